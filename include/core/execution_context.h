@@ -46,6 +46,7 @@ public:
   std::vector<std::string> optimization_rules_; // 使用的优化规则
   std::string index_info_;                      // 索引使用详情
   double cost_estimate_;                        // 成本估算
+  size_t parallel_degree_;                      // 查询并行度（0为默认）
 
   // 执行状态
   bool has_error_;            // 是否有错误
@@ -255,6 +256,16 @@ public:
    */
   void set_cost_estimate(double cost_estimate);
 
+  /**
+   * @brief 获取会话的查询并行度（0表示按配置或CPU核数决定）
+   */
+  size_t get_parallel_degree() const;
+
+  /**
+   * @brief 设置会话的查询并行度，1表示串行执行
+   */
+  void set_parallel_degree(size_t parallel_degree);
+
   /**
    * @brief 检查是否有错误
    */
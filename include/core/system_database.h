@@ -2,6 +2,7 @@
 #define SQLCC_SYSTEM_DATABASE_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -37,6 +38,8 @@ const std::string SYS_TABLE_CLUSTER_NODES = "sys_cluster_nodes";
 const std::string SYS_TABLE_DISTRIBUTED_TRANSACTIONS = "sys_distributed_transactions";
 const std::string SYS_TABLE_DISTRIBUTED_OBJECTS = "sys_distributed_objects";
 const std::string SYS_TABLE_TEMPORAL_TABLES = "sys_temporal_tables";
+const std::string SYS_TABLE_TABLE_STATISTICS = "sys_table_statistics";
+const std::string SYS_TABLE_COLUMN_STATISTICS = "sys_column_statistics";
 
 // 系统数据库数据结构定义
 
@@ -248,6 +251,25 @@ struct SysTemporalTable {
     std::string created_at;
 };
 
+// 表统计信息（ANALYZE生成）
+struct SysTableStatistics {
+    int64_t table_id;
+    int64_t row_count;
+    int64_t page_count;
+    std::string analyzed_at;
+};
+
+// 列统计信息（ANALYZE生成）
+struct SysColumnStatistics {
+    int64_t table_id;
+    std::string column_name;
+    std::string data_type;
+    double null_fraction;
+    double distinct_count;
+    std::string histogram;  // encode_histogram编码的等深直方图边界
+    std::string analyzed_at;
+};
+
 /**
  * 系统数据库管理器
  * 负责管理SQLCC的system数据库，存储所有元数据信息
@@ -386,6 +408,13 @@ public:
     std::vector<SysClusterNode> GetClusterNodes();
     std::vector<SysDistributedTransaction> GetActiveDistributedTransactions();
 
+    // 统计信息操作（ANALYZE写入，覆盖该表之前的统计信息）
+    bool SaveTableStatistics(int64_t table_id, int64_t row_count, int64_t page_count);
+    bool SaveColumnStatistics(int64_t table_id, const std::string& column_name, const std::string& data_type,
+                              double null_fraction, double distinct_count, const std::string& histogram);
+    std::vector<SysTableStatistics> GetTableStatistics(int64_t table_id);
+    std::vector<SysColumnStatistics> GetColumnStatistics(int64_t table_id);
+
     // 工具方法
     std::string GetCurrentTimeString() const;
     int64_t GenerateId(const std::string& table_name);
@@ -401,6 +430,7 @@ public:
 private:
     std::shared_ptr<DatabaseManager> db_manager_;  // 数据库管理器
     std::string last_error_;                       // 最后一次错误信息
+    std::mutex statistics_mutex_;                  // 串行化统计信息的先删后写
 
     // 系统表创建方法
     bool CreateSystemTables();
@@ -425,6 +455,8 @@ private:
     bool CreateSysDistributedTransactionsTable();
     bool CreateSysDistributedObjectsTable();
     bool CreateSysTemporalTablesTable();
+    bool CreateSysTableStatisticsTable();
+    bool CreateSysColumnStatisticsTable();
 
     // 初始化默认数据
     bool InitializeDefaultData();
@@ -432,6 +464,11 @@ private:
     // 执行SQL语句的辅助方法
     bool ExecuteSQL(const std::string& sql);
 
+    // 统计信息表的读写：按table_id（以及列名）覆盖旧行
+    std::vector<std::vector<std::string>> ReadStatisticsRows(const std::string& table_name, int64_t table_id);
+    bool ReplaceStatisticsRow(const std::string& table_name, int64_t table_id, const std::string& column_name,
+                              const std::vector<std::string>& values);
+
     void SetError(const std::string& error) {
         last_error_ = error;
     }
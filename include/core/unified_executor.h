@@ -2,6 +2,8 @@
 #define SQLCC_UNIFIED_EXECUTOR_H
 
 #include "execution_context.h" // 使用统一的ExecutionContext定义
+#include "execution/join_order.h"
+#include "execution/physical_operator.h"
 #include "execution_engine.h"
 #include "sql_parser/ast_nodes.h"
 #include "system_database.h"
@@ -80,18 +82,6 @@ protected:
    */
   bool defaultPermissionCheck(const ExecutionContext &context);
 
-  // 辅助方法
-  bool matchesWhereClause(const std::vector<std::string> &record,
-                          const sql_parser::WhereClause &where_clause,
-                          std::shared_ptr<TableMetadata> metadata);
-
-  std::string getColumnValue(const std::vector<std::string> &record,
-                             const std::string &column_name,
-                             std::shared_ptr<TableMetadata> metadata);
-
-  bool compareValues(const std::string &left, const std::string &right,
-                     const std::string &op);
-
   // 约束验证方法
   bool validateColumnConstraints(const std::vector<std::string> &record,
                                  std::shared_ptr<TableMetadata> metadata,
@@ -110,10 +100,13 @@ protected:
                                const std::string &table_name, int32_t page_id,
                                size_t offset, ExecutionContext &context);
 
+  // 记录更新后可能换了位置，旧条目按旧位置删除，新条目指向新位置
   void maintainIndexesOnUpdate(const std::vector<std::string> &old_record,
                                const std::vector<std::string> &new_record,
-                               const std::string &table_name, int32_t page_id,
-                               size_t offset, ExecutionContext &context);
+                               const std::string &table_name,
+                               int32_t old_page_id, size_t old_offset,
+                               int32_t new_page_id, size_t new_offset,
+                               ExecutionContext &context);
 
   void maintainIndexesOnDelete(const std::vector<std::string> &record,
                                const std::string &table_name, int32_t page_id,
@@ -216,6 +209,20 @@ private:
 
   ExecutionResult executeSelect(sql_parser::SelectStatement *stmt,
                                 ExecutionContext &context);
+
+  /**
+   * @brief EXPLAIN输出算子树；EXPLAIN ANALYZE实际执行查询（结果丢弃），
+   * 输出每个算子的估计/实际行数、执行次数、耗时和缓冲池访问
+   */
+  ExecutionResult executeExplain(sql_parser::ExplainStatement *stmt,
+                                 ExecutionContext &context);
+
+  /**
+   * @brief 把DML修改的行数计入统计信息，超过阈值时自动重新ANALYZE
+   */
+  void trackModifications(ExecutionContext &context,
+                          const std::string &table_name, size_t inserted,
+                          size_t deleted, size_t updated);
 };
 
 /**
@@ -267,6 +274,13 @@ private:
   ExecutionResult executeShow(sql_parser::ShowStatement *stmt,
                               ExecutionContext &context);
 
+  /**
+   * @brief 扫描表收集统计信息，写入统计信息目录和系统表
+   * 未指定表时分析当前数据库的所有表
+   */
+  ExecutionResult executeAnalyze(sql_parser::AnalyzeStatement *stmt,
+                                 ExecutionContext &context);
+
   std::string formatDatabases(const std::vector<std::string> &databases);
   std::string formatTables(const std::vector<std::string> &tables);
 };
@@ -284,7 +298,9 @@ struct ExecutionPlan {
   std::string index_name;
   std::vector<std::string> columns;
   std::string where_clause;
+  std::string join_condition;  // 连接条件（JOIN计划），如"a.id = b.a_id"
   double cost_estimate;
+  double estimated_rows = 0.0; // 估计输出行数，没有统计信息时为0
   bool is_optimized;
 
   // 生成执行计划描述
@@ -308,11 +324,101 @@ public:
   ExecutionPlan optimizePlan(const ExecutionPlan &plan,
                              const ExecutionContext &context);
 
-  // 评估执行计划成本
+  /**
+   * @brief 评估执行计划成本
+   * 表有ANALYZE统计信息时按代价模型（页读取与逐行CPU代价）估计，
+   * 否则按计划类型返回固定成本
+   */
   double estimateCost(const ExecutionPlan &plan,
                       const ExecutionContext &context);
 
+  /**
+   * @brief 生成可执行的拉取式算子树
+   * 扫描算子根据表存储和可用索引选择，其上依次叠加过滤、聚合、
+   * 排序、LIMIT和投影算子。多表连接的数据源为按连接顺序优化生成的
+   * 连接树，WHERE条件下推到所属表的扫描之上
+   * @throws Exception 存储引擎或表元数据不可用
+   */
+  OperatorPtr generateOperatorTree(const sql_parser::SelectStatement &stmt,
+                                   const ExecutionContext &context);
+
+  /**
+   * @brief 在给定数据源之上生成算子树
+   * @param stmt SELECT语句
+   * @param source 数据源算子
+   */
+  OperatorPtr generateOperatorTree(const sql_parser::SelectStatement &stmt,
+                                   OperatorPtr source);
+
+  /**
+   * @brief 设置排序、聚合算子的工作内存（字节），超出时溢出到磁盘
+   */
+  void setWorkMem(size_t bytes) { work_mem_ = bytes; }
+  size_t getWorkMem() const { return work_mem_; }
+
+  /**
+   * @brief 设置全表扫描的并行度，大于1时扫描、过滤和部分聚合在工作线程上
+   * 按morsel并行执行（默认为1，串行）
+   */
+  void setParallelDegree(size_t dop) { parallel_degree_ = dop; }
+  size_t getParallelDegree() const { return parallel_degree_; }
+
+  // 解析 COUNT(*)、SUM(col) 等聚合选择列
+  static bool parseAggregate(const std::string &expr, AggregateSpec &spec);
+
+  /**
+   * @brief 解析窗口函数选择列，如
+   * "RANK() OVER (PARTITION BY dept ORDER BY salary DESC)"、
+   * "SUM(x) OVER (ORDER BY id ROWS BETWEEN 2 PRECEDING AND CURRENT ROW)"
+   * @return 不是窗口函数时返回false
+   * @throws Exception 是窗口函数但函数名、参数或帧不受支持
+   */
+  static bool parseWindowFunction(const std::string &expr, WindowSpec &spec);
+
 private:
+  // 两表连接的顺序与算法选择
+  struct JoinChoice {
+    std::string outer_table;
+    std::string inner_table;
+    JoinAlgorithm algorithm = JoinAlgorithm::HASH;
+    double cost = 0.0;
+    double rows = 0.0;
+  };
+
+  size_t work_mem_;
+  size_t parallel_degree_;
+
+  /**
+   * @brief 按两侧的统计信息选择连接顺序和算法
+   * @return 连接条件不是"a.x = b.y"形式或缺少统计信息时返回false
+   */
+  bool chooseJoin(const ExecutionPlan &plan, const ExecutionContext &context,
+                  JoinChoice &choice);
+
+  // 生成连接计划（两表时评估两种连接顺序，三表及以上枚举连接树）
+  ExecutionPlan generateJoinPlan(const sql_parser::SelectStatement &stmt,
+                                 const ExecutionContext &context);
+
+  /**
+   * @brief 由"a.x = b.y AND b.z = c.w"形式的连接条件生成连接图
+   * FROM后的表为0号关系。关系行数和连接条件选择率取自统计信息，
+   * 没有统计信息时按kDefaultJoinRelationRows行和外键连接估计。
+   * WHERE条件下推到所属的关系（没有表名前缀时属于FROM后的表），
+   * 该关系的行数乘以条件的选择率
+   * @param where_relation 输出WHERE条件所属的关系下标，没有WHERE时为npos
+   * @return 连接条件不是等值条件的合取时返回false
+   */
+  bool buildJoinGraph(const ExecutionPlan &plan, const ExecutionContext &context,
+                      JoinGraph &graph, size_t &where_relation);
+
+  // 按优化后的连接顺序生成连接算子树
+  OperatorPtr generateJoinOperator(const sql_parser::SelectStatement &stmt,
+                                   const ExecutionContext &context);
+
+  // 生成扫描算子（等值条件且列上有索引时使用索引扫描）
+  OperatorPtr generateScanOperator(const sql_parser::SelectStatement &stmt,
+                                   const ExecutionContext &context);
+
   // 生成全表扫描计划
   ExecutionPlan
   generateFullTableScanPlan(const sql_parser::SelectStatement &stmt);
@@ -396,6 +502,22 @@ private:
   ExecutionPlanGenerator plan_generator_;
 };
 
+/**
+ * @brief 基于代价的查询优化器
+ * 在规则优化之后按ANALYZE收集的统计信息重新估计成本：扫描方式（全表扫描或
+ * 索引查找）和两表连接的顺序、算法都按代价选择。没有统计信息的表退化为
+ * 基于规则的行为
+ */
+class CostBasedOptimizer : public RuleBasedOptimizer {
+public:
+  CostBasedOptimizer() = default;
+  ~CostBasedOptimizer() override = default;
+
+  // 优化查询计划，成本按代价模型重新计算
+  ExecutionPlan optimize(const ExecutionPlan &plan,
+                         const ExecutionContext &context) override;
+};
+
 /**
  * @brief 统一执行器
  * 使用策略模式统一处理所有类型的SQL语句
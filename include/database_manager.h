@@ -85,7 +85,7 @@ public:
   bool Close();
 
   // 获取存储引擎（用于DML操作）
-  std::shared_ptr<StorageEngine> GetStorageEngine() { return storage_engine_; }
+  std::shared_ptr<StorageEngine> GetStorageEngine();
 
   // 获取表元数据（用于索引优化）
   std::shared_ptr<TableMetadata>
@@ -95,7 +95,7 @@ public:
   std::shared_ptr<IndexManager> GetIndexManager();
 
 private:
-  std::shared_ptr<ConfigManager> config_manager_;   // 配置管理器
+  ConfigManager *config_manager_;                   // 配置管理器（全局单例）
   std::shared_ptr<StorageEngine> storage_engine_;   // 存储引擎
   std::shared_ptr<BufferPoolSharded> buffer_pool_;  // shard化缓冲池
   std::shared_ptr<TransactionManager> txn_manager_; // 事务管理器
@@ -117,6 +117,11 @@ private:
   // 私有辅助方法
   bool LoadDatabases();
   bool LoadTables(const std::string &db_name);
+  // 按需创建存储引擎，数据文件放在db_path_下，调用方持有mutex_
+  std::shared_ptr<StorageEngine> EnsureStorageEngine();
+  // 从表文件读取列定义，调用方持有mutex_
+  std::vector<std::pair<std::string, std::string>>
+  ReadTableColumns(const std::string &db_name, const std::string &table_name);
 };
 
 } // namespace sqlcc
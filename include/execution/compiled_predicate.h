@@ -0,0 +1,93 @@
+#ifndef SQLCC_COMPILED_PREDICATE_H
+#define SQLCC_COMPILED_PREDICATE_H
+
+#include "execution/simd_filter.h"
+#include "execution_result.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sqlcc {
+
+// 前向声明
+struct TableMetadata;
+class PredicateNode;
+
+namespace sql_parser {
+class WhereClause;
+}
+
+/**
+ * @brief 编译后的WHERE谓词
+ *
+ * 每个查询编译一次：列名解析为下标，常量按列的数据类型预先转换，
+ * 比较节点按(值类型, 操作符)模板特化，逐行求值时不再查找列名、
+ * 转换常量或抛出异常。既可以对存储层的字符串记录求值，也可以对
+ * 算子树中的Row求值，两者语义与parse_value + compare_values一致。
+ * 整批求值(select)时数值比较、BETWEEN、IN先把列取成连续数组，
+ * 再用SIMD内核生成位图与选择向量。对象可廉价复制（共享同一棵谓词树）。
+ */
+class CompiledPredicate {
+public:
+  /**
+   * @brief 恒真谓词
+   */
+  CompiledPredicate();
+
+  /**
+   * @brief 编译"列 操作符 常量"比较，操作符支持 = <> != < > <= >=，
+   * 以及[NOT] BETWEEN（常量为"low AND high"）和[NOT] IN（常量为"(v1, v2)"）
+   * @throws Exception 列不存在或操作符不受支持
+   */
+  static CompiledPredicate compile(const std::vector<ColumnMeta> &columns,
+                                   const std::string &column,
+                                   const std::string &op,
+                                   const std::string &literal);
+
+  /**
+   * @brief 编译WHERE子句，列名为空时返回恒真谓词
+   * @throws Exception 列不存在或操作符不受支持
+   */
+  static CompiledPredicate compile(const sql_parser::WhereClause &where,
+                                   const std::vector<ColumnMeta> &columns);
+  static CompiledPredicate compile(const sql_parser::WhereClause &where,
+                                   const TableMetadata &metadata);
+
+  static CompiledPredicate between(const std::vector<ColumnMeta> &columns,
+                                   const std::string &column,
+                                   const std::string &low,
+                                   const std::string &high);
+  static CompiledPredicate in_list(const std::vector<ColumnMeta> &columns,
+                                   const std::string &column,
+                                   const std::vector<std::string> &literals);
+
+  static CompiledPredicate constant(bool value);
+  static CompiledPredicate all_of(const std::vector<CompiledPredicate> &terms);
+  static CompiledPredicate any_of(const std::vector<CompiledPredicate> &terms);
+  static CompiledPredicate negate(const CompiledPredicate &term);
+
+  bool operator()(const std::vector<std::string> &record) const;
+  bool operator()(const Row &row) const;
+
+  /**
+   * @brief 对整批行求值，selection中写入满足条件的行下标（升序）
+   */
+  void select(const std::vector<Row> &rows, SelectionVector &selection) const;
+
+  bool always_true() const;
+  std::string describe() const;
+
+private:
+  explicit CompiledPredicate(std::shared_ptr<const PredicateNode> root);
+
+  std::shared_ptr<const PredicateNode> root_;
+};
+
+/**
+ * @brief 把表元数据的列转换为算子使用的列描述
+ */
+std::vector<ColumnMeta> table_columns(const TableMetadata &metadata);
+
+} // namespace sqlcc
+
+#endif // SQLCC_COMPILED_PREDICATE_H
@@ -0,0 +1,61 @@
+#ifndef SQLCC_EXPLAIN_ANALYZE_H
+#define SQLCC_EXPLAIN_ANALYZE_H
+
+#include "buffer_usage.h"
+#include "execution/physical_operator.h"
+#include <string>
+
+namespace sqlcc {
+
+/**
+ * @brief 一个算子在一次执行中的运行统计
+ * 时间和缓冲池访问包含其下层算子（与PostgreSQL的EXPLAIN ANALYZE相同），
+ * 本算子自身的开销为其与子算子之差
+ */
+struct OperatorProfile {
+  size_t loops = 0;     // open()次数（嵌套循环的内侧会被多次打开）
+  size_t rows = 0;      // 各次执行输出的总行数
+  double wall_ms = 0.0; // open/next/close的墙钟时间
+  double cpu_ms = 0.0;  // 调用线程在open/next/close中消耗的CPU时间
+  BufferUsage buffers;  // 调用线程上的缓冲池访问
+};
+
+/**
+ * @brief 计时算子
+ * 包装一个算子，转发open/next/close并记录OperatorProfile，输出列与被包装的
+ * 算子相同。由instrument_operator_tree插入到算子树的每条边上
+ */
+class InstrumentedOperator : public PhysicalOperator {
+public:
+  explicit InstrumentedOperator(OperatorPtr input);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+  const PhysicalOperator &input() const { return *children_.front(); }
+  const OperatorProfile &profile() const { return profile_; }
+
+private:
+  OperatorProfile profile_;
+};
+
+/**
+ * @brief 用InstrumentedOperator包装算子树中的每个算子
+ * 并行汇集算子（Gather）的工作线程流水线在其他线程上执行且被汇集算子直接
+ * 引用，不做包装；工作线程的缓冲池访问计入汇集算子
+ * @return 包装后的根算子
+ */
+OperatorPtr instrument_operator_tree(OperatorPtr root);
+
+/**
+ * @brief 输出已执行的计时算子树
+ * 每个算子一行：估计行数、实际行数、执行次数、墙钟和CPU时间以及缓冲池
+ * 命中/未命中/磁盘读取页数，缩进格式与PhysicalOperator::explain()相同
+ */
+std::string explain_analyze(const PhysicalOperator &root);
+
+} // namespace sqlcc
+
+#endif // SQLCC_EXPLAIN_ANALYZE_H
@@ -1,6 +1,7 @@
 #ifndef SQLCC_JOIN_EXECUTOR_H
 #define SQLCC_JOIN_EXECUTOR_H
 
+#include "execution/spill_file.h"
 #include "execution_result.h"
 #include "sql_parser/ast_nodes.h"
 #include <chrono>
@@ -25,6 +26,49 @@ enum class JoinType {
   NATURAL_JOIN
 };
 
+/**
+ * @brief JOIN物理算法
+ */
+enum class JoinAlgorithm {
+  AUTO,             // 由代价估计选择
+  NESTED_LOOP,      // 嵌套循环连接
+  HASH,             // 哈希连接（超出内存限制时自动分区溢出）
+  SORT_MERGE,       // 排序归并连接
+  INDEX_NESTED_LOOP // 索引嵌套循环连接
+};
+
+/**
+ * @brief 连接输入的基数估计
+ */
+struct JoinInputEstimate {
+  size_t rows = 0;
+  bool sorted_on_key = false;  // 输入已按连接键有序（如B+树扫描、排序后的子结果）
+  bool indexed_on_key = false; // 连接键上有可用的B+树索引（仅对内表有意义）
+};
+
+/**
+ * @brief 根据基数估计选择连接算法
+ * 代价以处理的行数计：嵌套循环为L*R；哈希连接为构建侧两倍加探测侧；
+ * 归并连接为L+R加上未排序一侧的n*log2(n)；索引嵌套循环为外表每行一次
+ * 索引下降加一次页读取，只适用于保留外表（左表）或内连接的情况。
+ * 代价相同时依次优先哈希、归并、嵌套循环。
+ * @param outer 外表（左表）估计
+ * @param inner 内表（右表）估计
+ * @param join_type JOIN类型
+ * @param equi_join 是否为等值连接
+ */
+JoinAlgorithm choose_join_algorithm(const JoinInputEstimate &outer,
+                                    const JoinInputEstimate &inner,
+                                    JoinType join_type, bool equi_join);
+
+/**
+ * @brief 估计指定连接算法的代价，单位与choose_join_algorithm一致
+ * 内表没有连接键索引时INDEX_NESTED_LOOP的代价为无穷大
+ */
+double estimate_join_cost(JoinAlgorithm algorithm,
+                          const JoinInputEstimate &outer,
+                          const JoinInputEstimate &inner);
+
 /**
  * @brief JOIN执行统计信息
  */
@@ -37,6 +81,11 @@ struct JoinExecutionStats {
   std::chrono::milliseconds left_scan_time{};
   std::chrono::milliseconds right_scan_time{};
   std::chrono::milliseconds join_time{};
+  std::string algorithm;   // 实际使用的连接算法
+  size_t build_rows = 0;   // 哈希连接构建侧行数
+  size_t spilled_partitions = 0; // 溢出到磁盘的分区数
+  size_t spilled_bytes = 0;      // 溢出写入的字节数
+  size_t max_partition_depth = 0; // 递归重分区的最大深度
   bool has_error = false;
   std::optional<std::string> error_message;
 };
@@ -80,7 +129,73 @@ public:
    */
   JoinExecutionStats get_stats() const;
 
+  /**
+   * @brief 设置内存限制（字节）
+   * Hash JOIN构建侧超过该限制时按分区溢出到临时文件
+   */
+  void set_memory_limit(size_t limit_bytes);
+
+  /**
+   * @brief 指定连接算法，默认AUTO由代价估计选择
+   * 非等值条件只能使用嵌套循环；物化输入上没有索引，INDEX_NESTED_LOOP按AUTO处理
+   */
+  void set_algorithm(JoinAlgorithm algorithm);
+
 private:
+  /**
+   * @brief Hash JOIN的构建/探测侧配置
+   * 构建侧可能是左表也可能是右表，输出行始终按左、右顺序拼接
+   */
+  struct HashJoinPlan {
+    JoinType join_type;
+    bool build_left;
+    size_t build_key;
+    size_t probe_key;
+    bool keep_build; // 构建侧未匹配行需要输出
+    bool keep_probe; // 探测侧未匹配行需要输出
+    size_t left_width;
+    size_t right_width;
+  };
+
+  /**
+   * @brief 在内存中对一组构建行建立哈希表并用探测侧流式探测
+   */
+  void join_in_memory(const HashJoinPlan &plan, const std::vector<Row> &build,
+                      const RowReader &probe, ExecutionResult &result);
+
+  /**
+   * @brief Grace/Hybrid Hash JOIN
+   * 按连接键哈希把两侧划分为多个分区，0号分区常驻内存并在划分探测侧时
+   * 直接探测，其余分区写入溢出文件后逐个连接；仍超出内存限制的分区换用
+   * 新的哈希种子递归重分区
+   * @param build_bytes 构建侧估算内存大小
+   * @param depth 当前递归深度
+   */
+  void join_partitioned(const HashJoinPlan &plan, const RowReader &build,
+                        const RowReader &probe, size_t build_bytes,
+                        size_t build_count, size_t depth,
+                        ExecutionResult &result);
+
+  /**
+   * @brief 连接一对溢出分区
+   */
+  void join_spilled_partition(const HashJoinPlan &plan, SpillFile *build,
+                              SpillFile *probe, size_t parent_build_count,
+                              size_t depth, ExecutionResult &result);
+
+  /**
+   * @brief 分块连接无法再划分的分区（例如全部为同一个键）
+   * 构建侧按内存限制分块，每块扫描一遍探测侧，探测行的匹配标记跨块累计
+   */
+  void join_in_chunks(const HashJoinPlan &plan, SpillFile &build,
+                      SpillFile &probe, ExecutionResult &result);
+
+  /**
+   * @brief 按左右顺序输出一行连接结果，nullptr一侧填充NULL
+   */
+  void emit_row(const HashJoinPlan &plan, const Row *build_row,
+                const Row *probe_row, ExecutionResult &result);
+
   /**
    * @brief 执行Nested Loop JOIN算法
    * @param left_result 左表结果
@@ -94,6 +209,56 @@ private:
                                            JoinType join_type,
                                            const std::string &join_condition);
 
+  /**
+   * @brief 执行Hash JOIN算法
+   * 在较小的输入上建立哈希表，用另一侧探测；构建行的匹配标记使
+   * LEFT/RIGHT/FULL JOIN在一次探测中完成
+   * @param left_result 左表结果
+   * @param right_result 右表结果
+   * @param join_type JOIN类型
+   * @param left_key 左表连接键列位置
+   * @param right_key 右表连接键列位置
+   * @return JOIN后的结果
+   */
+  ExecutionResult execute_hash_join(const ExecutionResult &left_result,
+                                    const ExecutionResult &right_result,
+                                    JoinType join_type, size_t left_key,
+                                    size_t right_key);
+
+  /**
+   * @brief 执行Sort-Merge JOIN算法
+   * 已按连接键有序的输入不再排序；相同键的行组做笛卡尔积，
+   * 未匹配行在归并过程中直接输出
+   * @param left_result 左表结果
+   * @param right_result 右表结果
+   * @param join_type JOIN类型
+   * @param left_key 左表连接键列位置
+   * @param right_key 右表连接键列位置
+   * @param left_sorted 左表已按连接键有序
+   * @param right_sorted 右表已按连接键有序
+   * @return JOIN后的结果
+   */
+  ExecutionResult execute_sort_merge_join(const ExecutionResult &left_result,
+                                          const ExecutionResult &right_result,
+                                          JoinType join_type, size_t left_key,
+                                          size_t right_key, bool left_sorted,
+                                          bool right_sorted);
+
+  /**
+   * @brief 解析等值连接条件，如 "left.col1 = right.col2"
+   * @param join_condition JOIN条件
+   * @param left_meta 左表元数据
+   * @param right_meta 右表元数据
+   * @param left_key 输出左表连接键列位置
+   * @param right_key 输出右表连接键列位置
+   * @return 条件为空时返回false
+   * @throws Exception 非等值条件或列不存在
+   */
+  bool parse_join_condition(const std::string &join_condition,
+                            const std::vector<ColumnMeta> &left_meta,
+                            const std::vector<ColumnMeta> &right_meta,
+                            size_t &left_key, size_t &right_key) const;
+
   /**
    * @brief 检查两个行是否满足JOIN条件
    * @param left_row 左表行
@@ -128,6 +293,8 @@ private:
                         const std::vector<ColumnMeta> &right_meta);
 
   std::shared_ptr<SqlExecutor> sql_executor_;
+  size_t memory_limit_;
+  JoinAlgorithm algorithm_;
   JoinExecutionStats stats_;
 };
 
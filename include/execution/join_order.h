@@ -0,0 +1,113 @@
+#ifndef SQLCC_JOIN_ORDER_H
+#define SQLCC_JOIN_ORDER_H
+
+#include "execution/physical_operator.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sqlcc {
+
+/**
+ * @brief 动态规划枚举连接顺序的最大表数，超过时使用贪心算法
+ */
+constexpr size_t kMaxDpJoinRelations = 12;
+
+/**
+ * @brief 没有统计信息的表在连接顺序估计中使用的行数
+ */
+constexpr double kDefaultJoinRelationRows = 1000.0;
+
+/**
+ * @brief 连接图中的一个关系（基表）
+ * rows为下推过滤条件之后的估计行数
+ */
+struct JoinRelation {
+  std::string name;
+  double rows = 0.0;
+  double scan_cost = 0.0;
+};
+
+/**
+ * @brief 两个关系之间的等值连接条件 left.left_column = right.right_column
+ */
+struct JoinPredicate {
+  size_t left = 0;
+  size_t right = 0;
+  std::string left_column;
+  std::string right_column;
+  double selectivity = 1.0; // 连接结果行数 / (左行数 * 右行数)
+
+  std::string to_string(const std::vector<JoinRelation> &relations) const;
+};
+
+/**
+ * @brief 连接图：关系为顶点，等值连接条件为边
+ */
+struct JoinGraph {
+  std::vector<JoinRelation> relations;
+  std::vector<JoinPredicate> predicates;
+
+  /**
+   * @brief 按表名查找关系下标
+   * @return 不存在时返回relations.size()
+   */
+  size_t find(const std::string &name) const;
+};
+
+/**
+ * @brief 连接树节点
+ * 叶子对应一个关系；内部节点的右子树为哈希构建侧（JoinOperator物化右子树），
+ * 因此总是把估计行数较小的一侧放在右边。左右子树都可以是连接（bushy树）
+ */
+struct JoinTreeNode {
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  uint64_t relations = 0;  // 包含的关系集合（位图）
+  size_t relation = npos;  // 叶子对应的关系下标
+  std::shared_ptr<const JoinTreeNode> left;
+  std::shared_ptr<const JoinTreeNode> right;
+  std::vector<size_t> predicates; // 在本节点求值的连接条件下标，为空时是笛卡尔积
+  double rows = 0.0;
+  double cost = 0.0;
+
+  bool is_leaf() const { return relation != npos; }
+
+  /**
+   * @brief 以括号形式输出连接顺序，如 "((fact JOIN d1) JOIN (d2 JOIN d3))"
+   */
+  std::string to_string(const JoinGraph &graph) const;
+};
+
+using JoinTreePtr = std::shared_ptr<const JoinTreeNode>;
+
+/**
+ * @brief 选择代价最低的连接顺序
+ * 表数不超过kMaxDpJoinRelations且连接图连通时用DPccp枚举全部连通子图及其
+ * 连通补集（包括bushy树，不产生笛卡尔积）；表更多或连接图不连通时使用贪心
+ * 算法（GOO），每次合并结果行数最小的一对子树，没有连接条件的子树最后以
+ * 笛卡尔积合并。代价为两侧代价、哈希连接代价与中间结果行数之和
+ * @throws Exception 没有关系或关系超过64个
+ */
+JoinTreePtr optimize_join_order(const JoinGraph &graph);
+
+/**
+ * @brief 贪心连接顺序，optimize_join_order在表数较多时使用
+ */
+JoinTreePtr greedy_join_order(const JoinGraph &graph);
+
+/**
+ * @brief 按连接树生成算子树
+ * 叶子算子由make_leaf生成（可以在扫描之上放置下推的过滤条件），其输出列名
+ * 加上"表名."前缀以区分各表的同名列。每个连接节点的第一个条件作为JoinOperator
+ * 的等值条件，其余条件（连接图中的环）在连接之上过滤
+ */
+OperatorPtr
+build_join_operator(const JoinTreeNode &tree, const JoinGraph &graph,
+                    const std::function<OperatorPtr(size_t relation)> &make_leaf);
+
+} // namespace sqlcc
+
+#endif // SQLCC_JOIN_ORDER_H
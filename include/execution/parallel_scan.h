@@ -0,0 +1,176 @@
+#ifndef SQLCC_PARALLEL_SCAN_H
+#define SQLCC_PARALLEL_SCAN_H
+
+#include "buffer_usage.h"
+#include "execution/physical_operator.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sqlcc {
+
+/**
+ * @brief 默认查询并行度：CPU核数（至少为1）
+ */
+size_t default_parallel_degree();
+
+/**
+ * @brief 工作线程池
+ * 所有并行查询共享同一个池（shared()，线程数为CPU核数），任务按提交顺序执行
+ */
+class WorkerPool {
+public:
+  explicit WorkerPool(size_t threads);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  static WorkerPool &shared();
+
+  void submit(std::function<void()> task);
+  size_t thread_count() const { return threads_.size(); }
+
+private:
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  bool stopping_ = false;
+};
+
+/**
+ * @brief Morsel队列
+ * 把表的数据页按顺序切分为morsel，每个morsel是若干个相邻的页。
+ * 工作线程通过原子计数器领取morsel，先完成的线程领取更多，负载自动均衡
+ */
+class MorselQueue {
+public:
+  explicit MorselQueue(size_t pages_per_morsel);
+
+  /**
+   * @brief 重新切分数据页，只能在没有线程领取时调用
+   */
+  void reset(std::vector<int32_t> pages);
+
+  /**
+   * @brief 领取一个morsel，其数据页为page(begin)到page(end - 1)
+   * @return 没有剩余morsel时返回false
+   */
+  bool next(size_t &begin, size_t &end);
+
+  int32_t page(size_t index) const { return pages_[index]; }
+  size_t morsel_count() const {
+    return (pages_.size() + pages_per_morsel_ - 1) / pages_per_morsel_;
+  }
+
+private:
+  size_t pages_per_morsel_;
+  std::vector<int32_t> pages_;
+  std::atomic<size_t> next_{0};
+};
+
+/**
+ * @brief Morsel扫描算子
+ * 从共享的MorselQueue领取morsel，通过全表扫描算子逐页读取并转换记录，
+ * 同一时刻只缓存一页的行。每个工作线程各有一个实例
+ */
+class MorselScanOperator : public PhysicalOperator {
+public:
+  MorselScanOperator(const TableScanOperator &table_scan,
+                     std::shared_ptr<MorselQueue> queue);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  std::string describe() const override;
+
+  size_t morsels_scanned() const { return morsels_scanned_; }
+
+private:
+  const TableScanOperator &table_scan_;
+  std::shared_ptr<MorselQueue> queue_;
+  size_t position_ = 0; // 当前morsel中下一个要读取的页
+  size_t end_ = 0;
+  std::vector<Row> page_rows_; // 当前页已转换但尚未输出的行
+  size_t row_position_ = 0;
+  size_t morsels_scanned_ = 0;
+};
+
+/**
+ * @brief 工作线程流水线工厂：在给定的morsel扫描之上叠加过滤、部分聚合等算子
+ */
+using PipelineFactory = std::function<OperatorPtr(OperatorPtr source)>;
+
+/**
+ * @brief 并行扫描的汇集（Gather Exchange）算子
+ *
+ * 构造时为每个工作线程各生成一条流水线（morsel扫描→过滤→部分聚合），
+ * open()时只从页目录获取数据页并切分为morsel，把各流水线提交到工作线程池，
+ * 数据页由工作线程各自读取和解码。
+ * 工作线程把输出批放入有界缓冲区，调用线程在next()中取出；缓冲区满时
+ * 工作线程等待，因此上层LIMIT满足后扫描很快停止。工作线程的异常在
+ * next()中重新抛出。输出行之间没有确定的顺序。
+ */
+class ExchangeOperator : public PhysicalOperator {
+public:
+  /**
+   * @param table_scan 被并行化的全表扫描
+   * @param pipeline 流水线工厂，构造期间调用dop次
+   * @param dop 并行度（工作线程数），实际启动的线程数不超过morsel数
+   */
+  ExchangeOperator(std::unique_ptr<TableScanOperator> table_scan,
+                   const PipelineFactory &pipeline, size_t dop,
+                   WorkerPool &pool = WorkerPool::shared());
+  ~ExchangeOperator() override;
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+  size_t dop() const { return pipelines_.size(); }
+  size_t morsel_count() const { return queue_->morsel_count(); }
+  size_t workers_started() const { return workers_started_; }
+
+  /**
+   * @brief 最近一次执行中各工作线程流水线的缓冲池访问之和
+   * 工作线程结束后才累加，应在close()之后读取
+   */
+  BufferUsage worker_buffer_usage() const;
+
+private:
+  void run_worker(PhysicalOperator &pipeline);
+  void stop_workers();
+
+  std::unique_ptr<TableScanOperator> table_scan_;
+  std::shared_ptr<MorselQueue> queue_;
+  // 各工作线程的流水线；第一条同时作为children_[0]用于输出计划
+  std::vector<PhysicalOperator *> pipelines_;
+  std::vector<OperatorPtr> extra_pipelines_;
+  WorkerPool &pool_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable space_;
+  std::deque<std::vector<Row>> buffer_;
+  size_t running_ = 0;
+  bool cancelled_ = false;
+  std::exception_ptr error_;
+  size_t workers_started_ = 0;
+  BufferUsage worker_buffers_;
+
+  std::vector<Row> current_;
+  size_t position_ = 0;
+};
+
+} // namespace sqlcc
+
+#endif // SQLCC_PARALLEL_SCAN_H
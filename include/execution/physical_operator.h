@@ -0,0 +1,930 @@
+#ifndef SQLCC_PHYSICAL_OPERATOR_H
+#define SQLCC_PHYSICAL_OPERATOR_H
+
+#include "execution/compiled_predicate.h"
+#include "execution/join_executor.h"
+#include "execution_result.h"
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sqlcc {
+
+// 前向声明
+class TableStorageManager;
+class BPlusTreeIndex;
+struct IndexEntry;
+struct TableMetadata;
+
+/**
+ * @brief 算子之间传递的默认批大小（行数）
+ */
+constexpr size_t kDefaultBatchSize = 1024;
+
+/**
+ * @brief 行批次
+ * 算子之间按固定容量的批次传递数据，容量由消费者设置，
+ * 生产者每次最多填充capacity()行
+ */
+class RowBatch {
+public:
+  explicit RowBatch(size_t capacity = kDefaultBatchSize);
+
+  void clear() { rows_.clear(); }
+  void set_capacity(size_t capacity);
+  size_t capacity() const { return capacity_; }
+  size_t size() const { return rows_.size(); }
+  bool empty() const { return rows_.empty(); }
+  bool full() const { return rows_.size() >= capacity_; }
+
+  void add_row(Row row) { rows_.push_back(std::move(row)); }
+
+  Row &operator[](size_t index) { return rows_[index]; }
+  const Row &operator[](size_t index) const { return rows_[index]; }
+
+  std::vector<Row> &rows() { return rows_; }
+  const std::vector<Row> &rows() const { return rows_; }
+
+private:
+  std::vector<Row> rows_;
+  size_t capacity_;
+};
+
+/**
+ * @brief 物理算子基类（拉取式/Volcano模型）
+ *
+ * 调用顺序为open() -> next()* -> close()。next()清空batch后填充至多
+ * batch.capacity()行，返回false表示输入已耗尽（此时batch为空）。
+ * 父算子只在需要数据时才拉取子算子，因此LIMIT满足后扫描立即停止。
+ */
+class PhysicalOperator {
+public:
+  virtual ~PhysicalOperator() = default;
+
+  virtual void open();
+  virtual bool next(RowBatch &batch) = 0;
+  virtual void close();
+
+  /**
+   * @brief 算子名称及参数，用于输出计划
+   */
+  virtual std::string describe() const = 0;
+
+  /**
+   * @brief 以缩进树形式输出以该算子为根的计划
+   */
+  std::string explain() const;
+
+  /**
+   * @brief 给输出列名加上"prefix."前缀（已带前缀的列不变），
+   * 多表连接中区分同名列，需在生成父算子之前调用
+   */
+  void qualify_columns(const std::string &prefix);
+
+  /**
+   * @brief 用wrap的返回值替换每个子算子，用于在已生成的算子树中插入算子
+   * （如EXPLAIN ANALYZE的计时算子）。wrap必须保持子算子的输出列不变
+   */
+  void wrap_children(
+      const std::function<std::unique_ptr<PhysicalOperator>(
+          std::unique_ptr<PhysicalOperator>)> &wrap);
+
+  const std::vector<ColumnMeta> &output_columns() const { return columns_; }
+  size_t rows_produced() const { return rows_produced_; }
+  const std::vector<std::unique_ptr<PhysicalOperator>> &children() const {
+    return children_;
+  }
+
+  /**
+   * @brief 优化器估计的输出行数，负数表示未估计
+   */
+  double estimated_rows() const { return estimated_rows_; }
+  void set_estimated_rows(double rows) { estimated_rows_ = rows; }
+
+protected:
+  void explain(std::string &out, int depth) const;
+
+  std::vector<ColumnMeta> columns_;
+  std::vector<std::unique_ptr<PhysicalOperator>> children_;
+  size_t rows_produced_ = 0;
+  double estimated_rows_ = -1.0;
+};
+
+using OperatorPtr = std::unique_ptr<PhysicalOperator>;
+using RowPredicate = std::function<bool(const Row &)>;
+
+// ==================== 扫描算子 ====================
+
+/**
+ * @brief 对已物化的行集合进行扫描
+ * 用于把现有执行器产生的ExecutionResult接入算子树
+ */
+class ValuesScanOperator : public PhysicalOperator {
+public:
+  ValuesScanOperator(std::vector<ColumnMeta> columns, std::vector<Row> rows);
+  explicit ValuesScanOperator(ExecutionResult result);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  std::string describe() const override;
+
+private:
+  std::vector<Row> rows_;
+  size_t position_ = 0;
+};
+
+/**
+ * @brief 全表扫描算子
+ * open()时只获取记录位置，记录内容在next()中按批读取并按列类型转换
+ */
+class TableScanOperator : public PhysicalOperator {
+public:
+  TableScanOperator(std::shared_ptr<TableStorageManager> table_storage,
+                    const std::string &table_name,
+                    std::shared_ptr<TableMetadata> metadata);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+  const std::shared_ptr<TableStorageManager> &table_storage() const {
+    return table_storage_;
+  }
+  const std::string &table_name() const { return table_name_; }
+  const std::shared_ptr<TableMetadata> &metadata() const { return metadata_; }
+
+  /**
+   * @brief 读取一条记录并按列类型转换，可由多个线程同时调用
+   * @return 记录不存在或已删除时返回false
+   */
+  bool read_row(int32_t page_id, size_t offset, Row &row) const;
+
+  /**
+   * @brief 开始一次按页扫描：清零跳过的页数，返回表的数据页（不读取页面）
+   */
+  std::vector<int32_t> start_page_scan();
+
+  /**
+   * @brief 读取一个数据页上的全部记录，按列类型转换后追加到rows，
+   * 可由多个线程同时调用。设置了区域过滤时先查区域映射，被排除的页不读取
+   * @return 页面被区域映射排除时返回false
+   */
+  bool scan_page(int32_t page_id, std::vector<Row> &rows) const;
+
+  /**
+   * @brief 按区域映射跳过不可能满足 column op value 的页面
+   * 读取每个数据页之前检查，被排除的页不再固定。只是预筛选，
+   * 上层的过滤算子仍对读出的每一行求值
+   */
+  void set_zone_filter(const std::string &column, const std::string &op,
+                       const std::string &value);
+  size_t pages_skipped() const { return pages_skipped_; }
+
+  /**
+   * @brief 改为只读索引（仅用于索引扫描）
+   * 输出列只保留索引键列和INCLUDE列（按表中的列顺序），行直接由索引条目
+   * 生成，不再读取数据页。调用方保证查询引用的列都被索引覆盖
+   */
+  void set_index_only(const std::string &key_column,
+                      const std::vector<std::string> &included_columns);
+  bool index_only() const { return index_only_; }
+
+protected:
+  bool fetch_rows(RowBatch &batch);
+  // 记录一个索引条目的位置，只读索引时同时保存被覆盖列的值
+  void add_index_entry(const IndexEntry &entry);
+  // 读取一条记录，测试中可以替换为内存中的数据
+  virtual std::vector<std::string> read_record(int32_t page_id,
+                                               size_t offset) const;
+  // 表的数据页和一页上的全部记录，测试中可以替换为内存中的数据
+  virtual std::vector<int32_t> table_pages() const;
+  virtual std::vector<std::vector<std::string>>
+  read_page(int32_t page_id) const;
+  // 页面是否可能包含满足区域过滤条件的行，测试中可以替换
+  virtual bool page_may_match(int32_t page_id) const;
+  void convert_record(const std::vector<std::string> &record, Row &row) const;
+
+  std::shared_ptr<TableStorageManager> table_storage_;
+  std::string table_name_;
+  std::shared_ptr<TableMetadata> metadata_;
+  // 全表扫描：open()时只取页目录，next()逐页读取，同一时刻只缓存一页的行
+  std::vector<int32_t> pages_;
+  size_t page_position_ = 0;
+  std::vector<Row> page_rows_;
+  size_t row_position_ = 0;
+  // 索引扫描：索引给出的记录位置，由fetch_rows()逐条读取
+  std::vector<std::pair<int32_t, size_t>> locations_;
+  size_t position_ = 0;
+
+  size_t zone_column_ = 0;
+  std::string zone_op_; // 为空表示不做页面排除
+  std::string zone_value_;
+  mutable std::atomic<size_t> pages_skipped_{0}; // 并行扫描时各线程累加
+
+  bool index_only_ = false;
+  // 每个输出列在索引条目中的来源：-1为索引键，否则为INCLUDE值的下标
+  std::vector<int> index_sources_;
+  // 与locations_一一对应的被覆盖列的值
+  std::vector<std::vector<std::string>> index_records_;
+};
+
+/**
+ * @brief 索引扫描算子
+ * 按 索引列 op value 定位记录：op为=时执行等值查找；op为>、>=、<、<=时沿
+ * B+树叶子链执行范围查找，只用于数值列（其键按保序编码存储）
+ */
+class IndexScanOperator : public TableScanOperator {
+public:
+  /**
+   * @param value 不带引号的常量
+   * @throws Exception 范围查找的列不是数值列或op不受支持
+   */
+  IndexScanOperator(std::shared_ptr<TableStorageManager> table_storage,
+                    const std::string &table_name,
+                    std::shared_ptr<TableMetadata> metadata,
+                    BPlusTreeIndex *index, const std::string &op,
+                    const std::string &value);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  std::string describe() const override;
+
+private:
+  BPlusTreeIndex *index_;
+  std::string op_;
+  std::string value_;
+  std::string lower_bound_; // 编码后的键范围（闭区间）
+  std::string upper_bound_;
+};
+
+/**
+ * @brief 按索引顺序扫描算子
+ * 沿B+树叶子链按键升序分块读取索引条目（块大小从批大小开始倍增），
+ * 上层LIMIT满足后不再拉取，ORDER BY 索引列 LIMIT n 只访问约n条索引条目和
+ * 记录。数值列的键按保序编码存储，字符串列按原始文本存储，两者的索引顺序
+ * 都与排序算子的升序一致（数值列中无法解析的值排在最后）
+ */
+class IndexOrderScanOperator : public TableScanOperator {
+public:
+  IndexOrderScanOperator(std::shared_ptr<TableStorageManager> table_storage,
+                         const std::string &table_name,
+                         std::shared_ptr<TableMetadata> metadata,
+                         BPlusTreeIndex *index, const std::string &column);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  std::string describe() const override;
+
+  const std::string &column() const { return column_; }
+  size_t entries_read() const { return entries_read_; }
+
+protected:
+  // 读取不小于lower_bound的至多max_entries个索引条目
+  virtual std::vector<IndexEntry> scan_index(const std::string &lower_bound,
+                                             size_t max_entries) const;
+
+private:
+  void read_chunk(size_t batch_capacity);
+
+  BPlusTreeIndex *index_;
+  std::string column_;
+  std::string last_key_;      // 已读取的最大键
+  size_t last_key_count_ = 0; // 已读取的等于last_key_的条目数
+  size_t chunk_size_ = 0;
+  size_t entries_read_ = 0;
+  bool exhausted_ = false;
+};
+
+// ==================== 行处理算子 ====================
+
+/**
+ * @brief 过滤算子
+ */
+class FilterOperator : public PhysicalOperator {
+public:
+  FilterOperator(OperatorPtr child, RowPredicate predicate,
+                 const std::string &description);
+
+  /**
+   * @brief 使用编译后的谓词，按批求值得到选择向量，只搬移选中的行
+   */
+  FilterOperator(OperatorPtr child, CompiledPredicate predicate,
+                 const std::string &description);
+
+  bool next(RowBatch &batch) override;
+  std::string describe() const override;
+
+private:
+  RowPredicate predicate_;
+  CompiledPredicate compiled_;
+  bool vectorized_ = false;
+  SelectionVector selection_;
+  std::string description_;
+  RowBatch input_;
+};
+
+/**
+ * @brief 投影算子
+ */
+class ProjectOperator : public PhysicalOperator {
+public:
+  ProjectOperator(OperatorPtr child, const std::vector<std::string> &columns);
+
+  bool next(RowBatch &batch) override;
+  std::string describe() const override;
+
+private:
+  std::vector<size_t> indexes_;
+};
+
+/**
+ * @brief 等值连接使用的哈希表
+ * 以构建侧行中的键值指针作为哈希键，同键行通过next链表串联（保持输入顺序），
+ * 并记录每个构建行是否被匹配，外连接只需一次探测即可输出未匹配行。
+ * 构建所用的行集合在哈希表使用期间必须保持不变。
+ */
+class JoinHashTable {
+public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  void build(const std::vector<Row> &rows, size_t key_index);
+  void clear();
+
+  /**
+   * @brief 查找与key相等的第一个构建行
+   * @return 构建行下标，没有匹配时返回npos
+   */
+  size_t find(const Value &key) const;
+  size_t next(size_t row_index) const { return next_[row_index]; }
+
+  void mark_matched(size_t row_index) { matched_[row_index] = true; }
+  bool matched(size_t row_index) const { return matched_[row_index]; }
+  size_t size() const { return next_.size(); }
+
+private:
+  struct KeyHash {
+    size_t operator()(const Value *value) const;
+  };
+  struct KeyEqual {
+    bool operator()(const Value *left, const Value *right) const;
+  };
+
+  std::unordered_map<const Value *, size_t, KeyHash, KeyEqual> heads_;
+  std::vector<size_t> next_;
+  std::vector<bool> matched_;
+};
+
+/**
+ * @brief 连接算子
+ * 右子树在open()时物化为内表，左子树按批流式驱动；
+ * 连接条件在构造时解析一次，等值连接在内表上建立哈希表
+ */
+class JoinOperator : public PhysicalOperator {
+public:
+  JoinOperator(OperatorPtr left, OperatorPtr right, JoinType join_type,
+               const std::string &join_condition);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+private:
+  size_t first_candidate(const Row &outer_row) const;
+  size_t next_candidate(size_t inner_index) const;
+  Row merge(const Row &left_row, const Row &right_row) const;
+
+  JoinType join_type_;
+  std::string join_condition_;
+  bool has_keys_ = false;
+  size_t left_key_ = 0;
+  size_t right_key_ = 0;
+  size_t left_width_ = 0;
+  size_t right_width_ = 0;
+
+  std::vector<Row> inner_rows_;
+  std::vector<bool> inner_matched_;
+  JoinHashTable hash_table_;
+  RowBatch outer_;
+  size_t outer_position_ = 0;
+  size_t inner_position_ = 0;
+  bool probe_started_ = false;
+  bool outer_matched_ = false;
+  bool outer_exhausted_ = false;
+  size_t unmatched_position_ = 0;
+};
+
+/**
+ * @brief 索引嵌套循环连接算子
+ *
+ * 外表按批流式读取，每批收集去重后的连接键，逐个在内表的B+树索引上查找，
+ * 把命中的记录位置按(页号, 偏移)排序去重后再读取，使每批只按顺序访问包含
+ * 匹配记录的页，同一页内的记录只需固定一次页。内表不做全表扫描，
+ * 因此只支持INNER JOIN和LEFT JOIN。
+ */
+class IndexNestedLoopJoinOperator : public PhysicalOperator {
+public:
+  IndexNestedLoopJoinOperator(OperatorPtr outer,
+                              std::shared_ptr<TableStorageManager> table_storage,
+                              const std::string &table_name,
+                              std::shared_ptr<TableMetadata> metadata,
+                              BPlusTreeIndex *index,
+                              const std::string &outer_key,
+                              JoinType join_type);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+  size_t index_lookups() const { return index_lookups_; }
+  size_t pages_touched() const { return pages_touched_; }
+
+protected:
+  /**
+   * @brief 在索引上查找一个键
+   */
+  virtual std::vector<IndexEntry> lookup(const std::string &key) const;
+
+  /**
+   * @brief 读取一条内表记录，位置已按页号排序
+   */
+  virtual std::vector<std::string> fetch(int32_t page_id, size_t offset) const;
+
+private:
+  void probe_batch();
+
+  std::shared_ptr<TableStorageManager> table_storage_;
+  std::string table_name_;
+  std::shared_ptr<TableMetadata> metadata_;
+  BPlusTreeIndex *index_;
+  std::string outer_key_name_;
+  size_t outer_key_ = 0;
+  JoinType join_type_;
+  size_t outer_width_ = 0;
+  size_t inner_width_ = 0;
+
+  RowBatch outer_;
+  std::vector<Row> pending_;
+  size_t pending_position_ = 0;
+  bool outer_exhausted_ = false;
+  size_t index_lookups_ = 0;
+  size_t pages_touched_ = 0;
+};
+
+/**
+ * @brief 哈希半连接/反连接算子
+ * 内表在open()时物化并按连接键建立哈希表，外表按批流式读取，只输出在内表
+ * 中有匹配（反连接：没有匹配）的外表行，每个外表行至多输出一次，输出列与
+ * 外表相同。EXISTS/IN子查询去相关后由该算子执行。
+ */
+class SemiJoinOperator : public PhysicalOperator {
+public:
+  /**
+   * @throws Exception 连接键列不存在
+   */
+  SemiJoinOperator(OperatorPtr outer, OperatorPtr inner,
+                   const std::string &outer_key, const std::string &inner_key,
+                   bool anti);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+  bool anti() const { return anti_; }
+
+private:
+  std::string outer_key_name_;
+  std::string inner_key_name_;
+  size_t outer_key_ = 0;
+  size_t inner_key_ = 0;
+  bool anti_;
+
+  std::vector<Row> inner_rows_;
+  JoinHashTable hash_table_;
+  RowBatch outer_;
+};
+
+// ==================== 阻塞算子 ====================
+
+/**
+ * @brief 聚合函数描述
+ * column为空表示COUNT(*)
+ */
+struct AggregateSpec {
+  enum Function { COUNT, SUM, AVG, MIN, MAX };
+  Function function;
+  std::string column;
+  std::string alias;
+};
+
+/**
+ * @brief 聚合阶段，用于两阶段（并行）聚合
+ *
+ * PARTIAL输出分组键和每个聚合的部分状态（4列：alias#count、alias#int、
+ * alias#double、alias#string，最后一列的类型为聚合输入列的类型）；
+ * FINAL以PARTIAL的输出为输入，合并同一分组的部分状态后输出最终结果。
+ */
+enum class AggregatePhase { COMPLETE, PARTIAL, FINAL };
+
+/**
+ * @brief 分组哈希聚合算子
+ *
+ * 分组表采用开放寻址，按输入行直接计算分组键哈希并比较，只有出现新分组时
+ * 才复制键值。每个聚合按输入列类型选择整数、浮点或字符串累加器，状态以
+ * 原生int64/double保存。分组表超过内存限制时，把部分聚合状态按分组键排序
+ * 写入溢出文件；输入结束后多路归并各有序段，合并相同分组后按批输出。
+ * HAVING条件在聚合输出上求值。
+ */
+class AggregateOperator : public PhysicalOperator {
+public:
+  /**
+   * @throws Exception 分组列或聚合列不存在（FINAL阶段为部分状态列不存在）
+   */
+  AggregateOperator(OperatorPtr child,
+                    const std::vector<std::string> &group_by,
+                    const std::vector<AggregateSpec> &aggregates,
+                    AggregatePhase phase = AggregatePhase::COMPLETE);
+  ~AggregateOperator() override;
+
+  /**
+   * @brief 设置HAVING条件
+   * @param column 分组列或聚合输出列名（如"COUNT(*)"）
+   * @throws Exception 列不存在、操作符不受支持或处于PARTIAL阶段
+   */
+  void set_having(const std::string &column, const std::string &op,
+                  const std::string &literal);
+
+  /**
+   * @brief 设置分组表内存限制（字节），超出时溢出到磁盘
+   */
+  void set_memory_limit(size_t limit_bytes);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+  size_t group_count() const { return group_count_; }
+  size_t spilled_runs() const { return spilled_runs_; }
+  AggregatePhase phase() const { return phase_; }
+
+private:
+  // 累加器的值类型
+  enum class ValueKind { UNRESOLVED, INT, DOUBLE, STRING };
+
+  // 单个分组上单个聚合的状态
+  struct AggregateState {
+    int64_t count = 0;
+    int64_t int_value = 0;
+    double double_value = 0.0;
+    std::string string_value;
+  };
+
+  struct SpillRun;
+
+  void consume();
+  size_t find_or_add_group(const Row &row, size_t hash);
+  void grow_slots();
+  void update_state(AggregateState &state, size_t aggregate,
+                    const Row &row);
+  void merge_state(AggregateState &target, const AggregateState &source,
+                   size_t aggregate) const;
+  Value finalize_state(const AggregateState &state, size_t aggregate) const;
+  // 部分状态在行中占4列：count、int_value、double_value、string_value
+  static AggregateState read_state(const Row &row, size_t base);
+  static void append_state(const AggregateState &state,
+                           std::vector<Value> &values);
+  bool emit_group(std::vector<Value> key, const AggregateState *states,
+                  Row &out) const;
+  void spill_groups();
+  void clear_groups();
+  bool next_merged(Row &out);
+
+  std::vector<std::string> group_by_names_;
+  std::vector<size_t> group_by_;
+  std::vector<AggregateSpec> aggregates_;
+  std::vector<size_t> aggregate_columns_;
+  std::vector<size_t> state_columns_; // FINAL阶段各聚合部分状态的起始列
+  std::vector<ValueKind> kinds_;
+  AggregatePhase phase_;
+  RowPredicate having_;
+  std::string having_description_;
+  size_t memory_limit_;
+
+  // 内存中的分组表
+  std::vector<std::vector<Value>> group_keys_;
+  std::vector<size_t> group_hashes_;
+  std::vector<AggregateState> states_; // 分组g的第a个聚合位于g*聚合数+a
+  std::vector<size_t> slots_;
+  size_t memory_used_ = 0;
+
+  // 溢出段及归并状态
+  std::vector<std::unique_ptr<SpillRun>> runs_;
+  std::vector<size_t> merge_heap_;
+
+  std::vector<Row> results_;
+  bool consumed_ = false;
+  size_t position_ = 0;
+  size_t group_count_ = 0;
+  size_t spilled_runs_ = 0;
+};
+
+/**
+ * @brief 排序键
+ */
+struct SortKey {
+  std::string column;
+  bool ascending = true;
+};
+
+/**
+ * @brief 排序算子（外部归并排序）
+ *
+ * 输入按工作内存切分成段，段内按规范化二进制排序键排序（只做字节比较，
+ * 不再逐列比较Value）。输入超出工作内存时有序段写入溢出文件，最后用败者树
+ * 多路归并；段数超过归并路数上限时先做中间归并。排序是稳定的。
+ */
+class SortOperator : public PhysicalOperator {
+public:
+  SortOperator(OperatorPtr child, const std::vector<SortKey> &keys);
+  ~SortOperator() override;
+
+  /**
+   * @brief 设置工作内存（字节），决定内存段大小和归并路数
+   */
+  void set_memory_limit(size_t limit_bytes);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+  size_t spilled_runs() const { return spilled_runs_; }
+  size_t merge_passes() const { return merge_passes_; }
+
+private:
+  struct SortRun;
+
+  void consume();
+  void sort_buffer();
+  void spill_buffer();
+  std::unique_ptr<SortRun> merge_runs(std::vector<std::unique_ptr<SortRun>> runs);
+  size_t max_fan_in() const;
+  bool next_merged(Row &out);
+
+  std::vector<SortKey> keys_;
+  std::vector<size_t> key_indexes_;
+  size_t memory_limit_;
+
+  // 当前内存段：行、对应的排序键以及排序后的顺序
+  std::vector<Row> rows_;
+  std::vector<std::string> row_keys_;
+  std::vector<size_t> order_;
+  size_t memory_used_ = 0;
+
+  // 溢出段和最终归并使用的败者树
+  std::vector<std::unique_ptr<SortRun>> runs_;
+  std::vector<size_t> loser_tree_;
+
+  bool sorted_ = false;
+  size_t position_ = 0;
+  size_t spilled_runs_ = 0;
+  size_t merge_passes_ = 0;
+};
+
+/**
+ * @brief Top-N算子（ORDER BY ... LIMIT/OFFSET）
+ * 用大小为offset+limit的有界堆代替全量排序，内存与页大小而不是表大小成正比。
+ * 结果与SortOperator+LimitOperator相同，同键时保持输入顺序
+ */
+class TopNOperator : public PhysicalOperator {
+public:
+  TopNOperator(OperatorPtr child, const std::vector<SortKey> &keys,
+               size_t limit, size_t offset = 0);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+private:
+  struct Entry {
+    std::string key;
+    size_t sequence; // 输入顺序，保证同键时结果稳定
+    Row row;
+  };
+
+  void consume();
+
+  std::vector<SortKey> keys_;
+  std::vector<size_t> key_indexes_;
+  size_t limit_;
+  size_t offset_;
+  size_t capacity_; // offset + limit
+  std::vector<Entry> heap_; // 最大堆，堆顶是保留行中排在最后的一行
+  bool consumed_ = false;
+  size_t position_ = 0;
+};
+
+/**
+ * @brief 窗口函数描述
+ *
+ * 帧以相对当前行的偏移表示（负数为PRECEDING，正数为FOLLOWING），
+ * 如 ROWS BETWEEN 2 PRECEDING AND 1 FOLLOWING 为 [-2, 1]。
+ * 未指定帧时按SQL默认：有ORDER BY为从分区开始到当前行的最后一个同序行，
+ * 否则为整个分区。
+ */
+struct WindowSpec {
+  enum Function {
+    ROW_NUMBER,
+    RANK,
+    DENSE_RANK,
+    LAG,
+    LEAD,
+    SUM,
+    COUNT,
+    AVG,
+    MIN,
+    MAX
+  };
+  static constexpr int64_t kUnboundedPreceding =
+      std::numeric_limits<int64_t>::min();
+  static constexpr int64_t kUnboundedFollowing =
+      std::numeric_limits<int64_t>::max();
+
+  Function function;
+  std::string column;  // 参数列，ROW_NUMBER/RANK/COUNT(*)为空
+  std::vector<std::string> partition_by;
+  std::vector<SortKey> order_by;
+  int64_t offset = 1;  // LAG/LEAD的偏移
+  Value default_value; // LAG/LEAD越过分区边界时的值
+  bool has_frame = false;
+  int64_t frame_start = kUnboundedPreceding;
+  int64_t frame_end = 0;
+  std::string alias;   // 输出列名
+};
+
+/**
+ * @brief 窗口函数算子
+ *
+ * 输入在open()后全部物化，按(PARTITION BY, ORDER BY)相同的窗口函数分组，
+ * 每组只排序一次（稳定排序，键为encode_sort_key编码），并在一次扫描中计算
+ * 组内所有函数。帧的起止位置随当前行单调前移，SUM/COUNT/AVG使用可撤销的
+ * 累加器，MIN/MAX使用单调队列，滑动帧每行均摊O(1)。
+ * 输出为输入列加每个窗口函数一列，行按第一组的排序顺序输出。
+ */
+class WindowOperator : public PhysicalOperator {
+public:
+  /**
+   * @throws Exception 列不存在或函数参数不合法
+   */
+  WindowOperator(OperatorPtr child, const std::vector<WindowSpec> &windows);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  void close() override;
+  std::string describe() const override;
+
+  /**
+   * @brief 实际执行的排序次数（相同窗口定义共享一次排序）
+   */
+  size_t sorts_performed() const { return sorts_performed_; }
+
+private:
+  struct WindowGroup {
+    std::vector<size_t> partition_indexes;
+    std::vector<SortKey> order_by;
+    std::vector<size_t> order_indexes;
+    std::vector<size_t> functions; // windows_中的下标
+  };
+
+  void consume();
+  void compute_group(const WindowGroup &group, std::vector<size_t> &order);
+  void compute_function(size_t function, const std::vector<size_t> &order,
+                        size_t begin, size_t end,
+                        const std::vector<size_t> &peer_end);
+
+  std::vector<WindowSpec> windows_;
+  std::vector<size_t> argument_indexes_;
+  std::vector<bool> integer_sum_;
+  std::vector<WindowGroup> groups_;
+  size_t input_width_ = 0;
+
+  std::vector<Row> rows_;
+  std::vector<size_t> output_order_;
+  bool consumed_ = false;
+  size_t position_ = 0;
+  size_t sorts_performed_ = 0;
+};
+
+/**
+ * @brief LIMIT/OFFSET算子
+ * 向子算子请求的批大小不超过仍需要的行数，满足后不再拉取
+ */
+class LimitOperator : public PhysicalOperator {
+public:
+  LimitOperator(OperatorPtr child, size_t limit, size_t offset = 0);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  std::string describe() const override;
+
+private:
+  size_t limit_;
+  size_t offset_;
+  size_t skipped_ = 0;
+  size_t emitted_ = 0;
+  RowBatch input_;
+};
+
+/**
+ * @brief UNION ALL算子
+ * 依次把左、右子算子的批直接转发给上层，不复制也不物化行
+ * @throws Exception 两侧列数不同
+ */
+class UnionAllOperator : public PhysicalOperator {
+public:
+  UnionAllOperator(OperatorPtr left, OperatorPtr right);
+
+  void open() override;
+  bool next(RowBatch &batch) override;
+  std::string describe() const override;
+
+private:
+  size_t current_ = 0;
+};
+
+// ==================== 辅助函数 ====================
+
+/**
+ * @brief 比较两个值，整数与浮点数按数值比较
+ * @return 小于返回负数，相等返回0，大于返回正数
+ */
+int compare_values(const Value &left, const Value &right);
+
+/**
+ * @brief 把值编码为可按字节比较的排序键并追加到out
+ * 编码后按字节(memcmp)比较的结果与compare_values一致：数值在字符串之前，
+ * 降序时所有字节取反
+ */
+void encode_sort_key(const Value &value, bool ascending, std::string &out);
+
+/**
+ * @brief 计算值的哈希，整数值的浮点数与对应整数哈希相同
+ */
+size_t hash_value(const Value &value);
+
+/**
+ * @brief 按列名查找列位置，支持"table.column"形式；
+ * 输出列带表名前缀时不带前缀的列名匹配第一个同名列
+ * @throws Exception 列不存在
+ */
+size_t resolve_column(const std::vector<ColumnMeta> &columns,
+                      const std::string &name);
+
+/**
+ * @brief 将字符串按列类型转换为Value，无法解析时保留为字符串
+ */
+Value parse_value(const std::string &text, const std::string &data_type);
+
+/**
+ * @brief 生成"列 操作符 常量"形式的谓词
+ * 列位置和常量类型只解析一次，操作符支持 = <> != < > <= >=
+ * @throws Exception 列不存在或操作符不受支持
+ */
+RowPredicate make_comparison_predicate(const std::vector<ColumnMeta> &columns,
+                                       const std::string &column,
+                                       const std::string &op,
+                                       const std::string &literal);
+
+/**
+ * @brief 为两个子树选择连接算子
+ * inner为TableScanOperator且inner_index是内表连接键上的索引时，按
+ * choose_join_algorithm的代价估计决定是否使用索引嵌套循环连接，
+ * 否则使用JoinOperator（等值条件下为哈希连接）
+ * @param outer_rows 外表估计行数
+ * @param inner_rows 内表估计行数
+ * @throws Exception 连接条件无法解析
+ */
+OperatorPtr plan_join(OperatorPtr outer, size_t outer_rows, OperatorPtr inner,
+                      size_t inner_rows, BPlusTreeIndex *inner_index,
+                      JoinType join_type, const std::string &join_condition);
+
+/**
+ * @brief 执行算子树并收集全部结果
+ * @param root 根算子
+ * @param batch_size 批大小
+ */
+ExecutionResult execute_operator_tree(PhysicalOperator &root,
+                                      size_t batch_size = kDefaultBatchSize);
+
+} // namespace sqlcc
+
+#endif // SQLCC_PHYSICAL_OPERATOR_H
@@ -0,0 +1,154 @@
+#ifndef SQLCC_RESULT_CACHE_H
+#define SQLCC_RESULT_CACHE_H
+
+#include "execution_result.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace sqlcc {
+
+/**
+ * @brief 查询结果缓存的默认内存上限（字节）
+ */
+constexpr size_t kDefaultResultCacheBytes = 64 * 1024 * 1024;
+
+/**
+ * @brief 查询结果缓存
+ *
+ * 服务器范围内共享（shared()），缓存只读SELECT的完整结果。键由规范化的
+ * SQL文本与权限上下文（当前数据库和用户）组成，不同用户之间不共享结果。
+ * 每个条目记录所读各表在执行前的版本。修改表的写入在begin_write()与
+ * commit_write()/abort_write()之间进行：期间依赖该表的条目不命中，读到
+ * 该表的结果不放入缓存（可能含未提交的行）；提交时版本加一并删除依赖
+ * 条目，回滚不影响已缓存的结果。DDL直接调用invalidate_table()。查找时
+ * 再次核对版本，执行期间表被修改的结果不会放入缓存。条目总大小超过内存
+ * 上限时按LRU淘汰。所有操作线程安全
+ */
+class QueryResultCache {
+public:
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t inserts = 0;
+    size_t evictions = 0;     // 因内存上限被淘汰的条目数
+    size_t invalidations = 0; // 因表被修改而删除的条目数
+    size_t entries = 0;
+    size_t bytes = 0;
+    size_t capacity = 0;
+  };
+
+  static QueryResultCache &shared();
+
+  explicit QueryResultCache(size_t capacity_bytes = kDefaultResultCacheBytes);
+
+  /**
+   * @brief 规范化SQL文本：字符串和引号标识符之外的连续空白合并为一个空格，
+   * 去掉标点和运算符两侧的空白以及末尾的分号。不改变大小写（标识符可能
+   * 区分大小写）
+   */
+  static std::string normalize_sql(const std::string &sql);
+
+  /**
+   * @brief 由数据库、用户和SQL文本生成缓存键
+   */
+  static std::string make_key(const std::string &database,
+                              const std::string &user, const std::string &sql);
+
+  /**
+   * @brief 读取各表的当前版本，在执行查询之前调用，随结果一起传给insert()
+   */
+  std::vector<uint64_t> table_versions(const std::string &database,
+                                       const std::vector<std::string> &tables) const;
+
+  /**
+   * @brief 查找缓存结果，命中时该条目成为最近使用
+   * @return 未命中或条目已失效时返回nullptr
+   */
+  std::shared_ptr<const ExecutionResult> lookup(const std::string &key);
+
+  /**
+   * @brief 放入查询结果
+   * 执行期间任一表的版本发生变化，或结果本身超过内存上限时不缓存
+   * @param versions 执行前由table_versions()读取的版本
+   */
+  void insert(const std::string &key, const std::string &database,
+              const std::vector<std::string> &tables,
+              const std::vector<uint64_t> &versions, ExecutionResult result);
+
+  /**
+   * @brief 表被修改：版本加一并删除依赖该表的全部条目
+   */
+  void invalidate_table(const std::string &database, const std::string &table);
+
+  /**
+   * @brief 开始修改表，之后必须调用commit_write()或abort_write()之一
+   * 同一张表可以有多个未结束的写入，全部结束前该表的结果不命中也不缓存
+   */
+  void begin_write(const std::string &database, const std::string &table);
+
+  /**
+   * @brief 修改已提交：结束写入，版本加一并删除依赖该表的全部条目
+   */
+  void commit_write(const std::string &database, const std::string &table);
+
+  /**
+   * @brief 修改已回滚：结束写入，表恢复为写入前已提交的内容，已缓存的
+   * 结果仍然有效，版本不变
+   */
+  void abort_write(const std::string &database, const std::string &table);
+
+  /**
+   * @brief 删除全部条目（删除数据库、回收权限等），表版本保持递增
+   */
+  void clear();
+
+  /**
+   * @brief 设置内存上限，超出时立即按LRU淘汰
+   */
+  void set_capacity(size_t bytes);
+
+  Stats stats() const;
+
+private:
+  struct Entry {
+    std::shared_ptr<const ExecutionResult> result;
+    std::vector<std::string> tables; // 表键（数据库+表名）
+    std::vector<uint64_t> versions;
+    size_t bytes = 0;
+    std::list<std::string>::iterator lru;
+  };
+
+  static std::string table_key(const std::string &database,
+                               const std::string &table);
+  static size_t estimate_bytes(const std::string &key,
+                               const ExecutionResult &result);
+
+  uint64_t version_locked(const std::string &table_key) const;
+  bool writing_locked(const std::string &table_key) const;
+  void invalidate_locked(const std::string &table_key);
+  void end_write_locked(const std::string &table_key);
+  void erase_locked(std::unordered_map<std::string, Entry>::iterator it);
+  void evict_locked(size_t capacity);
+
+  mutable std::mutex mutex_;
+  size_t capacity_;
+  size_t bytes_ = 0;
+  std::unordered_map<std::string, Entry> entries_;
+  std::list<std::string> lru_; // 头部为最近使用
+  std::unordered_map<std::string, uint64_t> versions_;
+  // 表键 -> 未结束的写入数
+  std::unordered_map<std::string, size_t> pending_writes_;
+  // 表键 -> 依赖该表的条目键
+  std::unordered_map<std::string, std::unordered_set<std::string>> dependents_;
+  Stats stats_;
+};
+
+} // namespace sqlcc
+
+#endif // SQLCC_RESULT_CACHE_H
@@ -1,6 +1,7 @@
 #ifndef SQLCC_SET_OPERATION_EXECUTOR_H
 #define SQLCC_SET_OPERATION_EXECUTOR_H
 
+#include "execution/spill_file.h"
 #include "execution_result.h"
 #include "sql_parser/set_operation_node.h"
 #include <chrono>
@@ -25,21 +26,12 @@ struct ExecutionStats {
   std::chrono::milliseconds left_execution_time{};
   std::chrono::milliseconds right_execution_time{};
   std::chrono::milliseconds operation_execution_time{};
+  size_t spilled_partitions = 0; // 超出内存限制时写入磁盘的分区数
+  size_t spilled_bytes = 0;
   bool has_error = false;
   std::optional<std::string> error_message;
 };
 
-// 行键结构（用于去重操作）
-struct RowKey {
-  std::vector<Value> values;
-
-  bool operator==(const RowKey &other) const { return values == other.values; }
-
-  struct Hash {
-    size_t operator()(const RowKey &key) const;
-  };
-};
-
 // 集合操作执行器
 class SetOperationExecutor {
 public:
@@ -62,10 +54,9 @@ public:
   ExecutionStats get_stats() const;
 
 private:
-  // 执行UNION操作
+  // 执行UNION操作（UNION ALL时移动两侧的行）
   ExecutionResult execute_union(const SetOperationNode &operation,
-                                const ExecutionResult &left,
-                                const ExecutionResult &right);
+                                ExecutionResult &left, ExecutionResult &right);
 
   // 执行INTERSECT操作
   ExecutionResult execute_intersect(const SetOperationNode &operation,
@@ -99,17 +90,31 @@ public:
   static ExecutionResult union_all(const ExecutionResult &left,
                                    const ExecutionResult &right);
 
+  // 合并两个结果集（UNION ALL），直接移动两侧的行而不复制
+  static ExecutionResult union_all(ExecutionResult &&left,
+                                   ExecutionResult &&right);
+
+  // 以下去重/计数操作使用只保存行指纹和行引用的哈希表，指纹相同时才比较整行。
+  // 哈希表超出memory_limit时按指纹把两侧输入分区写入磁盘，再逐个分区处理。
+  // stats非空时记录内存使用和溢出情况
+
   // 合并两个结果集并去重（UNION）
-  static ExecutionResult union_distinct(const ExecutionResult &left,
-                                        const ExecutionResult &right);
+  static ExecutionResult
+  union_distinct(const ExecutionResult &left, const ExecutionResult &right,
+                 size_t memory_limit = kDefaultOperatorMemoryLimit,
+                 ExecutionStats *stats = nullptr);
 
   // 求交集（INTERSECT）
-  static ExecutionResult intersect(const ExecutionResult &left,
-                                   const ExecutionResult &right, bool all);
+  static ExecutionResult
+  intersect(const ExecutionResult &left, const ExecutionResult &right, bool all,
+            size_t memory_limit = kDefaultOperatorMemoryLimit,
+            ExecutionStats *stats = nullptr);
 
   // 求差集（EXCEPT）
-  static ExecutionResult except(const ExecutionResult &left,
-                                const ExecutionResult &right, bool all);
+  static ExecutionResult
+  except(const ExecutionResult &left, const ExecutionResult &right, bool all,
+         size_t memory_limit = kDefaultOperatorMemoryLimit,
+         ExecutionStats *stats = nullptr);
 
   // 流式处理支持
   class StreamingProcessor {
@@ -127,12 +132,6 @@ public:
   // 暂时注释掉，因为当前没有实现且未使用
   // static std::unique_ptr<StreamingProcessor>
   // create_streaming_processor(SetOperationType operation_type, bool all);
-
-private:
-  // 生成行键（用于去重操作）
-  static RowKey
-  generate_row_key(const Row &row,
-                   const std::vector<ColumnMeta> &column_metadata);
 };
 
 // 集合操作专用异常
@@ -0,0 +1,109 @@
+#ifndef SQLCC_SIMD_FILTER_H
+#define SQLCC_SIMD_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sqlcc {
+
+/**
+ * @brief 比较操作符
+ */
+enum class CompareOp { EQ, NE, LT, LE, GT, GE };
+
+/**
+ * @brief 过滤内核使用的指令集
+ *
+ * 运行时检测CPU支持的最高级别，不支持的级别退回标量实现，
+ * 因此编译时不需要-mavx2。
+ */
+enum class SimdLevel { SCALAR, SSE42, AVX2 };
+
+/**
+ * @brief 选择向量：批内满足谓词的行下标（升序）
+ */
+using SelectionVector = std::vector<uint32_t>;
+
+/**
+ * @brief 位图按64位字存储，第i行对应words[i / 64]的第(i % 64)位
+ */
+inline size_t bitmap_words(size_t count) { return (count + 63) / 64; }
+
+inline bool bitmap_test(const uint64_t *bitmap, size_t index) {
+  return (bitmap[index / 64] >> (index % 64)) & 1;
+}
+
+inline void bitmap_set(uint64_t *bitmap, size_t index) {
+  bitmap[index / 64] |= uint64_t(1) << (index % 64);
+}
+
+/**
+ * @brief CPU支持的最高指令集级别
+ */
+SimdLevel detect_simd_level();
+
+/**
+ * @brief 当前内核使用的指令集级别，默认为detect_simd_level()
+ */
+SimdLevel active_simd_level();
+
+/**
+ * @brief 设置内核使用的指令集级别（超出CPU支持时取CPU支持的最高级别）
+ * @return 实际生效的级别
+ */
+SimdLevel set_simd_level(SimdLevel level);
+
+const char *simd_level_name(SimdLevel level);
+
+// ==================== 过滤内核 ====================
+// 内核把结果写入mask（bitmap_words(count)个字，满足条件的位为1，
+// 末尾多余的位清零），多个条件之间用bitmap_and/bitmap_or组合。
+
+void compare_mask(const int64_t *values, size_t count, CompareOp op,
+                  int64_t constant, uint64_t *mask,
+                  SimdLevel level = active_simd_level());
+void compare_mask(const double *values, size_t count, CompareOp op,
+                  double constant, uint64_t *mask,
+                  SimdLevel level = active_simd_level());
+
+/**
+ * @brief low <= value <= high
+ */
+void between_mask(const int64_t *values, size_t count, int64_t low,
+                  int64_t high, uint64_t *mask,
+                  SimdLevel level = active_simd_level());
+void between_mask(const double *values, size_t count, double low, double high,
+                  uint64_t *mask, SimdLevel level = active_simd_level());
+
+/**
+ * @brief value等于list中的任意一个
+ */
+void in_list_mask(const int64_t *values, size_t count, const int64_t *list,
+                  size_t list_size, uint64_t *mask,
+                  SimdLevel level = active_simd_level());
+void in_list_mask(const double *values, size_t count, const double *list,
+                  size_t list_size, uint64_t *mask,
+                  SimdLevel level = active_simd_level());
+
+/**
+ * @brief mask &= other / mask |= other，用于组合条件与有效位图
+ */
+void bitmap_and(uint64_t *mask, const uint64_t *other, size_t count);
+void bitmap_or(uint64_t *mask, const uint64_t *other, size_t count);
+
+/**
+ * @brief mask取反（末尾多余的位保持为0）
+ */
+void bitmap_not(uint64_t *mask, size_t count);
+
+/**
+ * @brief 把位图转换为选择向量
+ * @return 选中的行数
+ */
+size_t mask_to_selection(const uint64_t *mask, size_t count,
+                         SelectionVector &selection);
+
+} // namespace sqlcc
+
+#endif // SQLCC_SIMD_FILTER_H
@@ -0,0 +1,109 @@
+#ifndef SQLCC_SPILL_FILE_H
+#define SQLCC_SPILL_FILE_H
+
+#include "execution_result.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sqlcc {
+
+// 前向声明
+class DiskManager;
+
+/**
+ * @brief 算子默认内存限制（字节）
+ */
+constexpr size_t kDefaultOperatorMemoryLimit = 1024 * 1024 * 1024; // 1GB
+
+/**
+ * @brief 行读取器，每次返回下一行，输入耗尽时返回nullptr
+ * 返回的指针只在下一次调用前有效
+ */
+using RowReader = std::function<const Row *()>;
+
+/**
+ * @brief 从内存中的行集合创建读取器
+ */
+RowReader make_row_reader(const std::vector<Row> &rows);
+
+/**
+ * @brief 估算一行在内存中占用的字节数
+ */
+size_t estimate_row_size(const Row &row);
+
+/**
+ * @brief 算子溢出文件
+ *
+ * 超出内存预算的算子（Hash JOIN、排序、聚合等）把行序列化后顺序写入
+ * 临时文件。文件按PAGE_SIZE页组织并通过DiskManager进行页读写，行可以
+ * 跨页存放。先append()写入全部行，再rewind()后顺序read()，可多次重读。
+ * 对象析构时删除临时文件。
+ */
+class SpillFile {
+public:
+  SpillFile();
+  ~SpillFile();
+
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  /**
+   * @brief 追加一行
+   * @throws IOException 写页失败
+   */
+  void append(const Row &row);
+
+  /**
+   * @brief 刷出未写满的页并回到文件开头
+   */
+  void rewind();
+
+  /**
+   * @brief 读取下一行
+   * @return 行指针，只在下一次read()前有效；读完时返回nullptr
+   * @throws IOException 读页失败
+   */
+  const Row *read();
+
+  /**
+   * @brief 创建读取本文件的读取器（会先rewind()）
+   */
+  RowReader reader();
+
+  size_t row_count() const { return row_count_; }
+  size_t page_count() const { return pages_.size(); }
+  size_t bytes_written() const { return bytes_written_; }
+  /**
+   * @brief 文件中所有行的估算内存大小，用于判断能否整体装入内存
+   */
+  size_t memory_size() const { return memory_size_; }
+
+private:
+  void write_bytes(const char *data, size_t size);
+  bool read_bytes(char *data, size_t size);
+  void flush_page();
+
+  std::string path_;
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::vector<int32_t> pages_;
+
+  std::vector<char> write_page_;
+  size_t write_offset_ = 0;
+  size_t row_count_ = 0;
+  size_t bytes_written_ = 0;
+  size_t memory_size_ = 0;
+
+  std::vector<char> read_page_;
+  size_t read_page_index_ = 0;
+  size_t read_offset_ = 0;
+  size_t rows_read_ = 0;
+
+  std::string buffer_;
+  Row current_;
+};
+
+} // namespace sqlcc
+
+#endif // SQLCC_SPILL_FILE_H
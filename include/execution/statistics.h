@@ -0,0 +1,305 @@
+#ifndef SQLCC_STATISTICS_H
+#define SQLCC_STATISTICS_H
+
+#include "execution_result.h"
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sqlcc {
+
+class TableScanOperator;
+
+/**
+ * @brief ANALYZE为每列生成的等深直方图桶数
+ */
+constexpr size_t kDefaultHistogramBuckets = 32;
+
+/**
+ * @brief ANALYZE默认最多读取的页数，超过时按页随机采样
+ */
+constexpr size_t kDefaultSamplePages = 1000;
+
+/**
+ * @brief 行水库样本的默认容量，直方图由水库样本生成
+ */
+constexpr size_t kDefaultReservoirSize = 30000;
+
+/**
+ * @brief HyperLogLog默认精度：4096个寄存器，标准误差约1.6%
+ */
+constexpr uint8_t kDefaultHllPrecision = 12;
+
+/**
+ * @brief 自动ANALYZE阈值：修改行数超过 基数 + 比例 * 行数 时重新收集
+ */
+constexpr size_t kAutoAnalyzeBaseThreshold = 50;
+constexpr double kAutoAnalyzeScaleFactor = 0.1;
+
+/**
+ * @brief HyperLogLog不同值个数草图
+ * 每个值哈希后按低位选择寄存器，寄存器记录其余位中首个1的最大位置。
+ * 内存固定为2^precision字节，同精度的草图可以合并（取寄存器最大值），
+ * 因此各工作线程或分区可以分别统计后再合并
+ */
+class HyperLogLog {
+public:
+  explicit HyperLogLog(uint8_t precision = kDefaultHllPrecision);
+
+  void add(const Value &value);
+  void add_hash(uint64_t hash);
+
+  /**
+   * @brief 合并另一个草图
+   * @throws Exception 精度不同
+   */
+  void merge(const HyperLogLog &other);
+
+  /**
+   * @brief 估计不同值个数，基数较小时使用线性计数修正
+   */
+  double estimate() const;
+
+  uint8_t precision() const { return precision_; }
+
+private:
+  uint8_t precision_;
+  std::vector<uint8_t> registers_;
+};
+
+/**
+ * @brief 行水库样本（Algorithm R）
+ * 流式读取任意多行，始终保留容量以内的等概率样本。两个样本可以按
+ * 各自读取的行数加权合并，结果仍是并集上的等概率样本
+ */
+class ReservoirSample {
+public:
+  ReservoirSample(size_t capacity, uint64_t seed);
+
+  void add(const Row &row);
+  void merge(ReservoirSample &&other);
+
+  const std::vector<Row> &rows() const { return rows_; }
+  size_t capacity() const { return capacity_; }
+  // 读取过的总行数
+  size_t seen() const { return seen_; }
+  // 样本是否包含了读取过的全部行
+  bool complete() const { return seen_ == rows_.size(); }
+
+private:
+  size_t capacity_;
+  size_t seen_ = 0;
+  std::vector<Row> rows_;
+  uint64_t state_;
+
+  uint64_t next_random();
+};
+
+/**
+ * @brief 列统计信息
+ */
+struct ColumnStatistics {
+  std::string column_name;
+  std::string data_type;
+  double null_fraction = 0.0;  // NULL值所占比例
+  double distinct_count = 0.0; // 非NULL值的不同值个数
+  // 等深直方图的桶边界（升序），histogram[0]为最小值，最后一个为最大值，
+  // 相邻边界之间的非NULL行数相同
+  std::vector<Value> histogram;
+
+  /**
+   * @brief 估计非NULL行中不大于（inclusive为false时小于）value的比例
+   */
+  double fraction_below(const Value &value, bool inclusive) const;
+
+  /**
+   * @brief 估计"列 操作符 常量"在全部行中的选择率
+   * 操作符支持 = <> != < > <= >=、[NOT] BETWEEN（常量为"low AND high"）
+   * 和[NOT] IN（常量为"(v1, v2)"），其余操作符返回默认选择率
+   */
+  double selectivity(const std::string &op, const std::string &literal) const;
+};
+
+/**
+ * @brief 表统计信息
+ */
+struct TableStatistics {
+  std::string table_name;
+  size_t row_count = 0;
+  size_t page_count = 0;
+  std::vector<ColumnStatistics> columns;
+
+  /**
+   * @brief 按列名查找列统计信息，支持"table.column"形式
+   * @return 列没有统计信息时返回nullptr
+   */
+  const ColumnStatistics *column(const std::string &name) const;
+
+  /**
+   * @brief 估计谓词的选择率，列没有统计信息时使用默认选择率
+   */
+  double selectivity(const std::string &column, const std::string &op,
+                     const std::string &literal) const;
+};
+
+/**
+ * @brief 没有统计信息时的默认选择率
+ */
+double default_selectivity(const std::string &op);
+
+/**
+ * @brief 统计信息收集选项
+ */
+struct StatisticsOptions {
+  size_t buckets = kDefaultHistogramBuckets;
+  size_t sample_pages = kDefaultSamplePages; // 0表示读取全部页
+  size_t reservoir_size = kDefaultReservoirSize;
+  size_t parallel_degree = 1;
+  uint64_t seed = 0; // 页采样和水库采样的随机种子
+};
+
+/**
+ * @brief 单个工作线程的统计信息收集器
+ * 累计行数、每列的NULL个数和HyperLogLog草图，以及一个行水库样本。
+ * 各工作线程的收集器合并后再生成统计信息
+ */
+class StatisticsCollector {
+public:
+  StatisticsCollector(std::vector<ColumnMeta> columns,
+                      const StatisticsOptions &options, uint64_t seed);
+
+  void add_row(const Row &row);
+  void merge(StatisticsCollector &&other);
+
+  size_t rows() const { return rows_; }
+
+  /**
+   * @brief 生成统计信息
+   * 读取了全部记录时行数为精确值，否则按读取比例外推。样本包含全部行时
+   * 不同值个数精确计算；否则取HyperLogLog估计与样本上Haas-Stokes（Duj1）
+   * 估计的较大者，后者把只出现一次的值外推到全表
+   * @param pages_read 读取的页数
+   * @param total_pages 表的页数
+   */
+  TableStatistics finish(const std::string &table_name, size_t pages_read,
+                         size_t total_pages) const;
+
+private:
+  std::vector<ColumnMeta> columns_;
+  size_t buckets_;
+  size_t rows_ = 0;
+  std::vector<size_t> nulls_;
+  std::vector<HyperLogLog> sketches_;
+  ReservoirSample sample_;
+};
+
+/**
+ * @brief 扫描表并收集统计信息
+ * 行数、页数、每列的NULL比例和不同值个数，以及每列的等深直方图。
+ * 空字符串和"NULL"按NULL统计，数值列中无法解析为数值的值也按NULL统计。
+ * 表的页数超过options.sample_pages时只读取随机选取的页（页级采样），
+ * 数据页列表只在调用线程上从页目录获取一次，parallel_degree大于1时各页在工作线程上读取
+ * @param table_scan 未open的全表扫描算子
+ */
+TableStatistics collect_table_statistics(TableScanOperator &table_scan,
+                                         const StatisticsOptions &options = {});
+
+/**
+ * @brief 直方图与文本之间的转换，用于把统计信息写入系统表
+ * @throws Exception 文本格式错误
+ */
+std::string encode_histogram(const std::vector<Value> &histogram);
+std::vector<Value> decode_histogram(const std::string &text);
+
+/**
+ * @brief 统计信息目录
+ * 按（数据库, 表）保存最近一次ANALYZE的结果，供优化器估计代价。
+ * 统计信息对象不可变，更新时整体替换，读写可并发进行
+ */
+class StatisticsCatalog {
+public:
+  static StatisticsCatalog &shared();
+
+  /**
+   * @brief 保存统计信息，并清零该表的修改计数
+   */
+  void put(const std::string &database, TableStatistics statistics);
+  std::shared_ptr<const TableStatistics> get(const std::string &database,
+                                             const std::string &table) const;
+  void remove(const std::string &database, const std::string &table);
+  void clear();
+
+  /**
+   * @brief 记录DML修改的行数，只跟踪已有统计信息的表
+   * 行数按插入和删除的差值增量调整（页数按每页行数同比例调整），
+   * 三者之和累计为自上次ANALYZE以来的修改行数
+   */
+  void record_modification(const std::string &database,
+                           const std::string &table, size_t inserted,
+                           size_t deleted, size_t updated);
+  size_t modified_rows(const std::string &database,
+                       const std::string &table) const;
+
+  /**
+   * @brief 修改行数是否超过自动ANALYZE阈值
+   */
+  bool needs_analyze(const std::string &database,
+                     const std::string &table) const;
+
+private:
+  struct Entry {
+    std::shared_ptr<const TableStatistics> statistics;
+    size_t modified_rows = 0;
+  };
+
+  static std::string key(const std::string &database, const std::string &table);
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, Entry> tables_;
+};
+
+// ==================== 代价模型 ====================
+
+/**
+ * @brief 代价常量，以顺序读取一页的代价为单位
+ */
+constexpr double kSeqPageCost = 1.0;
+constexpr double kRandomPageCost = 4.0;
+constexpr double kCpuTupleCost = 0.01;
+constexpr double kCpuIndexTupleCost = 0.005;
+constexpr double kCpuOperatorCost = 0.0025;
+
+/**
+ * @brief 全表扫描代价：顺序读取全部页并对每行求值一次谓词
+ */
+double seq_scan_cost(const TableStatistics &statistics);
+
+/**
+ * @brief 索引扫描代价：索引下降、逐项读取索引和按记录位置随机读取数据页
+ * 数据页数按Mackert-Lohman公式估计，选择的行越多越接近全部页数
+ * @param selectivity 索引条件的选择率
+ */
+double index_scan_cost(const TableStatistics &statistics, double selectivity);
+
+/**
+ * @brief 按统计信息判断"列 操作符 常量"使用索引扫描是否比全表扫描便宜
+ */
+bool index_scan_is_cheaper(const TableStatistics &statistics,
+                           const std::string &column, const std::string &op,
+                           const std::string &literal);
+
+/**
+ * @brief 估计等值连接的结果行数：|L|*|R| / max(ndv(L.a), ndv(R.b))
+ * 列没有统计信息时按该侧行数作为不同值个数
+ */
+double estimate_join_rows(const TableStatistics &left,
+                          const std::string &left_column,
+                          const TableStatistics &right,
+                          const std::string &right_column);
+
+} // namespace sqlcc
+
+#endif // SQLCC_STATISTICS_H
@@ -1,11 +1,15 @@
 #ifndef SQLCC_SUBQUERY_EXECUTOR_H
 #define SQLCC_SUBQUERY_EXECUTOR_H
 
+#include "execution/physical_operator.h"
 #include "execution_context.h"
 #include "execution_result.h"
 #include "sql_parser/ast_nodes.h"
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 
 namespace sqlcc {
 
@@ -14,17 +18,59 @@ class SqlExecutor;
 class DatabaseManager;
 class UserManager;
 
+/**
+ * @brief 外层查询WHERE中的子查询谓词
+ * outer_column为IN/标量比较左侧的外层列，comparison_op只用于标量比较，
+ * 如 salary > (SELECT AVG(salary) ...)
+ */
+struct SubqueryPredicate {
+  enum Kind { EXISTS, NOT_EXISTS, IN, NOT_IN, SCALAR };
+  Kind kind;
+  std::string outer_column;
+  std::string comparison_op;
+  const sql_parser::SelectStatement *subquery;
+};
+
+/**
+ * @brief 子查询WHERE中引用外层列的相关条件：inner_column op outer_column
+ */
+struct Correlation {
+  std::string inner_column;
+  std::string op;
+  std::string outer_column;
+};
+
 /**
  * @brief 子查询执行器
  * 支持执行各种类型的子查询
+ *
+ * 规划时优先把子查询改写为连接：相关的EXISTS/NOT EXISTS改写为半连接/反连接，
+ * 不相关的IN/NOT IN改写为以子查询结果为内表的半连接/反连接，相关的聚合标量
+ * 子查询改写为按相关列分组聚合后与外表连接。无法改写时逐行求值，结果按
+ * (子查询, 相关参数值)缓存，相同参数的外层行只执行一次子查询。
  */
 class SubqueryExecutor {
+public:
+  /**
+   * @brief 子查询数据源：返回指定表的全表扫描算子
+   */
+  using SourceProvider = std::function<OperatorPtr(const std::string &table)>;
+
 private:
   std::shared_ptr<SqlExecutor> sql_executor_;
   std::shared_ptr<DatabaseManager> db_manager_;
   std::shared_ptr<UserManager> user_manager_;
   ExecutionContext context_;
 
+  SourceProvider source_provider_;
+  std::string outer_table_;
+  std::vector<ColumnMeta> outer_columns_;
+
+  // 子查询结果缓存，键为子查询签名加相关参数的编码
+  std::unordered_map<std::string, ExecutionResult> result_cache_;
+  size_t cache_hits_ = 0;
+  size_t executions_ = 0;
+
 public:
   /**
    * @brief 构造函数
@@ -99,6 +145,42 @@ public:
       std::unique_ptr<sql_parser::SelectStatement> subquery,
       const Value &outer_value, bool is_any, const std::string &comparison_op);
 
+  /**
+   * @brief 规划外层查询上的子查询谓词
+   * 能改写为连接时返回连接算子树，否则返回带缓存逐行求值的过滤算子
+   * @param outer 外层查询算子
+   * @param outer_table 外层表名或别名，用于识别相关引用
+   * @param predicate 子查询谓词
+   * @note 逐行求值的过滤算子引用本执行器和predicate.subquery，
+   *       二者须在算子树执行结束前保持有效
+   */
+  OperatorPtr plan_subquery_predicate(OperatorPtr outer,
+                                      const std::string &outer_table,
+                                      const SubqueryPredicate &predicate);
+
+  /**
+   * @brief 设置外层查询的表名（或别名）和列，逐行执行相关子查询前调用
+   */
+  void set_outer_scope(const std::string &outer_table,
+                       const std::vector<ColumnMeta> &outer_columns);
+
+  /**
+   * @brief 查找子查询WHERE中引用外层列的相关条件
+   * 值为外层表限定的列名（如 e1.dept_id），或未限定但只能解析为外层列
+   * @return 不相关时返回std::nullopt
+   */
+  std::optional<Correlation>
+  find_correlation(const sql_parser::SelectStatement &subquery) const;
+
+  /**
+   * @brief 设置子查询数据源，默认通过存储引擎扫描表
+   */
+  void set_source_provider(SourceProvider provider);
+
+  size_t cache_hits() const { return cache_hits_; }
+  size_t subquery_executions() const { return executions_; }
+  void clear_cache();
+
   /**
    * @brief 设置执行上下文
    * @param context 执行上下文
@@ -127,6 +209,24 @@ private:
   void replace_correlated_references(sql_parser::SelectStatement &subquery,
                                      const Row &outer_row);
 
+  /**
+   * @brief 执行子查询（带缓存），子查询中的相关引用按outer_row绑定
+   */
+  const ExecutionResult &
+  execute_cached(const sql_parser::SelectStatement &subquery,
+                 const Row &outer_row);
+
+  /**
+   * @brief 子查询表的全表扫描算子
+   */
+  OperatorPtr make_source(const std::string &table);
+
+  /**
+   * @brief 尝试把子查询谓词改写为连接，不能改写时返回nullptr且不消耗outer
+   */
+  OperatorPtr decorrelate(OperatorPtr &outer,
+                          const SubqueryPredicate &predicate);
+
   /**
    * @brief 评估子查询结果
    * @param result 子查询执行结果
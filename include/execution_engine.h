@@ -128,6 +128,11 @@ private:
   std::string getColumnValue(const std::vector<std::string> &record,
                              const std::string &column_name,
                              std::shared_ptr<TableMetadata> metadata);
+  // 覆盖索引的INCLUDE列在记录中的值
+  std::vector<std::string>
+  getIncludedValues(const std::vector<std::string> &record,
+                    const BPlusTreeIndex &index,
+                    std::shared_ptr<TableMetadata> metadata);
 
   // WHERE条件评估辅助方法
   // TODO: 支持AND/OR组合条件
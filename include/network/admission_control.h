@@ -0,0 +1,100 @@
+/**
+ * @file admission_control.h
+ * @brief 服务器查询准入控制头文件
+ *
+ * 该文件定义了全局进行中查询数的准入控制器：超过上限的查询按到达顺序
+ * 进入有界等待队列，队列满时直接拒绝并返回过载响应，避免负载突增时
+ * 内存无限增长
+ */
+
+#ifndef SQLCC_NETWORK_ADMISSION_CONTROL_H
+#define SQLCC_NETWORK_ADMISSION_CONTROL_H
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace sqlcc {
+namespace network {
+
+class ConnectionHandler;
+
+/**
+ * @enum AdmissionResult
+ * @brief 准入判定结果
+ */
+enum class AdmissionResult {
+    ADMITTED,  // 立即执行
+    QUEUED,    // 进入等待队列，获得名额后由服务器调度执行
+    REJECTED   // 等待队列已满，返回过载响应
+};
+
+/**
+ * @struct AdmissionStats
+ * @brief 准入控制与背压统计
+ */
+struct AdmissionStats {
+    size_t queries_admitted = 0;       ///< 立即获得名额的查询数
+    size_t queries_queued = 0;         ///< 进入等待队列的查询数
+    size_t queries_rejected = 0;       ///< 因过载被拒绝的查询数
+    size_t connections_rejected = 0;   ///< 超过最大连接数被拒绝的连接数
+    size_t read_pauses = 0;            ///< 输出缓冲超过高水位而暂停读取的次数
+    size_t inflight = 0;               ///< 当前进行中的查询数
+    size_t queued = 0;                 ///< 当前等待中的查询数
+    size_t peak_inflight = 0;          ///< 进行中查询数的峰值
+    size_t peak_output_bytes = 0;      ///< 单连接输出缓冲的峰值字节数
+};
+
+/**
+ * @class AdmissionController
+ * @brief 全局进行中查询数限制与FIFO等待队列
+ *
+ * 查询从开始执行到结果全部写入套接字之前占用一个名额，因此慢速读取的
+ * 客户端也会计入，结果缓冲的总量受max_inflight约束。每个连接最多
+ * 有一个查询在队列中等待（等待期间暂停读取该连接）。
+ */
+class AdmissionController {
+public:
+    AdmissionController(size_t max_inflight, size_t max_queued);
+
+    /**
+     * @brief 为连接上的一条查询申请名额
+     */
+    AdmissionResult TryAdmit(ConnectionHandler* handler);
+
+    /**
+     * @brief 归还一个名额
+     */
+    void Release();
+
+    /**
+     * @brief 连接关闭时从等待队列中移除
+     */
+    void Cancel(ConnectionHandler* handler);
+
+    /**
+     * @brief 取出下一个可以执行的等待连接并为其占用名额
+     * @return 没有空闲名额或队列为空时返回nullptr
+     */
+    ConnectionHandler* NextRunnable();
+
+    void SetLimits(size_t max_inflight, size_t max_queued);
+
+    void RecordConnectionRejected();
+    void RecordReadPause(size_t buffered_bytes);
+    void RecordOutputBytes(size_t buffered_bytes);
+
+    AdmissionStats GetStats() const;
+
+private:
+    mutable std::mutex mutex_;
+    size_t max_inflight_;
+    size_t max_queued_;
+    std::deque<ConnectionHandler*> waiting_;
+    AdmissionStats stats_;
+};
+
+} // namespace network
+} // namespace sqlcc
+
+#endif // SQLCC_NETWORK_ADMISSION_CONTROL_H
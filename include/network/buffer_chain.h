@@ -0,0 +1,117 @@
+/**
+ * @file buffer_chain.h
+ * @brief 网络发送缓冲链头文件
+ *
+ * 该文件定义了基于引用计数的发送缓冲链，配合writev/sendmsg实现
+ * 分散/聚集(scatter/gather)发送，避免为每条消息拼接新的缓冲区
+ */
+
+#ifndef SQLCC_NETWORK_BUFFER_CHAIN_H
+#define SQLCC_NETWORK_BUFFER_CHAIN_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
+namespace sqlcc {
+namespace network {
+
+/**
+ * @struct BufferSlice
+ * @brief 缓冲链中的一个片段
+ *
+ * 片段只引用数据，不拥有拷贝；owner保证底层内存在发送完成前有效
+ */
+struct BufferSlice {
+    std::shared_ptr<const void> owner;  ///< 底层内存的所有者（引用计数）
+    const char* data = nullptr;         ///< 片段起始地址
+    size_t length = 0;                  ///< 片段剩余长度
+};
+
+/**
+ * @class BufferChain
+ * @brief 引用计数的发送缓冲链
+ *
+ * 消息头、消息体、MAC等可以作为独立片段追加，发送时一次性
+ * 组装为iovec数组交给内核，部分发送后通过Consume推进
+ */
+class BufferChain {
+public:
+    BufferChain() = default;
+
+    /**
+     * @brief 追加一个片段
+     * @param owner 内存所有者
+     * @param data 片段起始地址（必须位于owner管理的内存中）
+     * @param length 片段长度，长度为0时忽略
+     */
+    void Append(std::shared_ptr<const void> owner, const char* data, size_t length);
+
+    /**
+     * @brief 追加整个字节容器（std::vector<char>/std::vector<uint8_t>/std::string）
+     * @param container 共享的容器，不会被拷贝
+     */
+    template <typename Container>
+    void Append(std::shared_ptr<Container> container) {
+        if (!container || container->empty()) {
+            return;
+        }
+        const char* data = reinterpret_cast<const char*>(container->data());
+        size_t length = container->size();
+        Append(std::shared_ptr<const void>(std::move(container)), data, length);
+    }
+
+    /**
+     * @brief 将另一条链的所有片段移动到本链尾部
+     * @param other 源缓冲链，调用后为空
+     */
+    void Splice(BufferChain& other);
+
+    /**
+     * @brief 丢弃链首的bytes个字节（用于部分发送后推进）
+     * @param bytes 已发送的字节数
+     */
+    void Consume(size_t bytes);
+
+    /**
+     * @brief 清空缓冲链
+     */
+    void Clear();
+
+    bool Empty() const { return slices_.empty(); }
+    size_t TotalBytes() const { return total_bytes_; }
+    size_t SliceCount() const { return slices_.size(); }
+    const BufferSlice& Front() const { return slices_.front(); }
+
+    /**
+     * @brief 收集前max_slices个片段的所有者
+     *
+     * 用于MSG_ZEROCOPY：内核完成发送前必须保持这些内存有效
+     */
+    std::vector<std::shared_ptr<const void>> CollectOwners(size_t max_slices) const;
+
+#ifdef __linux__
+    /**
+     * @brief 将链首的片段填充到iovec数组
+     * @param iov 输出的iovec数组
+     * @param max_iov 数组容量
+     * @return 实际填充的iovec数量
+     */
+    size_t FillIovec(struct iovec* iov, size_t max_iov) const;
+#endif
+
+private:
+    std::deque<BufferSlice> slices_;  ///< 待发送的片段
+    size_t total_bytes_ = 0;          ///< 待发送的总字节数
+};
+
+} // namespace network
+} // namespace sqlcc
+
+#endif // SQLCC_NETWORK_BUFFER_CHAIN_H
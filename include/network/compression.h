@@ -0,0 +1,88 @@
+/**
+ * @file compression.h
+ * @brief 网络帧压缩模块头文件
+ *
+ * 该文件定义了SQLCC网络协议使用的LZ系列快速压缩编解码器。
+ * 块格式与LZ4 block format兼容，不依赖外部压缩库。
+ */
+
+#ifndef SQLCC_NETWORK_COMPRESSION_H
+#define SQLCC_NETWORK_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sqlcc {
+namespace network {
+
+/**
+ * @class LZCodec
+ * @brief LZ4块格式的压缩与解压缩
+ *
+ * 贪心哈希匹配，单遍扫描，优先速度而非压缩率
+ */
+class LZCodec {
+public:
+    /**
+     * @brief 压缩输出的最大可能长度（不可压缩数据的最坏情况）
+     */
+    static size_t MaxCompressedSize(size_t input_size);
+
+    /**
+     * @brief 压缩一个数据块
+     * @param src 输入数据
+     * @param src_size 输入长度
+     * @param dst 输出缓冲区
+     * @param dst_capacity 输出缓冲区容量，应不小于MaxCompressedSize(src_size)
+     * @return 压缩后长度，容量不足返回0
+     */
+    static size_t Compress(const char* src, size_t src_size, char* dst, size_t dst_capacity);
+
+    /**
+     * @brief 解压缩一个数据块
+     * @param src 压缩数据
+     * @param src_size 压缩数据长度
+     * @param dst 输出缓冲区
+     * @param dst_capacity 输出缓冲区容量（即原始数据长度）
+     * @return 解压后的长度，数据损坏或越界返回-1
+     */
+    static long Decompress(const char* src, size_t src_size, char* dst, size_t dst_capacity);
+};
+
+/**
+ * @class FrameCompressor
+ * @brief 消息体的压缩封装
+ *
+ * 压缩后的消息体格式: [uint32_t 原始长度][LZ块]。
+ * 压缩在加密之前进行（密文不可压缩），接收方先解密后解压。
+ */
+class FrameCompressor {
+public:
+    static constexpr size_t kDefaultThreshold = 4 * 1024;          ///< 小于该长度的消息体不压缩
+    static constexpr size_t kMaxFrameBodySize = 256 * 1024 * 1024; ///< 解压后消息体的长度上限
+    static constexpr size_t kMaxExpansion = 255;                   ///< 解压后与压缩数据的长度比上限
+
+    /**
+     * @brief 压缩消息体
+     * @param data 原始消息体
+     * @param size 原始长度
+     * @param out 输出的压缩消息体
+     * @return 压缩有收益时返回true；否则返回false，调用方应原样发送
+     */
+    static bool Compress(const char* data, size_t size, std::string* out);
+
+    /**
+     * @brief 解压消息体
+     * @param data 压缩消息体
+     * @param size 压缩消息体长度
+     * @param out 输出的原始消息体
+     * @return 数据合法返回true
+     */
+    static bool Decompress(const char* data, size_t size, std::string* out);
+};
+
+} // namespace network
+} // namespace sqlcc
+
+#endif // SQLCC_NETWORK_COMPRESSION_H
@@ -0,0 +1,194 @@
+/**
+ * @file connection_pool.h
+ * @brief 客户端连接池头文件
+ *
+ * 该文件定义了线程安全的客户端连接池：复用已完成握手与认证的会话，
+ * 借出前做存活检查，回收长时间空闲的连接，并提供返回future的异步查询接口，
+ * 使应用线程可以在少量套接字上保持大量进行中的查询
+ */
+
+#ifndef SQLCC_NETWORK_CONNECTION_POOL_H
+#define SQLCC_NETWORK_CONNECTION_POOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/network.h"
+
+namespace sqlcc {
+namespace network {
+
+/**
+ * @struct ConnectionPoolOptions
+ * @brief 连接池配置
+ */
+struct ConnectionPoolOptions {
+    std::string host = "127.0.0.1";
+    int port = 18647;
+    std::string username;                 ///< 为空时以CONNECT_DISABLE_AUTH建立匿名会话
+    std::string password;
+    bool enable_tls = false;
+    std::string ca_cert_path;
+    bool enable_key_exchange = false;     ///< 握手后进行AES密钥交换
+    bool enable_compression = false;      ///< 在CONNECT中请求帧压缩
+
+    size_t max_connections = 8;           ///< 同时打开的最大连接数
+    size_t min_idle = 0;                  ///< 启动时预建并在回收时保留的空闲连接数
+    size_t async_workers = 0;             ///< 异步查询工作线程数，0表示等于max_connections
+
+    std::chrono::milliseconds acquire_timeout{5000};      ///< 借出连接的最长等待时间
+    std::chrono::milliseconds idle_timeout{60000};        ///< 空闲超过该时间的连接被关闭
+    std::chrono::milliseconds validation_interval{1000};  ///< 空闲超过该时间的连接借出前做存活检查
+    std::chrono::milliseconds query_timeout{30000};       ///< 单次响应的接收超时
+};
+
+/**
+ * @struct ConnectionPoolStats
+ * @brief 连接池运行统计
+ */
+struct ConnectionPoolStats {
+    size_t created = 0;             ///< 累计新建（完成握手）的连接
+    size_t reused = 0;              ///< 借出时复用空闲连接的次数
+    size_t evicted_idle = 0;        ///< 因空闲超时关闭的连接
+    size_t failed_validation = 0;   ///< 借出前存活检查失败而丢弃的连接
+    size_t discarded_broken = 0;    ///< 使用中出错、归还时被丢弃的连接
+    size_t acquire_timeouts = 0;    ///< 借出超时次数
+    size_t idle = 0;                ///< 当前空闲连接数
+    size_t in_use = 0;              ///< 当前借出的连接数
+    size_t pending_async = 0;       ///< 排队等待执行的异步查询数
+};
+
+class ClientConnectionPool;
+
+/**
+ * @class PooledConnection
+ * @brief 借出的连接句柄，析构时自动归还
+ *
+ * 使用中发生错误时调用MarkBroken，连接归还时会被关闭而不是放回空闲队列
+ */
+class PooledConnection {
+public:
+    PooledConnection() = default;
+    ~PooledConnection();
+
+    PooledConnection(PooledConnection&& other) noexcept;
+    PooledConnection& operator=(PooledConnection&& other) noexcept;
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    explicit operator bool() const { return connection_ != nullptr; }
+    ClientNetworkManager* operator->() const { return connection_.get(); }
+    ClientNetworkManager* Get() const { return connection_.get(); }
+
+    void MarkBroken() { broken_ = true; }
+
+    /**
+     * @brief 提前归还连接
+     */
+    void Release();
+
+private:
+    friend class ClientConnectionPool;
+    PooledConnection(ClientConnectionPool* pool, std::unique_ptr<ClientNetworkManager> connection);
+
+    ClientConnectionPool* pool_ = nullptr;
+    std::unique_ptr<ClientNetworkManager> connection_;
+    bool broken_ = false;
+};
+
+/**
+ * @class ClientConnectionPool
+ * @brief 线程安全的客户端连接池
+ *
+ * 空闲连接按后进先出复用（最近使用的连接最可能仍然有效）；
+ * 后台维护线程关闭空闲超时的连接并补足min_idle。
+ * 异步查询进入队列，由固定数量的工作线程借用连接执行。
+ */
+class ClientConnectionPool {
+public:
+    explicit ClientConnectionPool(const ConnectionPoolOptions& options);
+    ~ClientConnectionPool();
+
+    ClientConnectionPool(const ClientConnectionPool&) = delete;
+    ClientConnectionPool& operator=(const ClientConnectionPool&) = delete;
+
+    /**
+     * @brief 借出一个已完成握手（与认证）的连接
+     * @return 连接句柄；超时、连接失败或连接池已关闭时为空句柄
+     */
+    PooledConnection Acquire();
+
+    /**
+     * @brief 借用连接同步执行一条查询
+     */
+    QueryResponse Execute(const std::string& sql);
+
+    /**
+     * @brief 异步执行一条查询
+     * @return 查询完成后就绪的future；连接池已关闭时立即就绪并返回错误
+     */
+    std::future<QueryResponse> ExecuteAsync(const std::string& sql);
+
+    /**
+     * @brief 关闭空闲超时的连接（维护线程定期调用）
+     * @return 关闭的连接数
+     */
+    size_t EvictIdle();
+
+    /**
+     * @brief 关闭连接池：拒绝新请求，等待排队的异步查询完成后关闭所有连接
+     */
+    void Shutdown();
+
+    ConnectionPoolStats GetStats() const;
+    const ConnectionPoolOptions& GetOptions() const { return options_; }
+
+private:
+    friend class PooledConnection;
+
+    struct IdleConnection {
+        std::unique_ptr<ClientNetworkManager> connection;
+        std::chrono::steady_clock::time_point idle_since;
+    };
+
+    // 建立连接并完成握手、密钥交换与认证，失败返回nullptr
+    std::unique_ptr<ClientNetworkManager> CreateConnection();
+    // 连接归还入口（由PooledConnection调用）
+    void Return(std::unique_ptr<ClientNetworkManager> connection, bool broken);
+    void WorkerLoop();
+    void MaintenanceLoop();
+
+    ConnectionPoolOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_cv_;    // 有连接归还或名额释放
+    std::deque<IdleConnection> idle_;         // 尾部为最近归还的连接
+    size_t open_connections_ = 0;             // 空闲+借出+正在建立的连接数
+    bool shutdown_ = false;
+    ConnectionPoolStats stats_;
+
+    mutable std::mutex task_mutex_;
+    std::condition_variable task_cv_;
+    std::deque<std::packaged_task<QueryResponse()>> tasks_;
+    bool tasks_closed_ = false;
+    std::vector<std::thread> workers_;
+
+    std::mutex maintenance_mutex_;
+    std::condition_variable maintenance_cv_;
+    bool maintenance_stop_ = false;
+    std::thread maintenance_thread_;
+};
+
+} // namespace network
+} // namespace sqlcc
+
+#endif // SQLCC_NETWORK_CONNECTION_POOL_H
@@ -3,7 +3,7 @@
  * @brief 网络通信加密模块头文件
  * 
  * 该文件定义了SQLCC数据库系统的网络通信加密相关类和函数
- * 支持简单XOR加密和AES-256-CBC高级加密
+ * 支持简单XOR加密、AES-256-CBC高级加密和AES-256-GCM认证加密
  */
 
 #ifndef SQLCC_ENCRYPTION_H
@@ -12,11 +12,24 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <cstdint>
 
+// OpenSSL上下文前置声明，避免在头文件中引入OpenSSL
+struct evp_cipher_ctx_st;
+
 namespace sqlcc {
 namespace network {
 
+/**
+ * @enum AESMode
+ * @brief AES工作模式
+ */
+enum class AESMode {
+    CBC,  ///< AES-256-CBC，完整性需要额外的HMAC-SHA256
+    GCM   ///< AES-256-GCM认证加密，标签自带完整性校验
+};
+
 /**
  * @class EncryptionKey
  * @brief 加密密钥容器类
@@ -84,27 +97,44 @@ private:
 
 /**
  * @class AESEncryptor
- * @brief AES-256-CBC加密器类
+ * @brief AES-256加密器类
  * 
- * 提供基于AES-256-CBC算法的加密和解密功能
+ * 提供基于AES-256-CBC或AES-256-GCM算法的加密和解密功能。
+ * 密钥调度只在构造和UpdateKey时执行一次，加解密上下文按会话缓存复用。
  */
 class AESEncryptor {
 public:
+    static constexpr size_t kGcmNonceSize = 12;  ///< GCM随机数长度
+    static constexpr size_t kGcmTagSize = 16;    ///< GCM认证标签长度
+    static constexpr size_t kGcmOverhead = kGcmNonceSize + kGcmTagSize;
+
     /**
      * @brief 构造函数
      * @param encryption_key 加密密钥和IV
+     * @param mode 工作模式，默认CBC以兼容既有对端
      */
-    explicit AESEncryptor(std::shared_ptr<EncryptionKey> encryption_key);
+    explicit AESEncryptor(std::shared_ptr<EncryptionKey> encryption_key,
+                          AESMode mode = AESMode::CBC);
     
     /**
-     * @brief 析构函数
+     * @brief 析构函数，释放缓存的加解密上下文
      */
     ~AESEncryptor();
+
+    AESEncryptor(const AESEncryptor&) = delete;
+    AESEncryptor& operator=(const AESEncryptor&) = delete;
+
+    AESMode GetMode() const { return mode_; }
+
+    /**
+     * @brief 当前模式是否自带完整性校验（GCM无需再计算HMAC）
+     */
+    bool IsAuthenticated() const { return mode_ == AESMode::GCM; }
     
     /**
      * @brief 加密数据
      * @param data 待加密的数据
-     * @return 加密后的数据
+     * @return 加密后的数据（GCM模式为 nonce|密文|标签）
      */
     std::vector<uint8_t> Encrypt(const std::vector<uint8_t>& data) const;
     
@@ -112,8 +142,31 @@ public:
      * @brief 解密数据
      * @param data 待解密的数据
      * @return 解密后的数据
+     * @throws std::runtime_error 解密失败或GCM标签校验失败
      */
     std::vector<uint8_t> Decrypt(const std::vector<uint8_t>& data) const;
+
+    /**
+     * @brief GCM就地加密，输出布局为 [nonce(12)][密文][标签(16)]
+     * @param plaintext 明文；可以等于 out + kGcmNonceSize 以实现原地加密
+     * @param len 明文长度
+     * @param out 输出缓冲区，容量至少为 len + kGcmOverhead
+     * @return 写入out的字节数
+     * @throws std::runtime_error 非GCM模式或加密失败
+     */
+    size_t Seal(const uint8_t* plaintext, size_t len, uint8_t* out) const;
+
+    /**
+     * @brief GCM校验并解密 Seal 的输出
+     * @param sealed 密封数据 [nonce][密文][标签]
+     * @param sealed_len 密封数据长度
+     * @param out 明文输出，容量至少为 sealed_len - kGcmOverhead；
+     *            可以等于 sealed + kGcmNonceSize 以实现原地解密
+     * @param plaintext_len 输出明文长度
+     * @return 标签校验通过返回true
+     */
+    bool Open(const uint8_t* sealed, size_t sealed_len, uint8_t* out,
+              size_t* plaintext_len) const;
     
     /**
      * @brief 更新加密密钥
@@ -132,13 +185,27 @@ public:
 
 private:
     std::shared_ptr<EncryptionKey> encryption_key_;  ///< 加密密钥和IV
+    AESMode mode_;                                   ///< 工作模式
+
+    // 缓存的上下文：密钥调度完成后每条消息只需重置IV
+    mutable evp_cipher_ctx_st* encrypt_ctx_ = nullptr;
+    mutable evp_cipher_ctx_st* decrypt_ctx_ = nullptr;
+    mutable std::mutex ctx_mutex_;                   ///< 保护缓存上下文与nonce计数器
+
+    // GCM nonce = 4字节随机盐 || 8字节计数器（计数器初值随机），保证同一密钥下不重复
+    uint8_t nonce_salt_[4] = {0, 0, 0, 0};
+    mutable uint64_t nonce_counter_ = 0;
     
     /**
-     * @brief 初始化加密上下文
+     * @brief 初始化加密上下文（创建上下文并完成密钥调度）
      * @return 成功返回true，否则返回false
      */
     bool InitializeContext();
-    
+
+    /**
+     * @brief 释放缓存的上下文
+     */
+    void ReleaseContext();
 };
 
 // HMAC-SHA256 防篡改
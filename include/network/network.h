@@ -11,11 +11,14 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
-#include <queue>
+#include <deque>
 #include <mutex>
 #include <vector>
 
 #include "sql_executor.h"
+#include "network/admission_control.h"
+#include "network/buffer_chain.h"
+#include "network/compression.h"
 #include "network/encryption.h"
 #ifdef __linux__
 #include <openssl/ssl.h>
@@ -38,6 +41,27 @@ enum MessageType {
     KEY_EXCHANGE_ACK = 9 // 密钥交换确认
 };
 
+// CONNECT/CONN_ACK 能力标志位（CONN_ACK回显服务器接受的能力）
+enum ConnectFlags : uint16_t {
+    CONNECT_DISABLE_ENCRYPTION = 0x01,  // 禁用加密
+    CONNECT_DISABLE_AUTH = 0x02,        // 禁用认证
+    CONNECT_COMPRESSION = 0x04          // 协商启用大消息体压缩
+};
+
+// 帧级标志位：最高位表示消息体已压缩（先压缩后加密，接收方先解密后解压）
+constexpr uint16_t FRAME_FLAG_COMPRESSED = 0x8000;
+
+// 密钥交换标志位（KEY_EXCHANGE请求与KEY_EXCHANGE_ACK确认中的flags）
+enum KeyExchangeFlags : uint16_t {
+    KEY_EXCHANGE_AES = 0x01,  // 已启用AES加密
+    KEY_EXCHANGE_GCM = 0x02   // 使用AES-256-GCM认证加密，消息体不再追加HMAC
+};
+
+// ERROR消息的标志位
+enum ErrorFlags : uint16_t {
+    ERROR_OVERLOADED = 0x01   // 服务器过载，请求未执行，客户端可稍后重试
+};
+
 // 消息头结构
 struct MessageHeader {
     uint32_t magic;        // 魔数 'SQLC'
@@ -65,6 +89,10 @@ public:
     bool IsEncryptionDisabled() const;
     void SetAuthenticationDisabled(bool disabled);
     bool IsAuthenticationDisabled() const;
+
+    // 帧压缩（CONNECT时协商）
+    void SetCompressionEnabled(bool enabled) { compression_enabled_ = enabled; }
+    bool IsCompressionEnabled() const { return compression_enabled_; }
     
     // AES加密支持
     void SetAESEncryptor(std::shared_ptr<AESEncryptor> encryptor);
@@ -77,6 +105,7 @@ private:
     std::string user_;
     bool encryption_disabled_;     // 是否禁用加密
     bool authentication_disabled_; // 是否禁用认证
+    bool compression_enabled_ = false; // 是否已协商帧压缩
     std::shared_ptr<class AESEncryptor> aes_encryptor_;  // AES加密器
 };
 
@@ -109,8 +138,14 @@ public:
     void Disconnect();
     bool IsConnected() const;
     bool SendData(const std::vector<char>& data);
+    // 按消息头中的长度读取一条完整消息，超时或出错返回空
     std::vector<char> ReceiveData();
 
+    // 接收超时（毫秒），0表示一直阻塞
+    void SetReceiveTimeout(int timeout_ms);
+    // 非阻塞探测对端是否已关闭连接（连接池借出前的健康检查）
+    bool IsAlive() const;
+
     // TLS/SSL 支持
     void EnableTLS(bool enabled);
 #ifdef __linux__
@@ -118,10 +153,14 @@ public:
 #endif
 
 private:
+    // 读取恰好length个字节
+    bool ReadExact(char* buffer, size_t length);
+
     std::string host_;
     int port_;
     bool connected_;
     int socket_fd_;
+    int receive_timeout_ms_ = 0;
 #ifdef __linux__
     bool tls_enabled_ = false;
     std::string ca_cert_path_;
@@ -130,6 +169,13 @@ private:
 #endif
 };
 
+// 查询请求的响应
+struct QueryResponse {
+    bool success = false;     // 服务器返回QUERY_RESULT且flags为0
+    uint16_t type = ERROR;    // 响应消息类型
+    std::string payload;      // 结果或错误信息
+};
+
 // 客户端网络管理器
 class ClientNetworkManager {
 public:
@@ -144,9 +190,19 @@ public:
     bool ConnectAndAuthenticate(const std::string& username,
                                const std::string& password);
     bool SendAuthMessage(const std::string& username, const std::string& password);
+    // 发送认证请求并等待AUTH_ACK，认证通过返回true
+    bool Authenticate(const std::string& username, const std::string& password);
+
+    // 发送CONNECT并等待CONN_ACK（压缩请求会自动附加到flags）
+    bool Handshake(uint16_t connect_flags = 0);
+    // 发送一条查询并同步等待结果，响应序列号与请求不符时视为失败
+    QueryResponse ExecuteQuery(const std::string& sql);
+
+    void SetReceiveTimeout(int timeout_ms);
+    bool IsAlive() const;
     
     // AES加密支持
-    bool InitiateKeyExchange();  // 起动密钥交换
+    bool InitiateKeyExchange(bool prefer_gcm = true);  // 起动密钥交换，默认请求AES-256-GCM
     void SetAESEncryptor(std::shared_ptr<AESEncryptor> encryptor);
     std::shared_ptr<AESEncryptor> GetAESEncryptor() const;
     bool IsAESEncryptionEnabled() const;
@@ -157,7 +213,16 @@ public:
     bool ConfigureTLSClient(const std::string& ca_cert_path);
 #endif
 
+    // 帧压缩：在CONNECT中请求，服务器在CONN_ACK中确认后生效
+    void RequestCompression(bool enabled) { compression_requested_ = enabled; }
+    bool IsCompressionEnabled() const { return compression_enabled_; }
+
 private:
+    // 加密（如已启用）并发送一条完整消息
+    bool SealAndSend(const std::vector<char>& message);
+    // 解密（如已启用）一条接收到的完整消息
+    std::vector<char> OpenResponse(std::vector<char> response);
+
     // AES加密半加密/解密方法
     std::vector<char> EncryptMessage(const std::vector<char>& message);
     std::vector<char> DecryptMessage(const std::vector<char>& message);
@@ -165,6 +230,9 @@ private:
     std::unique_ptr<ClientConnection> connection_;
     std::shared_ptr<SessionManager> session_manager_;
     std::shared_ptr<AESEncryptor> aes_encryptor_;  // AES加密器
+    bool compression_requested_ = false;
+    bool compression_enabled_ = false;
+    uint32_t next_sequence_id_ = 16;  // 查询序列号，小值保留给握手消息
 };
 
 // 连接处理器
@@ -182,17 +250,50 @@ public:
     void SetTLS(struct ssl_st* ssl, bool enabled);
 #endif
 
+    // 设置所属的epoll实例，用于在发送未完成时注册EPOLLOUT
+    void SetEpollFd(int epoll_fd);
+
+    // 是否接受客户端的压缩协商请求，以及触发压缩的最小消息体长度
+    void SetCompressionSupported(bool supported, size_t threshold = FrameCompressor::kDefaultThreshold);
+
+    // 大结果帧启用MSG_ZEROCOPY发送，内核不支持时返回false
+    bool EnableZeroCopy(bool enabled);
+    bool IsZeroCopyEnabled() const { return zerocopy_enabled_; }
+
+    // 单次sendmsg达到该字节数时才使用MSG_ZEROCOPY（小包的页锁定开销高于拷贝）
+    static constexpr size_t kZeroCopyThreshold = 64 * 1024;
+
+    // 查询准入控制（为空时不限制）
+    void SetAdmissionController(std::shared_ptr<AdmissionController> admission);
+    // 输出缓冲超过高水位时暂停读取该连接，回落到低水位以下后恢复
+    void SetOutputBufferLimits(size_t high_watermark, size_t low_watermark);
+    // 执行在准入队列中等待的查询（获得名额后由服务器调用）
+    void RunPendingQuery();
+
+    static constexpr size_t kDefaultOutputHighWatermark = 4 * 1024 * 1024;
+    static constexpr size_t kDefaultOutputLowWatermark = 1024 * 1024;
+
 private:
     void HandleRead();
     void HandleWrite();
-    void SendMessage(const std::vector<char>& message);
+    // 构造并发送一帧：消息头原地序列化，消息体以引用计数方式挂入发送链
+    void SendFrame(uint16_t type, uint16_t flags, uint32_t sequence_id,
+                   std::shared_ptr<const std::string> body = nullptr);
+    // 按发送链与读取暂停状态更新epoll关注的事件，调用方需持有write_mutex_
+    void UpdateEpollInterest(bool want_write);
+    // 从接收缓冲中切分完整的帧并逐个处理
+    void ProcessBufferedFrames();
+    // 查询经准入控制后执行、排队或拒绝
+    void AdmitQuery(const std::vector<char>& message);
+    void ReleaseQuerySlot();
+    void ReapZeroCopyCompletions();
     void Close();
     
     void HandleConnectMessage(const std::vector<char>& data);
     void HandleAuthMessage(const std::vector<char>& data);
     void HandleQueryMessage(const std::vector<char>& data);
     void HandleKeyExchangeMessage(const std::vector<char>& data);
-    void SendErrorMessage(const std::string& error);
+    void SendErrorMessage(const std::string& error, uint16_t flags = 0, uint32_t sequence_id = 0);
     
     // AES加密半加密/解密方法
     std::vector<char> EncryptMessage(const std::vector<char>& message);
@@ -203,8 +304,24 @@ private:
     std::shared_ptr<sqlcc::SqlExecutor> sql_executor_;
     std::shared_ptr<Session> session_;
     bool closed_;
-    std::queue<std::vector<char>> write_queue_;
+    bool compression_supported_ = true;
+    size_t compression_threshold_ = FrameCompressor::kDefaultThreshold;
+    BufferChain write_chain_;      // 待发送的缓冲链
     std::mutex write_mutex_;
+    int epoll_fd_ = -1;
+    uint32_t epoll_events_ = 0;      // 当前在epoll中注册的事件
+    std::vector<char> read_buffer_;  // 尚未组成完整帧的接收数据
+    std::shared_ptr<AdmissionController> admission_;
+    size_t output_high_watermark_ = kDefaultOutputHighWatermark;
+    size_t output_low_watermark_ = kDefaultOutputLowWatermark;
+    bool output_throttled_ = false;  // 输出缓冲超过高水位，暂停读取
+    bool holding_query_slot_ = false;
+    bool query_waiting_ = false;     // 有查询在准入队列中等待，暂停读取
+    std::vector<char> pending_query_;
+    bool zerocopy_enabled_ = false;
+    uint32_t zerocopy_next_id_ = 0;  // 内核为每次MSG_ZEROCOPY发送分配的递增序号
+    // 已交给内核但尚未收到完成通知的零拷贝发送，保持底层缓冲区存活
+    std::deque<std::pair<uint32_t, std::vector<std::shared_ptr<const void>>>> zerocopy_inflight_;
 #ifdef __linux__
     struct ssl_st* ssl_ = nullptr;
     bool tls_enabled_ = false;
@@ -240,6 +357,19 @@ public:
     void Stop();
     void ProcessEvents();
     void SetSqlExecutor(std::shared_ptr<sqlcc::SqlExecutor> sql_executor);
+    // 对新接入的连接启用MSG_ZEROCOPY发送大结果帧
+    void EnableZeroCopy(bool enabled);
+    // 是否允许客户端协商帧压缩，以及压缩阈值
+    void EnableCompression(bool enabled, size_t threshold = FrameCompressor::kDefaultThreshold);
+    // 全局进行中查询数上限与等待队列长度
+    void SetAdmissionLimits(size_t max_inflight_queries, size_t max_queued_queries);
+    // 每个连接的输出缓冲高/低水位
+    void SetOutputBufferLimits(size_t high_watermark, size_t low_watermark);
+    AdmissionStats GetAdmissionStats() const;
+    size_t GetConnectionCount() const { return connections_.size(); }
+
+    static constexpr size_t kDefaultMaxInflightQueries = 64;
+    static constexpr size_t kDefaultMaxQueuedQueries = 1024;
 
 #ifdef __linux__
     void EnableTLS(bool enabled);
@@ -250,6 +380,11 @@ public:
 
 private:
     void AcceptConnection();
+    // 超过最大连接数时发送过载错误并关闭新连接
+    void RejectConnection(int client_fd);
+    // 为获得名额的等待连接执行排队中的查询
+    void DispatchQueuedQueries();
+    void RemoveConnection(ConnectionHandler* handler);
     
     int port_;
     int max_connections_;
@@ -259,6 +394,12 @@ private:
     std::shared_ptr<SessionManager> session_manager_;
     std::shared_ptr<sqlcc::SqlExecutor> sql_executor_;
     std::unordered_map<int, ConnectionHandler*> connections_;
+    bool zerocopy_enabled_ = false;
+    bool compression_enabled_ = true;
+    size_t compression_threshold_ = FrameCompressor::kDefaultThreshold;
+    std::shared_ptr<AdmissionController> admission_;
+    size_t output_high_watermark_ = ConnectionHandler::kDefaultOutputHighWatermark;
+    size_t output_low_watermark_ = ConnectionHandler::kDefaultOutputLowWatermark;
 #ifdef __linux__
     bool tls_enabled_ = false;
     struct ssl_ctx_st* ssl_ctx_ = nullptr; // SSL_CTX*
@@ -47,6 +47,7 @@ public:
 
   /**
    * @brief 获取执行统计信息
+   * 包括最后一条语句的执行步骤和查询结果缓存的命中/未命中次数
    * @return 统计信息字符串
    */
   std::string GetExecutionStats() const;
@@ -21,8 +21,10 @@ public:
   ~IndexManager();
 
   // 索引管理
+  // included_columns：INCLUDE列，其值随叶子条目保存，用于仅索引扫描
   bool CreateIndex(const std::string &index_name, const std::string &table_name,
-                   const std::string &column_name, bool unique = false);
+                   const std::string &column_name, bool unique = false,
+                   const std::vector<std::string> &included_columns = {});
   bool DropIndex(const std::string &index_name, const std::string &table_name);
   bool IndexExists(const std::string &index_name,
                    const std::string &table_name) const;
@@ -58,7 +58,9 @@ public:
         CALL_PROCEDURE,
         CREATE_TRIGGER,
         DROP_TRIGGER,
-        ALTER_TRIGGER
+        ALTER_TRIGGER,
+        ANALYZE,
+        EXPLAIN
     };
 
     Statement(Type type);
@@ -28,6 +28,8 @@ class DropUserStatement;
 class GrantStatement;
 class RevokeStatement;
 class ShowStatement;
+class AnalyzeStatement;
+class ExplainStatement;
 class NodeVisitor;
 
 // ==================== ColumnDefinition ====================
@@ -172,6 +174,7 @@ public:
     void setTableName(const std::string& table);
     void setWhereClause(const WhereClause& where);
     void setGroupByColumn(const std::string& column);
+    void setHavingClause(const WhereClause& having);
     void setOrderByColumn(const std::string& column);
     void setOrderDirection(const std::string& direction);
     void setSelectAll(bool selectAll);
@@ -183,6 +186,7 @@ public:
     const std::string& getTableName() const;
     const WhereClause& getWhereClause() const;
     const std::string& getGroupByColumn() const;
+    const WhereClause& getHavingClause() const;
     const std::string& getOrderByColumn() const;
     const std::string& getOrderDirection() const;
     const std::string& getJoinCondition() const;
@@ -191,6 +195,7 @@ public:
     bool isSelectAll() const;
     bool hasWhereClause() const;
     bool hasGroupBy() const;
+    bool hasHavingClause() const;
     bool hasOrderBy() const;
     bool hasJoinCondition() const;
     bool hasLimit() const;
@@ -205,6 +210,7 @@ private:
     std::string tableName_;
     WhereClause whereClause_{"", "", ""}; // 初始化空的WhereClause
     std::string groupByColumn_;
+    WhereClause havingClause_{"", "", ""}; // 列名为聚合表达式，如"COUNT(*)"
     std::string orderByColumn_;
     std::string orderDirection_;
     std::string joinCondition_;
@@ -381,6 +387,10 @@ public:
     void addColumn(const std::string& column);
     const std::vector<std::string>& getColumns() const;
     
+    // INCLUDE (cols)：随索引条目一起保存的非键列，用于仅索引扫描
+    void addIncludedColumn(const std::string& column);
+    const std::vector<std::string>& getIncludedColumns() const;
+    
     void setUnique(bool unique);  // 设置UNIQUE标记
     bool isUnique() const;         // 获取UNIQUE标记
     
@@ -392,6 +402,7 @@ private:
     std::string indexName_;
     std::string tableName_;
     std::vector<std::string> columns_;
+    std::vector<std::string> includedColumns_;
     bool unique_;  // 是否为UNIQUE索引
 };
 
@@ -562,6 +573,47 @@ private:
     bool hasFromDb_;           // 是否有FROM子句
 };
 
+// ==================== AnalyzeStatement ====================
+
+// ANALYZE [table]：收集表和列的统计信息，未指定表时分析当前数据库的所有表
+class AnalyzeStatement : public Statement {
+public:
+    AnalyzeStatement();
+    explicit AnalyzeStatement(const std::string& tableName);
+    ~AnalyzeStatement();
+
+    const std::string& getTableName() const;
+    bool hasTableName() const;
+
+    void accept(NodeVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+
+private:
+    std::string tableName_;
+};
+
+// ==================== ExplainStatement ====================
+
+// EXPLAIN [ANALYZE] SELECT ...：输出查询的算子树，ANALYZE时实际执行查询
+// 并输出每个算子的实际行数、执行次数、耗时和缓冲池访问
+class ExplainStatement : public Statement {
+public:
+    ExplainStatement(std::unique_ptr<Statement> statement, bool analyze);
+    ~ExplainStatement();
+
+    Statement* getStatement() const;
+    bool isAnalyze() const;
+
+    void accept(NodeVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+
+private:
+    std::unique_ptr<Statement> statement_;
+    bool analyze_;
+};
+
 // ==================== ProcedureParameter ====================
 
 class ProcedureParameter {
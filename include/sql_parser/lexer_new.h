@@ -53,6 +53,8 @@ private:
     Token createNumberToken(const std::string& lexeme, int line, int column);
     Token createOperatorToken(const std::string& lexeme, int line, int column);
     Token createPunctuationToken(const std::string& lexeme, int line, int column);
+    // 读取引号括起的字符串或标识符（当前字符为开引号）
+    Token scanQuoted(int line, int column);
 
     // Comment handling
     void skipLineComment();
@@ -32,6 +32,8 @@ class DropProcedureStatement;
 class CreateTriggerStatement;
 class DropTriggerStatement;
 class AlterTriggerStatement;
+class AnalyzeStatement;
+class ExplainStatement;
 class Expression;
 class SetOperationNode;
 class CompositeSelectStatement;
@@ -62,6 +64,8 @@ public:
   virtual void visit(CreateTriggerStatement &node) = 0;
   virtual void visit(DropTriggerStatement &node) = 0;
   virtual void visit(AlterTriggerStatement &node) = 0;
+  virtual void visit(AnalyzeStatement &node) = 0;
+  virtual void visit(ExplainStatement &node) = 0;
 
   // 表达式访问方法
   virtual void visit(Expression &node) = 0;
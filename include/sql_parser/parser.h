@@ -47,6 +47,8 @@ private:
   std::unique_ptr<Statement> parseDropStatement();
   std::unique_ptr<AlterStatement> parseAlterStatement();
   std::unique_ptr<UseStatement> parseUseStatement();
+  std::unique_ptr<AnalyzeStatement> parseAnalyzeStatement();
+  std::unique_ptr<ExplainStatement> parseExplainStatement();
 
   // DCL语句解析方法
   std::unique_ptr<Statement> parseCreateUserStatement();
@@ -68,6 +70,7 @@ private:
   void parseJoinClause(SelectStatement &stmt);
   void parseJoinCondition(SelectStatement &stmt);
   void parseGroupByClause(SelectStatement &stmt);
+  void parseHavingClause(SelectStatement &stmt);
   void parseOrderByClause(SelectStatement &stmt);
   void parseLimitOffsetClause(SelectStatement &stmt);
   std::unique_ptr<Expression> parseExpression();
@@ -59,6 +59,8 @@ private:
     std::unique_ptr<Statement> parseDCLStatement();
     std::unique_ptr<Statement> parseTCLStatement();
     std::unique_ptr<Statement> parseShowStatement();
+    std::unique_ptr<Statement> parseAnalyzeStatement();
+    std::unique_ptr<Statement> parseExplainStatement();
 
     // DDL statements
     std::unique_ptr<CreateStatement> parseCreateDatabaseStatement();
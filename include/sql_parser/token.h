@@ -33,6 +33,7 @@ public:
         KEYWORD_WITH, KEYWORD_PASSWORD, KEYWORD_IDENTIFIED, KEYWORD_SHOW, KEYWORD_COLUMNS,
         KEYWORD_INDEXES, KEYWORD_GRANTS, KEYWORD_DATABASES, KEYWORD_TABLES,
         KEYWORD_ALL, KEYWORD_DISTINCT, KEYWORD_UNION, KEYWORD_INTERSECT, KEYWORD_EXCEPT, KEYWORD_LIMIT, KEYWORD_OFFSET, KEYWORD_OUTER,
+        KEYWORD_ANALYZE, KEYWORD_EXPLAIN,
         
         MULTIPLY, // *
         
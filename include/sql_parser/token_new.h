@@ -172,6 +172,8 @@ public:
     KEYWORD_GRANTS,
     KEYWORD_DATABASES,
     KEYWORD_TABLES,
+    KEYWORD_ANALYZE,
+    KEYWORD_EXPLAIN,
 
     KEYWORD_TRUE,
     KEYWORD_FALSE,
@@ -27,16 +27,30 @@ enum class BPlusTreeNodeType {
 
 /**
  * @brief B+树键值对
- * 键是索引的键值，值是记录所在的页面ID和偏移量
+ * 键是索引的键值，值是记录所在的页面ID和偏移量；覆盖索引的条目还保存
+ * INCLUDE列的值
  */
 struct IndexEntry {
     std::string key;              // 索引键值
     int32_t page_id;              // 记录所在页面ID
     size_t offset;                // 记录在页面中的偏移量
+    std::vector<std::string> included_values; // INCLUDE列的值，顺序与索引定义相同
 
     IndexEntry() : page_id(-1), offset(0) {}
     IndexEntry(const std::string& k, int32_t pid, size_t off) 
         : key(k), page_id(pid), offset(off) {}
+    IndexEntry(const std::string& k, int32_t pid, size_t off, std::vector<std::string> included)
+        : key(k), page_id(pid), offset(off), included_values(std::move(included)) {}
+
+    // 序列化到叶子页面后占用的字节数
+    size_t SerializedSize() const {
+        size_t size = sizeof(int32_t) + key.size() + sizeof(int32_t) + sizeof(size_t) +
+                      sizeof(int32_t);
+        for (const auto& value : included_values) {
+            size += sizeof(int32_t) + value.size();
+        }
+        return size;
+    }
 
     bool operator<(const IndexEntry& other) const {
         return key < other.key;
@@ -153,10 +167,29 @@ public:
     bool Delete(const std::string& key);
     std::vector<IndexEntry> Search(const std::string& key) const;
     std::vector<IndexEntry> SearchRange(const std::string& lower_bound, const std::string& upper_bound) const;
+    // 按键升序返回不小于lower_bound的至多max_entries个条目，读够后不再访问后续叶子
+    std::vector<IndexEntry> ScanFrom(const std::string& lower_bound, size_t max_entries) const;
 
     // 获取索引信息
     const std::string& GetTableName() const { return table_name_; }
     const std::string& GetColumnName() const { return column_name_; }
+
+    // INCLUDE列：值保存在叶子条目中，查询只引用键列和INCLUDE列时不必回表
+    void SetIncludedColumns(const std::vector<std::string>& columns) { included_columns_ = columns; }
+    const std::vector<std::string>& GetIncludedColumns() const { return included_columns_; }
+
+    // 索引键编码：数值列（INT、DOUBLE等）的键按保序的二进制形式保存，字节序与数值
+    // 顺序一致，范围查找和按索引顺序扫描都依赖这一点；其他类型的列保存原始文本。
+    // 数值列中无法解析的值（包括空值）排在所有数值之后
+    static std::string EncodeKey(const std::string& value, const std::string& column_type);
+    static std::string DecodeKey(const std::string& key, const std::string& column_type);
+    // 数值列键的上下界（不含无法解析的值），column_type不是数值类型时返回false
+    static bool NumericKeyBounds(const std::string& column_type, std::string& min_key, std::string& max_key);
+
+    // 由一条记录生成索引条目（键值按列类型编码，INCLUDE列保存原始文本），
+    // 记录中缺少这些列时返回false
+    bool MakeEntry(const std::vector<std::string>& record, const TableMetadata& metadata,
+                   int32_t page_id, size_t offset, IndexEntry& entry) const;
     bool Exists() const; // 检查索引是否存在
     int32_t GetRootPageId() const { return root_page_id_; }
 
@@ -165,6 +198,7 @@ private:
     std::string table_name_;         // 表名
     std::string column_name_;        // 列名
     std::string index_name_;         // 索引名
+    std::vector<std::string> included_columns_; // INCLUDE列
     int32_t root_page_id_;           // 根节点页面ID
     int32_t metadata_page_id_;       // 元数据页面ID
 
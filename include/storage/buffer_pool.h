@@ -284,7 +284,8 @@ private:
     // Why: 当缓冲池已满且需要加载新页面时，必须选择一个现有页面进行替换
     // What: ReplacePage方法使用LRU算法选择一个引用计数为0的页面进行替换
     // How: 从LRU链表尾部开始查找，找到第一个引用计数为0的页面
-    int32_t ReplacePage();
+    // 注意：调用者必须已经通过lock持有latch_，写回脏页时会临时释放它
+    int32_t ReplacePage(std::unique_lock<std::timed_mutex>& lock);
 
     // 配置变更回调处理
     // Why: 需要响应配置变更，动态调整缓冲池行为
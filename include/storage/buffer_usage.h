@@ -0,0 +1,44 @@
+#ifndef SQLCC_BUFFER_USAGE_H
+#define SQLCC_BUFFER_USAGE_H
+
+#include <cstddef>
+
+namespace sqlcc {
+
+/**
+ * 缓冲池访问计数
+ * 缓冲池在每次FetchPage时累加到当前线程的计数器，调用方在一段代码前后
+ * 各取一次快照，差值即这段代码引起的页面访问（EXPLAIN ANALYZE按算子统计）
+ */
+struct BufferUsage {
+    size_t hits = 0;       // 命中缓冲池的页面访问
+    size_t misses = 0;     // 未命中、需要装入的页面访问
+    size_t disk_reads = 0; // 实际从磁盘读出的页面
+
+    BufferUsage &operator+=(const BufferUsage &other) {
+        hits += other.hits;
+        misses += other.misses;
+        disk_reads += other.disk_reads;
+        return *this;
+    }
+
+    BufferUsage operator-(const BufferUsage &other) const {
+        BufferUsage result;
+        result.hits = hits - other.hits;
+        result.misses = misses - other.misses;
+        result.disk_reads = disk_reads - other.disk_reads;
+        return result;
+    }
+};
+
+/**
+ * 当前线程的缓冲池访问计数，只增不减
+ */
+inline BufferUsage &thread_buffer_usage() {
+    thread_local BufferUsage usage;
+    return usage;
+}
+
+} // namespace sqlcc
+
+#endif // SQLCC_BUFFER_USAGE_H
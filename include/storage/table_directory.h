@@ -0,0 +1,78 @@
+#ifndef SQLCC_TABLE_DIRECTORY_H
+#define SQLCC_TABLE_DIRECTORY_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "table_storage.h"
+
+namespace sqlcc {
+
+/**
+ * 表目录
+ * 记录每张表的元数据和按分配顺序排列的数据页，由TableStorageManager在建表、
+ * 删表和分配新页时维护，扫描时按页号依次读取。执行器为每条语句创建临时的
+ * TableStorageManager，因此目录由存储引擎持有，与数据文件共存亡。
+ * 每次变更后整体写入数据文件旁的目录文件，重新打开时读回。线程安全
+ */
+class TableDirectory {
+public:
+    /**
+     * @param catalog_file 目录文件路径，为空时只保存在内存中
+     */
+    explicit TableDirectory(const std::string& catalog_file = "");
+
+    /**
+     * 登记新表并分配表ID
+     * @return 同名表已存在时返回false
+     */
+    bool AddTable(const std::shared_ptr<TableMetadata>& metadata);
+
+    /**
+     * 删除表并取出它的数据页，由调用方释放
+     * @return 表不存在时返回false
+     */
+    bool RemoveTable(const std::string& table_name, std::vector<int32_t>& pages);
+
+    std::shared_ptr<TableMetadata> GetTable(const std::string& table_name) const;
+
+    /**
+     * 把新分配的页追加到表的页列表末尾
+     */
+    bool AddPage(const std::string& table_name, int32_t page_id);
+
+    /**
+     * 表的数据页，按分配顺序排列
+     */
+    std::vector<int32_t> GetPages(const std::string& table_name) const;
+
+    /**
+     * 追加记录时持有，保证同一时刻只有一个写入者选择末页或分配新页
+     */
+    std::mutex& AppendMutex() { return append_mutex_; }
+
+private:
+    struct TableEntry {
+        std::shared_ptr<TableMetadata> metadata;
+        std::vector<int32_t> pages;
+    };
+
+    // 调用方持有mutex_
+    void Save() const;
+    void Load();
+
+    std::string catalog_file_;
+    mutable std::shared_mutex mutex_;
+    std::mutex append_mutex_;
+    std::unordered_map<std::string, TableEntry> tables_;
+    int64_t next_table_id_ = 1;
+};
+
+} // namespace sqlcc
+
+#endif // SQLCC_TABLE_DIRECTORY_H
@@ -76,7 +76,8 @@ public:
     ~TableStorageManager();
 
     // 表管理
-    bool CreateTable(const std::string& table_name, const std::vector<TableColumn>& columns);
+    bool CreateTable(const std::string& table_name, const std::vector<TableColumn>& columns,
+                     const std::string& database_name = "");
     bool DropTable(const std::string& table_name);
     bool TableExists(const std::string& table_name) const;
     std::shared_ptr<TableMetadata> GetTableMetadata(const std::string& table_name) const;
@@ -84,11 +85,18 @@ public:
     // 记录操作
     bool InsertRecord(const std::string& table_name, const std::vector<std::string>& values, int32_t& page_id, size_t& offset);
     bool UpdateRecord(const std::string& table_name, int32_t page_id, size_t offset, const std::vector<std::string>& new_values);
+    // 新版本写入同一页，该页放不下时移到表末尾，new_page_id/new_offset返回新位置
+    bool UpdateRecord(const std::string& table_name, int32_t page_id, size_t offset, const std::vector<std::string>& new_values,
+                      int32_t& new_page_id, size_t& new_offset);
     bool DeleteRecord(const std::string& table_name, int32_t page_id, size_t offset);
     std::vector<std::string> GetRecord(const std::string& table_name, int32_t page_id, size_t offset) const;
     
     // 批量操作
     std::vector<std::pair<int32_t, size_t>> ScanTable(const std::string& table_name) const;
+    // 表的数据页（按分配顺序），只查目录，不读取页面
+    std::vector<int32_t> GetTablePages(const std::string& table_name) const;
+    // 固定一次页面，解码其中所有未删除的记录
+    std::vector<std::vector<std::string>> GetPageRecords(const std::string& table_name, int32_t page_id) const;
     std::vector<std::vector<std::string>> GetRecords(const std::string& table_name, 
                                                      const std::vector<std::pair<int32_t, size_t>>& locations) const;
 
@@ -98,16 +106,21 @@ public:
     bool IndexExists(const std::string& table_name, const std::string& column_name) const;
     std::shared_ptr<class BPlusTreeIndex> GetIndex(const std::string& table_name, const std::string& column_name);
 
+    // 区域映射：插入和更新时记录每页各列的最小/最大值和空值数，
+    // 扫描时据此跳过不可能包含 column op value 的页面
+    bool PageMayMatch(int32_t page_id, size_t column_index, const std::string& column_type,
+                      const std::string& op, const std::string& value) const;
+
 private:
     std::shared_ptr<StorageEngine> storage_engine_;  // 存储引擎
     std::shared_ptr<IndexManager> index_manager_;    // 索引管理器
-    std::unordered_map<std::string, std::shared_ptr<TableMetadata>> table_metadata_; // 表元数据映射
     
     // 内部辅助方法
     class Page* AllocateNewPage(const std::string& table_name);
     bool InitializePage(class Page* page, const std::string& table_name);
     bool InsertRecordToPage(class Page* page, const std::vector<std::string>& values, size_t& offset);
-    bool UpdateRecordInPage(class Page* page, size_t offset, const std::vector<std::string>& new_values);
+    bool PageHasRoom(class Page* page, const std::vector<std::string>& values) const;
+    bool UpdateRecordInPage(class Page* page, size_t offset, const std::vector<std::string>& new_values, size_t& new_offset);
     bool DeleteRecordInPage(class Page* page, size_t offset);
     std::vector<std::string> GetRecordFromPage(class Page* page, size_t offset) const;
     size_t CalculateRecordSize(const std::vector<std::string>& values, const TableMetadata& metadata) const;
@@ -0,0 +1,84 @@
+#ifndef SQLCC_ZONE_MAP_H
+#define SQLCC_ZONE_MAP_H
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "table_storage.h"
+
+namespace sqlcc {
+
+/**
+ * 一页中一列的取值范围
+ * 值按列类型解析后比较，顺序与执行器的compare_values相同：数值在字符串之前，
+ * 数值按大小、字符串按字节序。数值列中无法解析的值（包括NULL）按字符串记录
+ */
+struct ColumnZone {
+    size_t null_count = 0;       // 空值或NULL的个数
+    bool has_number = false;
+    double min_number = 0.0;
+    double max_number = 0.0;
+    bool has_string = false;
+    std::string min_string;
+    std::string max_string;
+    bool unordered = false;      // 出现NaN，无法按范围排除
+};
+
+/**
+ * 一页的摘要：写入该页的行数和各列的取值范围
+ */
+struct PageZone {
+    size_t row_count = 0;
+    std::vector<ColumnZone> columns;
+};
+
+/**
+ * 区域映射（zone map）
+ * 按页记录每列的最小/最大值和空值数，由TableStorageManager在插入和更新时
+ * 维护。删除不收缩范围，摘要始终覆盖页中的全部存活行，因此只会少排除、
+ * 不会误排除。只保存在内存中，没有摘要的页（例如重启前写入的页）总是需要
+ * 读取。线程安全
+ */
+class ZoneMapIndex {
+public:
+    /**
+     * 把一行的各列值并入所在页的摘要
+     * @param columns 表的列定义，用于按类型解析各列值
+     */
+    void AddRecord(int32_t page_id, const std::vector<std::string>& values,
+                   const std::vector<TableColumn>& columns);
+
+    /**
+     * 页面被释放时删除其摘要
+     */
+    void RemovePage(int32_t page_id);
+
+    /**
+     * 读取一页的摘要
+     * @return 该页没有摘要时返回false
+     */
+    bool GetPageZone(int32_t page_id, PageZone& zone) const;
+
+    /**
+     * 判断一页中是否可能有行满足 column op literal
+     * 常量的解析方式与CompiledPredicate相同（带引号为字符串，否则按列类型
+     * 解析）。只对=、<、<=、>、>=判断，其他操作符和没有摘要的页返回true
+     * @param column 列在记录中的下标
+     * @param column_type 列类型
+     */
+    bool PageMayMatch(int32_t page_id, size_t column, const std::string& column_type,
+                      const std::string& op, const std::string& literal) const;
+
+    size_t PageCount() const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<int32_t, PageZone> pages_;
+};
+
+} // namespace sqlcc
+
+#endif // SQLCC_ZONE_MAP_H
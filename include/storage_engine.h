@@ -5,7 +5,9 @@
 #include "config_manager.h"
 #include "disk_manager.h"
 #include "page.h"
+#include "table_directory.h"
 #include "table_storage.h"
+#include "zone_map.h"
 #include <memory>
 #include <unordered_map>
 
@@ -162,6 +164,20 @@ public:
    */
   ConfigManager &GetConfigManager() const { return config_manager_; }
 
+  /**
+   * @brief 获取区域映射
+   * @return 各数据页的列取值范围，由TableStorageManager维护
+   */
+  ZoneMapIndex &GetZoneMaps() { return zone_maps_; }
+  const ZoneMapIndex &GetZoneMaps() const { return zone_maps_; }
+
+  /**
+   * @brief 获取表目录
+   * @return 各表的元数据和数据页列表，由TableStorageManager维护
+   */
+  TableDirectory &GetTableDirectory() { return *table_directory_; }
+  const TableDirectory &GetTableDirectory() const { return *table_directory_; }
+
 private:
   /// 配置管理器引用
   // Why: 需要访问配置参数来初始化和调整存储引擎的行为
@@ -181,6 +197,18 @@ private:
   // What: buffer_pool_是一个智能指针，指向BufferPool对象，负责内存中的页面管理
   // How: 使用std::unique_ptr管理BufferPool对象的生命周期，确保资源正确释放
   std::unique_ptr<BufferPoolSharded> buffer_pool_;
+
+  /// 区域映射
+  // Why: 范围和等值条件的全表扫描需要跳过不可能包含匹配行的页面
+  // What: zone_maps_按页记录各列的最小/最大值和空值数
+  // How: 页号在存储引擎内唯一，由存储引擎持有，页面删除时同步删除其摘要
+  ZoneMapIndex zone_maps_;
+
+  /// 表目录
+  // Why: 扫描需要知道每张表占用哪些数据页，而TableStorageManager只是临时对象
+  // What: table_directory_记录表元数据和数据页列表
+  // How: 保存在数据文件旁的".tables"文件中，随存储引擎一起打开
+  std::unique_ptr<TableDirectory> table_directory_;
 };
 
 } // namespace sqlcc
\ No newline at end of file
@@ -120,6 +120,14 @@ bool DatabaseManager::DropDatabase(const std::string &db_name) {
   }
 
   try {
+    // 释放库中各表的数据页
+    if (storage_engine_) {
+      TableStorageManager table_storage(storage_engine_);
+      for (const auto &table_name : it->second) {
+        table_storage.DropTable(table_name);
+      }
+    }
+
     std::string db_full_path = db_path_ + "/" + db_name;
     fs::remove_all(db_full_path);
     database_tables_.erase(it);
@@ -249,6 +257,22 @@ bool DatabaseManager::CreateTable(
     table_file << "],\"rows\":[]}" << std::endl;
     table_file.close();
 
+    // 在存储引擎中登记表结构，行数据写入数据页
+    std::vector<TableColumn> table_columns;
+    for (const auto &column : columns) {
+      table_columns.push_back({column.first, column.second, 0, true, ""});
+    }
+    TableStorageManager table_storage(EnsureStorageEngine());
+    auto stale = table_storage.GetTableMetadata(table_name);
+    if (stale && stale->database_name == db_name) {
+      // 同一数据库中残留的旧表（表文件已不在列表中），释放其数据页后重建
+      table_storage.DropTable(table_name);
+    }
+    if (!table_storage.CreateTable(table_name, table_columns, db_name)) {
+      fs::remove(table_file_path);
+      return false;
+    }
+
     // 将表添加到数据库表列表中
     tables.push_back(table_name);
 
@@ -300,8 +324,9 @@ bool DatabaseManager::DropTable(const std::string &table_name) {
     // 从列表中移除
     tables.erase(it);
 
-    // 从表存储中移除
+    // 从表存储中移除，释放数据页
     table_storages_[current_database_].erase(table_name);
+    TableStorageManager(EnsureStorageEngine()).DropTable(table_name);
 
 #ifdef USE_SPDLOG
     SPDLOG_INFO("Dropped table {} from database {}", table_name,
@@ -488,8 +513,9 @@ sqlcc::DatabaseManager::GetTableMetadata(const std::string &table_name) {
     return nullptr;
   }
 
-  // 检查表是否存在
-  if (!TableExists(table_name)) {
+  // 检查表是否存在（已持有锁，不能调用TableExists）
+  auto &tables = database_tables_[current_database_];
+  if (std::find(tables.begin(), tables.end(), table_name) == tables.end()) {
 #ifdef USE_SPDLOG
     SPDLOG_ERROR("Table {} does not exist in database {}", table_name,
                  current_database_);
@@ -497,17 +523,73 @@ sqlcc::DatabaseManager::GetTableMetadata(const std::string &table_name) {
     return nullptr;
   }
 
-  // 简化实现：返回一个空的TableMetadata对象
-  // 在实际实现中，这里应该从表文件中加载元数据
-  auto metadata = std::make_shared<TableMetadata>();
-  metadata->table_name = table_name;
-  metadata->database_name = current_database_;
+  TableStorageManager table_storage(EnsureStorageEngine());
+  auto metadata = table_storage.GetTableMetadata(table_name);
+  if (metadata) {
+    return metadata;
+  }
+
+  // 存储引擎中没有该表（例如表目录文件丢失），按表文件中的列定义重新登记
+  std::vector<TableColumn> table_columns;
+  for (const auto &column : ReadTableColumns(current_database_, table_name)) {
+    table_columns.push_back({column.first, column.second, 0, true, ""});
+  }
+  table_storage.CreateTable(table_name, table_columns, current_database_);
+  return table_storage.GetTableMetadata(table_name);
+}
+
+std::vector<std::pair<std::string, std::string>>
+sqlcc::DatabaseManager::ReadTableColumns(const std::string &db_name,
+                                         const std::string &table_name) {
+  std::vector<std::pair<std::string, std::string>> columns;
+  std::ifstream table_file(db_path_ + "/" + db_name + "/" + table_name +
+                           ".table");
+  std::string content((std::istreambuf_iterator<char>(table_file)),
+                      std::istreambuf_iterator<char>());
+
+  // 表文件由CreateTable写入，列格式固定为{"name":"...","type":"..."}
+  const std::string name_key = "{\"name\":\"";
+  const std::string type_key = "\",\"type\":\"";
+  size_t pos = content.find(name_key);
+  while (pos != std::string::npos) {
+    size_t name_begin = pos + name_key.size();
+    size_t name_end = content.find(type_key, name_begin);
+    if (name_end == std::string::npos) {
+      break;
+    }
+    size_t type_begin = name_end + type_key.size();
+    size_t type_end = content.find("\"}", type_begin);
+    if (type_end == std::string::npos) {
+      break;
+    }
+    columns.emplace_back(content.substr(name_begin, name_end - name_begin),
+                         content.substr(type_begin, type_end - type_begin));
+    pos = content.find(name_key, type_end);
+  }
+  return columns;
+}
 
-  // 添加一些示例列信息
-  metadata->columns.push_back({"id", "INT"});
-  metadata->columns.push_back({"name", "VARCHAR(50)"});
+std::shared_ptr<sqlcc::StorageEngine>
+sqlcc::DatabaseManager::GetStorageEngine() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (is_closed_) {
+    return nullptr;
+  }
+  return EnsureStorageEngine();
+}
 
-  return metadata;
+std::shared_ptr<sqlcc::StorageEngine>
+sqlcc::DatabaseManager::EnsureStorageEngine() {
+  if (!storage_engine_) {
+    if (!config_manager_) {
+      config_manager_ = &ConfigManager::GetInstance();
+    }
+    // 数据文件和表目录放在数据库根目录下，不同的数据库实例互不干扰。
+    // 存储引擎只在构造时读取该配置
+    config_manager_->SetValue("database.file", db_path_ + "/sqlcc.db");
+    storage_engine_ = std::make_shared<StorageEngine>(*config_manager_);
+  }
+  return storage_engine_;
 }
 
 // 获取索引管理器（用于索引优化）
@@ -523,17 +605,8 @@ std::shared_ptr<sqlcc::IndexManager> sqlcc::DatabaseManager::GetIndexManager() {
 
   // 如果索引管理器尚未初始化，则创建它
   if (!index_manager_) {
-    // 如果配置管理器不存在，创建一个
-    if (!config_manager_) {
-      config_manager_ = std::make_shared<ConfigManager>();
-    }
-
-    // 如果存储引擎不存在，创建一个存储引擎（需要ConfigManager引用）
-    if (!storage_engine_) {
-      storage_engine_ = std::make_shared<StorageEngine>(*config_manager_);
-    }
-
-    // 创建索引管理器
+    // 创建索引管理器，与表数据共用存储引擎
+    EnsureStorageEngine();
     index_manager_ =
         std::make_shared<IndexManager>(storage_engine_.get(), *config_manager_);
 
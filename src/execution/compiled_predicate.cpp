@@ -0,0 +1,889 @@
+#include "execution/compiled_predicate.h"
+#include "exception.h"
+#include "execution/physical_operator.h"
+#include "execution/simd_filter.h"
+#include "sql_parser/ast_nodes.h"
+#include "table_storage.h"
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+
+namespace sqlcc {
+
+/**
+ * @brief 谓词树节点
+ */
+class PredicateNode {
+public:
+  virtual ~PredicateNode() = default;
+  virtual bool evaluate(const std::vector<std::string> &record) const = 0;
+  virtual bool evaluate(const Row &row) const = 0;
+  virtual std::string describe() const = 0;
+
+  /**
+   * @brief 对整批行求值，结果写入位图mask（bitmap_words(rows.size())个字）
+   * 默认逐行求值，数值比较节点改为列式取值后调用SIMD内核
+   */
+  virtual void evaluate_batch(const std::vector<Row> &rows,
+                              uint64_t *mask) const {
+    std::fill(mask, mask + bitmap_words(rows.size()), 0);
+    for (size_t i = 0; i < rows.size(); ++i) {
+      if (evaluate(rows[i])) {
+        bitmap_set(mask, i);
+      }
+    }
+  }
+};
+
+namespace {
+
+template <CompareOp Op, typename T>
+inline bool apply_compare(const T &left, const T &right) {
+  if constexpr (Op == CompareOp::EQ) {
+    return left == right;
+  } else if constexpr (Op == CompareOp::NE) {
+    return left != right;
+  } else if constexpr (Op == CompareOp::LT) {
+    return left < right;
+  } else if constexpr (Op == CompareOp::LE) {
+    return left <= right;
+  } else if constexpr (Op == CompareOp::GT) {
+    return left > right;
+  } else {
+    return left >= right;
+  }
+}
+
+template <CompareOp Op> inline bool accept(int cmp) {
+  return apply_compare<Op>(cmp, 0);
+}
+
+// 列的存储类型，决定记录字段如何转换（与parse_value一致）
+enum class ColumnKind { INTEGER, REAL, TEXT, INFER };
+
+ColumnKind column_kind(const std::string &data_type) {
+  if (data_type.empty()) {
+    return ColumnKind::INFER;
+  }
+  switch (parse_value("0", data_type).type) {
+  case Value::Type::INT:
+    return ColumnKind::INTEGER;
+  case Value::Type::DOUBLE:
+    return ColumnKind::REAL;
+  default:
+    return ColumnKind::TEXT;
+  }
+}
+
+// 快速解析整个字段，失败时由调用方退回通用路径
+inline bool parse_field(std::string_view field, int64_t &out) {
+  auto result = std::from_chars(field.data(), field.data() + field.size(), out);
+  return result.ec == std::errc() && result.ptr == field.data() + field.size() &&
+         !field.empty();
+}
+
+inline bool parse_field(std::string_view field, double &out) {
+  auto result = std::from_chars(field.data(), field.data() + field.size(), out);
+  return result.ec == std::errc() && result.ptr == field.data() + field.size() &&
+         !field.empty();
+}
+
+// 把一批行的某列取出为连续数组，类型不符的行在valid中为0
+size_t gather_int64(const std::vector<Row> &rows, size_t index,
+                    std::vector<int64_t> &values,
+                    std::vector<uint64_t> &valid) {
+  values.resize(rows.size());
+  valid.assign(bitmap_words(rows.size()), 0);
+  size_t valid_count = 0;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const auto &row_values = rows[i].values;
+    if (index < row_values.size() &&
+        row_values[index].type == Value::Type::INT) {
+      values[i] = row_values[index].int_val;
+      bitmap_set(valid.data(), i);
+      ++valid_count;
+    } else {
+      values[i] = 0;
+    }
+  }
+  return valid_count;
+}
+
+// 整数与浮点值都转换为double
+size_t gather_double(const std::vector<Row> &rows, size_t index,
+                     std::vector<double> &values,
+                     std::vector<uint64_t> &valid) {
+  values.resize(rows.size());
+  valid.assign(bitmap_words(rows.size()), 0);
+  size_t valid_count = 0;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const auto &row_values = rows[i].values;
+    values[i] = 0;
+    if (index < row_values.size()) {
+      const Value &value = row_values[index];
+      if (value.type == Value::Type::DOUBLE) {
+        values[i] = value.double_val;
+      } else if (value.type == Value::Type::INT) {
+        values[i] = static_cast<double>(value.int_val);
+      } else {
+        continue;
+      }
+      bitmap_set(valid.data(), i);
+      ++valid_count;
+    }
+  }
+  return valid_count;
+}
+
+// 内核结果只对有效行成立，其余行逐行求值
+void finish_batch(const PredicateNode &node, const std::vector<Row> &rows,
+                  const std::vector<uint64_t> &valid, size_t valid_count,
+                  uint64_t *mask) {
+  bitmap_and(mask, valid.data(), rows.size());
+  if (valid_count == rows.size()) {
+    return;
+  }
+  for (size_t i = 0; i < rows.size(); ++i) {
+    if (!bitmap_test(valid.data(), i) && node.evaluate(rows[i])) {
+      bitmap_set(mask, i);
+    }
+  }
+}
+
+std::string literal_text(const Value &value) {
+  switch (value.type) {
+  case Value::Type::STRING:
+    return "'" + value.str_val + "'";
+  case Value::Type::INT:
+    return std::to_string(value.int_val);
+  default:
+    return std::to_string(value.double_val);
+  }
+}
+
+const char *op_text(CompareOp op) {
+  static const char *names[] = {"=", "<>", "<", "<=", ">", ">="};
+  return names[static_cast<int>(op)];
+}
+
+// 通用比较：字段按列类型转换为Value后用compare_values比较
+template <CompareOp Op> class GenericComparison : public PredicateNode {
+public:
+  GenericComparison(size_t index, std::string column, std::string data_type,
+                    Value literal)
+      : index_(index), column_(std::move(column)),
+        data_type_(std::move(data_type)), literal_(std::move(literal)) {}
+
+  bool evaluate(const std::vector<std::string> &record) const override {
+    return index_ < record.size() &&
+           accept<Op>(
+               compare_values(parse_value(record[index_], data_type_), literal_));
+  }
+
+  bool evaluate(const Row &row) const override {
+    return index_ < row.values.size() &&
+           accept<Op>(compare_values(row.values[index_], literal_));
+  }
+
+  std::string describe() const override {
+    return column_ + " " + op_text(Op) + " " + literal_text(literal_);
+  }
+
+protected:
+  size_t index_;
+  std::string column_;
+  std::string data_type_;
+  Value literal_;
+};
+
+// 整数列与整数常量
+template <CompareOp Op>
+class IntegerComparison : public GenericComparison<Op> {
+public:
+  using GenericComparison<Op>::GenericComparison;
+
+  bool evaluate(const std::vector<std::string> &record) const override {
+    if (this->index_ >= record.size()) {
+      return false;
+    }
+    int64_t value;
+    if (parse_field(record[this->index_], value)) {
+      return apply_compare<Op>(value, this->literal_.int_val);
+    }
+    return GenericComparison<Op>::evaluate(record);
+  }
+
+  bool evaluate(const Row &row) const override {
+    if (this->index_ < row.values.size() &&
+        row.values[this->index_].type == Value::Type::INT) {
+      return apply_compare<Op>(row.values[this->index_].int_val,
+                               this->literal_.int_val);
+    }
+    return GenericComparison<Op>::evaluate(row);
+  }
+
+  void evaluate_batch(const std::vector<Row> &rows,
+                      uint64_t *mask) const override {
+    static thread_local std::vector<int64_t> values;
+    static thread_local std::vector<uint64_t> valid;
+    size_t valid_count = gather_int64(rows, this->index_, values, valid);
+    compare_mask(values.data(), rows.size(), Op, this->literal_.int_val, mask);
+    finish_batch(*this, rows, valid, valid_count, mask);
+  }
+};
+
+// 数值列与浮点常量
+template <CompareOp Op> class RealComparison : public GenericComparison<Op> {
+public:
+  RealComparison(size_t index, std::string column, std::string data_type,
+                 Value literal)
+      : GenericComparison<Op>(index, std::move(column), std::move(data_type),
+                              literal),
+        number_(literal.type == Value::Type::INT
+                    ? static_cast<double>(literal.int_val)
+                    : literal.double_val),
+        integer_column_(column_kind(this->data_type_) == ColumnKind::INTEGER) {}
+
+  bool evaluate(const std::vector<std::string> &record) const override {
+    if (this->index_ >= record.size()) {
+      return false;
+    }
+    // 整数列的字段只按整数解析，与TableScanOperator的转换一致
+    if (integer_column_) {
+      int64_t value;
+      if (parse_field(record[this->index_], value)) {
+        return apply_compare<Op>(static_cast<double>(value), number_);
+      }
+    } else {
+      double value;
+      if (parse_field(record[this->index_], value)) {
+        return apply_compare<Op>(value, number_);
+      }
+    }
+    return GenericComparison<Op>::evaluate(record);
+  }
+
+  bool evaluate(const Row &row) const override {
+    if (this->index_ < row.values.size()) {
+      const Value &value = row.values[this->index_];
+      if (value.type == Value::Type::DOUBLE) {
+        return apply_compare<Op>(value.double_val, number_);
+      }
+      if (value.type == Value::Type::INT) {
+        return apply_compare<Op>(static_cast<double>(value.int_val), number_);
+      }
+    }
+    return GenericComparison<Op>::evaluate(row);
+  }
+
+  void evaluate_batch(const std::vector<Row> &rows,
+                      uint64_t *mask) const override {
+    static thread_local std::vector<double> values;
+    static thread_local std::vector<uint64_t> valid;
+    size_t valid_count = gather_double(rows, this->index_, values, valid);
+    compare_mask(values.data(), rows.size(), Op, number_, mask);
+    finish_batch(*this, rows, valid, valid_count, mask);
+  }
+
+private:
+  double number_;
+  bool integer_column_;
+};
+
+// 字符串列与字符串常量
+template <CompareOp Op> class TextComparison : public GenericComparison<Op> {
+public:
+  using GenericComparison<Op>::GenericComparison;
+
+  bool evaluate(const std::vector<std::string> &record) const override {
+    return this->index_ < record.size() &&
+           apply_compare<Op>(std::string_view(record[this->index_]),
+                             std::string_view(this->literal_.str_val));
+  }
+
+  bool evaluate(const Row &row) const override {
+    if (this->index_ < row.values.size() &&
+        row.values[this->index_].type == Value::Type::STRING) {
+      return apply_compare<Op>(
+          std::string_view(row.values[this->index_].str_val),
+          std::string_view(this->literal_.str_val));
+    }
+    return GenericComparison<Op>::evaluate(row);
+  }
+};
+
+// BETWEEN/IN的求值方式：列与全部常量都是整数、都是数值或需要通用比较
+enum class NumericDomain { INTEGER, REAL, GENERIC };
+
+NumericDomain numeric_domain(const std::string &data_type,
+                             const std::vector<Value> &literals) {
+  ColumnKind kind = column_kind(data_type);
+  if (kind != ColumnKind::INTEGER && kind != ColumnKind::REAL) {
+    return NumericDomain::GENERIC;
+  }
+  bool all_integer = true;
+  for (const auto &literal : literals) {
+    if (literal.type == Value::Type::STRING) {
+      return NumericDomain::GENERIC;
+    }
+    all_integer = all_integer && literal.type == Value::Type::INT;
+  }
+  return kind == ColumnKind::INTEGER && all_integer ? NumericDomain::INTEGER
+                                                    : NumericDomain::REAL;
+}
+
+double number_of(const Value &value) {
+  return value.type == Value::Type::INT ? static_cast<double>(value.int_val)
+                                        : value.double_val;
+}
+
+// 多常量谓词的公共部分：字段/值按数值域取出，取不出时交给通用比较
+class MultiLiteralNode : public PredicateNode {
+public:
+  MultiLiteralNode(size_t index, std::string column, std::string data_type,
+                   std::vector<Value> literals)
+      : index_(index), column_(std::move(column)),
+        data_type_(std::move(data_type)), literals_(std::move(literals)),
+        domain_(numeric_domain(data_type_, literals_)),
+        integer_column_(column_kind(data_type_) == ColumnKind::INTEGER) {
+    for (const auto &literal : literals_) {
+      integers_.push_back(literal.int_val);
+      numbers_.push_back(number_of(literal));
+    }
+  }
+
+  bool evaluate(const std::vector<std::string> &record) const override {
+    if (index_ >= record.size()) {
+      return false;
+    }
+    const std::string &field = record[index_];
+    if (domain_ == NumericDomain::INTEGER) {
+      int64_t value;
+      if (parse_field(field, value)) {
+        return matches_integer(value);
+      }
+    } else if (domain_ == NumericDomain::REAL) {
+      int64_t integer = 0;
+      double value = 0;
+      if (integer_column_ ? parse_field(field, integer)
+                          : parse_field(field, value)) {
+        return matches_number(integer_column_ ? static_cast<double>(integer)
+                                              : value);
+      }
+    }
+    return matches(parse_value(field, data_type_));
+  }
+
+  bool evaluate(const Row &row) const override {
+    if (index_ >= row.values.size()) {
+      return false;
+    }
+    const Value &value = row.values[index_];
+    if (domain_ == NumericDomain::INTEGER && value.type == Value::Type::INT) {
+      return matches_integer(value.int_val);
+    }
+    if (domain_ == NumericDomain::REAL && value.type != Value::Type::STRING) {
+      return matches_number(number_of(value));
+    }
+    return matches(value);
+  }
+
+  void evaluate_batch(const std::vector<Row> &rows,
+                      uint64_t *mask) const override {
+    static thread_local std::vector<int64_t> integers;
+    static thread_local std::vector<double> numbers;
+    static thread_local std::vector<uint64_t> valid;
+    size_t valid_count;
+    if (domain_ == NumericDomain::INTEGER) {
+      valid_count = gather_int64(rows, index_, integers, valid);
+      integer_kernel(integers.data(), rows.size(), mask);
+    } else if (domain_ == NumericDomain::REAL) {
+      valid_count = gather_double(rows, index_, numbers, valid);
+      number_kernel(numbers.data(), rows.size(), mask);
+    } else {
+      PredicateNode::evaluate_batch(rows, mask);
+      return;
+    }
+    finish_batch(*this, rows, valid, valid_count, mask);
+  }
+
+protected:
+  virtual bool matches_integer(int64_t value) const = 0;
+  virtual bool matches_number(double value) const = 0;
+  virtual bool matches(const Value &value) const = 0;
+  virtual void integer_kernel(const int64_t *values, size_t count,
+                              uint64_t *mask) const = 0;
+  virtual void number_kernel(const double *values, size_t count,
+                             uint64_t *mask) const = 0;
+
+  size_t index_;
+  std::string column_;
+  std::string data_type_;
+  std::vector<Value> literals_;
+  NumericDomain domain_;
+  bool integer_column_;
+  std::vector<int64_t> integers_;
+  std::vector<double> numbers_;
+};
+
+// column BETWEEN low AND high，literals_ = {low, high}
+class BetweenNode : public MultiLiteralNode {
+public:
+  using MultiLiteralNode::MultiLiteralNode;
+
+  std::string describe() const override {
+    return column_ + " BETWEEN " + literal_text(literals_[0]) + " AND " +
+           literal_text(literals_[1]);
+  }
+
+protected:
+  bool matches_integer(int64_t value) const override {
+    return value >= integers_[0] && value <= integers_[1];
+  }
+  bool matches_number(double value) const override {
+    return value >= numbers_[0] && value <= numbers_[1];
+  }
+  bool matches(const Value &value) const override {
+    return compare_values(value, literals_[0]) >= 0 &&
+           compare_values(value, literals_[1]) <= 0;
+  }
+  void integer_kernel(const int64_t *values, size_t count,
+                      uint64_t *mask) const override {
+    between_mask(values, count, integers_[0], integers_[1], mask);
+  }
+  void number_kernel(const double *values, size_t count,
+                     uint64_t *mask) const override {
+    between_mask(values, count, numbers_[0], numbers_[1], mask);
+  }
+};
+
+// column IN (v1, v2, ...)
+class InListNode : public MultiLiteralNode {
+public:
+  using MultiLiteralNode::MultiLiteralNode;
+
+  std::string describe() const override {
+    std::string out = column_ + " IN (";
+    for (size_t i = 0; i < literals_.size(); ++i) {
+      out += (i > 0 ? ", " : "") + literal_text(literals_[i]);
+    }
+    return out + ")";
+  }
+
+protected:
+  bool matches_integer(int64_t value) const override {
+    return std::find(integers_.begin(), integers_.end(), value) !=
+           integers_.end();
+  }
+  bool matches_number(double value) const override {
+    return std::find(numbers_.begin(), numbers_.end(), value) !=
+           numbers_.end();
+  }
+  bool matches(const Value &value) const override {
+    for (const auto &literal : literals_) {
+      if (compare_values(value, literal) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+  void integer_kernel(const int64_t *values, size_t count,
+                      uint64_t *mask) const override {
+    in_list_mask(values, count, integers_.data(), integers_.size(), mask);
+  }
+  void number_kernel(const double *values, size_t count,
+                     uint64_t *mask) const override {
+    in_list_mask(values, count, numbers_.data(), numbers_.size(), mask);
+  }
+};
+
+template <template <CompareOp> class Node>
+std::shared_ptr<const PredicateNode>
+make_node(CompareOp op, size_t index, const std::string &column,
+          const std::string &data_type, const Value &literal) {
+  switch (op) {
+  case CompareOp::EQ:
+    return std::make_shared<Node<CompareOp::EQ>>(index, column, data_type,
+                                                 literal);
+  case CompareOp::NE:
+    return std::make_shared<Node<CompareOp::NE>>(index, column, data_type,
+                                                 literal);
+  case CompareOp::LT:
+    return std::make_shared<Node<CompareOp::LT>>(index, column, data_type,
+                                                 literal);
+  case CompareOp::LE:
+    return std::make_shared<Node<CompareOp::LE>>(index, column, data_type,
+                                                 literal);
+  case CompareOp::GT:
+    return std::make_shared<Node<CompareOp::GT>>(index, column, data_type,
+                                                 literal);
+  case CompareOp::GE:
+    return std::make_shared<Node<CompareOp::GE>>(index, column, data_type,
+                                                 literal);
+  }
+  return nullptr;
+}
+
+class ConstantNode : public PredicateNode {
+public:
+  explicit ConstantNode(bool value) : value_(value) {}
+  bool evaluate(const std::vector<std::string> &) const override {
+    return value_;
+  }
+  bool evaluate(const Row &) const override { return value_; }
+  std::string describe() const override { return value_ ? "TRUE" : "FALSE"; }
+
+  void evaluate_batch(const std::vector<Row> &rows,
+                      uint64_t *mask) const override {
+    std::fill(mask, mask + bitmap_words(rows.size()), 0);
+    if (value_) {
+      bitmap_not(mask, rows.size());
+    }
+  }
+
+private:
+  bool value_;
+};
+
+// AND/OR：子节点按顺序短路求值
+template <bool IsAnd> class JunctionNode : public PredicateNode {
+public:
+  explicit JunctionNode(std::vector<std::shared_ptr<const PredicateNode>> terms)
+      : terms_(std::move(terms)) {}
+
+  bool evaluate(const std::vector<std::string> &record) const override {
+    for (const auto &term : terms_) {
+      if (term->evaluate(record) != IsAnd) {
+        return !IsAnd;
+      }
+    }
+    return IsAnd;
+  }
+
+  bool evaluate(const Row &row) const override {
+    for (const auto &term : terms_) {
+      if (term->evaluate(row) != IsAnd) {
+        return !IsAnd;
+      }
+    }
+    return IsAnd;
+  }
+
+  // 整批求值时逐个子节点求位图再按位组合
+  void evaluate_batch(const std::vector<Row> &rows,
+                      uint64_t *mask) const override {
+    terms_.front()->evaluate_batch(rows, mask);
+    std::vector<uint64_t> term_mask(bitmap_words(rows.size()));
+    for (size_t i = 1; i < terms_.size(); ++i) {
+      terms_[i]->evaluate_batch(rows, term_mask.data());
+      if (IsAnd) {
+        bitmap_and(mask, term_mask.data(), rows.size());
+      } else {
+        bitmap_or(mask, term_mask.data(), rows.size());
+      }
+    }
+  }
+
+  std::string describe() const override {
+    std::string out = "(";
+    for (size_t i = 0; i < terms_.size(); ++i) {
+      out += (i > 0 ? (IsAnd ? " AND " : " OR ") : "") + terms_[i]->describe();
+    }
+    return out + ")";
+  }
+
+private:
+  std::vector<std::shared_ptr<const PredicateNode>> terms_;
+};
+
+class NotNode : public PredicateNode {
+public:
+  explicit NotNode(std::shared_ptr<const PredicateNode> term)
+      : term_(std::move(term)) {}
+  bool evaluate(const std::vector<std::string> &record) const override {
+    return !term_->evaluate(record);
+  }
+  bool evaluate(const Row &row) const override { return !term_->evaluate(row); }
+  void evaluate_batch(const std::vector<Row> &rows,
+                      uint64_t *mask) const override {
+    term_->evaluate_batch(rows, mask);
+    bitmap_not(mask, rows.size());
+  }
+  std::string describe() const override {
+    return "NOT " + term_->describe();
+  }
+
+private:
+  std::shared_ptr<const PredicateNode> term_;
+};
+
+std::string trim(const std::string &text) {
+  size_t begin = text.find_first_not_of(" \t\n\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = text.find_last_not_of(" \t\n\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+std::string to_upper(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+  return text;
+}
+
+// 常量只转换一次：带引号的是字符串，否则按列类型转换
+Value convert_literal(const std::string &literal,
+                      const std::string &data_type) {
+  std::string raw = trim(literal);
+  if (raw.size() >= 2 && (raw.front() == '\'' || raw.front() == '"') &&
+      raw.back() == raw.front()) {
+    return Value(raw.substr(1, raw.size() - 2));
+  }
+  Value constant = parse_value(raw, data_type);
+  if (column_kind(data_type) == ColumnKind::INTEGER &&
+      constant.type == Value::Type::STRING) {
+    // 整数列与小数常量比较时按数值比较
+    Value number = parse_value(raw, "DOUBLE");
+    if (number.type == Value::Type::DOUBLE) {
+      return number;
+    }
+  }
+  return constant;
+}
+
+// 按逗号拆分IN列表，引号内的逗号不拆分
+std::vector<std::string> split_list(const std::string &text) {
+  std::vector<std::string> items;
+  std::string current;
+  char quote = 0;
+  for (char c : text) {
+    if (quote != 0) {
+      quote = c == quote ? 0 : quote;
+    } else if (c == '\'' || c == '"') {
+      quote = c;
+    } else if (c == ',') {
+      items.push_back(trim(current));
+      current.clear();
+      continue;
+    }
+    current += c;
+  }
+  if (!trim(current).empty() || !items.empty()) {
+    items.push_back(trim(current));
+  }
+  return items;
+}
+
+CompareOp parse_op(const std::string &op) {
+  std::string text = trim(op);
+  if (text == "=") {
+    return CompareOp::EQ;
+  } else if (text == "<>" || text == "!=") {
+    return CompareOp::NE;
+  } else if (text == "<") {
+    return CompareOp::LT;
+  } else if (text == "<=") {
+    return CompareOp::LE;
+  } else if (text == ">") {
+    return CompareOp::GT;
+  } else if (text == ">=") {
+    return CompareOp::GE;
+  }
+  throw Exception("Unsupported comparison operator: " + op);
+}
+
+std::shared_ptr<const PredicateNode> true_node() {
+  static const auto node = std::make_shared<ConstantNode>(true);
+  return node;
+}
+
+} // namespace
+
+CompiledPredicate::CompiledPredicate() : root_(true_node()) {}
+
+CompiledPredicate::CompiledPredicate(std::shared_ptr<const PredicateNode> root)
+    : root_(std::move(root)) {}
+
+CompiledPredicate CompiledPredicate::compile(
+    const std::vector<ColumnMeta> &columns, const std::string &column,
+    const std::string &op, const std::string &literal) {
+  // BETWEEN/IN（可带NOT）的常量部分分别为"low AND high"和"(v1, v2, ...)"
+  std::string keyword = to_upper(trim(op));
+  bool negated = keyword.rfind("NOT ", 0) == 0;
+  if (negated) {
+    keyword = trim(keyword.substr(4));
+  }
+  if (keyword == "BETWEEN") {
+    size_t and_pos = to_upper(literal).find(" AND ");
+    if (and_pos == std::string::npos) {
+      throw Exception("Invalid BETWEEN range: " + literal);
+    }
+    CompiledPredicate predicate =
+        between(columns, column, literal.substr(0, and_pos),
+                literal.substr(and_pos + 5));
+    return negated ? negate(predicate) : predicate;
+  }
+  if (keyword == "IN") {
+    std::string list = trim(literal);
+    if (list.size() >= 2 && list.front() == '(' && list.back() == ')') {
+      list = list.substr(1, list.size() - 2);
+    }
+    CompiledPredicate predicate = in_list(columns, column, split_list(list));
+    return negated ? negate(predicate) : predicate;
+  }
+  if (negated) {
+    throw Exception("Unsupported comparison operator: " + op);
+  }
+
+  size_t index = resolve_column(columns, column);
+  CompareOp compare_op = parse_op(op);
+  const std::string &data_type = columns[index].data_type;
+  ColumnKind kind = column_kind(data_type);
+  Value constant = convert_literal(literal, data_type);
+
+  const std::string &name = columns[index].name;
+  if (kind == ColumnKind::INTEGER && constant.type == Value::Type::INT) {
+    return CompiledPredicate(make_node<IntegerComparison>(
+        compare_op, index, name, data_type, constant));
+  }
+  if ((kind == ColumnKind::INTEGER || kind == ColumnKind::REAL) &&
+      constant.type == Value::Type::DOUBLE) {
+    return CompiledPredicate(make_node<RealComparison>(
+        compare_op, index, name, data_type, constant));
+  }
+  if (kind == ColumnKind::TEXT && constant.type == Value::Type::STRING) {
+    return CompiledPredicate(make_node<TextComparison>(
+        compare_op, index, name, data_type, constant));
+  }
+  return CompiledPredicate(make_node<GenericComparison>(
+      compare_op, index, name, data_type, constant));
+}
+
+CompiledPredicate CompiledPredicate::between(
+    const std::vector<ColumnMeta> &columns, const std::string &column,
+    const std::string &low, const std::string &high) {
+  size_t index = resolve_column(columns, column);
+  const std::string &data_type = columns[index].data_type;
+  return CompiledPredicate(std::make_shared<BetweenNode>(
+      index, columns[index].name, data_type,
+      std::vector<Value>{convert_literal(low, data_type),
+                         convert_literal(high, data_type)}));
+}
+
+CompiledPredicate
+CompiledPredicate::in_list(const std::vector<ColumnMeta> &columns,
+                           const std::string &column,
+                           const std::vector<std::string> &literals) {
+  size_t index = resolve_column(columns, column);
+  if (literals.empty()) {
+    throw Exception("Empty IN list for column: " + column);
+  }
+  const std::string &data_type = columns[index].data_type;
+  std::vector<Value> values;
+  for (const auto &literal : literals) {
+    values.push_back(convert_literal(literal, data_type));
+  }
+  return CompiledPredicate(std::make_shared<InListNode>(
+      index, columns[index].name, data_type, std::move(values)));
+}
+
+CompiledPredicate
+CompiledPredicate::compile(const sql_parser::WhereClause &where,
+                           const std::vector<ColumnMeta> &columns) {
+  if (where.getColumnName().empty()) {
+    return CompiledPredicate();
+  }
+  return compile(columns, where.getColumnName(), where.getOp(),
+                 where.getValue());
+}
+
+CompiledPredicate
+CompiledPredicate::compile(const sql_parser::WhereClause &where,
+                           const TableMetadata &metadata) {
+  return compile(where, table_columns(metadata));
+}
+
+CompiledPredicate CompiledPredicate::constant(bool value) {
+  return value ? CompiledPredicate()
+               : CompiledPredicate(std::make_shared<ConstantNode>(false));
+}
+
+CompiledPredicate
+CompiledPredicate::all_of(const std::vector<CompiledPredicate> &terms) {
+  std::vector<std::shared_ptr<const PredicateNode>> nodes;
+  for (const auto &term : terms) {
+    if (!term.always_true()) {
+      nodes.push_back(term.root_);
+    }
+  }
+  if (nodes.empty()) {
+    return CompiledPredicate();
+  }
+  if (nodes.size() == 1) {
+    return CompiledPredicate(nodes.front());
+  }
+  return CompiledPredicate(std::make_shared<JunctionNode<true>>(nodes));
+}
+
+CompiledPredicate
+CompiledPredicate::any_of(const std::vector<CompiledPredicate> &terms) {
+  std::vector<std::shared_ptr<const PredicateNode>> nodes;
+  for (const auto &term : terms) {
+    if (term.always_true()) {
+      return CompiledPredicate();
+    }
+    nodes.push_back(term.root_);
+  }
+  if (nodes.empty()) {
+    return constant(false);
+  }
+  if (nodes.size() == 1) {
+    return CompiledPredicate(nodes.front());
+  }
+  return CompiledPredicate(std::make_shared<JunctionNode<false>>(nodes));
+}
+
+CompiledPredicate CompiledPredicate::negate(const CompiledPredicate &term) {
+  return CompiledPredicate(std::make_shared<NotNode>(term.root_));
+}
+
+bool CompiledPredicate::operator()(
+    const std::vector<std::string> &record) const {
+  return root_->evaluate(record);
+}
+
+bool CompiledPredicate::operator()(const Row &row) const {
+  return root_->evaluate(row);
+}
+
+void CompiledPredicate::select(const std::vector<Row> &rows,
+                               SelectionVector &selection) const {
+  if (always_true()) {
+    selection.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+      selection[i] = static_cast<uint32_t>(i);
+    }
+    return;
+  }
+  static thread_local std::vector<uint64_t> mask;
+  mask.resize(bitmap_words(rows.size()));
+  root_->evaluate_batch(rows, mask.data());
+  mask_to_selection(mask.data(), rows.size(), selection);
+}
+
+bool CompiledPredicate::always_true() const { return root_ == true_node(); }
+
+std::string CompiledPredicate::describe() const { return root_->describe(); }
+
+std::vector<ColumnMeta> table_columns(const TableMetadata &metadata) {
+  std::vector<ColumnMeta> columns;
+  columns.reserve(metadata.columns.size());
+  for (const auto &column : metadata.columns) {
+    columns.push_back(
+        {column.name, column.type, column.nullable, false, false,
+         column.default_value});
+  }
+  return columns;
+}
+
+} // namespace sqlcc
@@ -0,0 +1,144 @@
+#include "execution/explain_analyze.h"
+#include "execution/parallel_scan.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+namespace sqlcc {
+
+namespace {
+
+double thread_cpu_ms() {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) * 1000.0 +
+         static_cast<double>(ts.tv_nsec) / 1e6;
+}
+
+std::string format_ms(double ms) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.3f", ms);
+  return buffer;
+}
+
+/**
+ * 在作用域结束时把墙钟时间、CPU时间和缓冲池访问的增量累加到profile，
+ * 子算子抛出异常时同样累加
+ */
+class ProfileScope {
+public:
+  explicit ProfileScope(OperatorProfile &profile)
+      : profile_(profile), wall_start_(std::chrono::steady_clock::now()),
+        cpu_start_(thread_cpu_ms()), buffers_start_(thread_buffer_usage()) {}
+
+  ~ProfileScope() {
+    std::chrono::duration<double, std::milli> wall =
+        std::chrono::steady_clock::now() - wall_start_;
+    profile_.wall_ms += wall.count();
+    profile_.cpu_ms += thread_cpu_ms() - cpu_start_;
+    profile_.buffers += thread_buffer_usage() - buffers_start_;
+  }
+
+private:
+  OperatorProfile &profile_;
+  std::chrono::steady_clock::time_point wall_start_;
+  double cpu_start_;
+  BufferUsage buffers_start_;
+};
+
+void explain_analyze(const PhysicalOperator &node, std::string &out,
+                     int depth) {
+  const auto *instrumented = dynamic_cast<const InstrumentedOperator *>(&node);
+  const PhysicalOperator &op = instrumented ? instrumented->input() : node;
+
+  out.append(static_cast<size_t>(depth) * 2, ' ');
+  out += (depth > 0 ? "-> " : "") + op.describe();
+
+  std::string details;
+  if (op.estimated_rows() >= 0) {
+    details += "est rows=" + std::to_string(std::llround(op.estimated_rows()));
+  }
+  std::string buffers;
+  if (instrumented) {
+    const OperatorProfile &profile = instrumented->profile();
+    if (!details.empty()) {
+      details += ", ";
+    }
+    if (profile.loops == 0) {
+      details += "never executed";
+    } else {
+      details += "actual rows=" + std::to_string(profile.rows) +
+                 ", loops=" + std::to_string(profile.loops) +
+                 ", time=" + format_ms(profile.wall_ms) + " ms" +
+                 ", cpu=" + format_ms(profile.cpu_ms) + " ms";
+      BufferUsage usage = profile.buffers;
+      // 工作线程上的页面访问计入汇集算子
+      if (const auto *exchange = dynamic_cast<const ExchangeOperator *>(&op)) {
+        usage += exchange->worker_buffer_usage();
+      }
+      buffers = " buffers: hits=" + std::to_string(usage.hits) +
+                " misses=" + std::to_string(usage.misses) +
+                " reads=" + std::to_string(usage.disk_reads);
+    }
+  }
+  if (!details.empty()) {
+    out += " (" + details + ")";
+  }
+  out += buffers + "\n";
+
+  for (const auto &child : op.children()) {
+    explain_analyze(*child, out, depth + 1);
+  }
+}
+
+} // namespace
+
+// ==================== InstrumentedOperator ====================
+
+InstrumentedOperator::InstrumentedOperator(OperatorPtr input) {
+  columns_ = input->output_columns();
+  estimated_rows_ = input->estimated_rows();
+  children_.push_back(std::move(input));
+}
+
+void InstrumentedOperator::open() {
+  ProfileScope scope(profile_);
+  ++profile_.loops;
+  PhysicalOperator::open();
+}
+
+bool InstrumentedOperator::next(RowBatch &batch) {
+  ProfileScope scope(profile_);
+  bool has_rows = children_.front()->next(batch);
+  if (has_rows) {
+    profile_.rows += batch.size();
+    rows_produced_ += batch.size();
+  }
+  return has_rows;
+}
+
+void InstrumentedOperator::close() {
+  ProfileScope scope(profile_);
+  PhysicalOperator::close();
+}
+
+std::string InstrumentedOperator::describe() const {
+  return input().describe();
+}
+
+OperatorPtr instrument_operator_tree(OperatorPtr root) {
+  // 汇集算子直接持有各工作线程流水线的指针，流水线保持原样
+  if (!dynamic_cast<ExchangeOperator *>(root.get())) {
+    root->wrap_children(instrument_operator_tree);
+  }
+  return std::make_unique<InstrumentedOperator>(std::move(root));
+}
+
+std::string explain_analyze(const PhysicalOperator &root) {
+  std::string out;
+  explain_analyze(root, out, 0);
+  return out;
+}
+
+} // namespace sqlcc
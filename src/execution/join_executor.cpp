@@ -1,13 +1,113 @@
 #include "execution/join_executor.h"
 #include "exception.h"
+#include "execution/physical_operator.h"
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <sstream>
 
 namespace sqlcc {
 
+namespace {
+
+// 代价模型中的相对系数
+constexpr double kHashBuildCost = 2.0;   // 构建侧每行的插入代价
+constexpr double kIndexPageCost = 4.0;   // 索引连接每次随机页读取的代价
+
+double log2_rows(size_t rows) { return std::log2(static_cast<double>(rows) + 1); }
+
+bool is_sorted_on_key(const std::vector<Row> &rows, size_t key) {
+  for (size_t i = 1; i < rows.size(); ++i) {
+    if (key >= rows[i].values.size() ||
+        compare_values(rows[i - 1].values[key], rows[i].values[key]) > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 按连接键稳定排序后的行下标
+std::vector<size_t> sorted_order(const std::vector<Row> &rows, size_t key,
+                                 bool already_sorted) {
+  std::vector<size_t> order(rows.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  if (!already_sorted) {
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return compare_values(rows[a].values[key], rows[b].values[key]) < 0;
+    });
+  }
+  return order;
+}
+
+} // namespace
+
+double estimate_join_cost(JoinAlgorithm algorithm,
+                          const JoinInputEstimate &outer,
+                          const JoinInputEstimate &inner) {
+  double left = static_cast<double>(outer.rows);
+  double right = static_cast<double>(inner.rows);
+
+  switch (algorithm) {
+  case JoinAlgorithm::NESTED_LOOP:
+    return left * right;
+  case JoinAlgorithm::HASH:
+    return kHashBuildCost * std::min(left, right) + std::max(left, right);
+  case JoinAlgorithm::SORT_MERGE: {
+    double cost = left + right;
+    if (!outer.sorted_on_key) {
+      cost += left * log2_rows(outer.rows);
+    }
+    if (!inner.sorted_on_key) {
+      cost += right * log2_rows(inner.rows);
+    }
+    return cost;
+  }
+  case JoinAlgorithm::INDEX_NESTED_LOOP:
+    if (!inner.indexed_on_key) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return left * (log2_rows(inner.rows) + kIndexPageCost);
+  case JoinAlgorithm::AUTO:
+    break;
+  }
+  return std::numeric_limits<double>::infinity();
+}
+
+JoinAlgorithm choose_join_algorithm(const JoinInputEstimate &outer,
+                                    const JoinInputEstimate &inner,
+                                    JoinType join_type, bool equi_join) {
+  if (!equi_join || join_type == JoinType::CROSS_JOIN) {
+    return JoinAlgorithm::NESTED_LOOP;
+  }
+
+  JoinAlgorithm best = JoinAlgorithm::HASH;
+  double best_cost = estimate_join_cost(JoinAlgorithm::HASH, outer, inner);
+  for (JoinAlgorithm candidate :
+       {JoinAlgorithm::SORT_MERGE, JoinAlgorithm::NESTED_LOOP}) {
+    double cost = estimate_join_cost(candidate, outer, inner);
+    if (cost < best_cost) {
+      best = candidate;
+      best_cost = cost;
+    }
+  }
+
+  // 索引连接不会读取内表的未匹配行，不能输出内表一侧的未匹配行
+  bool preserves_inner = join_type == JoinType::RIGHT_JOIN ||
+                         join_type == JoinType::FULL_JOIN;
+  if (!preserves_inner &&
+      estimate_join_cost(JoinAlgorithm::INDEX_NESTED_LOOP, outer, inner) <
+          best_cost) {
+    best = JoinAlgorithm::INDEX_NESTED_LOOP;
+  }
+  return best;
+}
+
 JoinExecutor::JoinExecutor(std::shared_ptr<SqlExecutor> sql_executor)
-    : sql_executor_(sql_executor) {}
+    : sql_executor_(sql_executor), memory_limit_(kDefaultOperatorMemoryLimit),
+      algorithm_(JoinAlgorithm::AUTO) {}
 
 ExecutionResult JoinExecutor::execute(const ExecutionResult &left_result,
                                       const ExecutionResult &right_result,
@@ -23,10 +123,46 @@ ExecutionResult JoinExecutor::execute(const ExecutionResult &left_result,
     stats_.left_rows = left_result.rows.size();
     stats_.right_rows = right_result.rows.size();
 
-    // 执行JOIN操作
-    // 目前只实现了Nested Loop JOIN，后续可以扩展其他算法
-    ExecutionResult result = execute_nested_loop_join(
-        left_result, right_result, join_type, join_condition);
+    // 解析连接条件并选择连接算法
+    size_t left_key = 0;
+    size_t right_key = 0;
+    bool equi_join = join_type != JoinType::CROSS_JOIN &&
+                     parse_join_condition(join_condition,
+                                          left_result.column_metadata,
+                                          right_result.column_metadata,
+                                          left_key, right_key);
+    JoinAlgorithm algorithm =
+        equi_join ? algorithm_ : JoinAlgorithm::NESTED_LOOP;
+    bool left_sorted = false;
+    bool right_sorted = false;
+    if (algorithm != JoinAlgorithm::NESTED_LOOP &&
+        algorithm != JoinAlgorithm::HASH) {
+      left_sorted = is_sorted_on_key(left_result.rows, left_key);
+      right_sorted = is_sorted_on_key(right_result.rows, right_key);
+    }
+    if (algorithm == JoinAlgorithm::AUTO ||
+        algorithm == JoinAlgorithm::INDEX_NESTED_LOOP) {
+      algorithm = choose_join_algorithm(
+          {left_result.rows.size(), left_sorted, false},
+          {right_result.rows.size(), right_sorted, false}, join_type, true);
+    }
+
+    ExecutionResult result;
+    switch (algorithm) {
+    case JoinAlgorithm::HASH:
+      result = execute_hash_join(left_result, right_result, join_type,
+                                 left_key, right_key);
+      break;
+    case JoinAlgorithm::SORT_MERGE:
+      result = execute_sort_merge_join(left_result, right_result, join_type,
+                                       left_key, right_key, left_sorted,
+                                       right_sorted);
+      break;
+    default:
+      result = execute_nested_loop_join(left_result, right_result, join_type,
+                                        join_condition);
+      break;
+    }
 
     // 更新统计信息
     auto end_time = std::chrono::steady_clock::now();
@@ -46,6 +182,15 @@ ExecutionResult JoinExecutor::execute(const ExecutionResult &left_result,
 
 JoinExecutionStats JoinExecutor::get_stats() const { return stats_; }
 
+void JoinExecutor::set_memory_limit(size_t limit_bytes) {
+  // 至少容纳一行，避免分区计算除零
+  memory_limit_ = std::max<size_t>(limit_bytes, 1);
+}
+
+void JoinExecutor::set_algorithm(JoinAlgorithm algorithm) {
+  algorithm_ = algorithm;
+}
+
 ExecutionResult JoinExecutor::execute_nested_loop_join(
     const ExecutionResult &left_result, const ExecutionResult &right_result,
     JoinType join_type, const std::string &join_condition) {
@@ -61,6 +206,7 @@ ExecutionResult JoinExecutor::execute_nested_loop_join(
 
   // 执行Nested Loop JOIN
   auto join_start = std::chrono::steady_clock::now();
+  stats_.algorithm = "nested_loop";
 
   // 遍历左表的每一行
   for (const auto &left_row : left_result.rows) {
@@ -126,21 +272,439 @@ ExecutionResult JoinExecutor::execute_nested_loop_join(
   return result;
 }
 
-bool JoinExecutor::match_join_condition(
-    const Row &left_row, const Row &right_row,
-    const std::vector<ColumnMeta> &left_meta,
-    const std::vector<ColumnMeta> &right_meta,
-    const std::string &join_condition) {
-  // 简化实现：目前只支持简单的等式连接，如 "left.col1 = right.col2"
-  // TODO: 实现更复杂的JOIN条件解析和匹配
+ExecutionResult JoinExecutor::execute_hash_join(
+    const ExecutionResult &left_result, const ExecutionResult &right_result,
+    JoinType join_type, size_t left_key, size_t right_key) {
+  ExecutionResult result;
+  result.column_metadata = merge_column_metadata(left_result.column_metadata,
+                                                 right_result.column_metadata);
+
+  auto join_start = std::chrono::steady_clock::now();
+
+  // 在较小的输入上建立哈希表
+  bool build_left = left_result.rows.size() < right_result.rows.size();
+  const ExecutionResult &build = build_left ? left_result : right_result;
+  const ExecutionResult &probe = build_left ? right_result : left_result;
+
+  // 按左右表角色判断哪一侧需要保留未匹配行
+  bool keep_left = join_type == JoinType::LEFT_JOIN ||
+                   join_type == JoinType::FULL_JOIN;
+  bool keep_right = join_type == JoinType::RIGHT_JOIN ||
+                    join_type == JoinType::FULL_JOIN;
+
+  HashJoinPlan plan;
+  plan.join_type = join_type;
+  plan.build_left = build_left;
+  plan.build_key = build_left ? left_key : right_key;
+  plan.probe_key = build_left ? right_key : left_key;
+  plan.keep_build = build_left ? keep_left : keep_right;
+  plan.keep_probe = build_left ? keep_right : keep_left;
+  plan.left_width = left_result.column_metadata.size();
+  plan.right_width = right_result.column_metadata.size();
+
+  stats_.algorithm = "hash";
+  stats_.build_rows = build.rows.size();
+  stats_.rows_processed = build.rows.size() + probe.rows.size();
+
+  size_t build_bytes = 0;
+  for (const auto &row : build.rows) {
+    build_bytes += estimate_row_size(row);
+  }
+
+  if (build_bytes <= memory_limit_) {
+    join_in_memory(plan, build.rows, make_row_reader(probe.rows), result);
+  } else {
+    // 构建侧超出内存限制，划分分区并溢出到磁盘
+    stats_.algorithm = "grace_hash";
+    join_partitioned(plan, make_row_reader(build.rows),
+                     make_row_reader(probe.rows), build_bytes,
+                     build.rows.size(), 0, result);
+  }
+
+  auto join_end = std::chrono::steady_clock::now();
+  stats_.join_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      join_end - join_start);
+
+  result.success = true;
+  result.message = "JOIN operation completed successfully";
+
+  return result;
+}
+
+void JoinExecutor::join_in_memory(const HashJoinPlan &plan,
+                                  const std::vector<Row> &build,
+                                  const RowReader &probe,
+                                  ExecutionResult &result) {
+  JoinHashTable hash_table;
+  hash_table.build(build, plan.build_key);
+
+  while (const Row *probe_row = probe()) {
+    size_t match = plan.probe_key < probe_row->values.size()
+                       ? hash_table.find(probe_row->values[plan.probe_key])
+                       : JoinHashTable::npos;
+    if (match == JoinHashTable::npos) {
+      if (plan.keep_probe) {
+        emit_row(plan, nullptr, probe_row, result);
+      }
+      continue;
+    }
+    for (; match != JoinHashTable::npos; match = hash_table.next(match)) {
+      hash_table.mark_matched(match);
+      emit_row(plan, &build[match], probe_row, result);
+    }
+  }
+
+  // 构建侧未匹配的行，无需第二次嵌套循环
+  if (plan.keep_build) {
+    for (size_t i = 0; i < build.size(); ++i) {
+      if (!hash_table.matched(i)) {
+        emit_row(plan, &build[i], nullptr, result);
+      }
+    }
+  }
+}
+
+namespace {
+
+// 分区扇出的上限与递归重分区的最大深度
+constexpr size_t kMaxJoinPartitions = 64;
+constexpr size_t kMaxPartitionDepth = 4;
+
+// 每层使用不同的种子重新打散哈希值，避免递归时分区不变
+size_t partition_of(const Value &key, size_t depth, size_t fanout) {
+  uint64_t hash = hash_value(key) + (depth + 1) * 0x9E3779B97F4A7C15ULL;
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 33;
+  return static_cast<size_t>(hash % fanout);
+}
+
+} // namespace
+
+void JoinExecutor::join_partitioned(const HashJoinPlan &plan,
+                                    const RowReader &build,
+                                    const RowReader &probe, size_t build_bytes,
+                                    size_t build_count, size_t depth,
+                                    ExecutionResult &result) {
+  stats_.max_partition_depth = std::max(stats_.max_partition_depth, depth);
+
+  // 每个分区约占内存限制的一半，常驻分区连同哈希表可以装入内存
+  size_t fanout = 2 * ((build_bytes + memory_limit_ - 1) / memory_limit_);
+  fanout = std::min(std::max<size_t>(fanout, 2), kMaxJoinPartitions);
+
+  std::vector<std::unique_ptr<SpillFile>> build_parts(fanout);
+  std::vector<std::unique_ptr<SpillFile>> probe_parts(fanout);
+  auto spill = [](std::vector<std::unique_ptr<SpillFile>> &parts, size_t index,
+                  const Row &row) {
+    if (!parts[index]) {
+      parts[index] = std::make_unique<SpillFile>();
+    }
+    parts[index]->append(row);
+  };
+
+  // 划分构建侧，0号分区常驻内存；倾斜导致其超限时同样溢出
+  std::vector<Row> resident;
+  size_t resident_bytes = 0;
+  bool resident_spilled = false;
+  while (const Row *row = build()) {
+    const Value &key = row->values[plan.build_key];
+    size_t part = partition_of(key, depth, fanout);
+    if (part != 0 || resident_spilled) {
+      spill(build_parts, part, *row);
+      continue;
+    }
+    resident_bytes += estimate_row_size(*row);
+    resident.push_back(*row);
+    if (resident_bytes > memory_limit_ / 2) {
+      for (const auto &resident_row : resident) {
+        spill(build_parts, 0, resident_row);
+      }
+      resident.clear();
+      resident.shrink_to_fit();
+      resident_spilled = true;
+    }
+  }
+
+  // 划分探测侧，落入常驻分区的行立即探测
+  JoinHashTable hash_table;
+  if (!resident_spilled) {
+    hash_table.build(resident, plan.build_key);
+  }
+  while (const Row *row = probe()) {
+    const Value &key = row->values[plan.probe_key];
+    size_t part = partition_of(key, depth, fanout);
+    if (part != 0 || resident_spilled) {
+      spill(probe_parts, part, *row);
+      continue;
+    }
+    size_t match = hash_table.find(key);
+    if (match == JoinHashTable::npos && plan.keep_probe) {
+      emit_row(plan, nullptr, row, result);
+    }
+    for (; match != JoinHashTable::npos; match = hash_table.next(match)) {
+      hash_table.mark_matched(match);
+      emit_row(plan, &resident[match], row, result);
+    }
+  }
+  if (!resident_spilled && plan.keep_build) {
+    for (size_t i = 0; i < resident.size(); ++i) {
+      if (!hash_table.matched(i)) {
+        emit_row(plan, &resident[i], nullptr, result);
+      }
+    }
+  }
+  hash_table.clear();
+  resident.clear();
+  resident.shrink_to_fit();
+
+  // 逐个连接溢出的分区对
+  for (size_t part = 0; part < fanout; ++part) {
+    if (build_parts[part]) {
+      stats_.spilled_partitions++;
+      build_parts[part]->rewind();
+      stats_.spilled_bytes += build_parts[part]->bytes_written();
+    }
+    if (probe_parts[part]) {
+      probe_parts[part]->rewind();
+      stats_.spilled_bytes += probe_parts[part]->bytes_written();
+    }
+    join_spilled_partition(plan, build_parts[part].get(),
+                           probe_parts[part].get(), build_count, depth, result);
+    // 分区连接完成后立即删除临时文件
+    build_parts[part].reset();
+    probe_parts[part].reset();
+  }
+}
+
+void JoinExecutor::join_spilled_partition(const HashJoinPlan &plan,
+                                          SpillFile *build, SpillFile *probe,
+                                          size_t parent_build_count,
+                                          size_t depth,
+                                          ExecutionResult &result) {
+  // 一侧为空时只需输出另一侧需要保留的行
+  if (!build || !probe) {
+    SpillFile *only = build ? build : probe;
+    bool keep = build ? plan.keep_build : plan.keep_probe;
+    if (only && keep) {
+      RowReader reader = only->reader();
+      while (const Row *row = reader()) {
+        emit_row(plan, build ? row : nullptr, build ? nullptr : row, result);
+      }
+    }
+    return;
+  }
+
+  if (build->memory_size() <= memory_limit_) {
+    std::vector<Row> rows;
+    rows.reserve(build->row_count());
+    RowReader reader = build->reader();
+    while (const Row *row = reader()) {
+      rows.push_back(*row);
+    }
+    join_in_memory(plan, rows, probe->reader(), result);
+    return;
+  }
+
+  // 分区仍然过大：若上一次划分确实缩小了数据则换种子递归重分区，
+  // 否则（同一个键的大量重复）改为分块连接
+  if (depth + 1 < kMaxPartitionDepth &&
+      build->row_count() < parent_build_count) {
+    join_partitioned(plan, build->reader(), probe->reader(),
+                     build->memory_size(), build->row_count(), depth + 1,
+                     result);
+    return;
+  }
+  join_in_chunks(plan, *build, *probe, result);
+}
+
+void JoinExecutor::join_in_chunks(const HashJoinPlan &plan, SpillFile &build,
+                                  SpillFile &probe, ExecutionResult &result) {
+  std::vector<bool> probe_matched(probe.row_count(), false);
+  std::vector<Row> chunk;
+  size_t chunk_bytes = 0;
+  JoinHashTable hash_table;
+
+  auto join_chunk = [&]() {
+    hash_table.build(chunk, plan.build_key);
+    RowReader reader = probe.reader();
+    size_t probe_index = 0;
+    while (const Row *row = reader()) {
+      size_t match = hash_table.find(row->values[plan.probe_key]);
+      if (match != JoinHashTable::npos) {
+        probe_matched[probe_index] = true;
+      }
+      for (; match != JoinHashTable::npos; match = hash_table.next(match)) {
+        hash_table.mark_matched(match);
+        emit_row(plan, &chunk[match], row, result);
+      }
+      probe_index++;
+    }
+    if (plan.keep_build) {
+      for (size_t i = 0; i < chunk.size(); ++i) {
+        if (!hash_table.matched(i)) {
+          emit_row(plan, &chunk[i], nullptr, result);
+        }
+      }
+    }
+    chunk.clear();
+    chunk_bytes = 0;
+  };
+
+  // build.reader()与probe.reader()使用各自的文件，交替读取互不影响
+  RowReader build_reader = build.reader();
+  while (const Row *row = build_reader()) {
+    chunk_bytes += estimate_row_size(*row);
+    chunk.push_back(*row);
+    if (chunk_bytes >= memory_limit_) {
+      join_chunk();
+    }
+  }
+  if (!chunk.empty()) {
+    join_chunk();
+  }
+
+  if (plan.keep_probe) {
+    RowReader reader = probe.reader();
+    size_t probe_index = 0;
+    while (const Row *row = reader()) {
+      if (!probe_matched[probe_index++]) {
+        emit_row(plan, nullptr, row, result);
+      }
+    }
+  }
+}
+
+void JoinExecutor::emit_row(const HashJoinPlan &plan, const Row *build_row,
+                            const Row *probe_row, ExecutionResult &result) {
+  const Row *left_row = plan.build_left ? build_row : probe_row;
+  const Row *right_row = plan.build_left ? probe_row : build_row;
+
+  Row merged_row;
+  merged_row.values.reserve(plan.left_width + plan.right_width);
+  if (left_row) {
+    merged_row.values.insert(merged_row.values.end(), left_row->values.begin(),
+                             left_row->values.end());
+  } else {
+    merged_row.values.resize(plan.left_width);
+  }
+  if (right_row) {
+    merged_row.values.insert(merged_row.values.end(),
+                             right_row->values.begin(),
+                             right_row->values.end());
+  } else {
+    merged_row.values.resize(plan.left_width + plan.right_width);
+  }
+  result.rows.push_back(std::move(merged_row));
+}
+
+ExecutionResult JoinExecutor::execute_sort_merge_join(
+    const ExecutionResult &left_result, const ExecutionResult &right_result,
+    JoinType join_type, size_t left_key, size_t right_key, bool left_sorted,
+    bool right_sorted) {
+  ExecutionResult result;
+  result.column_metadata = merge_column_metadata(left_result.column_metadata,
+                                                 right_result.column_metadata);
+
+  auto join_start = std::chrono::steady_clock::now();
+  stats_.algorithm = "sort_merge";
+  stats_.rows_processed = left_result.rows.size() + right_result.rows.size();
+
+  const std::vector<Row> &left_rows = left_result.rows;
+  const std::vector<Row> &right_rows = right_result.rows;
+  std::vector<size_t> left_order =
+      sorted_order(left_rows, left_key, left_sorted);
+  std::vector<size_t> right_order =
+      sorted_order(right_rows, right_key, right_sorted);
+
+  bool keep_left = join_type == JoinType::LEFT_JOIN ||
+                   join_type == JoinType::FULL_JOIN;
+  bool keep_right = join_type == JoinType::RIGHT_JOIN ||
+                    join_type == JoinType::FULL_JOIN;
+
+  Row left_nulls;
+  left_nulls.values.resize(left_result.column_metadata.size());
+  Row right_nulls;
+  right_nulls.values.resize(right_result.column_metadata.size());
+
+  auto left_value = [&](size_t i) -> const Value & {
+    return left_rows[left_order[i]].values[left_key];
+  };
+  auto right_value = [&](size_t j) -> const Value & {
+    return right_rows[right_order[j]].values[right_key];
+  };
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < left_order.size() && j < right_order.size()) {
+    int cmp = compare_values(left_value(i), right_value(j));
+    if (cmp < 0) {
+      if (keep_left) {
+        result.rows.push_back(
+            merge_rows(left_rows[left_order[i]], right_nulls, join_type));
+      }
+      i++;
+    } else if (cmp > 0) {
+      if (keep_right) {
+        result.rows.push_back(
+            merge_rows(left_nulls, right_rows[right_order[j]], join_type));
+      }
+      j++;
+    } else {
+      // 找出两侧键相同的行组并输出其笛卡尔积
+      size_t left_end = i + 1;
+      while (left_end < left_order.size() &&
+             compare_values(left_value(left_end), right_value(j)) == 0) {
+        left_end++;
+      }
+      size_t right_end = j + 1;
+      while (right_end < right_order.size() &&
+             compare_values(left_value(i), right_value(right_end)) == 0) {
+        right_end++;
+      }
+      for (size_t a = i; a < left_end; ++a) {
+        for (size_t b = j; b < right_end; ++b) {
+          result.rows.push_back(merge_rows(left_rows[left_order[a]],
+                                           right_rows[right_order[b]],
+                                           join_type));
+        }
+      }
+      i = left_end;
+      j = right_end;
+    }
+  }
+
+  for (; keep_left && i < left_order.size(); ++i) {
+    result.rows.push_back(
+        merge_rows(left_rows[left_order[i]], right_nulls, join_type));
+  }
+  for (; keep_right && j < right_order.size(); ++j) {
+    result.rows.push_back(
+        merge_rows(left_nulls, right_rows[right_order[j]], join_type));
+  }
+
+  auto join_end = std::chrono::steady_clock::now();
+  stats_.join_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      join_end - join_start);
+
+  result.success = true;
+  result.message = "JOIN operation completed successfully";
+
+  return result;
+}
 
+bool JoinExecutor::parse_join_condition(
+    const std::string &join_condition, const std::vector<ColumnMeta> &left_meta,
+    const std::vector<ColumnMeta> &right_meta, size_t &left_key,
+    size_t &right_key) const {
   if (join_condition.empty()) {
-    return true; // 无条件JOIN（CROSS JOIN）
+    return false;
   }
 
-  // 查找等式运算符
+  // 查找等式运算符（排除 <=、>=、!= 等）
   size_t eq_pos = join_condition.find('=');
-  if (eq_pos == std::string::npos) {
+  if (eq_pos == std::string::npos || eq_pos == 0 ||
+      std::string("<>!").find(join_condition[eq_pos - 1]) !=
+          std::string::npos) {
     // 只支持等式连接
     throw Exception("Only equality join conditions are supported");
   }
@@ -158,50 +722,48 @@ bool JoinExecutor::match_join_condition(
   trim(left_col_str);
   trim(right_col_str);
 
-  // 解析左列的表名和列名
-  size_t left_dot_pos = left_col_str.find('.');
-  std::string left_table_name, left_column_name;
-  if (left_dot_pos != std::string::npos) {
-    left_table_name = left_col_str.substr(0, left_dot_pos);
-    left_column_name = left_col_str.substr(left_dot_pos + 1);
-  } else {
-    left_column_name = left_col_str;
-  }
-
-  // 解析右列的表名和列名
-  size_t right_dot_pos = right_col_str.find('.');
-  std::string right_table_name, right_column_name;
-  if (right_dot_pos != std::string::npos) {
-    right_table_name = right_col_str.substr(0, right_dot_pos);
-    right_column_name = right_col_str.substr(right_dot_pos + 1);
-  } else {
-    right_column_name = right_col_str;
-  }
+  // 去掉表名前缀
+  auto column_name = [](const std::string &str) {
+    size_t dot_pos = str.find('.');
+    return dot_pos == std::string::npos ? str : str.substr(dot_pos + 1);
+  };
 
-  // 查找左列的索引
-  size_t left_col_idx = -1;
-  for (size_t i = 0; i < left_meta.size(); ++i) {
-    if (left_meta[i].name == left_column_name) {
-      left_col_idx = i;
-      break;
+  auto find_column = [](const std::vector<ColumnMeta> &meta,
+                        const std::string &name) {
+    for (size_t i = 0; i < meta.size(); ++i) {
+      if (meta[i].name == name) {
+        return i;
+      }
     }
-  }
+    return static_cast<size_t>(-1);
+  };
+
+  std::string left_column_name = column_name(left_col_str);
+  std::string right_column_name = column_name(right_col_str);
 
-  if (left_col_idx == -1) {
+  left_key = find_column(left_meta, left_column_name);
+  if (left_key == static_cast<size_t>(-1)) {
     throw Exception("Left column not found: " + left_column_name);
   }
 
-  // 查找右列的索引
-  size_t right_col_idx = -1;
-  for (size_t i = 0; i < right_meta.size(); ++i) {
-    if (right_meta[i].name == right_column_name) {
-      right_col_idx = i;
-      break;
-    }
+  right_key = find_column(right_meta, right_column_name);
+  if (right_key == static_cast<size_t>(-1)) {
+    throw Exception("Right column not found: " + right_column_name);
   }
 
-  if (right_col_idx == -1) {
-    throw Exception("Right column not found: " + right_column_name);
+  return true;
+}
+
+bool JoinExecutor::match_join_condition(
+    const Row &left_row, const Row &right_row,
+    const std::vector<ColumnMeta> &left_meta,
+    const std::vector<ColumnMeta> &right_meta,
+    const std::string &join_condition) {
+  size_t left_col_idx = 0;
+  size_t right_col_idx = 0;
+  if (!parse_join_condition(join_condition, left_meta, right_meta,
+                            left_col_idx, right_col_idx)) {
+    return true; // 无条件JOIN（CROSS JOIN）
   }
 
   // 比较左右列的值
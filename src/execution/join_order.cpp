@@ -0,0 +1,313 @@
+#include "execution/join_order.h"
+#include "exception.h"
+#include "execution/statistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sqlcc {
+
+namespace {
+
+constexpr size_t kMaxJoinRelations = 64;
+
+uint64_t bit(size_t relation) { return uint64_t(1) << relation; }
+
+// 下标不大于relation的关系集合（DPccp中的B_v）
+uint64_t prefix(size_t relation) { return (bit(relation) << 1) - 1; }
+
+size_t lowest(uint64_t set) { return static_cast<size_t>(__builtin_ctzll(set)); }
+
+size_t to_rows(double rows) {
+  return static_cast<size_t>(std::llround(std::max(rows, 0.0)));
+}
+
+/**
+ * 代价模型：子树集合的行数为各关系行数之积乘以集合内全部连接条件的选择率，
+ * 与子树的划分方式无关，因此同一集合的不同连接树可以直接比较代价
+ */
+class JoinCostModel {
+public:
+  explicit JoinCostModel(const JoinGraph &graph)
+      : graph_(graph), adjacency_(graph.relations.size(), 0) {
+    for (const auto &predicate : graph_.predicates) {
+      adjacency_[predicate.left] |= bit(predicate.right);
+      adjacency_[predicate.right] |= bit(predicate.left);
+    }
+  }
+
+  uint64_t neighbors(uint64_t set) const {
+    uint64_t result = 0;
+    for (uint64_t rest = set; rest != 0; rest &= rest - 1) {
+      result |= adjacency_[lowest(rest)];
+    }
+    return result & ~set;
+  }
+
+  JoinTreePtr leaf(size_t relation) const {
+    auto node = std::make_shared<JoinTreeNode>();
+    node->relations = bit(relation);
+    node->relation = relation;
+    node->rows = std::max(graph_.relations[relation].rows, 1.0);
+    node->cost = graph_.relations[relation].scan_cost;
+    return node;
+  }
+
+  // 连接两棵子树，行数较小的一侧作为右侧（哈希构建侧）
+  JoinTreePtr join(const JoinTreePtr &a, const JoinTreePtr &b) const {
+    auto node = std::make_shared<JoinTreeNode>();
+    node->relations = a->relations | b->relations;
+    node->rows = a->rows * b->rows;
+    for (size_t i = 0; i < graph_.predicates.size(); ++i) {
+      uint64_t left = bit(graph_.predicates[i].left);
+      uint64_t right = bit(graph_.predicates[i].right);
+      if (((a->relations & left) && (b->relations & right)) ||
+          ((a->relations & right) && (b->relations & left))) {
+        node->predicates.push_back(i);
+        node->rows *= graph_.predicates[i].selectivity;
+      }
+    }
+    node->rows = std::max(node->rows, 1.0);
+    bool swap = a->rows < b->rows;
+    node->left = swap ? b : a;
+    node->right = swap ? a : b;
+
+    JoinInputEstimate outer;
+    outer.rows = to_rows(node->left->rows);
+    JoinInputEstimate inner;
+    inner.rows = to_rows(node->right->rows);
+    JoinAlgorithm algorithm =
+        node->predicates.empty() ? JoinAlgorithm::NESTED_LOOP : JoinAlgorithm::HASH;
+    node->cost = a->cost + b->cost +
+                 (estimate_join_cost(algorithm, outer, inner) + node->rows) *
+                     kCpuTupleCost;
+    return node;
+  }
+
+private:
+  const JoinGraph &graph_;
+  std::vector<uint64_t> adjacency_;
+};
+
+/**
+ * DPccp（Moerkotte & Neumann）：按"连通子图, 连通补集"对枚举，每一对都是
+ * 一次不含笛卡尔积的合法连接。枚举出的对按并集大小排序后再做动态规划，
+ * 保证合并时两侧的最优子树都已确定
+ */
+class DPccp {
+public:
+  DPccp(const JoinCostModel &model, size_t relations)
+      : model_(model), relations_(relations), best_(size_t(1) << relations) {}
+
+  JoinTreePtr run() {
+    for (size_t relation = 0; relation < relations_; ++relation) {
+      best_[bit(relation)] = model_.leaf(relation);
+    }
+    for (size_t v = relations_; v-- > 0;) {
+      emit_csg(bit(v));
+      enumerate_csg_rec(bit(v), prefix(v));
+    }
+
+    std::stable_sort(pairs_.begin(), pairs_.end(),
+                     [](const std::pair<uint64_t, uint64_t> &a,
+                        const std::pair<uint64_t, uint64_t> &b) {
+                       return __builtin_popcountll(a.first | a.second) <
+                              __builtin_popcountll(b.first | b.second);
+                     });
+    for (const auto &pair : pairs_) {
+      const JoinTreePtr &left = best_[pair.first];
+      const JoinTreePtr &right = best_[pair.second];
+      if (!left || !right) {
+        continue;
+      }
+      JoinTreePtr candidate = model_.join(left, right);
+      JoinTreePtr &current = best_[candidate->relations];
+      if (!current || candidate->cost < current->cost) {
+        current = std::move(candidate);
+      }
+    }
+    return best_[prefix(relations_ - 1)];
+  }
+
+private:
+  void enumerate_csg_rec(uint64_t set, uint64_t excluded) {
+    uint64_t neighbors = model_.neighbors(set) & ~excluded;
+    for (uint64_t subset = neighbors; subset != 0;
+         subset = (subset - 1) & neighbors) {
+      emit_csg(set | subset);
+    }
+    for (uint64_t subset = neighbors; subset != 0;
+         subset = (subset - 1) & neighbors) {
+      enumerate_csg_rec(set | subset, excluded | neighbors);
+    }
+  }
+
+  void emit_csg(uint64_t set) {
+    uint64_t excluded = set | prefix(lowest(set));
+    uint64_t neighbors = model_.neighbors(set) & ~excluded;
+    for (size_t v = relations_; v-- > 0;) {
+      if (neighbors & bit(v)) {
+        pairs_.emplace_back(set, bit(v));
+        enumerate_cmp_rec(set, bit(v), excluded | (prefix(v) & neighbors));
+      }
+    }
+  }
+
+  void enumerate_cmp_rec(uint64_t set, uint64_t complement, uint64_t excluded) {
+    uint64_t neighbors = model_.neighbors(complement) & ~excluded;
+    for (uint64_t subset = neighbors; subset != 0;
+         subset = (subset - 1) & neighbors) {
+      pairs_.emplace_back(set, complement | subset);
+    }
+    for (uint64_t subset = neighbors; subset != 0;
+         subset = (subset - 1) & neighbors) {
+      enumerate_cmp_rec(set, complement | subset, excluded | neighbors);
+    }
+  }
+
+  const JoinCostModel &model_;
+  size_t relations_;
+  std::vector<JoinTreePtr> best_;
+  std::vector<std::pair<uint64_t, uint64_t>> pairs_;
+};
+
+void check_relation_count(const JoinGraph &graph) {
+  if (graph.relations.empty()) {
+    throw Exception("Join requires at least one table");
+  }
+  if (graph.relations.size() > kMaxJoinRelations) {
+    throw Exception("Too many tables in join: " +
+                    std::to_string(graph.relations.size()));
+  }
+}
+
+} // namespace
+
+std::string
+JoinPredicate::to_string(const std::vector<JoinRelation> &relations) const {
+  return relations[left].name + "." + left_column + " = " +
+         relations[right].name + "." + right_column;
+}
+
+size_t JoinGraph::find(const std::string &name) const {
+  for (size_t i = 0; i < relations.size(); ++i) {
+    if (relations[i].name == name) {
+      return i;
+    }
+  }
+  return relations.size();
+}
+
+std::string JoinTreeNode::to_string(const JoinGraph &graph) const {
+  if (is_leaf()) {
+    return graph.relations[relation].name;
+  }
+  return "(" + left->to_string(graph) +
+         (predicates.empty() ? " CROSS JOIN " : " JOIN ") +
+         right->to_string(graph) + ")";
+}
+
+JoinTreePtr greedy_join_order(const JoinGraph &graph) {
+  check_relation_count(graph);
+  JoinCostModel model(graph);
+  std::vector<JoinTreePtr> trees;
+  for (size_t relation = 0; relation < graph.relations.size(); ++relation) {
+    trees.push_back(model.leaf(relation));
+  }
+
+  while (trees.size() > 1) {
+    // 优先合并有连接条件的一对中结果行数最小的；都没有连接条件时做笛卡尔积
+    JoinTreePtr best;
+    size_t best_i = 0, best_j = 0;
+    bool best_connected = false;
+    for (size_t i = 0; i < trees.size(); ++i) {
+      uint64_t neighbors = model.neighbors(trees[i]->relations);
+      for (size_t j = i + 1; j < trees.size(); ++j) {
+        bool connected = (neighbors & trees[j]->relations) != 0;
+        if (best_connected && !connected) {
+          continue;
+        }
+        JoinTreePtr candidate = model.join(trees[i], trees[j]);
+        if (!best || (connected && !best_connected) ||
+            candidate->rows < best->rows ||
+            (candidate->rows == best->rows && candidate->cost < best->cost)) {
+          best = std::move(candidate);
+          best_i = i;
+          best_j = j;
+          best_connected = connected;
+        }
+      }
+    }
+    trees[best_i] = std::move(best);
+    trees.erase(trees.begin() + static_cast<std::ptrdiff_t>(best_j));
+  }
+  return trees.front();
+}
+
+JoinTreePtr optimize_join_order(const JoinGraph &graph) {
+  check_relation_count(graph);
+  if (graph.relations.size() <= kMaxDpJoinRelations) {
+    JoinCostModel model(graph);
+    JoinTreePtr tree = DPccp(model, graph.relations.size()).run();
+    if (tree) {
+      return tree;
+    }
+  }
+  // 表太多，或连接图不连通（需要笛卡尔积）
+  return greedy_join_order(graph);
+}
+
+OperatorPtr
+build_join_operator(const JoinTreeNode &tree, const JoinGraph &graph,
+                    const std::function<OperatorPtr(size_t relation)> &make_leaf) {
+  if (tree.is_leaf()) {
+    OperatorPtr leaf = make_leaf(tree.relation);
+    leaf->qualify_columns(graph.relations[tree.relation].name);
+    if (leaf->estimated_rows() < 0) {
+      leaf->set_estimated_rows(graph.relations[tree.relation].rows);
+    }
+    return leaf;
+  }
+
+  OperatorPtr left = build_join_operator(*tree.left, graph, make_leaf);
+  OperatorPtr right = build_join_operator(*tree.right, graph, make_leaf);
+  if (tree.predicates.empty()) {
+    OperatorPtr root = std::make_unique<JoinOperator>(
+        std::move(left), std::move(right), JoinType::CROSS_JOIN, "");
+    root->set_estimated_rows(tree.rows);
+    return root;
+  }
+  OperatorPtr root = std::make_unique<JoinOperator>(
+      std::move(left), std::move(right), JoinType::INNER_JOIN,
+      graph.predicates[tree.predicates.front()].to_string(graph.relations));
+  // tree.rows已计入全部条件的选择率，连接本身的估计行数不含其余条件
+  double rows = tree.rows;
+  for (size_t i = 1; i < tree.predicates.size(); ++i) {
+    rows /= std::max(graph.predicates[tree.predicates[i]].selectivity, 1e-12);
+  }
+  root->set_estimated_rows(rows);
+
+  // 连接图中的环：同一对子树之间的其余条件在连接之上逐行比较
+  for (size_t i = 1; i < tree.predicates.size(); ++i) {
+    const JoinPredicate &predicate = graph.predicates[tree.predicates[i]];
+    const auto &columns = root->output_columns();
+    size_t left_index = resolve_column(
+        columns, graph.relations[predicate.left].name + "." + predicate.left_column);
+    size_t right_index = resolve_column(
+        columns,
+        graph.relations[predicate.right].name + "." + predicate.right_column);
+    root = std::make_unique<FilterOperator>(
+        std::move(root),
+        [left_index, right_index](const Row &row) {
+          return left_index < row.values.size() &&
+                 right_index < row.values.size() &&
+                 compare_values(row.values[left_index],
+                                row.values[right_index]) == 0;
+        },
+        predicate.to_string(graph.relations));
+    rows *= predicate.selectivity;
+    root->set_estimated_rows(rows);
+  }
+  return root;
+}
+
+} // namespace sqlcc
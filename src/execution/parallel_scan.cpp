@@ -0,0 +1,270 @@
+#include "execution/parallel_scan.h"
+#include "exception.h"
+#include <algorithm>
+
+namespace sqlcc {
+
+namespace {
+
+// 每个morsel包含的页数：足够摊薄领取开销，又能让各线程负载均衡
+constexpr size_t kPagesPerMorsel = 16;
+// 汇集缓冲区中每个工作线程最多积压的批数
+constexpr size_t kBatchesPerWorker = 4;
+
+} // namespace
+
+size_t default_parallel_degree() {
+  return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+// ==================== WorkerPool ====================
+
+WorkerPool::WorkerPool(size_t threads) {
+  threads = std::max<size_t>(threads, 1);
+  for (size_t i = 0; i < threads; ++i) {
+    threads_.emplace_back([this] { run(); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+WorkerPool &WorkerPool::shared() {
+  static WorkerPool pool(default_parallel_degree());
+  return pool;
+}
+
+void WorkerPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void WorkerPool::run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+// ==================== MorselQueue ====================
+
+MorselQueue::MorselQueue(size_t pages_per_morsel)
+    : pages_per_morsel_(std::max<size_t>(pages_per_morsel, 1)) {}
+
+void MorselQueue::reset(std::vector<int32_t> pages) {
+  pages_ = std::move(pages);
+  next_.store(0, std::memory_order_relaxed);
+}
+
+bool MorselQueue::next(size_t &begin, size_t &end) {
+  size_t morsel = next_.fetch_add(1, std::memory_order_relaxed);
+  if (morsel >= morsel_count()) {
+    return false;
+  }
+  begin = morsel * pages_per_morsel_;
+  end = std::min(begin + pages_per_morsel_, pages_.size());
+  return true;
+}
+
+// ==================== MorselScanOperator ====================
+
+MorselScanOperator::MorselScanOperator(const TableScanOperator &table_scan,
+                                       std::shared_ptr<MorselQueue> queue)
+    : table_scan_(table_scan), queue_(std::move(queue)) {
+  columns_ = table_scan_.output_columns();
+}
+
+void MorselScanOperator::open() {
+  PhysicalOperator::open();
+  position_ = 0;
+  end_ = 0;
+  page_rows_.clear();
+  row_position_ = 0;
+  morsels_scanned_ = 0;
+}
+
+bool MorselScanOperator::next(RowBatch &batch) {
+  batch.clear();
+  while (!batch.full()) {
+    if (row_position_ < page_rows_.size()) {
+      batch.add_row(std::move(page_rows_[row_position_++]));
+      continue;
+    }
+    if (position_ == end_) {
+      if (!queue_->next(position_, end_)) {
+        break;
+      }
+      ++morsels_scanned_;
+      continue;
+    }
+    page_rows_.clear();
+    row_position_ = 0;
+    table_scan_.scan_page(queue_->page(position_++), page_rows_);
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+std::string MorselScanOperator::describe() const {
+  return "MorselScan(" + table_scan_.table_name() + ")";
+}
+
+// ==================== ExchangeOperator ====================
+
+ExchangeOperator::ExchangeOperator(
+    std::unique_ptr<TableScanOperator> table_scan,
+    const PipelineFactory &pipeline, size_t dop, WorkerPool &pool)
+    : table_scan_(std::move(table_scan)),
+      queue_(std::make_shared<MorselQueue>(kPagesPerMorsel)), pool_(pool) {
+  if (!table_scan_) {
+    throw Exception("Exchange requires a table scan");
+  }
+  dop = std::max<size_t>(dop, 1);
+  for (size_t worker = 0; worker < dop; ++worker) {
+    OperatorPtr root = pipeline(
+        std::make_unique<MorselScanOperator>(*table_scan_, queue_));
+    pipelines_.push_back(root.get());
+    if (worker == 0) {
+      columns_ = root->output_columns();
+      children_.push_back(std::move(root));
+    } else {
+      extra_pipelines_.push_back(std::move(root));
+    }
+  }
+}
+
+ExchangeOperator::~ExchangeOperator() { stop_workers(); }
+
+void ExchangeOperator::open() {
+  stop_workers();
+  rows_produced_ = 0;
+  current_.clear();
+  position_ = 0;
+  buffer_.clear();
+  cancelled_ = false;
+  error_ = nullptr;
+  worker_buffers_ = BufferUsage();
+
+  // 调用线程只读取页目录，数据页由工作线程读取
+  queue_->reset(table_scan_->start_page_scan());
+
+  // 线程数不超过morsel数；没有morsel时仍启动一个，保证流水线正常open/close
+  workers_started_ =
+      std::min(pipelines_.size(), std::max<size_t>(queue_->morsel_count(), 1));
+  running_ = workers_started_;
+  for (size_t worker = 0; worker < workers_started_; ++worker) {
+    PhysicalOperator *pipeline = pipelines_[worker];
+    pool_.submit([this, pipeline] { run_worker(*pipeline); });
+  }
+}
+
+void ExchangeOperator::run_worker(PhysicalOperator &pipeline) {
+  size_t capacity = kBatchesPerWorker * pipelines_.size();
+  BufferUsage start = thread_buffer_usage();
+  try {
+    pipeline.open();
+    RowBatch batch;
+    while (pipeline.next(batch)) {
+      std::vector<Row> rows;
+      rows.swap(batch.rows());
+      std::unique_lock<std::mutex> lock(mutex_);
+      space_.wait(lock,
+                  [&] { return cancelled_ || buffer_.size() < capacity; });
+      if (cancelled_) {
+        break;
+      }
+      buffer_.push_back(std::move(rows));
+      ready_.notify_one();
+    }
+    pipeline.close();
+  } catch (...) {
+    try {
+      pipeline.close();
+    } catch (...) {
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!error_) {
+      error_ = std::current_exception();
+    }
+    cancelled_ = true;
+    space_.notify_all();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  worker_buffers_ += thread_buffer_usage() - start;
+  --running_;
+  ready_.notify_all();
+}
+
+bool ExchangeOperator::next(RowBatch &batch) {
+  batch.clear();
+  while (!batch.full()) {
+    if (position_ < current_.size()) {
+      batch.add_row(std::move(current_[position_++]));
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (buffer_.empty() && running_ > 0 && !batch.empty() && !error_) {
+      break; // 先返回已取到的行，不等待其余工作线程
+    }
+    ready_.wait(lock, [this] {
+      return !buffer_.empty() || running_ == 0 || error_;
+    });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    if (buffer_.empty()) {
+      break;
+    }
+    current_ = std::move(buffer_.front());
+    buffer_.pop_front();
+    position_ = 0;
+    space_.notify_one();
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+void ExchangeOperator::stop_workers() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cancelled_ = true;
+  space_.notify_all();
+  ready_.wait(lock, [this] { return running_ == 0; });
+}
+
+void ExchangeOperator::close() {
+  stop_workers();
+  buffer_.clear();
+  current_.clear();
+  current_.shrink_to_fit();
+}
+
+BufferUsage ExchangeOperator::worker_buffer_usage() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return worker_buffers_;
+}
+
+std::string ExchangeOperator::describe() const {
+  return "Gather(dop=" + std::to_string(pipelines_.size()) + ")";
+}
+
+} // namespace sqlcc
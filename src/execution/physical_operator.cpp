@@ -0,0 +1,2688 @@
+#include "execution/physical_operator.h"
+#include "execution/spill_file.h"
+#include "b_plus_tree.h"
+#include "exception.h"
+#include "page.h"
+#include "table_storage.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+
+namespace sqlcc {
+
+namespace {
+
+std::string to_upper(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(),
+                 [](unsigned char c) { return std::toupper(c); });
+  return text;
+}
+
+std::string trim(const std::string &text) {
+  size_t begin = text.find_first_not_of(" \t");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = text.find_last_not_of(" \t");
+  return text.substr(begin, end - begin + 1);
+}
+
+// 去掉字符串常量两侧的引号
+std::string unquote(const std::string &text) {
+  if (text.size() >= 2 && (text.front() == '\'' || text.front() == '"') &&
+      text.back() == text.front()) {
+    return text.substr(1, text.size() - 2);
+  }
+  return text;
+}
+
+bool parse_int(const std::string &text, int64_t &out) {
+  if (text.empty()) {
+    return false;
+  }
+  char *end = nullptr;
+  errno = 0;
+  long long value = std::strtoll(text.c_str(), &end, 10);
+  if (errno != 0 || end != text.c_str() + text.size()) {
+    return false;
+  }
+  out = static_cast<int64_t>(value);
+  return true;
+}
+
+bool parse_double(const std::string &text, double &out) {
+  if (text.empty()) {
+    return false;
+  }
+  char *end = nullptr;
+  double value = std::strtod(text.c_str(), &end);
+  if (end != text.c_str() + text.size()) {
+    return false;
+  }
+  out = value;
+  return true;
+}
+
+double numeric_value(const Value &value) {
+  return value.type == Value::Type::INT ? static_cast<double>(value.int_val)
+                                        : value.double_val;
+}
+
+Row null_row(size_t width) {
+  Row row;
+  row.values.resize(width);
+  return row;
+}
+
+// 转换为索引键（索引以记录中的字符串形式保存键）
+std::string index_key(const Value &value) {
+  switch (value.type) {
+  case Value::Type::INT:
+    return std::to_string(value.int_val);
+  case Value::Type::DOUBLE: {
+    std::ostringstream out;
+    out << value.double_val;
+    return out.str();
+  }
+  default:
+    return value.str_val;
+  }
+}
+
+// 去掉"table."前缀
+std::string strip_table(const std::string &name) {
+  size_t dot = name.find('.');
+  return dot == std::string::npos ? name : name.substr(dot + 1);
+}
+
+} // namespace
+
+// ==================== RowBatch ====================
+
+RowBatch::RowBatch(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {
+  rows_.reserve(capacity_);
+}
+
+void RowBatch::set_capacity(size_t capacity) {
+  capacity_ = std::max<size_t>(1, capacity);
+}
+
+// ==================== PhysicalOperator ====================
+
+void PhysicalOperator::open() {
+  rows_produced_ = 0;
+  for (auto &child : children_) {
+    child->open();
+  }
+}
+
+void PhysicalOperator::close() {
+  for (auto &child : children_) {
+    child->close();
+  }
+}
+
+std::string PhysicalOperator::explain() const {
+  std::string out;
+  explain(out, 0);
+  return out;
+}
+
+void PhysicalOperator::qualify_columns(const std::string &prefix) {
+  for (auto &column : columns_) {
+    if (column.name.find('.') == std::string::npos) {
+      column.name = prefix + "." + column.name;
+    }
+  }
+}
+
+void PhysicalOperator::wrap_children(
+    const std::function<OperatorPtr(OperatorPtr)> &wrap) {
+  for (auto &child : children_) {
+    child = wrap(std::move(child));
+  }
+}
+
+void PhysicalOperator::explain(std::string &out, int depth) const {
+  out.append(static_cast<size_t>(depth) * 2, ' ');
+  out += (depth > 0 ? "-> " : "") + describe() + "\n";
+  for (const auto &child : children_) {
+    child->explain(out, depth + 1);
+  }
+}
+
+// ==================== ValuesScanOperator ====================
+
+ValuesScanOperator::ValuesScanOperator(std::vector<ColumnMeta> columns,
+                                       std::vector<Row> rows)
+    : rows_(std::move(rows)) {
+  columns_ = std::move(columns);
+}
+
+ValuesScanOperator::ValuesScanOperator(ExecutionResult result)
+    : ValuesScanOperator(std::move(result.column_metadata),
+                         std::move(result.rows)) {}
+
+void ValuesScanOperator::open() {
+  PhysicalOperator::open();
+  position_ = 0;
+}
+
+bool ValuesScanOperator::next(RowBatch &batch) {
+  batch.clear();
+  while (!batch.full() && position_ < rows_.size()) {
+    batch.add_row(rows_[position_++]);
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+std::string ValuesScanOperator::describe() const {
+  return "ValuesScan(rows=" + std::to_string(rows_.size()) + ")";
+}
+
+// ==================== TableScanOperator ====================
+
+TableScanOperator::TableScanOperator(
+    std::shared_ptr<TableStorageManager> table_storage,
+    const std::string &table_name, std::shared_ptr<TableMetadata> metadata)
+    : table_storage_(std::move(table_storage)), table_name_(table_name),
+      metadata_(std::move(metadata)) {
+  if (!table_storage_ || !metadata_) {
+    throw Exception("Table storage not available: " + table_name);
+  }
+  for (const auto &column : metadata_->columns) {
+    columns_.push_back({column.name, column.type, column.nullable, false,
+                        false, column.default_value});
+  }
+}
+
+void TableScanOperator::open() {
+  PhysicalOperator::open();
+  pages_ = start_page_scan();
+  page_position_ = 0;
+  page_rows_.clear();
+  row_position_ = 0;
+}
+
+void TableScanOperator::set_zone_filter(const std::string &column,
+                                        const std::string &op,
+                                        const std::string &value) {
+  zone_column_ = resolve_column(columns_, column);
+  zone_op_ = op;
+  zone_value_ = value;
+}
+
+bool TableScanOperator::page_may_match(int32_t page_id) const {
+  return table_storage_->PageMayMatch(page_id, zone_column_,
+                                      columns_[zone_column_].data_type,
+                                      zone_op_, zone_value_);
+}
+
+void TableScanOperator::set_index_only(
+    const std::string &key_column,
+    const std::vector<std::string> &included_columns) {
+  std::vector<ColumnMeta> columns;
+  std::vector<int> sources;
+  for (const auto &column : columns_) {
+    if (column.name == key_column) {
+      sources.push_back(-1);
+    } else {
+      auto it = std::find(included_columns.begin(), included_columns.end(),
+                          column.name);
+      if (it == included_columns.end()) {
+        continue;
+      }
+      sources.push_back(static_cast<int>(it - included_columns.begin()));
+    }
+    columns.push_back(column);
+  }
+  if (std::find(sources.begin(), sources.end(), -1) == sources.end()) {
+    throw Exception("Index column not found: " + key_column);
+  }
+  columns_ = std::move(columns);
+  index_sources_ = std::move(sources);
+  index_only_ = true;
+}
+
+void TableScanOperator::add_index_entry(const IndexEntry &entry) {
+  locations_.emplace_back(entry.page_id, entry.offset);
+  if (!index_only_) {
+    return;
+  }
+  std::vector<std::string> record;
+  record.reserve(index_sources_.size());
+  for (int source : index_sources_) {
+    if (source < 0) {
+      // 数值列的键按保序编码存储，输出前还原为文本
+      record.push_back(
+          BPlusTreeIndex::DecodeKey(entry.key, columns_[record.size()].data_type));
+    } else if (static_cast<size_t>(source) < entry.included_values.size()) {
+      record.push_back(entry.included_values[source]);
+    } else {
+      throw Exception("Index entry does not cover column: " +
+                      columns_[record.size()].name);
+    }
+  }
+  index_records_.push_back(std::move(record));
+}
+
+bool TableScanOperator::next(RowBatch &batch) {
+  batch.clear();
+  // 当前页的行输出完才读取下一页，上层LIMIT满足后不再固定后续页面
+  while (!batch.full()) {
+    if (row_position_ < page_rows_.size()) {
+      batch.add_row(std::move(page_rows_[row_position_++]));
+      continue;
+    }
+    if (page_position_ >= pages_.size()) {
+      break;
+    }
+    page_rows_.clear();
+    row_position_ = 0;
+    scan_page(pages_[page_position_++], page_rows_);
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+bool TableScanOperator::fetch_rows(RowBatch &batch) {
+  batch.clear();
+  while (!batch.full() && position_ < locations_.size()) {
+    if (index_only_) {
+      // 索引条目已包含全部输出列，不读取数据页
+      const auto &record = index_records_[position_++];
+      Row row;
+      row.values.reserve(record.size());
+      for (size_t i = 0; i < record.size(); ++i) {
+        row.values.push_back(parse_value(record[i], columns_[i].data_type));
+      }
+      batch.add_row(std::move(row));
+      continue;
+    }
+    const auto &location = locations_[position_++];
+    Row row;
+    if (read_row(location.first, location.second, row)) {
+      batch.add_row(std::move(row));
+    }
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+bool TableScanOperator::read_row(int32_t page_id, size_t offset,
+                                 Row &row) const {
+  std::vector<std::string> record = read_record(page_id, offset);
+  if (record.empty()) {
+    return false;
+  }
+  convert_record(record, row);
+  return true;
+}
+
+std::vector<int32_t> TableScanOperator::start_page_scan() {
+  pages_skipped_ = 0;
+  return table_pages();
+}
+
+bool TableScanOperator::scan_page(int32_t page_id,
+                                  std::vector<Row> &rows) const {
+  if (!zone_op_.empty() && !page_may_match(page_id)) {
+    ++pages_skipped_;
+    return false;
+  }
+  for (const auto &record : read_page(page_id)) {
+    Row row;
+    convert_record(record, row);
+    rows.push_back(std::move(row));
+  }
+  return true;
+}
+
+void TableScanOperator::convert_record(const std::vector<std::string> &record,
+                                       Row &row) const {
+  row.values.clear();
+  row.values.reserve(record.size());
+  for (size_t i = 0; i < record.size(); ++i) {
+    row.values.push_back(parse_value(
+        record[i], i < columns_.size() ? columns_[i].data_type : ""));
+  }
+}
+
+std::vector<std::string> TableScanOperator::read_record(int32_t page_id,
+                                                        size_t offset) const {
+  return table_storage_->GetRecord(table_name_, page_id, offset);
+}
+
+std::vector<int32_t> TableScanOperator::table_pages() const {
+  return table_storage_->GetTablePages(table_name_);
+}
+
+std::vector<std::vector<std::string>>
+TableScanOperator::read_page(int32_t page_id) const {
+  return table_storage_->GetPageRecords(table_name_, page_id);
+}
+
+void TableScanOperator::close() {
+  pages_.clear();
+  page_rows_.clear();
+  page_rows_.shrink_to_fit();
+  locations_.clear();
+  locations_.shrink_to_fit();
+  index_records_.clear();
+  index_records_.shrink_to_fit();
+  PhysicalOperator::close();
+}
+
+std::string TableScanOperator::describe() const {
+  if (zone_op_.empty()) {
+    return "TableScan(" + table_name_ + ")";
+  }
+  return "TableScan(" + table_name_ + ", zone map: " +
+         columns_[zone_column_].name + " " + zone_op_ + " " + zone_value_ +
+         ", pages skipped=" + std::to_string(pages_skipped_.load()) + ")";
+}
+
+// ==================== IndexScanOperator ====================
+
+IndexScanOperator::IndexScanOperator(
+    std::shared_ptr<TableStorageManager> table_storage,
+    const std::string &table_name, std::shared_ptr<TableMetadata> metadata,
+    BPlusTreeIndex *index, const std::string &op, const std::string &value)
+    : TableScanOperator(std::move(table_storage), table_name,
+                        std::move(metadata)),
+      index_(index), op_(op), value_(value) {
+  if (!index_) {
+    throw Exception("Index not available for table: " + table_name);
+  }
+  std::string key_type;
+  for (const auto &column : metadata_->columns) {
+    if (column.name == index_->GetColumnName()) {
+      key_type = column.type;
+      break;
+    }
+  }
+  std::string key = BPlusTreeIndex::EncodeKey(value_, key_type);
+  if (op_ == "=") {
+    lower_bound_ = upper_bound_ = key;
+    return;
+  }
+  std::string min_key, max_key;
+  if (!BPlusTreeIndex::NumericKeyBounds(key_type, min_key, max_key)) {
+    throw Exception("Index range scan requires a numeric column: " +
+                    index_->GetColumnName());
+  }
+  if (op_ == ">" || op_ == ">=") {
+    lower_bound_ = key;
+    upper_bound_ = max_key;
+  } else if (op_ == "<" || op_ == "<=") {
+    lower_bound_ = min_key;
+    upper_bound_ = key;
+  } else {
+    throw Exception("Unsupported index scan operator: " + op_);
+  }
+}
+
+void IndexScanOperator::open() {
+  PhysicalOperator::open();
+  std::vector<IndexEntry> entries =
+      op_ == "="
+          ? index_->Search(lower_bound_)
+          : index_->SearchRange(lower_bound_, upper_bound_);
+  locations_.clear();
+  locations_.reserve(entries.size());
+  index_records_.clear();
+  for (const auto &entry : entries) {
+    // SearchRange是闭区间，开区间的端点在这里去掉，不再读取对应记录
+    if ((op_ == ">" && entry.key == lower_bound_) ||
+        (op_ == "<" && entry.key == upper_bound_)) {
+      continue;
+    }
+    add_index_entry(entry);
+  }
+  position_ = 0;
+}
+
+bool IndexScanOperator::next(RowBatch &batch) { return fetch_rows(batch); }
+
+std::string IndexScanOperator::describe() const {
+  return std::string(index_only_ ? "IndexOnlyScan(" : "IndexScan(") +
+         table_name_ + ", " + index_->GetColumnName() + " " + op_ + " " +
+         value_ + ")";
+}
+
+// ==================== IndexOrderScanOperator ====================
+
+namespace {
+
+constexpr size_t kMaxIndexChunk = 4096;
+
+} // namespace
+
+IndexOrderScanOperator::IndexOrderScanOperator(
+    std::shared_ptr<TableStorageManager> table_storage,
+    const std::string &table_name, std::shared_ptr<TableMetadata> metadata,
+    BPlusTreeIndex *index, const std::string &column)
+    : TableScanOperator(std::move(table_storage), table_name,
+                        std::move(metadata)),
+      index_(index), column_(column) {}
+
+void IndexOrderScanOperator::open() {
+  PhysicalOperator::open();
+  locations_.clear();
+  index_records_.clear();
+  position_ = 0;
+  last_key_.clear();
+  last_key_count_ = 0;
+  chunk_size_ = 0;
+  entries_read_ = 0;
+  exhausted_ = false;
+}
+
+std::vector<IndexEntry>
+IndexOrderScanOperator::scan_index(const std::string &lower_bound,
+                                   size_t max_entries) const {
+  if (!index_) {
+    throw Exception("Index not available for table: " + table_name_);
+  }
+  return index_->ScanFrom(lower_bound, max_entries);
+}
+
+void IndexOrderScanOperator::read_chunk(size_t batch_capacity) {
+  chunk_size_ = chunk_size_ == 0 ? std::max<size_t>(batch_capacity, 1)
+                                 : std::min(chunk_size_ * 2, kMaxIndexChunk);
+
+  // 从上次的最大键继续读取，跳过已经返回过的同键条目
+  size_t wanted = chunk_size_ + last_key_count_;
+  std::vector<IndexEntry> entries = scan_index(last_key_, wanted);
+  exhausted_ = entries.size() < wanted;
+
+  size_t skip = 0;
+  while (skip < entries.size() && skip < last_key_count_ &&
+         entries[skip].key == last_key_) {
+    ++skip;
+  }
+
+  locations_.clear();
+  index_records_.clear();
+  position_ = 0;
+  for (size_t i = skip; i < entries.size(); ++i) {
+    const IndexEntry &entry = entries[i];
+    if (entry.key == last_key_) {
+      ++last_key_count_;
+    } else {
+      last_key_ = entry.key;
+      last_key_count_ = 1;
+    }
+    add_index_entry(entry);
+  }
+  entries_read_ += locations_.size();
+  if (locations_.empty()) {
+    exhausted_ = true;
+  }
+}
+
+bool IndexOrderScanOperator::next(RowBatch &batch) {
+  while (true) {
+    if (position_ >= locations_.size()) {
+      if (exhausted_) {
+        batch.clear();
+        return false;
+      }
+      read_chunk(batch.capacity());
+    }
+    // 当前块的记录都已删除时继续读取下一块
+    if (fetch_rows(batch)) {
+      return true;
+    }
+  }
+}
+
+std::string IndexOrderScanOperator::describe() const {
+  return std::string(index_only_ ? "IndexOnlyOrderScan(" : "IndexOrderScan(") +
+         table_name_ + ", " + column_ + " ASC)";
+}
+
+// ==================== FilterOperator ====================
+
+FilterOperator::FilterOperator(OperatorPtr child, RowPredicate predicate,
+                               const std::string &description)
+    : predicate_(std::move(predicate)), description_(description) {
+  columns_ = child->output_columns();
+  children_.push_back(std::move(child));
+}
+
+FilterOperator::FilterOperator(OperatorPtr child, CompiledPredicate predicate,
+                               const std::string &description)
+    : compiled_(std::move(predicate)), vectorized_(true),
+      description_(description) {
+  columns_ = child->output_columns();
+  children_.push_back(std::move(child));
+}
+
+bool FilterOperator::next(RowBatch &batch) {
+  batch.clear();
+  // 输入批与输出批容量相同，因此只在输出为空时继续拉取
+  input_.set_capacity(batch.capacity());
+  while (batch.empty()) {
+    if (!children_[0]->next(input_)) {
+      break;
+    }
+    if (vectorized_) {
+      compiled_.select(input_.rows(), selection_);
+      for (uint32_t index : selection_) {
+        batch.add_row(std::move(input_[index]));
+      }
+      continue;
+    }
+    for (auto &row : input_.rows()) {
+      if (predicate_(row)) {
+        batch.add_row(std::move(row));
+      }
+    }
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+std::string FilterOperator::describe() const {
+  return "Filter(" + description_ + ")";
+}
+
+// ==================== ProjectOperator ====================
+
+ProjectOperator::ProjectOperator(OperatorPtr child,
+                                 const std::vector<std::string> &columns) {
+  const auto &input_columns = child->output_columns();
+  bool select_all =
+      columns.empty() || (columns.size() == 1 && trim(columns[0]) == "*");
+  if (select_all) {
+    for (size_t i = 0; i < input_columns.size(); ++i) {
+      indexes_.push_back(i);
+    }
+  } else {
+    for (const auto &column : columns) {
+      indexes_.push_back(resolve_column(input_columns, trim(column)));
+    }
+  }
+  for (size_t index : indexes_) {
+    columns_.push_back(input_columns[index]);
+  }
+  children_.push_back(std::move(child));
+}
+
+bool ProjectOperator::next(RowBatch &batch) {
+  if (!children_[0]->next(batch)) {
+    return false;
+  }
+  for (auto &row : batch.rows()) {
+    Row projected;
+    projected.values.reserve(indexes_.size());
+    for (size_t index : indexes_) {
+      projected.values.push_back(index < row.values.size() ? row.values[index]
+                                                           : Value());
+    }
+    row = std::move(projected);
+  }
+  rows_produced_ += batch.size();
+  return true;
+}
+
+std::string ProjectOperator::describe() const {
+  std::string names;
+  for (const auto &column : columns_) {
+    names += (names.empty() ? "" : ", ") + column.name;
+  }
+  return "Project(" + names + ")";
+}
+
+// ==================== JoinOperator ====================
+
+JoinOperator::JoinOperator(OperatorPtr left, OperatorPtr right,
+                           JoinType join_type,
+                           const std::string &join_condition)
+    : join_type_(join_type), join_condition_(join_condition) {
+  const auto &left_columns = left->output_columns();
+  const auto &right_columns = right->output_columns();
+  left_width_ = left_columns.size();
+  right_width_ = right_columns.size();
+  columns_ = left_columns;
+  columns_.insert(columns_.end(), right_columns.begin(), right_columns.end());
+
+  if (join_type_ != JoinType::CROSS_JOIN && !join_condition_.empty()) {
+    size_t eq_pos = join_condition_.find('=');
+    if (eq_pos == std::string::npos || eq_pos == 0 ||
+        std::string("<>!").find(join_condition_[eq_pos - 1]) !=
+            std::string::npos) {
+      throw Exception("Only equality join conditions are supported");
+    }
+    std::string left_name = trim(join_condition_.substr(0, eq_pos));
+    std::string right_name = trim(join_condition_.substr(eq_pos + 1));
+    try {
+      left_key_ = resolve_column(left_columns, left_name);
+      right_key_ = resolve_column(right_columns, right_name);
+    } catch (const Exception &) {
+      // 条件可能写成 "right.col = left.col"
+      left_key_ = resolve_column(left_columns, right_name);
+      right_key_ = resolve_column(right_columns, left_name);
+    }
+    has_keys_ = true;
+  } else if (join_type_ == JoinType::NATURAL_JOIN) {
+    // NATURAL JOIN使用第一个同名列作为连接键
+    for (size_t i = 0; i < left_columns.size() && !has_keys_; ++i) {
+      for (size_t j = 0; j < right_columns.size(); ++j) {
+        if (left_columns[i].name == right_columns[j].name) {
+          left_key_ = i;
+          right_key_ = j;
+          has_keys_ = true;
+          break;
+        }
+      }
+    }
+  }
+
+  children_.push_back(std::move(left));
+  children_.push_back(std::move(right));
+}
+
+void JoinOperator::open() {
+  PhysicalOperator::open();
+
+  // 物化内表，等值连接时在内表上建立哈希表
+  inner_rows_.clear();
+  RowBatch batch;
+  while (children_[1]->next(batch)) {
+    for (auto &row : batch.rows()) {
+      inner_rows_.push_back(std::move(row));
+    }
+  }
+  inner_matched_.assign(inner_rows_.size(), false);
+  if (has_keys_) {
+    hash_table_.build(inner_rows_, right_key_);
+  }
+
+  outer_.clear();
+  outer_position_ = 0;
+  inner_position_ = JoinHashTable::npos;
+  probe_started_ = false;
+  outer_matched_ = false;
+  outer_exhausted_ = false;
+  unmatched_position_ = 0;
+}
+
+size_t JoinOperator::first_candidate(const Row &outer_row) const {
+  if (!has_keys_) {
+    return inner_rows_.empty() ? JoinHashTable::npos : 0;
+  }
+  if (left_key_ >= outer_row.values.size()) {
+    return JoinHashTable::npos;
+  }
+  return hash_table_.find(outer_row.values[left_key_]);
+}
+
+size_t JoinOperator::next_candidate(size_t inner_index) const {
+  if (has_keys_) {
+    return hash_table_.next(inner_index);
+  }
+  return inner_index + 1 < inner_rows_.size() ? inner_index + 1
+                                              : JoinHashTable::npos;
+}
+
+bool JoinOperator::next(RowBatch &batch) {
+  batch.clear();
+  bool left_outer = join_type_ == JoinType::LEFT_JOIN ||
+                    join_type_ == JoinType::FULL_JOIN;
+  bool right_outer = join_type_ == JoinType::RIGHT_JOIN ||
+                     join_type_ == JoinType::FULL_JOIN;
+
+  while (!batch.full()) {
+    if (outer_position_ >= outer_.size()) {
+      if (outer_exhausted_) {
+        break;
+      }
+      if (!children_[0]->next(outer_)) {
+        outer_exhausted_ = true;
+        break;
+      }
+      outer_position_ = 0;
+      probe_started_ = false;
+      continue;
+    }
+
+    // 输出批写满时保存探测位置，下次调用从中断处继续
+    const Row &left_row = outer_[outer_position_];
+    if (!probe_started_) {
+      inner_position_ = first_candidate(left_row);
+      outer_matched_ = false;
+      probe_started_ = true;
+    }
+    while (inner_position_ != JoinHashTable::npos && !batch.full()) {
+      size_t i = inner_position_;
+      inner_position_ = next_candidate(i);
+      batch.add_row(merge(left_row, inner_rows_[i]));
+      inner_matched_[i] = true;
+      outer_matched_ = true;
+    }
+    if (inner_position_ != JoinHashTable::npos) {
+      break;
+    }
+    if (left_outer && !outer_matched_) {
+      if (batch.full()) {
+        break;
+      }
+      batch.add_row(merge(left_row, null_row(right_width_)));
+    }
+    ++outer_position_;
+    probe_started_ = false;
+  }
+
+  // 外表耗尽后输出内表中未匹配的行
+  if (outer_exhausted_ && right_outer) {
+    while (unmatched_position_ < inner_rows_.size() && !batch.full()) {
+      size_t i = unmatched_position_++;
+      if (!inner_matched_[i]) {
+        batch.add_row(merge(null_row(left_width_), inner_rows_[i]));
+      }
+    }
+  }
+
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+void JoinOperator::close() {
+  hash_table_.clear();
+  inner_rows_.clear();
+  inner_rows_.shrink_to_fit();
+  inner_matched_.clear();
+  outer_.clear();
+  PhysicalOperator::close();
+}
+
+Row JoinOperator::merge(const Row &left_row, const Row &right_row) const {
+  Row merged;
+  merged.values.reserve(left_width_ + right_width_);
+  merged.values.insert(merged.values.end(), left_row.values.begin(),
+                       left_row.values.end());
+  merged.values.resize(left_width_);
+  merged.values.insert(merged.values.end(), right_row.values.begin(),
+                       right_row.values.end());
+  merged.values.resize(left_width_ + right_width_);
+  return merged;
+}
+
+std::string JoinOperator::describe() const {
+  static const char *names[] = {"Inner", "Left", "Right",
+                                "Full",  "Cross", "Natural"};
+  std::string out = std::string(has_keys_ ? "HashJoin(" : "NestedLoopJoin(") +
+                    names[static_cast<int>(join_type_)];
+  if (!join_condition_.empty()) {
+    out += ", " + join_condition_;
+  }
+  return out + ")";
+}
+
+// ==================== IndexNestedLoopJoinOperator ====================
+
+IndexNestedLoopJoinOperator::IndexNestedLoopJoinOperator(
+    OperatorPtr outer, std::shared_ptr<TableStorageManager> table_storage,
+    const std::string &table_name, std::shared_ptr<TableMetadata> metadata,
+    BPlusTreeIndex *index, const std::string &outer_key, JoinType join_type)
+    : table_storage_(std::move(table_storage)), table_name_(table_name),
+      metadata_(std::move(metadata)), index_(index),
+      outer_key_name_(outer_key), join_type_(join_type) {
+  if (!metadata_) {
+    throw Exception("Table metadata not available: " + table_name);
+  }
+  if (join_type_ != JoinType::INNER_JOIN &&
+      join_type_ != JoinType::LEFT_JOIN) {
+    throw Exception("Index nested loop join supports only INNER and LEFT JOIN");
+  }
+  outer_key_ = resolve_column(outer->output_columns(), outer_key_name_);
+  columns_ = outer->output_columns();
+  outer_width_ = columns_.size();
+  for (const auto &column : metadata_->columns) {
+    columns_.push_back({column.name, column.type, column.nullable, false,
+                        false, column.default_value});
+  }
+  inner_width_ = columns_.size() - outer_width_;
+  children_.push_back(std::move(outer));
+}
+
+void IndexNestedLoopJoinOperator::open() {
+  PhysicalOperator::open();
+  pending_.clear();
+  pending_position_ = 0;
+  outer_exhausted_ = false;
+  index_lookups_ = 0;
+  pages_touched_ = 0;
+}
+
+std::vector<IndexEntry>
+IndexNestedLoopJoinOperator::lookup(const std::string &key) const {
+  if (!index_) {
+    throw Exception("Index not available for table: " + table_name_);
+  }
+  for (const auto &column : metadata_->columns) {
+    if (column.name == index_->GetColumnName()) {
+      return index_->Search(BPlusTreeIndex::EncodeKey(key, column.type));
+    }
+  }
+  return index_->Search(key);
+}
+
+std::vector<std::string>
+IndexNestedLoopJoinOperator::fetch(int32_t page_id, size_t offset) const {
+  if (!table_storage_) {
+    throw Exception("Table storage not available: " + table_name_);
+  }
+  return table_storage_->GetRecord(table_name_, page_id, offset);
+}
+
+void IndexNestedLoopJoinOperator::probe_batch() {
+  pending_.clear();
+  pending_position_ = 0;
+
+  // 收集本批去重后的键，每个键只查找一次索引
+  std::map<std::string, std::vector<size_t>> key_rows; // 键 -> 匹配的内表行
+  for (const auto &row : outer_.rows()) {
+    key_rows.emplace(index_key(row.values[outer_key_]),
+                     std::vector<size_t>());
+  }
+
+  std::vector<std::pair<std::pair<int32_t, size_t>, std::string>> locations;
+  for (const auto &entry : key_rows) {
+    index_lookups_++;
+    for (const auto &index_entry : lookup(entry.first)) {
+      locations.push_back({{index_entry.page_id, index_entry.offset},
+                           entry.first});
+    }
+  }
+
+  // 按页顺序读取记录，连续访问同一页时只计一次
+  std::sort(locations.begin(), locations.end());
+  std::vector<Row> inner_rows;
+  int32_t previous_page = -1;
+  for (const auto &location : locations) {
+    if (location.first.first != previous_page) {
+      previous_page = location.first.first;
+      pages_touched_++;
+    }
+    std::vector<std::string> record =
+        fetch(location.first.first, location.first.second);
+    if (record.empty()) {
+      continue;
+    }
+    Row row;
+    row.values.reserve(inner_width_);
+    for (size_t i = 0; i < record.size() && i < inner_width_; ++i) {
+      row.values.push_back(
+          parse_value(record[i], columns_[outer_width_ + i].data_type));
+    }
+    row.values.resize(inner_width_);
+    inner_rows.push_back(std::move(row));
+    key_rows[location.second].push_back(inner_rows.size() - 1);
+  }
+
+  // 按外表顺序输出
+  for (const auto &outer_row : outer_.rows()) {
+    const auto &matches = key_rows[index_key(outer_row.values[outer_key_])];
+    for (size_t match : matches) {
+      Row merged = outer_row;
+      merged.values.insert(merged.values.end(),
+                           inner_rows[match].values.begin(),
+                           inner_rows[match].values.end());
+      pending_.push_back(std::move(merged));
+    }
+    if (matches.empty() && join_type_ == JoinType::LEFT_JOIN) {
+      Row merged = outer_row;
+      merged.values.resize(outer_width_ + inner_width_);
+      pending_.push_back(std::move(merged));
+    }
+  }
+}
+
+bool IndexNestedLoopJoinOperator::next(RowBatch &batch) {
+  batch.clear();
+  outer_.set_capacity(batch.capacity());
+  while (!batch.full()) {
+    if (pending_position_ < pending_.size()) {
+      batch.add_row(std::move(pending_[pending_position_++]));
+      continue;
+    }
+    if (outer_exhausted_ || !children_[0]->next(outer_)) {
+      outer_exhausted_ = true;
+      break;
+    }
+    probe_batch();
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+void IndexNestedLoopJoinOperator::close() {
+  pending_.clear();
+  pending_.shrink_to_fit();
+  PhysicalOperator::close();
+}
+
+std::string IndexNestedLoopJoinOperator::describe() const {
+  std::string column = index_ ? index_->GetColumnName() : "?";
+  return std::string("IndexNestedLoopJoin(") +
+         (join_type_ == JoinType::LEFT_JOIN ? "Left" : "Inner") + ", " +
+         outer_key_name_ + " = " + table_name_ + "." + column + ")";
+}
+
+// ==================== SemiJoinOperator ====================
+
+SemiJoinOperator::SemiJoinOperator(OperatorPtr outer, OperatorPtr inner,
+                                   const std::string &outer_key,
+                                   const std::string &inner_key, bool anti)
+    : outer_key_name_(outer_key), inner_key_name_(inner_key), anti_(anti) {
+  columns_ = outer->output_columns();
+  outer_key_ = resolve_column(columns_, outer_key);
+  inner_key_ = resolve_column(inner->output_columns(), inner_key);
+  children_.push_back(std::move(outer));
+  children_.push_back(std::move(inner));
+}
+
+void SemiJoinOperator::open() {
+  PhysicalOperator::open();
+
+  inner_rows_.clear();
+  RowBatch batch;
+  while (children_[1]->next(batch)) {
+    for (auto &row : batch.rows()) {
+      inner_rows_.push_back(std::move(row));
+    }
+  }
+  hash_table_.build(inner_rows_, inner_key_);
+  outer_.clear();
+}
+
+bool SemiJoinOperator::next(RowBatch &batch) {
+  batch.clear();
+  outer_.set_capacity(batch.capacity());
+  while (batch.empty()) {
+    if (!children_[0]->next(outer_)) {
+      break;
+    }
+    for (auto &row : outer_.rows()) {
+      bool matched = outer_key_ < row.values.size() &&
+                     hash_table_.find(row.values[outer_key_]) !=
+                         JoinHashTable::npos;
+      if (matched != anti_) {
+        batch.add_row(std::move(row));
+      }
+    }
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+void SemiJoinOperator::close() {
+  hash_table_.clear();
+  inner_rows_.clear();
+  inner_rows_.shrink_to_fit();
+  outer_.clear();
+  PhysicalOperator::close();
+}
+
+std::string SemiJoinOperator::describe() const {
+  return std::string(anti_ ? "AntiJoin(" : "SemiJoin(") + outer_key_name_ +
+         " = " + inner_key_name_ + ")";
+}
+
+// ==================== AggregateOperator ====================
+
+namespace {
+
+const char *aggregate_name(AggregateSpec::Function function) {
+  switch (function) {
+  case AggregateSpec::COUNT:
+    return "COUNT";
+  case AggregateSpec::SUM:
+    return "SUM";
+  case AggregateSpec::AVG:
+    return "AVG";
+  case AggregateSpec::MIN:
+    return "MIN";
+  case AggregateSpec::MAX:
+    return "MAX";
+  }
+  return "";
+}
+
+constexpr size_t kNoColumn = std::numeric_limits<size_t>::max();
+constexpr size_t kEmptySlot = std::numeric_limits<size_t>::max();
+
+// 按行中的分组列计算哈希，不复制键值
+size_t group_hash(const Row &row, const std::vector<size_t> &columns) {
+  size_t seed = 0;
+  for (size_t index : columns) {
+    size_t hash = index < row.values.size() ? hash_value(row.values[index]) : 0;
+    seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+int compare_keys(const std::vector<Value> &left, const std::vector<Value> &right,
+                 size_t width) {
+  for (size_t i = 0; i < width; ++i) {
+    int cmp = compare_values(left[i], right[i]);
+    if (cmp != 0) {
+      return cmp;
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+// 一个按分组键有序的溢出段，head为当前未消费的行
+struct AggregateOperator::SpillRun {
+  SpillFile file;
+  RowReader reader;
+  const Row *head = nullptr;
+};
+
+AggregateOperator::AggregateOperator(OperatorPtr child,
+                                     const std::vector<std::string> &group_by,
+                                     const std::vector<AggregateSpec> &aggregates,
+                                     AggregatePhase phase)
+    : group_by_names_(group_by), aggregates_(aggregates), phase_(phase),
+      memory_limit_(kDefaultOperatorMemoryLimit) {
+  const auto &input_columns = child->output_columns();
+  for (const auto &name : group_by_names_) {
+    group_by_.push_back(resolve_column(input_columns, name));
+    columns_.push_back(input_columns[group_by_.back()]);
+  }
+  for (auto &aggregate : aggregates_) {
+    if (aggregate.column == "*") {
+      aggregate.column.clear();
+    }
+    if (aggregate.alias.empty()) {
+      aggregate.alias = std::string(aggregate_name(aggregate.function)) + "(" +
+                        (aggregate.column.empty() ? "*" : aggregate.column) +
+                        ")";
+    }
+    std::string data_type;
+    if (phase_ == AggregatePhase::FINAL) {
+      // 输入是部分状态，聚合输入列的类型记录在alias#string列上
+      size_t base = resolve_column(input_columns, aggregate.alias + "#count");
+      if (base + 3 >= input_columns.size()) {
+        throw Exception("Partial aggregate state incomplete: " +
+                        aggregate.alias);
+      }
+      state_columns_.push_back(base);
+      aggregate_columns_.push_back(kNoColumn);
+      data_type = input_columns[base + 3].data_type;
+    } else if (aggregate.column.empty()) {
+      aggregate_columns_.push_back(kNoColumn);
+    } else {
+      aggregate_columns_.push_back(
+          resolve_column(input_columns, aggregate.column));
+      data_type = input_columns[aggregate_columns_.back()].data_type;
+    }
+    // 按列类型选择累加器；类型未知时由第一个值决定
+    ValueKind kind = ValueKind::UNRESOLVED;
+    if (!data_type.empty()) {
+      switch (parse_value("0", data_type).type) {
+      case Value::Type::INT:
+        kind = ValueKind::INT;
+        break;
+      case Value::Type::DOUBLE:
+        kind = ValueKind::DOUBLE;
+        break;
+      case Value::Type::STRING:
+        kind = ValueKind::STRING;
+        break;
+      }
+    }
+    kinds_.push_back(kind);
+    if (phase_ == AggregatePhase::PARTIAL) {
+      columns_.push_back(
+          {aggregate.alias + "#count", "BIGINT", true, false, false, ""});
+      columns_.push_back(
+          {aggregate.alias + "#int", "BIGINT", true, false, false, ""});
+      columns_.push_back(
+          {aggregate.alias + "#double", "DOUBLE", true, false, false, ""});
+      columns_.push_back(
+          {aggregate.alias + "#string", data_type, true, false, false, ""});
+      continue;
+    }
+    if (aggregate.function == AggregateSpec::COUNT) {
+      data_type = "BIGINT";
+    } else if (aggregate.function == AggregateSpec::AVG) {
+      data_type = "DOUBLE";
+    }
+    columns_.push_back({aggregate.alias, data_type, true, false, false, ""});
+  }
+  children_.push_back(std::move(child));
+}
+
+AggregateOperator::~AggregateOperator() = default;
+
+void AggregateOperator::set_having(const std::string &column,
+                                   const std::string &op,
+                                   const std::string &literal) {
+  if (phase_ == AggregatePhase::PARTIAL) {
+    throw Exception("HAVING is not allowed on a partial aggregate");
+  }
+  having_ = make_comparison_predicate(columns_, column, op, literal);
+  having_description_ = column + " " + op + " " + literal;
+}
+
+void AggregateOperator::set_memory_limit(size_t limit_bytes) {
+  memory_limit_ = std::max<size_t>(limit_bytes, 1);
+}
+
+void AggregateOperator::open() {
+  PhysicalOperator::open();
+  clear_groups();
+  runs_.clear();
+  merge_heap_.clear();
+  results_.clear();
+  consumed_ = false;
+  position_ = 0;
+  group_count_ = 0;
+  spilled_runs_ = 0;
+}
+
+void AggregateOperator::clear_groups() {
+  group_keys_.clear();
+  group_hashes_.clear();
+  states_.clear();
+  slots_.assign(64, kEmptySlot);
+  memory_used_ = 0;
+}
+
+void AggregateOperator::grow_slots() {
+  slots_.assign(slots_.size() * 2, kEmptySlot);
+  size_t mask = slots_.size() - 1;
+  for (size_t group = 0; group < group_hashes_.size(); ++group) {
+    size_t slot = group_hashes_[group] & mask;
+    while (slots_[slot] != kEmptySlot) {
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot] = group;
+  }
+}
+
+size_t AggregateOperator::find_or_add_group(const Row &row, size_t hash) {
+  size_t mask = slots_.size() - 1;
+  size_t slot = hash & mask;
+  while (slots_[slot] != kEmptySlot) {
+    size_t group = slots_[slot];
+    if (group_hashes_[group] == hash) {
+      const auto &key = group_keys_[group];
+      bool equal = true;
+      for (size_t i = 0; i < group_by_.size() && equal; ++i) {
+        size_t index = group_by_[i];
+        equal = index < row.values.size()
+                    ? compare_values(key[i], row.values[index]) == 0
+                    : compare_values(key[i], Value()) == 0;
+      }
+      if (equal) {
+        return group;
+      }
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  // 新分组：复制键值并分配状态
+  size_t group = group_keys_.size();
+  std::vector<Value> key;
+  key.reserve(group_by_.size());
+  for (size_t index : group_by_) {
+    key.push_back(index < row.values.size() ? row.values[index] : Value());
+  }
+  Row key_row;
+  key_row.values = key;
+  memory_used_ += estimate_row_size(key_row) + sizeof(size_t) * 3 +
+                  aggregates_.size() * sizeof(AggregateState);
+  group_keys_.push_back(std::move(key));
+  group_hashes_.push_back(hash);
+  states_.resize(states_.size() + aggregates_.size());
+  slots_[slot] = group;
+  if (group_keys_.size() * 2 > slots_.size()) {
+    grow_slots();
+  }
+  return group;
+}
+
+void AggregateOperator::update_state(AggregateState &state, size_t aggregate,
+                                     const Row &row) {
+  size_t column = aggregate_columns_[aggregate];
+  if (column == kNoColumn) {
+    ++state.count;
+    return;
+  }
+  if (column >= row.values.size()) {
+    return;
+  }
+  const Value &value = row.values[column];
+  AggregateSpec::Function function = aggregates_[aggregate].function;
+  if (function == AggregateSpec::COUNT) {
+    ++state.count;
+    return;
+  }
+
+  ValueKind &kind = kinds_[aggregate];
+  if (kind == ValueKind::UNRESOLVED) {
+    kind = value.type == Value::Type::INT      ? ValueKind::INT
+           : value.type == Value::Type::DOUBLE ? ValueKind::DOUBLE
+                                               : ValueKind::STRING;
+  }
+
+  switch (kind) {
+  case ValueKind::INT: {
+    if (value.type == Value::Type::STRING) {
+      return; // 无法转换的值不参与数值聚合
+    }
+    int64_t v = value.type == Value::Type::INT
+                    ? value.int_val
+                    : static_cast<int64_t>(value.double_val);
+    if (function == AggregateSpec::SUM || function == AggregateSpec::AVG) {
+      state.int_value += v;
+    } else if (state.count == 0 ||
+               (function == AggregateSpec::MIN ? v < state.int_value
+                                               : v > state.int_value)) {
+      state.int_value = v;
+    }
+    break;
+  }
+  case ValueKind::DOUBLE: {
+    if (value.type == Value::Type::STRING) {
+      return;
+    }
+    double v = numeric_value(value);
+    if (function == AggregateSpec::SUM || function == AggregateSpec::AVG) {
+      state.double_value += v;
+    } else if (state.count == 0 ||
+               (function == AggregateSpec::MIN ? v < state.double_value
+                                               : v > state.double_value)) {
+      state.double_value = v;
+    }
+    break;
+  }
+  default: {
+    // 字符串只支持MIN/MAX
+    if (function == AggregateSpec::SUM || function == AggregateSpec::AVG) {
+      return;
+    }
+    const std::string &v = value.type == Value::Type::STRING
+                               ? value.str_val
+                               : index_key(value);
+    if (state.count == 0 ||
+        (function == AggregateSpec::MIN ? v < state.string_value
+                                        : v > state.string_value)) {
+      state.string_value = v;
+    }
+    break;
+  }
+  }
+  ++state.count;
+}
+
+void AggregateOperator::merge_state(AggregateState &target,
+                                    const AggregateState &source,
+                                    size_t aggregate) const {
+  if (source.count == 0) {
+    return;
+  }
+  AggregateSpec::Function function = aggregates_[aggregate].function;
+  if (function == AggregateSpec::SUM || function == AggregateSpec::AVG) {
+    target.int_value += source.int_value;
+    target.double_value += source.double_value;
+  } else if (function != AggregateSpec::COUNT) {
+    bool take_min = function == AggregateSpec::MIN;
+    bool first = target.count == 0;
+    switch (kinds_[aggregate]) {
+    case ValueKind::INT:
+      if (first || (take_min ? source.int_value < target.int_value
+                             : source.int_value > target.int_value)) {
+        target.int_value = source.int_value;
+      }
+      break;
+    case ValueKind::DOUBLE:
+      if (first || (take_min ? source.double_value < target.double_value
+                             : source.double_value > target.double_value)) {
+        target.double_value = source.double_value;
+      }
+      break;
+    default:
+      if (first || (take_min ? source.string_value < target.string_value
+                             : source.string_value > target.string_value)) {
+        target.string_value = source.string_value;
+      }
+      break;
+    }
+  }
+  target.count += source.count;
+}
+
+Value AggregateOperator::finalize_state(const AggregateState &state,
+                                        size_t aggregate) const {
+  AggregateSpec::Function function = aggregates_[aggregate].function;
+  ValueKind kind = kinds_[aggregate];
+  switch (function) {
+  case AggregateSpec::COUNT:
+    return Value(state.count);
+  case AggregateSpec::SUM:
+    return kind == ValueKind::DOUBLE ? Value(state.double_value)
+                                     : Value(state.int_value);
+  case AggregateSpec::AVG:
+    if (state.count == 0 || kind == ValueKind::STRING) {
+      return Value();
+    }
+    return Value((kind == ValueKind::INT
+                      ? static_cast<double>(state.int_value)
+                      : state.double_value) /
+                 static_cast<double>(state.count));
+  default:
+    if (state.count == 0) {
+      return Value();
+    }
+    switch (kind) {
+    case ValueKind::INT:
+      return Value(state.int_value);
+    case ValueKind::DOUBLE:
+      return Value(state.double_value);
+    default:
+      return Value(state.string_value);
+    }
+  }
+}
+
+AggregateOperator::AggregateState
+AggregateOperator::read_state(const Row &row, size_t base) {
+  AggregateState state;
+  state.count = row.values[base].int_val;
+  state.int_value = row.values[base + 1].int_val;
+  state.double_value = row.values[base + 2].double_val;
+  state.string_value = row.values[base + 3].str_val;
+  return state;
+}
+
+void AggregateOperator::append_state(const AggregateState &state,
+                                     std::vector<Value> &values) {
+  values.emplace_back(state.count);
+  values.emplace_back(state.int_value);
+  values.emplace_back(state.double_value);
+  values.emplace_back(state.string_value);
+}
+
+bool AggregateOperator::emit_group(std::vector<Value> key,
+                                   const AggregateState *states,
+                                   Row &out) const {
+  out.values = std::move(key);
+  if (phase_ == AggregatePhase::PARTIAL) {
+    out.values.reserve(group_by_.size() + aggregates_.size() * 4);
+    for (size_t a = 0; a < aggregates_.size(); ++a) {
+      append_state(states[a], out.values);
+    }
+    return true;
+  }
+  out.values.reserve(group_by_.size() + aggregates_.size());
+  for (size_t a = 0; a < aggregates_.size(); ++a) {
+    out.values.push_back(finalize_state(states[a], a));
+  }
+  return !having_ || having_(out);
+}
+
+void AggregateOperator::spill_groups() {
+  // 按分组键排序后写出部分聚合状态：键值之后每个聚合占4列
+  std::vector<size_t> order(group_keys_.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  size_t width = group_by_.size();
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return compare_keys(group_keys_[a], group_keys_[b], width) < 0;
+  });
+
+  auto run = std::make_unique<SpillRun>();
+  Row row;
+  for (size_t group : order) {
+    row.values = group_keys_[group];
+    for (size_t a = 0; a < aggregates_.size(); ++a) {
+      append_state(states_[group * aggregates_.size() + a], row.values);
+    }
+    run->file.append(row);
+  }
+  runs_.push_back(std::move(run));
+  spilled_runs_++;
+  clear_groups();
+}
+
+void AggregateOperator::consume() {
+  clear_groups();
+  size_t aggregate_count = aggregates_.size();
+
+  RowBatch batch;
+  while (children_[0]->next(batch)) {
+    for (const auto &row : batch.rows()) {
+      size_t group = find_or_add_group(row, group_hash(row, group_by_));
+      AggregateState *states = &states_[group * aggregate_count];
+      if (phase_ == AggregatePhase::FINAL) {
+        for (size_t a = 0; a < aggregate_count; ++a) {
+          merge_state(states[a], read_state(row, state_columns_[a]), a);
+        }
+      } else {
+        for (size_t a = 0; a < aggregate_count; ++a) {
+          update_state(states[a], a, row);
+        }
+      }
+      // 分组表超出内存限制，写出有序段
+      if (memory_used_ > memory_limit_ && !group_by_.empty()) {
+        spill_groups();
+      }
+    }
+  }
+
+  if (!runs_.empty()) {
+    if (!group_keys_.empty()) {
+      spill_groups();
+    }
+    // 建立按段首分组键排序的最小堆
+    for (size_t i = 0; i < runs_.size(); ++i) {
+      runs_[i]->reader = runs_[i]->file.reader();
+      runs_[i]->head = runs_[i]->reader();
+      if (runs_[i]->head) {
+        merge_heap_.push_back(i);
+      }
+    }
+    auto greater = [this](size_t a, size_t b) {
+      return compare_keys(runs_[a]->head->values, runs_[b]->head->values,
+                          group_by_.size()) > 0;
+    };
+    std::make_heap(merge_heap_.begin(), merge_heap_.end(), greater);
+    consumed_ = true;
+    return;
+  }
+
+  // 没有GROUP BY时即使输入为空也输出一行
+  if (group_keys_.empty() && group_by_.empty()) {
+    group_keys_.emplace_back();
+    states_.resize(aggregate_count);
+  }
+
+  group_count_ = group_keys_.size();
+  results_.reserve(group_keys_.size());
+  for (size_t g = 0; g < group_keys_.size(); ++g) {
+    Row row;
+    if (emit_group(std::move(group_keys_[g]), &states_[g * aggregate_count],
+                   row)) {
+      results_.push_back(std::move(row));
+    }
+  }
+  clear_groups();
+  consumed_ = true;
+}
+
+bool AggregateOperator::next_merged(Row &out) {
+  auto greater = [this](size_t a, size_t b) {
+    return compare_keys(runs_[a]->head->values, runs_[b]->head->values,
+                        group_by_.size()) > 0;
+  };
+  size_t width = group_by_.size();
+  size_t aggregate_count = aggregates_.size();
+  std::vector<AggregateState> states(aggregate_count);
+
+  while (!merge_heap_.empty()) {
+    std::pop_heap(merge_heap_.begin(), merge_heap_.end(), greater);
+    size_t first = merge_heap_.back();
+    merge_heap_.pop_back();
+
+    std::vector<Value> key(runs_[first]->head->values.begin(),
+                           runs_[first]->head->values.begin() + width);
+    for (auto &state : states) {
+      state = AggregateState();
+    }
+
+    // 合并所有段中与该分组键相同的行（每段内分组键唯一）
+    size_t run = first;
+    while (true) {
+      const Row &head = *runs_[run]->head;
+      for (size_t a = 0; a < aggregate_count; ++a) {
+        merge_state(states[a], read_state(head, width + a * 4), a);
+      }
+      runs_[run]->head = runs_[run]->reader();
+      if (runs_[run]->head) {
+        merge_heap_.push_back(run);
+        std::push_heap(merge_heap_.begin(), merge_heap_.end(), greater);
+      }
+      if (merge_heap_.empty() ||
+          compare_keys(runs_[merge_heap_.front()]->head->values, key, width) !=
+              0) {
+        break;
+      }
+      std::pop_heap(merge_heap_.begin(), merge_heap_.end(), greater);
+      run = merge_heap_.back();
+      merge_heap_.pop_back();
+    }
+
+    group_count_++;
+    if (emit_group(std::move(key), states.data(), out)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AggregateOperator::next(RowBatch &batch) {
+  if (!consumed_) {
+    consume();
+  }
+  batch.clear();
+  if (!runs_.empty()) {
+    Row row;
+    while (!batch.full() && next_merged(row)) {
+      batch.add_row(std::move(row));
+    }
+  } else {
+    while (!batch.full() && position_ < results_.size()) {
+      batch.add_row(std::move(results_[position_++]));
+    }
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+void AggregateOperator::close() {
+  results_.clear();
+  results_.shrink_to_fit();
+  clear_groups();
+  runs_.clear();
+  merge_heap_.clear();
+  PhysicalOperator::close();
+}
+
+std::string AggregateOperator::describe() const {
+  std::string out = phase_ == AggregatePhase::PARTIAL ? "PartialAggregate("
+                    : phase_ == AggregatePhase::FINAL ? "FinalAggregate("
+                                                      : "Aggregate(";
+  if (!group_by_names_.empty()) {
+    out += "group by ";
+    for (size_t i = 0; i < group_by_names_.size(); ++i) {
+      out += (i > 0 ? ", " : "") + group_by_names_[i];
+    }
+    out += "; ";
+  }
+  for (size_t i = 0; i < aggregates_.size(); ++i) {
+    out += (i > 0 ? ", " : "") + aggregates_[i].alias;
+  }
+  if (having_) {
+    out += "; having " + having_description_;
+  }
+  return out + ")";
+}
+
+// ==================== SortOperator ====================
+
+namespace {
+
+// 溢出段每页需要读写两个页缓冲，归并路数按此从工作内存中折算
+constexpr size_t kSortRunBufferBytes = 2 * PAGE_SIZE;
+constexpr size_t kMaxSortFanIn = 256;
+
+// 败者树：tree[0]为胜者，其余节点保存该子树比赛的败者，叶子数为tree.size()
+// beats(a, b)：来源a的当前行是否应排在来源b之前
+template <typename Beats>
+void build_loser_tree(std::vector<size_t> &tree, size_t count, Beats beats) {
+  tree.assign(std::max<size_t>(count, 1), 0);
+  std::vector<size_t> winners(2 * count);
+  for (size_t i = 0; i < count; ++i) {
+    winners[count + i] = i;
+  }
+  for (size_t node = count - 1; node > 0 && count > 1; --node) {
+    size_t left = winners[2 * node];
+    size_t right = winners[2 * node + 1];
+    bool left_wins = beats(left, right);
+    winners[node] = left_wins ? left : right;
+    tree[node] = left_wins ? right : left;
+  }
+  tree[0] = count > 1 ? winners[1] : 0;
+}
+
+// 胜者前进一行后沿叶到根重新比赛
+template <typename Beats>
+void replay_loser_tree(std::vector<size_t> &tree, Beats beats) {
+  size_t winner = tree[0];
+  for (size_t node = (winner + tree.size()) / 2; node > 0; node /= 2) {
+    if (beats(tree[node], winner)) {
+      std::swap(tree[node], winner);
+    }
+  }
+  tree[0] = winner;
+}
+
+// 耗尽的段排在最后；同键时编号小的段（输入中更早的行）优先，保持稳定
+template <typename Runs>
+bool run_precedes(const Runs &runs, size_t a, size_t b) {
+  if (!runs[a]->head || !runs[b]->head) {
+    return runs[a]->head != nullptr;
+  }
+  int cmp = runs[a]->key().compare(runs[b]->key());
+  return cmp < 0 || (cmp == 0 && a < b);
+}
+
+// 按大端序追加，保证字节比较与数值比较一致
+void append_big_endian(std::string &out, uint64_t bits) {
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<char>((bits >> shift) & 0xff));
+  }
+}
+
+} // namespace
+
+// 有序段：溢出文件或最后一个内存段。行的最后一列保存排序键
+struct SortOperator::SortRun {
+  std::unique_ptr<SpillFile> file;
+  std::vector<Row> rows;
+  RowReader reader;
+  const Row *head = nullptr;
+
+  void start() {
+    reader = file ? file->reader() : make_row_reader(rows);
+    head = reader();
+  }
+  const std::string &key() const { return head->values.back().str_val; }
+};
+
+SortOperator::SortOperator(OperatorPtr child, const std::vector<SortKey> &keys)
+    : keys_(keys), memory_limit_(kDefaultOperatorMemoryLimit) {
+  columns_ = child->output_columns();
+  for (const auto &key : keys_) {
+    key_indexes_.push_back(resolve_column(columns_, key.column));
+  }
+  children_.push_back(std::move(child));
+}
+
+SortOperator::~SortOperator() = default;
+
+void SortOperator::set_memory_limit(size_t limit_bytes) {
+  memory_limit_ = std::max<size_t>(limit_bytes, 1);
+}
+
+void SortOperator::open() {
+  PhysicalOperator::open();
+  rows_.clear();
+  row_keys_.clear();
+  order_.clear();
+  runs_.clear();
+  loser_tree_.clear();
+  memory_used_ = 0;
+  sorted_ = false;
+  position_ = 0;
+  spilled_runs_ = 0;
+  merge_passes_ = 0;
+}
+
+size_t SortOperator::max_fan_in() const {
+  return std::min(kMaxSortFanIn,
+                  std::max<size_t>(2, memory_limit_ / kSortRunBufferBytes));
+}
+
+void SortOperator::sort_buffer() {
+  order_.resize(rows_.size());
+  for (size_t i = 0; i < order_.size(); ++i) {
+    order_[i] = i;
+  }
+  std::stable_sort(order_.begin(), order_.end(), [this](size_t a, size_t b) {
+    return row_keys_[a] < row_keys_[b];
+  });
+}
+
+void SortOperator::spill_buffer() {
+  sort_buffer();
+  auto run = std::make_unique<SortRun>();
+  run->file = std::make_unique<SpillFile>();
+  for (size_t index : order_) {
+    Row &row = rows_[index];
+    row.values.emplace_back(std::move(row_keys_[index]));
+    run->file->append(row);
+  }
+  runs_.push_back(std::move(run));
+  spilled_runs_++;
+  rows_.clear();
+  row_keys_.clear();
+  order_.clear();
+  memory_used_ = 0;
+}
+
+std::unique_ptr<SortOperator::SortRun>
+SortOperator::merge_runs(std::vector<std::unique_ptr<SortRun>> runs) {
+  for (auto &run : runs) {
+    run->start();
+  }
+  auto beats = [&runs](size_t a, size_t b) {
+    return run_precedes(runs, a, b);
+  };
+  std::vector<size_t> tree;
+  build_loser_tree(tree, runs.size(), beats);
+
+  auto merged = std::make_unique<SortRun>();
+  merged->file = std::make_unique<SpillFile>();
+  while (runs[tree[0]]->head) {
+    SortRun &run = *runs[tree[0]];
+    merged->file->append(*run.head);
+    run.head = run.reader();
+    replay_loser_tree(tree, beats);
+  }
+  return merged;
+}
+
+void SortOperator::consume() {
+  RowBatch input;
+  while (children_[0]->next(input)) {
+    for (auto &row : input.rows()) {
+      std::string key;
+      for (size_t k = 0; k < key_indexes_.size(); ++k) {
+        size_t index = key_indexes_[k];
+        encode_sort_key(index < row.values.size() ? row.values[index]
+                                                  : Value(),
+                        keys_[k].ascending, key);
+      }
+      memory_used_ += estimate_row_size(row) + key.capacity() + sizeof(size_t);
+      rows_.push_back(std::move(row));
+      row_keys_.push_back(std::move(key));
+      if (memory_used_ > memory_limit_) {
+        spill_buffer();
+      }
+    }
+  }
+
+  if (runs_.empty()) {
+    // 全部装入内存，直接按排序顺序输出
+    sort_buffer();
+    sorted_ = true;
+    return;
+  }
+
+  // 最后一个内存段不写盘，作为归并的一路
+  if (!rows_.empty()) {
+    sort_buffer();
+    auto run = std::make_unique<SortRun>();
+    run->rows.reserve(rows_.size());
+    for (size_t index : order_) {
+      rows_[index].values.emplace_back(std::move(row_keys_[index]));
+      run->rows.push_back(std::move(rows_[index]));
+    }
+    rows_.clear();
+    row_keys_.clear();
+    order_.clear();
+    runs_.push_back(std::move(run));
+  }
+
+  // 段数超过归并路数时，按输入顺序分组做中间归并
+  size_t fan_in = max_fan_in();
+  while (runs_.size() > fan_in) {
+    std::vector<std::unique_ptr<SortRun>> merged;
+    for (size_t begin = 0; begin < runs_.size(); begin += fan_in) {
+      size_t end = std::min(begin + fan_in, runs_.size());
+      if (end - begin == 1) {
+        merged.push_back(std::move(runs_[begin]));
+        continue;
+      }
+      std::vector<std::unique_ptr<SortRun>> group;
+      for (size_t i = begin; i < end; ++i) {
+        group.push_back(std::move(runs_[i]));
+      }
+      merged.push_back(merge_runs(std::move(group)));
+    }
+    runs_ = std::move(merged);
+    merge_passes_++;
+  }
+
+  for (auto &run : runs_) {
+    run->start();
+  }
+  build_loser_tree(loser_tree_, runs_.size(), [this](size_t a, size_t b) {
+    return run_precedes(runs_, a, b);
+  });
+  merge_passes_++;
+  sorted_ = true;
+}
+
+bool SortOperator::next_merged(Row &out) {
+  SortRun &run = *runs_[loser_tree_[0]];
+  if (!run.head) {
+    return false;
+  }
+  out = *run.head;
+  out.values.pop_back(); // 去掉排序键列
+  run.head = run.reader();
+  replay_loser_tree(loser_tree_, [this](size_t a, size_t b) {
+    return run_precedes(runs_, a, b);
+  });
+  return true;
+}
+
+bool SortOperator::next(RowBatch &batch) {
+  if (!sorted_) {
+    consume();
+  }
+
+  batch.clear();
+  if (!runs_.empty()) {
+    Row row;
+    while (!batch.full() && next_merged(row)) {
+      batch.add_row(std::move(row));
+    }
+  } else {
+    while (!batch.full() && position_ < order_.size()) {
+      batch.add_row(std::move(rows_[order_[position_++]]));
+    }
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+void SortOperator::close() {
+  rows_.clear();
+  rows_.shrink_to_fit();
+  row_keys_.clear();
+  row_keys_.shrink_to_fit();
+  order_.clear();
+  runs_.clear();
+  loser_tree_.clear();
+  PhysicalOperator::close();
+}
+
+std::string SortOperator::describe() const {
+  std::string out = "Sort(";
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    out += (i > 0 ? ", " : "") + keys_[i].column +
+           (keys_[i].ascending ? " ASC" : " DESC");
+  }
+  return out + ")";
+}
+
+// ==================== TopNOperator ====================
+
+TopNOperator::TopNOperator(OperatorPtr child, const std::vector<SortKey> &keys,
+                           size_t limit, size_t offset)
+    : keys_(keys), limit_(limit), offset_(offset) {
+  capacity_ = limit > std::numeric_limits<size_t>::max() - offset
+                  ? std::numeric_limits<size_t>::max()
+                  : limit + offset;
+  columns_ = child->output_columns();
+  for (const auto &key : keys_) {
+    key_indexes_.push_back(resolve_column(columns_, key.column));
+  }
+  children_.push_back(std::move(child));
+}
+
+void TopNOperator::open() {
+  PhysicalOperator::open();
+  heap_.clear();
+  consumed_ = false;
+  position_ = 0;
+}
+
+void TopNOperator::consume() {
+  consumed_ = true;
+  if (limit_ == 0) {
+    return;
+  }
+  auto before = [](const Entry &left, const Entry &right) {
+    int cmp = left.key.compare(right.key);
+    return cmp < 0 || (cmp == 0 && left.sequence < right.sequence);
+  };
+
+  RowBatch input;
+  std::string key;
+  size_t sequence = 0;
+  while (children_[0]->next(input)) {
+    for (auto &row : input.rows()) {
+      key.clear();
+      for (size_t k = 0; k < key_indexes_.size(); ++k) {
+        size_t index = key_indexes_[k];
+        encode_sort_key(index < row.values.size() ? row.values[index]
+                                                  : Value(),
+                        keys_[k].ascending, key);
+      }
+      // 堆已满时只有排在堆顶之前的行才替换堆顶；序号递增，同键的新行不会入选
+      if (heap_.size() >= capacity_) {
+        if (key.compare(heap_.front().key) >= 0) {
+          ++sequence;
+          continue;
+        }
+        std::pop_heap(heap_.begin(), heap_.end(), before);
+        heap_.back() = Entry{key, sequence++, std::move(row)};
+      } else {
+        heap_.push_back(Entry{key, sequence++, std::move(row)});
+      }
+      std::push_heap(heap_.begin(), heap_.end(), before);
+    }
+  }
+  std::sort_heap(heap_.begin(), heap_.end(), before);
+  position_ = std::min(offset_, heap_.size());
+}
+
+bool TopNOperator::next(RowBatch &batch) {
+  if (!consumed_) {
+    consume();
+  }
+  batch.clear();
+  while (!batch.full() && position_ < heap_.size()) {
+    batch.add_row(std::move(heap_[position_++].row));
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+void TopNOperator::close() {
+  heap_.clear();
+  heap_.shrink_to_fit();
+  PhysicalOperator::close();
+}
+
+std::string TopNOperator::describe() const {
+  std::string out = "TopN(";
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    out += (i > 0 ? ", " : "") + keys_[i].column +
+           (keys_[i].ascending ? " ASC" : " DESC");
+  }
+  out += "; limit " + std::to_string(limit_);
+  if (offset_ > 0) {
+    out += ", offset " + std::to_string(offset_);
+  }
+  return out + ")";
+}
+
+// ==================== WindowOperator ====================
+
+WindowOperator::WindowOperator(OperatorPtr child,
+                               const std::vector<WindowSpec> &windows)
+    : windows_(windows) {
+  const auto &input_columns = child->output_columns();
+  input_width_ = input_columns.size();
+  columns_ = input_columns;
+
+  for (size_t f = 0; f < windows_.size(); ++f) {
+    const WindowSpec &spec = windows_[f];
+    bool ranking = spec.function == WindowSpec::ROW_NUMBER ||
+                   spec.function == WindowSpec::RANK ||
+                   spec.function == WindowSpec::DENSE_RANK;
+    bool needs_argument =
+        !ranking && !(spec.function == WindowSpec::COUNT && spec.column.empty());
+    if (needs_argument && spec.column.empty()) {
+      throw Exception("Window function requires an argument: " + spec.alias);
+    }
+    size_t argument = spec.column.empty()
+                          ? kNoColumn
+                          : resolve_column(input_columns, spec.column);
+    argument_indexes_.push_back(argument);
+    integer_sum_.push_back(
+        argument != kNoColumn &&
+        parse_value("0", input_columns[argument].data_type).type ==
+            Value::Type::INT);
+
+    if ((spec.function == WindowSpec::LAG ||
+         spec.function == WindowSpec::LEAD) &&
+        spec.offset < 0) {
+      throw Exception("LAG/LEAD offset must not be negative: " + spec.alias);
+    }
+    if (spec.has_frame &&
+        (spec.frame_start > spec.frame_end ||
+         spec.frame_start == WindowSpec::kUnboundedFollowing ||
+         spec.frame_end == WindowSpec::kUnboundedPreceding)) {
+      throw Exception("Invalid window frame: " + spec.alias);
+    }
+
+    std::string type;
+    switch (spec.function) {
+    case WindowSpec::ROW_NUMBER:
+    case WindowSpec::RANK:
+    case WindowSpec::DENSE_RANK:
+    case WindowSpec::COUNT:
+      type = "INT";
+      break;
+    case WindowSpec::AVG:
+      type = "DOUBLE";
+      break;
+    case WindowSpec::SUM:
+      type = integer_sum_.back() ? "INT" : "DOUBLE";
+      break;
+    default:
+      type = input_columns[argument].data_type;
+      break;
+    }
+    columns_.push_back({spec.alias, type, true, false, false, ""});
+
+    // 相同(PARTITION BY, ORDER BY)的函数归入同一组，共享一次排序
+    std::vector<size_t> partition_indexes;
+    for (const auto &column : spec.partition_by) {
+      partition_indexes.push_back(resolve_column(input_columns, column));
+    }
+    std::vector<size_t> order_indexes;
+    for (const auto &key : spec.order_by) {
+      order_indexes.push_back(resolve_column(input_columns, key.column));
+    }
+    auto group = std::find_if(
+        groups_.begin(), groups_.end(), [&](const WindowGroup &candidate) {
+          return candidate.partition_indexes == partition_indexes &&
+                 candidate.order_indexes == order_indexes &&
+                 std::equal(candidate.order_by.begin(),
+                            candidate.order_by.end(), spec.order_by.begin(),
+                            [](const SortKey &a, const SortKey &b) {
+                              return a.ascending == b.ascending;
+                            });
+        });
+    if (group == groups_.end()) {
+      groups_.push_back(
+          WindowGroup{partition_indexes, spec.order_by, order_indexes, {}});
+      group = groups_.end() - 1;
+    }
+    group->functions.push_back(f);
+  }
+  children_.push_back(std::move(child));
+}
+
+void WindowOperator::open() {
+  PhysicalOperator::open();
+  rows_.clear();
+  output_order_.clear();
+  consumed_ = false;
+  position_ = 0;
+  sorts_performed_ = 0;
+}
+
+void WindowOperator::consume() {
+  consumed_ = true;
+  RowBatch input;
+  while (children_[0]->next(input)) {
+    for (auto &row : input.rows()) {
+      row.values.resize(input_width_);
+      row.values.resize(input_width_ + windows_.size());
+      rows_.push_back(std::move(row));
+    }
+  }
+
+  for (size_t g = 0; g < groups_.size(); ++g) {
+    std::vector<size_t> order;
+    compute_group(groups_[g], order);
+    if (g == 0) {
+      output_order_ = std::move(order);
+    }
+  }
+  if (groups_.empty()) {
+    output_order_.resize(rows_.size());
+    std::iota(output_order_.begin(), output_order_.end(), 0);
+  }
+}
+
+void WindowOperator::compute_group(const WindowGroup &group,
+                                   std::vector<size_t> &order) {
+  size_t count = rows_.size();
+  order.resize(count);
+  std::iota(order.begin(), order.end(), 0);
+
+  // 键为分区列（升序）接ORDER BY列的编码；编码无前缀歧义，
+  // 分区键相同即同一分区，整个键相同即同序行
+  std::vector<std::string> keys(count);
+  std::vector<size_t> partition_length(count);
+  for (size_t r = 0; r < count; ++r) {
+    for (size_t index : group.partition_indexes) {
+      encode_sort_key(rows_[r].values[index], true, keys[r]);
+    }
+    partition_length[r] = keys[r].size();
+    for (size_t k = 0; k < group.order_indexes.size(); ++k) {
+      encode_sort_key(rows_[r].values[group.order_indexes[k]],
+                      group.order_by[k].ascending, keys[r]);
+    }
+  }
+  if (!group.partition_indexes.empty() || !group.order_indexes.empty()) {
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return keys[a] < keys[b];
+    });
+    sorts_performed_++;
+  }
+
+  auto same_partition = [&](size_t a, size_t b) {
+    return partition_length[a] == partition_length[b] &&
+           keys[a].compare(0, partition_length[a], keys[b], 0,
+                           partition_length[b]) == 0;
+  };
+  std::vector<size_t> peer_end;
+  for (size_t begin = 0; begin < count;) {
+    size_t end = begin + 1;
+    while (end < count && same_partition(order[begin], order[end])) {
+      ++end;
+    }
+    // peer_end[p]：分区内第p行所在同序行段的结束位置（分区内相对位置）
+    peer_end.assign(end - begin, 0);
+    for (size_t i = end; i-- > begin;) {
+      peer_end[i - begin] =
+          i + 1 < end && keys[order[i]] == keys[order[i + 1]]
+              ? peer_end[i + 1 - begin]
+              : i + 1 - begin;
+    }
+    for (size_t f : group.functions) {
+      compute_function(f, order, begin, end, peer_end);
+    }
+    begin = end;
+  }
+}
+
+void WindowOperator::compute_function(size_t function,
+                                      const std::vector<size_t> &order,
+                                      size_t begin, size_t end,
+                                      const std::vector<size_t> &peer_end) {
+  const WindowSpec &spec = windows_[function];
+  size_t output = input_width_ + function;
+  size_t argument = argument_indexes_[function];
+  size_t size = end - begin;
+  auto row_at = [&](size_t position) -> Row & {
+    return rows_[order[begin + position]];
+  };
+
+  switch (spec.function) {
+  case WindowSpec::ROW_NUMBER:
+    for (size_t p = 0; p < size; ++p) {
+      row_at(p).values[output] = Value(static_cast<int64_t>(p + 1));
+    }
+    return;
+
+  case WindowSpec::RANK:
+  case WindowSpec::DENSE_RANK: {
+    int64_t rank = 0;
+    int64_t dense_rank = 0;
+    for (size_t p = 0; p < size; ++p) {
+      if (p == 0 || peer_end[p - 1] != peer_end[p]) {
+        rank = static_cast<int64_t>(p + 1);
+        dense_rank++;
+      }
+      row_at(p).values[output] =
+          Value(spec.function == WindowSpec::RANK ? rank : dense_rank);
+    }
+    return;
+  }
+
+  case WindowSpec::LAG:
+  case WindowSpec::LEAD: {
+    int64_t shift = spec.function == WindowSpec::LAG ? -spec.offset : spec.offset;
+    for (size_t p = 0; p < size; ++p) {
+      int64_t source = static_cast<int64_t>(p) + shift;
+      row_at(p).values[output] =
+          source >= 0 && source < static_cast<int64_t>(size)
+              ? row_at(static_cast<size_t>(source)).values[argument]
+              : spec.default_value;
+    }
+    return;
+  }
+
+  default:
+    break;
+  }
+
+  // 聚合窗口：帧[frame_begin, frame_end)随当前行单调前移，
+  // 进入帧的行加入累加器，离开帧的行撤销
+  bool integer = integer_sum_[function];
+  int64_t count = 0;
+  int64_t int_sum = 0;
+  double double_sum = 0.0;
+  std::deque<size_t> extremes; // MIN/MAX单调队列：位置递增，值单调
+  bool minimum = spec.function == WindowSpec::MIN;
+  auto value_at = [&](size_t position) -> const Value & {
+    return row_at(position).values[argument];
+  };
+  auto add = [&](size_t position) {
+    count++;
+    if (argument == kNoColumn) {
+      return;
+    }
+    const Value &value = value_at(position);
+    if (spec.function == WindowSpec::SUM || spec.function == WindowSpec::AVG) {
+      if (integer) {
+        int_sum += value.type == Value::Type::INT
+                       ? value.int_val
+                       : static_cast<int64_t>(numeric_value(value));
+      } else {
+        double_sum += numeric_value(value);
+      }
+    } else if (spec.function == WindowSpec::MIN ||
+               spec.function == WindowSpec::MAX) {
+      while (!extremes.empty()) {
+        int cmp = compare_values(value_at(extremes.back()), value);
+        if (minimum ? cmp <= 0 : cmp >= 0) {
+          break;
+        }
+        extremes.pop_back();
+      }
+      extremes.push_back(position);
+    }
+  };
+  auto remove = [&](size_t position) {
+    count--;
+    if (argument == kNoColumn) {
+      return;
+    }
+    const Value &value = value_at(position);
+    if (spec.function == WindowSpec::SUM || spec.function == WindowSpec::AVG) {
+      if (integer) {
+        int_sum -= value.type == Value::Type::INT
+                       ? value.int_val
+                       : static_cast<int64_t>(numeric_value(value));
+      } else {
+        // 帧为空时清零，避免浮点误差累积
+        double_sum = count == 0 ? 0.0 : double_sum - numeric_value(value);
+      }
+    } else if (!extremes.empty() && extremes.front() == position) {
+      extremes.pop_front();
+    }
+  };
+  auto clamp = [size](int64_t position) {
+    return static_cast<size_t>(
+        std::max<int64_t>(0, std::min<int64_t>(position, size)));
+  };
+
+  size_t current_begin = 0;
+  size_t current_end = 0;
+  for (size_t p = 0; p < size; ++p) {
+    size_t frame_begin = 0;
+    size_t frame_end = size;
+    if (spec.has_frame) {
+      int64_t position = static_cast<int64_t>(p);
+      frame_begin = spec.frame_start == WindowSpec::kUnboundedPreceding
+                        ? 0
+                        : clamp(position + spec.frame_start);
+      frame_end = spec.frame_end == WindowSpec::kUnboundedFollowing
+                      ? size
+                      : clamp(position + spec.frame_end + 1);
+    } else if (!spec.order_by.empty()) {
+      frame_end = peer_end[p];
+    }
+    frame_end = std::max(frame_end, frame_begin);
+
+    while (current_end < frame_end) {
+      add(current_end++);
+    }
+    while (current_begin < frame_begin) {
+      remove(current_begin++);
+    }
+
+    Value &out = row_at(p).values[output];
+    switch (spec.function) {
+    case WindowSpec::COUNT:
+      out = Value(count);
+      break;
+    case WindowSpec::SUM:
+      out = integer ? Value(int_sum) : Value(double_sum);
+      break;
+    case WindowSpec::AVG:
+      // 空帧没有NULL可表示，输出0
+      out = Value(count == 0 ? 0.0
+                             : (integer ? static_cast<double>(int_sum)
+                                        : double_sum) /
+                                   static_cast<double>(count));
+      break;
+    default:
+      out = extremes.empty() ? Value() : value_at(extremes.front());
+      break;
+    }
+  }
+}
+
+bool WindowOperator::next(RowBatch &batch) {
+  if (!consumed_) {
+    consume();
+  }
+  batch.clear();
+  while (!batch.full() && position_ < output_order_.size()) {
+    batch.add_row(std::move(rows_[output_order_[position_++]]));
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+void WindowOperator::close() {
+  rows_.clear();
+  rows_.shrink_to_fit();
+  output_order_.clear();
+  PhysicalOperator::close();
+}
+
+std::string WindowOperator::describe() const {
+  std::string out = "Window(";
+  for (size_t f = 0; f < windows_.size(); ++f) {
+    out += (f > 0 ? ", " : "") + windows_[f].alias;
+  }
+  return out + "; " + std::to_string(groups_.size()) + " sort group" +
+         (groups_.size() == 1 ? "" : "s") + ")";
+}
+
+// ==================== LimitOperator ====================
+
+LimitOperator::LimitOperator(OperatorPtr child, size_t limit, size_t offset)
+    : limit_(limit), offset_(offset) {
+  columns_ = child->output_columns();
+  children_.push_back(std::move(child));
+}
+
+void LimitOperator::open() {
+  PhysicalOperator::open();
+  skipped_ = 0;
+  emitted_ = 0;
+}
+
+bool LimitOperator::next(RowBatch &batch) {
+  batch.clear();
+  while (batch.empty() && emitted_ < limit_) {
+    // 只向子算子请求仍然需要的行数
+    size_t remaining = limit_ - emitted_;
+    size_t to_skip = offset_ - skipped_;
+    size_t wanted = remaining > std::numeric_limits<size_t>::max() - to_skip
+                        ? std::numeric_limits<size_t>::max()
+                        : remaining + to_skip;
+    input_.set_capacity(std::min(batch.capacity(), wanted));
+    if (!children_[0]->next(input_)) {
+      break;
+    }
+    for (auto &row : input_.rows()) {
+      if (skipped_ < offset_) {
+        ++skipped_;
+        continue;
+      }
+      if (emitted_ >= limit_ || batch.full()) {
+        break;
+      }
+      batch.add_row(std::move(row));
+      ++emitted_;
+    }
+  }
+  rows_produced_ += batch.size();
+  return !batch.empty();
+}
+
+std::string LimitOperator::describe() const {
+  return "Limit(" + std::to_string(limit_) +
+         (offset_ > 0 ? ", offset " + std::to_string(offset_) : "") + ")";
+}
+
+// ==================== UnionAllOperator ====================
+
+UnionAllOperator::UnionAllOperator(OperatorPtr left, OperatorPtr right) {
+  if (left->output_columns().size() != right->output_columns().size()) {
+    throw Exception("UNION ALL inputs have different column counts");
+  }
+  columns_ = left->output_columns();
+  children_.push_back(std::move(left));
+  children_.push_back(std::move(right));
+}
+
+void UnionAllOperator::open() {
+  PhysicalOperator::open();
+  current_ = 0;
+}
+
+bool UnionAllOperator::next(RowBatch &batch) {
+  while (current_ < children_.size()) {
+    if (children_[current_]->next(batch)) {
+      rows_produced_ += batch.size();
+      return true;
+    }
+    ++current_;
+  }
+  batch.clear();
+  return false;
+}
+
+std::string UnionAllOperator::describe() const { return "UnionAll"; }
+
+// ==================== 辅助函数 ====================
+
+int compare_values(const Value &left, const Value &right) {
+  bool left_numeric = left.type != Value::Type::STRING;
+  bool right_numeric = right.type != Value::Type::STRING;
+  if (left_numeric && right_numeric) {
+    if (left.type == Value::Type::INT && right.type == Value::Type::INT) {
+      return (left.int_val > right.int_val) - (left.int_val < right.int_val);
+    }
+    double a = numeric_value(left);
+    double b = numeric_value(right);
+    return (a > b) - (a < b);
+  }
+  if (!left_numeric && !right_numeric) {
+    int cmp = left.str_val.compare(right.str_val);
+    return (cmp > 0) - (cmp < 0);
+  }
+  // 数值排在字符串之前
+  return left_numeric ? -1 : 1;
+}
+
+void encode_sort_key(const Value &value, bool ascending, std::string &out) {
+  size_t start = out.size();
+  if (value.type == Value::Type::STRING) {
+    // 字符串：0x00转义为0x00 0xFF，以0x00 0x00结尾，保证前缀在前
+    out.push_back('\x02');
+    for (char c : value.str_val) {
+      out.push_back(c);
+      if (c == '\0') {
+        out.push_back('\xff');
+      }
+    }
+    out.push_back('\0');
+    out.push_back('\0');
+  } else {
+    // 数值：IEEE754位模式翻转后按大端序可直接比较；再附加整数值，
+    // 区分超过2^53后转换为double相同的整数
+    out.push_back('\x01');
+    double number = numeric_value(value);
+    if (number == 0.0) {
+      number = 0.0; // -0.0与0.0相等
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &number, sizeof(bits));
+    bits = (bits & 0x8000000000000000ULL) ? ~bits : bits | 0x8000000000000000ULL;
+    append_big_endian(out, bits);
+
+    int64_t exact = value.int_val;
+    if (value.type == Value::Type::DOUBLE) {
+      exact = number >= 9.2e18    ? std::numeric_limits<int64_t>::max()
+              : number <= -9.2e18 ? std::numeric_limits<int64_t>::min()
+                                  : static_cast<int64_t>(number);
+    }
+    append_big_endian(out, static_cast<uint64_t>(exact) ^ 0x8000000000000000ULL);
+  }
+  if (!ascending) {
+    for (size_t i = start; i < out.size(); ++i) {
+      out[i] = static_cast<char>(~out[i]);
+    }
+  }
+}
+
+size_t hash_value(const Value &value) {
+  switch (value.type) {
+  case Value::Type::INT:
+    return std::hash<int64_t>()(value.int_val);
+  case Value::Type::DOUBLE: {
+    double integral;
+    if (std::modf(value.double_val, &integral) == 0.0 &&
+        std::fabs(integral) < 9.2e18) {
+      return std::hash<int64_t>()(static_cast<int64_t>(integral));
+    }
+    return std::hash<double>()(value.double_val);
+  }
+  case Value::Type::STRING:
+    return std::hash<std::string>()(value.str_val);
+  }
+  return 0;
+}
+
+size_t resolve_column(const std::vector<ColumnMeta> &columns,
+                      const std::string &name) {
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (columns[i].name == name) {
+      return i;
+    }
+  }
+  size_t dot = name.find('.');
+  if (dot != std::string::npos) {
+    std::string column = name.substr(dot + 1);
+    for (size_t i = 0; i < columns.size(); ++i) {
+      if (columns[i].name == column) {
+        return i;
+      }
+    }
+  } else {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      size_t column_dot = columns[i].name.find('.');
+      if (column_dot != std::string::npos &&
+          columns[i].name.compare(column_dot + 1, std::string::npos, name) ==
+              0) {
+        return i;
+      }
+    }
+  }
+  throw Exception("Column not found: " + name);
+}
+
+Value parse_value(const std::string &text, const std::string &data_type) {
+  std::string type = to_upper(data_type);
+  int64_t int_value;
+  double double_value;
+
+  if (type.find("INT") != std::string::npos) {
+    if (parse_int(text, int_value)) {
+      return Value(int_value);
+    }
+  } else if (type.find("FLOAT") != std::string::npos ||
+             type.find("DOUBLE") != std::string::npos ||
+             type.find("DECIMAL") != std::string::npos ||
+             type.find("NUMERIC") != std::string::npos ||
+             type.find("REAL") != std::string::npos) {
+    if (parse_double(text, double_value)) {
+      return Value(double_value);
+    }
+  } else if (type.empty()) {
+    // 类型未知时按字面值推断
+    if (parse_int(text, int_value)) {
+      return Value(int_value);
+    }
+    if (parse_double(text, double_value)) {
+      return Value(double_value);
+    }
+  }
+  return Value(text);
+}
+
+RowPredicate make_comparison_predicate(const std::vector<ColumnMeta> &columns,
+                                       const std::string &column,
+                                       const std::string &op,
+                                       const std::string &literal) {
+  // 编译一次，逐行求值时不再分派操作符或转换常量
+  CompiledPredicate predicate =
+      CompiledPredicate::compile(columns, column, op, literal);
+  return [predicate](const Row &row) { return predicate(row); };
+}
+
+// ==================== JoinHashTable ====================
+
+size_t JoinHashTable::KeyHash::operator()(const Value *value) const {
+  return hash_value(*value);
+}
+
+bool JoinHashTable::KeyEqual::operator()(const Value *left,
+                                         const Value *right) const {
+  return compare_values(*left, *right) == 0;
+}
+
+void JoinHashTable::build(const std::vector<Row> &rows, size_t key_index) {
+  clear();
+  next_.assign(rows.size(), npos);
+  matched_.assign(rows.size(), false);
+  heads_.reserve(rows.size());
+  // 逆序插入到链表头，遍历链表时即为输入顺序
+  for (size_t i = rows.size(); i-- > 0;) {
+    if (key_index >= rows[i].values.size()) {
+      continue;
+    }
+    auto inserted = heads_.emplace(&rows[i].values[key_index], i);
+    if (!inserted.second) {
+      next_[i] = inserted.first->second;
+      inserted.first->second = i;
+    }
+  }
+}
+
+void JoinHashTable::clear() {
+  heads_.clear();
+  next_.clear();
+  matched_.clear();
+}
+
+size_t JoinHashTable::find(const Value &key) const {
+  auto it = heads_.find(&key);
+  return it == heads_.end() ? npos : it->second;
+}
+
+OperatorPtr plan_join(OperatorPtr outer, size_t outer_rows, OperatorPtr inner,
+                      size_t inner_rows, BPlusTreeIndex *inner_index,
+                      JoinType join_type, const std::string &join_condition) {
+  auto *inner_scan = dynamic_cast<TableScanOperator *>(inner.get());
+  size_t eq_pos = join_condition.find('=');
+  if (inner_index && inner_scan && eq_pos != std::string::npos &&
+      join_type != JoinType::CROSS_JOIN) {
+    std::string first = trim(join_condition.substr(0, eq_pos));
+    std::string second = trim(join_condition.substr(eq_pos + 1));
+    // 条件中引用内表索引列的一侧为内表键，另一侧为外表键
+    std::string outer_key;
+    if (strip_table(second) == inner_index->GetColumnName()) {
+      outer_key = first;
+    } else if (strip_table(first) == inner_index->GetColumnName()) {
+      outer_key = second;
+    }
+
+    JoinInputEstimate outer_estimate{outer_rows, false, false};
+    JoinInputEstimate inner_estimate{inner_rows, false, true};
+    if (!outer_key.empty() &&
+        choose_join_algorithm(outer_estimate, inner_estimate, join_type,
+                              true) == JoinAlgorithm::INDEX_NESTED_LOOP) {
+      return std::make_unique<IndexNestedLoopJoinOperator>(
+          std::move(outer), inner_scan->table_storage(),
+          inner_scan->table_name(), inner_scan->metadata(), inner_index,
+          outer_key, join_type);
+    }
+  }
+  return std::make_unique<JoinOperator>(std::move(outer), std::move(inner),
+                                        join_type, join_condition);
+}
+
+ExecutionResult execute_operator_tree(PhysicalOperator &root,
+                                      size_t batch_size) {
+  ExecutionResult result;
+  result.column_metadata = root.output_columns();
+
+  root.open();
+  try {
+    RowBatch batch(batch_size);
+    while (root.next(batch)) {
+      for (auto &row : batch.rows()) {
+        result.rows.push_back(std::move(row));
+      }
+    }
+  } catch (...) {
+    root.close();
+    throw;
+  }
+  root.close();
+
+  result.success = true;
+  result.message = "Query executed successfully";
+  return result;
+}
+
+} // namespace sqlcc
@@ -0,0 +1,289 @@
+#include "execution/result_cache.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace sqlcc {
+
+namespace {
+
+// 两侧空白不影响语义的标点和运算符
+bool is_separator(char c) {
+  return c != '\0' && std::strchr(",()=<>;", c) != nullptr;
+}
+
+} // namespace
+
+QueryResultCache &QueryResultCache::shared() {
+  static QueryResultCache cache;
+  return cache;
+}
+
+QueryResultCache::QueryResultCache(size_t capacity_bytes)
+    : capacity_(capacity_bytes) {}
+
+std::string QueryResultCache::normalize_sql(const std::string &sql) {
+  std::string out;
+  out.reserve(sql.size());
+  char quote = 0;
+  bool pending_space = false;
+  for (char c : sql) {
+    if (quote) {
+      out += c;
+      if (c == quote) {
+        quote = 0;
+      }
+      continue;
+    }
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      pending_space = true;
+      continue;
+    }
+    if (pending_space && !out.empty() && !is_separator(out.back()) &&
+        !is_separator(c)) {
+      out += ' ';
+    }
+    pending_space = false;
+    if (c == '\'' || c == '"' || c == '`') {
+      quote = c;
+    }
+    out += c;
+  }
+  while (!quote && !out.empty() && out.back() == ';') {
+    out.pop_back();
+  }
+  return out;
+}
+
+std::string QueryResultCache::make_key(const std::string &database,
+                                       const std::string &user,
+                                       const std::string &sql) {
+  std::string key = database;
+  key += '\0';
+  key += user;
+  key += '\0';
+  key += normalize_sql(sql);
+  return key;
+}
+
+std::string QueryResultCache::table_key(const std::string &database,
+                                        const std::string &table) {
+  // 表名按不区分大小写处理：大小写不同的两张表只会多失效，不会读到旧结果
+  std::string key = database;
+  key += '\0';
+  key += table;
+  std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+  return key;
+}
+
+size_t QueryResultCache::estimate_bytes(const std::string &key,
+                                        const ExecutionResult &result) {
+  // 键在条目表、LRU链表和依赖表中各保存一份
+  size_t bytes = sizeof(Entry) + sizeof(ExecutionResult) + 3 * key.size() +
+                 result.message.size();
+  for (const auto &column : result.column_metadata) {
+    bytes += sizeof(ColumnMeta) + column.name.size() + column.data_type.size() +
+             column.default_value.size();
+  }
+  for (const auto &row : result.rows) {
+    bytes += sizeof(Row) + row.values.size() * sizeof(Value);
+    for (const auto &value : row.values) {
+      bytes += value.str_val.size();
+    }
+  }
+  return bytes;
+}
+
+std::vector<uint64_t>
+QueryResultCache::table_versions(const std::string &database,
+                                 const std::vector<std::string> &tables) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<uint64_t> versions;
+  versions.reserve(tables.size());
+  for (const auto &table : tables) {
+    versions.push_back(version_locked(table_key(database, table)));
+  }
+  return versions;
+}
+
+std::shared_ptr<const ExecutionResult>
+QueryResultCache::lookup(const std::string &key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++stats_.misses;
+    return nullptr;
+  }
+  const Entry &entry = it->second;
+  for (size_t i = 0; i < entry.tables.size(); ++i) {
+    // 写入者应读到自己未提交的修改；写入回滚后条目仍然有效，不删除
+    if (writing_locked(entry.tables[i])) {
+      ++stats_.misses;
+      return nullptr;
+    }
+    if (version_locked(entry.tables[i]) != entry.versions[i]) {
+      erase_locked(it);
+      ++stats_.invalidations;
+      ++stats_.misses;
+      return nullptr;
+    }
+  }
+  lru_.splice(lru_.begin(), lru_, entry.lru);
+  ++stats_.hits;
+  return entry.result;
+}
+
+void QueryResultCache::insert(const std::string &key,
+                              const std::string &database,
+                              const std::vector<std::string> &tables,
+                              const std::vector<uint64_t> &versions,
+                              ExecutionResult result) {
+  if (tables.size() != versions.size()) {
+    return;
+  }
+  size_t bytes = estimate_bytes(key, result);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry entry;
+  for (size_t i = 0; i < tables.size(); ++i) {
+    std::string table = table_key(database, tables[i]);
+    // 执行期间表被修改，结果可能混合了修改前后的数据；
+    // 表上有未结束的写入时结果可能包含之后被回滚的行
+    if (version_locked(table) != versions[i] || writing_locked(table)) {
+      return;
+    }
+    entry.tables.push_back(std::move(table));
+  }
+  if (bytes > capacity_) {
+    return;
+  }
+
+  auto existing = entries_.find(key);
+  if (existing != entries_.end()) {
+    erase_locked(existing);
+  }
+  evict_locked(capacity_ - bytes);
+
+  entry.result = std::make_shared<const ExecutionResult>(std::move(result));
+  entry.versions = versions;
+  entry.bytes = bytes;
+  lru_.push_front(key);
+  entry.lru = lru_.begin();
+  for (const auto &table : entry.tables) {
+    dependents_[table].insert(key);
+  }
+  entries_.emplace(key, std::move(entry));
+  bytes_ += bytes;
+  ++stats_.inserts;
+}
+
+void QueryResultCache::invalidate_table(const std::string &database,
+                                        const std::string &table) {
+  std::string key = table_key(database, table);
+  std::lock_guard<std::mutex> lock(mutex_);
+  invalidate_locked(key);
+}
+
+void QueryResultCache::begin_write(const std::string &database,
+                                   const std::string &table) {
+  std::string key = table_key(database, table);
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++pending_writes_[key];
+}
+
+void QueryResultCache::commit_write(const std::string &database,
+                                    const std::string &table) {
+  std::string key = table_key(database, table);
+  std::lock_guard<std::mutex> lock(mutex_);
+  end_write_locked(key);
+  invalidate_locked(key);
+}
+
+void QueryResultCache::abort_write(const std::string &database,
+                                   const std::string &table) {
+  std::string key = table_key(database, table);
+  std::lock_guard<std::mutex> lock(mutex_);
+  end_write_locked(key);
+}
+
+void QueryResultCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.invalidations += entries_.size();
+  entries_.clear();
+  lru_.clear();
+  dependents_.clear();
+  bytes_ = 0;
+}
+
+void QueryResultCache::set_capacity(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = bytes;
+  evict_locked(capacity_);
+}
+
+QueryResultCache::Stats QueryResultCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.entries = entries_.size();
+  stats.bytes = bytes_;
+  stats.capacity = capacity_;
+  return stats;
+}
+
+uint64_t QueryResultCache::version_locked(const std::string &table_key) const {
+  auto it = versions_.find(table_key);
+  return it == versions_.end() ? 0 : it->second;
+}
+
+bool QueryResultCache::writing_locked(const std::string &table_key) const {
+  return pending_writes_.count(table_key) > 0;
+}
+
+void QueryResultCache::invalidate_locked(const std::string &table_key) {
+  ++versions_[table_key];
+  auto dependents = dependents_.find(table_key);
+  if (dependents == dependents_.end()) {
+    return;
+  }
+  std::vector<std::string> keys(dependents->second.begin(),
+                                dependents->second.end());
+  for (const auto &entry_key : keys) {
+    auto it = entries_.find(entry_key);
+    if (it != entries_.end()) {
+      erase_locked(it);
+      ++stats_.invalidations;
+    }
+  }
+}
+
+void QueryResultCache::end_write_locked(const std::string &table_key) {
+  auto it = pending_writes_.find(table_key);
+  if (it != pending_writes_.end() && --it->second == 0) {
+    pending_writes_.erase(it);
+  }
+}
+
+void QueryResultCache::erase_locked(
+    std::unordered_map<std::string, Entry>::iterator it) {
+  for (const auto &table : it->second.tables) {
+    auto dependents = dependents_.find(table);
+    if (dependents != dependents_.end()) {
+      dependents->second.erase(it->first);
+      if (dependents->second.empty()) {
+        dependents_.erase(dependents);
+      }
+    }
+  }
+  bytes_ -= it->second.bytes;
+  lru_.erase(it->second.lru);
+  entries_.erase(it);
+}
+
+void QueryResultCache::evict_locked(size_t capacity) {
+  while (bytes_ > capacity && !lru_.empty()) {
+    erase_locked(entries_.find(lru_.back()));
+    ++stats_.evictions;
+  }
+}
+
+} // namespace sqlcc
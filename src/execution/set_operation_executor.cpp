@@ -2,8 +2,10 @@
 #include "exception.h"
 #include "sql_parser/set_operation_node.h"
 #include <algorithm>
+#include <deque>
+#include <functional>
+#include <limits>
 #include <memory>
-#include <unordered_set>
 
 namespace sqlcc {
 
@@ -12,8 +14,7 @@ using sql_parser::SetOperationType;
 
 SetOperationExecutor::SetOperationExecutor(
     std::shared_ptr<SqlExecutor> sql_executor)
-    : sql_executor_(sql_executor),
-      memory_limit_(1024 * 1024 * 1024) { // 默认1GB内存限制
+    : sql_executor_(sql_executor), memory_limit_(kDefaultOperatorMemoryLimit) {
 }
 
 ExecutionResult
@@ -24,8 +25,7 @@ SetOperationExecutor::execute(const SetOperationNode &operation) {
   auto start_time = std::chrono::steady_clock::now();
 
   try {
-    // 2. 检查内存使用
-    // MemoryManager::check_memory_limit(memory_limit_);
+    // 内存限制由集合操作的哈希表执行，超出时分区写入磁盘
 
     // 3. 执行左操作数
     auto left_start = std::chrono::steady_clock::now();
@@ -50,6 +50,7 @@ SetOperationExecutor::execute(const SetOperationNode &operation) {
     }
 
     // 6. 根据操作类型执行相应的集合操作
+    size_t input_rows = left_result.rows.size() + right_result.rows.size();
     ExecutionResult result;
     auto operation_start = std::chrono::steady_clock::now();
 
@@ -77,9 +78,7 @@ SetOperationExecutor::execute(const SetOperationNode &operation) {
     stats_.total_execution_time =
         std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
                                                               start_time);
-    stats_.rows_processed = left_result.rows.size() + right_result.rows.size();
-    // stats_.memory_used = MemoryManager::get_current_usage(); //
-    // 暂时注释，MemoryManager未实现
+    stats_.rows_processed = input_rows;
 
     return result;
 
@@ -99,12 +98,13 @@ ExecutionStats SetOperationExecutor::get_stats() const { return stats_; }
 
 ExecutionResult
 SetOperationExecutor::execute_union(const SetOperationNode &operation,
-                                    const ExecutionResult &left,
-                                    const ExecutionResult &right) {
+                                    ExecutionResult &left,
+                                    ExecutionResult &right) {
   if (operation.isAll()) {
-    return ResultSetCombiner::union_all(left, right);
+    return ResultSetCombiner::union_all(std::move(left), std::move(right));
   } else {
-    return ResultSetCombiner::union_distinct(left, right);
+    return ResultSetCombiner::union_distinct(left, right, memory_limit_,
+                                             &stats_);
   }
 }
 
@@ -112,14 +112,16 @@ ExecutionResult
 SetOperationExecutor::execute_intersect(const SetOperationNode &operation,
                                         const ExecutionResult &left,
                                         const ExecutionResult &right) {
-  return ResultSetCombiner::intersect(left, right, operation.isAll());
+  return ResultSetCombiner::intersect(left, right, operation.isAll(),
+                                      memory_limit_, &stats_);
 }
 
 ExecutionResult
 SetOperationExecutor::execute_except(const SetOperationNode &operation,
                                      const ExecutionResult &left,
                                      const ExecutionResult &right) {
-  return ResultSetCombiner::except(left, right, operation.isAll());
+  return ResultSetCombiner::except(left, right, operation.isAll(),
+                                   memory_limit_, &stats_);
 }
 
 ExecutionResult
@@ -160,183 +162,339 @@ bool SetOperationExecutor::validate_result_compatibility(
   return true;
 }
 
-// ResultSetCombiner 实现
-ExecutionResult ResultSetCombiner::union_all(const ExecutionResult &left,
-                                             const ExecutionResult &right) {
-  ExecutionResult result;
+// ==================== 集合操作哈希表 ====================
 
-  // 复制列元数据（使用左结果集的元数据）
-  result.column_metadata = left.column_metadata;
+namespace {
 
-  // 预分配内存以提高性能
-  result.rows.reserve(left.rows.size() + right.rows.size());
+enum class SetOp { UNION, INTERSECT, EXCEPT };
 
-  // 添加左结果集的所有行
-  result.rows.insert(result.rows.end(), left.rows.begin(), left.rows.end());
+constexpr size_t kSetOperationFanout = 16;
+constexpr size_t kMaxSetOperationDepth = 4;
 
-  // 添加右结果集的所有行
-  result.rows.insert(result.rows.end(), right.rows.begin(), right.rows.end());
+// 可重复读取的行来源：内存中的结果集或溢出分区
+struct RowSource {
+  std::function<RowReader()> open;
+  bool stable; // 读取器返回的行指针在整个处理期间有效（无需复制）
+};
 
-  return result;
+uint64_t row_fingerprint(const Row &row) {
+  size_t hash = 0;
+  for (const auto &value : row.values) {
+    switch (value.type) {
+    case Value::Type::INT:
+      hash_combine(hash, std::hash<int64_t>()(value.int_val));
+      break;
+    case Value::Type::DOUBLE:
+      hash_combine(hash, std::hash<double>()(value.double_val));
+      break;
+    case Value::Type::STRING:
+      hash_combine(hash, std::hash<std::string>()(value.str_val));
+      break;
+    }
+  }
+  return hash;
 }
 
-ExecutionResult
-ResultSetCombiner::union_distinct(const ExecutionResult &left,
-                                  const ExecutionResult &right) {
-  ExecutionResult result;
-  result.column_metadata = left.column_metadata;
-
-  // 使用哈希表进行去重
-  std::unordered_set<RowKey, RowKey::Hash> seen_rows;
+// 按指纹和分区层数选择分区，每层使用不同的位
+size_t partition_of(uint64_t fingerprint, size_t depth) {
+  uint64_t mixed = fingerprint ^ ((depth + 1) * 0x9e3779b97f4a7c15ULL);
+  mixed ^= mixed >> 33;
+  mixed *= 0xff51afd7ed558ccdULL;
+  mixed ^= mixed >> 33;
+  return static_cast<size_t>(mixed % kSetOperationFanout);
+}
 
-  // 处理左结果集
-  for (const auto &row : left.rows) {
-    RowKey key = generate_row_key(row, left.column_metadata);
-    if (seen_rows.insert(key).second) {
-      result.rows.push_back(row);
+// 开放寻址哈希表：每个不同的行只保存指纹、行指针和计数
+class RowFingerprintTable {
+public:
+  struct Entry {
+    uint64_t fingerprint;
+    const Row *row;
+    size_t count;
+    bool emitted;
+  };
+
+  RowFingerprintTable() : slots_(64, kEmpty) {}
+
+  Entry *find(const Row &row, uint64_t fingerprint) {
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = fingerprint & mask; slots_[slot] != kEmpty;
+         slot = (slot + 1) & mask) {
+      Entry &entry = entries_[slots_[slot]];
+      // 指纹相同时才比较整行
+      if (entry.fingerprint == fingerprint && entry.row->values == row.values) {
+        return &entry;
+      }
     }
+    return nullptr;
   }
 
-  // 处理右结果集
-  for (const auto &row : right.rows) {
-    RowKey key = generate_row_key(row, right.column_metadata);
-    if (seen_rows.insert(key).second) {
-      result.rows.push_back(row);
+  // row在表的生命周期内必须有效
+  Entry &insert(const Row *row, uint64_t fingerprint) {
+    if ((entries_.size() + 1) * 2 > slots_.size()) {
+      grow();
     }
+    size_t mask = slots_.size() - 1;
+    size_t slot = fingerprint & mask;
+    while (slots_[slot] != kEmpty) {
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot] = entries_.size();
+    entries_.push_back({fingerprint, row, 0, false});
+    memory_used_ += sizeof(Entry) + 2 * sizeof(size_t) + estimate_row_size(*row);
+    return entries_.back();
   }
 
-  return result;
-}
+  size_t memory_used() const { return memory_used_; }
 
-ExecutionResult ResultSetCombiner::intersect(const ExecutionResult &left,
-                                             const ExecutionResult &right,
-                                             bool all) {
-  ExecutionResult result;
-  result.column_metadata = left.column_metadata;
+private:
+  static constexpr size_t kEmpty = std::numeric_limits<size_t>::max();
 
-  if (all) {
-    // INTERSECT ALL：保留重复
-    std::unordered_map<RowKey, size_t, RowKey::Hash> right_counts;
+  void grow() {
+    slots_.assign(slots_.size() * 2, kEmpty);
+    size_t mask = slots_.size() - 1;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      size_t slot = entries_[i].fingerprint & mask;
+      while (slots_[slot] != kEmpty) {
+        slot = (slot + 1) & mask;
+      }
+      slots_[slot] = i;
+    }
+  }
 
-    // 统计右结果集中每行的出现次数
-    for (const auto &row : right.rows) {
-      RowKey key = generate_row_key(row, right.column_metadata);
-      right_counts[key]++;
+  std::vector<Entry> entries_;
+  std::vector<size_t> slots_;
+  size_t memory_used_ = 0;
+};
+
+class SetOperationRunner {
+public:
+  SetOperationRunner(SetOp op, bool all, size_t memory_limit,
+                     ExecutionStats *stats, std::vector<Row> &output)
+      : op_(op), all_(all), memory_limit_(std::max<size_t>(memory_limit, 1)),
+        stats_(stats), output_(output) {}
+
+  void run(const RowSource &left, const RowSource &right, size_t depth) {
+    if (run_in_memory(left, right)) {
+      return;
     }
+    if (depth >= kMaxSetOperationDepth) {
+      throw MemoryLimitExceededException(
+          "set operation exceeds memory limit after " +
+          std::to_string(depth) + " partitioning passes");
+    }
+    run_partitioned(left, right, depth);
+  }
 
-    // 处理左结果集
-    for (const auto &row : left.rows) {
-      RowKey key = generate_row_key(row, left.column_metadata);
-      auto it = right_counts.find(key);
-      if (it != right_counts.end() && it->second > 0) {
-        result.rows.push_back(row);
-        it->second--;
+private:
+  // 在内存中完成整个操作；哈希表超出内存限制时放弃并返回false。
+  // 输出先记录在pending中，成功后才写入结果，因此放弃时不会产生重复输出
+  bool run_in_memory(const RowSource &left, const RowSource &right) {
+    RowFingerprintTable table;
+    std::deque<Row> owned;
+    size_t owned_bytes = 0;
+    std::vector<const Row *> pending;
+
+    auto keep = [&](const Row *row, bool stable) -> const Row * {
+      if (stable) {
+        return row;
+      }
+      owned.push_back(*row);
+      owned_bytes += estimate_row_size(*row);
+      return &owned.back();
+    };
+    auto exceeded = [&]() {
+      size_t used = table.memory_used() + owned_bytes;
+      if (stats_) {
+        stats_->memory_used = std::max(stats_->memory_used, used);
+      }
+      return used > memory_limit_;
+    };
+
+    if (op_ == SetOp::UNION) {
+      for (const RowSource *source : {&left, &right}) {
+        RowReader reader = source->open();
+        while (const Row *row = reader()) {
+          uint64_t fingerprint = row_fingerprint(*row);
+          if (table.find(*row, fingerprint)) {
+            continue;
+          }
+          const Row *kept = keep(row, source->stable);
+          table.insert(kept, fingerprint);
+          pending.push_back(kept);
+          if (exceeded()) {
+            return false;
+          }
+        }
+      }
+    } else {
+      // 右侧建表，重复行只增加计数
+      RowReader build = right.open();
+      while (const Row *row = build()) {
+        uint64_t fingerprint = row_fingerprint(*row);
+        if (auto *entry = table.find(*row, fingerprint)) {
+          entry->count++;
+          continue;
+        }
+        table.insert(keep(row, right.stable), fingerprint).count = 1;
+        if (exceeded()) {
+          return false;
+        }
+      }
+
+      RowReader probe = left.open();
+      while (const Row *row = probe()) {
+        uint64_t fingerprint = row_fingerprint(*row);
+        auto *entry = table.find(*row, fingerprint);
+        if (op_ == SetOp::INTERSECT) {
+          if (!entry || entry->count == 0 || (!all_ && entry->emitted)) {
+            continue;
+          }
+          if (all_) {
+            entry->count--;
+          } else {
+            entry->emitted = true;
+          }
+          pending.push_back(keep(row, left.stable));
+        } else if (all_) {
+          if (entry && entry->count > 0) {
+            entry->count--;
+          } else {
+            pending.push_back(keep(row, left.stable));
+          }
+        } else if (!entry) {
+          // EXCEPT DISTINCT：输出过的左侧行也放入表中用于去重
+          const Row *kept = keep(row, left.stable);
+          table.insert(kept, fingerprint).emitted = true;
+          pending.push_back(kept);
+        }
+        if (exceeded()) {
+          return false;
+        }
       }
     }
-  } else {
-    // INTERSECT DISTINCT：去重
-    std::unordered_set<RowKey, RowKey::Hash> right_set;
-    std::unordered_set<RowKey, RowKey::Hash> result_set;
-
-    // 构建右结果集的集合
-    for (const auto &row : right.rows) {
-      RowKey key = generate_row_key(row, right.column_metadata);
-      right_set.insert(key);
+
+    output_.reserve(output_.size() + pending.size());
+    for (const Row *row : pending) {
+      output_.push_back(*row);
     }
+    return true;
+  }
 
-    // 处理左结果集
-    for (const auto &row : left.rows) {
-      RowKey key = generate_row_key(row, left.column_metadata);
-      if (right_set.count(key) > 0 && result_set.insert(key).second) {
-        result.rows.push_back(row);
+  // 按指纹把两侧输入分区写入磁盘，相同的行一定落在同一分区
+  void run_partitioned(const RowSource &left, const RowSource &right,
+                       size_t depth) {
+    std::vector<std::unique_ptr<SpillFile>> left_parts;
+    std::vector<std::unique_ptr<SpillFile>> right_parts;
+    for (size_t i = 0; i < kSetOperationFanout; ++i) {
+      left_parts.push_back(std::make_unique<SpillFile>());
+      right_parts.push_back(std::make_unique<SpillFile>());
+    }
+    auto scatter = [depth](const RowSource &source,
+                           std::vector<std::unique_ptr<SpillFile>> &parts) {
+      RowReader reader = source.open();
+      while (const Row *row = reader()) {
+        parts[partition_of(row_fingerprint(*row), depth)]->append(*row);
+      }
+    };
+    scatter(left, left_parts);
+    scatter(right, right_parts);
+
+    for (size_t i = 0; i < kSetOperationFanout; ++i) {
+      SpillFile *left_file = left_parts[i].get();
+      SpillFile *right_file = right_parts[i].get();
+      bool needs_right = op_ == SetOp::UNION;
+      if (left_file->row_count() == 0 &&
+          (!needs_right || right_file->row_count() == 0)) {
+        continue;
+      }
+      run({[left_file]() { return left_file->reader(); }, false},
+          {[right_file]() { return right_file->reader(); }, false},
+          depth + 1);
+      if (stats_) {
+        stats_->spilled_partitions++;
+        stats_->spilled_bytes +=
+            left_file->bytes_written() + right_file->bytes_written();
       }
+      // 处理完的分区立即删除临时文件
+      left_parts[i].reset();
+      right_parts[i].reset();
     }
   }
 
+  SetOp op_;
+  bool all_;
+  size_t memory_limit_;
+  ExecutionStats *stats_;
+  std::vector<Row> &output_;
+};
+
+ExecutionResult run_set_operation(SetOp op, bool all,
+                                  const ExecutionResult &left,
+                                  const ExecutionResult &right,
+                                  size_t memory_limit, ExecutionStats *stats) {
+  ExecutionResult result;
+  result.column_metadata = left.column_metadata;
+  SetOperationRunner runner(op, all, memory_limit, stats, result.rows);
+  runner.run({[&left]() { return make_row_reader(left.rows); }, true},
+             {[&right]() { return make_row_reader(right.rows); }, true}, 0);
   return result;
 }
 
-ExecutionResult ResultSetCombiner::except(const ExecutionResult &left,
-                                          const ExecutionResult &right,
-                                          bool all) {
+} // namespace
+
+// ResultSetCombiner 实现
+ExecutionResult ResultSetCombiner::union_all(const ExecutionResult &left,
+                                             const ExecutionResult &right) {
   ExecutionResult result;
-  result.column_metadata = left.column_metadata;
 
-  if (all) {
-    // EXCEPT ALL：保留重复
-    std::unordered_map<RowKey, size_t, RowKey::Hash> right_counts;
+  // 复制列元数据（使用左结果集的元数据）
+  result.column_metadata = left.column_metadata;
 
-    // 统计右结果集中每行的出现次数
-    for (const auto &row : right.rows) {
-      RowKey key = generate_row_key(row, right.column_metadata);
-      right_counts[key]++;
-    }
+  // 预分配内存以提高性能
+  result.rows.reserve(left.rows.size() + right.rows.size());
 
-    // 处理左结果集
-    for (const auto &row : left.rows) {
-      RowKey key = generate_row_key(row, left.column_metadata);
-      auto it = right_counts.find(key);
-      if (it == right_counts.end() || it->second == 0) {
-        result.rows.push_back(row);
-      } else {
-        it->second--;
-      }
-    }
-  } else {
-    // EXCEPT DISTINCT：去重
-    std::unordered_set<RowKey, RowKey::Hash> right_set;
-    std::unordered_set<RowKey, RowKey::Hash> result_set;
-
-    // 构建右结果集的集合
-    for (const auto &row : right.rows) {
-      RowKey key = generate_row_key(row, right.column_metadata);
-      right_set.insert(key);
-    }
+  // 添加左结果集的所有行
+  result.rows.insert(result.rows.end(), left.rows.begin(), left.rows.end());
 
-    // 处理左结果集
-    for (const auto &row : left.rows) {
-      RowKey key = generate_row_key(row, left.column_metadata);
-      if (right_set.count(key) == 0 && result_set.insert(key).second) {
-        result.rows.push_back(row);
-      }
-    }
-  }
+  // 添加右结果集的所有行
+  result.rows.insert(result.rows.end(), right.rows.begin(), right.rows.end());
 
   return result;
 }
 
-RowKey ResultSetCombiner::generate_row_key(
-    const Row &row, const std::vector<ColumnMeta> &column_metadata) {
-  RowKey key;
-  key.values.reserve(row.values.size());
+ExecutionResult ResultSetCombiner::union_all(ExecutionResult &&left,
+                                             ExecutionResult &&right) {
+  ExecutionResult result = std::move(left);
+  result.rows.reserve(result.rows.size() + right.rows.size());
+  std::move(right.rows.begin(), right.rows.end(),
+            std::back_inserter(result.rows));
+  right.rows.clear();
+  return result;
+}
 
-  for (size_t i = 0; i < row.values.size(); ++i) {
-    // 这里简化处理，实际实现中需要根据数据类型进行适当的键生成
-    // 对于复杂类型（如BLOB、TEXT等）需要特殊处理
-    key.values.push_back(row.values[i]);
-  }
+ExecutionResult
+ResultSetCombiner::union_distinct(const ExecutionResult &left,
+                                  const ExecutionResult &right,
+                                  size_t memory_limit, ExecutionStats *stats) {
+  return run_set_operation(SetOp::UNION, false, left, right, memory_limit,
+                           stats);
+}
 
-  return key;
+ExecutionResult ResultSetCombiner::intersect(const ExecutionResult &left,
+                                             const ExecutionResult &right,
+                                             bool all, size_t memory_limit,
+                                             ExecutionStats *stats) {
+  return run_set_operation(SetOp::INTERSECT, all, left, right, memory_limit,
+                           stats);
 }
 
-// RowKey::Hash实现
-size_t RowKey::Hash::operator()(const RowKey &key) const {
-  size_t hash = 0;
-  for (const auto &value : key.values) {
-    // 根据Value类型计算哈希值
-    switch (value.type) {
-    case Value::Type::INT:
-      hash_combine(hash, std::hash<int64_t>()(value.int_val));
-      break;
-    case Value::Type::DOUBLE:
-      hash_combine(hash, std::hash<double>()(value.double_val));
-      break;
-    case Value::Type::STRING:
-      hash_combine(hash, std::hash<std::string>()(value.str_val));
-      break;
-    }
-  }
-  return hash;
+ExecutionResult ResultSetCombiner::except(const ExecutionResult &left,
+                                          const ExecutionResult &right,
+                                          bool all, size_t memory_limit,
+                                          ExecutionStats *stats) {
+  return run_set_operation(SetOp::EXCEPT, all, left, right, memory_limit,
+                           stats);
 }
 
 // 辅助函数：哈希组合
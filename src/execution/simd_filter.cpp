@@ -0,0 +1,620 @@
+#include "execution/simd_filter.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SQLCC_SIMD_X86 1
+#include <immintrin.h>
+#define SQLCC_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define SQLCC_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace sqlcc {
+
+namespace {
+
+// ==================== 标量实现 ====================
+
+template <CompareOp Op, typename T>
+inline bool scalar_compare(T value, T constant) {
+  if constexpr (Op == CompareOp::EQ) {
+    return value == constant;
+  } else if constexpr (Op == CompareOp::NE) {
+    return value != constant;
+  } else if constexpr (Op == CompareOp::LT) {
+    return value < constant;
+  } else if constexpr (Op == CompareOp::LE) {
+    return value <= constant;
+  } else if constexpr (Op == CompareOp::GT) {
+    return value > constant;
+  } else {
+    return value >= constant;
+  }
+}
+
+template <CompareOp Op, typename T> struct ScalarCompare {
+  T constant;
+  bool operator()(T value) const {
+    return scalar_compare<Op>(value, constant);
+  }
+};
+
+template <typename T> struct ScalarBetween {
+  T low;
+  T high;
+  bool operator()(T value) const { return value >= low && value <= high; }
+};
+
+// 短列表顺序比较
+template <typename T> struct ScalarInList {
+  const T *list;
+  size_t list_size;
+  bool operator()(T value) const {
+    for (size_t k = 0; k < list_size; ++k) {
+      if (value == list[k]) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// 长列表排序后二分查找
+template <typename T> struct ScalarSortedInList {
+  const std::vector<T> *sorted;
+  bool operator()(T value) const {
+    // 用==确认命中：NaN与任何值都不满足<，binary_search会误判为相等
+    auto it = std::lower_bound(sorted->begin(), sorted->end(), value);
+    return it != sorted->end() && *it == value;
+  }
+};
+
+// 逐个64行的字填充位图，Predicate为标量判定
+template <typename T, typename Predicate>
+void scalar_fill(const T *values, size_t count, const Predicate &predicate,
+                 uint64_t *mask) {
+  size_t words = bitmap_words(count);
+  for (size_t w = 0; w < words; ++w) {
+    size_t begin = w * 64;
+    size_t end = std::min(begin + 64, count);
+    uint64_t bits = 0;
+    for (size_t i = begin; i < end; ++i) {
+      bits |= uint64_t(predicate(values[i])) << (i - begin);
+    }
+    mask[w] = bits;
+  }
+}
+
+#ifdef SQLCC_SIMD_X86
+
+// ==================== SSE4.2实现（每次2个64位值） ====================
+
+template <CompareOp Op> struct Sse42CompareInt {
+  static constexpr size_t kLanes = 2;
+  __m128i constant;
+  int64_t scalar;
+  SQLCC_TARGET_SSE42 explicit Sse42CompareInt(int64_t value)
+      : constant(_mm_set1_epi64x(value)), scalar(value) {}
+  SQLCC_TARGET_SSE42 int lanes(const int64_t *values) const {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    int bits;
+    if constexpr (Op == CompareOp::EQ || Op == CompareOp::NE) {
+      bits = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(v, constant)));
+    } else if constexpr (Op == CompareOp::LT || Op == CompareOp::GE) {
+      bits = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(constant, v)));
+    } else {
+      bits = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(v, constant)));
+    }
+    if constexpr (Op == CompareOp::NE || Op == CompareOp::GE ||
+                  Op == CompareOp::LE) {
+      bits ^= 0x3;
+    }
+    return bits;
+  }
+  bool operator()(int64_t value) const {
+    return scalar_compare<Op>(value, scalar);
+  }
+};
+
+template <CompareOp Op> struct Sse42CompareDouble {
+  static constexpr size_t kLanes = 2;
+  __m128d constant;
+  double scalar;
+  SQLCC_TARGET_SSE42 explicit Sse42CompareDouble(double value)
+      : constant(_mm_set1_pd(value)), scalar(value) {}
+  SQLCC_TARGET_SSE42 int lanes(const double *values) const {
+    __m128d v = _mm_loadu_pd(values);
+    if constexpr (Op == CompareOp::EQ) {
+      return _mm_movemask_pd(_mm_cmpeq_pd(v, constant));
+    } else if constexpr (Op == CompareOp::NE) {
+      return _mm_movemask_pd(_mm_cmpneq_pd(v, constant));
+    } else if constexpr (Op == CompareOp::LT) {
+      return _mm_movemask_pd(_mm_cmplt_pd(v, constant));
+    } else if constexpr (Op == CompareOp::LE) {
+      return _mm_movemask_pd(_mm_cmple_pd(v, constant));
+    } else if constexpr (Op == CompareOp::GT) {
+      return _mm_movemask_pd(_mm_cmpgt_pd(v, constant));
+    } else {
+      return _mm_movemask_pd(_mm_cmpge_pd(v, constant));
+    }
+  }
+  bool operator()(double value) const {
+    return scalar_compare<Op>(value, scalar);
+  }
+};
+
+struct Sse42BetweenInt {
+  static constexpr size_t kLanes = 2;
+  __m128i low;
+  __m128i high;
+  ScalarBetween<int64_t> scalar;
+  SQLCC_TARGET_SSE42 Sse42BetweenInt(int64_t low_value, int64_t high_value)
+      : low(_mm_set1_epi64x(low_value)), high(_mm_set1_epi64x(high_value)),
+        scalar{low_value, high_value} {}
+  SQLCC_TARGET_SSE42 int lanes(const int64_t *values) const {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    __m128i outside =
+        _mm_or_si128(_mm_cmpgt_epi64(low, v), _mm_cmpgt_epi64(v, high));
+    return _mm_movemask_pd(_mm_castsi128_pd(outside)) ^ 0x3;
+  }
+  bool operator()(int64_t value) const { return scalar(value); }
+};
+
+struct Sse42BetweenDouble {
+  static constexpr size_t kLanes = 2;
+  __m128d low;
+  __m128d high;
+  ScalarBetween<double> scalar;
+  SQLCC_TARGET_SSE42 Sse42BetweenDouble(double low_value, double high_value)
+      : low(_mm_set1_pd(low_value)), high(_mm_set1_pd(high_value)),
+        scalar{low_value, high_value} {}
+  SQLCC_TARGET_SSE42 int lanes(const double *values) const {
+    __m128d v = _mm_loadu_pd(values);
+    return _mm_movemask_pd(
+        _mm_and_pd(_mm_cmpge_pd(v, low), _mm_cmple_pd(v, high)));
+  }
+  bool operator()(double value) const { return scalar(value); }
+};
+
+struct Sse42InListInt {
+  static constexpr size_t kLanes = 2;
+  ScalarInList<int64_t> scalar;
+  SQLCC_TARGET_SSE42 int lanes(const int64_t *values) const {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    __m128i hit = _mm_setzero_si128();
+    for (size_t k = 0; k < scalar.list_size; ++k) {
+      hit = _mm_or_si128(hit,
+                         _mm_cmpeq_epi64(v, _mm_set1_epi64x(scalar.list[k])));
+    }
+    return _mm_movemask_pd(_mm_castsi128_pd(hit));
+  }
+  bool operator()(int64_t value) const { return scalar(value); }
+};
+
+struct Sse42InListDouble {
+  static constexpr size_t kLanes = 2;
+  ScalarInList<double> scalar;
+  SQLCC_TARGET_SSE42 int lanes(const double *values) const {
+    __m128d v = _mm_loadu_pd(values);
+    __m128d hit = _mm_setzero_pd();
+    for (size_t k = 0; k < scalar.list_size; ++k) {
+      hit = _mm_or_pd(hit, _mm_cmpeq_pd(v, _mm_set1_pd(scalar.list[k])));
+    }
+    return _mm_movemask_pd(hit);
+  }
+  bool operator()(double value) const { return scalar(value); }
+};
+
+// ==================== AVX2实现（每次4个64位值） ====================
+
+template <CompareOp Op> struct Avx2CompareInt {
+  static constexpr size_t kLanes = 4;
+  __m256i constant;
+  int64_t scalar;
+  SQLCC_TARGET_AVX2 explicit Avx2CompareInt(int64_t value)
+      : constant(_mm256_set1_epi64x(value)), scalar(value) {}
+  SQLCC_TARGET_AVX2 int lanes(const int64_t *values) const {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    int bits;
+    if constexpr (Op == CompareOp::EQ || Op == CompareOp::NE) {
+      bits = _mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_cmpeq_epi64(v, constant)));
+    } else if constexpr (Op == CompareOp::LT || Op == CompareOp::GE) {
+      bits = _mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_cmpgt_epi64(constant, v)));
+    } else {
+      bits = _mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_cmpgt_epi64(v, constant)));
+    }
+    if constexpr (Op == CompareOp::NE || Op == CompareOp::GE ||
+                  Op == CompareOp::LE) {
+      bits ^= 0xF;
+    }
+    return bits;
+  }
+  bool operator()(int64_t value) const {
+    return scalar_compare<Op>(value, scalar);
+  }
+};
+
+template <CompareOp Op> struct Avx2CompareDouble {
+  static constexpr size_t kLanes = 4;
+  __m256d constant;
+  double scalar;
+  SQLCC_TARGET_AVX2 explicit Avx2CompareDouble(double value)
+      : constant(_mm256_set1_pd(value)), scalar(value) {}
+  SQLCC_TARGET_AVX2 int lanes(const double *values) const {
+    __m256d v = _mm256_loadu_pd(values);
+    // 有序比较：NaN只满足<>，与C++比较运算符一致
+    if constexpr (Op == CompareOp::EQ) {
+      return _mm256_movemask_pd(_mm256_cmp_pd(v, constant, _CMP_EQ_OQ));
+    } else if constexpr (Op == CompareOp::NE) {
+      return _mm256_movemask_pd(_mm256_cmp_pd(v, constant, _CMP_NEQ_UQ));
+    } else if constexpr (Op == CompareOp::LT) {
+      return _mm256_movemask_pd(_mm256_cmp_pd(v, constant, _CMP_LT_OQ));
+    } else if constexpr (Op == CompareOp::LE) {
+      return _mm256_movemask_pd(_mm256_cmp_pd(v, constant, _CMP_LE_OQ));
+    } else if constexpr (Op == CompareOp::GT) {
+      return _mm256_movemask_pd(_mm256_cmp_pd(v, constant, _CMP_GT_OQ));
+    } else {
+      return _mm256_movemask_pd(_mm256_cmp_pd(v, constant, _CMP_GE_OQ));
+    }
+  }
+  bool operator()(double value) const {
+    return scalar_compare<Op>(value, scalar);
+  }
+};
+
+struct Avx2BetweenInt {
+  static constexpr size_t kLanes = 4;
+  __m256i low;
+  __m256i high;
+  ScalarBetween<int64_t> scalar;
+  SQLCC_TARGET_AVX2 Avx2BetweenInt(int64_t low_value, int64_t high_value)
+      : low(_mm256_set1_epi64x(low_value)),
+        high(_mm256_set1_epi64x(high_value)), scalar{low_value, high_value} {}
+  SQLCC_TARGET_AVX2 int lanes(const int64_t *values) const {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    __m256i outside =
+        _mm256_or_si256(_mm256_cmpgt_epi64(low, v), _mm256_cmpgt_epi64(v, high));
+    return _mm256_movemask_pd(_mm256_castsi256_pd(outside)) ^ 0xF;
+  }
+  bool operator()(int64_t value) const { return scalar(value); }
+};
+
+struct Avx2BetweenDouble {
+  static constexpr size_t kLanes = 4;
+  __m256d low;
+  __m256d high;
+  ScalarBetween<double> scalar;
+  SQLCC_TARGET_AVX2 Avx2BetweenDouble(double low_value, double high_value)
+      : low(_mm256_set1_pd(low_value)), high(_mm256_set1_pd(high_value)),
+        scalar{low_value, high_value} {}
+  SQLCC_TARGET_AVX2 int lanes(const double *values) const {
+    __m256d v = _mm256_loadu_pd(values);
+    return _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(v, low, _CMP_GE_OQ),
+                                            _mm256_cmp_pd(v, high, _CMP_LE_OQ)));
+  }
+  bool operator()(double value) const { return scalar(value); }
+};
+
+struct Avx2InListInt {
+  static constexpr size_t kLanes = 4;
+  ScalarInList<int64_t> scalar;
+  SQLCC_TARGET_AVX2 int lanes(const int64_t *values) const {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    __m256i hit = _mm256_setzero_si256();
+    for (size_t k = 0; k < scalar.list_size; ++k) {
+      hit = _mm256_or_si256(
+          hit, _mm256_cmpeq_epi64(v, _mm256_set1_epi64x(scalar.list[k])));
+    }
+    return _mm256_movemask_pd(_mm256_castsi256_pd(hit));
+  }
+  bool operator()(int64_t value) const { return scalar(value); }
+};
+
+struct Avx2InListDouble {
+  static constexpr size_t kLanes = 4;
+  ScalarInList<double> scalar;
+  SQLCC_TARGET_AVX2 int lanes(const double *values) const {
+    __m256d v = _mm256_loadu_pd(values);
+    __m256d hit = _mm256_setzero_pd();
+    for (size_t k = 0; k < scalar.list_size; ++k) {
+      hit = _mm256_or_pd(
+          hit, _mm256_cmp_pd(v, _mm256_set1_pd(scalar.list[k]), _CMP_EQ_OQ));
+    }
+    return _mm256_movemask_pd(hit);
+  }
+  bool operator()(double value) const { return scalar(value); }
+};
+
+// 向量化填充：每个64位字内按kLanes批量比较，字末不足一个向量的部分用标量
+template <typename T, typename Kernel>
+SQLCC_TARGET_SSE42 void sse42_fill(const T *values, size_t count,
+                                   const Kernel &kernel, uint64_t *mask) {
+  size_t words = bitmap_words(count);
+  for (size_t w = 0; w < words; ++w) {
+    size_t begin = w * 64;
+    size_t end = std::min(begin + 64, count);
+    uint64_t bits = 0;
+    size_t i = begin;
+    for (; i + Kernel::kLanes <= end; i += Kernel::kLanes) {
+      bits |= uint64_t(kernel.lanes(values + i)) << (i - begin);
+    }
+    for (; i < end; ++i) {
+      bits |= uint64_t(kernel(values[i])) << (i - begin);
+    }
+    mask[w] = bits;
+  }
+}
+
+template <typename T, typename Kernel>
+SQLCC_TARGET_AVX2 void avx2_fill(const T *values, size_t count,
+                                 const Kernel &kernel, uint64_t *mask) {
+  size_t words = bitmap_words(count);
+  for (size_t w = 0; w < words; ++w) {
+    size_t begin = w * 64;
+    size_t end = std::min(begin + 64, count);
+    uint64_t bits = 0;
+    size_t i = begin;
+    for (; i + Kernel::kLanes <= end; i += Kernel::kLanes) {
+      bits |= uint64_t(kernel.lanes(values + i)) << (i - begin);
+    }
+    for (; i < end; ++i) {
+      bits |= uint64_t(kernel(values[i])) << (i - begin);
+    }
+    mask[w] = bits;
+  }
+}
+
+#endif // SQLCC_SIMD_X86
+
+SimdLevel probe_simd_level() {
+#ifdef SQLCC_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return SimdLevel::SSE42;
+  }
+#endif
+  return SimdLevel::SCALAR;
+}
+
+std::atomic<SimdLevel> &current_level() {
+  static std::atomic<SimdLevel> level(detect_simd_level());
+  return level;
+}
+
+// 不支持的级别一律退回标量
+SimdLevel usable(SimdLevel level) {
+  return std::min(level, detect_simd_level());
+}
+
+template <typename T, CompareOp Op>
+void compare_mask_op(const T *values, size_t count, T constant, uint64_t *mask,
+                     SimdLevel level) {
+#ifdef SQLCC_SIMD_X86
+  if constexpr (std::is_same_v<T, int64_t>) {
+    if (level == SimdLevel::AVX2) {
+      avx2_fill(values, count, Avx2CompareInt<Op>(constant), mask);
+      return;
+    }
+    if (level == SimdLevel::SSE42) {
+      sse42_fill(values, count, Sse42CompareInt<Op>(constant), mask);
+      return;
+    }
+  } else {
+    if (level == SimdLevel::AVX2) {
+      avx2_fill(values, count, Avx2CompareDouble<Op>(constant), mask);
+      return;
+    }
+    if (level == SimdLevel::SSE42) {
+      sse42_fill(values, count, Sse42CompareDouble<Op>(constant), mask);
+      return;
+    }
+  }
+#else
+  (void)level;
+#endif
+  scalar_fill(values, count, ScalarCompare<Op, T>{constant}, mask);
+}
+
+template <typename T>
+void compare_mask_impl(const T *values, size_t count, CompareOp op, T constant,
+                       uint64_t *mask, SimdLevel level) {
+  level = usable(level);
+  switch (op) {
+  case CompareOp::EQ:
+    return compare_mask_op<T, CompareOp::EQ>(values, count, constant, mask,
+                                             level);
+  case CompareOp::NE:
+    return compare_mask_op<T, CompareOp::NE>(values, count, constant, mask,
+                                             level);
+  case CompareOp::LT:
+    return compare_mask_op<T, CompareOp::LT>(values, count, constant, mask,
+                                             level);
+  case CompareOp::LE:
+    return compare_mask_op<T, CompareOp::LE>(values, count, constant, mask,
+                                             level);
+  case CompareOp::GT:
+    return compare_mask_op<T, CompareOp::GT>(values, count, constant, mask,
+                                             level);
+  case CompareOp::GE:
+    return compare_mask_op<T, CompareOp::GE>(values, count, constant, mask,
+                                             level);
+  }
+}
+
+// 超过该长度的IN列表改为排序后二分查找
+constexpr size_t kLinearInListLimit = 16;
+
+} // namespace
+
+SimdLevel detect_simd_level() {
+  static const SimdLevel level = probe_simd_level();
+  return level;
+}
+
+SimdLevel active_simd_level() {
+  return current_level().load(std::memory_order_relaxed);
+}
+
+SimdLevel set_simd_level(SimdLevel level) {
+  level = usable(level);
+  current_level().store(level, std::memory_order_relaxed);
+  return level;
+}
+
+const char *simd_level_name(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::AVX2:
+    return "AVX2";
+  case SimdLevel::SSE42:
+    return "SSE4.2";
+  default:
+    return "SCALAR";
+  }
+}
+
+void compare_mask(const int64_t *values, size_t count, CompareOp op,
+                  int64_t constant, uint64_t *mask, SimdLevel level) {
+  compare_mask_impl(values, count, op, constant, mask, level);
+}
+
+void compare_mask(const double *values, size_t count, CompareOp op,
+                  double constant, uint64_t *mask, SimdLevel level) {
+  compare_mask_impl(values, count, op, constant, mask, level);
+}
+
+void between_mask(const int64_t *values, size_t count, int64_t low,
+                  int64_t high, uint64_t *mask, SimdLevel level) {
+  level = usable(level);
+#ifdef SQLCC_SIMD_X86
+  if (level == SimdLevel::AVX2) {
+    avx2_fill(values, count, Avx2BetweenInt(low, high), mask);
+    return;
+  }
+  if (level == SimdLevel::SSE42) {
+    sse42_fill(values, count, Sse42BetweenInt(low, high), mask);
+    return;
+  }
+#endif
+  scalar_fill(values, count, ScalarBetween<int64_t>{low, high}, mask);
+}
+
+void between_mask(const double *values, size_t count, double low, double high,
+                  uint64_t *mask, SimdLevel level) {
+  level = usable(level);
+#ifdef SQLCC_SIMD_X86
+  if (level == SimdLevel::AVX2) {
+    avx2_fill(values, count, Avx2BetweenDouble(low, high), mask);
+    return;
+  }
+  if (level == SimdLevel::SSE42) {
+    sse42_fill(values, count, Sse42BetweenDouble(low, high), mask);
+    return;
+  }
+#endif
+  scalar_fill(values, count, ScalarBetween<double>{low, high}, mask);
+}
+
+void in_list_mask(const int64_t *values, size_t count, const int64_t *list,
+                  size_t list_size, uint64_t *mask, SimdLevel level) {
+  level = usable(level);
+  if (list_size > kLinearInListLimit) {
+    std::vector<int64_t> sorted(list, list + list_size);
+    std::sort(sorted.begin(), sorted.end());
+    scalar_fill(values, count, ScalarSortedInList<int64_t>{&sorted}, mask);
+    return;
+  }
+  ScalarInList<int64_t> scalar{list, list_size};
+#ifdef SQLCC_SIMD_X86
+  if (level == SimdLevel::AVX2) {
+    avx2_fill(values, count, Avx2InListInt{scalar}, mask);
+    return;
+  }
+  if (level == SimdLevel::SSE42) {
+    sse42_fill(values, count, Sse42InListInt{scalar}, mask);
+    return;
+  }
+#endif
+  scalar_fill(values, count, scalar, mask);
+}
+
+void in_list_mask(const double *values, size_t count, const double *list,
+                  size_t list_size, uint64_t *mask, SimdLevel level) {
+  level = usable(level);
+  if (list_size > kLinearInListLimit) {
+    // NaN不等于任何值，排序前去掉
+    std::vector<double> sorted;
+    for (size_t k = 0; k < list_size; ++k) {
+      if (!std::isnan(list[k])) {
+        sorted.push_back(list[k]);
+      }
+    }
+    std::sort(sorted.begin(), sorted.end());
+    scalar_fill(values, count, ScalarSortedInList<double>{&sorted}, mask);
+    return;
+  }
+  ScalarInList<double> scalar{list, list_size};
+#ifdef SQLCC_SIMD_X86
+  if (level == SimdLevel::AVX2) {
+    avx2_fill(values, count, Avx2InListDouble{scalar}, mask);
+    return;
+  }
+  if (level == SimdLevel::SSE42) {
+    sse42_fill(values, count, Sse42InListDouble{scalar}, mask);
+    return;
+  }
+#endif
+  scalar_fill(values, count, scalar, mask);
+}
+
+void bitmap_and(uint64_t *mask, const uint64_t *other, size_t count) {
+  size_t words = bitmap_words(count);
+  for (size_t w = 0; w < words; ++w) {
+    mask[w] &= other[w];
+  }
+}
+
+void bitmap_or(uint64_t *mask, const uint64_t *other, size_t count) {
+  size_t words = bitmap_words(count);
+  for (size_t w = 0; w < words; ++w) {
+    mask[w] |= other[w];
+  }
+}
+
+void bitmap_not(uint64_t *mask, size_t count) {
+  size_t words = bitmap_words(count);
+  for (size_t w = 0; w < words; ++w) {
+    mask[w] = ~mask[w];
+  }
+  if (count % 64 != 0) {
+    mask[words - 1] &= (uint64_t(1) << (count % 64)) - 1;
+  }
+}
+
+size_t mask_to_selection(const uint64_t *mask, size_t count,
+                         SelectionVector &selection) {
+  // 先按最大可能大小分配，循环内不做容量检查
+  selection.resize(count);
+  uint32_t *out = selection.data();
+  size_t selected = 0;
+  size_t words = bitmap_words(count);
+  for (size_t w = 0; w < words; ++w) {
+    uint64_t bits = mask[w];
+    uint32_t base = static_cast<uint32_t>(w * 64);
+    while (bits != 0) {
+      out[selected++] = base + static_cast<uint32_t>(__builtin_ctzll(bits));
+      bits &= bits - 1;
+    }
+  }
+  selection.resize(selected);
+  return selected;
+}
+
+} // namespace sqlcc
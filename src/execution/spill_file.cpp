@@ -0,0 +1,204 @@
+#include "execution/spill_file.h"
+#include "config_manager.h"
+#include "disk_manager.h"
+#include "exception.h"
+#include "page.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <unistd.h>
+
+namespace sqlcc {
+
+namespace {
+
+// 生成进程内唯一的临时文件路径
+std::string make_spill_path() {
+  static std::atomic<uint64_t> counter{0};
+  std::error_code ec;
+  std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+  if (ec) {
+    dir = ".";
+  }
+  return (dir / ("sqlcc_spill_" + std::to_string(::getpid()) + "_" +
+                 std::to_string(counter.fetch_add(1)) + ".tmp"))
+      .string();
+}
+
+template <typename T> void append_pod(std::string &out, T value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> T read_pod(const char *&data) {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  data += sizeof(T);
+  return value;
+}
+
+// 行编码：列数(uint32)，每列为类型(uint8) + 值（字符串为长度(uint32) + 内容）
+void encode_row(const Row &row, std::string &out) {
+  out.clear();
+  append_pod<uint32_t>(out, static_cast<uint32_t>(row.values.size()));
+  for (const auto &value : row.values) {
+    append_pod<uint8_t>(out, static_cast<uint8_t>(value.type));
+    switch (value.type) {
+    case Value::Type::INT:
+      append_pod<int64_t>(out, value.int_val);
+      break;
+    case Value::Type::DOUBLE:
+      append_pod<double>(out, value.double_val);
+      break;
+    case Value::Type::STRING:
+      append_pod<uint32_t>(out, static_cast<uint32_t>(value.str_val.size()));
+      out.append(value.str_val);
+      break;
+    }
+  }
+}
+
+void decode_row(const std::string &in, Row &row) {
+  const char *data = in.data();
+  uint32_t count = read_pod<uint32_t>(data);
+  row.values.resize(count);
+  for (auto &value : row.values) {
+    value.type = static_cast<Value::Type>(read_pod<uint8_t>(data));
+    switch (value.type) {
+    case Value::Type::INT:
+      value.int_val = read_pod<int64_t>(data);
+      value.str_val.clear();
+      break;
+    case Value::Type::DOUBLE:
+      value.double_val = read_pod<double>(data);
+      value.str_val.clear();
+      break;
+    case Value::Type::STRING: {
+      uint32_t length = read_pod<uint32_t>(data);
+      value.str_val.assign(data, length);
+      data += length;
+      break;
+    }
+    }
+  }
+}
+
+} // namespace
+
+RowReader make_row_reader(const std::vector<Row> &rows) {
+  size_t position = 0;
+  return [&rows, position]() mutable -> const Row * {
+    return position < rows.size() ? &rows[position++] : nullptr;
+  };
+}
+
+size_t estimate_row_size(const Row &row) {
+  size_t size = sizeof(Row) + row.values.capacity() * sizeof(Value);
+  for (const auto &value : row.values) {
+    // 短字符串存放在对象内部，不额外分配
+    if (value.str_val.capacity() > 15) {
+      size += value.str_val.capacity() + 1;
+    }
+  }
+  return size;
+}
+
+SpillFile::SpillFile()
+    : path_(make_spill_path()),
+      disk_manager_(std::make_unique<DiskManager>(
+          path_, ConfigManager::GetInstance())),
+      write_page_(PAGE_SIZE), read_page_(PAGE_SIZE) {}
+
+SpillFile::~SpillFile() {
+  disk_manager_.reset();
+  std::error_code ec;
+  std::filesystem::remove(path_, ec);
+}
+
+void SpillFile::append(const Row &row) {
+  encode_row(row, buffer_);
+  uint32_t length = static_cast<uint32_t>(buffer_.size());
+  write_bytes(reinterpret_cast<const char *>(&length), sizeof(length));
+  write_bytes(buffer_.data(), buffer_.size());
+  row_count_++;
+  memory_size_ += estimate_row_size(row);
+}
+
+void SpillFile::rewind() {
+  if (write_offset_ > 0) {
+    flush_page();
+  }
+  read_page_index_ = 0;
+  read_offset_ = PAGE_SIZE; // 首次读取时加载第一页
+  rows_read_ = 0;
+}
+
+const Row *SpillFile::read() {
+  if (rows_read_ >= row_count_) {
+    return nullptr;
+  }
+  uint32_t length = 0;
+  if (!read_bytes(reinterpret_cast<char *>(&length), sizeof(length))) {
+    return nullptr;
+  }
+  buffer_.resize(length);
+  if (!read_bytes(&buffer_[0], length)) {
+    return nullptr;
+  }
+  decode_row(buffer_, current_);
+  rows_read_++;
+  return &current_;
+}
+
+RowReader SpillFile::reader() {
+  rewind();
+  return [this]() { return read(); };
+}
+
+void SpillFile::write_bytes(const char *data, size_t size) {
+  while (size > 0) {
+    size_t chunk = std::min(size, PAGE_SIZE - write_offset_);
+    std::memcpy(write_page_.data() + write_offset_, data, chunk);
+    write_offset_ += chunk;
+    data += chunk;
+    size -= chunk;
+    if (write_offset_ == PAGE_SIZE) {
+      flush_page();
+    }
+  }
+}
+
+bool SpillFile::read_bytes(char *data, size_t size) {
+  while (size > 0) {
+    if (read_offset_ == PAGE_SIZE) {
+      if (read_page_index_ >= pages_.size()) {
+        return false;
+      }
+      if (!disk_manager_->ReadPage(pages_[read_page_index_],
+                                   read_page_.data())) {
+        throw IOException("Failed to read spill page from " + path_);
+      }
+      read_page_index_++;
+      read_offset_ = 0;
+    }
+    size_t chunk = std::min(size, PAGE_SIZE - read_offset_);
+    std::memcpy(data, read_page_.data() + read_offset_, chunk);
+    read_offset_ += chunk;
+    data += chunk;
+    size -= chunk;
+  }
+  return true;
+}
+
+void SpillFile::flush_page() {
+  int32_t page_id = disk_manager_->AllocatePage();
+  if (!disk_manager_->WritePage(page_id, write_page_.data())) {
+    throw IOException("Failed to write spill page to " + path_);
+  }
+  pages_.push_back(page_id);
+  bytes_written_ += PAGE_SIZE;
+  write_offset_ = 0;
+}
+
+} // namespace sqlcc
@@ -0,0 +1,761 @@
+#include "execution/statistics.h"
+#include "exception.h"
+#include "execution/parallel_scan.h"
+#include "execution/physical_operator.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+
+namespace sqlcc {
+
+namespace {
+
+// 采样ANALYZE时每个morsel包含的页数
+constexpr size_t kAnalyzePagesPerMorsel = 16;
+
+// splitmix64终结函数：hash_value对整数是恒等映射，HyperLogLog需要均匀的64位哈希
+uint64_t mix64(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+std::string trim(const std::string &text) {
+  size_t begin = text.find_first_not_of(" \t\n\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = text.find_last_not_of(" \t\n\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+std::string to_upper(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+  return text;
+}
+
+bool is_numeric_type(const std::string &data_type) {
+  return !data_type.empty() &&
+         parse_value("0", data_type).type != Value::Type::STRING;
+}
+
+bool is_null_value(const Value &value, const std::string &data_type) {
+  if (value.type != Value::Type::STRING) {
+    return false;
+  }
+  // 数值列中无法解析为数值的值（包括空值）按NULL统计
+  return value.str_val.empty() || to_upper(value.str_val) == "NULL" ||
+         is_numeric_type(data_type);
+}
+
+// 与CompiledPredicate相同的常量转换：带引号的为字符串，否则按列类型解析
+Value convert_literal(const std::string &literal, const std::string &data_type) {
+  std::string raw = trim(literal);
+  if (raw.size() >= 2 && (raw.front() == '\'' || raw.front() == '"') &&
+      raw.back() == raw.front()) {
+    return Value(raw.substr(1, raw.size() - 2));
+  }
+  Value constant = parse_value(raw, data_type);
+  if (constant.type == Value::Type::STRING && is_numeric_type(data_type)) {
+    Value number = parse_value(raw, "DOUBLE");
+    if (number.type == Value::Type::DOUBLE) {
+      return number;
+    }
+  }
+  return constant;
+}
+
+std::vector<std::string> split_list(const std::string &text) {
+  std::vector<std::string> items;
+  std::string current;
+  char quote = 0;
+  for (char c : text) {
+    if (quote != 0) {
+      quote = c == quote ? 0 : quote;
+    } else if (c == '\'' || c == '"') {
+      quote = c;
+    } else if (c == ',') {
+      items.push_back(trim(current));
+      current.clear();
+      continue;
+    }
+    current += c;
+  }
+  if (!trim(current).empty() || !items.empty()) {
+    items.push_back(trim(current));
+  }
+  return items;
+}
+
+double numeric(const Value &value) {
+  return value.type == Value::Type::INT ? static_cast<double>(value.int_val)
+                                        : value.double_val;
+}
+
+double clamp_fraction(double fraction) {
+  return std::min(std::max(fraction, 0.0), 1.0);
+}
+
+bool value_less(const Value &left, const Value &right) {
+  return compare_values(left, right) < 0;
+}
+
+// 非NULL行中等于value的比例：出现在多个桶边界上的高频值按跨越的桶数估计
+double equal_fraction(const ColumnStatistics &column, const Value &value) {
+  const auto &bounds = column.histogram;
+  if (bounds.empty()) {
+    return 0.0;
+  }
+  size_t lo = std::lower_bound(bounds.begin(), bounds.end(), value, value_less) -
+              bounds.begin();
+  size_t hi = std::upper_bound(bounds.begin(), bounds.end(), value, value_less) -
+              bounds.begin();
+  if (hi == 0 || lo == bounds.size()) {
+    return 0.0; // 超出[最小值, 最大值]
+  }
+  double fraction = 1.0 / std::max(column.distinct_count, 1.0);
+  size_t buckets = bounds.size() - 1;
+  if (hi - lo > 1 && buckets > 0) {
+    fraction = std::max(fraction, static_cast<double>(hi - lo - 1) / buckets);
+  }
+  return std::min(fraction, 1.0);
+}
+
+} // namespace
+
+// ==================== ColumnStatistics ====================
+
+double ColumnStatistics::fraction_below(const Value &value,
+                                        bool inclusive) const {
+  if (histogram.empty()) {
+    return 0.0;
+  }
+  size_t lo = std::lower_bound(histogram.begin(), histogram.end(), value,
+                               value_less) -
+              histogram.begin();
+  size_t hi = std::upper_bound(histogram.begin(), histogram.end(), value,
+                               value_less) -
+              histogram.begin();
+  size_t buckets = histogram.size() - 1;
+
+  // 先估计不大于value的比例，再减去等于value的部分
+  double at_most;
+  if (hi == 0) {
+    at_most = 0.0;
+  } else if (lo == histogram.size() || buckets == 0) {
+    at_most = 1.0;
+  } else if (hi > lo) {
+    // value恰好是桶边界
+    at_most = std::max(static_cast<double>(hi - 1) / buckets,
+                       equal_fraction(*this, value));
+  } else {
+    // histogram[lo - 1] < value < histogram[lo]，数值在桶内线性插值
+    const Value &low = histogram[lo - 1];
+    const Value &high = histogram[lo];
+    double position = 0.5;
+    if (value.type != Value::Type::STRING && low.type != Value::Type::STRING &&
+        high.type != Value::Type::STRING && numeric(high) > numeric(low)) {
+      position = (numeric(value) - numeric(low)) / (numeric(high) - numeric(low));
+    }
+    at_most = (static_cast<double>(lo - 1) + position) / buckets;
+  }
+  if (!inclusive) {
+    at_most -= equal_fraction(*this, value);
+  }
+  return clamp_fraction(at_most);
+}
+
+double ColumnStatistics::selectivity(const std::string &op,
+                                     const std::string &literal) const {
+  std::string keyword = to_upper(trim(op));
+  bool negated = keyword.rfind("NOT ", 0) == 0;
+  if (negated) {
+    keyword = trim(keyword.substr(4));
+  }
+  double non_null = 1.0 - null_fraction;
+
+  double fraction;
+  if (keyword == "BETWEEN") {
+    size_t and_pos = to_upper(literal).find(" AND ");
+    if (and_pos == std::string::npos) {
+      return default_selectivity(op);
+    }
+    Value low = convert_literal(literal.substr(0, and_pos), data_type);
+    Value high = convert_literal(literal.substr(and_pos + 5), data_type);
+    fraction = fraction_below(high, true) - fraction_below(low, false);
+  } else if (keyword == "IN") {
+    std::string list = trim(literal);
+    if (list.size() >= 2 && list.front() == '(' && list.back() == ')') {
+      list = list.substr(1, list.size() - 2);
+    }
+    fraction = 0.0;
+    for (const auto &item : split_list(list)) {
+      fraction += equal_fraction(*this, convert_literal(item, data_type));
+    }
+  } else if (negated) {
+    return default_selectivity(op);
+  } else {
+    Value value = convert_literal(literal, data_type);
+    if (keyword == "=") {
+      fraction = equal_fraction(*this, value);
+    } else if (keyword == "<>" || keyword == "!=") {
+      fraction = 1.0 - equal_fraction(*this, value);
+    } else if (keyword == "<") {
+      fraction = fraction_below(value, false);
+    } else if (keyword == "<=") {
+      fraction = fraction_below(value, true);
+    } else if (keyword == ">") {
+      fraction = 1.0 - fraction_below(value, true);
+    } else if (keyword == ">=") {
+      fraction = 1.0 - fraction_below(value, false);
+    } else {
+      return default_selectivity(op);
+    }
+  }
+
+  fraction = clamp_fraction(fraction);
+  if (negated) {
+    fraction = 1.0 - fraction;
+  }
+  return non_null * fraction;
+}
+
+// ==================== TableStatistics ====================
+
+const ColumnStatistics *TableStatistics::column(const std::string &name) const {
+  auto find = [this](const std::string &column_name) -> const ColumnStatistics * {
+    for (const auto &column : columns) {
+      if (column.column_name == column_name) {
+        return &column;
+      }
+    }
+    return nullptr;
+  };
+  const ColumnStatistics *result = find(name);
+  size_t dot = name.find('.');
+  if (!result && dot != std::string::npos) {
+    result = find(name.substr(dot + 1));
+  }
+  return result;
+}
+
+double TableStatistics::selectivity(const std::string &column_name,
+                                    const std::string &op,
+                                    const std::string &literal) const {
+  const ColumnStatistics *statistics = column(column_name);
+  if (!statistics) {
+    return default_selectivity(op);
+  }
+  return statistics->selectivity(op, literal);
+}
+
+double default_selectivity(const std::string &op) {
+  std::string keyword = to_upper(trim(op));
+  if (keyword.rfind("NOT ", 0) == 0) {
+    return 1.0 - default_selectivity(keyword.substr(4));
+  }
+  if (keyword == "=") {
+    return 0.005;
+  } else if (keyword == "<>" || keyword == "!=") {
+    return 0.995;
+  } else if (keyword == "IN") {
+    return 0.05;
+  } else if (keyword == "BETWEEN") {
+    return 0.25;
+  }
+  return 1.0 / 3.0; // 范围比较及其他操作符
+}
+
+// ==================== HyperLogLog ====================
+
+HyperLogLog::HyperLogLog(uint8_t precision)
+    : precision_(std::min<uint8_t>(std::max<uint8_t>(precision, 4), 18)),
+      registers_(size_t(1) << precision_, 0) {}
+
+void HyperLogLog::add(const Value &value) {
+  add_hash(mix64(static_cast<uint64_t>(hash_value(value))));
+}
+
+void HyperLogLog::add_hash(uint64_t hash) {
+  size_t index = hash & (registers_.size() - 1);
+  uint64_t rest = hash >> precision_;
+  uint8_t max_rank = static_cast<uint8_t>(64 - precision_ + 1);
+  uint8_t rank = rest == 0
+                     ? max_rank
+                     : static_cast<uint8_t>(__builtin_ctzll(rest) + 1);
+  registers_[index] = std::max(registers_[index], std::min(rank, max_rank));
+}
+
+void HyperLogLog::merge(const HyperLogLog &other) {
+  if (other.precision_ != precision_) {
+    throw Exception("Cannot merge HyperLogLog sketches of different precision");
+  }
+  for (size_t i = 0; i < registers_.size(); ++i) {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+}
+
+double HyperLogLog::estimate() const {
+  double m = static_cast<double>(registers_.size());
+  double sum = 0.0;
+  size_t zeros = 0;
+  for (uint8_t rank : registers_) {
+    sum += std::ldexp(1.0, -rank);
+    zeros += rank == 0;
+  }
+  double alpha = 0.7213 / (1.0 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+  // 基数较小时原始估计偏高，改用空寄存器比例的线性计数
+  if (estimate <= 2.5 * m && zeros > 0) {
+    estimate = m * std::log(m / static_cast<double>(zeros));
+  }
+  return estimate;
+}
+
+// ==================== ReservoirSample ====================
+
+ReservoirSample::ReservoirSample(size_t capacity, uint64_t seed)
+    : capacity_(std::max<size_t>(capacity, 1)), state_(seed) {}
+
+uint64_t ReservoirSample::next_random() {
+  state_ += 0x9e3779b97f4a7c15ULL;
+  return mix64(state_);
+}
+
+void ReservoirSample::add(const Row &row) {
+  ++seen_;
+  if (rows_.size() < capacity_) {
+    rows_.push_back(row);
+    return;
+  }
+  uint64_t slot = next_random() % seen_;
+  if (slot < capacity_) {
+    rows_[slot] = row;
+  }
+}
+
+void ReservoirSample::merge(ReservoirSample &&other) {
+  size_t total = seen_ + other.seen_;
+  if (rows_.size() + other.rows_.size() <= capacity_ && complete() &&
+      other.complete()) {
+    std::move(other.rows_.begin(), other.rows_.end(),
+              std::back_inserter(rows_));
+    seen_ = total;
+    return;
+  }
+
+  // 两个样本各自打乱后按剩余行数加权逐个抽取（不放回），
+  // 每个样本中的一行代表 读取行数/样本行数 行
+  auto shuffle = [this](std::vector<Row> &rows) {
+    for (size_t i = rows.size(); i > 1; --i) {
+      std::swap(rows[i - 1], rows[next_random() % i]);
+    }
+  };
+  shuffle(rows_);
+  shuffle(other.rows_);
+  std::vector<Row> merged;
+  size_t target = std::min(capacity_, rows_.size() + other.rows_.size());
+  merged.reserve(target);
+  size_t a = 0, b = 0;
+  uint64_t weight_a = seen_, weight_b = other.seen_;
+  while (merged.size() < target) {
+    bool take_a;
+    if (a == rows_.size()) {
+      take_a = false;
+    } else if (b == other.rows_.size()) {
+      take_a = true;
+    } else {
+      take_a = next_random() % (weight_a + weight_b) < weight_a;
+    }
+    if (take_a) {
+      merged.push_back(std::move(rows_[a++]));
+      weight_a -= weight_a > 1 ? 1 : 0;
+    } else {
+      merged.push_back(std::move(other.rows_[b++]));
+      weight_b -= weight_b > 1 ? 1 : 0;
+    }
+  }
+  rows_ = std::move(merged);
+  seen_ = total;
+}
+
+// ==================== 统计信息收集 ====================
+
+StatisticsCollector::StatisticsCollector(std::vector<ColumnMeta> columns,
+                                         const StatisticsOptions &options,
+                                         uint64_t seed)
+    : columns_(std::move(columns)),
+      buckets_(std::max<size_t>(options.buckets, 1)),
+      nulls_(columns_.size(), 0), sketches_(columns_.size()),
+      sample_(options.reservoir_size, seed) {}
+
+void StatisticsCollector::add_row(const Row &row) {
+  ++rows_;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    if (i >= row.values.size() ||
+        is_null_value(row.values[i], columns_[i].data_type)) {
+      ++nulls_[i];
+    } else {
+      sketches_[i].add(row.values[i]);
+    }
+  }
+  sample_.add(row);
+}
+
+void StatisticsCollector::merge(StatisticsCollector &&other) {
+  rows_ += other.rows_;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    nulls_[i] += other.nulls_[i];
+    sketches_[i].merge(other.sketches_[i]);
+  }
+  sample_.merge(std::move(other.sample_));
+}
+
+TableStatistics StatisticsCollector::finish(const std::string &table_name,
+                                            size_t pages_read,
+                                            size_t total_pages) const {
+  TableStatistics statistics;
+  statistics.table_name = table_name;
+  statistics.page_count = total_pages;
+  bool read_all = pages_read >= total_pages;
+  statistics.row_count =
+      read_all || pages_read == 0
+          ? rows_
+          : static_cast<size_t>(std::llround(static_cast<double>(rows_) *
+                                             total_pages / pages_read));
+  bool exact = read_all && sample_.complete();
+
+  std::string key;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    ColumnStatistics column;
+    column.column_name = columns_[i].name;
+    column.data_type = columns_[i].data_type;
+    if (rows_ > 0) {
+      column.null_fraction = static_cast<double>(nulls_[i]) / rows_;
+    }
+
+    // 样本中的非NULL值及其出现次数（按排序键去重，整数与等值的浮点数视为同一个值）
+    std::vector<Value> values;
+    std::unordered_map<std::string, size_t> counts;
+    for (const Row &row : sample_.rows()) {
+      if (i >= row.values.size() ||
+          is_null_value(row.values[i], columns_[i].data_type)) {
+        continue;
+      }
+      key.clear();
+      encode_sort_key(row.values[i], true, key);
+      ++counts[key];
+      values.push_back(row.values[i]);
+    }
+
+    double sample_distinct = static_cast<double>(counts.size());
+    if (exact) {
+      column.distinct_count = sample_distinct;
+    } else if (!values.empty()) {
+      // Duj1：D = n*d / (n - f1 + f1*n/N)，f1为样本中只出现一次的值个数
+      double n = static_cast<double>(values.size());
+      double total = std::max(statistics.row_count * (1.0 - column.null_fraction), n);
+      double singletons = 0.0;
+      for (const auto &entry : counts) {
+        singletons += entry.second == 1;
+      }
+      double duj1 = n * sample_distinct / (n - singletons + singletons * n / total);
+      column.distinct_count =
+          std::min(std::max(duj1, sketches_[i].estimate()), total);
+      column.distinct_count = std::max(column.distinct_count, sample_distinct);
+    }
+
+    // 等深直方图：第j个边界取排序后第j*(n-1)/k个值
+    std::sort(values.begin(), values.end(), value_less);
+    if (!values.empty()) {
+      size_t count = std::min(buckets_, values.size());
+      for (size_t j = 0; j <= count; ++j) {
+        column.histogram.push_back(values[j * (values.size() - 1) / count]);
+      }
+    }
+    statistics.columns.push_back(std::move(column));
+  }
+  return statistics;
+}
+
+TableStatistics collect_table_statistics(TableScanOperator &table_scan,
+                                         const StatisticsOptions &options) {
+  // 只读取页目录，不读取记录
+  std::vector<int32_t> pages = table_scan.start_page_scan();
+
+  // 页级采样：随机选取sample_pages个页，只读取这些页上的记录
+  std::vector<int32_t> sampled = pages;
+  if (options.sample_pages != 0 && sampled.size() > options.sample_pages) {
+    std::mt19937_64 rng(options.seed);
+    for (size_t i = 0; i < options.sample_pages; ++i) {
+      std::uniform_int_distribution<size_t> pick(i, sampled.size() - 1);
+      std::swap(sampled[i], sampled[pick(rng)]);
+    }
+    sampled.resize(options.sample_pages);
+    std::sort(sampled.begin(), sampled.end());
+  }
+
+  auto queue = std::make_shared<MorselQueue>(kAnalyzePagesPerMorsel);
+  queue->reset(sampled);
+  size_t dop = std::min(std::max<size_t>(options.parallel_degree, 1),
+                        std::max<size_t>(queue->morsel_count(), 1));
+  std::vector<StatisticsCollector> collectors;
+  for (size_t worker = 0; worker < dop; ++worker) {
+    collectors.emplace_back(table_scan.output_columns(), options,
+                            options.seed + worker + 1);
+  }
+  auto run = [&](StatisticsCollector &collector) {
+    size_t begin = 0, end = 0;
+    std::vector<Row> rows;
+    while (queue->next(begin, end)) {
+      for (size_t i = begin; i < end; ++i) {
+        rows.clear();
+        table_scan.scan_page(queue->page(i), rows);
+        for (const Row &row : rows) {
+          collector.add_row(row);
+        }
+      }
+    }
+  };
+
+  // 调用线程也作为一个工作线程，其余提交到共享线程池
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t running = dop - 1;
+  std::exception_ptr error;
+  for (size_t worker = 1; worker < dop; ++worker) {
+    WorkerPool::shared().submit([&, worker] {
+      std::exception_ptr failure;
+      try {
+        run(collectors[worker]);
+      } catch (...) {
+        failure = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (failure && !error) {
+        error = failure;
+      }
+      --running;
+      done.notify_all();
+    });
+  }
+  std::exception_ptr local_error;
+  try {
+    run(collectors[0]);
+  } catch (...) {
+    local_error = std::current_exception();
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return running == 0; });
+  }
+  if (local_error) {
+    std::rethrow_exception(local_error);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  for (size_t worker = 1; worker < dop; ++worker) {
+    collectors[0].merge(std::move(collectors[worker]));
+  }
+  return collectors[0].finish(table_scan.table_name(), sampled.size(),
+                              pages.size());
+}
+
+// 每个边界编码为"类型字符 长度:文本"，文本中可以包含任意字符
+std::string encode_histogram(const std::vector<Value> &histogram) {
+  std::string out;
+  for (const auto &value : histogram) {
+    std::string text;
+    char type;
+    if (value.type == Value::Type::INT) {
+      type = 'I';
+      text = std::to_string(value.int_val);
+    } else if (value.type == Value::Type::DOUBLE) {
+      type = 'D';
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "%.17g", value.double_val);
+      text = buffer;
+    } else {
+      type = 'S';
+      text = value.str_val;
+    }
+    out += type;
+    out += std::to_string(text.size());
+    out += ':';
+    out += text;
+  }
+  return out;
+}
+
+std::vector<Value> decode_histogram(const std::string &text) {
+  std::vector<Value> histogram;
+  size_t position = 0;
+  while (position < text.size()) {
+    char type = text[position++];
+    size_t colon = text.find(':', position);
+    if (colon == std::string::npos || colon == position) {
+      throw Exception("Invalid histogram encoding");
+    }
+    size_t length = std::stoul(text.substr(position, colon - position));
+    if (colon + 1 + length > text.size()) {
+      throw Exception("Invalid histogram encoding");
+    }
+    std::string value = text.substr(colon + 1, length);
+    position = colon + 1 + length;
+    if (type == 'I') {
+      histogram.emplace_back(static_cast<int64_t>(std::stoll(value)));
+    } else if (type == 'D') {
+      histogram.emplace_back(std::stod(value));
+    } else if (type == 'S') {
+      histogram.emplace_back(value);
+    } else {
+      throw Exception("Invalid histogram encoding");
+    }
+  }
+  return histogram;
+}
+
+// ==================== StatisticsCatalog ====================
+
+StatisticsCatalog &StatisticsCatalog::shared() {
+  static StatisticsCatalog catalog;
+  return catalog;
+}
+
+std::string StatisticsCatalog::key(const std::string &database,
+                                   const std::string &table) {
+  return database + '\0' + table;
+}
+
+void StatisticsCatalog::put(const std::string &database,
+                            TableStatistics statistics) {
+  std::string table_key = key(database, statistics.table_name);
+  auto entry = std::make_shared<const TableStatistics>(std::move(statistics));
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  tables_[table_key] = Entry{std::move(entry), 0};
+}
+
+std::shared_ptr<const TableStatistics>
+StatisticsCatalog::get(const std::string &database,
+                       const std::string &table) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = tables_.find(key(database, table));
+  return it == tables_.end() ? nullptr : it->second.statistics;
+}
+
+void StatisticsCatalog::remove(const std::string &database,
+                               const std::string &table) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  tables_.erase(key(database, table));
+}
+
+void StatisticsCatalog::clear() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  tables_.clear();
+}
+
+void StatisticsCatalog::record_modification(const std::string &database,
+                                            const std::string &table,
+                                            size_t inserted, size_t deleted,
+                                            size_t updated) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto it = tables_.find(key(database, table));
+  if (it == tables_.end() || inserted + deleted + updated == 0) {
+    return;
+  }
+  Entry &entry = it->second;
+  entry.modified_rows += inserted + deleted + updated;
+  if (inserted == deleted) {
+    return;
+  }
+
+  // 统计信息不可变：复制后调整行数，页数按原来的每页行数换算
+  auto adjusted = std::make_shared<TableStatistics>(*entry.statistics);
+  size_t old_rows = adjusted->row_count;
+  adjusted->row_count =
+      old_rows + inserted > deleted ? old_rows + inserted - deleted : 0;
+  if (old_rows > 0 && adjusted->page_count > 0) {
+    double rows_per_page =
+        static_cast<double>(old_rows) / adjusted->page_count;
+    adjusted->page_count = static_cast<size_t>(
+        std::ceil(adjusted->row_count / rows_per_page));
+  } else if (adjusted->row_count > 0) {
+    adjusted->page_count = std::max<size_t>(adjusted->page_count, 1);
+  }
+  entry.statistics = std::move(adjusted);
+}
+
+size_t StatisticsCatalog::modified_rows(const std::string &database,
+                                        const std::string &table) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = tables_.find(key(database, table));
+  return it == tables_.end() ? 0 : it->second.modified_rows;
+}
+
+bool StatisticsCatalog::needs_analyze(const std::string &database,
+                                      const std::string &table) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = tables_.find(key(database, table));
+  if (it == tables_.end()) {
+    return false;
+  }
+  double threshold = kAutoAnalyzeBaseThreshold +
+                     kAutoAnalyzeScaleFactor * it->second.statistics->row_count;
+  return static_cast<double>(it->second.modified_rows) > threshold;
+}
+
+// ==================== 代价模型 ====================
+
+double seq_scan_cost(const TableStatistics &statistics) {
+  double rows = static_cast<double>(statistics.row_count);
+  return static_cast<double>(statistics.page_count) * kSeqPageCost +
+         rows * (kCpuTupleCost + kCpuOperatorCost);
+}
+
+double index_scan_cost(const TableStatistics &statistics, double selectivity) {
+  double rows = static_cast<double>(statistics.row_count);
+  double pages = std::max<double>(static_cast<double>(statistics.page_count), 1);
+  double tuples = clamp_fraction(selectivity) * rows;
+
+  // Mackert-Lohman：按记录位置读取tuples行时实际访问的不同页数
+  double pages_fetched = 0.0;
+  if (tuples > 0) {
+    pages_fetched = std::min(2.0 * pages * tuples / (2.0 * pages + tuples), pages);
+  }
+  double descent = std::ceil(std::log2(rows + 1.0)) * kCpuOperatorCost;
+  return kRandomPageCost * (1.0 + pages_fetched) + descent +
+         tuples * (kCpuIndexTupleCost + kCpuTupleCost);
+}
+
+bool index_scan_is_cheaper(const TableStatistics &statistics,
+                           const std::string &column, const std::string &op,
+                           const std::string &literal) {
+  double selectivity = statistics.selectivity(column, op, literal);
+  return index_scan_cost(statistics, selectivity) < seq_scan_cost(statistics);
+}
+
+double estimate_join_rows(const TableStatistics &left,
+                          const std::string &left_column,
+                          const TableStatistics &right,
+                          const std::string &right_column) {
+  double left_rows = static_cast<double>(left.row_count);
+  double right_rows = static_cast<double>(right.row_count);
+  const ColumnStatistics *left_stats = left.column(left_column);
+  const ColumnStatistics *right_stats = right.column(right_column);
+  double left_ndv = left_stats ? left_stats->distinct_count : left_rows;
+  double right_ndv = right_stats ? right_stats->distinct_count : right_rows;
+  double ndv = std::max({left_ndv, right_ndv, 1.0});
+  return left_rows * right_rows / ndv;
+}
+
+} // namespace sqlcc
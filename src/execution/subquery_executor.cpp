@@ -1,6 +1,11 @@
 #include "execution/subquery_executor.h"
+#include "database_manager.h"
+#include "exception.h"
 #include "sql_parser/ast_nodes.h"
+#include "unified_executor.h"
 #include <algorithm>
+#include <cctype>
+#include <iomanip>
 #include <memory>
 #include <optional>
 #include <sstream>
@@ -8,6 +13,134 @@
 
 namespace sqlcc {
 
+namespace {
+
+// 缓存的子查询结果数上限，超出时整体清空
+constexpr size_t kMaxCachedSubqueryResults = 4096;
+
+std::string trim(const std::string &text) {
+  size_t begin = text.find_first_not_of(" \t\n\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = text.find_last_not_of(" \t\n\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+std::string to_upper(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+  return text;
+}
+
+// 字符串或数值常量（不是列引用）
+bool is_literal(const std::string &text) {
+  if (text.empty() || text.front() == '\'' || text.front() == '"') {
+    return true;
+  }
+  char c = text.front();
+  return std::isdigit(static_cast<unsigned char>(c)) ||
+         ((c == '-' || c == '+' || c == '.') && text.size() > 1 &&
+          (std::isdigit(static_cast<unsigned char>(text[1])) || text[1] == '.'));
+}
+
+// 交换比较两侧时对应的操作符
+std::string flip_comparison(const std::string &op) {
+  if (op == "<") {
+    return ">";
+  } else if (op == ">") {
+    return "<";
+  } else if (op == "<=") {
+    return ">=";
+  } else if (op == ">=") {
+    return "<=";
+  }
+  return op;
+}
+
+// 比较结果按操作符判定
+std::function<bool(int)> comparison_accept(const std::string &op) {
+  if (op == "=") {
+    return [](int cmp) { return cmp == 0; };
+  } else if (op == "<>" || op == "!=") {
+    return [](int cmp) { return cmp != 0; };
+  } else if (op == "<") {
+    return [](int cmp) { return cmp < 0; };
+  } else if (op == "<=") {
+    return [](int cmp) { return cmp <= 0; };
+  } else if (op == ">") {
+    return [](int cmp) { return cmp > 0; };
+  } else if (op == ">=") {
+    return [](int cmp) { return cmp >= 0; };
+  }
+  throw Exception("Unsupported comparison operator: " + op);
+}
+
+// 值转换为可放回WHERE条件的常量文本
+std::string value_literal(const Value &value) {
+  switch (value.type) {
+  case Value::Type::INT:
+    return std::to_string(value.int_val);
+  case Value::Type::DOUBLE: {
+    std::ostringstream out;
+    out << std::setprecision(17) << value.double_val;
+    return out.str();
+  }
+  case Value::Type::STRING:
+    return "'" + value.str_val + "'";
+  }
+  return "";
+}
+
+// 子查询的文本签名，作为结果缓存键的前缀
+std::string subquery_signature(const sql_parser::SelectStatement &stmt) {
+  std::string out = stmt.getTableName() + "|";
+  out += stmt.isSelectAll() ? "*" : "";
+  for (const auto &column : stmt.getSelectColumns()) {
+    out += column + ",";
+  }
+  if (stmt.hasWhereClause()) {
+    const auto &where = stmt.getWhereClause();
+    out += "|W:" + where.getColumnName() + " " + where.getOp() + " " +
+           where.getValue();
+  }
+  if (stmt.hasGroupBy()) {
+    out += "|G:" + stmt.getGroupByColumn();
+  }
+  if (stmt.hasHavingClause()) {
+    const auto &having = stmt.getHavingClause();
+    out += "|H:" + having.getColumnName() + " " + having.getOp() + " " +
+           having.getValue();
+  }
+  if (stmt.hasOrderBy()) {
+    out += "|O:" + stmt.getOrderByColumn() + " " + stmt.getOrderDirection();
+  }
+  if (stmt.hasLimit()) {
+    out += "|L:" + std::to_string(stmt.getLimit());
+  }
+  if (stmt.hasOffset()) {
+    out += "|F:" + std::to_string(stmt.getOffset());
+  }
+  return out;
+}
+
+bool has_aggregate(const sql_parser::SelectStatement &stmt) {
+  for (const auto &column : stmt.getSelectColumns()) {
+    AggregateSpec spec;
+    if (ExecutionPlanGenerator::parseAggregate(column, spec)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const char *kind_name(SubqueryPredicate::Kind kind) {
+  static const char *names[] = {"EXISTS", "NOT EXISTS", "IN", "NOT IN",
+                                "SCALAR"};
+  return names[static_cast<int>(kind)];
+}
+
+} // namespace
+
 SubqueryExecutor::SubqueryExecutor(std::shared_ptr<SqlExecutor> sql_executor,
                                    std::shared_ptr<DatabaseManager> db_manager,
                                    std::shared_ptr<UserManager> user_manager,
@@ -23,36 +156,32 @@ SubqueryExecutor::~SubqueryExecutor() {
 
 ExecutionResult SubqueryExecutor::execute_subquery(
     std::unique_ptr<sql_parser::SelectStatement> subquery) {
-  // 执行基本子查询
-  // 这里简化实现，实际应该使用SqlExecutor执行子查询
-  // 目前返回空结果，后续需要完善
-  ExecutionResult result;
-  result.success = true;
-  result.message = "Subquery executed successfully";
-  return result;
+  // 在子查询表的扫描之上生成算子树执行
+  executions_++;
+  try {
+    ExecutionPlanGenerator generator;
+    OperatorPtr root = generator.generateOperatorTree(
+        *subquery, make_source(subquery->getTableName()));
+    ExecutionResult result = execute_operator_tree(*root);
+    result.message = "Subquery executed successfully";
+    return result;
+  } catch (const Exception &e) {
+    return ExecutionResult(false, e.what());
+  }
 }
 
 ExecutionResult SubqueryExecutor::execute_correlated_subquery(
     std::unique_ptr<sql_parser::SelectStatement> subquery,
     const Row &outer_row) {
-  // 1. 准备子查询执行上下文
-  ExecutionContext subquery_context = prepare_subquery_context(outer_row);
-
-  // 2. 替换子查询中的相关引用
-  replace_correlated_references(*subquery, outer_row);
-
-  // 3. 执行子查询
-  ExecutionResult result = execute_subquery(std::move(subquery));
-
-  return result;
+  // 相关引用按外层行绑定，相同参数直接返回缓存结果
+  return execute_cached(*subquery, outer_row);
 }
 
 bool SubqueryExecutor::execute_exists_subquery(
     std::unique_ptr<sql_parser::SelectStatement> subquery,
     const Row &outer_row) {
   // 执行EXISTS子查询，检查是否返回至少一行
-  ExecutionResult result =
-      execute_correlated_subquery(std::move(subquery), outer_row);
+  const ExecutionResult &result = execute_cached(*subquery, outer_row);
   return result.success && !result.rows.empty();
 }
 
@@ -60,7 +189,7 @@ bool SubqueryExecutor::execute_in_subquery(
     std::unique_ptr<sql_parser::SelectStatement> subquery,
     const Value &outer_value) {
   // 执行IN子查询，检查外部值是否在子查询结果中
-  ExecutionResult result = execute_subquery(std::move(subquery));
+  const ExecutionResult &result = execute_cached(*subquery, Row());
 
   if (!result.success) {
     return false;
@@ -103,8 +232,7 @@ std::optional<Value> SubqueryExecutor::execute_scalar_subquery(
     std::unique_ptr<sql_parser::SelectStatement> subquery,
     const Row &outer_row) {
   // 执行标量子查询，返回单个值
-  ExecutionResult result =
-      execute_correlated_subquery(std::move(subquery), outer_row);
+  const ExecutionResult &result = execute_cached(*subquery, outer_row);
 
   if (!result.success) {
     return std::nullopt;
@@ -157,8 +285,284 @@ bool SubqueryExecutor::execute_any_all_subquery(
   return result_value;
 }
 
+OperatorPtr
+SubqueryExecutor::plan_subquery_predicate(OperatorPtr outer,
+                                          const std::string &outer_table,
+                                          const SubqueryPredicate &predicate) {
+  if (!predicate.subquery) {
+    throw Exception("Subquery predicate without subquery");
+  }
+  set_outer_scope(outer_table, outer->output_columns());
+  if (OperatorPtr rewritten = decorrelate(outer, predicate)) {
+    return rewritten;
+  }
+
+  // 无法改写：逐行求值，子查询结果按相关参数缓存
+  size_t outer_index = 0;
+  std::function<bool(int)> accept;
+  if (predicate.kind != SubqueryPredicate::EXISTS &&
+      predicate.kind != SubqueryPredicate::NOT_EXISTS) {
+    outer_index = resolve_column(outer_columns_, predicate.outer_column);
+  }
+  if (predicate.kind == SubqueryPredicate::SCALAR) {
+    accept = comparison_accept(predicate.comparison_op);
+  }
+
+  RowPredicate filter = [this, predicate, outer_index,
+                         accept](const Row &row) {
+    const ExecutionResult &result = execute_cached(*predicate.subquery, row);
+    if (!result.success) {
+      throw Exception("Subquery failed: " + result.message);
+    }
+    switch (predicate.kind) {
+    case SubqueryPredicate::EXISTS:
+      return !result.rows.empty();
+    case SubqueryPredicate::NOT_EXISTS:
+      return result.rows.empty();
+    case SubqueryPredicate::IN:
+    case SubqueryPredicate::NOT_IN: {
+      bool found = std::any_of(
+          result.rows.begin(), result.rows.end(), [&](const Row &sub_row) {
+            return !sub_row.values.empty() &&
+                   compare_values(row.values[outer_index],
+                                  sub_row.values[0]) == 0;
+          });
+      return found == (predicate.kind == SubqueryPredicate::IN);
+    }
+    case SubqueryPredicate::SCALAR:
+      if (result.rows.size() > 1) {
+        throw Exception("Scalar subquery returned more than one row");
+      }
+      // 空结果视为NULL，比较结果不为真
+      return result.rows.size() == 1 && !result.rows[0].values.empty() &&
+             accept(compare_values(row.values[outer_index],
+                                   result.rows[0].values[0]));
+    }
+    return false;
+  };
+
+  std::string description = kind_name(predicate.kind);
+  if (!predicate.outer_column.empty()) {
+    description = predicate.outer_column + " " +
+                  (predicate.kind == SubqueryPredicate::SCALAR
+                       ? predicate.comparison_op
+                       : description);
+  }
+  return std::make_unique<FilterOperator>(
+      std::move(outer), std::move(filter),
+      description + " (SELECT ... FROM " + predicate.subquery->getTableName() +
+          ", memoized)");
+}
+
+OperatorPtr SubqueryExecutor::decorrelate(OperatorPtr &outer,
+                                          const SubqueryPredicate &predicate) {
+  const sql_parser::SelectStatement &subquery = *predicate.subquery;
+  std::optional<Correlation> correlation = find_correlation(subquery);
+  bool equi_correlated = correlation && correlation->op == "=";
+
+  switch (predicate.kind) {
+  case SubqueryPredicate::EXISTS:
+  case SubqueryPredicate::NOT_EXISTS: {
+    // 相关条件是唯一的WHERE条件，去掉后内表就是整张表；
+    // 聚合、分组和LIMIT/OFFSET会改变"是否存在"的语义，不改写
+    if (!equi_correlated || has_aggregate(subquery) || subquery.hasGroupBy() ||
+        subquery.hasHavingClause() || subquery.hasLimit() ||
+        subquery.hasOffset()) {
+      return nullptr;
+    }
+    return std::make_unique<SemiJoinOperator>(
+        std::move(outer), make_source(subquery.getTableName()),
+        correlation->outer_column, correlation->inner_column,
+        predicate.kind == SubqueryPredicate::NOT_EXISTS);
+  }
+
+  case SubqueryPredicate::IN:
+  case SubqueryPredicate::NOT_IN: {
+    // 不相关的IN子查询只执行一次，结果作为半连接/反连接的内表
+    if (correlation) {
+      return nullptr;
+    }
+    ExecutionPlanGenerator generator;
+    OperatorPtr inner = generator.generateOperatorTree(
+        subquery, make_source(subquery.getTableName()));
+    if (inner->output_columns().size() != 1) {
+      throw Exception("IN subquery must return exactly one column");
+    }
+    std::string inner_key = inner->output_columns()[0].name;
+    return std::make_unique<SemiJoinOperator>(
+        std::move(outer), std::move(inner), predicate.outer_column, inner_key,
+        predicate.kind == SubqueryPredicate::NOT_IN);
+  }
+
+  case SubqueryPredicate::SCALAR: {
+    // 形如 col op (SELECT AGG(x) FROM t WHERE t.k = outer.k)：按k分组聚合
+    // 一次，再与外表按k连接后比较
+    AggregateSpec spec;
+    if (!equi_correlated || subquery.getSelectColumns().size() != 1 ||
+        !ExecutionPlanGenerator::parseAggregate(subquery.getSelectColumns()[0],
+                                                spec) ||
+        subquery.hasGroupBy() || subquery.hasHavingClause() ||
+        subquery.hasLimit() || subquery.hasOffset()) {
+      return nullptr;
+    }
+    std::function<bool(int)> accept =
+        comparison_accept(predicate.comparison_op);
+    std::vector<std::string> outer_names;
+    for (const auto &column : outer_columns_) {
+      outer_names.push_back(column.name);
+    }
+    size_t outer_width = outer_columns_.size();
+    size_t compare_index = resolve_column(outer_columns_, predicate.outer_column);
+    std::string outer_key =
+        outer_columns_[resolve_column(outer_columns_, correlation->outer_column)]
+            .name;
+
+    auto aggregate = std::make_unique<AggregateOperator>(
+        make_source(subquery.getTableName()),
+        std::vector<std::string>{correlation->inner_column},
+        std::vector<AggregateSpec>{spec});
+    std::string inner_key = aggregate->output_columns()[0].name;
+
+    // 没有匹配分组时标量子查询为NULL，比较不为真，因此用内连接；
+    // COUNT在空输入上为0，用左连接并以补齐的0作为计数
+    JoinType join_type = spec.function == AggregateSpec::COUNT
+                             ? JoinType::LEFT_JOIN
+                             : JoinType::INNER_JOIN;
+    OperatorPtr root = std::make_unique<JoinOperator>(
+        std::move(outer), std::move(aggregate), join_type,
+        outer_key + " = " + inner_key);
+    RowPredicate filter = [compare_index, outer_width,
+                           accept](const Row &row) {
+      return outer_width + 1 < row.values.size() &&
+             accept(compare_values(row.values[compare_index],
+                                   row.values[outer_width + 1]));
+    };
+    root = std::make_unique<FilterOperator>(
+        std::move(root), std::move(filter),
+        predicate.outer_column + " " + predicate.comparison_op + " " +
+            spec.alias);
+    return std::make_unique<ProjectOperator>(std::move(root), outer_names);
+  }
+  }
+  return nullptr;
+}
+
+void SubqueryExecutor::set_outer_scope(
+    const std::string &outer_table,
+    const std::vector<ColumnMeta> &outer_columns) {
+  // 外层作用域变化会改变相关引用的识别，缓存结果不再适用
+  bool changed = outer_table != outer_table_ ||
+                 outer_columns.size() != outer_columns_.size() ||
+                 !std::equal(outer_columns.begin(), outer_columns.end(),
+                             outer_columns_.begin(),
+                             [](const ColumnMeta &a, const ColumnMeta &b) {
+                               return a.name == b.name;
+                             });
+  if (changed) {
+    clear_cache();
+  }
+  outer_table_ = outer_table;
+  outer_columns_ = outer_columns;
+}
+
+std::optional<Correlation> SubqueryExecutor::find_correlation(
+    const sql_parser::SelectStatement &subquery) const {
+  if (!subquery.hasWhereClause() || outer_columns_.empty()) {
+    return std::nullopt;
+  }
+  const auto &where = subquery.getWhereClause();
+  std::string column = trim(where.getColumnName());
+  std::string value = trim(where.getValue());
+
+  auto qualified_by_outer = [&](const std::string &name) {
+    size_t dot = name.find('.');
+    return dot != std::string::npos && !outer_table_.empty() &&
+           to_upper(name.substr(0, dot)) == to_upper(outer_table_);
+  };
+  auto resolves_in_outer = [&](const std::string &name) {
+    try {
+      resolve_column(outer_columns_, name);
+      return true;
+    } catch (const Exception &) {
+      return false;
+    }
+  };
+
+  // inner.col op outer.col；未限定的名称在子查询与外层是同一张表时
+  // 按SQL作用域规则解析为内层列
+  bool value_is_outer =
+      !is_literal(value) && resolves_in_outer(value) &&
+      (qualified_by_outer(value) ||
+       (value.find('.') == std::string::npos &&
+        to_upper(subquery.getTableName()) != to_upper(outer_table_)));
+  if (value_is_outer && !qualified_by_outer(column)) {
+    return Correlation{column, where.getOp(), value};
+  }
+  // outer.col op inner.col
+  if (qualified_by_outer(column) && resolves_in_outer(column) &&
+      !is_literal(value)) {
+    return Correlation{value, flip_comparison(where.getOp()), column};
+  }
+  return std::nullopt;
+}
+
+void SubqueryExecutor::set_source_provider(SourceProvider provider) {
+  source_provider_ = std::move(provider);
+  clear_cache();
+}
+
+void SubqueryExecutor::clear_cache() { result_cache_.clear(); }
+
+const ExecutionResult &
+SubqueryExecutor::execute_cached(const sql_parser::SelectStatement &subquery,
+                                 const Row &outer_row) {
+  std::string key = subquery_signature(subquery);
+  std::optional<Correlation> correlation = find_correlation(subquery);
+  Value parameter;
+  if (correlation) {
+    size_t index = resolve_column(outer_columns_, correlation->outer_column);
+    if (index >= outer_row.values.size()) {
+      throw Exception("Correlated reference not bound: " +
+                      correlation->outer_column);
+    }
+    parameter = outer_row.values[index];
+    key.push_back('\0');
+    encode_sort_key(parameter, true, key);
+  }
+
+  auto it = result_cache_.find(key);
+  if (it != result_cache_.end()) {
+    cache_hits_++;
+    return it->second;
+  }
+
+  auto bound = std::make_unique<sql_parser::SelectStatement>(subquery);
+  replace_correlated_references(*bound, outer_row);
+  ExecutionResult result = execute_subquery(std::move(bound));
+  if (result_cache_.size() >= kMaxCachedSubqueryResults) {
+    result_cache_.clear();
+  }
+  return result_cache_.emplace(std::move(key), std::move(result)).first->second;
+}
+
+OperatorPtr SubqueryExecutor::make_source(const std::string &table) {
+  if (source_provider_) {
+    return source_provider_(table);
+  }
+  ExecutionContext context = context_;
+  if (!context.db_manager && !context.db_manager_) {
+    context.db_manager = db_manager_;
+  }
+  sql_parser::SelectStatement scan;
+  scan.setTableName(table);
+  scan.setSelectAll(true);
+  ExecutionPlanGenerator generator;
+  return generator.generateOperatorTree(scan, context);
+}
+
 void SubqueryExecutor::set_context(const ExecutionContext &context) {
   context_ = context;
+  clear_cache();
 }
 
 const ExecutionContext &SubqueryExecutor::get_context() const {
@@ -179,9 +583,19 @@ SubqueryExecutor::prepare_subquery_context(const Row &outer_row) {
 
 void SubqueryExecutor::replace_correlated_references(
     sql_parser::SelectStatement &subquery, const Row &outer_row) {
-  // 替换子查询中的相关引用
-  // 这里简化实现，实际应该遍历子查询的AST，替换相关引用
-  // 目前不做任何替换，后续需要完善
+  // 把相关条件中的外层列替换为外层行的值
+  std::optional<Correlation> correlation = find_correlation(subquery);
+  if (!correlation) {
+    return;
+  }
+  size_t index = resolve_column(outer_columns_, correlation->outer_column);
+  if (index >= outer_row.values.size()) {
+    throw Exception("Correlated reference not bound: " +
+                    correlation->outer_column);
+  }
+  subquery.setWhereClause(
+      sql_parser::WhereClause(correlation->inner_column, correlation->op,
+                              value_literal(outer_row.values[index])));
 }
 
 bool SubqueryExecutor::evaluate_subquery_result(
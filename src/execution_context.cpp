@@ -26,6 +26,7 @@ ExecutionContext::ExecutionContext()
       optimization_rules_(),           // 默认无优化规则
       index_info_(""),                 // 默认无索引信息
       cost_estimate_(0.0),             // 默认成本估算为0
+      parallel_degree_(0),             // 默认按配置或CPU核数决定并行度
       has_error_(false),               // 默认无错误
       error_message_(""),              // 默认无错误信息
       db_manager(nullptr),             // 默认无数据库管理器（兼容旧代码）
@@ -49,8 +50,8 @@ ExecutionContext::ExecutionContext(const std::string &current_user,
       used_index(false), execution_plan("未优化"), used_index_(false),
       execution_plan_("未优化"), plan_details_(""), optimized_plan_(""),
       query_optimized_(false), optimization_rules_(), index_info_(""),
-      cost_estimate_(0.0), has_error_(false), error_message_(""),
-      db_manager(nullptr), user_manager(nullptr), system_db(nullptr),
+      cost_estimate_(0.0), parallel_degree_(0), has_error_(false),
+      error_message_(""), db_manager(nullptr), user_manager(nullptr), system_db(nullptr),
       db_manager_(nullptr), user_manager_(nullptr), system_db_(nullptr),
       permission_validator_(nullptr) {}
 
@@ -66,8 +67,8 @@ ExecutionContext::ExecutionContext(std::shared_ptr<DatabaseManager> db_manager,
       execution_time_ms_(0), used_index(false), execution_plan("未优化"),
       used_index_(false), execution_plan_("未优化"), plan_details_(""),
       optimized_plan_(""), query_optimized_(false), optimization_rules_(),
-      index_info_(""), cost_estimate_(0.0), has_error_(false),
-      error_message_(""), db_manager(db_manager), user_manager(user_manager),
+      index_info_(""), cost_estimate_(0.0), parallel_degree_(0),
+      has_error_(false), error_message_(""), db_manager(db_manager), user_manager(user_manager),
       system_db(system_db), db_manager_(db_manager),
       user_manager_(user_manager), system_db_(system_db),
       permission_validator_(nullptr) {}
@@ -192,6 +193,14 @@ void ExecutionContext::set_cost_estimate(double cost_estimate) {
   cost_estimate_ = cost_estimate;
 }
 
+size_t ExecutionContext::get_parallel_degree() const {
+  return parallel_degree_;
+}
+
+void ExecutionContext::set_parallel_degree(size_t parallel_degree) {
+  parallel_degree_ = parallel_degree;
+}
+
 bool ExecutionContext::has_error() const { return has_error_; }
 
 void ExecutionContext::set_error(bool has_error,
@@ -310,6 +319,7 @@ std::shared_ptr<ExecutionContext> ExecutionContext::clone() const {
   cloned->optimization_rules_ = optimization_rules_;
   cloned->index_info_ = index_info_;
   cloned->cost_estimate_ = cost_estimate_;
+  cloned->parallel_degree_ = parallel_degree_;
   cloned->has_error_ = has_error_;
   cloned->error_message_ = error_message_;
   cloned->db_manager_ = db_manager_;
@@ -348,6 +358,7 @@ std::string ExecutionContext::to_string() const {
   oss << "]" << std::endl;
   oss << "  index_info: '" << index_info_ << "'" << std::endl;
   oss << "  cost_estimate: " << cost_estimate_ << std::endl;
+  oss << "  parallel_degree: " << parallel_degree_ << std::endl;
   oss << "  has_error: " << (has_error_ ? "true" : "false") << std::endl;
   oss << "  error_message: '" << error_message_ << "'" << std::endl;
   oss << "  has_db_manager: " << (db_manager_ ? "true" : "false") << std::endl;
@@ -6,6 +6,21 @@
 
 namespace sqlcc {
 
+namespace {
+
+// 按列类型编码的索引键（数值列按保序编码，与BPlusTreeIndex::MakeEntry一致）
+std::string indexKey(const std::string &value, const std::string &column_name,
+                     const TableMetadata &metadata) {
+  for (const auto &column : metadata.columns) {
+    if (column.name == column_name) {
+      return BPlusTreeIndex::EncodeKey(value, column.type);
+    }
+  }
+  return value;
+}
+
+} // namespace
+
 ExecutionEngine::ExecutionEngine(std::shared_ptr<DatabaseManager> db_manager)
     : db_manager_(db_manager),
       execution_context_(
@@ -211,7 +226,7 @@ DMLExecutor::optimizeQueryWithIndex(const std::string &table_name,
       auto index = index_manager->GetIndex(table_name, column_name);
       if (index) {
         // 使用索引查找匹配的记录位置
-        auto positions = index->Search(value);
+        auto positions = index->Search(indexKey(value, column_name, *metadata));
         if (!positions.empty()) {
           used_index = true;
           index_info = "使用索引: " + column_name + " 索引";
@@ -257,7 +272,8 @@ void DMLExecutor::maintainIndexesOnInsert(
       std::string value = getColumnValue(record, column_name, metadata);
       if (!value.empty()) {
         // 在索引中插入新记录
-        IndexEntry entry(value, page_id, offset);
+        IndexEntry entry(indexKey(value, column_name, *metadata), page_id, offset,
+                         getIncludedValues(record, *index, metadata));
         index->Insert(entry);
       }
     }
@@ -288,15 +304,22 @@ void DMLExecutor::maintainIndexesOnUpdate(
       std::string old_value = getColumnValue(old_record, column_name, metadata);
       std::string new_value = getColumnValue(new_record, column_name, metadata);
 
-      // 如果值发生变化，更新索引
-      if (old_value != new_value) {
+      std::vector<std::string> old_included =
+          getIncludedValues(old_record, *index, metadata);
+      std::vector<std::string> new_included =
+          getIncludedValues(new_record, *index, metadata);
+
+      // 如果键值或INCLUDE列的值发生变化，更新索引
+      if (old_value != new_value || old_included != new_included) {
         // 删除旧索引项
         if (!old_value.empty()) {
-          index->Delete(old_value);
+          index->Delete(indexKey(old_value, column_name, *metadata));
         }
         // 插入新索引项
         if (!new_value.empty()) {
-          IndexEntry new_entry(new_value, page_id, offset);
+          IndexEntry new_entry(indexKey(new_value, column_name, *metadata),
+                               page_id, offset,
+                               std::move(new_included));
           index->Insert(new_entry);
         }
       }
@@ -327,7 +350,7 @@ void DMLExecutor::maintainIndexesOnDelete(
       std::string value = getColumnValue(record, column_name, metadata);
       if (!value.empty()) {
         // 从索引中删除记录
-        index->Delete(value);
+        index->Delete(indexKey(value, column_name, *metadata));
       }
     }
   }
@@ -364,6 +387,18 @@ DMLExecutor::getColumnValue(const std::vector<std::string> &record,
   return "";
 }
 
+std::vector<std::string>
+DMLExecutor::getIncludedValues(const std::vector<std::string> &record,
+                               const BPlusTreeIndex &index,
+                               std::shared_ptr<TableMetadata> metadata) {
+  std::vector<std::string> values;
+  values.reserve(index.GetIncludedColumns().size());
+  for (const auto &column_name : index.GetIncludedColumns()) {
+    values.push_back(getColumnValue(record, column_name, metadata));
+  }
+  return values;
+}
+
 // DCLExecutor 实现
 DCLExecutor::DCLExecutor(std::shared_ptr<DatabaseManager> db_manager,
                          std::shared_ptr<UserManager> user_manager)
@@ -132,83 +132,3 @@ int main(int argc, char* argv[]) {
     
     return 0;
 }
-
-// 在 network 命名空间内实现 ConnectAndAuthenticate 方法
-namespace sqlcc::network {
-    bool ClientNetworkManager::ConnectAndAuthenticate(const std::string& username, const std::string& password) {
-        // 连接到服务器
-        if (!this->Connect()) {
-            return false;
-        }
-
-        // 发送连接请求
-        std::vector<char> connect_msg(sizeof(MessageHeader));
-        MessageHeader* header = reinterpret_cast<MessageHeader*>(connect_msg.data());
-        header->magic = 0x53514C43; // 'SQLC'
-        header->length = 0;
-        header->type = CONNECT;
-        header->flags = 0;
-        header->sequence_id = 1;
-
-        if (!this->SendRequest(connect_msg)) {
-            this->Disconnect();
-            return false;
-        }
-
-        // 接收连接确认
-        std::vector<char> connect_resp = this->ReceiveResponse();
-        if (connect_resp.empty()) {
-            this->Disconnect();
-            return false;
-        }
-
-        MessageHeader* resp_header = reinterpret_cast<MessageHeader*>(connect_resp.data());
-        if (resp_header->magic != 0x53514C43 || resp_header->type != CONN_ACK) {
-            this->Disconnect();
-            return false;
-        }
-
-        // 发送认证请求
-        size_t user_len = username.length();
-        size_t pass_len = password.length();
-        size_t msg_len = 2 * sizeof(uint32_t) + user_len + pass_len;
-
-        std::vector<char> auth_msg(sizeof(MessageHeader) + msg_len);
-        header = reinterpret_cast<MessageHeader*>(auth_msg.data());
-        header->magic = 0x53514C43; // 'SQLC'
-        header->length = msg_len;
-        header->type = AUTH;
-        header->flags = 0;
-        header->sequence_id = 2;
-
-        char* body = auth_msg.data() + sizeof(MessageHeader);
-        *reinterpret_cast<uint32_t*>(body) = user_len;
-        *reinterpret_cast<uint32_t*>(body + sizeof(uint32_t)) = pass_len;
-        std::memcpy(body + 2 * sizeof(uint32_t), username.c_str(), user_len);
-        std::memcpy(body + 2 * sizeof(uint32_t) + user_len, password.c_str(), pass_len);
-
-        if (!this->SendRequest(auth_msg)) {
-            this->Disconnect();
-            return false;
-        }
-
-        // 接收认证响应
-        std::vector<char> auth_resp = this->ReceiveResponse();
-        if (auth_resp.empty()) {
-            this->Disconnect();
-            return false;
-        }
-
-        resp_header = reinterpret_cast<MessageHeader*>(auth_resp.data());
-        if (resp_header->magic != 0x53514C43 || resp_header->type != AUTH_ACK) {
-            return false;
-        }
-
-        // 检查认证结果标志位：0表示成功，1表示失败
-        if (resp_header->flags != 0) {
-            return false;
-        }
-
-        return true;
-    }
-}
\ No newline at end of file
@@ -0,0 +1,89 @@
+/**
+ * @file admission_control.cpp
+ * @brief 服务器查询准入控制实现文件
+ */
+
+#include "network/admission_control.h"
+
+#include <algorithm>
+
+namespace sqlcc {
+namespace network {
+
+AdmissionController::AdmissionController(size_t max_inflight, size_t max_queued)
+    : max_inflight_(std::max<size_t>(1, max_inflight)), max_queued_(max_queued) {}
+
+AdmissionResult AdmissionController::TryAdmit(ConnectionHandler* handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 已有等待者时新查询也必须排队，保证先到先服务
+    if (stats_.inflight < max_inflight_ && waiting_.empty()) {
+        ++stats_.inflight;
+        ++stats_.queries_admitted;
+        stats_.peak_inflight = std::max(stats_.peak_inflight, stats_.inflight);
+        return AdmissionResult::ADMITTED;
+    }
+    if (waiting_.size() < max_queued_) {
+        waiting_.push_back(handler);
+        ++stats_.queries_queued;
+        stats_.queued = waiting_.size();
+        return AdmissionResult::QUEUED;
+    }
+    ++stats_.queries_rejected;
+    return AdmissionResult::REJECTED;
+}
+
+void AdmissionController::Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.inflight > 0) {
+        --stats_.inflight;
+    }
+}
+
+void AdmissionController::Cancel(ConnectionHandler* handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    waiting_.erase(std::remove(waiting_.begin(), waiting_.end(), handler), waiting_.end());
+    stats_.queued = waiting_.size();
+}
+
+ConnectionHandler* AdmissionController::NextRunnable() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (waiting_.empty() || stats_.inflight >= max_inflight_) {
+        return nullptr;
+    }
+    ConnectionHandler* handler = waiting_.front();
+    waiting_.pop_front();
+    stats_.queued = waiting_.size();
+    ++stats_.inflight;
+    stats_.peak_inflight = std::max(stats_.peak_inflight, stats_.inflight);
+    return handler;
+}
+
+void AdmissionController::SetLimits(size_t max_inflight, size_t max_queued) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_inflight_ = std::max<size_t>(1, max_inflight);
+    max_queued_ = max_queued;
+}
+
+void AdmissionController::RecordConnectionRejected() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.connections_rejected;
+}
+
+void AdmissionController::RecordReadPause(size_t buffered_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.read_pauses;
+    stats_.peak_output_bytes = std::max(stats_.peak_output_bytes, buffered_bytes);
+}
+
+void AdmissionController::RecordOutputBytes(size_t buffered_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.peak_output_bytes = std::max(stats_.peak_output_bytes, buffered_bytes);
+}
+
+AdmissionStats AdmissionController::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace network
+} // namespace sqlcc
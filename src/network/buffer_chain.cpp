@@ -0,0 +1,83 @@
+/**
+ * @file buffer_chain.cpp
+ * @brief 网络发送缓冲链实现文件
+ */
+
+#include "network/buffer_chain.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace sqlcc {
+namespace network {
+
+void BufferChain::Append(std::shared_ptr<const void> owner, const char* data, size_t length) {
+    if (length == 0 || data == nullptr) {
+        return;
+    }
+    BufferSlice slice;
+    slice.owner = std::move(owner);
+    slice.data = data;
+    slice.length = length;
+    slices_.push_back(std::move(slice));
+    total_bytes_ += length;
+}
+
+void BufferChain::Splice(BufferChain& other) {
+    if (other.slices_.empty()) {
+        return;
+    }
+    std::move(other.slices_.begin(), other.slices_.end(), std::back_inserter(slices_));
+    total_bytes_ += other.total_bytes_;
+    other.Clear();
+}
+
+void BufferChain::Consume(size_t bytes) {
+    bytes = std::min(bytes, total_bytes_);
+    total_bytes_ -= bytes;
+    while (bytes > 0 && !slices_.empty()) {
+        BufferSlice& front = slices_.front();
+        if (bytes >= front.length) {
+            bytes -= front.length;
+            slices_.pop_front();
+        } else {
+            // 部分发送：只推进指针，不拷贝剩余数据
+            front.data += bytes;
+            front.length -= bytes;
+            bytes = 0;
+        }
+    }
+}
+
+void BufferChain::Clear() {
+    slices_.clear();
+    total_bytes_ = 0;
+}
+
+std::vector<std::shared_ptr<const void>> BufferChain::CollectOwners(size_t max_slices) const {
+    std::vector<std::shared_ptr<const void>> owners;
+    size_t count = std::min(max_slices, slices_.size());
+    owners.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        owners.push_back(slices_[i].owner);
+    }
+    return owners;
+}
+
+#ifdef __linux__
+size_t BufferChain::FillIovec(struct iovec* iov, size_t max_iov) const {
+    size_t count = 0;
+    for (const auto& slice : slices_) {
+        if (count >= max_iov) {
+            break;
+        }
+        iov[count].iov_base = const_cast<char*>(slice.data);
+        iov[count].iov_len = slice.length;
+        ++count;
+    }
+    return count;
+}
+#endif
+
+} // namespace network
+} // namespace sqlcc
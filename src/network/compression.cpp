@@ -0,0 +1,243 @@
+/**
+ * @file compression.cpp
+ * @brief 网络帧压缩模块实现文件
+ */
+
+#include "network/compression.h"
+
+#include <cstring>
+#include <vector>
+
+namespace sqlcc {
+namespace network {
+
+namespace {
+
+constexpr size_t kMinMatch = 4;        // 最短匹配长度
+constexpr size_t kLastLiterals = 5;    // 块末尾必须保留为字面量的字节数
+constexpr size_t kMatchFindLimit = 12; // 距块末尾小于该值时不再查找匹配
+constexpr size_t kMaxOffset = 65535;   // 16位偏移的最大回溯距离
+constexpr int kHashLog = 14;           // 哈希表大小：2^14个位置
+
+inline uint32_t Read32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t HashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - kHashLog);
+}
+
+// 写入长度的扩展字节（长度 >= 15 时使用）
+inline char* WriteLengthTail(char* op, size_t length) {
+    while (length >= 255) {
+        *op++ = static_cast<char>(255);
+        length -= 255;
+    }
+    *op++ = static_cast<char>(length);
+    return op;
+}
+
+// 读取长度的扩展字节，越界返回false
+inline bool ReadLengthTail(const unsigned char*& ip, const unsigned char* end, size_t& length) {
+    unsigned char byte;
+    do {
+        if (ip >= end) {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace
+
+size_t LZCodec::MaxCompressedSize(size_t input_size) {
+    return input_size + input_size / 255 + 16;
+}
+
+size_t LZCodec::Compress(const char* src, size_t src_size, char* dst, size_t dst_capacity) {
+    if (dst_capacity < MaxCompressedSize(src_size)) {
+        return 0;
+    }
+
+    char* op = dst;
+    size_t anchor = 0;
+
+    if (src_size >= kMatchFindLimit + 1) {
+        // 每个线程复用一张哈希表，避免每帧分配
+        thread_local std::vector<uint32_t> table;
+        table.assign(size_t(1) << kHashLog, 0);
+
+        const size_t match_limit = src_size - kLastLiterals;
+        const size_t search_limit = src_size - kMatchFindLimit;
+        size_t ip = 0;
+        size_t misses = 0;
+
+        while (ip < search_limit) {
+            uint32_t sequence = Read32(src + ip);
+            uint32_t h = HashSequence(sequence);
+            // 表中存储位置+1，0表示空槽
+            size_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(ip + 1);
+
+            if (candidate == 0 || ip + 1 - candidate > kMaxOffset ||
+                Read32(src + candidate - 1) != sequence) {
+                // 连续未命中时加大步长，快速跳过不可压缩区域
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+            size_t ref = candidate - 1;
+
+            // 向后扩展匹配，匹配不能进入末尾字面量区
+            size_t match_len = kMinMatch;
+            while (ip + match_len < match_limit && src[ref + match_len] == src[ip + match_len]) {
+                ++match_len;
+            }
+
+            // 输出序列：token | 字面量长度扩展 | 字面量 | 偏移 | 匹配长度扩展
+            size_t literal_len = ip - anchor;
+            char* token = op++;
+            unsigned char token_value = 0;
+            if (literal_len >= 15) {
+                token_value = 15 << 4;
+                op = WriteLengthTail(op, literal_len - 15);
+            } else {
+                token_value = static_cast<unsigned char>(literal_len << 4);
+            }
+            std::memcpy(op, src + anchor, literal_len);
+            op += literal_len;
+
+            uint16_t offset = static_cast<uint16_t>(ip - ref);
+            *op++ = static_cast<char>(offset & 0xff);
+            *op++ = static_cast<char>(offset >> 8);
+
+            size_t match_code = match_len - kMinMatch;
+            if (match_code >= 15) {
+                token_value |= 15;
+                op = WriteLengthTail(op, match_code - 15);
+            } else {
+                token_value |= static_cast<unsigned char>(match_code);
+            }
+            *token = static_cast<char>(token_value);
+
+            // 为匹配内部的一个位置补充哈希，提高后续命中率
+            if (ip + match_len - 2 < search_limit) {
+                size_t pos = ip + match_len - 2;
+                table[HashSequence(Read32(src + pos))] = static_cast<uint32_t>(pos + 1);
+            }
+            ip += match_len;
+            anchor = ip;
+        }
+    }
+
+    // 最后一个序列只包含字面量
+    size_t literal_len = src_size - anchor;
+    if (literal_len >= 15) {
+        *op++ = static_cast<char>(15 << 4);
+        op = WriteLengthTail(op, literal_len - 15);
+    } else {
+        *op++ = static_cast<char>(literal_len << 4);
+    }
+    std::memcpy(op, src + anchor, literal_len);
+    op += literal_len;
+    return static_cast<size_t>(op - dst);
+}
+
+long LZCodec::Decompress(const char* src, size_t src_size, char* dst, size_t dst_capacity) {
+    const unsigned char* ip = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* const ip_end = ip + src_size;
+    char* op = dst;
+    char* const op_end = dst + dst_capacity;
+
+    while (ip < ip_end) {
+        unsigned char token = *ip++;
+
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && !ReadLengthTail(ip, ip_end, literal_len)) {
+            return -1;
+        }
+        if (literal_len > static_cast<size_t>(ip_end - ip) ||
+            literal_len > static_cast<size_t>(op_end - op)) {
+            return -1;
+        }
+        std::memcpy(op, ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+
+        if (ip >= ip_end) {
+            break; // 最后一个序列没有匹配部分
+        }
+
+        if (ip_end - ip < 2) {
+            return -1;
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+            return -1;
+        }
+
+        size_t match_len = token & 15;
+        if (match_len == 15 && !ReadLengthTail(ip, ip_end, match_len)) {
+            return -1;
+        }
+        match_len += kMinMatch;
+        if (match_len > static_cast<size_t>(op_end - op)) {
+            return -1;
+        }
+
+        const char* match = op - offset;
+        if (offset >= match_len) {
+            std::memcpy(op, match, match_len);
+            op += match_len;
+        } else {
+            // 重叠复制（游程），必须逐字节前向拷贝
+            for (size_t i = 0; i < match_len; ++i) {
+                *op++ = match[i];
+            }
+        }
+    }
+    return static_cast<long>(op - dst);
+}
+
+bool FrameCompressor::Compress(const char* data, size_t size, std::string* out) {
+    if (size == 0 || size > kMaxFrameBodySize) {
+        return false;
+    }
+    out->resize(sizeof(uint32_t) + LZCodec::MaxCompressedSize(size));
+    uint32_t raw_size = static_cast<uint32_t>(size);
+    std::memcpy(&(*out)[0], &raw_size, sizeof(raw_size));
+    size_t compressed = LZCodec::Compress(data, size, &(*out)[sizeof(uint32_t)],
+                                          out->size() - sizeof(uint32_t));
+    // 至少节省1/16才值得让接收方付出解压代价
+    if (compressed == 0 || sizeof(uint32_t) + compressed >= size - size / 16) {
+        return false;
+    }
+    out->resize(sizeof(uint32_t) + compressed);
+    return true;
+}
+
+bool FrameCompressor::Decompress(const char* data, size_t size, std::string* out) {
+    if (size < sizeof(uint32_t)) {
+        return false;
+    }
+    uint32_t raw_size = 0;
+    std::memcpy(&raw_size, data, sizeof(raw_size));
+    // 每个输入字节至多展开为255个输出字节，声明的长度超过该比例一定是伪造的，
+    // 在分配输出缓冲区之前拒绝
+    uint64_t compressed_size = size - sizeof(uint32_t);
+    if (raw_size > kMaxFrameBodySize || raw_size > compressed_size * kMaxExpansion) {
+        return false;
+    }
+    out->resize(raw_size);
+    long decoded = LZCodec::Decompress(data + sizeof(uint32_t), size - sizeof(uint32_t),
+                                       raw_size ? &(*out)[0] : nullptr, raw_size);
+    return decoded >= 0 && static_cast<uint32_t>(decoded) == raw_size;
+}
+
+} // namespace network
+} // namespace sqlcc
@@ -0,0 +1,325 @@
+/**
+ * @file connection_pool.cpp
+ * @brief 客户端连接池实现文件
+ */
+
+#include "network/connection_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace sqlcc {
+namespace network {
+
+// PooledConnection实现
+PooledConnection::PooledConnection(ClientConnectionPool* pool,
+                                   std::unique_ptr<ClientNetworkManager> connection)
+    : pool_(pool), connection_(std::move(connection)) {}
+
+PooledConnection::~PooledConnection() {
+    Release();
+}
+
+PooledConnection::PooledConnection(PooledConnection&& other) noexcept
+    : pool_(other.pool_), connection_(std::move(other.connection_)), broken_(other.broken_) {
+    other.pool_ = nullptr;
+    other.broken_ = false;
+}
+
+PooledConnection& PooledConnection::operator=(PooledConnection&& other) noexcept {
+    if (this != &other) {
+        Release();
+        pool_ = other.pool_;
+        connection_ = std::move(other.connection_);
+        broken_ = other.broken_;
+        other.pool_ = nullptr;
+        other.broken_ = false;
+    }
+    return *this;
+}
+
+void PooledConnection::Release() {
+    if (pool_ && connection_) {
+        pool_->Return(std::move(connection_), broken_);
+    }
+    pool_ = nullptr;
+    connection_.reset();
+    broken_ = false;
+}
+
+// ClientConnectionPool实现
+ClientConnectionPool::ClientConnectionPool(const ConnectionPoolOptions& options)
+    : options_(options) {
+    options_.max_connections = std::max<size_t>(1, options_.max_connections);
+    options_.min_idle = std::min(options_.min_idle, options_.max_connections);
+
+    // 预建min_idle个连接，首批查询不必承担握手延迟
+    for (size_t i = 0; i < options_.min_idle; ++i) {
+        auto connection = CreateConnection();
+        if (!connection) {
+            break;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++open_connections_;
+        ++stats_.created;
+        idle_.push_back({std::move(connection), std::chrono::steady_clock::now()});
+    }
+
+    size_t workers = options_.async_workers > 0 ? options_.async_workers : options_.max_connections;
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back(&ClientConnectionPool::WorkerLoop, this);
+    }
+    maintenance_thread_ = std::thread(&ClientConnectionPool::MaintenanceLoop, this);
+}
+
+ClientConnectionPool::~ClientConnectionPool() {
+    Shutdown();
+}
+
+std::unique_ptr<ClientNetworkManager> ClientConnectionPool::CreateConnection() {
+    auto connection = std::make_unique<ClientNetworkManager>(options_.host, options_.port);
+    if (options_.enable_tls) {
+        connection->EnableTLS(true);
+#ifdef __linux__
+        if (!options_.ca_cert_path.empty()) {
+            connection->ConfigureTLSClient(options_.ca_cert_path);
+        }
+#endif
+    }
+    connection->RequestCompression(options_.enable_compression);
+    connection->SetReceiveTimeout(static_cast<int>(options_.query_timeout.count()));
+
+    if (!connection->Connect()) {
+        return nullptr;
+    }
+
+    // 无凭据时建立匿名会话；有凭据时先完成密钥交换，再发送认证信息
+    bool anonymous = options_.username.empty();
+    if (!connection->Handshake(anonymous ? CONNECT_DISABLE_AUTH : 0)) {
+        return nullptr;
+    }
+    if (options_.enable_key_exchange && !connection->InitiateKeyExchange()) {
+        return nullptr;
+    }
+    if (!anonymous && !connection->Authenticate(options_.username, options_.password)) {
+        return nullptr;
+    }
+    return connection;
+}
+
+PooledConnection ClientConnectionPool::Acquire() {
+    auto deadline = std::chrono::steady_clock::now() + options_.acquire_timeout;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        if (shutdown_) {
+            return PooledConnection();
+        }
+
+        // 优先复用最近归还的连接；空闲较久的连接先做存活检查
+        while (!idle_.empty()) {
+            IdleConnection entry = std::move(idle_.back());
+            idle_.pop_back();
+            auto idle_for = std::chrono::steady_clock::now() - entry.idle_since;
+            if (idle_for < options_.validation_interval || entry.connection->IsAlive()) {
+                ++stats_.reused;
+                ++stats_.in_use;
+                return PooledConnection(this, std::move(entry.connection));
+            }
+            ++stats_.failed_validation;
+            --open_connections_;
+        }
+
+        if (open_connections_ < options_.max_connections) {
+            // 先占用名额，握手在锁外进行
+            ++open_connections_;
+            lock.unlock();
+            auto connection = CreateConnection();
+            lock.lock();
+            if (connection) {
+                ++stats_.created;
+                ++stats_.in_use;
+                return PooledConnection(this, std::move(connection));
+            }
+            --open_connections_;
+            available_cv_.notify_one();
+            return PooledConnection();
+        }
+
+        if (available_cv_.wait_until(lock, deadline) == std::cv_status::timeout &&
+            idle_.empty() && open_connections_ >= options_.max_connections) {
+            ++stats_.acquire_timeouts;
+            return PooledConnection();
+        }
+    }
+}
+
+void ClientConnectionPool::Return(std::unique_ptr<ClientNetworkManager> connection, bool broken) {
+    std::unique_ptr<ClientNetworkManager> to_close;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --stats_.in_use;
+        if (broken || shutdown_ || !connection->IsConnected()) {
+            if (broken || !connection->IsConnected()) {
+                ++stats_.discarded_broken;
+            }
+            --open_connections_;
+            to_close = std::move(connection);
+        } else {
+            idle_.push_back({std::move(connection), std::chrono::steady_clock::now()});
+        }
+    }
+    available_cv_.notify_one();
+    // to_close在锁外析构，断开连接不阻塞其他线程
+}
+
+QueryResponse ClientConnectionPool::Execute(const std::string& sql) {
+    PooledConnection connection = Acquire();
+    if (!connection) {
+        QueryResponse response;
+        response.payload = "No connection available";
+        return response;
+    }
+    QueryResponse response = connection->ExecuteQuery(sql);
+    if (!connection->IsConnected()) {
+        connection.MarkBroken();
+    }
+    return response;
+}
+
+std::future<QueryResponse> ClientConnectionPool::ExecuteAsync(const std::string& sql) {
+    std::packaged_task<QueryResponse()> task([this, sql]() { return Execute(sql); });
+    std::future<QueryResponse> future = task.get_future();
+    {
+        std::lock_guard<std::mutex> lock(task_mutex_);
+        if (!tasks_closed_) {
+            tasks_.push_back(std::move(task));
+            task_cv_.notify_one();
+            return future;
+        }
+    }
+    std::promise<QueryResponse> rejected;
+    QueryResponse response;
+    response.payload = "Connection pool is shut down";
+    rejected.set_value(std::move(response));
+    return rejected.get_future();
+}
+
+void ClientConnectionPool::WorkerLoop() {
+    while (true) {
+        std::packaged_task<QueryResponse()> task;
+        {
+            std::unique_lock<std::mutex> lock(task_mutex_);
+            task_cv_.wait(lock, [this]() { return tasks_closed_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return; // 已关闭且队列已排空
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+size_t ClientConnectionPool::EvictIdle() {
+    std::vector<std::unique_ptr<ClientNetworkManager>> to_close;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        // 队首是归还最早的连接
+        while (idle_.size() > options_.min_idle &&
+               now - idle_.front().idle_since >= options_.idle_timeout) {
+            to_close.push_back(std::move(idle_.front().connection));
+            idle_.pop_front();
+            --open_connections_;
+            ++stats_.evicted_idle;
+        }
+    }
+    if (!to_close.empty()) {
+        available_cv_.notify_all();
+    }
+    return to_close.size();
+}
+
+void ClientConnectionPool::MaintenanceLoop() {
+    auto period = std::min<std::chrono::milliseconds>(
+        std::chrono::milliseconds(1000),
+        std::max<std::chrono::milliseconds>(std::chrono::milliseconds(10), options_.idle_timeout / 2));
+
+    std::unique_lock<std::mutex> maintenance_lock(maintenance_mutex_);
+    while (!maintenance_cv_.wait_for(maintenance_lock, period, [this]() { return maintenance_stop_; })) {
+        maintenance_lock.unlock();
+        EvictIdle();
+
+        // 补足min_idle（例如连接被服务器关闭之后）
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (shutdown_ || idle_.size() >= options_.min_idle ||
+                    open_connections_ >= options_.max_connections) {
+                    break;
+                }
+                ++open_connections_;
+            }
+            auto connection = CreateConnection();
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!connection || shutdown_) {
+                --open_connections_;
+                break;
+            }
+            ++stats_.created;
+            idle_.push_back({std::move(connection), std::chrono::steady_clock::now()});
+            available_cv_.notify_one();
+        }
+        maintenance_lock.lock();
+    }
+}
+
+void ClientConnectionPool::Shutdown() {
+    // 先排空异步队列，已提交的查询仍然可以借用连接完成
+    {
+        std::lock_guard<std::mutex> lock(task_mutex_);
+        tasks_closed_ = true;
+    }
+    task_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(maintenance_mutex_);
+        maintenance_stop_ = true;
+    }
+    maintenance_cv_.notify_all();
+    if (maintenance_thread_.joinable()) {
+        maintenance_thread_.join();
+    }
+
+    std::deque<IdleConnection> to_close;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+        open_connections_ -= idle_.size();
+        to_close.swap(idle_);
+    }
+    available_cv_.notify_all();
+    // 借出中的连接在归还时关闭
+}
+
+ConnectionPoolStats ClientConnectionPool::GetStats() const {
+    ConnectionPoolStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats = stats_;
+        stats.idle = idle_.size();
+    }
+    std::lock_guard<std::mutex> lock(task_mutex_);
+    stats.pending_async = tasks_.size();
+    return stats;
+}
+
+} // namespace network
+} // namespace sqlcc
@@ -78,14 +78,24 @@ std::vector<char> SimpleEncryptor::Decrypt(const std::vector<char>& data) const
 // AESEncryptor 实现
 // =====================
 
-AESEncryptor::AESEncryptor(std::shared_ptr<EncryptionKey> encryption_key)
-    : encryption_key_(encryption_key) {
+AESEncryptor::AESEncryptor(std::shared_ptr<EncryptionKey> encryption_key, AESMode mode)
+    : encryption_key_(encryption_key), mode_(mode) {
     if (!encryption_key_) {
         throw std::invalid_argument("Encryption key cannot be null");
     }
+#ifdef __linux__
+    if (RAND_bytes(nonce_salt_, sizeof(nonce_salt_)) != 1 ||
+        RAND_bytes(reinterpret_cast<unsigned char*>(&nonce_counter_), sizeof(nonce_counter_)) != 1) {
+        throw std::runtime_error("Failed to generate GCM nonce seed using OpenSSL");
+    }
+#endif
+    // 密钥长度不合法时延迟到加解密时报错，保持与原有行为一致
+    InitializeContext();
 }
 
-AESEncryptor::~AESEncryptor() = default;
+AESEncryptor::~AESEncryptor() {
+    ReleaseContext();
+}
 
 bool AESEncryptor::IsAvailable() {
 #ifdef __linux__
@@ -97,45 +107,42 @@ bool AESEncryptor::IsAvailable() {
 
 std::vector<uint8_t> AESEncryptor::Encrypt(const std::vector<uint8_t>& data) const {
 #ifdef __linux__
-    if (!encryption_key_ || encryption_key_->GetKey().size() != 32) {
-        throw std::runtime_error("Invalid encryption key size for AES-256");
+    if (mode_ == AESMode::GCM) {
+        std::vector<uint8_t> sealed(data.size() + kGcmOverhead);
+        sealed.resize(Seal(data.data(), data.size(), sealed.data()));
+        return sealed;
     }
-    
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-    if (!ctx) {
-        throw std::runtime_error("Failed to create EVP cipher context");
+
+    std::lock_guard<std::mutex> lock(ctx_mutex_);
+    if (!encrypt_ctx_) {
+        throw std::runtime_error("Invalid encryption key size for AES-256");
     }
     
     std::vector<uint8_t> encrypted_data(data.size() + EVP_MAX_BLOCK_LENGTH);
     int len = 0;
     int ciphertext_len = 0;
     
-    try {
-        // 初始化加密上下文（AES-256-CBC）
-        if (EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), nullptr, 
-                               encryption_key_->GetKey().data(), 
-                               encryption_key_->GetIV().data()) != 1) {
-            throw std::runtime_error("Failed to initialize AES encryption");
-        }
-        
-        // 加密数据
-        if (EVP_EncryptUpdate(ctx, encrypted_data.data(), &len, data.data(), data.size()) != 1) {
-            throw std::runtime_error("Failed to encrypt data");
-        }
-        ciphertext_len = len;
-        
-        // 处理最后的块
-        if (EVP_EncryptFinal_ex(ctx, encrypted_data.data() + len, &len) != 1) {
-            throw std::runtime_error("Failed to finalize encryption");
-        }
-        ciphertext_len += len;
-        
-        encrypted_data.resize(ciphertext_len);
-        return encrypted_data;
-    } catch (const std::exception&) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw;
+    // 复用已完成密钥调度的上下文（AES-256-CBC），只重置IV
+    if (EVP_EncryptInit_ex(encrypt_ctx_, nullptr, nullptr, nullptr,
+                           encryption_key_->GetIV().data()) != 1) {
+        throw std::runtime_error("Failed to initialize AES encryption");
+    }
+    
+    // 加密数据
+    if (EVP_EncryptUpdate(encrypt_ctx_, encrypted_data.data(), &len, data.data(),
+                          static_cast<int>(data.size())) != 1) {
+        throw std::runtime_error("Failed to encrypt data");
+    }
+    ciphertext_len = len;
+    
+    // 处理最后的块
+    if (EVP_EncryptFinal_ex(encrypt_ctx_, encrypted_data.data() + len, &len) != 1) {
+        throw std::runtime_error("Failed to finalize encryption");
     }
+    ciphertext_len += len;
+    
+    encrypted_data.resize(ciphertext_len);
+    return encrypted_data;
 #else
     throw std::runtime_error("AES encryption not supported on non-Linux platforms");
 #endif
@@ -143,65 +150,177 @@ std::vector<uint8_t> AESEncryptor::Encrypt(const std::vector<uint8_t>& data) con
 
 std::vector<uint8_t> AESEncryptor::Decrypt(const std::vector<uint8_t>& data) const {
 #ifdef __linux__
-    if (!encryption_key_ || encryption_key_->GetKey().size() != 32) {
-        throw std::runtime_error("Invalid encryption key size for AES-256");
+    if (mode_ == AESMode::GCM) {
+        if (data.size() < kGcmOverhead) {
+            throw std::runtime_error("GCM message too short");
+        }
+        std::vector<uint8_t> plaintext(data.size() - kGcmOverhead);
+        size_t plaintext_len = 0;
+        if (!Open(data.data(), data.size(), plaintext.data(), &plaintext_len)) {
+            throw std::runtime_error("GCM authentication failed");
+        }
+        plaintext.resize(plaintext_len);
+        return plaintext;
     }
-    
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-    if (!ctx) {
-        throw std::runtime_error("Failed to create EVP cipher context");
+
+    std::lock_guard<std::mutex> lock(ctx_mutex_);
+    if (!decrypt_ctx_) {
+        throw std::runtime_error("Invalid encryption key size for AES-256");
     }
     
     std::vector<uint8_t> decrypted_data(data.size() + EVP_MAX_BLOCK_LENGTH);
     int len = 0;
     int plaintext_len = 0;
     
-    try {
-        // 初始化解密上下文（AES-256-CBC）
-        if (EVP_DecryptInit_ex(ctx, EVP_aes_256_cbc(), nullptr, 
-                               encryption_key_->GetKey().data(), 
-                               encryption_key_->GetIV().data()) != 1) {
-            throw std::runtime_error("Failed to initialize AES decryption");
-        }
-        
-        // 解密数据
-        if (EVP_DecryptUpdate(ctx, decrypted_data.data(), &len, data.data(), data.size()) != 1) {
-            throw std::runtime_error("Failed to decrypt data");
-        }
-        plaintext_len = len;
-        
-        // 处理最后的块
-        if (EVP_DecryptFinal_ex(ctx, decrypted_data.data() + len, &len) != 1) {
-            throw std::runtime_error("Failed to finalize decryption");
-        }
-        plaintext_len += len;
-        
-        decrypted_data.resize(plaintext_len);
-        return decrypted_data;
-    } catch (const std::exception&) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw;
+    // 复用已完成密钥调度的上下文（AES-256-CBC），只重置IV
+    if (EVP_DecryptInit_ex(decrypt_ctx_, nullptr, nullptr, nullptr,
+                           encryption_key_->GetIV().data()) != 1) {
+        throw std::runtime_error("Failed to initialize AES decryption");
+    }
+    
+    // 解密数据
+    if (EVP_DecryptUpdate(decrypt_ctx_, decrypted_data.data(), &len, data.data(),
+                          static_cast<int>(data.size())) != 1) {
+        throw std::runtime_error("Failed to decrypt data");
     }
+    plaintext_len = len;
+    
+    // 处理最后的块
+    if (EVP_DecryptFinal_ex(decrypt_ctx_, decrypted_data.data() + len, &len) != 1) {
+        throw std::runtime_error("Failed to finalize decryption");
+    }
+    plaintext_len += len;
+    
+    decrypted_data.resize(plaintext_len);
+    return decrypted_data;
 #else
     throw std::runtime_error("AES decryption not supported on non-Linux platforms");
 #endif
 }
 
+size_t AESEncryptor::Seal(const uint8_t* plaintext, size_t len, uint8_t* out) const {
+#ifdef __linux__
+    if (mode_ != AESMode::GCM) {
+        throw std::runtime_error("Seal requires AES-256-GCM mode");
+    }
+    std::lock_guard<std::mutex> lock(ctx_mutex_);
+    if (!encrypt_ctx_) {
+        throw std::runtime_error("Invalid encryption key size for AES-256");
+    }
+
+    // 生成本条消息的nonce并写在输出开头
+    uint8_t* nonce = out;
+    std::memcpy(nonce, nonce_salt_, sizeof(nonce_salt_));
+    uint64_t counter = nonce_counter_++;
+    std::memcpy(nonce + sizeof(nonce_salt_), &counter, sizeof(counter));
+
+    uint8_t* ciphertext = out + kGcmNonceSize;
+    int out_len = 0;
+    int final_len = 0;
+    if (EVP_EncryptInit_ex(encrypt_ctx_, nullptr, nullptr, nullptr, nonce) != 1 ||
+        EVP_EncryptUpdate(encrypt_ctx_, ciphertext, &out_len, plaintext,
+                          static_cast<int>(len)) != 1 ||
+        EVP_EncryptFinal_ex(encrypt_ctx_, ciphertext + out_len, &final_len) != 1) {
+        throw std::runtime_error("Failed to encrypt data with AES-256-GCM");
+    }
+    size_t ciphertext_len = static_cast<size_t>(out_len + final_len);
+    if (EVP_CIPHER_CTX_ctrl(encrypt_ctx_, EVP_CTRL_GCM_GET_TAG, static_cast<int>(kGcmTagSize),
+                            ciphertext + ciphertext_len) != 1) {
+        throw std::runtime_error("Failed to get AES-256-GCM tag");
+    }
+    return kGcmNonceSize + ciphertext_len + kGcmTagSize;
+#else
+    (void)plaintext; (void)len; (void)out;
+    throw std::runtime_error("AES encryption not supported on non-Linux platforms");
+#endif
+}
+
+bool AESEncryptor::Open(const uint8_t* sealed, size_t sealed_len, uint8_t* out,
+                        size_t* plaintext_len) const {
+#ifdef __linux__
+    if (mode_ != AESMode::GCM || sealed_len < kGcmOverhead) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(ctx_mutex_);
+    if (!decrypt_ctx_) {
+        return false;
+    }
+
+    const uint8_t* nonce = sealed;
+    const uint8_t* ciphertext = sealed + kGcmNonceSize;
+    size_t ciphertext_len = sealed_len - kGcmOverhead;
+    // EVP_CIPHER_CTX_ctrl的标签参数不是const，复制到栈上
+    uint8_t tag[kGcmTagSize];
+    std::memcpy(tag, ciphertext + ciphertext_len, kGcmTagSize);
+
+    int out_len = 0;
+    int final_len = 0;
+    if (EVP_DecryptInit_ex(decrypt_ctx_, nullptr, nullptr, nullptr, nonce) != 1 ||
+        EVP_DecryptUpdate(decrypt_ctx_, out, &out_len, ciphertext,
+                          static_cast<int>(ciphertext_len)) != 1 ||
+        EVP_CIPHER_CTX_ctrl(decrypt_ctx_, EVP_CTRL_GCM_SET_TAG,
+                            static_cast<int>(kGcmTagSize), tag) != 1) {
+        return false;
+    }
+    // 标签不匹配时Final失败，调用方必须丢弃out中的内容
+    if (EVP_DecryptFinal_ex(decrypt_ctx_, out + out_len, &final_len) != 1) {
+        return false;
+    }
+    if (plaintext_len) {
+        *plaintext_len = static_cast<size_t>(out_len + final_len);
+    }
+    return true;
+#else
+    (void)sealed; (void)sealed_len; (void)out; (void)plaintext_len;
+    return false;
+#endif
+}
+
 void AESEncryptor::UpdateKey(std::shared_ptr<EncryptionKey> encryption_key) {
     if (!encryption_key) {
         throw std::invalid_argument("Encryption key cannot be null");
     }
+    std::lock_guard<std::mutex> lock(ctx_mutex_);
     encryption_key_ = encryption_key;
+    // 新密钥需要重新进行密钥调度
+    ReleaseContext();
+    InitializeContext();
 }
 
 bool AESEncryptor::InitializeContext() {
 #ifdef __linux__
-    return encryption_key_ && encryption_key_->GetKey().size() == 32;
+    if (!encryption_key_ || encryption_key_->GetKey().size() != 32) {
+        return false;
+    }
+    const EVP_CIPHER* cipher = (mode_ == AESMode::GCM) ? EVP_aes_256_gcm() : EVP_aes_256_cbc();
+    encrypt_ctx_ = EVP_CIPHER_CTX_new();
+    decrypt_ctx_ = EVP_CIPHER_CTX_new();
+    // 仅设置算法与密钥，IV/nonce在每条消息加解密时设置
+    if (!encrypt_ctx_ || !decrypt_ctx_ ||
+        EVP_EncryptInit_ex(encrypt_ctx_, cipher, nullptr, encryption_key_->GetKey().data(), nullptr) != 1 ||
+        EVP_DecryptInit_ex(decrypt_ctx_, cipher, nullptr, encryption_key_->GetKey().data(), nullptr) != 1) {
+        ReleaseContext();
+        return false;
+    }
+    return true;
 #else
     return false;
 #endif
 }
 
+void AESEncryptor::ReleaseContext() {
+#ifdef __linux__
+    if (encrypt_ctx_) {
+        EVP_CIPHER_CTX_free(encrypt_ctx_);
+        encrypt_ctx_ = nullptr;
+    }
+    if (decrypt_ctx_) {
+        EVP_CIPHER_CTX_free(decrypt_ctx_);
+        decrypt_ctx_ = nullptr;
+    }
+#endif
+}
+
 // HMAC-SHA256 实现
 std::vector<uint8_t> HMACSHA256::Compute(const std::vector<uint8_t>& key,
                                          const std::vector<uint8_t>& data) {
@@ -6,11 +6,11 @@
 #include <memory>
 #include <algorithm>
 #include <cstddef>
-#include <queue>
 #include <mutex>
 
 #ifdef __linux__
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -18,6 +18,7 @@
 #include <cerrno>
 #include <sys/epoll.h>
 #include <netdb.h>
+#include <linux/errqueue.h>
 #endif
 
 #include "network/encryption.h"
@@ -160,6 +161,9 @@ bool ClientConnection::Connect() {
     }
 
     connected_ = true;
+    if (receive_timeout_ms_ > 0) {
+        SetReceiveTimeout(receive_timeout_ms_);
+    }
 
     // 如果启用TLS，则进行TLS握手
     if (tls_enabled_) {
@@ -191,7 +195,8 @@ bool ClientConnection::Connect() {
 
 void ClientConnection::Disconnect() {
 #ifdef __linux__
-    if (connected_ && socket_fd_ >= 0) {
+    // 对端关闭时connected_已被清除，但套接字仍需释放
+    if (socket_fd_ >= 0) {
         if (tls_enabled_ && ssl_) {
             SSL_shutdown(ssl_);
             SSL_free(ssl_);
@@ -246,41 +251,111 @@ bool ClientConnection::SendData(const std::vector<char>& data) {
 
 std::vector<char> ClientConnection::ReceiveData() {
 #ifdef __linux__
-    std::vector<char> buffer(4096);
-    if (tls_enabled_ && ssl_) {
+    if (!connected_ || socket_fd_ < 0) {
+        return std::vector<char>();
+    }
+    if (tls_enabled_ && ssl_ && receive_timeout_ms_ == 0) {
         // 设置超时，避免无限阻塞
         struct timeval tv;
         tv.tv_sec = 5;
         tv.tv_usec = 0;
         setsockopt(socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-        int bytes = SSL_read(ssl_, buffer.data(), static_cast<int>(buffer.size()));
-        if (bytes <= 0) {
-            return std::vector<char>();
-        }
-        buffer.resize(bytes);
-        return buffer;
     }
-    ssize_t received = recv(socket_fd_, buffer.data(), buffer.size(), 0);
-    
-    if (received < 0) {
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            // 非阻塞模式下没有数据可读
-            return std::vector<char>();
-        }
-        return std::vector<char>(); // 错误发生
-    } else if (received == 0) {
-        // 连接被对方关闭
-        connected_ = false;
+
+    // 先读消息头，再按长度读完整的消息体：大结果跨多次recv，
+    // 连接复用时不能把上一条响应的残余留给下一条请求
+    std::vector<char> buffer(sizeof(MessageHeader));
+    if (!ReadExact(buffer.data(), buffer.size())) {
+        return std::vector<char>();
+    }
+    const MessageHeader* header = reinterpret_cast<const MessageHeader*>(buffer.data());
+    if (header->magic != 0x53514C43) {
+        return buffer; // 非协议数据，交给上层判断
+    }
+    size_t body_length = header->length;
+    if (body_length > FrameCompressor::kMaxFrameBodySize + AESEncryptor::kGcmOverhead + 64) {
+        Disconnect();
+        return std::vector<char>();
+    }
+    buffer.resize(sizeof(MessageHeader) + body_length);
+    if (body_length > 0 && !ReadExact(buffer.data() + sizeof(MessageHeader), body_length)) {
+        // 消息被截断，流已失去同步，只能断开
+        Disconnect();
         return std::vector<char>();
     }
-    
-    buffer.resize(received);
     return buffer;
 #else
     return std::vector<char>();
 #endif
 }
 
+bool ClientConnection::ReadExact(char* buffer, size_t length) {
+#ifdef __linux__
+    size_t total = 0;
+    while (total < length) {
+        ssize_t received;
+        if (tls_enabled_ && ssl_) {
+            received = SSL_read(ssl_, buffer + total, static_cast<int>(length - total));
+            if (received <= 0) {
+                return false;
+            }
+        } else {
+            received = recv(socket_fd_, buffer + total, length - total, 0);
+            if (received < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false; // 超时（EAGAIN）或错误
+            }
+            if (received == 0) {
+                // 连接被对方关闭
+                connected_ = false;
+                return false;
+            }
+        }
+        total += static_cast<size_t>(received);
+    }
+    return true;
+#else
+    (void)buffer;
+    (void)length;
+    return false;
+#endif
+}
+
+void ClientConnection::SetReceiveTimeout(int timeout_ms) {
+    receive_timeout_ms_ = timeout_ms;
+#ifdef __linux__
+    if (socket_fd_ >= 0) {
+        struct timeval tv;
+        tv.tv_sec = timeout_ms / 1000;
+        tv.tv_usec = (timeout_ms % 1000) * 1000;
+        setsockopt(socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+#endif
+}
+
+bool ClientConnection::IsAlive() const {
+#ifdef __linux__
+    if (!connected_ || socket_fd_ < 0) {
+        return false;
+    }
+    // 空闲连接上不应有未读数据：读到EOF说明对端已关闭，读到数据说明流已失步
+    char probe;
+    ssize_t n = recv(socket_fd_, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) {
+        return false;
+    }
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    // TLS连接上可能有会话票据等控制记录尚未被SSL_read消费
+    return tls_enabled_;
+#else
+    return connected_;
+#endif
+}
+
 // ClientNetworkManager实现
 ClientNetworkManager::ClientNetworkManager(const std::string& host, int port)
     : connection_(std::make_unique<ClientConnection>(host, port)),
@@ -311,6 +386,49 @@ bool ClientNetworkManager::IsConnected() const {
 }
 
 bool ClientNetworkManager::SendRequest(const std::vector<char>& request) {
+    if (request.size() >= sizeof(MessageHeader)) {
+        const MessageHeader* req_header = reinterpret_cast<const MessageHeader*>(request.data());
+        bool request_compression = req_header->type == CONNECT && compression_requested_;
+        bool compress_body = compression_enabled_ &&
+                             req_header->length >= FrameCompressor::kDefaultThreshold &&
+                             request.size() >= sizeof(MessageHeader) + req_header->length;
+        if (request_compression || compress_body) {
+            // 先压缩后加密：密文不可压缩
+            std::string compressed;
+            if (compress_body &&
+                FrameCompressor::Compress(request.data() + sizeof(MessageHeader),
+                                          req_header->length, &compressed)) {
+                std::vector<char> framed(sizeof(MessageHeader) + compressed.size());
+                MessageHeader* header = reinterpret_cast<MessageHeader*>(framed.data());
+                *header = *req_header;
+                header->flags |= FRAME_FLAG_COMPRESSED;
+                header->length = static_cast<uint32_t>(compressed.size());
+                std::memcpy(framed.data() + sizeof(MessageHeader), compressed.data(), compressed.size());
+                return SealAndSend(framed);
+            }
+            if (request_compression) {
+                std::vector<char> framed = request;
+                reinterpret_cast<MessageHeader*>(framed.data())->flags |= CONNECT_COMPRESSION;
+                return SealAndSend(framed);
+            }
+        }
+    }
+    return SealAndSend(request);
+}
+
+bool ClientNetworkManager::SealAndSend(const std::vector<char>& request) {
+    if (IsAESEncryptionEnabled() && aes_encryptor_->IsAuthenticated() &&
+        request.size() >= sizeof(MessageHeader)) {
+        // GCM：消息体直接加密进发送缓冲区，标签替代HMAC
+        size_t body_len = request.size() - sizeof(MessageHeader);
+        std::vector<char> msg(sizeof(MessageHeader) + body_len + AESEncryptor::kGcmOverhead);
+        std::memcpy(msg.data(), request.data(), sizeof(MessageHeader));
+        size_t sealed_len = aes_encryptor_->Seal(
+            reinterpret_cast<const uint8_t*>(request.data() + sizeof(MessageHeader)), body_len,
+            reinterpret_cast<uint8_t*>(msg.data() + sizeof(MessageHeader)));
+        reinterpret_cast<MessageHeader*>(msg.data())->length = static_cast<uint32_t>(sealed_len);
+        return connection_->SendData(msg);
+    }
     // 在客户端侧，仅对消息体进行加密并追加HMAC
     if (IsAESEncryptionEnabled()) {
         std::vector<char> msg = request;
@@ -331,9 +449,56 @@ bool ClientNetworkManager::SendRequest(const std::vector<char>& request) {
 }
 
 std::vector<char> ClientNetworkManager::ReceiveResponse() {
-    auto resp = connection_->ReceiveData();
+    std::vector<char> resp = OpenResponse(connection_->ReceiveData());
     if (resp.size() < sizeof(MessageHeader)) return resp;
     MessageHeader* header = reinterpret_cast<MessageHeader*>(resp.data());
+
+    // 服务器在CONN_ACK中回显压缩能力表示接受协商
+    if (header->type == CONN_ACK) {
+        compression_enabled_ = compression_requested_ && (header->flags & CONNECT_COMPRESSION);
+    }
+
+    // 解密之后再解压
+    if ((header->flags & FRAME_FLAG_COMPRESSED) && compression_enabled_ &&
+        resp.size() >= sizeof(MessageHeader) + header->length) {
+        std::string raw;
+        if (!FrameCompressor::Decompress(resp.data() + sizeof(MessageHeader), header->length, &raw)) {
+            return resp; // 返回原始响应以便上层处理错误
+        }
+        MessageHeader new_header = *header;
+        new_header.flags &= static_cast<uint16_t>(~FRAME_FLAG_COMPRESSED);
+        new_header.length = static_cast<uint32_t>(raw.size());
+        std::vector<char> out(sizeof(MessageHeader) + raw.size());
+        std::memcpy(out.data(), &new_header, sizeof(MessageHeader));
+        std::memcpy(out.data() + sizeof(MessageHeader), raw.data(), raw.size());
+        return out;
+    }
+    return resp;
+}
+
+std::vector<char> ClientNetworkManager::OpenResponse(std::vector<char> resp) {
+    if (resp.size() < sizeof(MessageHeader)) return resp;
+    MessageHeader* header = reinterpret_cast<MessageHeader*>(resp.data());
+    if (IsAESEncryptionEnabled() && aes_encryptor_->IsAuthenticated()) {
+        if (header->length < AESEncryptor::kGcmOverhead ||
+            resp.size() < sizeof(MessageHeader) + header->length) {
+            return resp;
+        }
+        // GCM：校验标签并直接解密到输出缓冲区
+        std::vector<char> out(sizeof(MessageHeader) + header->length - AESEncryptor::kGcmOverhead);
+        size_t plaintext_len = 0;
+        if (!aes_encryptor_->Open(reinterpret_cast<const uint8_t*>(resp.data() + sizeof(MessageHeader)),
+                                  header->length,
+                                  reinterpret_cast<uint8_t*>(out.data() + sizeof(MessageHeader)),
+                                  &plaintext_len)) {
+            return resp; // 返回原始响应以便上层处理错误
+        }
+        MessageHeader new_header = *header;
+        new_header.length = static_cast<uint32_t>(plaintext_len);
+        std::memcpy(out.data(), &new_header, sizeof(MessageHeader));
+        out.resize(sizeof(MessageHeader) + plaintext_len);
+        return out;
+    }
     if (IsAESEncryptionEnabled() && header->length >= 32) {
         const char* body_ptr = resp.data() + sizeof(MessageHeader);
         std::vector<uint8_t> ciphertext(body_ptr, body_ptr + header->length - 32);
@@ -380,13 +545,125 @@ bool ClientNetworkManager::SendAuthMessage(const std::string& username, const st
     return SendRequest(message);
 }
 
-bool ClientNetworkManager::InitiateKeyExchange() {
-    // 发送密钥交换请求
+bool ClientNetworkManager::ConnectAndAuthenticate(const std::string& username, const std::string& password) {
+    // 连接到服务器并完成CONNECT/CONN_ACK
+    if (!Connect()) {
+        return false;
+    }
+    if (!Handshake(0)) {
+        Disconnect();
+        return false;
+    }
+
+    return Authenticate(username, password);
+}
+
+bool ClientNetworkManager::Authenticate(const std::string& username, const std::string& password) {
+    // 发送认证请求并接收认证响应
+    if (!SendAuthMessage(username, password)) {
+        Disconnect();
+        return false;
+    }
+    std::vector<char> auth_resp = ReceiveResponse();
+    if (auth_resp.size() < sizeof(MessageHeader)) {
+        Disconnect();
+        return false;
+    }
+
+    MessageHeader* resp_header = reinterpret_cast<MessageHeader*>(auth_resp.data());
+    if (resp_header->magic != 0x53514C43 || resp_header->type != AUTH_ACK) {
+        return false;
+    }
+
+    // 检查认证结果标志位：0表示成功，1表示失败
+    return resp_header->flags == 0;
+}
+
+bool ClientNetworkManager::Handshake(uint16_t connect_flags) {
+    MessageHeader header;
+    header.magic = 0x53514C43; // 'SQLC'
+    header.length = 0;
+    header.type = CONNECT;
+    header.flags = connect_flags;
+    header.sequence_id = 1;
+
+    std::vector<char> message(sizeof(MessageHeader));
+    std::memcpy(message.data(), &header, sizeof(MessageHeader));
+    if (!SendRequest(message)) {
+        return false;
+    }
+
+    std::vector<char> response = ReceiveResponse();
+    if (response.size() < sizeof(MessageHeader)) {
+        return false;
+    }
+    const MessageHeader* resp_header = reinterpret_cast<const MessageHeader*>(response.data());
+    return resp_header->magic == 0x53514C43 && resp_header->type == CONN_ACK;
+}
+
+QueryResponse ClientNetworkManager::ExecuteQuery(const std::string& sql) {
+    QueryResponse result;
+    uint32_t sequence_id = next_sequence_id_++;
+
+    std::vector<char> message(sizeof(MessageHeader) + sql.size());
+    MessageHeader* header = reinterpret_cast<MessageHeader*>(message.data());
+    header->magic = 0x53514C43; // 'SQLC'
+    header->length = static_cast<uint32_t>(sql.size());
+    header->type = QUERY;
+    header->flags = 0;
+    header->sequence_id = sequence_id;
+    std::memcpy(message.data() + sizeof(MessageHeader), sql.data(), sql.size());
+
+    // 传输层失败后流的状态未知，断开连接，调用方（连接池）据此丢弃该连接
+    if (!SendRequest(message)) {
+        result.payload = "Failed to send query";
+        Disconnect();
+        return result;
+    }
+
+    std::vector<char> response = ReceiveResponse();
+    if (response.size() < sizeof(MessageHeader)) {
+        result.payload = "No response from server";
+        Disconnect();
+        return result;
+    }
+    const MessageHeader* resp_header = reinterpret_cast<const MessageHeader*>(response.data());
+    if (resp_header->magic != 0x53514C43 ||
+        response.size() < sizeof(MessageHeader) + resp_header->length) {
+        result.payload = "Malformed response";
+        Disconnect();
+        return result;
+    }
+    result.type = resp_header->type;
+    result.payload.assign(response.data() + sizeof(MessageHeader), resp_header->length);
+    if (resp_header->type == QUERY_RESULT) {
+        if (resp_header->sequence_id != sequence_id) {
+            // 响应与请求错位，连接不可再复用
+            result.type = ERROR;
+            result.payload = "Response sequence mismatch";
+            Disconnect();
+            return result;
+        }
+        result.success = resp_header->flags == 0;
+    }
+    return result;
+}
+
+void ClientNetworkManager::SetReceiveTimeout(int timeout_ms) {
+    connection_->SetReceiveTimeout(timeout_ms);
+}
+
+bool ClientNetworkManager::IsAlive() const {
+    return connection_->IsAlive();
+}
+
+bool ClientNetworkManager::InitiateKeyExchange(bool prefer_gcm) {
+    // 发送密钥交换请求，通过flags请求GCM认证加密
     MessageHeader header;
     header.magic = 0x53514C43; // 'SQLC'
     header.length = 0;
     header.type = KEY_EXCHANGE;
-    header.flags = 0;
+    header.flags = prefer_gcm ? KEY_EXCHANGE_GCM : 0;
     header.sequence_id = 2;
     
     std::vector<char> message(sizeof(MessageHeader));
@@ -432,7 +709,9 @@ bool ClientNetworkManager::InitiateKeyExchange() {
             iv  // 使用服务器发送的IV
         );
         
-        aes_encryptor_ = std::make_shared<network::AESEncryptor>(encryption_key);
+        // 服务器确认GCM时使用认证加密，否则退回CBC+HMAC
+        AESMode mode = (resp_header->flags & KEY_EXCHANGE_GCM) ? AESMode::GCM : AESMode::CBC;
+        aes_encryptor_ = std::make_shared<network::AESEncryptor>(encryption_key, mode);
         std::cout << "KEY_EXCHANGE successful" << std::endl;
         return true;
     } catch (const std::exception& e) {
@@ -508,10 +787,15 @@ ConnectionHandler::ConnectionHandler(int fd, std::shared_ptr<SessionManager> ses
     // 设置为非阻塞模式
     int flags = fcntl(fd_, F_GETFL, 0);
     fcntl(fd_, F_SETFL, flags | O_NONBLOCK);
+    epoll_events_ = EPOLLIN;
 #endif
 }
 
 ConnectionHandler::~ConnectionHandler() {
+    if (admission_) {
+        admission_->Cancel(this);
+        ReleaseQuerySlot();
+    }
 #ifdef __linux__
     if (ssl_) { SSL_free(ssl_); ssl_ = nullptr; }
 #endif
@@ -530,6 +814,40 @@ bool ConnectionHandler::IsClosed() const {
     return closed_;
 }
 
+void ConnectionHandler::SetEpollFd(int epoll_fd) {
+    epoll_fd_ = epoll_fd;
+}
+
+void ConnectionHandler::SetCompressionSupported(bool supported, size_t threshold) {
+    compression_supported_ = supported;
+    compression_threshold_ = threshold;
+}
+
+void ConnectionHandler::SetAdmissionController(std::shared_ptr<AdmissionController> admission) {
+    admission_ = std::move(admission);
+}
+
+void ConnectionHandler::SetOutputBufferLimits(size_t high_watermark, size_t low_watermark) {
+    output_high_watermark_ = std::max<size_t>(1, high_watermark);
+    output_low_watermark_ = std::min(low_watermark, output_high_watermark_);
+}
+
+bool ConnectionHandler::EnableZeroCopy(bool enabled) {
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    int value = enabled ? 1 : 0;
+    if (setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &value, sizeof(value)) != 0) {
+        // 内核不支持（< 4.14）或套接字类型不支持，退回普通拷贝发送
+        zerocopy_enabled_ = false;
+        return false;
+    }
+    zerocopy_enabled_ = enabled;
+    return true;
+#else
+    (void)enabled;
+    return false;
+#endif
+}
+
 void ConnectionHandler::HandleEvent(uint32_t events) {
 #ifdef __linux__
     if (events & EPOLLIN) {
@@ -537,8 +855,30 @@ void ConnectionHandler::HandleEvent(uint32_t events) {
     }
     if (events & EPOLLOUT) {
         HandleWrite();
+        // 输出缓冲回落到低水位后，继续处理暂停期间已接收的帧
+        if (!output_throttled_ && !query_waiting_ && !closed_) {
+            ProcessBufferedFrames();
+            if (tls_enabled_ && ssl_ && SSL_pending(ssl_) > 0) {
+                HandleRead();
+            }
+        }
+    }
+    if (events & EPOLLERR) {
+        // MSG_ZEROCOPY的完成通知通过错误队列投递，同样触发EPOLLERR，
+        // 只有套接字上确实存在错误时才关闭连接
+        int socket_error = 0;
+        socklen_t len = sizeof(socket_error);
+        if (zerocopy_enabled_) {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            ReapZeroCopyCompletions();
+        }
+        if (!zerocopy_enabled_ ||
+            getsockopt(fd_, SOL_SOCKET, SO_ERROR, &socket_error, &len) != 0 ||
+            socket_error != 0) {
+            Close();
+        }
     }
-    if (events & (EPOLLERR | EPOLLHUP)) {
+    if (events & EPOLLHUP) {
         Close();
     }
 #endif
@@ -546,18 +886,18 @@ void ConnectionHandler::HandleEvent(uint32_t events) {
 
 void ConnectionHandler::HandleRead() {
 #ifdef __linux__
-    // 读取数据并处理
-    std::vector<char> buffer(4096);
+    // 读取数据并按消息头中的长度切分为完整的帧
+    char buffer[16384];
     ssize_t bytes_read = 0;
     if (tls_enabled_ && ssl_) {
-        bytes_read = SSL_read(ssl_, buffer.data(), static_cast<int>(buffer.size()));
+        bytes_read = SSL_read(ssl_, buffer, static_cast<int>(sizeof(buffer)));
     } else {
-        bytes_read = recv(fd_, buffer.data(), buffer.size(), 0);
+        bytes_read = recv(fd_, buffer, sizeof(buffer), 0);
     }
     
     if (bytes_read > 0) {
-        buffer.resize(bytes_read);
-        ProcessMessage(buffer);
+        read_buffer_.insert(read_buffer_.end(), buffer, buffer + bytes_read);
+        ProcessBufferedFrames();
     } else if (bytes_read == 0) {
         // 客户端关闭连接
         Close();
@@ -570,69 +910,255 @@ void ConnectionHandler::HandleRead() {
 #endif
 }
 
+void ConnectionHandler::ProcessBufferedFrames() {
+    // 单帧上限：解压后上限之外留出加密开销
+    constexpr size_t kMaxInboundFrameBody = FrameCompressor::kMaxFrameBodySize + 64;
+
+    size_t offset = 0;
+    // 有查询在准入队列中等待或输出缓冲超过高水位时，已接收的帧留待之后处理
+    while (!closed_ && !query_waiting_ && !output_throttled_ &&
+           read_buffer_.size() - offset >= sizeof(MessageHeader)) {
+        MessageHeader header;
+        std::memcpy(&header, read_buffer_.data() + offset, sizeof(MessageHeader));
+        if (header.magic != 0x53514C43 || header.length > kMaxInboundFrameBody) {
+            // 流已失去同步，无法再定位后续帧
+            SendErrorMessage("Invalid message format");
+            Close();
+            break;
+        }
+        size_t frame_size = sizeof(MessageHeader) + header.length;
+        if (read_buffer_.size() - offset < frame_size) {
+            break;
+        }
+        std::vector<char> frame(read_buffer_.begin() + offset, read_buffer_.begin() + offset + frame_size);
+        offset += frame_size;
+        ProcessMessage(frame);
+    }
+    if (offset > 0) {
+        read_buffer_.erase(read_buffer_.begin(), read_buffer_.begin() + offset);
+    }
+}
+
 void ConnectionHandler::HandleWrite() {
 #ifdef __linux__
-    // 处理写事件（如果有待发送的数据）
+    // 单次sendmsg最多聚集的片段数（远小于IOV_MAX，足以覆盖头+体+MAC的若干帧）
+    constexpr size_t kMaxIovecPerSend = 64;
+
     std::lock_guard<std::mutex> lock(write_mutex_);
-    while (!write_queue_.empty()) {
-        const std::vector<char>& data = write_queue_.front();
-        ssize_t bytes_sent = 0;
+    if (zerocopy_enabled_ && !zerocopy_inflight_.empty()) {
+        ReapZeroCopyCompletions();
+    }
+
+    bool allow_zerocopy = zerocopy_enabled_;
+    while (!write_chain_.Empty() && !closed_) {
         if (tls_enabled_ && ssl_) {
-            bytes_sent = SSL_write(ssl_, data.data(), static_cast<int>(data.size()));
-        } else {
-            bytes_sent = send(fd_, data.data(), data.size(), 0);
+            // SSL_write不支持聚集写，逐片段写入，仍然避免拼接拷贝
+            const BufferSlice& slice = write_chain_.Front();
+            int written = SSL_write(ssl_, slice.data, static_cast<int>(slice.length));
+            if (written > 0) {
+                write_chain_.Consume(static_cast<size_t>(written));
+                continue;
+            }
+            int ssl_error = SSL_get_error(ssl_, written);
+            if (ssl_error == SSL_ERROR_WANT_WRITE || ssl_error == SSL_ERROR_WANT_READ) {
+                break;
+            }
+            Close();
+            return;
         }
-        
+
+        struct iovec iov[kMaxIovecPerSend];
+        size_t iovcnt = write_chain_.FillIovec(iov, kMaxIovecPerSend);
+        size_t batch_bytes = 0;
+        for (size_t i = 0; i < iovcnt; ++i) {
+            batch_bytes += iov[i].iov_len;
+        }
+
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovcnt;
+
+        int send_flags = MSG_NOSIGNAL;
+        bool zerocopy = false;
+#ifdef MSG_ZEROCOPY
+        if (allow_zerocopy && batch_bytes >= kZeroCopyThreshold) {
+            send_flags |= MSG_ZEROCOPY;
+            zerocopy = true;
+        }
+#endif
+
+        ssize_t bytes_sent = sendmsg(fd_, &msg, send_flags);
         if (bytes_sent > 0) {
-            write_queue_.pop();
-        } else if (bytes_sent < 0) {
+            if (zerocopy) {
+                // 内核直接引用用户页，完成通知到达前必须保持这些缓冲区存活
+                zerocopy_inflight_.emplace_back(zerocopy_next_id_++,
+                                                write_chain_.CollectOwners(iovcnt));
+            }
+            write_chain_.Consume(static_cast<size_t>(bytes_sent));
+            continue;
+        }
+        if (bytes_sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
             if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                // 注册 EPOLLOUT 事件以在可写时继续发送
-                struct epoll_event ev;
-                ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
-                ev.data.ptr = this;
-                // 在 ServerNetworkManager 中需要 epoll_fd，这里暂时不修改，等待后续优化
-                break;
-            } else {
-                Close();
                 break;
             }
+            if (zerocopy && errno == ENOBUFS) {
+                // 超出optmem限制，本轮退回普通发送
+                allow_zerocopy = false;
+                continue;
+            }
         }
+        Close();
+        return;
+    }
+
+    // 仍有数据未发出时等待EPOLLOUT，发送完毕后取消关注，避免空转
+    bool drained = write_chain_.Empty();
+    if (!drained && admission_) {
+        admission_->RecordOutputBytes(write_chain_.TotalBytes());
+    }
+    UpdateEpollInterest(!drained);
+    // 查询结果全部写入套接字后才归还准入名额
+    if (drained) {
+        ReleaseQuerySlot();
     }
 #endif
 }
 
-void ConnectionHandler::SendMessage(const std::vector<char>& message) {
+void ConnectionHandler::UpdateEpollInterest(bool want_write) {
 #ifdef __linux__
-    std::vector<char> to_send = message;
-    // 如果AES已启用，则仅对消息体进行加密并追加HMAC（除 KEY_EXCHANGE_ACK 外）
-    MessageHeader* msg_header = reinterpret_cast<MessageHeader*>(to_send.data());
-    if (session_ && session_->IsAESEncryptionEnabled() && msg_header->type != KEY_EXCHANGE_ACK) {
-        MessageHeader* header = reinterpret_cast<MessageHeader*>(to_send.data());
-        std::vector<char> body(to_send.begin() + sizeof(MessageHeader), to_send.end());
-        // 加密体并追加MAC
-        auto aes = session_->GetAESEncryptor();
-        std::vector<uint8_t> ct = aes->Encrypt(std::vector<uint8_t>(body.begin(), body.end()));
-        std::vector<uint8_t> mac = HMACSHA256::Compute(aes->GetKeyBytes(), ct);
-        std::vector<char> new_body(ct.begin(), ct.end());
-        new_body.insert(new_body.end(), mac.begin(), mac.end());
-        header->length = static_cast<uint32_t>(new_body.size());
-        to_send.resize(sizeof(MessageHeader) + new_body.size());
-        std::memcpy(to_send.data(), header, sizeof(MessageHeader));
-        std::memcpy(to_send.data() + sizeof(MessageHeader), new_body.data(), new_body.size());
+    if (epoll_fd_ < 0 || closed_) {
+        return;
+    }
+    // 高低水位之间保持原状态，避免在阈值附近反复切换
+    size_t buffered = write_chain_.TotalBytes();
+    if (!output_throttled_ && buffered >= output_high_watermark_) {
+        output_throttled_ = true;
+        if (admission_) {
+            admission_->RecordReadPause(buffered);
+        }
+    } else if (output_throttled_ && buffered <= output_low_watermark_) {
+        output_throttled_ = false;
     }
 
-    std::lock_guard<std::mutex> lock(write_mutex_);
-    bool queue_was_empty = write_queue_.empty();
-    write_queue_.push(to_send);
-    
-    // 如果队列之前为空，尝试立即发送，否则等待 EPOLLOUT 事件
-    if (queue_was_empty) {
-        // 释放锁后调用 HandleWrite 避免死锁
-        write_mutex_.unlock();
-        HandleWrite();
-        write_mutex_.lock();
+    // 暂停读取时不再关注EPOLLIN，未读数据留在内核中，由TCP流控反压到客户端
+    uint32_t events = (output_throttled_ || query_waiting_) ? 0 : EPOLLIN;
+    if (want_write) {
+        events |= EPOLLOUT;
+    }
+    if (events == epoll_events_) {
+        return;
+    }
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.ptr = this;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd_, &ev) == 0) {
+        epoll_events_ = events;
+    }
+#else
+    (void)want_write;
+#endif
+}
+
+void ConnectionHandler::ReapZeroCopyCompletions() {
+#if defined(__linux__) && defined(SO_EE_ORIGIN_ZEROCOPY)
+    // 调用方需持有write_mutex_
+    while (!zerocopy_inflight_.empty()) {
+        char control[128];
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break;
+        }
+        for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm)) {
+            bool is_recverr = (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                              (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+            if (!is_recverr) {
+                continue;
+            }
+            const auto* serr = reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cm));
+            if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            // 完成通知覆盖区间[ee_info, ee_data]，按序释放其之前的所有发送
+            uint32_t completed_hi = serr->ee_data;
+            while (!zerocopy_inflight_.empty() &&
+                   static_cast<int32_t>(zerocopy_inflight_.front().first - completed_hi) <= 0) {
+                zerocopy_inflight_.pop_front();
+            }
+        }
+    }
+#endif
+}
+
+void ConnectionHandler::SendFrame(uint16_t type, uint16_t flags, uint32_t sequence_id,
+                                  std::shared_ptr<const std::string> body) {
+#ifdef __linux__
+    // 消息头单独分配并原地填写，作为缓冲链的第一个片段
+    auto header = std::make_shared<MessageHeader>();
+    header->magic = 0x53514C43; // 'SQLC'
+    header->length = body ? static_cast<uint32_t>(body->size()) : 0;
+    header->type = type;
+    header->flags = flags;
+    header->sequence_id = sequence_id;
+
+    BufferChain frame;
+    frame.Append(std::shared_ptr<const void>(header),
+                 reinterpret_cast<const char*>(header.get()), sizeof(MessageHeader));
+
+    // 已协商压缩时，先压缩大消息体再加密（密文不可压缩）
+    if (session_ && session_->IsCompressionEnabled() && body &&
+        body->size() >= compression_threshold_) {
+        auto compressed = std::make_shared<std::string>();
+        if (FrameCompressor::Compress(body->data(), body->size(), compressed.get())) {
+            header->flags |= FRAME_FLAG_COMPRESSED;
+            header->length = static_cast<uint32_t>(compressed->size());
+            body = std::move(compressed);
+        }
     }
+
+    // 如果AES已启用，则仅对消息体进行加密（除 KEY_EXCHANGE_ACK 外）
+    if (session_ && session_->IsAESEncryptionEnabled() && type != KEY_EXCHANGE_ACK &&
+        session_->GetAESEncryptor()->IsAuthenticated()) {
+        // GCM：消息体一次加密直接写入发送缓冲区，认证标签替代HMAC
+        auto aes = session_->GetAESEncryptor();
+        size_t body_len = body ? body->size() : 0;
+        auto sealed = std::make_shared<std::vector<uint8_t>>(body_len + AESEncryptor::kGcmOverhead);
+        const uint8_t* plaintext = body ? reinterpret_cast<const uint8_t*>(body->data()) : nullptr;
+        sealed->resize(aes->Seal(plaintext, body_len, sealed->data()));
+        header->length = static_cast<uint32_t>(sealed->size());
+        frame.Append(std::move(sealed));
+    } else if (session_ && session_->IsAESEncryptionEnabled() && type != KEY_EXCHANGE_ACK) {
+        // CBC：加密后追加HMAC
+        auto aes = session_->GetAESEncryptor();
+        std::vector<uint8_t> plaintext;
+        if (body) {
+            plaintext.assign(body->begin(), body->end());
+        }
+        auto ciphertext = std::make_shared<std::vector<uint8_t>>(aes->Encrypt(plaintext));
+        auto mac = std::make_shared<std::vector<uint8_t>>(
+            HMACSHA256::Compute(aes->GetKeyBytes(), *ciphertext));
+        header->length = static_cast<uint32_t>(ciphertext->size() + mac->size());
+        // 密文与MAC作为独立片段发送，不再拼接成新的消息缓冲区
+        frame.Append(std::move(ciphertext));
+        frame.Append(std::move(mac));
+    } else if (body) {
+        frame.Append(std::move(body));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        write_chain_.Splice(frame);
+    }
+    // 立即尝试发送，未发完的部分由EPOLLOUT驱动继续发送
+    HandleWrite();
+#else
+    (void)type; (void)flags; (void)sequence_id; (void)body;
 #endif
 }
 
@@ -642,9 +1168,76 @@ void ConnectionHandler::Close() {
 #ifdef __linux__
         close(fd_);
 #endif
+        // 归还准入名额并退出等待队列
+        if (admission_) {
+            if (query_waiting_) {
+                admission_->Cancel(this);
+                query_waiting_ = false;
+            }
+            ReleaseQuerySlot();
+        }
+    }
+}
+
+void ConnectionHandler::ReleaseQuerySlot() {
+    if (holding_query_slot_) {
+        holding_query_slot_ = false;
+        if (admission_) {
+            admission_->Release();
+        }
+    }
+}
+
+void ConnectionHandler::AdmitQuery(const std::vector<char>& message) {
+    // 连接已持有名额（上一条结果尚未发完）时沿用该名额
+    if (!admission_ || holding_query_slot_) {
+        HandleQueryMessage(message);
+        return;
+    }
+    const MessageHeader* header = reinterpret_cast<const MessageHeader*>(message.data());
+    switch (admission_->TryAdmit(this)) {
+        case AdmissionResult::ADMITTED:
+            holding_query_slot_ = true;
+            HandleQueryMessage(message);
+            break;
+        case AdmissionResult::QUEUED: {
+            // 等待期间暂停读取，该连接不会再堆积新的请求
+            query_waiting_ = true;
+            pending_query_ = message;
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            UpdateEpollInterest(!write_chain_.Empty());
+            break;
+        }
+        case AdmissionResult::REJECTED:
+            SendErrorMessage("Server overloaded, retry later", ERROR_OVERLOADED, header->sequence_id);
+            break;
     }
 }
 
+void ConnectionHandler::RunPendingQuery() {
+    if (closed_ || !query_waiting_) {
+        // 名额已由准入控制器占用，没有可执行的查询时立即归还
+        if (admission_) {
+            admission_->Release();
+        }
+        return;
+    }
+    query_waiting_ = false;
+    holding_query_slot_ = true;
+    std::vector<char> query;
+    query.swap(pending_query_);
+    HandleQueryMessage(query);
+    if (closed_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        UpdateEpollInterest(!write_chain_.Empty());
+    }
+    // 恢复读取，并处理等待期间已接收的帧
+    ProcessBufferedFrames();
+}
+
 void ConnectionHandler::ProcessMessage(const std::vector<char>& data) {
     // 处理接收到的消息
     if (data.size() < sizeof(MessageHeader)) {
@@ -657,10 +1250,34 @@ void ConnectionHandler::ProcessMessage(const std::vector<char>& data) {
         return;
     }
     
-    // 若启用AES，则尝试将消息体解密（除密钥交换外）
-    std::vector<char> working = data;
-    if (session_ && session_->IsAESEncryptionEnabled() && header->type != KEY_EXCHANGE && header->length >= 32) {
-        const char* body_ptr = working.data() + sizeof(MessageHeader);
+    // 若启用AES，则尝试将消息体解密（除密钥交换外）；未加密时直接使用原始缓冲区
+    const std::vector<char>* message = &data;
+    std::vector<char> decrypted;
+    bool encrypted = session_ && session_->IsAESEncryptionEnabled() && header->type != KEY_EXCHANGE;
+    if (encrypted && session_->GetAESEncryptor()->IsAuthenticated()) {
+        if (header->length < AESEncryptor::kGcmOverhead ||
+            data.size() < sizeof(MessageHeader) + header->length) {
+            SendErrorMessage("Invalid encrypted message");
+            return;
+        }
+        // GCM：校验标签的同时直接解密到新消息体，无需单独的HMAC计算
+        decrypted.resize(sizeof(MessageHeader) + header->length - AESEncryptor::kGcmOverhead);
+        size_t plaintext_len = 0;
+        auto aes = session_->GetAESEncryptor();
+        if (!aes->Open(reinterpret_cast<const uint8_t*>(data.data() + sizeof(MessageHeader)),
+                       header->length,
+                       reinterpret_cast<uint8_t*>(decrypted.data() + sizeof(MessageHeader)),
+                       &plaintext_len)) {
+            SendErrorMessage("GCM authentication failed");
+            return;
+        }
+        MessageHeader new_header = *header;
+        new_header.length = static_cast<uint32_t>(plaintext_len);
+        std::memcpy(decrypted.data(), &new_header, sizeof(MessageHeader));
+        decrypted.resize(sizeof(MessageHeader) + plaintext_len);
+        message = &decrypted;
+    } else if (encrypted && header->length >= 32) {
+        const char* body_ptr = data.data() + sizeof(MessageHeader);
         std::vector<uint8_t> ciphertext(body_ptr, body_ptr + header->length - 32);
         std::vector<uint8_t> mac(body_ptr + header->length - 32, body_ptr + header->length);
         auto aes = session_->GetAESEncryptor();
@@ -672,25 +1289,50 @@ void ConnectionHandler::ProcessMessage(const std::vector<char>& data) {
         // 重建消息，将明文作为新体
         MessageHeader new_header = *header;
         new_header.length = static_cast<uint32_t>(plaintext.size());
-        working.resize(sizeof(MessageHeader) + plaintext.size());
-        std::memcpy(working.data(), &new_header, sizeof(MessageHeader));
-        std::memcpy(working.data() + sizeof(MessageHeader), plaintext.data(), plaintext.size());
-        header = reinterpret_cast<MessageHeader*>(working.data());
+        decrypted.resize(sizeof(MessageHeader) + plaintext.size());
+        std::memcpy(decrypted.data(), &new_header, sizeof(MessageHeader));
+        std::memcpy(decrypted.data() + sizeof(MessageHeader), plaintext.data(), plaintext.size());
+        message = &decrypted;
+    }
+    header = reinterpret_cast<MessageHeader*>(const_cast<char*>(message->data()));
+
+    // 解密之后再解压
+    std::vector<char> decompressed;
+    if (header->flags & FRAME_FLAG_COMPRESSED) {
+        // 只接受已经协商过压缩的连接发来的压缩帧
+        if (!session_ || !session_->IsCompressionEnabled()) {
+            SendErrorMessage("Compression not negotiated");
+            return;
+        }
+        std::string raw;
+        if (message->size() < sizeof(MessageHeader) + header->length ||
+            !FrameCompressor::Decompress(message->data() + sizeof(MessageHeader), header->length, &raw)) {
+            SendErrorMessage("Invalid compressed message");
+            return;
+        }
+        MessageHeader new_header = *header;
+        new_header.flags &= static_cast<uint16_t>(~FRAME_FLAG_COMPRESSED);
+        new_header.length = static_cast<uint32_t>(raw.size());
+        decompressed.resize(sizeof(MessageHeader) + raw.size());
+        std::memcpy(decompressed.data(), &new_header, sizeof(MessageHeader));
+        std::memcpy(decompressed.data() + sizeof(MessageHeader), raw.data(), raw.size());
+        message = &decompressed;
+        header = reinterpret_cast<MessageHeader*>(decompressed.data());
     }
     
     // 根据消息类型处理
     switch (header->type) {
         case CONNECT:
-            HandleConnectMessage(working);
+            HandleConnectMessage(*message);
             break;
         case AUTH:
-            HandleAuthMessage(working);
+            HandleAuthMessage(*message);
             break;
         case QUERY:
-            HandleQueryMessage(working);
+            AdmitQuery(*message);
             break;
         case KEY_EXCHANGE:
-            HandleKeyExchangeMessage(working);
+            HandleKeyExchangeMessage(*message);
             break;
         default:
             break;
@@ -708,29 +1350,27 @@ void ConnectionHandler::HandleConnectMessage(const std::vector<char>& data) {
         client_flags = header->flags;
         
         // 如果客户端请求禁用加密，记录到会话中
-        if (client_flags & 0x01) {
+        if (client_flags & CONNECT_DISABLE_ENCRYPTION) {
             session_->SetEncryptionDisabled(true);
         }
         
         // 如果客户端请求禁用认证，记录到会话中
-        if (client_flags & 0x02) {
+        if (client_flags & CONNECT_DISABLE_AUTH) {
             session_->SetAuthenticationDisabled(true);
             // 自动通过认证
             session_->SetAuthenticated("anonymous");
         }
+
+        // 客户端请求压缩且服务器允许时启用；否则在确认中清除该位表示拒绝
+        if ((client_flags & CONNECT_COMPRESSION) && compression_supported_) {
+            session_->SetCompressionEnabled(true);
+        } else {
+            client_flags &= ~static_cast<uint32_t>(CONNECT_COMPRESSION);
+        }
     }
     
-    // 发送连接确认消息，包含相同的标志
-    MessageHeader ack_header;
-    ack_header.magic = 0x53514C43; // 'SQLC'
-    ack_header.length = 0;
-    ack_header.type = CONN_ACK;
-    ack_header.flags = client_flags; // 回显客户端的标志
-    ack_header.sequence_id = 1;
-
-    std::vector<char> ack_msg(sizeof(MessageHeader));
-    std::memcpy(ack_msg.data(), &ack_header, sizeof(MessageHeader));
-    SendMessage(ack_msg);
+    // 发送连接确认消息，回显客户端的标志
+    SendFrame(CONN_ACK, static_cast<uint16_t>(client_flags), 1);
 }
 
 void ConnectionHandler::HandleAuthMessage(const std::vector<char>& data) {
@@ -762,17 +1402,8 @@ void ConnectionHandler::HandleAuthMessage(const std::vector<char>& data) {
 
     bool authenticated = session_manager_->Authenticate(session_->GetSessionId(), username, password);
     
-    // 发送认证确认消息
-    MessageHeader ack_header;
-    ack_header.magic = 0x53514C43; // 'SQLC'
-    ack_header.length = 0;
-    ack_header.type = AUTH_ACK;
-    ack_header.flags = authenticated ? 0 : 1; // 使用flags表示认证结果
-    ack_header.sequence_id = header->sequence_id;
-
-    std::vector<char> ack_msg(sizeof(MessageHeader));
-    std::memcpy(ack_msg.data(), &ack_header, sizeof(MessageHeader));
-    SendMessage(ack_msg);
+    // 发送认证确认消息，使用flags表示认证结果
+    SendFrame(AUTH_ACK, authenticated ? 0 : 1, header->sequence_id);
 }
 
 void ConnectionHandler::HandleQueryMessage(const std::vector<char>& data) {
@@ -801,22 +1432,11 @@ void ConnectionHandler::HandleQueryMessage(const std::vector<char>& data) {
     std::string query(data.data() + sizeof(MessageHeader), header->length);
     
     // 执行SQL查询（在最小化构建下，直接回显查询）
-    std::string result;
+    auto result = std::make_shared<std::string>("ECHO: " + query);
     bool success = true;
-    result = std::string("ECHO: ") + query;
-    
-    // 构造查询结果消息
-    MessageHeader result_header;
-    result_header.magic = 0x53514C43; // 'SQLC'
-    result_header.length = result.length();
-    result_header.type = QUERY_RESULT;
-    result_header.flags = success ? 0 : 1; // 使用flags表示执行结果
-    result_header.sequence_id = header->sequence_id;
 
-    std::vector<char> result_msg(sizeof(MessageHeader) + result.length());
-    std::memcpy(result_msg.data(), &result_header, sizeof(MessageHeader));
-    std::memcpy(result_msg.data() + sizeof(MessageHeader), result.c_str(), result.length());
-    SendMessage(result_msg);
+    // 结果体直接挂入发送链，不再拷贝到新的消息缓冲区；flags表示执行结果
+    SendFrame(QUERY_RESULT, success ? 0 : 1, header->sequence_id, std::move(result));
 }
 
 void ConnectionHandler::HandleKeyExchangeMessage(const std::vector<char>& data) {
@@ -832,43 +1452,29 @@ void ConnectionHandler::HandleKeyExchangeMessage(const std::vector<char>& data)
     try {
         // 生成AES-256密钥和IV
         auto encryption_key = network::EncryptionKey::GenerateRandom(32, 16); // AES-256 = 32字节
-        auto aes_encryptor = std::make_shared<network::AESEncryptor>(encryption_key);
+        // 客户端请求GCM时使用认证加密，旧客户端保持CBC+HMAC
+        bool use_gcm = (header->flags & KEY_EXCHANGE_GCM) != 0;
+        auto aes_encryptor = std::make_shared<network::AESEncryptor>(
+            encryption_key, use_gcm ? AESMode::GCM : AESMode::CBC);
         
         // 将AES加密器设置到session中
         session_->SetAESEncryptor(aes_encryptor);
         
         // 发送密钥交换确认消息，含有了IV
-        std::string ack_data(reinterpret_cast<const char*>(encryption_key->GetIV().data()), 
-                            encryption_key->GetIV().size());
-        
-        MessageHeader ack_header;
-        ack_header.magic = 0x53514C43; // 'SQLC'
-        ack_header.length = ack_data.length();
-        ack_header.type = KEY_EXCHANGE_ACK;
-        ack_header.flags = 0x01; // 使用flag表示已含有AES加密
-        ack_header.sequence_id = header->sequence_id;
-
-        std::vector<char> ack_msg(sizeof(MessageHeader) + ack_data.length());
-        std::memcpy(ack_msg.data(), &ack_header, sizeof(MessageHeader));
-        std::memcpy(ack_msg.data() + sizeof(MessageHeader), ack_data.c_str(), ack_data.length());
-        SendMessage(ack_msg);
+        auto ack_data = std::make_shared<std::string>(
+            reinterpret_cast<const char*>(encryption_key->GetIV().data()),
+            encryption_key->GetIV().size());
+
+        // 使用flag表示已含有AES加密及所选模式
+        uint16_t ack_flags = KEY_EXCHANGE_AES | (use_gcm ? KEY_EXCHANGE_GCM : 0);
+        SendFrame(KEY_EXCHANGE_ACK, ack_flags, header->sequence_id, std::move(ack_data));
     } catch (const std::exception& e) {
         SendErrorMessage(std::string("Key exchange failed: ") + e.what());
     }
 }
 
-void ConnectionHandler::SendErrorMessage(const std::string& error) {
-    MessageHeader error_header;
-    error_header.magic = 0x53514C43; // 'SQLC'
-    error_header.length = error.length();
-    error_header.type = ERROR;
-    error_header.flags = 0;
-    error_header.sequence_id = 0;
-
-    std::vector<char> error_msg(sizeof(MessageHeader) + error.length());
-    std::memcpy(error_msg.data(), &error_header, sizeof(MessageHeader));
-    std::memcpy(error_msg.data() + sizeof(MessageHeader), error.c_str(), error.length());
-    SendMessage(error_msg);
+void ConnectionHandler::SendErrorMessage(const std::string& error, uint16_t flags, uint32_t sequence_id) {
+    SendFrame(ERROR, flags, sequence_id, std::make_shared<std::string>(error));
 }
 
 std::vector<char> ConnectionHandler::EncryptMessage(const std::vector<char>& message) {
@@ -925,7 +1531,8 @@ MessageProcessor::MessageProcessor(std::shared_ptr<SessionManager> session_manag
 // ServerNetworkManager实现
 ServerNetworkManager::ServerNetworkManager(int port, int max_connections)
     : port_(port), max_connections_(max_connections), listen_fd_(-1), epoll_fd_(-1), running_(false),
-      session_manager_(std::make_shared<SessionManager>()) {}
+      session_manager_(std::make_shared<SessionManager>()),
+      admission_(std::make_shared<AdmissionController>(kDefaultMaxInflightQueries, kDefaultMaxQueuedQueries)) {}
 
 ServerNetworkManager::~ServerNetworkManager() {
     Stop();
@@ -1025,20 +1632,60 @@ void ServerNetworkManager::ProcessEvents() {
             handler->HandleEvent(events[i].events);
             
             if (handler->IsClosed()) {
-                // 从epoll中移除并删除连接处理器
-                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, handler->GetFd(), nullptr);
-                connections_.erase(handler->GetFd());
-                delete handler;
+                RemoveConnection(handler);
             }
         }
     }
+
+    // 本轮释放的名额按到达顺序分配给等待中的查询
+    DispatchQueuedQueries();
+#endif
+}
+
+void ServerNetworkManager::DispatchQueuedQueries() {
+    while (ConnectionHandler* handler = admission_->NextRunnable()) {
+        handler->RunPendingQuery();
+        if (handler->IsClosed()) {
+            RemoveConnection(handler);
+        }
+    }
+}
+
+void ServerNetworkManager::RemoveConnection(ConnectionHandler* handler) {
+#ifdef __linux__
+    // 从epoll中移除并删除连接处理器
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, handler->GetFd(), nullptr);
 #endif
+    connections_.erase(handler->GetFd());
+    delete handler;
 }
 
 void ServerNetworkManager::SetSqlExecutor(std::shared_ptr<sqlcc::SqlExecutor> sql_executor) {
     sql_executor_ = std::move(sql_executor);
 }
 
+void ServerNetworkManager::EnableZeroCopy(bool enabled) {
+    zerocopy_enabled_ = enabled;
+}
+
+void ServerNetworkManager::EnableCompression(bool enabled, size_t threshold) {
+    compression_enabled_ = enabled;
+    compression_threshold_ = threshold;
+}
+
+void ServerNetworkManager::SetAdmissionLimits(size_t max_inflight_queries, size_t max_queued_queries) {
+    admission_->SetLimits(max_inflight_queries, max_queued_queries);
+}
+
+void ServerNetworkManager::SetOutputBufferLimits(size_t high_watermark, size_t low_watermark) {
+    output_high_watermark_ = high_watermark;
+    output_low_watermark_ = low_watermark;
+}
+
+AdmissionStats ServerNetworkManager::GetAdmissionStats() const {
+    return admission_->GetStats();
+}
+
 void ServerNetworkManager::EnableTLS(bool enabled) {
 #ifdef __linux__
     tls_enabled_ = enabled;
@@ -1079,8 +1726,21 @@ void ServerNetworkManager::AcceptConnection() {
         return;
     }
 
+    // 连接数已达上限：明确拒绝，而不是无限制地接入
+    if (connections_.size() >= static_cast<size_t>(max_connections_)) {
+        RejectConnection(client_fd);
+        return;
+    }
+
     // 创建连接处理器，传入SQL执行器
     ConnectionHandler* handler = new ConnectionHandler(client_fd, session_manager_, sql_executor_);
+    handler->SetEpollFd(epoll_fd_);
+    handler->SetCompressionSupported(compression_enabled_, compression_threshold_);
+    handler->SetAdmissionController(admission_);
+    handler->SetOutputBufferLimits(output_high_watermark_, output_low_watermark_);
+    if (zerocopy_enabled_ && !tls_enabled_) {
+        handler->EnableZeroCopy(true);
+    }
 
     // 若启用TLS，在该连接上进行握手
     if (tls_enabled_ && ssl_ctx_) {
@@ -1121,5 +1781,28 @@ void ServerNetworkManager::AcceptConnection() {
 #endif
 }
 
+void ServerNetworkManager::RejectConnection(int client_fd) {
+#ifdef __linux__
+    admission_->RecordConnectionRejected();
+    // 明文连接上尽力发送一条过载错误（TLS握手之前无法发送，直接关闭）
+    if (!tls_enabled_) {
+        static const char kReason[] = "Too many connections";
+        MessageHeader header;
+        header.magic = 0x53514C43; // 'SQLC'
+        header.length = sizeof(kReason) - 1;
+        header.type = ERROR;
+        header.flags = ERROR_OVERLOADED;
+        header.sequence_id = 0;
+        char frame[sizeof(MessageHeader) + sizeof(kReason) - 1];
+        std::memcpy(frame, &header, sizeof(MessageHeader));
+        std::memcpy(frame + sizeof(MessageHeader), kReason, sizeof(kReason) - 1);
+        send(client_fd, frame, sizeof(frame), MSG_NOSIGNAL | MSG_DONTWAIT);
+    }
+    close(client_fd);
+#else
+    (void)client_fd;
+#endif
+}
+
 } // namespace network
-} // namespace sqlcc
\ No newline at end of file
+} // namespace sqlcc
@@ -19,7 +19,8 @@ IndexManager::~IndexManager() {
 
 bool IndexManager::CreateIndex(const std::string &index_name,
                                const std::string &table_name,
-                               const std::string &column_name, bool) {
+                               const std::string &column_name, bool,
+                               const std::vector<std::string> &included_columns) {
   SQLCC_LOG_INFO("Creating index: " + index_name + " on table: " + table_name +
                  ", column: " + column_name);
 
@@ -32,6 +33,7 @@ bool IndexManager::CreateIndex(const std::string &index_name,
   // 创建新的B+树索引
   auto index = std::make_unique<BPlusTreeIndex>(storage_engine_, table_name,
                                                 column_name);
+  index->SetIncludedColumns(included_columns);
   if (!index->Create()) {
     SQLCC_LOG_ERROR("Failed to create index: " + index_name);
     return false;
@@ -1,11 +1,16 @@
 #include "sql_executor.h"
+#include "config_manager.h"
 #include "core/permission_validator.h"
 #include "database_manager.h"
+#include "execution/result_cache.h"
 #include "execution_engine.h"
 #include "sql_parser/ast_nodes.h"
 #include "sql_parser/parser_new.h"
 #include "system_database.h"
 #include "user_manager.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -13,6 +18,110 @@
 
 namespace sqlcc {
 
+namespace {
+
+// executor.result_cache：是否启用查询结果缓存（默认关闭）；
+// executor.result_cache_mb：缓存的内存上限，只在配置值变化时重新设置
+bool ResultCacheEnabled() {
+  static std::atomic<int> applied_capacity_mb{
+      static_cast<int>(kDefaultResultCacheBytes / (1024 * 1024))};
+  auto &config = ConfigManager::GetInstance();
+  if (!config.GetBool("executor.result_cache", false)) {
+    return false;
+  }
+  int capacity_mb = config.GetInt("executor.result_cache_mb",
+                                  kDefaultResultCacheBytes / (1024 * 1024));
+  if (capacity_mb > 0 &&
+      applied_capacity_mb.exchange(capacity_mb) != capacity_mb) {
+    QueryResultCache::shared().set_capacity(static_cast<size_t>(capacity_mb) *
+                                            1024 * 1024);
+  }
+  return true;
+}
+
+// 可缓存的只读SELECT所读的表（主表和连接条件中"表.列"引用的表）。
+// 含子查询或不确定函数的查询每次执行结果可能不同，不缓存
+bool CollectCacheableTables(const sql_parser::Statement &stmt,
+                            const std::string &sql,
+                            std::vector<std::string> &tables) {
+  auto select_stmt = dynamic_cast<const sql_parser::SelectStatement *>(&stmt);
+  if (!select_stmt || select_stmt->getTableName().empty()) {
+    return false;
+  }
+  std::string upper_sql = sql;
+  std::transform(upper_sql.begin(), upper_sql.end(), upper_sql.begin(),
+                 ::toupper);
+  if (upper_sql.find("SELECT") != upper_sql.rfind("SELECT")) {
+    return false;
+  }
+  for (const char *function : {"NOW(", "RAND(", "RANDOM(", "UUID(", "SYSDATE",
+                               "CURRENT_DATE", "CURRENT_TIME"}) {
+    if (upper_sql.find(function) != std::string::npos) {
+      return false;
+    }
+  }
+
+  tables.push_back(select_stmt->getTableName());
+  const std::string &condition = select_stmt->getJoinCondition();
+  std::string identifier;
+  for (char c : condition) {
+    if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+      identifier += c;
+      continue;
+    }
+    if (c == '.' && !identifier.empty() &&
+        std::find(tables.begin(), tables.end(), identifier) == tables.end()) {
+      tables.push_back(identifier);
+    }
+    identifier.clear();
+  }
+  return true;
+}
+
+// 执行DDL之后使缓存中依赖被修改表的结果失效。INSERT/UPDATE/DELETE由DML
+// 执行策略在提交时使缓存失效；回滚的写入从未使结果失效，也无需清理。
+// 存储过程、删除数据库和回收权限的影响范围无法从语句确定，清空整个缓存
+void InvalidateResultCache(sql_parser::Statement::Type type,
+                           const std::string &table,
+                           const std::string &database) {
+  auto &cache = QueryResultCache::shared();
+  switch (type) {
+  case sql_parser::Statement::ALTER:
+  case sql_parser::Statement::DROP:
+    if (table.empty()) {
+      cache.clear();
+    } else {
+      cache.invalidate_table(database, table);
+    }
+    break;
+  case sql_parser::Statement::CALL_PROCEDURE:
+  case sql_parser::Statement::DROP_USER:
+  case sql_parser::Statement::REVOKE:
+    cache.clear();
+    break;
+  default:
+    break;
+  }
+}
+
+// DDL语句修改的表，DROP/ALTER数据库时为空
+std::string ModifiedTable(const sql_parser::Statement &stmt) {
+  if (auto drop_stmt =
+          dynamic_cast<const sql_parser::DropStatement *>(&stmt)) {
+    return drop_stmt->getObjectType() == sql_parser::DropStatement::DATABASE
+               ? ""
+               : drop_stmt->getObjectName();
+  } else if (auto alter_stmt =
+                 dynamic_cast<const sql_parser::AlterStatement *>(&stmt)) {
+    return alter_stmt->getObjectType() == sql_parser::AlterStatement::DATABASE
+               ? ""
+               : alter_stmt->getObjectName();
+  }
+  return "";
+}
+
+} // namespace
+
 // 构造函数实现
 SqlExecutor::SqlExecutor() {
   db_manager_ = std::make_shared<DatabaseManager>("./data", 1024, 16, 64);
@@ -44,6 +153,27 @@ std::string SqlExecutor::Execute(const std::string &sql) {
       return "Error: " + GetLastError();
     }
 
+    // 只读SELECT先按规范化SQL和权限上下文（数据库、用户）查找结果缓存，
+    // 未命中时在执行前记录所读表的版本
+    std::string database =
+        db_manager_ ? db_manager_->GetCurrentDatabase() : current_database_;
+    auto &result_cache = QueryResultCache::shared();
+    std::string cache_key;
+    std::vector<std::string> cache_tables;
+    std::vector<uint64_t> cache_versions;
+    if (ResultCacheEnabled() &&
+        CollectCacheableTables(*stmt, sql, cache_tables)) {
+      cache_key = QueryResultCache::make_key(database, current_user_, sql);
+      if (auto cached = result_cache.lookup(cache_key)) {
+        execution_stats_ = "查询结果缓存命中\n";
+        return cached->message.empty() ? "Query executed successfully"
+                                       : cached->message;
+      }
+      cache_versions = result_cache.table_versions(database, cache_tables);
+    }
+    sql_parser::Statement::Type statement_type = stmt->getType();
+    std::string modified_table = ModifiedTable(*stmt);
+
     // 权限验证 - 暂时跳过权限验证，直接执行语句
     // TODO: 实现完整的权限验证系统
     // auto permission_result =
@@ -72,6 +202,13 @@ std::string SqlExecutor::Execute(const std::string &sql) {
     // 保存执行统计信息
     execution_stats_ = query_plan->getExecutionStats();
 
+    // DDL失败时也可能已经修改了部分内容，同样使缓存失效
+    InvalidateResultCache(statement_type, modified_table, database);
+    if (result.success && !cache_key.empty()) {
+      result_cache.insert(cache_key, database, cache_tables, cache_versions,
+                          result);
+    }
+
     // 更新当前数据库（如果是USE语句）
     UpdateCurrentDatabase(sql);
 
@@ -106,8 +243,17 @@ std::string SqlExecutor::ExecuteFile(const std::string &file_path) {
 // 获取最后一次执行的错误信息
 std::string SqlExecutor::GetLastError() const { return last_error_; }
 
-// 获取执行统计信息
-std::string SqlExecutor::GetExecutionStats() const { return execution_stats_; }
+// 获取执行统计信息，附带服务器范围的查询结果缓存统计
+std::string SqlExecutor::GetExecutionStats() const {
+  QueryResultCache::Stats cache = QueryResultCache::shared().stats();
+  std::ostringstream stats;
+  stats << execution_stats_ << "查询结果缓存: 命中 " << cache.hits
+        << ", 未命中 " << cache.misses << ", 条目 " << cache.entries
+        << ", 内存 " << cache.bytes << "/" << cache.capacity << " 字节"
+        << ", 淘汰 " << cache.evictions << ", 失效 " << cache.invalidations
+        << "\n";
+  return stats.str();
+}
 
 // 设置错误信息
 void SqlExecutor::SetError(const std::string &error) { last_error_ = error; }
@@ -91,6 +91,8 @@ bool SystemDatabase::CreateSystemTables() {
     if (!CreateSysDistributedTransactionsTable()) return false;
     if (!CreateSysDistributedObjectsTable()) return false;
     if (!CreateSysTemporalTablesTable()) return false;
+    if (!CreateSysTableStatisticsTable()) return false;
+    if (!CreateSysColumnStatisticsTable()) return false;
     
     return true;
 }
@@ -535,6 +537,49 @@ bool SystemDatabase::CreateSysTemporalTablesTable() {
     return true;
 }
 
+bool SystemDatabase::CreateSysTableStatisticsTable() {
+    if (db_manager_->TableExists(SYS_TABLE_TABLE_STATISTICS)) {
+        return true;
+    }
+
+    std::vector<std::pair<std::string, std::string>> columns = {
+        {"table_id", "BIGINT PRIMARY KEY"},
+        {"row_count", "BIGINT NOT NULL"},
+        {"page_count", "BIGINT NOT NULL"},
+        {"analyzed_at", "TIMESTAMP NOT NULL"}
+    };
+
+    if (!db_manager_->CreateTable(SYS_TABLE_TABLE_STATISTICS, columns)) {
+        SetError("Failed to create sys_table_statistics table");
+        return false;
+    }
+
+    return true;
+}
+
+bool SystemDatabase::CreateSysColumnStatisticsTable() {
+    if (db_manager_->TableExists(SYS_TABLE_COLUMN_STATISTICS)) {
+        return true;
+    }
+
+    std::vector<std::pair<std::string, std::string>> columns = {
+        {"table_id", "BIGINT NOT NULL"},
+        {"column_name", "VARCHAR(255) NOT NULL"},
+        {"data_type", "VARCHAR(50) NOT NULL"},
+        {"null_fraction", "DOUBLE NOT NULL"},
+        {"distinct_count", "DOUBLE NOT NULL"},
+        {"histogram", "TEXT"},
+        {"analyzed_at", "TIMESTAMP NOT NULL"}
+    };
+
+    if (!db_manager_->CreateTable(SYS_TABLE_COLUMN_STATISTICS, columns)) {
+        SetError("Failed to create sys_column_statistics table");
+        return false;
+    }
+
+    return true;
+}
+
 bool SystemDatabase::InitializeDefaultData() {
     // TODO: 初始化默认的超级用户和角色
     // 这里需要实现默认数据的插入逻辑
@@ -1414,4 +1459,135 @@ std::vector<SysDistributedTransaction> SystemDatabase::GetActiveDistributedTrans
     return std::vector<SysDistributedTransaction>();
 }
 
+// 统计信息操作实现
+// ExecuteSQL尚未接入执行器，统计信息表直接通过表存储读写，保证ANALYZE的结果
+// 在重启后仍然可以读回。两张表的第一列都是table_id
+std::vector<std::vector<std::string>> SystemDatabase::ReadStatisticsRows(const std::string& table_name,
+                                                                         int64_t table_id) {
+    std::vector<std::vector<std::string>> rows;
+    auto storage_engine = db_manager_->GetStorageEngine();
+    if (!storage_engine) {
+        return rows;
+    }
+    TableStorageManager table_storage(storage_engine);
+    std::string id = std::to_string(table_id);
+    for (const auto& location : table_storage.ScanTable(table_name)) {
+        auto row = table_storage.GetRecord(table_name, location.first, location.second);
+        if (!row.empty() && row[0] == id) {
+            rows.push_back(std::move(row));
+        }
+    }
+    return rows;
+}
+
+bool SystemDatabase::ReplaceStatisticsRow(const std::string& table_name, int64_t table_id,
+                                          const std::string& column_name,
+                                          const std::vector<std::string>& values) {
+    auto storage_engine = db_manager_->GetStorageEngine();
+    if (!storage_engine) {
+        SetError("Storage engine not available");
+        return false;
+    }
+    TableStorageManager table_storage(storage_engine);
+    if (!table_storage.TableExists(table_name)) {
+        SetError("System table " + table_name + " does not exist");
+        return false;
+    }
+
+    // 每张表（或每列）只保留最近一次ANALYZE的结果
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    std::string id = std::to_string(table_id);
+    for (const auto& location : table_storage.ScanTable(table_name)) {
+        auto row = table_storage.GetRecord(table_name, location.first, location.second);
+        if (row.empty() || row[0] != id) {
+            continue;
+        }
+        if (!column_name.empty() && (row.size() < 2 || row[1] != column_name)) {
+            continue;
+        }
+        table_storage.DeleteRecord(table_name, location.first, location.second);
+    }
+
+    int32_t page_id = -1;
+    size_t offset = 0;
+    if (!table_storage.InsertRecord(table_name, values, page_id, offset)) {
+        SetError("Failed to write " + table_name);
+        return false;
+    }
+    return true;
+}
+
+bool SystemDatabase::SaveTableStatistics(int64_t table_id, int64_t row_count, int64_t page_count) {
+    try {
+        return ReplaceStatisticsRow(SYS_TABLE_TABLE_STATISTICS, table_id, "",
+                                    {std::to_string(table_id), std::to_string(row_count),
+                                     std::to_string(page_count), GetCurrentTimeString()});
+    } catch (const std::exception& e) {
+        SetError(std::string("SaveTableStatistics failed: ") + e.what());
+        return false;
+    }
+}
+
+bool SystemDatabase::SaveColumnStatistics(int64_t table_id, const std::string& column_name, const std::string& data_type,
+                                          double null_fraction, double distinct_count, const std::string& histogram) {
+    try {
+        // 浮点数按17位有效数字写入，读回时不丢精度
+        std::stringstream null_text;
+        std::stringstream distinct_text;
+        null_text << std::setprecision(17) << null_fraction;
+        distinct_text << std::setprecision(17) << distinct_count;
+        return ReplaceStatisticsRow(SYS_TABLE_COLUMN_STATISTICS, table_id, column_name,
+                                    {std::to_string(table_id), column_name, data_type, null_text.str(),
+                                     distinct_text.str(), histogram, GetCurrentTimeString()});
+    } catch (const std::exception& e) {
+        SetError(std::string("SaveColumnStatistics failed: ") + e.what());
+        return false;
+    }
+}
+
+std::vector<SysTableStatistics> SystemDatabase::GetTableStatistics(int64_t table_id) {
+    std::vector<SysTableStatistics> result;
+    try {
+        for (const auto& row : ReadStatisticsRows(SYS_TABLE_TABLE_STATISTICS, table_id)) {
+            if (row.size() < 4) {
+                continue;
+            }
+            SysTableStatistics statistics;
+            statistics.table_id = table_id;
+            statistics.row_count = std::stoll(row[1]);
+            statistics.page_count = std::stoll(row[2]);
+            statistics.analyzed_at = row[3];
+            result.push_back(statistics);
+        }
+    } catch (const std::exception& e) {
+        SetError(std::string("GetTableStatistics failed: ") + e.what());
+        result.clear();
+    }
+    return result;
+}
+
+std::vector<SysColumnStatistics> SystemDatabase::GetColumnStatistics(int64_t table_id) {
+    std::vector<SysColumnStatistics> result;
+    try {
+        for (const auto& row : ReadStatisticsRows(SYS_TABLE_COLUMN_STATISTICS, table_id)) {
+            if (row.size() < 7) {
+                continue;
+            }
+            SysColumnStatistics statistics;
+            statistics.table_id = table_id;
+            statistics.column_name = row[1];
+            statistics.data_type = row[2];
+            statistics.null_fraction = std::stod(row[3]);
+            statistics.distinct_count = std::stod(row[4]);
+            statistics.histogram = row[5];
+            statistics.analyzed_at = row[6];
+            result.push_back(statistics);
+        }
+    } catch (const std::exception& e) {
+        SetError(std::string("GetColumnStatistics failed: ") + e.what());
+        result.clear();
+    }
+    return result;
+}
+
 } // namespace sqlcc
\ No newline at end of file
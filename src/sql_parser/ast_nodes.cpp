@@ -115,6 +115,10 @@ void SelectStatement::setGroupByColumn(const std::string& column) {
     groupByColumn_ = column;
 }
 
+void SelectStatement::setHavingClause(const WhereClause& having) {
+    havingClause_ = having;
+}
+
 void SelectStatement::setOrderByColumn(const std::string& column) {
     orderByColumn_ = column;
 }
@@ -157,6 +161,10 @@ const std::string& SelectStatement::getGroupByColumn() const {
     return groupByColumn_;
 }
 
+const WhereClause& SelectStatement::getHavingClause() const {
+    return havingClause_;
+}
+
 const std::string& SelectStatement::getOrderByColumn() const {
     return orderByColumn_;
 }
@@ -189,6 +197,10 @@ bool SelectStatement::hasGroupBy() const {
     return !groupByColumn_.empty();
 }
 
+bool SelectStatement::hasHavingClause() const {
+    return !havingClause_.getColumnName().empty();
+}
+
 bool SelectStatement::hasOrderBy() const {
     return !orderByColumn_.empty();
 }
@@ -373,13 +385,22 @@ const std::string& CreateIndexStatement::getTableName() const {
 }
 
 const std::string& CreateIndexStatement::getColumnName() const {
-    return columns_.empty() ? "" : columns_[0];
+    static const std::string empty;
+    return columns_.empty() ? empty : columns_[0];
 }
 
 const std::vector<std::string>& CreateIndexStatement::getColumns() const {
     return columns_;
 }
 
+void CreateIndexStatement::addIncludedColumn(const std::string& column) {
+    includedColumns_.push_back(column);
+}
+
+const std::vector<std::string>& CreateIndexStatement::getIncludedColumns() const {
+    return includedColumns_;
+}
+
 void CreateIndexStatement::setUnique(bool unique) {
     unique_ = unique;
 }
@@ -584,6 +605,43 @@ bool ShowStatement::hasFromDatabase() const {
     return hasFromDb_;
 }
 
+// ==================== AnalyzeStatement ====================
+
+AnalyzeStatement::AnalyzeStatement() : Statement(ANALYZE) {
+}
+
+AnalyzeStatement::AnalyzeStatement(const std::string& tableName)
+    : Statement(ANALYZE), tableName_(tableName) {
+}
+
+AnalyzeStatement::~AnalyzeStatement() {
+}
+
+const std::string& AnalyzeStatement::getTableName() const {
+    return tableName_;
+}
+
+bool AnalyzeStatement::hasTableName() const {
+    return !tableName_.empty();
+}
+
+// ==================== ExplainStatement ====================
+
+ExplainStatement::ExplainStatement(std::unique_ptr<Statement> statement, bool analyze)
+    : Statement(EXPLAIN), statement_(std::move(statement)), analyze_(analyze) {
+}
+
+ExplainStatement::~ExplainStatement() {
+}
+
+Statement* ExplainStatement::getStatement() const {
+    return statement_.get();
+}
+
+bool ExplainStatement::isAnalyze() const {
+    return analyze_;
+}
+
 // ==================== ProcedureParameter ====================
 
 ProcedureParameter::ProcedureParameter(const std::string& name, const std::string& type, Mode mode)
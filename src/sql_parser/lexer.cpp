@@ -305,6 +305,10 @@ Token Lexer::readIdentifier() {
     type = Token::KEYWORD_DATABASES;
   else if (upper_value == "TABLES")
     type = Token::KEYWORD_TABLES;
+  else if (upper_value == "ANALYZE")
+    type = Token::KEYWORD_ANALYZE;
+  else if (upper_value == "EXPLAIN")
+    type = Token::KEYWORD_EXPLAIN;
 
   return Token(type, value, line_, column_);
 }
@@ -127,6 +127,11 @@ void LexerNew::setupTransitionTable() {
         {'"', LexerState::STRING_DOUBLE}
     };
 
+    // 两个字符的比较运算符：<=、>=、!=、<>
+    transitions_[LexerState::OPERATOR] = {
+        {'=', LexerState::OPERATOR}, {'>', LexerState::OPERATOR}
+    };
+
     // Add transitions for identifiers and numbers
     for (char c = 'a'; c <= 'z'; ++c) {
         transitions_[LexerState::START][c] = LexerState::IDENTIFIER;
@@ -135,7 +140,7 @@ void LexerNew::setupTransitionTable() {
     transitions_[LexerState::START]['_'] = LexerState::IDENTIFIER;
 
     // Add Unicode support for identifier start
-    for (unsigned char c = 128; c <= 255; ++c) {
+    for (int c = 128; c <= 255; ++c) {
         transitions_[LexerState::START][static_cast<char>(c)] = LexerState::IDENTIFIER;
     }
 
@@ -156,7 +161,7 @@ void LexerNew::setupTransitionTable() {
     transitions_[LexerState::IDENTIFIER]['_'] = LexerState::IDENTIFIER;
 
     // Add Unicode support for identifier continuation
-    for (unsigned char c = 128; c <= 255; ++c) {
+    for (int c = 128; c <= 255; ++c) {
         transitions_[LexerState::IDENTIFIER][static_cast<char>(c)] = LexerState::IDENTIFIER;
     }
 
@@ -252,6 +257,11 @@ Token LexerNew::nextToken() {
         int start_line = line_;
         int start_column = column_;
 
+        // 字符串的内容可以是任意字符，不经过转移表
+        if (ch == '\'' || ch == '"') {
+            return scanQuoted(start_line, start_column);
+        }
+
         // DFA processing
         while (!isAtEnd()) {
             ch = peek();
@@ -272,6 +282,12 @@ Token LexerNew::nextToken() {
             advance();
         }
 
+        // 无法识别的字符单独作为一个UNKNOWN记号，避免停在原地
+        if (position_ == static_cast<size_t>(start_pos)) {
+            advance();
+            return Token(Token::UNKNOWN, std::string(1, ch), start_line, start_column);
+        }
+
         // Create token based on final state
         std::string lexeme = input_.substr(start_pos, position_ - start_pos);
         return createToken(current_state_, lexeme, start_line, start_column);
@@ -387,6 +403,8 @@ Token LexerNew::createKeywordToken(const std::string& keyword, int line, int col
         keywordMap["password"] = Token::KEYWORD_PASSWORD;
         keywordMap["identified"] = Token::KEYWORD_IDENTIFIED;
         keywordMap["show"] = Token::KEYWORD_SHOW;
+        keywordMap["analyze"] = Token::KEYWORD_ANALYZE;
+        keywordMap["explain"] = Token::KEYWORD_EXPLAIN;
 
         // Logical Operators
         keywordMap["and"] = Token::KEYWORD_AND;
@@ -432,6 +450,7 @@ Token LexerNew::createOperatorToken(const std::string& lexeme, int line, int col
         {"/", Token::OPERATOR_DIVIDE},
         {"=", Token::OPERATOR_EQUAL},
         {"!=", Token::OPERATOR_NOT_EQUAL},
+        {"<>", Token::OPERATOR_NOT_EQUAL},
         {"<", Token::OPERATOR_LESS_THAN},
         {"<=", Token::OPERATOR_LESS_EQUAL},
         {">", Token::OPERATOR_GREATER_THAN},
@@ -466,6 +485,35 @@ Token LexerNew::createPunctuationToken(const std::string& lexeme, int line, int
     return Token(Token::UNKNOWN, lexeme, line, column);
 }
 
+Token LexerNew::scanQuoted(int line, int column) {
+    char quote = advance();
+    std::string value;
+    while (!isAtEnd()) {
+        char ch = advance();
+        if (ch == quote) {
+            // 连续两个引号表示引号本身
+            if (peek() == quote) {
+                value += advance();
+                continue;
+            }
+            return Token(quote == '\'' ? Token::STRING_LITERAL : Token::IDENTIFIER,
+                         value, line, column);
+        }
+        if (ch == '\\' && quote == '\'' && !isAtEnd()) {
+            char escaped = advance();
+            switch (escaped) {
+                case 'n': value += '\n'; break;
+                case 't': value += '\t'; break;
+                case 'r': value += '\r'; break;
+                default: value += escaped; break;
+            }
+            continue;
+        }
+        value += ch;
+    }
+    return Token(Token::UNKNOWN, std::string(1, quote) + value, line, column);
+}
+
 void LexerNew::skipLineComment() {
     // Skip '--' and rest of line
     advance(); // skip first '-'
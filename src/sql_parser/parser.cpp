@@ -8,6 +8,15 @@
 namespace sqlcc {
 namespace sql_parser {
 
+namespace {
+
+bool isIncludeKeyword(std::string lexeme) {
+  std::transform(lexeme.begin(), lexeme.end(), lexeme.begin(), ::toupper);
+  return lexeme == "INCLUDE";
+}
+
+} // namespace
+
 Parser::Parser(const std::string &input) : lexer_(input) { nextToken(); }
 
 void Parser::nextToken() { currentToken_ = lexer_.nextToken(); }
@@ -86,6 +95,10 @@ std::unique_ptr<Statement> Parser::parseStatement() {
     return parseRevokeStatement();
   } else if (match(Token::KEYWORD_SHOW)) {
     return parseShowStatement();
+  } else if (match(Token::KEYWORD_ANALYZE)) {
+    return parseAnalyzeStatement();
+  } else if (match(Token::KEYWORD_EXPLAIN)) {
+    return parseExplainStatement();
   } else {
     reportError("Unexpected token: " + currentToken_.getLexeme());
     return nullptr;
@@ -224,6 +237,25 @@ std::unique_ptr<CreateIndexStatement> Parser::parseCreateIndexStatement() {
 
   consume(Token::RPAREN);
 
+  // INCLUDE (col, ...)：INCLUDE不是保留字，按标识符识别
+  if (match(Token::IDENTIFIER) && isIncludeKeyword(currentToken_.getLexeme())) {
+    consume();
+    consume(Token::LPAREN);
+    while (true) {
+      if (!match(Token::IDENTIFIER)) {
+        reportError("Expected included column name");
+        return nullptr;
+      }
+      stmt->addIncludedColumn(currentToken_.getLexeme());
+      consume();
+      if (!match(Token::COMMA)) {
+        break;
+      }
+      consume(); // 消耗逗号
+    }
+    consume(Token::RPAREN);
+  }
+
   return stmt;
 }
 
@@ -351,6 +383,10 @@ std::unique_ptr<SelectStatement> Parser::parseSelectStatement() {
     parseGroupByClause(*stmt);
   }
 
+  if (match(Token::KEYWORD_HAVING)) {
+    parseHavingClause(*stmt);
+  }
+
   if (match(Token::KEYWORD_ORDER)) {
     parseOrderByClause(*stmt);
   }
@@ -591,10 +627,13 @@ void Parser::parseJoinCondition(SelectStatement &stmt) {
   std::string column2 = currentToken_.getLexeme();
   consume();
 
-  // 保存连接条件（简化处理，只保存第一个连接条件）
+  // 多个JOIN的连接条件以AND合并，由优化器决定连接顺序
+  std::string condition =
+      table1 + "." + column1 + " = " + table2 + "." + column2;
   if (stmt.getJoinCondition().empty()) {
-    stmt.setJoinCondition(table1 + "." + column1 + " = " + table2 + "." +
-                          column2);
+    stmt.setJoinCondition(condition);
+  } else {
+    stmt.setJoinCondition(stmt.getJoinCondition() + " AND " + condition);
   }
 }
 
@@ -603,6 +642,7 @@ void Parser::parseWhereClause(SelectStatement &stmt) {
 
   // 解析条件表达式
   std::string condition;
+  std::vector<Token> tokens;
 
   // 简化处理，只收集条件字符串，不进行详细解析
   int paren_count = 0;
@@ -665,11 +705,31 @@ void Parser::parseWhereClause(SelectStatement &stmt) {
       }
     } else {
       // 普通条件
+      tokens.push_back(currentToken_);
       condition += " " + currentToken_.getLexeme();
       consume();
     }
   }
 
+  // "列 比较符 常量"形式的条件按列、操作符和值保存，与UPDATE/DELETE一致，
+  // 其他条件只保存条件字符串
+  if (tokens.size() == 3 && condition.find('(') == std::string::npos &&
+      tokens[0].getType() == Token::IDENTIFIER &&
+      (tokens[1].getType() == Token::OPERATOR_EQUAL ||
+       tokens[1].getType() == Token::OPERATOR_NOT_EQUAL ||
+       tokens[1].getType() == Token::OPERATOR_LESS_THAN ||
+       tokens[1].getType() == Token::OPERATOR_LESS_EQUAL ||
+       tokens[1].getType() == Token::OPERATOR_GREATER_THAN ||
+       tokens[1].getType() == Token::OPERATOR_GREATER_EQUAL) &&
+      (tokens[2].getType() == Token::STRING_LITERAL ||
+       tokens[2].getType() == Token::INTEGER_LITERAL ||
+       tokens[2].getType() == Token::FLOAT_LITERAL)) {
+    stmt.setWhereClause(WhereClause(tokens[0].getLexeme(),
+                                    tokens[1].getLexeme(),
+                                    tokens[2].getLexeme()));
+    return;
+  }
+
   // 简化处理，只保存条件字符串
   WhereClause whereClause("", "", condition);
   stmt.setWhereClause(whereClause);
@@ -716,6 +776,41 @@ void Parser::parseGroupByClause(SelectStatement &stmt) {
   } while (match(Token::IDENTIFIER) || match(Token::LPAREN));
 }
 
+void Parser::parseHavingClause(SelectStatement &stmt) {
+  consume(Token::KEYWORD_HAVING);
+
+  // 简化处理：只支持"聚合表达式 比较符 字面值"形式，左侧拼接为"COUNT(*)"
+  auto isComparison = [](const std::string &lexeme) {
+    return lexeme == "=" || lexeme == "<>" || lexeme == "!=" ||
+           lexeme == "<" || lexeme == "<=" || lexeme == ">" || lexeme == ">=";
+  };
+  std::string column;
+  while (!isComparison(currentToken_.getLexeme()) &&
+         !match(Token::END_OF_INPUT)) {
+    column += currentToken_.getLexeme();
+    consume();
+  }
+  if (column.empty() || match(Token::END_OF_INPUT)) {
+    reportError("Expected comparison in HAVING");
+    return;
+  }
+
+  std::string op = currentToken_.getLexeme();
+  consume();
+
+  std::string value = currentToken_.getLexeme();
+  if (match(Token::STRING_LITERAL)) {
+    value = "'" + value + "'";
+  } else if (!match(Token::INTEGER_LITERAL) && !match(Token::FLOAT_LITERAL) &&
+             !match(Token::IDENTIFIER)) {
+    reportError("Expected value in HAVING");
+    return;
+  }
+  consume();
+
+  stmt.setHavingClause(WhereClause(column, op, value));
+}
+
 void Parser::parseOrderByClause(SelectStatement &stmt) {
   consume(Token::KEYWORD_ORDER);
   expect(Token::KEYWORD_BY, "Expected BY after ORDER");
@@ -847,33 +942,52 @@ void Parser::parseInsertColumns(InsertStatement &stmt) {
 }
 
 void Parser::parseInsertValues(InsertStatement &stmt) {
-  consume(Token::LPAREN);
+  // 每个括号是一行，多行之间用逗号分隔
+  while (true) {
+    consume(Token::LPAREN);
 
-  do {
-    if (match(Token::STRING_LITERAL) || match(Token::INTEGER_LITERAL) ||
-        match(Token::FLOAT_LITERAL)) {
-      std::string value = currentToken_.getLexeme();
-      stmt.addValue(value);
-      consume();
-    } else if (match(Token::KEYWORD_NULL) ||
-               currentToken_.getLexeme() == "NULL") {
-      // 处理NULL值
-      stmt.addValue("NULL");
-      consume();
-    } else {
-      reportError("Expected string, number, or NULL literal");
-      return;
-    }
+    do {
+      if (match(Token::STRING_LITERAL) || match(Token::INTEGER_LITERAL) ||
+          match(Token::FLOAT_LITERAL)) {
+        std::string value = currentToken_.getLexeme();
+        stmt.addValue(value);
+        consume();
+      } else if (match(Token::OPERATOR_MINUS) || match(Token::OPERATOR_PLUS)) {
+        // 带符号的数值
+        std::string sign = match(Token::OPERATOR_MINUS) ? "-" : "";
+        consume();
+        if (!match(Token::INTEGER_LITERAL) && !match(Token::FLOAT_LITERAL)) {
+          reportError("Expected number after sign");
+          return;
+        }
+        stmt.addValue(sign + currentToken_.getLexeme());
+        consume();
+      } else if (match(Token::KEYWORD_NULL) ||
+                 currentToken_.getLexeme() == "NULL") {
+        // 处理NULL值
+        stmt.addValue("NULL");
+        consume();
+      } else {
+        reportError("Expected string, number, or NULL literal");
+        return;
+      }
 
-    if (!match(Token::COMMA)) {
-      break;
-    }
+      if (!match(Token::COMMA)) {
+        break;
+      }
 
-    consume(); // 消费逗号
+      consume(); // 消费逗号
 
-  } while (!match(Token::RPAREN));
+    } while (!match(Token::RPAREN));
 
-  consume(Token::RPAREN);
+    consume(Token::RPAREN);
+    stmt.finishRow();
+
+    if (!match(Token::COMMA)) {
+      break;
+    }
+    consume(); // 消费行之间的逗号
+  }
 }
 
 std::unique_ptr<UpdateStatement> Parser::parseUpdateStatement() {
@@ -1162,6 +1276,34 @@ std::unique_ptr<UseStatement> Parser::parseUseStatement() {
   return stmt;
 }
 
+// ANALYZE [table]
+std::unique_ptr<AnalyzeStatement> Parser::parseAnalyzeStatement() {
+  consume(Token::KEYWORD_ANALYZE);
+
+  if (match(Token::IDENTIFIER)) {
+    std::string tableName = currentToken_.getLexeme();
+    consume();
+    return std::make_unique<AnalyzeStatement>(tableName);
+  }
+  return std::make_unique<AnalyzeStatement>();
+}
+
+// EXPLAIN [ANALYZE] SELECT ...
+std::unique_ptr<ExplainStatement> Parser::parseExplainStatement() {
+  consume(Token::KEYWORD_EXPLAIN);
+
+  bool analyze = false;
+  if (match(Token::KEYWORD_ANALYZE)) {
+    consume();
+    analyze = true;
+  }
+  if (!match(Token::KEYWORD_SELECT)) {
+    reportError("Expected SELECT after EXPLAIN");
+    return nullptr;
+  }
+  return std::make_unique<ExplainStatement>(parseSelectStatement(), analyze);
+}
+
 // DCL语句解析方法
 std::unique_ptr<Statement> Parser::parseCreateUserStatement() {
   // USER关键字已经被parseCreateStatement函数消耗了，所以这里不需要再消耗
@@ -8,6 +8,15 @@
 namespace sqlcc {
 namespace sql_parser {
 
+namespace {
+
+bool isIncludeKeyword(std::string lexeme) {
+  std::transform(lexeme.begin(), lexeme.end(), lexeme.begin(), ::toupper);
+  return lexeme == "INCLUDE";
+}
+
+} // namespace
+
 ParserNew::ParserNew(const std::string &input)
     : lexer_(input), hasLookahead_(false), panicMode_(false) {
   initializeSyncTokens();
@@ -132,7 +141,8 @@ void ParserNew::initializeSyncTokens() {
       Token::KEYWORD_SELECT, Token::KEYWORD_INSERT, Token::KEYWORD_UPDATE,
       Token::KEYWORD_DELETE, Token::KEYWORD_CREATE, Token::KEYWORD_DROP,
       Token::KEYWORD_ALTER,  Token::KEYWORD_GRANT,  Token::KEYWORD_REVOKE,
-      Token::KEYWORD_SHOW,   Token::KEYWORD_COMMIT, Token::KEYWORD_ROLLBACK};
+      Token::KEYWORD_SHOW,   Token::KEYWORD_COMMIT, Token::KEYWORD_ROLLBACK,
+      Token::KEYWORD_ANALYZE, Token::KEYWORD_EXPLAIN};
 }
 
 // Statement parsing (strict BNF compliance)
@@ -161,6 +171,10 @@ std::unique_ptr<Statement> ParserNew::parseStatement() {
     return parseTCLStatement();
   } else if (match(Token::KEYWORD_SHOW)) {
     return parseShowStatement();
+  } else if (match(Token::KEYWORD_ANALYZE)) {
+    return parseAnalyzeStatement();
+  } else if (match(Token::KEYWORD_EXPLAIN)) {
+    return parseExplainStatement();
   } else {
     reportError("Unexpected token: " + currentToken_.getLexeme());
     return nullptr;
@@ -215,6 +229,24 @@ std::unique_ptr<Statement> ParserNew::parseShowStatement() {
   return nullptr;
 }
 
+// ANALYZE [table_name]
+std::unique_ptr<Statement> ParserNew::parseAnalyzeStatement() {
+  if (check(Token::IDENTIFIER)) {
+    return std::make_unique<AnalyzeStatement>(parseIdentifier());
+  }
+  return std::make_unique<AnalyzeStatement>();
+}
+
+// EXPLAIN [ANALYZE] select_statement
+std::unique_ptr<Statement> ParserNew::parseExplainStatement() {
+  bool analyze = match(Token::KEYWORD_ANALYZE);
+  if (!match(Token::KEYWORD_SELECT)) {
+    reportError("Expected SELECT after EXPLAIN");
+    return nullptr;
+  }
+  return std::make_unique<ExplainStatement>(parseSelectStatement(), analyze);
+}
+
 // DDL statements
 std::unique_ptr<CreateStatement> ParserNew::parseCreateDatabaseStatement() {
   consume(Token::KEYWORD_DATABASE);
@@ -274,6 +306,17 @@ std::unique_ptr<CreateIndexStatement> ParserNew::parseCreateIndexStatement() {
     stmt->setUnique(true);
   }
 
+  // INCLUDE (col, ...)：INCLUDE不是保留字，按标识符识别
+  if (check(Token::IDENTIFIER) &&
+      isIncludeKeyword(currentToken_.getLexeme())) {
+    advance();
+    consume(Token::LPAREN);
+    do {
+      stmt->addIncludedColumn(parseIdentifier());
+    } while (match(Token::COMMA));
+    consume(Token::RPAREN);
+  }
+
   return stmt;
 }
 
@@ -113,6 +113,8 @@ std::string Token::getTypeName(Type type) {
         case KEYWORD_WITH: return "WITH";
         case KEYWORD_PASSWORD: return "PASSWORD";
         case KEYWORD_IDENTIFIED: return "IDENTIFIED";
+        case KEYWORD_ANALYZE: return "ANALYZE";
+        case KEYWORD_EXPLAIN: return "EXPLAIN";
         case MULTIPLY: return "MULTIPLY";
         case END_OF_INPUT: return "END_OF_INPUT";
         case ERROR: return "ERROR";
@@ -162,6 +162,8 @@ std::string Token::getTypeName(Type type) {
         {KEYWORD_GRANTS, "KEYWORD_GRANTS"},
         {KEYWORD_DATABASES, "KEYWORD_DATABASES"},
         {KEYWORD_TABLES, "KEYWORD_TABLES"},
+        {KEYWORD_ANALYZE, "KEYWORD_ANALYZE"},
+        {KEYWORD_EXPLAIN, "KEYWORD_EXPLAIN"},
         {KEYWORD_TRUE, "KEYWORD_TRUE"},
         {KEYWORD_FALSE, "KEYWORD_FALSE"},
         
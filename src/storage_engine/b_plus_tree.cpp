@@ -29,6 +29,12 @@
 #include "logger.h"
 #include "page.h"
 #include "storage_engine.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
 
@@ -159,9 +165,14 @@ namespace sqlcc {
 // Page header for B+Tree nodes (存储在页面头部的B+树节点元数据)
 // Page header format:
 // [is_leaf(1)] [key_count(4)] [parent_page_id(4)] [next_page_id(4)]
-// [padding(7)]
+// [leaf_format(1)] [padding(6)]
 #define PAGE_HEADER_SIZE 20
 #define PAGE_DATA_SIZE (PAGE_SIZE - PAGE_HEADER_SIZE)
+// 叶子页格式：0为旧格式，1为每个条目带INCLUDE列的值
+#define BPLUS_TREE_LEAF_FORMAT 1
+// 叶子节点序列化后超过一半数据区时分裂，单个条目不能超过一半数据区，
+// 保证插入后、分裂前的叶子仍能写入一页
+#define BPLUS_TREE_MAX_ENTRY_BYTES (PAGE_DATA_SIZE / 2)
 
 /**
  * @class BPlusTreeNode
@@ -546,7 +557,7 @@ void BPlusTreeInternalNode::InsertChild(int32_t child_page_id,
   size_t pos = it - keys_.begin();
 
   // 插入键和子节点ID
-  if (keys_.empty()) {
+  if (child_page_ids_.empty()) {
     // 第一个子节点，只添加子节点ID，不添加键
     child_page_ids_.push_back(child_page_id);
   } else if (it == keys_.end()) {
@@ -584,13 +595,14 @@ void BPlusTreeInternalNode::RemoveChild(int32_t child_page_id) {
 }
 
 int32_t BPlusTreeInternalNode::FindChildPageId(const std::string &key) const {
-  // 二分查找找到第一个大于等于key的位置
-  auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+  // 二分查找找到第一个大于key的位置
+  auto it = std::upper_bound(keys_.begin(), keys_.end(), key);
   size_t pos = it - keys_.begin();
 
   // 根据B+树的搜索规则：
   // - 如果key小于所有键，返回第一个子节点
   // - 如果key大于等于某个键，返回该键右侧的子节点
+  //   （分裂时提升的键是右侧节点的第一个键，等于它的键在右侧）
   return child_page_ids_[pos];
 }
 
@@ -602,6 +614,8 @@ void BPlusTreeInternalNode::Split(BPlusTreeInternalNode *&new_node) {
   int32_t new_page_id;
   storage_engine_->NewPage(&new_page_id);
   new_node = new BPlusTreeInternalNode(storage_engine_, new_page_id);
+  // 节点自己持有一次固定，释放NewPage留下的那次
+  storage_engine_->UnpinPage(new_page_id, true);
 
   // 计算中间位置
   size_t mid = keys_.size() / 2;
@@ -742,8 +756,9 @@ BPlusTreeLeafNode::~BPlusTreeLeafNode() {
  *
  * @par 页面格式
  * - 页面头部：is_leaf(1字节) + key_count(4字节) + parent_page_id(4字节) +
- * next_page_id(4字节) + padding(7字节)
- * - 页面数据：键长度(4字节) + 键内容 + 数据长度(4字节) + 数据内容，重复n次
+ * next_page_id(4字节) + leaf_format(1字节) + padding(6字节)
+ * - 页面数据：键长度(4字节) + 键内容 + 页面ID(4字节) + 偏移量(8字节) +
+ * INCLUDE值个数(4字节) + (值长度(4字节) + 值内容)*，重复n次
  *
  * @par 注意事项
  * - 序列化后页面会被标记为脏页，在UnpinPage时写入磁盘
@@ -759,6 +774,7 @@ void BPlusTreeLeafNode::SerializeToPage() {
       static_cast<int32_t>(entries_.size());                // 条目数量
   *reinterpret_cast<int32_t *>(data + 5) = parent_page_id_; // 父节点ID
   *reinterpret_cast<int32_t *>(data + 9) = next_page_id_;   // 下一节点ID
+  data[13] = BPLUS_TREE_LEAF_FORMAT;
 
   // 序列化条目
   size_t offset = PAGE_HEADER_SIZE;
@@ -777,6 +793,18 @@ void BPlusTreeLeafNode::SerializeToPage() {
     offset += sizeof(int32_t);
     memcpy(data + offset, &entry.offset, sizeof(size_t));
     offset += sizeof(size_t);
+
+    // 序列化INCLUDE列的值
+    int32_t included_count = static_cast<int32_t>(entry.included_values.size());
+    memcpy(data + offset, &included_count, sizeof(int32_t));
+    offset += sizeof(int32_t);
+    for (const auto &value : entry.included_values) {
+      int32_t value_len = static_cast<int32_t>(value.size());
+      memcpy(data + offset, &value_len, sizeof(int32_t));
+      offset += sizeof(int32_t);
+      memcpy(data + offset, value.data(), value_len);
+      offset += value_len;
+    }
   }
 
   // 页面已修改，将在UnpinPage时标记为脏页
@@ -792,8 +820,9 @@ void BPlusTreeLeafNode::SerializeToPage() {
  *
  * @par 页面格式
  * - 页面头部：is_leaf(1字节) + key_count(4字节) + parent_page_id(4字节) +
- * next_page_id(4字节) + padding(7字节)
- * - 页面数据：键长度(4字节) + 键内容 + 页面ID(4字节) + 偏移量(8字节)，重复n次
+ * next_page_id(4字节) + leaf_format(1字节) + padding(6字节)
+ * - 页面数据：键长度(4字节) + 键内容 + 页面ID(4字节) + 偏移量(8字节)，
+ * 格式1的每个条目后跟INCLUDE列的值，重复n次
  *
  * @par 注意事项
  * - 反序列化前会清空节点的现有数据
@@ -808,6 +837,7 @@ void BPlusTreeLeafNode::DeserializeFromPage() {
   int32_t entry_count = *reinterpret_cast<int32_t *>(data + 1);
   parent_page_id_ = *reinterpret_cast<int32_t *>(data + 5);
   next_page_id_ = *reinterpret_cast<int32_t *>(data + 9);
+  bool has_included = data[13] == BPLUS_TREE_LEAF_FORMAT;
 
   entries_.clear();
 
@@ -827,7 +857,21 @@ void BPlusTreeLeafNode::DeserializeFromPage() {
     size_t off = *reinterpret_cast<size_t *>(data + offset);
     offset += sizeof(size_t);
 
-    entries_.emplace_back(key, page_id, off);
+    // 反序列化INCLUDE列的值
+    std::vector<std::string> included;
+    if (has_included) {
+      int32_t included_count = *reinterpret_cast<int32_t *>(data + offset);
+      offset += sizeof(int32_t);
+      included.reserve(included_count);
+      for (int32_t j = 0; j < included_count; ++j) {
+        int32_t value_len = *reinterpret_cast<int32_t *>(data + offset);
+        offset += sizeof(int32_t);
+        included.emplace_back(data + offset, value_len);
+        offset += value_len;
+      }
+    }
+
+    entries_.emplace_back(key, page_id, off, std::move(included));
   }
 }
 
@@ -847,7 +891,15 @@ void BPlusTreeLeafNode::DeserializeFromPage() {
  * - 最大键数量的设计考虑了磁盘页大小和索引效率的平衡
  */
 bool BPlusTreeLeafNode::IsFull() const {
-  return entries_.size() >= BPLUS_TREE_MAX_KEYS;
+  if (entries_.size() >= BPLUS_TREE_MAX_KEYS) {
+    return true;
+  }
+  // 带INCLUDE列的条目较大，按序列化后的字节数判断
+  size_t bytes = 0;
+  for (const auto &entry : entries_) {
+    bytes += entry.SerializedSize();
+  }
+  return bytes > BPLUS_TREE_MAX_ENTRY_BYTES;
 }
 
 /**
@@ -1057,6 +1109,8 @@ void BPlusTreeLeafNode::Split(BPlusTreeLeafNode *&new_node) {
   int32_t new_page_id;
   storage_engine_->NewPage(&new_page_id);
   new_node = new BPlusTreeLeafNode(storage_engine_, new_page_id);
+  // 节点自己持有一次固定，释放NewPage留下的那次
+  storage_engine_->UnpinPage(new_page_id, true);
 
   // 计算中间位置
   size_t mid = entries_.size() / 2;
@@ -1233,6 +1287,8 @@ bool BPlusTreeIndex::Create() {
     storage_engine_->DeletePage(root_page_id_);
     return false;
   }
+  // 节点自己持有一次固定，释放NewPage留下的那次
+  storage_engine_->UnpinPage(root_page_id_, true);
 
   // 序列化根节点到页面
   root_node->SerializeToPage();
@@ -1325,6 +1381,11 @@ bool BPlusTreeIndex::Insert(const IndexEntry &entry) {
   if (!storage_engine_)
     return false;
 
+  if (entry.SerializedSize() > BPLUS_TREE_MAX_ENTRY_BYTES) {
+    SQLCC_LOG_ERROR("Index entry too large for index: " + index_name_);
+    return false;
+  }
+
   // 如果树为空，创建根节点
   if (root_page_id_ < 0) {
     if (!Create())
@@ -1350,6 +1411,7 @@ bool BPlusTreeIndex::Insert(const IndexEntry &entry) {
     // 创建新的内部节点作为根节点，直接使用新分配的页面ID
     BPlusTreeInternalNode *new_root =
         new BPlusTreeInternalNode(storage_engine_, new_root_page_id);
+    storage_engine_->UnpinPage(new_root_page_id, true);
 
     // 使用InsertChild方法添加第一个子节点
     // 对于第一个子节点，我们使用一个空字符串作为键，因为内部节点的第一个子节点不需要键
@@ -1523,6 +1585,217 @@ BPlusTreeIndex::SearchRange(const std::string &lower_bound,
   return results;
 }
 
+/**
+ * @brief 从指定键开始按序扫描索引
+ * @details 从根节点下降到lower_bound所在的叶子节点，然后沿叶子节点链按键升序
+ * 收集条目，收集到max_entries个后立即停止，不再加载后续叶子节点
+ *
+ * @param lower_bound 起始键（包含），空字符串表示从最小键开始
+ * @param max_entries 最多返回的条目数
+ * @return std::vector<IndexEntry> - 按键有序的条目
+ *
+ * @par 算法复杂度
+ * - 时间复杂度：O(logn + k)，k为返回的条目数，与索引大小无关
+ *
+ * @par 注意事项
+ * - 用于ORDER BY 索引列 LIMIT n 的提前终止扫描，调用方可以用上次返回的
+ *   最后一个键作为下一次的起始键分块读取
+ */
+std::vector<IndexEntry>
+BPlusTreeIndex::ScanFrom(const std::string &lower_bound,
+                         size_t max_entries) const {
+  std::vector<IndexEntry> results;
+  if (!storage_engine_ || root_page_id_ < 0 || max_entries == 0)
+    return results;
+
+  BPlusTreeNode *node =
+      const_cast<BPlusTreeIndex *>(this)->LoadNode(root_page_id_);
+  while (node && !node->IsLeaf()) {
+    BPlusTreeInternalNode *internal =
+        dynamic_cast<BPlusTreeInternalNode *>(node);
+    int32_t child_page_id = internal->FindChildPageId(lower_bound);
+    delete node;
+    node = const_cast<BPlusTreeIndex *>(this)->LoadNode(child_page_id);
+  }
+
+  std::unordered_set<int32_t> visited_pages;
+  while (node) {
+    BPlusTreeLeafNode *leaf = dynamic_cast<BPlusTreeLeafNode *>(node);
+    if (!leaf || !visited_pages.insert(leaf->GetPageId()).second) {
+      break;
+    }
+    const auto &entries = leaf->GetEntries();
+    auto it = std::lower_bound(entries.begin(), entries.end(),
+                               IndexEntry(lower_bound, 0, 0));
+    for (; it != entries.end() && results.size() < max_entries; ++it) {
+      results.push_back(*it);
+    }
+
+    int32_t next_page_id = leaf->GetNextPageId();
+    delete node;
+    node = nullptr;
+    if (results.size() >= max_entries || next_page_id == -1) {
+      break;
+    }
+    node = const_cast<BPlusTreeIndex *>(this)->LoadNode(next_page_id);
+  }
+  delete node;
+
+  return results;
+}
+
+namespace {
+
+enum class KeyKind { TEXT, INTEGER, REAL };
+
+KeyKind key_kind(const std::string &column_type) {
+  std::string type = column_type;
+  std::transform(type.begin(), type.end(), type.begin(), ::toupper);
+  if (type.find("INT") != std::string::npos) {
+    return KeyKind::INTEGER;
+  }
+  for (const char *real : {"FLOAT", "DOUBLE", "DECIMAL", "NUMERIC", "REAL"}) {
+    if (type.find(real) != std::string::npos) {
+      return KeyKind::REAL;
+    }
+  }
+  return KeyKind::TEXT;
+}
+
+// 标记字节：数值键在前，无法解析的值在后
+constexpr char kNumericKey = '\x01';
+constexpr char kUnparsedKey = '\x02';
+constexpr size_t kNumericKeySize = 1 + sizeof(uint64_t);
+
+void append_big_endian(std::string &out, uint64_t bits) {
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<char>((bits >> shift) & 0xff));
+  }
+}
+
+uint64_t read_big_endian(const std::string &key) {
+  uint64_t bits = 0;
+  for (size_t i = 1; i < kNumericKeySize; ++i) {
+    bits = (bits << 8) | static_cast<unsigned char>(key[i]);
+  }
+  return bits;
+}
+
+} // namespace
+
+// 整数翻转符号位，浮点数按IEEE754位模式翻转（负数取反，非负数置符号位），
+// 两者按大端序写出后字节序与数值顺序一致
+std::string BPlusTreeIndex::EncodeKey(const std::string &value,
+                                      const std::string &column_type) {
+  KeyKind kind = key_kind(column_type);
+  if (kind == KeyKind::TEXT) {
+    return value;
+  }
+  std::string key;
+  const char *begin = value.c_str();
+  char *end = nullptr;
+  errno = 0;
+  if (kind == KeyKind::INTEGER) {
+    long long number = std::strtoll(begin, &end, 10);
+    if (!value.empty() && errno == 0 && *end == '\0') {
+      key.push_back(kNumericKey);
+      append_big_endian(key, static_cast<uint64_t>(number) ^
+                                 0x8000000000000000ULL);
+      return key;
+    }
+  } else {
+    double number = std::strtod(begin, &end);
+    if (!value.empty() && errno == 0 && *end == '\0' && !std::isnan(number)) {
+      if (number == 0.0) {
+        number = 0.0; // -0.0与0.0相等
+      }
+      uint64_t bits;
+      std::memcpy(&bits, &number, sizeof(bits));
+      bits = (bits & 0x8000000000000000ULL) ? ~bits
+                                            : bits | 0x8000000000000000ULL;
+      key.push_back(kNumericKey);
+      append_big_endian(key, bits);
+      return key;
+    }
+  }
+  key.push_back(kUnparsedKey);
+  key += value;
+  return key;
+}
+
+std::string BPlusTreeIndex::DecodeKey(const std::string &key,
+                                      const std::string &column_type) {
+  KeyKind kind = key_kind(column_type);
+  if (kind == KeyKind::TEXT || key.empty()) {
+    return key;
+  }
+  if (key[0] == kUnparsedKey) {
+    return key.substr(1);
+  }
+  if (key[0] != kNumericKey || key.size() != kNumericKeySize) {
+    return key;
+  }
+  uint64_t bits = read_big_endian(key);
+  if (kind == KeyKind::INTEGER) {
+    return std::to_string(
+        static_cast<long long>(bits ^ 0x8000000000000000ULL));
+  }
+  bits = (bits & 0x8000000000000000ULL) ? bits & ~0x8000000000000000ULL
+                                        : ~bits;
+  double number;
+  std::memcpy(&number, &bits, sizeof(number));
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.17g", number);
+  return text;
+}
+
+bool BPlusTreeIndex::NumericKeyBounds(const std::string &column_type,
+                                      std::string &min_key,
+                                      std::string &max_key) {
+  if (key_kind(column_type) == KeyKind::TEXT) {
+    return false;
+  }
+  min_key.assign(1, kNumericKey);
+  max_key.assign(1, kNumericKey);
+  max_key.append(sizeof(uint64_t), '\xff');
+  return true;
+}
+
+// 键值和INCLUDE列的值按列名从记录中取出，键值按列类型编码
+bool BPlusTreeIndex::MakeEntry(const std::vector<std::string> &record,
+                               const TableMetadata &metadata, int32_t page_id,
+                               size_t offset, IndexEntry &entry) const {
+  auto value_of = [&](const std::string &column, std::string &value) {
+    for (size_t i = 0; i < metadata.columns.size() && i < record.size(); ++i) {
+      if (metadata.columns[i].name == column) {
+        value = record[i];
+        return true;
+      }
+    }
+    return false;
+  };
+
+  entry = IndexEntry();
+  if (!value_of(column_name_, entry.key)) {
+    return false;
+  }
+  for (const auto &column : metadata.columns) {
+    if (column.name == column_name_) {
+      entry.key = EncodeKey(entry.key, column.type);
+      break;
+    }
+  }
+  entry.page_id = page_id;
+  entry.offset = offset;
+  entry.included_values.resize(included_columns_.size());
+  for (size_t i = 0; i < included_columns_.size(); ++i) {
+    if (!value_of(included_columns_[i], entry.included_values[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
  * @brief 检查B+树索引是否存在
  * @details 检查B+树索引是否存在，通过根节点页ID判断
@@ -1623,11 +1896,15 @@ BPlusTreeNode *BPlusTreeIndex::CreateNewNode(bool is_leaf) {
   if (page_id < 0)
     return nullptr;
 
+  BPlusTreeNode *node = nullptr;
   if (is_leaf) {
-    return new BPlusTreeLeafNode(storage_engine_, page_id);
+    node = new BPlusTreeLeafNode(storage_engine_, page_id);
   } else {
-    return new BPlusTreeInternalNode(storage_engine_, page_id);
+    node = new BPlusTreeInternalNode(storage_engine_, page_id);
   }
+  // 节点自己持有一次固定，释放NewPage留下的那次
+  storage_engine_->UnpinPage(page_id, true);
+  return node;
 }
 
 void BPlusTreeIndex::DeleteNode(int32_t page_id) {
@@ -1880,15 +2157,16 @@ bool BPlusTreeIndex::Insert(const IndexEntry &entry,
 
       // 检查当前节点是否需要分裂
       if (internal->IsFull()) {
+        // 提升的键是中间键，Split会把它从两个节点中都去掉
+        promoted_key = internal->GetKeys()[internal->GetKeys().size() / 2];
+
         BPlusTreeInternalNode *new_internal = nullptr;
         internal->Split(new_internal);
-
-        // 设置提升的键为分裂后的内部节点的第一个键
-        promoted_key = internal->GetKeys().back();
         new_node = new_internal;
       }
     }
 
+    delete child_new_node;
     delete child_node;
     return result;
   }
@@ -137,7 +137,7 @@ Page* BufferPool::FetchPage(int32_t page_id) {
         // Why: 需要选择一个页面进行替换，为新页面腾出空间
         // What: ReplacePage方法使用LRU算法选择一个可替换的页面
         // How: 从LRU链表尾部开始查找，找到第一个引用计数为0的页面
-        int32_t replaced_page_id = ReplacePage();
+        int32_t replaced_page_id = ReplacePage(lock);
         if (replaced_page_id == -1) {
             // 无法替换页面，抛出异常
             // Why: 如果所有页面都在使用中，无法为新页面腾出空间，必须报错
@@ -463,14 +463,9 @@ bool BufferPool::UnpinPage(int32_t page_id, bool is_dirty) {
 // Why: 当缓冲池已满时，需要选择一个页面进行替换，为新页面腾出空间
 // What: ReplacePage方法使用LRU算法选择一个可替换的页面
 // How: 从LRU链表尾部开始查找，找到第一个引用计数为0的页面
-int32_t BufferPool::ReplacePage() {
-    // 加锁保护并发访问 - 使用带超时的unique_lock以支持临时解锁避免死锁
-    std::unique_lock<std::timed_mutex> lock(latch_, std::defer_lock);
-    if (!lock.try_lock_for(std::chrono::milliseconds(lock_timeout_ms_))) {
-        // 获取锁失败，记录警告并抛出异常
-        SQLCC_LOG_WARN("Failed to acquire buffer pool lock for page replacement");
-        throw LockTimeoutException("Failed to acquire buffer pool lock for page replacement");
-    }
+int32_t BufferPool::ReplacePage(std::unique_lock<std::timed_mutex>& lock) {
+    // 调用者已经持有latch_，这里不能再次加锁：timed_mutex不可重入，
+    // 再次加锁只会等到超时。写回脏页时通过调用者的lock临时释放
     
     // 从LRU链表尾部开始查找可替换的页面
     // Why: LRU链表尾部是最近最少使用的页面，应该优先替换
@@ -575,9 +570,8 @@ int32_t BufferPool::ReplacePage() {
         // Why: 需要从引用计数表中删除页面，以释放引用计数占用的内存
         // What: 从page_refs_哈希表中删除页面ID
         // How: 使用std::unordered_map的erase方法删除
-        if (ref_it != page_refs_.end()) {
-            page_refs_.erase(ref_it);
-        }
+        // 写回脏页时释放过锁，ref_it可能已经失效，按页面ID删除
+        page_refs_.erase(page_id);
         
         // 从LRU链表中移除
         // Why: 需要从LRU链表中删除页面，以维护LRU链表的正确性
@@ -668,7 +662,7 @@ Page* BufferPool::NewPage(int32_t* page_id) {
         // Why: 需要选择一个页面进行替换，为新页面腾出空间
         // What: ReplacePage方法使用LRU算法选择一个可替换的页面
         // How: 从LRU链表尾部开始查找，找到第一个引用计数为0的页面
-        int32_t replaced_page_id = ReplacePage();
+        int32_t replaced_page_id = ReplacePage(lock);
         if (replaced_page_id == -1) {
             // 无法替换页面，返回nullptr
             // Why: 如果所有页面都在使用中，无法为新页面腾出空间，必须报错
@@ -788,7 +782,7 @@ std::vector<Page*> BufferPool::BatchFetchPages(const std::vector<int32_t>& page_
     if (available_space < pages_to_read.size()) {
         // 需要替换一些页面
         for (size_t i = 0; i < pages_to_read.size() - available_space; ++i) {
-            int32_t victim_page_id = ReplacePage();
+            int32_t victim_page_id = ReplacePage(lock);
             if (victim_page_id == -1) {
                 // 没有可替换的页面
                 SQLCC_LOG_ERROR("Buffer pool is full and no pages can be replaced during batch fetch");
@@ -1059,7 +1053,7 @@ bool BufferPool::PrefetchPage(int32_t page_id) {
     // 检查缓冲池是否已满
     if (page_table_.size() >= pool_size_) {
         // 尝试替换一个页面
-        int32_t victim_page_id = ReplacePage();
+        int32_t victim_page_id = ReplacePage(lock);
         if (victim_page_id == -1) {
             // 没有可替换的页面，预取失败
             SQLCC_LOG_WARN("Buffer pool is full and no pages can be replaced, prefetch failed for page " + std::to_string(page_id));
@@ -1,4 +1,5 @@
 #include "buffer_pool_sharded.h"
+#include "buffer_usage.h"
 #include "exception.h"
 #include "logger.h"
 
@@ -60,11 +61,13 @@ Page *BufferPoolSharded::FetchPage(int32_t page_id, bool exclusive) {
     }
     
     stats_.total_hits++;
+    thread_buffer_usage().hits++;
     return page_wrapper->page;
   }
 
   // 页面不在缓冲池中，需要从磁盘加载
   stats_.total_misses++;
+  thread_buffer_usage().misses++;
 
   // 如果shard已满，需要替换页面
   if (shard.current_size >= shard.max_size) {
@@ -78,7 +81,9 @@ Page *BufferPoolSharded::FetchPage(int32_t page_id, bool exclusive) {
   // 从磁盘读取页面数据
   char page_data[PAGE_SIZE];
   bool read_success = disk_manager_->ReadPage(page_id, page_data);
-  if (!read_success) {
+  if (read_success) {
+    thread_buffer_usage().disk_reads++;
+  } else {
     // 如果读取失败，可能是新页面，创建一个新的页面
     memset(page_data, 0, PAGE_SIZE);
   }
@@ -144,8 +149,9 @@ void BufferPoolSharded::FlushAllPages() {
       int32_t page_id = pair.first;
       std::shared_ptr<PageWrapper> page_wrapper = pair.second;
 
-      if (page_wrapper->is_dirty) {
-        
+      if (page_wrapper->is_dirty &&
+          disk_manager_->WritePage(
+              page_id, static_cast<char *>(page_wrapper->page->GetData()))) {
         page_wrapper->is_dirty = false;
       }
     }
@@ -28,6 +28,9 @@ StorageEngine::StorageEngine(ConfigManager &config_manager)
     
     // 创建缓冲池
     buffer_pool_ = std::make_unique<BufferPoolSharded>(disk_manager_.get(), config_manager_, buffer_pool_size, shard_count);
+
+    // 打开表目录
+    table_directory_ = std::make_unique<TableDirectory>(db_file + ".tables");
 }
 
 StorageEngine::~StorageEngine() {
@@ -86,6 +89,7 @@ bool StorageEngine::DeletePage(int32_t page_id) {
         return false;
     }
     
+    zone_maps_.RemovePage(page_id);
     return buffer_pool_->DeletePage(page_id);
 }
 
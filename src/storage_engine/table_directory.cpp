@@ -0,0 +1,171 @@
+#include "table_directory.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace sqlcc {
+
+namespace {
+
+std::vector<std::string> SplitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::string field;
+    std::istringstream stream(line);
+    while (std::getline(stream, field, '\t')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+} // namespace
+
+TableDirectory::TableDirectory(const std::string& catalog_file)
+    : catalog_file_(catalog_file) {
+    Load();
+}
+
+bool TableDirectory::AddTable(const std::shared_ptr<TableMetadata>& metadata) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (tables_.count(metadata->table_name)) {
+        return false;
+    }
+    // 表ID只增不减，删表后重建的同名表不会读到旧表留在系统表里的统计信息
+    metadata->table_id = next_table_id_++;
+    tables_.emplace(metadata->table_name, TableEntry{metadata, {}});
+    Save();
+    return true;
+}
+
+bool TableDirectory::RemoveTable(const std::string& table_name, std::vector<int32_t>& pages) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = tables_.find(table_name);
+    if (it == tables_.end()) {
+        return false;
+    }
+    pages = std::move(it->second.pages);
+    tables_.erase(it);
+    Save();
+    return true;
+}
+
+std::shared_ptr<TableMetadata> TableDirectory::GetTable(const std::string& table_name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = tables_.find(table_name);
+    return it == tables_.end() ? nullptr : it->second.metadata;
+}
+
+bool TableDirectory::AddPage(const std::string& table_name, int32_t page_id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = tables_.find(table_name);
+    if (it == tables_.end()) {
+        return false;
+    }
+    it->second.pages.push_back(page_id);
+    Save();
+    return true;
+}
+
+std::vector<int32_t> TableDirectory::GetPages(const std::string& table_name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = tables_.find(table_name);
+    return it == tables_.end() ? std::vector<int32_t>() : it->second.pages;
+}
+
+void TableDirectory::Save() const {
+    if (catalog_file_.empty()) {
+        return;
+    }
+
+    // 先写临时文件再改名，避免中途失败留下半个目录
+    std::string temp_file = catalog_file_ + ".tmp";
+    {
+        std::ofstream out(temp_file, std::ios::trunc);
+        if (!out) {
+            SQLCC_LOG_ERROR("Failed to write table directory: " + temp_file);
+            return;
+        }
+        out << "next_table_id\t" << next_table_id_ << '\n';
+        for (const auto& entry : tables_) {
+            const TableMetadata& metadata = *entry.second.metadata;
+            out << "table\t" << metadata.table_name << '\t' << metadata.database_name << '\t'
+                << metadata.record_size << '\t' << metadata.is_fixed_length << '\t'
+                << metadata.table_id << '\n';
+            for (const auto& column : metadata.columns) {
+                out << "column\t" << column.name << '\t' << column.type << '\t' << column.size
+                    << '\t' << column.nullable << '\t' << column.default_value << '\n';
+            }
+            out << "pages";
+            for (int32_t page_id : entry.second.pages) {
+                out << '\t' << page_id;
+            }
+            out << '\n';
+        }
+    }
+    if (std::rename(temp_file.c_str(), catalog_file_.c_str()) != 0) {
+        SQLCC_LOG_ERROR("Failed to replace table directory: " + catalog_file_);
+    }
+}
+
+void TableDirectory::Load() {
+    if (catalog_file_.empty()) {
+        return;
+    }
+    std::ifstream in(catalog_file_);
+    if (!in) {
+        return;
+    }
+
+    TableEntry* current = nullptr;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields = SplitFields(line);
+        if (fields.empty()) {
+            continue;
+        }
+        try {
+            if (fields[0] == "next_table_id" && fields.size() >= 2) {
+                next_table_id_ = std::max<int64_t>(next_table_id_, std::stoll(fields[1]));
+            } else if (fields[0] == "table" && fields.size() >= 5) {
+                auto metadata = std::make_shared<TableMetadata>();
+                metadata->table_name = fields[1];
+                metadata->database_name = fields[2];
+                metadata->record_size = std::stoul(fields[3]);
+                metadata->is_fixed_length = fields[4] == "1";
+                // 旧版本的目录文件没有表ID，读完后统一补发
+                metadata->table_id = fields.size() > 5 ? std::stoll(fields[5]) : 0;
+                current = &tables_[metadata->table_name];
+                current->metadata = metadata;
+                current->pages.clear();
+            } else if (fields[0] == "column" && current && fields.size() >= 5) {
+                TableColumn column;
+                column.name = fields[1];
+                column.type = fields[2];
+                column.size = std::stoul(fields[3]);
+                column.nullable = fields[4] == "1";
+                column.default_value = fields.size() > 5 ? fields[5] : "";
+                auto& metadata = *current->metadata;
+                metadata.column_index_map[column.name] = static_cast<int>(metadata.columns.size());
+                metadata.columns.push_back(column);
+            } else if (fields[0] == "pages" && current) {
+                for (size_t i = 1; i < fields.size(); i++) {
+                    current->pages.push_back(std::stoi(fields[i]));
+                }
+            }
+        } catch (const std::exception& e) {
+            SQLCC_LOG_ERROR("Malformed table directory entry in " + catalog_file_ + ": " + line);
+        }
+    }
+
+    for (const auto& entry : tables_) {
+        next_table_id_ = std::max(next_table_id_, entry.second.metadata->table_id + 1);
+    }
+    for (auto& entry : tables_) {
+        if (entry.second.metadata->table_id == 0) {
+            entry.second.metadata->table_id = next_table_id_++;
+        }
+    }
+}
+
+} // namespace sqlcc
@@ -4,6 +4,7 @@
 #include "logger.h"
 #include <cstring>
 #include <algorithm>
+#include <mutex>
 
 namespace sqlcc {
 
@@ -17,7 +18,8 @@ TableStorageManager::TableStorageManager(std::shared_ptr<StorageEngine> storage_
 TableStorageManager::~TableStorageManager() {
 }
 
-bool TableStorageManager::CreateTable(const std::string& table_name, const std::vector<TableColumn>& columns) {
+bool TableStorageManager::CreateTable(const std::string& table_name, const std::vector<TableColumn>& columns,
+                                      const std::string& database_name) {
     // 检查表是否已存在
     if (TableExists(table_name)) {
         SQLCC_LOG_WARN("Table already exists: " + table_name);
@@ -27,6 +29,7 @@ bool TableStorageManager::CreateTable(const std::string& table_name, const std::
     // 创建表元数据
     auto metadata = std::make_shared<TableMetadata>();
     metadata->table_name = table_name;
+    metadata->database_name = database_name;
     metadata->columns = columns;
     
     // 计算记录大小
@@ -58,8 +61,11 @@ bool TableStorageManager::CreateTable(const std::string& table_name, const std::
     // 添加记录头部大小
     metadata->record_size += sizeof(RecordHeader);
     
-    // 存储元数据
-    table_metadata_[table_name] = metadata;
+    // 登记到存储引擎的表目录，其他TableStorageManager实例也能看到
+    if (!storage_engine_->GetTableDirectory().AddTable(metadata)) {
+        SQLCC_LOG_WARN("Table already exists: " + table_name);
+        return false;
+    }
     
     SQLCC_LOG_INFO("Created table: " + table_name + " with " + std::to_string(columns.size()) + " columns");
     return true;
@@ -72,23 +78,26 @@ bool TableStorageManager::DropTable(const std::string& table_name) {
         return false;
     }
 
-    // 移除表元数据
-    table_metadata_.erase(table_name);
+    // 移除表元数据并释放数据页
+    std::vector<int32_t> pages;
+    if (!storage_engine_->GetTableDirectory().RemoveTable(table_name, pages)) {
+        SQLCC_LOG_WARN("Table does not exist: " + table_name);
+        return false;
+    }
+    for (int32_t page_id : pages) {
+        storage_engine_->DeletePage(page_id);
+    }
     
     SQLCC_LOG_INFO("Dropped table: " + table_name);
     return true;
 }
 
 bool TableStorageManager::TableExists(const std::string& table_name) const {
-    return table_metadata_.find(table_name) != table_metadata_.end();
+    return GetTableMetadata(table_name) != nullptr;
 }
 
 std::shared_ptr<TableMetadata> TableStorageManager::GetTableMetadata(const std::string& table_name) const {
-    auto it = table_metadata_.find(table_name);
-    if (it != table_metadata_.end()) {
-        return it->second;
-    }
-    return nullptr;
+    return storage_engine_->GetTableDirectory().GetTable(table_name);
 }
 
 bool TableStorageManager::InsertRecord(const std::string& table_name, const std::vector<std::string>& values, 
@@ -106,25 +115,50 @@ bool TableStorageManager::InsertRecord(const std::string& table_name, const std:
         return false;
     }
 
-    // 分配新页面（简化实现，实际应查找有足够空间的页面）
-    Page* page = AllocateNewPage(table_name);
+    // 记录追加到表的最后一页，放不下时分配新页
+    TableDirectory& directory = storage_engine_->GetTableDirectory();
+    std::lock_guard<std::mutex> append_lock(directory.AppendMutex());
+
+    Page* page = nullptr;
+    std::vector<int32_t> pages = directory.GetPages(table_name);
+    if (!pages.empty()) {
+        page = storage_engine_->FetchPage(pages.back());
+        if (page && !PageHasRoom(page, values)) {
+            storage_engine_->UnpinPage(pages.back(), false);
+            page = nullptr;
+        }
+    }
     if (!page) {
-        SQLCC_LOG_ERROR("Failed to allocate new page for table: " + table_name);
-        return false;
+        page = AllocateNewPage(table_name);
+        if (!page) {
+            SQLCC_LOG_ERROR("Failed to allocate new page for table: " + table_name);
+            return false;
+        }
     }
 
     // 插入记录到页面
-    if (!InsertRecordToPage(page, values, offset)) {
+    page_id = page->GetPageId();
+    bool result = InsertRecordToPage(page, values, offset);
+    storage_engine_->UnpinPage(page_id, result);
+    if (!result) {
         SQLCC_LOG_ERROR("Failed to insert record to page for table: " + table_name);
         return false;
     }
 
-    page_id = page->GetPageId();
+    storage_engine_->GetZoneMaps().AddRecord(page_id, values, metadata->columns);
     return true;
 }
 
 bool TableStorageManager::UpdateRecord(const std::string& table_name, int32_t page_id, size_t offset, 
                                      const std::vector<std::string>& new_values) {
+    int32_t new_page_id;
+    size_t new_offset;
+    return UpdateRecord(table_name, page_id, offset, new_values, new_page_id, new_offset);
+}
+
+bool TableStorageManager::UpdateRecord(const std::string& table_name, int32_t page_id, size_t offset,
+                                     const std::vector<std::string>& new_values,
+                                     int32_t& new_page_id, size_t& new_offset) {
     // 检查表是否存在
     auto metadata = GetTableMetadata(table_name);
     if (!metadata) {
@@ -139,13 +173,22 @@ bool TableStorageManager::UpdateRecord(const std::string& table_name, int32_t pa
         return false;
     }
 
-    // 更新记录
-    bool result = UpdateRecordInPage(page, offset, new_values);
+    // 更新记录（新版本写入同一页），旧值仍留在摘要中，范围只扩大不收缩
+    bool result = UpdateRecordInPage(page, offset, new_values, new_offset);
+    if (result) {
+        new_page_id = page_id;
+        storage_engine_->GetZoneMaps().AddRecord(page_id, new_values, metadata->columns);
+    }
     
     // 解除页面固定
     storage_engine_->UnpinPage(page_id, result); // 如果更新成功，则标记为脏页
-    
-    return result;
+    if (result) {
+        return true;
+    }
+
+    // 同一页放不下新版本：删除旧记录，新版本追加到表末尾
+    return DeleteRecord(table_name, page_id, offset) &&
+           InsertRecord(table_name, new_values, new_page_id, new_offset);
 }
 
 bool TableStorageManager::DeleteRecord(const std::string& table_name, int32_t page_id, size_t offset) {
@@ -204,10 +247,77 @@ std::vector<std::pair<int32_t, size_t>> TableStorageManager::ScanTable(const std
         return {};
     }
 
-    // 简化实现：返回空结果，表示扫描表
-    // TODO: 实现完整的表扫描逻辑
-    SQLCC_LOG_WARN("ScanTable simplified implementation: returning empty result");
-    return {};
+    // 按分配顺序遍历表的数据页，页内记录从头部之后依次排列到空闲空间起点
+    std::vector<std::pair<int32_t, size_t>> locations;
+    for (int32_t page_id : storage_engine_->GetTableDirectory().GetPages(table_name)) {
+        Page* page = storage_engine_->FetchPage(page_id);
+        if (!page) {
+            SQLCC_LOG_ERROR("Failed to fetch page: " + std::to_string(page_id));
+            continue;
+        }
+
+        const char* data = page->GetData();
+        PageHeader header = ReadPageHeader(page);
+        size_t offset = PAGE_HEADER_SIZE;
+        while (offset + sizeof(RecordHeader) <= header.free_space_offset) {
+            RecordHeader record_header;
+            memcpy(&record_header, data + offset, sizeof(RecordHeader));
+            if (record_header.size < sizeof(RecordHeader)) {
+                SQLCC_LOG_ERROR("Corrupted record in page: " + std::to_string(page_id));
+                break;
+            }
+            if (!record_header.is_deleted) {
+                locations.emplace_back(page_id, offset);
+            }
+            offset += record_header.size;
+        }
+
+        storage_engine_->UnpinPage(page_id, false);
+    }
+    return locations;
+}
+
+std::vector<int32_t> TableStorageManager::GetTablePages(const std::string& table_name) const {
+    if (!GetTableMetadata(table_name)) {
+        SQLCC_LOG_ERROR("Table does not exist: " + table_name);
+        return {};
+    }
+    return storage_engine_->GetTableDirectory().GetPages(table_name);
+}
+
+std::vector<std::vector<std::string>> TableStorageManager::GetPageRecords(const std::string& table_name,
+                                                                         int32_t page_id) const {
+    if (!GetTableMetadata(table_name)) {
+        SQLCC_LOG_ERROR("Table does not exist: " + table_name);
+        return {};
+    }
+
+    Page* page = storage_engine_->FetchPage(page_id);
+    if (!page) {
+        SQLCC_LOG_ERROR("Failed to fetch page: " + std::to_string(page_id));
+        return {};
+    }
+
+    // 与ScanTable相同的页内遍历，但在固定期间直接解码，不再逐条GetRecord
+    std::vector<std::vector<std::string>> records;
+    const char* data = page->GetData();
+    PageHeader header = ReadPageHeader(page);
+    size_t offset = PAGE_HEADER_SIZE;
+    while (offset + sizeof(RecordHeader) <= header.free_space_offset) {
+        RecordHeader record_header;
+        memcpy(&record_header, data + offset, sizeof(RecordHeader));
+        if (record_header.size < sizeof(RecordHeader)) {
+            SQLCC_LOG_ERROR("Corrupted record in page: " + std::to_string(page_id));
+            break;
+        }
+        if (!record_header.is_deleted) {
+            records.push_back(GetRecordFromPage(page, offset));
+        }
+        offset += record_header.size;
+    }
+
+    storage_engine_->UnpinPage(page_id, false);
+    return records;
 }
 
 std::vector<std::vector<std::string>> TableStorageManager::GetRecords(const std::string& table_name, 
@@ -253,8 +363,9 @@ Page* TableStorageManager::AllocateNewPage(const std::string& table_name) {
         return nullptr;
     }
 
-    // 初始化页面
+    // 初始化页面并登记到表目录
     InitializePage(page, table_name);
+    storage_engine_->GetTableDirectory().AddPage(table_name, page_id);
     
     return page;
 }
@@ -327,19 +438,23 @@ bool TableStorageManager::InsertRecordToPage(Page* page, const std::vector<std::
     return true;
 }
 
-bool TableStorageManager::UpdateRecordInPage(Page* page, size_t offset, const std::vector<std::string>& new_values) {
-    char* data = page->GetData();
-    
-    // 读取记录头部
-    RecordHeader record_header;
-    memcpy(&record_header, data + offset, sizeof(RecordHeader));
-    
-    // 标记为删除
-    record_header.is_deleted = true;
-    memcpy(data + offset, &record_header, sizeof(RecordHeader));
-    
-    // 插入新记录（简化实现，实际应尝试原地更新）
-    size_t new_offset;
+bool TableStorageManager::PageHasRoom(Page* page, const std::vector<std::string>& values) const {
+    size_t record_size = sizeof(RecordHeader);
+    for (const auto& value : values) {
+        record_size += sizeof(uint32_t) + value.length();
+    }
+    return ReadPageHeader(page).free_space_size >= record_size + SLOT_ARRAY_ENTRY_SIZE;
+}
+
+bool TableStorageManager::UpdateRecordInPage(Page* page, size_t offset, const std::vector<std::string>& new_values,
+                                             size_t& new_offset) {
+    // 先确认放得下，失败时旧记录保持原样
+    if (!PageHasRoom(page, new_values)) {
+        return false;
+    }
+
+    // 标记旧记录删除，新版本写入同一页（简化实现，实际应尝试原地更新）
+    DeleteRecordInPage(page, offset);
     return InsertRecordToPage(page, new_values, new_offset);
 }
 
@@ -424,6 +539,15 @@ void TableStorageManager::WritePageHeader(Page* page, const PageHeader& header)
     memcpy(data + sizeof(PageType) + 3 * sizeof(int32_t) + 3 * sizeof(uint16_t), &header.tuple_count, sizeof(uint16_t));
 }
 
+bool TableStorageManager::PageMayMatch(int32_t page_id, size_t column_index,
+                                       const std::string& column_type, const std::string& op,
+                                       const std::string& value) const {
+    if (!storage_engine_) {
+        return true;
+    }
+    return storage_engine_->GetZoneMaps().PageMayMatch(page_id, column_index, column_type, op, value);
+}
+
 bool TableStorageManager::CreateIndex(const std::string& table_name, const std::string& column_name) {
     // TODO: 需要实现IndexManager类
     SQLCC_LOG_WARN("CreateIndex not implemented: IndexManager class is missing");
@@ -0,0 +1,202 @@
+#include "zone_map.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+
+namespace sqlcc {
+
+namespace {
+
+std::string ToUpper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+    return text;
+}
+
+std::string Trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\n\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\n\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool ParseInt(const std::string& text, double& out) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    long long value = std::strtoll(text.c_str(), &end, 10);
+    if (errno != 0 || end != text.c_str() + text.size()) {
+        return false;
+    }
+    out = static_cast<double>(value);
+    return true;
+}
+
+bool ParseDouble(const std::string& text, double& out) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end != text.c_str() + text.size()) {
+        return false;
+    }
+    out = value;
+    return true;
+}
+
+bool IsIntegerType(const std::string& upper_type) {
+    return upper_type.find("INT") != std::string::npos;
+}
+
+bool IsRealType(const std::string& upper_type) {
+    return upper_type.find("FLOAT") != std::string::npos ||
+           upper_type.find("DOUBLE") != std::string::npos ||
+           upper_type.find("DECIMAL") != std::string::npos ||
+           upper_type.find("NUMERIC") != std::string::npos ||
+           upper_type.find("REAL") != std::string::npos;
+}
+
+// 与执行器的parse_value相同：按列类型解析为数值，失败时按字符串处理
+bool ParseNumber(const std::string& text, const std::string& upper_type, double& out) {
+    if (IsIntegerType(upper_type)) {
+        return ParseInt(text, out);
+    }
+    if (IsRealType(upper_type)) {
+        return ParseDouble(text, out);
+    }
+    if (upper_type.empty()) {
+        return ParseInt(text, out) || ParseDouble(text, out);
+    }
+    return false;
+}
+
+void Widen(ColumnZone& zone, const std::string& value, const std::string& upper_type) {
+    if (value.empty() || ToUpper(value) == "NULL") {
+        ++zone.null_count;
+    }
+    double number;
+    if (ParseNumber(value, upper_type, number)) {
+        if (std::isnan(number)) {
+            zone.unordered = true;
+        } else if (!zone.has_number) {
+            zone.has_number = true;
+            zone.min_number = zone.max_number = number;
+        } else {
+            zone.min_number = std::min(zone.min_number, number);
+            zone.max_number = std::max(zone.max_number, number);
+        }
+        return;
+    }
+    if (!zone.has_string) {
+        zone.has_string = true;
+        zone.min_string = zone.max_string = value;
+    } else if (value < zone.min_string) {
+        zone.min_string = value;
+    } else if (value > zone.max_string) {
+        zone.max_string = value;
+    }
+}
+
+} // namespace
+
+void ZoneMapIndex::AddRecord(int32_t page_id, const std::vector<std::string>& values,
+                             const std::vector<TableColumn>& columns) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    PageZone& zone = pages_[page_id];
+    if (zone.columns.size() < values.size()) {
+        zone.columns.resize(values.size());
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        std::string type = i < columns.size() ? ToUpper(columns[i].type) : "";
+        Widen(zone.columns[i], values[i], type);
+    }
+    ++zone.row_count;
+}
+
+void ZoneMapIndex::RemovePage(int32_t page_id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    pages_.erase(page_id);
+}
+
+bool ZoneMapIndex::GetPageZone(int32_t page_id, PageZone& zone) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = pages_.find(page_id);
+    if (it == pages_.end()) {
+        return false;
+    }
+    zone = it->second;
+    return true;
+}
+
+bool ZoneMapIndex::PageMayMatch(int32_t page_id, size_t column, const std::string& column_type,
+                                const std::string& op, const std::string& literal) const {
+    std::string compare = Trim(op);
+    if (compare != "=" && compare != "<" && compare != "<=" && compare != ">" &&
+        compare != ">=") {
+        return true;
+    }
+
+    // 常量的解析与CompiledPredicate相同；整数列与小数常量按数值比较
+    std::string raw = Trim(literal);
+    std::string upper_type = ToUpper(column_type);
+    bool is_number = false;
+    double number = 0.0;
+    std::string text = raw;
+    if (raw.size() >= 2 && (raw.front() == '\'' || raw.front() == '"') &&
+        raw.back() == raw.front()) {
+        text = raw.substr(1, raw.size() - 2);
+    } else {
+        is_number = ParseNumber(raw, upper_type, number) ||
+                    (IsIntegerType(upper_type) && ParseDouble(raw, number));
+    }
+    if (is_number && std::isnan(number)) {
+        return true;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = pages_.find(page_id);
+    if (it == pages_.end() || column >= it->second.columns.size()) {
+        return true;
+    }
+    const ColumnZone& zone = it->second.columns[column];
+    if (zone.unordered) {
+        return true;
+    }
+
+    // 数值在字符串之前。整数转换为double可能舍入，数值范围一律按闭区间判断
+    if (is_number) {
+        if (compare == "=") {
+            return zone.has_number && zone.min_number <= number && number <= zone.max_number;
+        }
+        if (compare == "<" || compare == "<=") {
+            return zone.has_number && zone.min_number <= number;
+        }
+        return zone.has_string || (zone.has_number && zone.max_number >= number);
+    }
+    if (compare == "=") {
+        return zone.has_string && zone.min_string <= text && text <= zone.max_string;
+    }
+    if (compare == "<") {
+        return zone.has_number || (zone.has_string && zone.min_string < text);
+    }
+    if (compare == "<=") {
+        return zone.has_number || (zone.has_string && zone.min_string <= text);
+    }
+    if (compare == ">") {
+        return zone.has_string && zone.max_string > text;
+    }
+    return zone.has_string && zone.max_string >= text;
+}
+
+size_t ZoneMapIndex::PageCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return pages_.size();
+}
+
+} // namespace sqlcc
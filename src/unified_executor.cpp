@@ -1,11 +1,25 @@
 #include "unified_executor.h"
+#include "b_plus_tree.h"
 #include "database_manager.h"
+#include "exception.h"
+#include "execution/compiled_predicate.h"
+#include "execution/explain_analyze.h"
+#include "execution/parallel_scan.h"
+#include "execution/result_cache.h"
+#include "execution/spill_file.h"
+#include "execution/statistics.h"
+#include "sql_executor/index_manager.h"
 #include "storage_engine.h"
 #include "system_database.h"
 #include "table_storage.h"
 #include "user_manager.h"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 namespace sqlcc {
@@ -43,9 +57,15 @@ std::string ExecutionPlan::toString() const {
   if (!index_name.empty()) {
     ss << " [索引: " << index_name << "]";
   }
+  if (!join_condition.empty()) {
+    ss << " [连接: " << join_condition << "]";
+  }
   if (!where_clause.empty()) {
     ss << " [条件: " << where_clause << "]";
   }
+  if (estimated_rows > 0) {
+    ss << " [估计行数: " << estimated_rows << "]";
+  }
   ss << " [成本: " << cost_estimate << "]";
   if (is_optimized) {
     ss << " [已优化]";
@@ -56,13 +76,313 @@ std::string ExecutionPlan::toString() const {
 
 // ==================== ExecutionPlanGenerator 实现 ====================
 
-ExecutionPlanGenerator::ExecutionPlanGenerator() {
-  // 初始化执行计划生成器
+namespace {
+
+// 从系统表读回之前ANALYZE持久化的统计信息，没有时返回nullptr
+std::shared_ptr<const TableStatistics>
+loadPersistedStatistics(const ExecutionContext &context,
+                        const std::string &table) {
+  auto system_db = context.system_db ? context.system_db : context.system_db_;
+  auto db_manager = context.db_manager ? context.db_manager : context.db_manager_;
+  if (!system_db || !db_manager || !db_manager->GetStorageEngine()) {
+    return nullptr;
+  }
+  auto metadata = db_manager->GetStorageEngine()->GetTableDirectory().GetTable(table);
+  if (!metadata) {
+    return nullptr;
+  }
+  auto table_rows = system_db->GetTableStatistics(metadata->table_id);
+  if (table_rows.empty()) {
+    return nullptr;
+  }
+
+  TableStatistics statistics;
+  statistics.table_name = table;
+  statistics.row_count = static_cast<size_t>(table_rows.back().row_count);
+  statistics.page_count = static_cast<size_t>(table_rows.back().page_count);
+  auto column_rows = system_db->GetColumnStatistics(metadata->table_id);
+  // 按表定义的列顺序还原，与ANALYZE直接产生的结果一致
+  for (const auto &column : metadata->columns) {
+    for (const auto &row : column_rows) {
+      if (row.column_name != column.name) {
+        continue;
+      }
+      ColumnStatistics column_statistics;
+      column_statistics.column_name = row.column_name;
+      column_statistics.data_type = row.data_type;
+      column_statistics.null_fraction = row.null_fraction;
+      column_statistics.distinct_count = row.distinct_count;
+      try {
+        column_statistics.histogram = decode_histogram(row.histogram);
+      } catch (const std::exception &) {
+        column_statistics.histogram.clear();
+      }
+      statistics.columns.push_back(std::move(column_statistics));
+      break;
+    }
+  }
+  StatisticsCatalog::shared().put(context.current_database,
+                                  std::move(statistics));
+  return StatisticsCatalog::shared().get(context.current_database, table);
+}
+
+std::shared_ptr<const TableStatistics>
+lookupStatistics(const ExecutionContext &context, const std::string &table) {
+  if (table.empty()) {
+    return nullptr;
+  }
+  if (auto statistics =
+          StatisticsCatalog::shared().get(context.current_database, table)) {
+    return statistics;
+  }
+  // 进程内目录未命中（例如重启后），回退到系统表
+  return loadPersistedStatistics(context, table);
+}
+
+// 列上是否有B+树索引，列名可以带表名前缀
+bool hasIndexOn(const ExecutionContext &context, const std::string &table,
+                std::string column) {
+  auto db_manager = context.db_manager ? context.db_manager : context.db_manager_;
+  if (!db_manager || column.empty()) {
+    return false;
+  }
+  auto index_manager = db_manager->GetIndexManager();
+  if (!index_manager) {
+    return false;
+  }
+  size_t dot = column.find('.');
+  if (dot != std::string::npos) {
+    column = column.substr(dot + 1);
+  }
+  for (BPlusTreeIndex *index : index_manager->GetTableIndexes(table)) {
+    if (index && index->GetColumnName() == column) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// 比较条件同时交给全表扫描，按区域映射跳过不可能包含匹配行的页面
+void setZoneFilter(TableScanOperator &scan, const std::string &column,
+                   const std::string &op, const std::string &value) {
+  if (!column.empty() &&
+      (op == "=" || op == "<" || op == "<=" || op == ">" || op == ">=")) {
+    scan.set_zone_filter(column, op, value);
+  }
+}
+
+// 查询引用的列（选择列、聚合参数、WHERE、GROUP BY、HAVING、ORDER BY）都是
+// 索引键列或INCLUDE列时，可以只读索引回答
+bool indexCovers(const BPlusTreeIndex &index,
+                 const sql_parser::SelectStatement &stmt,
+                 const TableMetadata &metadata) {
+  const auto &included = index.GetIncludedColumns();
+  auto covers = [&](std::string column) {
+    size_t dot = column.find('.');
+    if (dot != std::string::npos) {
+      column = column.substr(dot + 1);
+    }
+    return column.empty() || column == index.GetColumnName() ||
+           std::find(included.begin(), included.end(), column) !=
+               included.end();
+  };
+  auto covers_expr = [&](const std::string &expr) {
+    AggregateSpec spec;
+    return ExecutionPlanGenerator::parseAggregate(expr, spec)
+               ? covers(spec.column)
+               : !expr.empty() && covers(expr);
+  };
+
+  if (stmt.isSelectAll() || stmt.getSelectColumns().empty()) {
+    for (const auto &column : metadata.columns) {
+      if (!covers(column.name)) {
+        return false;
+      }
+    }
+  }
+  for (const auto &column : stmt.getSelectColumns()) {
+    if (column != "*" && !covers_expr(column)) {
+      return false;
+    }
+  }
+  return (!stmt.hasWhereClause() ||
+          covers(stmt.getWhereClause().getColumnName())) &&
+         (!stmt.hasGroupBy() || covers(stmt.getGroupByColumn())) &&
+         (!stmt.hasHavingClause() ||
+          covers_expr(stmt.getHavingClause().getColumnName())) &&
+         (!stmt.hasOrderBy() || covers(stmt.getOrderByColumn()));
+}
+
+// 拆分"列 操作符 常量"形式的条件，操作符可能是"NOT IN"等两个词
+bool splitWhereClause(const std::string &where_clause, std::string &column,
+                      std::string &op, std::string &literal) {
+  std::istringstream where(where_clause);
+  if (!(where >> column >> op)) {
+    return false;
+  }
+  std::string upper_op = op;
+  std::transform(upper_op.begin(), upper_op.end(), upper_op.begin(),
+                 ::toupper);
+  if (upper_op == "NOT") {
+    std::string keyword;
+    where >> keyword;
+    op += " " + keyword;
+  }
+  std::getline(where, literal);
+  return true;
+}
+
+// 拆分"table.column"，没有表名前缀时返回false
+bool splitQualifiedColumn(std::string text, std::string &table,
+                          std::string &column) {
+  text.erase(0, text.find_first_not_of(" \t"));
+  text.erase(text.find_last_not_of(" \t") + 1);
+  size_t dot = text.find('.');
+  if (dot == std::string::npos || dot == 0 || dot + 1 == text.size()) {
+    return false;
+  }
+  table = text.substr(0, dot);
+  column = text.substr(dot + 1);
+  return true;
+}
+
+// 按AND（不区分大小写）拆分连接条件
+std::vector<std::string> splitConjuncts(const std::string &condition) {
+  std::string upper = condition;
+  std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+  std::vector<std::string> conjuncts;
+  size_t start = 0;
+  while (true) {
+    size_t pos = upper.find(" AND ", start);
+    conjuncts.push_back(condition.substr(
+        start, pos == std::string::npos ? std::string::npos : pos - start));
+    if (pos == std::string::npos) {
+      break;
+    }
+    start = pos + 5;
+  }
+  return conjuncts;
+}
+
+const char *joinAlgorithmName(JoinAlgorithm algorithm) {
+  switch (algorithm) {
+  case JoinAlgorithm::NESTED_LOOP:
+    return "nested_loop";
+  case JoinAlgorithm::HASH:
+    return "hash";
+  case JoinAlgorithm::SORT_MERGE:
+    return "sort_merge";
+  case JoinAlgorithm::INDEX_NESTED_LOOP:
+    return "index_nested_loop";
+  default:
+    return "auto";
+  }
+}
+
+/**
+ * 从扫描的估计行数自下而上推算各算子的估计行数，EXPLAIN ANALYZE中与实际
+ * 行数对照。已有估计的算子（连接树）保持不变；过滤乘以WHERE条件的选择率，
+ * 无GROUP BY的聚合为1行，LIMIT和Top-N取扣除OFFSET后与LIMIT的较小值，
+ * 其余算子与输入相同。没有统计信息时扫描和其上的算子都不标注
+ * @return 估计行数，未知时为负数
+ */
+double annotateEstimatedRows(PhysicalOperator &op,
+                             const sql_parser::SelectStatement &stmt,
+                             const TableStatistics *statistics) {
+  if (op.estimated_rows() >= 0) {
+    return op.estimated_rows();
+  }
+  const auto &where = stmt.getWhereClause();
+  bool filtered = stmt.hasWhereClause() && !where.getColumnName().empty();
+  if (op.children().empty()) {
+    if (!statistics) {
+      return -1.0;
+    }
+    double rows = static_cast<double>(statistics->row_count);
+    if (filtered && dynamic_cast<IndexScanOperator *>(&op)) {
+      rows *= statistics->selectivity(where.getColumnName(), where.getOp(),
+                                      where.getValue());
+    }
+    op.set_estimated_rows(rows);
+    return rows;
+  }
+
+  PhysicalOperator &input = *op.children().front();
+  double rows = annotateEstimatedRows(input, stmt, statistics);
+  if (rows < 0) {
+    return rows;
+  }
+  if (dynamic_cast<FilterOperator *>(&op)) {
+    // 索引扫描已按同一条件定位，过滤不再减少行数
+    if (filtered && !dynamic_cast<IndexScanOperator *>(&input)) {
+      rows *= statistics ? statistics->selectivity(where.getColumnName(),
+                                                   where.getOp(),
+                                                   where.getValue())
+                         : default_selectivity(where.getOp());
+    }
+  } else if (dynamic_cast<AggregateOperator *>(&op)) {
+    if (!stmt.hasGroupBy()) {
+      rows = 1.0;
+    } else if (const ColumnStatistics *column =
+                   statistics ? statistics->column(stmt.getGroupByColumn())
+                              : nullptr) {
+      rows = std::min(rows, std::max(column->distinct_count, 1.0));
+    }
+    if (stmt.hasHavingClause()) {
+      rows *= default_selectivity(stmt.getHavingClause().getOp());
+    }
+  } else if (auto *exchange = dynamic_cast<ExchangeOperator *>(&op)) {
+    // 每个工作线程各输出一份部分聚合结果
+    if (dynamic_cast<AggregateOperator *>(&input)) {
+      rows *= static_cast<double>(exchange->dop());
+    }
+  } else if (dynamic_cast<LimitOperator *>(&op) ||
+             dynamic_cast<TopNOperator *>(&op)) {
+    if (stmt.hasOffset() && stmt.getOffset() > 0) {
+      rows = std::max(rows - static_cast<double>(stmt.getOffset()), 0.0);
+    }
+    if (stmt.hasLimit() && stmt.getLimit() >= 0) {
+      rows = std::min(rows, static_cast<double>(stmt.getLimit()));
+    }
+  }
+  op.set_estimated_rows(rows);
+  return rows;
 }
 
+} // namespace
+
+ExecutionPlanGenerator::ExecutionPlanGenerator()
+    : work_mem_(kDefaultOperatorMemoryLimit), parallel_degree_(1) {}
+
 ExecutionPlan
 ExecutionPlanGenerator::generatePlan(const sql_parser::SelectStatement &stmt,
                                      const ExecutionContext &context) {
+  if (stmt.hasJoinCondition()) {
+    return generateJoinPlan(stmt, context);
+  }
+
+  // 有ANALYZE统计信息时按代价在全表扫描和索引查找之间选择
+  if (auto statistics = lookupStatistics(context, stmt.getTableName())) {
+    ExecutionPlan plan = generateFullTableScanPlan(stmt);
+    plan.cost_estimate = estimateCost(plan, context);
+    double selectivity = 1.0;
+    if (stmt.hasWhereClause()) {
+      const auto &where = stmt.getWhereClause();
+      selectivity = statistics->selectivity(where.getColumnName(), where.getOp(),
+                                            where.getValue());
+      if (where.getOp() == "=" &&
+          hasIndexOn(context, stmt.getTableName(), where.getColumnName())) {
+        ExecutionPlan seek = generateIndexSeekPlan(stmt, context);
+        seek.cost_estimate = estimateCost(seek, context);
+        if (seek.cost_estimate < plan.cost_estimate) {
+          plan = seek;
+        }
+      }
+    }
+    plan.estimated_rows = selectivity * statistics->row_count;
+    return plan;
+  }
+
   // 1. 检查WHERE子句是否存在
   if (stmt.hasWhereClause() && !stmt.getWhereClause().getColumnName().empty()) {
     // 2. 检查是否有可用索引
@@ -98,7 +418,40 @@ ExecutionPlanGenerator::optimizePlan(const ExecutionPlan &plan,
 
 double ExecutionPlanGenerator::estimateCost(const ExecutionPlan &plan,
                                             const ExecutionContext &context) {
-  // 简化实现：根据计划类型估算成本
+  if (plan.type == ExecutionPlan::JOIN) {
+    JoinGraph graph;
+    size_t where_relation;
+    if (buildJoinGraph(plan, context, graph, where_relation) &&
+        graph.relations.size() > 2) {
+      return optimize_join_order(graph)->cost;
+    }
+    JoinChoice choice;
+    if (chooseJoin(plan, context, choice)) {
+      return choice.cost;
+    }
+  } else if (auto statistics = lookupStatistics(context, plan.table_name)) {
+    std::string column, op, literal;
+    bool has_condition = splitWhereClause(plan.where_clause, column, op, literal);
+    double rows = static_cast<double>(statistics->row_count);
+    switch (plan.type) {
+    case ExecutionPlan::INDEX_SCAN:
+    case ExecutionPlan::INDEX_SEEK:
+      if (has_condition) {
+        return index_scan_cost(*statistics,
+                               statistics->selectivity(column, op, literal));
+      }
+      return seq_scan_cost(*statistics);
+    case ExecutionPlan::AGGREGATE:
+      return seq_scan_cost(*statistics) + rows * kCpuOperatorCost;
+    case ExecutionPlan::SORT:
+      return seq_scan_cost(*statistics) +
+             rows * std::log2(std::max(rows, 2.0)) * kCpuOperatorCost;
+    default:
+      return seq_scan_cost(*statistics);
+    }
+  }
+
+  // 没有统计信息时根据计划类型估算成本
   switch (plan.type) {
   case ExecutionPlan::FULL_TABLE_SCAN:
     return 100.0; // 全表扫描成本最高
@@ -181,6 +534,745 @@ ExecutionPlan ExecutionPlanGenerator::generateIndexSeekPlan(
   return plan;
 }
 
+ExecutionPlan ExecutionPlanGenerator::generateJoinPlan(
+    const sql_parser::SelectStatement &stmt, const ExecutionContext &context) {
+  ExecutionPlan plan;
+  plan.type = ExecutionPlan::JOIN;
+  plan.description = "连接执行计划";
+  plan.table_name = stmt.getTableName();
+  plan.columns = stmt.getSelectColumns();
+  plan.join_condition = stmt.getJoinCondition();
+  if (stmt.hasWhereClause()) {
+    const auto &where = stmt.getWhereClause();
+    plan.where_clause =
+        where.getColumnName() + " " + where.getOp() + " " + where.getValue();
+  }
+  plan.cost_estimate = 200.0;
+  plan.is_optimized = false;
+
+  // 三表及以上：枚举连接树（bushy树、过滤条件下推）
+  JoinGraph graph;
+  size_t where_relation;
+  if (buildJoinGraph(plan, context, graph, where_relation) &&
+      graph.relations.size() > 2) {
+    JoinTreePtr tree = optimize_join_order(graph);
+    plan.description += "：连接顺序 " + tree->to_string(graph);
+    plan.cost_estimate = tree->cost;
+    plan.estimated_rows = tree->rows;
+    return plan;
+  }
+
+  JoinChoice choice;
+  if (chooseJoin(plan, context, choice)) {
+    plan.description += "：外表 " + choice.outer_table + "，内表 " +
+                        choice.inner_table + "，算法 " +
+                        joinAlgorithmName(choice.algorithm);
+    plan.cost_estimate = choice.cost;
+    plan.estimated_rows = choice.rows;
+  }
+  return plan;
+}
+
+bool ExecutionPlanGenerator::chooseJoin(const ExecutionPlan &plan,
+                                        const ExecutionContext &context,
+                                        JoinChoice &choice) {
+  // 连接条件为"a.x = b.y"，两侧都需要有统计信息
+  size_t eq = plan.join_condition.find('=');
+  if (eq == std::string::npos) {
+    return false;
+  }
+  std::string tables[2], columns[2];
+  if (!splitQualifiedColumn(plan.join_condition.substr(0, eq), tables[0],
+                            columns[0]) ||
+      !splitQualifiedColumn(plan.join_condition.substr(eq + 1), tables[1],
+                            columns[1])) {
+    return false;
+  }
+  std::shared_ptr<const TableStatistics> statistics[2];
+  double rows[2], scan_cost[2];
+  std::string where_column, op, literal;
+  bool has_where = splitWhereClause(plan.where_clause, where_column, op, literal);
+  for (int side = 0; side < 2; ++side) {
+    statistics[side] = lookupStatistics(context, tables[side]);
+    if (!statistics[side]) {
+      return false;
+    }
+    rows[side] = static_cast<double>(statistics[side]->row_count);
+    scan_cost[side] = seq_scan_cost(*statistics[side]);
+  }
+
+  // WHERE条件作用于带前缀的表，没有前缀时作用于FROM后的表
+  double where_selectivity = 1.0;
+  if (has_where) {
+    std::string where_table = plan.table_name, column = where_column;
+    splitQualifiedColumn(where_column, where_table, column);
+    for (int side = 0; side < 2; ++side) {
+      if (tables[side] == where_table) {
+        where_selectivity = statistics[side]->selectivity(column, op, literal);
+        rows[side] *= where_selectivity;
+        break;
+      }
+    }
+  }
+
+  // 内连接两种顺序都评估：外表扫描 + 内表扫描（索引嵌套循环不扫描内表）+ 连接
+  bool found = false;
+  for (int outer = 0; outer < 2; ++outer) {
+    int inner = 1 - outer;
+    JoinInputEstimate outer_input;
+    outer_input.rows = static_cast<size_t>(rows[outer]);
+    JoinInputEstimate inner_input;
+    inner_input.rows = static_cast<size_t>(rows[inner]);
+    inner_input.indexed_on_key =
+        hasIndexOn(context, tables[inner], columns[inner]);
+    JoinAlgorithm algorithm = choose_join_algorithm(
+        outer_input, inner_input, JoinType::INNER_JOIN, true);
+    double cost = scan_cost[outer] +
+                  estimate_join_cost(algorithm, outer_input, inner_input) *
+                      kCpuTupleCost;
+    if (algorithm != JoinAlgorithm::INDEX_NESTED_LOOP) {
+      cost += scan_cost[inner];
+    }
+    if (!found || cost < choice.cost) {
+      choice.outer_table = tables[outer];
+      choice.inner_table = tables[inner];
+      choice.algorithm = algorithm;
+      choice.cost = cost;
+      found = true;
+    }
+  }
+  choice.rows = estimate_join_rows(*statistics[0], columns[0], *statistics[1],
+                                   columns[1]) *
+                where_selectivity;
+  return true;
+}
+
+bool ExecutionPlanGenerator::buildJoinGraph(const ExecutionPlan &plan,
+                                            const ExecutionContext &context,
+                                            JoinGraph &graph,
+                                            size_t &where_relation) {
+  graph = JoinGraph();
+  where_relation = JoinTreeNode::npos;
+  auto add_relation = [&graph](const std::string &name) {
+    size_t index = graph.find(name);
+    if (index == graph.relations.size()) {
+      graph.relations.push_back({name, 0.0, 0.0});
+    }
+    return index;
+  };
+  add_relation(plan.table_name);
+  for (const auto &conjunct : splitConjuncts(plan.join_condition)) {
+    size_t eq = conjunct.find('=');
+    if (eq == std::string::npos || eq == 0 ||
+        std::string("<>!").find(conjunct[eq - 1]) != std::string::npos) {
+      return false;
+    }
+    std::string left_table, right_table;
+    JoinPredicate predicate;
+    if (!splitQualifiedColumn(conjunct.substr(0, eq), left_table,
+                              predicate.left_column) ||
+        !splitQualifiedColumn(conjunct.substr(eq + 1), right_table,
+                              predicate.right_column) ||
+        left_table == right_table) {
+      return false;
+    }
+    predicate.left = add_relation(left_table);
+    predicate.right = add_relation(right_table);
+    graph.predicates.push_back(predicate);
+  }
+
+  // 基表行数与扫描代价，没有统计信息时使用默认行数
+  std::vector<std::shared_ptr<const TableStatistics>> statistics;
+  for (auto &relation : graph.relations) {
+    auto table_statistics = lookupStatistics(context, relation.name);
+    if (!table_statistics) {
+      auto placeholder = std::make_shared<TableStatistics>();
+      placeholder->table_name = relation.name;
+      placeholder->row_count = static_cast<size_t>(kDefaultJoinRelationRows);
+      table_statistics = placeholder;
+      relation.scan_cost = kDefaultJoinRelationRows * kCpuTupleCost;
+    } else {
+      relation.scan_cost = seq_scan_cost(*table_statistics);
+    }
+    relation.rows = static_cast<double>(table_statistics->row_count);
+    statistics.push_back(std::move(table_statistics));
+  }
+  for (auto &predicate : graph.predicates) {
+    double product = graph.relations[predicate.left].rows *
+                     graph.relations[predicate.right].rows;
+    predicate.selectivity =
+        product > 0 ? estimate_join_rows(*statistics[predicate.left],
+                                         predicate.left_column,
+                                         *statistics[predicate.right],
+                                         predicate.right_column) /
+                          product
+                    : 1.0;
+  }
+
+  // WHERE条件下推到所属的表
+  std::string where_column, op, literal;
+  if (splitWhereClause(plan.where_clause, where_column, op, literal)) {
+    std::string table = plan.table_name, column = where_column;
+    splitQualifiedColumn(where_column, table, column);
+    where_relation = graph.find(table);
+    if (where_relation == graph.relations.size()) {
+      return false;
+    }
+    graph.relations[where_relation].rows *=
+        statistics[where_relation]->selectivity(column, op, literal);
+  }
+  return true;
+}
+
+OperatorPtr
+ExecutionPlanGenerator::generateJoinOperator(const sql_parser::SelectStatement &stmt,
+                                             const ExecutionContext &context) {
+  auto db_manager = context.db_manager ? context.db_manager : context.db_manager_;
+  if (!db_manager || !db_manager->GetStorageEngine()) {
+    throw Exception("Storage engine not available");
+  }
+
+  ExecutionPlan plan;
+  plan.table_name = stmt.getTableName();
+  plan.join_condition = stmt.getJoinCondition();
+  const auto &where = stmt.getWhereClause();
+  if (stmt.hasWhereClause()) {
+    plan.where_clause =
+        where.getColumnName() + " " + where.getOp() + " " + where.getValue();
+  }
+  JoinGraph graph;
+  size_t where_relation;
+  if (!buildJoinGraph(plan, context, graph, where_relation)) {
+    throw Exception("Unsupported join condition: " + stmt.getJoinCondition());
+  }
+  JoinTreePtr tree = optimize_join_order(graph);
+
+  auto table_storage =
+      std::make_shared<TableStorageManager>(db_manager->GetStorageEngine());
+  return build_join_operator(*tree, graph, [&](size_t relation) -> OperatorPtr {
+    const std::string &table_name = graph.relations[relation].name;
+    auto metadata = table_storage->GetTableMetadata(table_name);
+    if (!metadata) {
+      metadata = db_manager->GetTableMetadata(table_name);
+    }
+    if (!metadata) {
+      throw Exception("Table metadata not available: " + table_name);
+    }
+    auto table_scan =
+        std::make_unique<TableScanOperator>(table_storage, table_name, metadata);
+    if (auto statistics = lookupStatistics(context, table_name)) {
+      table_scan->set_estimated_rows(static_cast<double>(statistics->row_count));
+    }
+    if (relation != where_relation) {
+      return table_scan;
+    }
+    setZoneFilter(*table_scan, where.getColumnName(), where.getOp(),
+                  where.getValue());
+    OperatorPtr scan = std::move(table_scan);
+    CompiledPredicate predicate =
+        CompiledPredicate::compile(scan->output_columns(), where.getColumnName(),
+                                   where.getOp(), where.getValue());
+    return std::make_unique<FilterOperator>(std::move(scan), std::move(predicate),
+                                            plan.where_clause);
+  });
+}
+
+OperatorPtr
+ExecutionPlanGenerator::generateOperatorTree(const sql_parser::SelectStatement &stmt,
+                                             const ExecutionContext &context) {
+  if (stmt.hasJoinCondition()) {
+    // WHERE条件已在连接之下求值
+    sql_parser::SelectStatement rest = stmt;
+    rest.setWhereClause(sql_parser::WhereClause("", "", ""));
+    OperatorPtr root =
+        generateOperatorTree(rest, generateJoinOperator(stmt, context));
+    annotateEstimatedRows(*root, rest, nullptr);
+    return root;
+  }
+  OperatorPtr root =
+      generateOperatorTree(stmt, generateScanOperator(stmt, context));
+  auto statistics = lookupStatistics(context, stmt.getTableName());
+  annotateEstimatedRows(*root, stmt, statistics.get());
+  return root;
+}
+
+OperatorPtr
+ExecutionPlanGenerator::generateOperatorTree(const sql_parser::SelectStatement &stmt,
+                                             OperatorPtr source) {
+  std::string direction = stmt.getOrderDirection();
+  std::transform(direction.begin(), direction.end(), direction.begin(),
+                 ::toupper);
+  bool ascending = direction != "DESC";
+  // 数据源已按ORDER BY列升序输出（索引顺序扫描）时不再排序
+  const auto *order_scan =
+      dynamic_cast<const IndexOrderScanOperator *>(source.get());
+  bool source_ordered = order_scan && stmt.hasOrderBy() && ascending &&
+                        order_scan->column() == stmt.getOrderByColumn();
+
+  OperatorPtr root = std::move(source);
+
+  std::vector<AggregateSpec> aggregates;
+  for (const auto &column : stmt.getSelectColumns()) {
+    AggregateSpec spec;
+    if (parseAggregate(column, spec)) {
+      aggregates.push_back(spec);
+    }
+  }
+  // HAVING引用的聚合未出现在选择列中时补充计算，投影时再去掉
+  AggregateSpec having_spec;
+  if (stmt.hasHavingClause() &&
+      parseAggregate(stmt.getHavingClause().getColumnName(), having_spec) &&
+      std::none_of(aggregates.begin(), aggregates.end(),
+                   [&](const AggregateSpec &spec) {
+                     return spec.alias == having_spec.alias;
+                   })) {
+    aggregates.push_back(having_spec);
+  }
+  bool aggregated = !aggregates.empty() || stmt.hasGroupBy();
+  std::vector<std::string> group_by;
+  if (stmt.hasGroupBy()) {
+    group_by.push_back(stmt.getGroupByColumn());
+  }
+
+  // 1. WHERE条件（索引扫描之后仍然保留，保证类型化比较的语义）
+  auto add_filter = [&stmt](OperatorPtr input) -> OperatorPtr {
+    if (!stmt.hasWhereClause() ||
+        stmt.getWhereClause().getColumnName().empty()) {
+      return input;
+    }
+    const auto &where = stmt.getWhereClause();
+    CompiledPredicate predicate = CompiledPredicate::compile(
+        input->output_columns(), where.getColumnName(), where.getOp(),
+        where.getValue());
+    return std::make_unique<FilterOperator>(
+        std::move(input), std::move(predicate),
+        where.getColumnName() + " " + where.getOp() + " " + where.getValue());
+  };
+
+  // 全表扫描并行化：每个工作线程执行 morsel扫描→过滤→部分聚合，
+  // 汇集之后再做最终聚合。聚合列类型未知时各线程的累加器类型可能不一致，
+  // 此时只并行扫描和过滤
+  AggregatePhase phase = AggregatePhase::COMPLETE;
+  // 索引扫描只读取少量记录或依赖输出顺序，不并行
+  bool full_scan = dynamic_cast<TableScanOperator *>(root.get()) &&
+                   !dynamic_cast<IndexScanOperator *>(root.get()) &&
+                   !dynamic_cast<IndexOrderScanOperator *>(root.get());
+  if (parallel_degree_ > 1 && full_scan) {
+    const auto &scan_columns = root->output_columns();
+    bool partial =
+        aggregated &&
+        std::all_of(aggregates.begin(), aggregates.end(),
+                    [&](const AggregateSpec &spec) {
+                      return spec.function == AggregateSpec::COUNT ||
+                             spec.column.empty() || spec.column == "*" ||
+                             !scan_columns[resolve_column(scan_columns,
+                                                          spec.column)]
+                                  .data_type.empty();
+                    });
+    size_t dop = parallel_degree_;
+    size_t work_mem = work_mem_;
+    std::unique_ptr<TableScanOperator> scan(
+        static_cast<TableScanOperator *>(root.release()));
+    root = std::make_unique<ExchangeOperator>(
+        std::move(scan),
+        [&](OperatorPtr input) -> OperatorPtr {
+          input = add_filter(std::move(input));
+          if (partial) {
+            auto aggregate = std::make_unique<AggregateOperator>(
+                std::move(input), group_by, aggregates,
+                AggregatePhase::PARTIAL);
+            aggregate->set_memory_limit(work_mem / dop);
+            input = std::move(aggregate);
+          }
+          return input;
+        },
+        dop);
+    if (partial) {
+      phase = AggregatePhase::FINAL;
+    }
+  } else {
+    root = add_filter(std::move(root));
+  }
+
+  // 2. 聚合：选择列中出现聚合函数或存在GROUP BY
+  if (aggregated) {
+    auto aggregate = std::make_unique<AggregateOperator>(
+        std::move(root), group_by, aggregates, phase);
+    aggregate->set_memory_limit(work_mem_);
+    if (stmt.hasHavingClause()) {
+      const auto &having = stmt.getHavingClause();
+      aggregate->set_having(having.getColumnName(), having.getOp(),
+                            having.getValue());
+    }
+    root = std::move(aggregate);
+  }
+
+  // 3. 窗口函数：在聚合之后、排序之前计算
+  std::vector<WindowSpec> windows;
+  for (const auto &column : stmt.getSelectColumns()) {
+    WindowSpec spec;
+    if (parseWindowFunction(column, spec)) {
+      windows.push_back(spec);
+    }
+  }
+  if (!windows.empty()) {
+    root = std::make_unique<WindowOperator>(std::move(root), windows);
+  }
+
+  size_t limit = stmt.hasLimit() && stmt.getLimit() >= 0
+                     ? static_cast<size_t>(stmt.getLimit())
+                     : std::numeric_limits<size_t>::max();
+  size_t offset = stmt.hasOffset() && stmt.getOffset() > 0
+                      ? static_cast<size_t>(stmt.getOffset())
+                      : 0;
+  bool limited = stmt.hasLimit() && stmt.getLimit() >= 0;
+  if (aggregated || !windows.empty()) {
+    source_ordered = false;
+  }
+
+  // 4. 排序：带LIMIT时只保留前offset+limit行（Top-N堆）
+  if (stmt.hasOrderBy() && !source_ordered) {
+    std::vector<SortKey> keys{{stmt.getOrderByColumn(), ascending}};
+    if (limited) {
+      root = std::make_unique<TopNOperator>(std::move(root), keys, limit,
+                                            offset);
+    } else {
+      auto sort = std::make_unique<SortOperator>(std::move(root), keys);
+      sort->set_memory_limit(work_mem_);
+      root = std::move(sort);
+    }
+  }
+
+  // 5. LIMIT/OFFSET：满足后停止拉取下层算子
+  bool topn = stmt.hasOrderBy() && !source_ordered && limited;
+  if ((stmt.hasLimit() || stmt.hasOffset()) && !topn) {
+    root = std::make_unique<LimitOperator>(std::move(root), limit, offset);
+  }
+
+  // 6. 投影
+  if (!stmt.isSelectAll() && !stmt.getSelectColumns().empty()) {
+    std::vector<std::string> columns;
+    for (const auto &column : stmt.getSelectColumns()) {
+      AggregateSpec spec;
+      columns.push_back(parseAggregate(column, spec) ? spec.alias : column);
+    }
+    root = std::make_unique<ProjectOperator>(std::move(root), columns);
+  }
+
+  return root;
+}
+
+OperatorPtr
+ExecutionPlanGenerator::generateScanOperator(const sql_parser::SelectStatement &stmt,
+                                             const ExecutionContext &context) {
+  auto db_manager = context.db_manager ? context.db_manager : context.db_manager_;
+  if (!db_manager || !db_manager->GetStorageEngine()) {
+    throw Exception("Storage engine not available");
+  }
+
+  const std::string &table_name = stmt.getTableName();
+  auto table_storage =
+      std::make_shared<TableStorageManager>(db_manager->GetStorageEngine());
+  auto metadata = table_storage->GetTableMetadata(table_name);
+  if (!metadata) {
+    metadata = db_manager->GetTableMetadata(table_name);
+  }
+  if (!metadata) {
+    throw Exception("Table metadata not available: " + table_name);
+  }
+
+  // 等值条件按索引键定位；数值列的索引键按保序编码存储，>、>=、<、<= 沿B+树
+  // 叶子链做范围查找，其他列的范围条件走全表扫描+过滤。
+  // 有统计信息时只在索引扫描比全表扫描便宜时使用索引（低选择性的值走全表扫描）；
+  // 索引覆盖查询时不读数据页，总是使用索引
+  if (stmt.hasWhereClause()) {
+    const auto &where = stmt.getWhereClause();
+    const std::string &op = where.getOp();
+    bool range = op == ">" || op == ">=" || op == "<" || op == "<=";
+    auto column = std::find_if(
+        metadata->columns.begin(), metadata->columns.end(),
+        [&](const TableColumn &c) { return c.name == where.getColumnName(); });
+    std::string key = where.getValue();
+    if (key.size() >= 2 && key.front() == '\'' && key.back() == '\'') {
+      key = key.substr(1, key.size() - 2);
+    }
+    // 范围查找要求列为数值类型且常量能按该类型解析
+    bool usable = op == "=" ||
+                  (range && column != metadata->columns.end() &&
+                   parse_value("0", column->type).type != Value::Type::STRING &&
+                   parse_value(key, column->type).type != Value::Type::STRING);
+    auto index_manager = db_manager->GetIndexManager();
+    auto statistics = lookupStatistics(context, table_name);
+    bool cheaper = !statistics ||
+                   index_scan_is_cheaper(*statistics, where.getColumnName(),
+                                         op, where.getValue());
+    if (index_manager && usable) {
+      for (BPlusTreeIndex *index : index_manager->GetTableIndexes(table_name)) {
+        if (!index || index->GetColumnName() != where.getColumnName()) {
+          continue;
+        }
+        bool covering = indexCovers(*index, stmt, *metadata);
+        if (!cheaper && !covering) {
+          continue;
+        }
+        auto scan = std::make_unique<IndexScanOperator>(
+            table_storage, table_name, metadata, index, op, key);
+        if (covering) {
+          scan->set_index_only(index->GetColumnName(),
+                               index->GetIncludedColumns());
+        }
+        return scan;
+      }
+    }
+  }
+
+  // ORDER BY 索引列 LIMIT n：按索引顺序扫描，LIMIT满足后停止。索引顺序与
+  // 排序算子的升序一致（数值列按保序编码）；降序和聚合查询仍走Top-N
+  std::string direction = stmt.getOrderDirection();
+  std::transform(direction.begin(), direction.end(), direction.begin(),
+                 ::toupper);
+  bool has_aggregate = stmt.hasGroupBy();
+  for (const auto &column : stmt.getSelectColumns()) {
+    AggregateSpec spec;
+    has_aggregate = has_aggregate || parseAggregate(column, spec);
+  }
+  if (stmt.hasOrderBy() && stmt.hasLimit() && direction != "DESC" &&
+      !has_aggregate) {
+    auto column = std::find_if(
+        metadata->columns.begin(), metadata->columns.end(),
+        [&](const TableColumn &c) { return c.name == stmt.getOrderByColumn(); });
+    auto index_manager = db_manager->GetIndexManager();
+    if (column != metadata->columns.end() && !column->type.empty() &&
+        index_manager) {
+      for (BPlusTreeIndex *index : index_manager->GetTableIndexes(table_name)) {
+        if (index && index->GetColumnName() == column->name) {
+          auto scan = std::make_unique<IndexOrderScanOperator>(
+              table_storage, table_name, metadata, index, column->name);
+          if (indexCovers(*index, stmt, *metadata)) {
+            scan->set_index_only(index->GetColumnName(),
+                                 index->GetIncludedColumns());
+          }
+          return scan;
+        }
+      }
+    }
+  }
+
+  auto scan =
+      std::make_unique<TableScanOperator>(table_storage, table_name, metadata);
+  if (stmt.hasWhereClause()) {
+    const auto &where = stmt.getWhereClause();
+    setZoneFilter(*scan, where.getColumnName(), where.getOp(), where.getValue());
+  }
+  return scan;
+}
+
+bool ExecutionPlanGenerator::parseAggregate(const std::string &expr,
+                                            AggregateSpec &spec) {
+  size_t open = expr.find('(');
+  if (open == std::string::npos || expr.back() != ')') {
+    return false;
+  }
+  std::string name = expr.substr(0, open);
+  name.erase(std::remove(name.begin(), name.end(), ' '), name.end());
+  std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+
+  static const std::unordered_map<std::string, AggregateSpec::Function>
+      functions = {{"COUNT", AggregateSpec::COUNT},
+                   {"SUM", AggregateSpec::SUM},
+                   {"AVG", AggregateSpec::AVG},
+                   {"MIN", AggregateSpec::MIN},
+                   {"MAX", AggregateSpec::MAX}};
+  auto it = functions.find(name);
+  if (it == functions.end()) {
+    return false;
+  }
+
+  std::string argument = expr.substr(open + 1, expr.size() - open - 2);
+  argument.erase(0, argument.find_first_not_of(" \t"));
+  argument.erase(argument.find_last_not_of(" \t") + 1);
+  // 参数中还有括号时是窗口函数（如 "SUM(x) OVER (...)"）
+  if (argument.find_first_of("()") != std::string::npos) {
+    return false;
+  }
+  spec.function = it->second;
+  spec.column = argument == "*" ? "" : argument;
+  spec.alias = expr;
+  return true;
+}
+
+namespace {
+
+std::string trimText(const std::string &text) {
+  size_t begin = text.find_first_not_of(" \t\n\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = text.find_last_not_of(" \t\n\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+std::vector<std::string> splitList(const std::string &text) {
+  std::vector<std::string> items;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    item = trimText(item);
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+// 解析帧边界，返回相对当前行的偏移
+int64_t parseFrameBound(const std::string &bound) {
+  std::string upper = trimText(bound);
+  if (upper == "CURRENT ROW") {
+    return 0;
+  } else if (upper == "UNBOUNDED PRECEDING") {
+    return WindowSpec::kUnboundedPreceding;
+  } else if (upper == "UNBOUNDED FOLLOWING") {
+    return WindowSpec::kUnboundedFollowing;
+  }
+  size_t space = upper.find(' ');
+  if (space != std::string::npos) {
+    std::string count = upper.substr(0, space);
+    std::string direction = trimText(upper.substr(space + 1));
+    if (!count.empty() &&
+        std::all_of(count.begin(), count.end(), ::isdigit) &&
+        (direction == "PRECEDING" || direction == "FOLLOWING")) {
+      int64_t offset = std::stoll(count);
+      return direction == "PRECEDING" ? -offset : offset;
+    }
+  }
+  throw Exception("Unsupported window frame bound: " + bound);
+}
+
+} // namespace
+
+bool ExecutionPlanGenerator::parseWindowFunction(const std::string &expr,
+                                                 WindowSpec &spec) {
+  std::string upper = expr;
+  std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+  size_t call_end = upper.find(')');
+  size_t over = upper.find("OVER", call_end == std::string::npos ? 0 : call_end);
+  size_t window_open = upper.find('(', over);
+  if (call_end == std::string::npos || over == std::string::npos ||
+      window_open == std::string::npos || upper.back() != ')' ||
+      !trimText(upper.substr(call_end + 1, over - call_end - 1)).empty() ||
+      !trimText(upper.substr(over + 4, window_open - over - 4)).empty()) {
+    return false;
+  }
+
+  // 函数名与参数
+  size_t call_open = upper.find('(');
+  std::string name = trimText(upper.substr(0, call_open));
+  static const std::unordered_map<std::string, WindowSpec::Function>
+      functions = {{"ROW_NUMBER", WindowSpec::ROW_NUMBER},
+                   {"RANK", WindowSpec::RANK},
+                   {"DENSE_RANK", WindowSpec::DENSE_RANK},
+                   {"LAG", WindowSpec::LAG},
+                   {"LEAD", WindowSpec::LEAD},
+                   {"SUM", WindowSpec::SUM},
+                   {"COUNT", WindowSpec::COUNT},
+                   {"AVG", WindowSpec::AVG},
+                   {"MIN", WindowSpec::MIN},
+                   {"MAX", WindowSpec::MAX}};
+  auto it = functions.find(name);
+  if (it == functions.end()) {
+    throw Exception("Unsupported window function: " + name);
+  }
+  spec = WindowSpec();
+  spec.function = it->second;
+  spec.alias = expr;
+  std::vector<std::string> arguments =
+      splitList(expr.substr(call_open + 1, call_end - call_open - 1));
+  if (!arguments.empty() && arguments[0] != "*") {
+    spec.column = arguments[0];
+  }
+  if (spec.function == WindowSpec::LAG || spec.function == WindowSpec::LEAD) {
+    if (arguments.size() > 1) {
+      spec.offset = std::stoll(arguments[1]);
+    }
+    if (arguments.size() > 2) {
+      std::string literal = arguments[2];
+      if (literal.size() >= 2 && literal.front() == '\'' &&
+          literal.back() == '\'') {
+        spec.default_value = Value(literal.substr(1, literal.size() - 2));
+      } else {
+        spec.default_value = parse_value(literal, "DOUBLE");
+        if (spec.default_value.type == Value::Type::DOUBLE &&
+            literal.find_first_of(".eE") == std::string::npos) {
+          spec.default_value = parse_value(literal, "INT");
+        }
+      }
+    }
+  }
+
+  // OVER子句：[PARTITION BY ...] [ORDER BY ...] [ROWS ...]
+  std::string window = upper.substr(window_open + 1,
+                                    upper.size() - window_open - 2);
+  std::string original = expr.substr(window_open + 1,
+                                     expr.size() - window_open - 2);
+  size_t partition = window.find("PARTITION BY");
+  size_t order = window.find("ORDER BY");
+  size_t frame = window.find("ROWS");
+  if (window.find("RANGE") != std::string::npos) {
+    throw Exception("RANGE window frames are not supported: " + expr);
+  }
+  auto clause_end = [&](size_t start) {
+    size_t end = window.size();
+    for (size_t next : {partition, order, frame}) {
+      if (next != std::string::npos && next > start && next < end) {
+        end = next;
+      }
+    }
+    return end;
+  };
+  if (partition != std::string::npos) {
+    size_t start = partition + 12;
+    spec.partition_by =
+        splitList(original.substr(start, clause_end(start) - start));
+  }
+  if (order != std::string::npos) {
+    size_t start = order + 8;
+    for (const auto &item :
+         splitList(original.substr(start, clause_end(start) - start))) {
+      SortKey key{item, true};
+      std::string item_upper = item;
+      std::transform(item_upper.begin(), item_upper.end(), item_upper.begin(),
+                     ::toupper);
+      for (const char *suffix : {" ASC", " DESC"}) {
+        size_t length = std::strlen(suffix);
+        if (item_upper.size() > length &&
+            item_upper.compare(item_upper.size() - length, length, suffix) ==
+                0) {
+          key.column = trimText(item.substr(0, item.size() - length));
+          key.ascending = std::strcmp(suffix, " ASC") == 0;
+        }
+      }
+      spec.order_by.push_back(key);
+    }
+  }
+  if (frame != std::string::npos) {
+    std::string clause = trimText(window.substr(frame + 4));
+    spec.has_frame = true;
+    if (clause.rfind("BETWEEN ", 0) == 0) {
+      size_t and_pos = clause.find(" AND ");
+      if (and_pos == std::string::npos) {
+        throw Exception("Invalid window frame: " + expr);
+      }
+      spec.frame_start = parseFrameBound(clause.substr(8, and_pos - 8));
+      spec.frame_end = parseFrameBound(clause.substr(and_pos + 5));
+    } else {
+      spec.frame_start = parseFrameBound(clause);
+      spec.frame_end = 0;
+    }
+  }
+  return true;
+}
+
 // ==================== RuleBasedOptimizer 实现 ====================
 
 RuleBasedOptimizer::RuleBasedOptimizer() {
@@ -276,6 +1368,16 @@ bool RuleBasedOptimizer::isRuleEnabled(const std::string &rule_name) const {
   return (it != optimization_rules_.end()) && it->second;
 }
 
+// ==================== CostBasedOptimizer 实现 ====================
+
+ExecutionPlan CostBasedOptimizer::optimize(const ExecutionPlan &plan,
+                                           const ExecutionContext &context) {
+  ExecutionPlan optimized_plan = RuleBasedOptimizer::optimize(plan, context);
+  // 规则优化不改变计划的实际代价，按统计信息重新估计
+  optimized_plan.cost_estimate = estimateCost(optimized_plan, context);
+  return optimized_plan;
+}
+
 // ==================== ExecutionStrategy 基类实现 ====================
 
 bool ExecutionStrategy::checkPermission(const sql_parser::Statement *stmt,
@@ -325,81 +1427,6 @@ bool ExecutionStrategy::defaultPermissionCheck(
   return context.current_user == "admin";
 }
 
-// 辅助方法实现
-bool ExecutionStrategy::matchesWhereClause(
-    const std::vector<std::string> &record,
-    const sql_parser::WhereClause &where_clause,
-    std::shared_ptr<TableMetadata> metadata) {
-
-  if (where_clause.getColumnName().empty()) {
-    return true;
-  }
-
-  std::string column_value =
-      getColumnValue(record, where_clause.getColumnName(), metadata);
-  return compareValues(column_value, where_clause.getValue(),
-                       where_clause.getOp());
-}
-
-std::string
-ExecutionStrategy::getColumnValue(const std::vector<std::string> &record,
-                                  const std::string &column_name,
-                                  std::shared_ptr<TableMetadata> metadata) {
-
-  if (!metadata)
-    return "";
-
-  auto it = metadata->column_index_map.find(column_name);
-  if (it == metadata->column_index_map.end())
-    return "";
-
-  int index = it->second;
-  if (index < 0 || index >= static_cast<int>(record.size()))
-    return "";
-
-  return record[index];
-}
-
-bool ExecutionStrategy::compareValues(const std::string &left,
-                                      const std::string &right,
-                                      const std::string &op) {
-
-  if (op == "=")
-    return left == right;
-  if (op == "<>")
-    return left != right;
-  if (op == "<") {
-    try {
-      return std::stoi(left) < std::stoi(right);
-    } catch (...) {
-      return left < right;
-    }
-  }
-  if (op == ">") {
-    try {
-      return std::stoi(left) > std::stoi(right);
-    } catch (...) {
-      return left > right;
-    }
-  }
-  if (op == "<=") {
-    try {
-      return std::stoi(left) <= std::stoi(right);
-    } catch (...) {
-      return left <= right;
-    }
-  }
-  if (op == ">=") {
-    try {
-      return std::stoi(left) >= std::stoi(right);
-    } catch (...) {
-      return left > right;
-    }
-  }
-
-  return false;
-}
-
 // 约束验证方法实现
 bool ExecutionStrategy::validateColumnConstraints(
     const std::vector<std::string> &record,
@@ -439,23 +1466,106 @@ bool ExecutionStrategy::checkUniqueKeyConstraints(
 }
 
 // 索引维护方法实现
+namespace {
+
+// 表上的索引和表的元数据，没有索引时返回false
+bool tableIndexes(const ExecutionContext &context, const std::string &table_name,
+                  std::vector<BPlusTreeIndex *> &indexes,
+                  std::shared_ptr<TableMetadata> &metadata) {
+  auto db_manager = context.db_manager ? context.db_manager : context.db_manager_;
+  auto index_manager = db_manager ? db_manager->GetIndexManager() : nullptr;
+  if (!index_manager) {
+    return false;
+  }
+  indexes = index_manager->GetTableIndexes(table_name);
+  if (indexes.empty()) {
+    return false;
+  }
+  metadata = db_manager->GetTableMetadata(table_name);
+  return metadata != nullptr;
+}
+
+// 删除指向(page_id, offset)的索引条目。Delete按键删除，同键的其他条目
+// 删除后重新插入，保证INCLUDE列的值与各自的记录一致
+void removeIndexEntry(BPlusTreeIndex &index, const std::string &key,
+                      int32_t page_id, size_t offset) {
+  std::vector<IndexEntry> entries = index.Search(key);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    index.Delete(key);
+  }
+  for (const auto &entry : entries) {
+    if (entry.page_id != page_id || entry.offset != offset) {
+      index.Insert(entry);
+    }
+  }
+}
+
+} // namespace
+
 void ExecutionStrategy::maintainIndexesOnInsert(
     const std::vector<std::string> &record, const std::string &table_name,
     int32_t page_id, size_t offset, ExecutionContext &context) {
-  // 索引维护的简化实现
+  std::vector<BPlusTreeIndex *> indexes;
+  std::shared_ptr<TableMetadata> metadata;
+  if (!tableIndexes(context, table_name, indexes, metadata)) {
+    return;
+  }
+  for (BPlusTreeIndex *index : indexes) {
+    IndexEntry entry;
+    if (index && index->MakeEntry(record, *metadata, page_id, offset, entry)) {
+      index->Insert(entry);
+    }
+  }
 }
 
 void ExecutionStrategy::maintainIndexesOnUpdate(
     const std::vector<std::string> &old_record,
     const std::vector<std::string> &new_record, const std::string &table_name,
-    int32_t page_id, size_t offset, ExecutionContext &context) {
-  // 索引维护的简化实现
+    int32_t old_page_id, size_t old_offset, int32_t new_page_id,
+    size_t new_offset, ExecutionContext &context) {
+  std::vector<BPlusTreeIndex *> indexes;
+  std::shared_ptr<TableMetadata> metadata;
+  if (!tableIndexes(context, table_name, indexes, metadata)) {
+    return;
+  }
+  bool moved = old_page_id != new_page_id || old_offset != new_offset;
+  for (BPlusTreeIndex *index : indexes) {
+    IndexEntry old_entry;
+    IndexEntry new_entry;
+    bool had_entry =
+        index && index->MakeEntry(old_record, *metadata, old_page_id,
+                                  old_offset, old_entry);
+    bool has_entry =
+        index && index->MakeEntry(new_record, *metadata, new_page_id,
+                                  new_offset, new_entry);
+    // 位置、键值和INCLUDE列的值都没有变化时索引条目保持不变
+    if (had_entry && has_entry && !moved && old_entry.key == new_entry.key &&
+        old_entry.included_values == new_entry.included_values) {
+      continue;
+    }
+    if (had_entry) {
+      removeIndexEntry(*index, old_entry.key, old_page_id, old_offset);
+    }
+    if (has_entry) {
+      index->Insert(new_entry);
+    }
+  }
 }
 
 void ExecutionStrategy::maintainIndexesOnDelete(
     const std::vector<std::string> &record, const std::string &table_name,
     int32_t page_id, size_t offset, ExecutionContext &context) {
-  // 索引维护的简化实现
+  std::vector<BPlusTreeIndex *> indexes;
+  std::shared_ptr<TableMetadata> metadata;
+  if (!tableIndexes(context, table_name, indexes, metadata)) {
+    return;
+  }
+  for (BPlusTreeIndex *index : indexes) {
+    IndexEntry entry;
+    if (index && index->MakeEntry(record, *metadata, page_id, offset, entry)) {
+      removeIndexEntry(*index, entry.key, page_id, offset);
+    }
+  }
 }
 
 // ==================== DDLExecutionStrategy ====================
@@ -474,6 +1584,12 @@ DDLExecutionStrategy::execute(std::unique_ptr<sql_parser::Statement> stmt,
   } else if (auto alter_stmt =
                  dynamic_cast<sql_parser::AlterStatement *>(stmt.get())) {
     return executeAlter(alter_stmt, context);
+  } else if (auto create_index_stmt =
+                 dynamic_cast<sql_parser::CreateIndexStatement *>(stmt.get())) {
+    return executeCreateIndex(create_index_stmt, context);
+  } else if (auto drop_index_stmt =
+                 dynamic_cast<sql_parser::DropIndexStatement *>(stmt.get())) {
+    return executeDropIndex(drop_index_stmt, context);
   }
 
   return {false, "Unsupported DDL statement type"};
@@ -553,6 +1669,7 @@ DDLExecutionStrategy::executeDrop(sql_parser::DropStatement *stmt,
   case sql_parser::DropStatement::DATABASE: {
     std::string db_name = stmt->getObjectName();
     if (context.db_manager->DropDatabase(db_name)) {
+      QueryResultCache::shared().clear();
       context.records_affected = 1;
       return {true, "Database '" + db_name + "' dropped successfully"};
     } else {
@@ -563,6 +1680,9 @@ DDLExecutionStrategy::executeDrop(sql_parser::DropStatement *stmt,
   case sql_parser::DropStatement::TABLE: {
     std::string table_name = stmt->getObjectName();
     if (context.db_manager->DropTable(table_name)) {
+      StatisticsCatalog::shared().remove(context.current_database, table_name);
+      QueryResultCache::shared().invalidate_table(context.current_database,
+                                                  table_name);
       context.records_affected = 1;
       return {true, "Table '" + table_name + "' dropped successfully"};
     } else {
@@ -587,7 +1707,71 @@ ExecutionResult
 DDLExecutionStrategy::executeCreateIndex(sql_parser::CreateIndexStatement *stmt,
                                          ExecutionContext &context) {
 
-  // CREATE INDEX的简化实现
+  auto db_manager = context.db_manager ? context.db_manager : context.db_manager_;
+  if (!db_manager || !db_manager->GetStorageEngine()) {
+    return {false, "Storage engine not available"};
+  }
+  auto index_manager = db_manager->GetIndexManager();
+  if (!index_manager) {
+    return {false, "Index manager not available"};
+  }
+  const std::string &table_name = stmt->getTableName();
+  auto metadata = db_manager->GetTableMetadata(table_name);
+  if (!metadata) {
+    return {false, "Table '" + table_name + "' does not exist"};
+  }
+
+  // 只支持单列索引键；INCLUDE列不能重复，也不能是键列
+  const auto &columns = stmt->getColumns();
+  if (columns.size() != 1) {
+    return {false, "Only single-column index keys are supported"};
+  }
+  const auto &included = stmt->getIncludedColumns();
+  auto has_column = [&](const std::string &name) {
+    return std::any_of(
+        metadata->columns.begin(), metadata->columns.end(),
+        [&](const TableColumn &column) { return column.name == name; });
+  };
+  for (size_t i = 0; i < columns.size() + included.size(); ++i) {
+    const std::string &name =
+        i < columns.size() ? columns[i] : included[i - columns.size()];
+    if (!has_column(name)) {
+      return {false, "Column '" + name + "' does not exist in table '" +
+                         table_name + "'"};
+    }
+    if (i >= columns.size() &&
+        (name == columns.front() ||
+         std::find(included.begin(), included.begin() + (i - columns.size()),
+                   name) != included.begin() + (i - columns.size()))) {
+      return {false, "Duplicate column '" + name + "' in index"};
+    }
+  }
+
+  if (!index_manager->CreateIndex(stmt->getIndexName(), table_name,
+                                  columns.front(), stmt->isUnique(),
+                                  included)) {
+    return {false, "Failed to create index '" + stmt->getIndexName() + "'"};
+  }
+
+  // 为已有记录建立索引条目
+  BPlusTreeIndex *index =
+      index_manager->GetIndex(stmt->getIndexName(), table_name);
+  if (index) {
+    TableStorageManager table_storage(db_manager->GetStorageEngine());
+    for (const auto &location : table_storage.ScanTable(table_name)) {
+      std::vector<std::string> record =
+          table_storage.GetRecord(table_name, location.first, location.second);
+      IndexEntry entry;
+      if (!record.empty() &&
+          index->MakeEntry(record, *metadata, location.first, location.second,
+                           entry) &&
+          !index->Insert(entry)) {
+        return {false, "Failed to build index '" + stmt->getIndexName() +
+                           "': entry too large"};
+      }
+    }
+  }
+  context.records_affected = 1;
   return {true, "Index created successfully"};
 }
 
@@ -601,24 +1785,134 @@ DDLExecutionStrategy::executeDropIndex(sql_parser::DropIndexStatement *stmt,
 
 // ==================== DMLExecutionStrategy ====================
 
+namespace {
+
+// 并行度：会话设置优先，其次为executor.parallel_degree，默认使用全部核
+size_t resolveParallelDegree(const ExecutionContext &context) {
+  size_t dop = context.get_parallel_degree();
+  if (dop == 0) {
+    int configured =
+        ConfigManager::GetInstance().GetInt("executor.parallel_degree", 0);
+    dop = configured > 0 ? static_cast<size_t>(configured)
+                         : default_parallel_degree();
+  }
+  return dop;
+}
+
+// 按执行器配置生成SELECT的算子树，并在上下文中记录是否使用索引和计划文本
+OperatorPtr buildSelectOperatorTree(const sql_parser::SelectStatement &stmt,
+                                    ExecutionContext &context) {
+  ExecutionPlanGenerator plan_generator;
+  // executor.work_mem_kb：排序/聚合的工作内存，未配置时使用算子默认值
+  int work_mem_kb =
+      ConfigManager::GetInstance().GetInt("executor.work_mem_kb", 0);
+  if (work_mem_kb > 0) {
+    plan_generator.setWorkMem(static_cast<size_t>(work_mem_kb) * 1024);
+  }
+  plan_generator.setParallelDegree(resolveParallelDegree(context));
+  OperatorPtr root = plan_generator.generateOperatorTree(stmt, context);
+
+  const PhysicalOperator *leaf = root.get();
+  while (!leaf->children().empty()) {
+    leaf = leaf->children().front().get();
+  }
+  context.used_index = dynamic_cast<const IndexScanOperator *>(leaf) != nullptr;
+  context.execution_plan = root->explain();
+  return root;
+}
+
+// 收集一张表的统计信息，写入系统表和统计信息目录。
+// executor.analyze_sample_pages：每张表最多读取的页数，0表示读取全部页
+void analyzeTable(ExecutionContext &context, const std::string &table_name) {
+  auto db_manager = context.db_manager ? context.db_manager : context.db_manager_;
+  if (!db_manager || !db_manager->GetStorageEngine()) {
+    throw Exception("Storage engine not available");
+  }
+  auto table_storage =
+      std::make_shared<TableStorageManager>(db_manager->GetStorageEngine());
+  auto metadata = table_storage->GetTableMetadata(table_name);
+  if (!metadata) {
+    metadata = db_manager->GetTableMetadata(table_name);
+  }
+  if (!metadata) {
+    throw Exception("Table '" + table_name + "' does not exist");
+  }
+
+  StatisticsOptions options;
+  int sample_pages = ConfigManager::GetInstance().GetInt(
+      "executor.analyze_sample_pages", static_cast<int>(kDefaultSamplePages));
+  options.sample_pages = sample_pages > 0 ? static_cast<size_t>(sample_pages) : 0;
+  options.parallel_degree = resolveParallelDegree(context);
+  options.seed = std::hash<std::string>()(table_name);
+
+  TableScanOperator table_scan(table_storage, table_name, metadata);
+  TableStatistics statistics = collect_table_statistics(table_scan, options);
+
+  // 持久化到系统表；优化器读取的是进程内的统计信息目录
+  auto system_db = context.system_db ? context.system_db : context.system_db_;
+  if (system_db) {
+    system_db->SaveTableStatistics(metadata->table_id, statistics.row_count,
+                                   statistics.page_count);
+    for (const auto &column : statistics.columns) {
+      system_db->SaveColumnStatistics(
+          metadata->table_id, column.column_name, column.data_type,
+          column.null_fraction, column.distinct_count,
+          encode_histogram(column.histogram));
+    }
+  }
+  StatisticsCatalog::shared().put(context.current_database,
+                                  std::move(statistics));
+}
+
+/**
+ * 在查询结果缓存中登记一次对表的写入：写入期间依赖该表的结果不命中也
+ * 不缓存，作用域结束时提交并使依赖结果失效。语句自动提交且没有语句级
+ * 撤销，中途失败或抛出异常时也可能已写入部分行，同样按提交处理
+ */
+class ResultCacheWriteScope {
+public:
+  ResultCacheWriteScope(const std::string &database, const std::string &table)
+      : database_(database), table_(table) {
+    QueryResultCache::shared().begin_write(database_, table_);
+  }
+
+  ~ResultCacheWriteScope() {
+    QueryResultCache::shared().commit_write(database_, table_);
+  }
+
+private:
+  std::string database_;
+  std::string table_;
+};
+
+} // namespace
+
 ExecutionResult
 DMLExecutionStrategy::execute(std::unique_ptr<sql_parser::Statement> stmt,
                               ExecutionContext &context) {
 
   if (auto insert_stmt =
           dynamic_cast<sql_parser::InsertStatement *>(stmt.get())) {
+    ResultCacheWriteScope write(context.current_database,
+                                insert_stmt->getTableName());
     return executeInsert(insert_stmt, context);
   } else if (auto update_stmt =
                  dynamic_cast<sql_parser::UpdateStatement *>(stmt.get())) {
+    ResultCacheWriteScope write(context.current_database,
+                                update_stmt->getTableName());
     return executeUpdate(update_stmt, context);
   } else if (auto delete_stmt =
                  dynamic_cast<sql_parser::DeleteStatement *>(stmt.get())) {
+    ResultCacheWriteScope write(context.current_database,
+                                delete_stmt->getTableName());
     return executeDelete(delete_stmt, context);
   } else if (auto select_stmt =
                  dynamic_cast<sql_parser::SelectStatement *>(stmt.get())) {
     return executeSelect(select_stmt, context);
+  } else if (auto explain_stmt =
+                 dynamic_cast<sql_parser::ExplainStatement *>(stmt.get())) {
+    return executeExplain(explain_stmt, context);
   }
-
   return {false, "Unsupported DML statement type"};
 }
 
@@ -629,6 +1923,13 @@ bool DMLExecutionStrategy::checkPermission(const sql_parser::Statement *stmt,
     return true; // 默认允许
   }
 
+  // EXPLAIN按被解释的语句检查权限
+  if (auto explain_stmt =
+          dynamic_cast<const sql_parser::ExplainStatement *>(stmt)) {
+    return explain_stmt->getStatement() &&
+           checkPermission(explain_stmt->getStatement(), context);
+  }
+
   std::string operation;
   std::string table_name;
 
@@ -661,6 +1962,12 @@ bool DMLExecutionStrategy::validate(const sql_parser::Statement *stmt,
     return false;
   }
 
+  if (auto explain_stmt =
+          dynamic_cast<const sql_parser::ExplainStatement *>(stmt)) {
+    return explain_stmt->getStatement() &&
+           validate(explain_stmt->getStatement(), context);
+  }
+
   // 检查表是否存在
   std::string table_name;
   if (auto insert_stmt =
@@ -726,6 +2033,7 @@ DMLExecutionStrategy::executeInsert(sql_parser::InsertStatement *stmt,
   }
 
   context.records_affected = rows_inserted;
+  trackModifications(context, stmt->getTableName(), rows_inserted, 0, 0);
   return {true, "INSERT executed successfully, " +
                     std::to_string(rows_inserted) + " row(s) inserted"};
 }
@@ -745,6 +2053,15 @@ DMLExecutionStrategy::executeUpdate(sql_parser::UpdateStatement *stmt,
     return {false, "Failed to get table metadata"};
   }
 
+  // WHERE条件只编译一次，逐行求值
+  CompiledPredicate where_predicate;
+  try {
+    where_predicate =
+        CompiledPredicate::compile(stmt->getWhereClause(), *metadata);
+  } catch (const Exception &e) {
+    return {false, e.what()};
+  }
+
   // 索引优化查询
   std::vector<std::pair<int32_t, size_t>> locations;
   if (stmt->hasWhereClause()) {
@@ -766,8 +2083,7 @@ DMLExecutionStrategy::executeUpdate(sql_parser::UpdateStatement *stmt,
       continue;
 
     // WHERE条件检查
-    if (!stmt->hasWhereClause() ||
-        matchesWhereClause(record, stmt->getWhereClause(), metadata)) {
+    if (where_predicate(record)) {
       std::vector<std::string> new_record = record;
 
       // 应用更新
@@ -795,19 +2111,23 @@ DMLExecutionStrategy::executeUpdate(sql_parser::UpdateStatement *stmt,
         return {false, "Constraint validation failed for update"};
       }
 
-      // 索引维护
-      maintainIndexesOnUpdate(record, new_record, stmt->getTableName(),
-                              location.first, location.second, context);
-
-      // 更新记录
+      // 更新记录：新版本可能写到页内其他位置或移到表末尾，
+      // 索引按更新后的位置维护
+      int32_t new_page_id = location.first;
+      size_t new_offset = location.second;
       if (table_storage.UpdateRecord(stmt->getTableName(), location.first,
-                                     location.second, new_record)) {
+                                     location.second, new_record, new_page_id,
+                                     new_offset)) {
+        maintainIndexesOnUpdate(record, new_record, stmt->getTableName(),
+                                location.first, location.second, new_page_id,
+                                new_offset, context);
         rows_updated++;
       }
     }
   }
 
   context.records_affected = rows_updated;
+  trackModifications(context, stmt->getTableName(), 0, 0, rows_updated);
   return {true, "UPDATE executed successfully, " +
                     std::to_string(rows_updated) + " row(s) updated"};
 }
@@ -827,6 +2147,15 @@ DMLExecutionStrategy::executeDelete(sql_parser::DeleteStatement *stmt,
     return {false, "Failed to get table metadata"};
   }
 
+  // WHERE条件只编译一次，逐行求值
+  CompiledPredicate where_predicate;
+  try {
+    where_predicate =
+        CompiledPredicate::compile(stmt->getWhereClause(), *metadata);
+  } catch (const Exception &e) {
+    return {false, e.what()};
+  }
+
   // 索引优化查询
   std::vector<std::pair<int32_t, size_t>> locations;
   if (stmt->hasWhereClause()) {
@@ -847,8 +2176,7 @@ DMLExecutionStrategy::executeDelete(sql_parser::DeleteStatement *stmt,
       continue;
 
     // WHERE条件检查
-    if (!stmt->hasWhereClause() ||
-        matchesWhereClause(record, stmt->getWhereClause(), metadata)) {
+    if (where_predicate(record)) {
       // 索引维护
       maintainIndexesOnDelete(record, stmt->getTableName(), location.first,
                               location.second, context);
@@ -862,6 +2190,7 @@ DMLExecutionStrategy::executeDelete(sql_parser::DeleteStatement *stmt,
   }
 
   context.records_affected = rows_deleted;
+  trackModifications(context, stmt->getTableName(), 0, rows_deleted, 0);
   return {true, "DELETE executed successfully, " +
                     std::to_string(rows_deleted) + " row(s) deleted"};
 }
@@ -870,9 +2199,95 @@ ExecutionResult
 DMLExecutionStrategy::executeSelect(sql_parser::SelectStatement *stmt,
                                     ExecutionContext &context) {
 
-  // SELECT语句的简化实现
-  context.records_affected = 0;
-  return {true, "SELECT executed successfully"};
+  try {
+    OperatorPtr root = buildSelectOperatorTree(*stmt, context);
+    ExecutionResult result = execute_operator_tree(*root);
+    context.records_affected = 0;
+    context.rows_returned_ = result.rows.size();
+    result.message = "SELECT executed successfully, " +
+                     std::to_string(result.rows.size()) + " row(s) returned";
+    return result;
+  } catch (const std::exception &e) {
+    return {false, std::string("SELECT failed: ") + e.what()};
+  }
+}
+
+ExecutionResult
+DMLExecutionStrategy::executeExplain(sql_parser::ExplainStatement *stmt,
+                                     ExecutionContext &context) {
+  auto select_stmt =
+      dynamic_cast<sql_parser::SelectStatement *>(stmt->getStatement());
+  if (!select_stmt) {
+    return {false, "EXPLAIN supports only SELECT statements"};
+  }
+
+  try {
+    OperatorPtr root = buildSelectOperatorTree(*select_stmt, context);
+    std::string plan;
+    if (!stmt->isAnalyze()) {
+      plan = root->explain();
+    } else {
+      // 实际执行查询，结果行直接丢弃，只输出各算子的运行统计
+      root = instrument_operator_tree(std::move(root));
+      auto start = std::chrono::steady_clock::now();
+      size_t rows = 0;
+      root->open();
+      try {
+        RowBatch batch;
+        while (root->next(batch)) {
+          rows += batch.size();
+        }
+      } catch (...) {
+        root->close();
+        throw;
+      }
+      root->close();
+      std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+
+      char total[96];
+      std::snprintf(total, sizeof(total), "Execution Time: %.3f ms, %zu row(s)",
+                    elapsed.count(), rows);
+      plan = explain_analyze(*root) + total + "\n";
+    }
+    context.execution_plan = plan;
+
+    // 每行计划一个结果行
+    ExecutionResult result(true, "EXPLAIN executed successfully");
+    result.column_metadata.push_back(
+        {"QUERY PLAN", "VARCHAR", false, false, false, ""});
+    std::stringstream lines(plan);
+    std::string line;
+    while (std::getline(lines, line)) {
+      Row row;
+      row.values.push_back(Value(line));
+      result.rows.push_back(std::move(row));
+    }
+    context.records_affected = 0;
+    context.rows_returned_ = result.rows.size();
+    return result;
+  } catch (const std::exception &e) {
+    return {false, std::string("EXPLAIN failed: ") + e.what()};
+  }
+}
+
+void DMLExecutionStrategy::trackModifications(ExecutionContext &context,
+                                              const std::string &table_name,
+                                              size_t inserted, size_t deleted,
+                                              size_t updated) {
+  auto &catalog = StatisticsCatalog::shared();
+  catalog.record_modification(context.current_database, table_name, inserted,
+                              deleted, updated);
+  // executor.auto_analyze：修改行数超过阈值时在本语句中重新收集（按页采样）
+  if (!ConfigManager::GetInstance().GetBool("executor.auto_analyze", true) ||
+      !catalog.needs_analyze(context.current_database, table_name)) {
+    return;
+  }
+  try {
+    analyzeTable(context, table_name);
+  } catch (const std::exception &) {
+    // 自动ANALYZE失败不影响DML结果，保留增量调整后的统计信息
+  }
 }
 
 // 索引优化查询实现
@@ -910,11 +2325,13 @@ DMLExecutionStrategy::optimizeQueryWithIndex(
     return all_locations;
   }
 
+  CompiledPredicate predicate =
+      CompiledPredicate::compile(where_clause, *metadata);
   std::vector<std::pair<int32_t, size_t>> filtered_locations;
   for (const auto &location : all_locations) {
     std::vector<std::string> record =
         table_storage.GetRecord(table_name, location.first, location.second);
-    if (!record.empty() && matchesWhereClause(record, where_clause, metadata)) {
+    if (!record.empty() && predicate(record)) {
       filtered_locations.push_back(location);
     }
   }
@@ -987,6 +2404,7 @@ DCLExecutionStrategy::executeDropUser(sql_parser::DropUserStatement *stmt,
   std::string username = stmt->getUsername();
 
   if (context.user_manager->DropUser(username)) {
+    QueryResultCache::shared().clear();
     context.records_affected = 1;
     return {true, "User '" + username + "' dropped successfully"};
   } else {
@@ -1015,7 +2433,8 @@ DCLExecutionStrategy::executeRevoke(sql_parser::RevokeStatement *stmt,
     return {false, "User manager not available"};
   }
 
-  // REVOKE的简化实现
+  // REVOKE的简化实现；缓存结果按用户保存，回收权限后不能再返回
+  QueryResultCache::shared().clear();
   context.records_affected = 1;
   return {true, "Privileges revoked successfully"};
 }
@@ -1031,6 +2450,9 @@ UtilityExecutionStrategy::execute(std::unique_ptr<sql_parser::Statement> stmt,
   } else if (auto show_stmt =
                  dynamic_cast<sql_parser::ShowStatement *>(stmt.get())) {
     return executeShow(show_stmt, context);
+  } else if (auto analyze_stmt =
+                 dynamic_cast<sql_parser::AnalyzeStatement *>(stmt.get())) {
+    return executeAnalyze(analyze_stmt, context);
   }
 
   return {false, "Unsupported utility statement type"};
@@ -1083,6 +2505,32 @@ UtilityExecutionStrategy::executeShow(sql_parser::ShowStatement *stmt,
   }
 }
 
+ExecutionResult
+UtilityExecutionStrategy::executeAnalyze(sql_parser::AnalyzeStatement *stmt,
+                                         ExecutionContext &context) {
+  auto db_manager = context.db_manager ? context.db_manager : context.db_manager_;
+  if (!db_manager || !db_manager->GetStorageEngine()) {
+    return {false, "Storage engine not available"};
+  }
+
+  std::vector<std::string> tables;
+  if (stmt->hasTableName()) {
+    tables.push_back(stmt->getTableName());
+  } else {
+    tables = db_manager->ListTables();
+  }
+
+  try {
+    for (const auto &table_name : tables) {
+      analyzeTable(context, table_name);
+    }
+  } catch (const std::exception &e) {
+    return {false, std::string("ANALYZE failed: ") + e.what()};
+  }
+
+  return {true, std::to_string(tables.size()) + " table(s) analyzed"};
+}
+
 std::string UtilityExecutionStrategy::formatDatabases(
     const std::vector<std::string> &databases) {
 
@@ -1162,6 +2610,10 @@ void UnifiedExecutor::initializeStrategies() {
       std::make_unique<DDLExecutionStrategy>();
   strategies_[sql_parser::Statement::ALTER] =
       std::make_unique<DDLExecutionStrategy>();
+  strategies_[sql_parser::Statement::CREATE_INDEX] =
+      std::make_unique<DDLExecutionStrategy>();
+  strategies_[sql_parser::Statement::DROP_INDEX] =
+      std::make_unique<DDLExecutionStrategy>();
   strategies_[sql_parser::Statement::INSERT] =
       std::make_unique<DMLExecutionStrategy>();
   strategies_[sql_parser::Statement::UPDATE] =
@@ -1170,6 +2622,8 @@ void UnifiedExecutor::initializeStrategies() {
       std::make_unique<DMLExecutionStrategy>();
   strategies_[sql_parser::Statement::SELECT] =
       std::make_unique<DMLExecutionStrategy>();
+  strategies_[sql_parser::Statement::EXPLAIN] =
+      std::make_unique<DMLExecutionStrategy>();
   strategies_[sql_parser::Statement::CREATE_USER] =
       std::make_unique<DCLExecutionStrategy>();
   strategies_[sql_parser::Statement::DROP_USER] =
@@ -1182,14 +2636,16 @@ void UnifiedExecutor::initializeStrategies() {
       std::make_unique<UtilityExecutionStrategy>();
   strategies_[sql_parser::Statement::SHOW] =
       std::make_unique<UtilityExecutionStrategy>();
+  strategies_[sql_parser::Statement::ANALYZE] =
+      std::make_unique<UtilityExecutionStrategy>();
 }
 
 void UnifiedExecutor::initializeOptimizer() {
   // 初始化执行计划生成器
   plan_generator_ = std::make_unique<ExecutionPlanGenerator>();
 
-  // 初始化查询优化器（使用基于规则的优化器）
-  query_optimizer_ = std::make_unique<RuleBasedOptimizer>();
+  // 初始化查询优化器（基于代价，表没有统计信息时按规则优化）
+  query_optimizer_ = std::make_unique<CostBasedOptimizer>();
 }
 
 ExecutionResult
@@ -1276,6 +2732,32 @@ UnifiedExecutor::execute(std::unique_ptr<sql_parser::Statement> stmt) {
   return result;
 }
 
+ExecutionResult
+UnifiedExecutor::execute(std::unique_ptr<sql_parser::Statement> stmt,
+                         std::shared_ptr<ExecutionContext> context) {
+  if (!context) {
+    return execute(std::move(stmt));
+  }
+
+  // 使用调用方的会话信息执行，并把执行统计写回调用方上下文
+  if (!context->current_user.empty()) {
+    last_context_.current_user = context->current_user;
+  }
+  if (!context->current_database.empty()) {
+    last_context_.current_database = context->current_database;
+  }
+  last_context_.set_parallel_degree(context->get_parallel_degree());
+
+  ExecutionResult result = execute(std::move(stmt));
+
+  context->records_affected = last_context_.records_affected;
+  context->rows_returned_ = last_context_.rows_returned_;
+  context->used_index = last_context_.used_index;
+  context->execution_plan = last_context_.execution_plan;
+  context->execution_time_ms_ = last_context_.execution_time_ms_;
+  return result;
+}
+
 ExecutionStrategy *
 UnifiedExecutor::getStrategy(sql_parser::Statement::Type type) {
   auto it = strategies_.find(type);
@@ -1371,6 +2853,7 @@ bool UnifiedExecutor::validateGlobalContext(const sql_parser::Statement *stmt,
   case sql_parser::Statement::UPDATE:
   case sql_parser::Statement::DELETE:
   case sql_parser::Statement::SELECT:
+  case sql_parser::Statement::EXPLAIN:
     // 这些语句需要有效的数据库上下文
     if (context.current_database.empty()) {
       return false;
@@ -1392,9 +2875,10 @@ bool UnifiedExecutor::validateGlobalContext(const sql_parser::Statement *stmt,
     // SHOW语句可能需要数据库上下文，取决于具体操作
     break;
 
-  // 索引相关语句
+  // 索引相关语句和ANALYZE
   case sql_parser::Statement::CREATE_INDEX:
   case sql_parser::Statement::DROP_INDEX:
+  case sql_parser::Statement::ANALYZE:
     // 这些语句需要有效的数据库上下文
     if (context.current_database.empty()) {
       return false;
@@ -1446,8 +2930,25 @@ AdvancedExecutor::executeSubquery(sql_parser::SelectStatement *stmt) {
 ExecutionResult
 AdvancedExecutor::executeWindowFunction(sql_parser::SelectStatement *stmt) {
 
-  // 窗口函数的特殊处理
-  return {false, "Window functions not yet implemented"};
+  // 窗口函数由SELECT的算子树中的WindowOperator计算
+  if (!stmt) {
+    return {false, "Window function query is null"};
+  }
+  bool has_window = false;
+  try {
+    for (const auto &column : stmt->getSelectColumns()) {
+      WindowSpec spec;
+      has_window = has_window ||
+                   ExecutionPlanGenerator::parseWindowFunction(column, spec);
+    }
+  } catch (const std::exception &e) {
+    return {false, e.what()};
+  }
+  if (!has_window) {
+    return {false, "No window function in select list"};
+  }
+  return executeComplexQuery(
+      std::make_unique<sql_parser::SelectStatement>(*stmt));
 }
 
 ExecutionResult AdvancedExecutor::optimizeAndExecute(
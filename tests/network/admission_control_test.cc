@@ -0,0 +1,351 @@
+/**
+ * @file admission_control_test.cc
+ * @brief 服务器准入控制与背压测试
+ *
+ * 测试查询名额的准入/排队/拒绝、最大连接数限制、慢速读取客户端
+ * 触发的读取暂停与输出缓冲上限，以及过载时的排队与拒绝响应
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "network/admission_control.h"
+#include "network/network.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace sqlcc::network;
+
+TEST(AdmissionControllerTest, AdmitQueueReject) {
+    AdmissionController admission(2, 1);
+    auto* a = reinterpret_cast<ConnectionHandler*>(0x10);
+    auto* b = reinterpret_cast<ConnectionHandler*>(0x20);
+    auto* c = reinterpret_cast<ConnectionHandler*>(0x30);
+    auto* d = reinterpret_cast<ConnectionHandler*>(0x40);
+
+    EXPECT_EQ(admission.TryAdmit(a), AdmissionResult::ADMITTED);
+    EXPECT_EQ(admission.TryAdmit(b), AdmissionResult::ADMITTED);
+    EXPECT_EQ(admission.TryAdmit(c), AdmissionResult::QUEUED);
+    EXPECT_EQ(admission.TryAdmit(d), AdmissionResult::REJECTED);
+    EXPECT_EQ(admission.NextRunnable(), nullptr);
+
+    // 归还名额后等待者按到达顺序获得名额
+    admission.Release();
+    EXPECT_EQ(admission.NextRunnable(), c);
+    EXPECT_EQ(admission.NextRunnable(), nullptr);
+
+    AdmissionStats stats = admission.GetStats();
+    EXPECT_EQ(stats.inflight, 2u);
+    EXPECT_EQ(stats.queued, 0u);
+    EXPECT_EQ(stats.queries_admitted, 2u);
+    EXPECT_EQ(stats.queries_queued, 1u);
+    EXPECT_EQ(stats.queries_rejected, 1u);
+    EXPECT_EQ(stats.peak_inflight, 2u);
+}
+
+TEST(AdmissionControllerTest, CancelAndFifoFairness) {
+    AdmissionController admission(1, 4);
+    auto* a = reinterpret_cast<ConnectionHandler*>(0x10);
+    auto* b = reinterpret_cast<ConnectionHandler*>(0x20);
+    auto* c = reinterpret_cast<ConnectionHandler*>(0x30);
+
+    EXPECT_EQ(admission.TryAdmit(a), AdmissionResult::ADMITTED);
+    EXPECT_EQ(admission.TryAdmit(b), AdmissionResult::QUEUED);
+    EXPECT_EQ(admission.TryAdmit(c), AdmissionResult::QUEUED);
+
+    // 已关闭的连接退出队列
+    admission.Cancel(b);
+    EXPECT_EQ(admission.GetStats().queued, 1u);
+
+    // 有等待者时，即使名额刚释放，新到的查询也要排在后面
+    admission.Release();
+    EXPECT_EQ(admission.TryAdmit(a), AdmissionResult::QUEUED);
+    EXPECT_EQ(admission.NextRunnable(), c);
+    admission.Release();
+    EXPECT_EQ(admission.NextRunnable(), a);
+}
+
+#ifdef __linux__
+
+namespace {
+
+constexpr uint32_t kMagic = 0x53514C43;
+
+class AdmissionTestServer {
+public:
+    AdmissionTestServer(int port, int max_connections, std::function<void(ServerNetworkManager&)> configure)
+        : server_(port, max_connections) {
+        if (configure) {
+            configure(server_);
+        }
+    }
+
+    bool Start() {
+        if (!server_.Start()) {
+            return false;
+        }
+        thread_ = std::thread([this]() {
+            while (running_.load()) {
+                server_.ProcessEvents();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        return true;
+    }
+
+    ~AdmissionTestServer() {
+        running_.store(false);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        server_.Stop();
+    }
+
+    AdmissionStats Stats() const { return server_.GetAdmissionStats(); }
+
+    // 轮询直到条件成立或超时
+    bool WaitFor(const std::function<bool(const AdmissionStats&)>& predicate) const {
+        for (int i = 0; i < 500; ++i) {
+            if (predicate(Stats())) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+private:
+    ServerNetworkManager server_;
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+std::vector<char> MakeFrame(uint16_t type, uint16_t flags, uint32_t sequence_id, const std::string& body) {
+    MessageHeader header;
+    header.magic = kMagic;
+    header.length = static_cast<uint32_t>(body.size());
+    header.type = type;
+    header.flags = flags;
+    header.sequence_id = sequence_id;
+    std::vector<char> frame(sizeof(MessageHeader) + body.size());
+    std::memcpy(frame.data(), &header, sizeof(MessageHeader));
+    std::memcpy(frame.data() + sizeof(MessageHeader), body.data(), body.size());
+    return frame;
+}
+
+// 接收窗口很小、按需读取的原始套接字客户端，模拟慢速读取
+class SlowClient {
+public:
+    bool Connect(int port) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        int rcvbuf = 4096;
+        setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        if (connect(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+            return false;
+        }
+        struct timeval tv{5, 0};
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        return Send(MakeFrame(CONNECT, CONNECT_DISABLE_AUTH, 1, "")) && ReadFrame().type == CONN_ACK;
+    }
+
+    ~SlowClient() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool Send(const std::vector<char>& frame) {
+        size_t sent = 0;
+        while (sent < frame.size()) {
+            ssize_t n = send(fd_, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    struct Frame {
+        uint16_t type = 0xFFFF;
+        uint32_t sequence_id = 0;
+        std::string body;
+    };
+
+    Frame ReadFrame() {
+        Frame frame;
+        MessageHeader header;
+        if (!ReadExact(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kMagic) {
+            return frame;
+        }
+        frame.body.resize(header.length);
+        if (header.length > 0 && !ReadExact(&frame.body[0], header.length)) {
+            return frame;
+        }
+        frame.type = header.type;
+        frame.sequence_id = header.sequence_id;
+        return frame;
+    }
+
+private:
+    bool ReadExact(char* buffer, size_t length) {
+        size_t total = 0;
+        while (total < length) {
+            ssize_t n = recv(fd_, buffer + total, length - total, 0);
+            if (n <= 0) {
+                return false;
+            }
+            total += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    int fd_ = -1;
+};
+
+} // namespace
+
+TEST(ServerAdmissionTest, RejectsConnectionsOverLimit) {
+    AdmissionTestServer server(6531, 2, nullptr);
+    ASSERT_TRUE(server.Start());
+
+    ClientNetworkManager first("127.0.0.1", 6531);
+    ClientNetworkManager second("127.0.0.1", 6531);
+    ASSERT_TRUE(first.Connect());
+    ASSERT_TRUE(first.Handshake(CONNECT_DISABLE_AUTH));
+    ASSERT_TRUE(second.Connect());
+    ASSERT_TRUE(second.Handshake(CONNECT_DISABLE_AUTH));
+
+    ClientNetworkManager third("127.0.0.1", 6531);
+    third.SetReceiveTimeout(2000);
+    ASSERT_TRUE(third.Connect());
+    std::vector<char> response = third.ReceiveResponse();
+    ASSERT_GE(response.size(), sizeof(MessageHeader));
+    const MessageHeader* header = reinterpret_cast<const MessageHeader*>(response.data());
+    EXPECT_EQ(header->type, ERROR);
+    EXPECT_EQ(header->flags, ERROR_OVERLOADED);
+    EXPECT_EQ(server.Stats().connections_rejected, 1u);
+
+    // 已接入的连接不受影响
+    EXPECT_TRUE(first.ExecuteQuery("SELECT 1").success);
+}
+
+TEST(ServerAdmissionTest, SlowReaderPausesReadingAndBoundsOutput) {
+    const size_t kHigh = 64 * 1024;
+    AdmissionTestServer server(6532, 100, [&](ServerNetworkManager& s) {
+        s.SetOutputBufferLimits(kHigh, 16 * 1024);
+    });
+    ASSERT_TRUE(server.Start());
+
+    SlowClient client;
+    ASSERT_TRUE(client.Connect(6532));
+
+    // 客户端连续发送大量查询但暂不读取结果
+    const int kQueries = 2000;
+    const std::string padding(4000, 'p');
+    std::atomic<bool> send_ok{true};
+    std::thread sender([&]() {
+        for (int i = 0; i < kQueries; ++i) {
+            if (!client.Send(MakeFrame(QUERY, 0, 100 + i, "SELECT '" + padding + "'"))) {
+                send_ok.store(false);
+                return;
+            }
+        }
+    });
+
+    ASSERT_TRUE(server.WaitFor([](const AdmissionStats& s) { return s.read_pauses > 0; }));
+    // 暂停读取后输出缓冲不再增长：至多超出高水位一条结果
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_LT(server.Stats().peak_output_bytes, kHigh + 8 * 1024);
+
+    // 客户端开始读取后所有查询按顺序完成
+    for (int i = 0; i < kQueries; ++i) {
+        SlowClient::Frame frame = client.ReadFrame();
+        ASSERT_EQ(frame.type, QUERY_RESULT) << "query " << i;
+        ASSERT_EQ(frame.sequence_id, static_cast<uint32_t>(100 + i));
+    }
+    sender.join();
+    EXPECT_TRUE(send_ok.load());
+    EXPECT_LT(server.Stats().peak_output_bytes, kHigh + 8 * 1024);
+}
+
+TEST(ServerAdmissionTest, OverloadQueuesThenRejects) {
+    AdmissionTestServer server(6533, 100, [](ServerNetworkManager& s) {
+        s.SetAdmissionLimits(1, 1);
+        s.SetOutputBufferLimits(128 * 1024, 32 * 1024);
+    });
+    ASSERT_TRUE(server.Start());
+
+    // 慢速客户端的结果积压在输出缓冲中，持续占用唯一的名额
+    SlowClient slow;
+    ASSERT_TRUE(slow.Connect(6533));
+    const int kQueries = 1000;
+    const std::string padding(4000, 'p');
+    std::thread sender([&]() {
+        for (int i = 0; i < kQueries; ++i) {
+            if (!slow.Send(MakeFrame(QUERY, 0, 100 + i, "SELECT '" + padding + "'"))) {
+                return;
+            }
+        }
+    });
+    ASSERT_TRUE(server.WaitFor([](const AdmissionStats& s) { return s.read_pauses > 0; }));
+    EXPECT_EQ(server.Stats().inflight, 1u);
+
+    // 第二个客户端的查询进入等待队列
+    ClientNetworkManager queued("127.0.0.1", 6533);
+    queued.SetReceiveTimeout(5000);
+    ASSERT_TRUE(queued.Connect());
+    ASSERT_TRUE(queued.Handshake(CONNECT_DISABLE_AUTH));
+    ASSERT_TRUE(queued.SendRequest(MakeFrame(QUERY, 0, 42, "SELECT 'queued'")));
+    ASSERT_TRUE(server.WaitFor([](const AdmissionStats& s) { return s.queued == 1; }));
+
+    // 队列已满，第三个客户端立即收到过载错误
+    ClientNetworkManager rejected("127.0.0.1", 6533);
+    rejected.SetReceiveTimeout(5000);
+    ASSERT_TRUE(rejected.Connect());
+    ASSERT_TRUE(rejected.Handshake(CONNECT_DISABLE_AUTH));
+    QueryResponse overload = rejected.ExecuteQuery("SELECT 'rejected'");
+    EXPECT_FALSE(overload.success);
+    EXPECT_EQ(overload.type, ERROR);
+    EXPECT_EQ(overload.payload, "Server overloaded, retry later");
+    EXPECT_EQ(server.Stats().queries_rejected, 1u);
+
+    // 慢速客户端读完结果后名额释放，排队的查询得到执行；
+    // 名额释放到排队查询被调度之间，慢速客户端的后续查询也可能因队列已满被拒绝
+    for (int i = 0; i < kQueries; ++i) {
+        SlowClient::Frame frame = slow.ReadFrame();
+        ASSERT_TRUE(frame.type == QUERY_RESULT ||
+                    (frame.type == ERROR && frame.body == "Server overloaded, retry later"))
+            << "query " << i << ": " << frame.body;
+        ASSERT_EQ(frame.sequence_id, static_cast<uint32_t>(100 + i));
+    }
+    sender.join();
+    std::vector<char> response = queued.ReceiveResponse();
+    ASSERT_GE(response.size(), sizeof(MessageHeader));
+    const MessageHeader* header = reinterpret_cast<const MessageHeader*>(response.data());
+    EXPECT_EQ(header->type, QUERY_RESULT);
+    EXPECT_EQ(header->sequence_id, 42u);
+    EXPECT_EQ(std::string(response.data() + sizeof(MessageHeader), header->length), "ECHO: SELECT 'queued'");
+}
+
+#endif // __linux__
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -10,6 +10,9 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <chrono>
 #include "network/encryption.h"
 #include "network/network.h"
 
@@ -486,6 +489,160 @@ TEST(PBKDF2Test, VariableOutputLength) {
 #endif
 }
 
+/**
+ * @test GcmSealOpenRoundTrip
+ * @brief 测试AES-256-GCM加密解密往返，且每条消息的nonce不同
+ */
+TEST_F(AESEncryptorTest, GcmSealOpenRoundTrip) {
+#ifdef __linux__
+    AESEncryptor aes(encryption_key_, AESMode::GCM);
+    EXPECT_TRUE(aes.IsAuthenticated());
+    std::string plaintext = "GCM authenticated payload";
+    std::vector<uint8_t> data(plaintext.begin(), plaintext.end());
+
+    auto c1 = aes.Encrypt(data);
+    auto c2 = aes.Encrypt(data);
+    EXPECT_EQ(c1.size(), data.size() + AESEncryptor::kGcmOverhead);
+    // nonce每条消息递增，相同明文得到不同密文
+    EXPECT_NE(c1, c2);
+    EXPECT_EQ(aes.Decrypt(c1), data);
+    EXPECT_EQ(aes.Decrypt(c2), data);
+#else
+    GTEST_SKIP() << "AES not available on this platform";
+#endif
+}
+
+/**
+ * @test GcmInPlace
+ * @brief 测试调用方缓冲区上的原地加密与原地解密
+ */
+TEST_F(AESEncryptorTest, GcmInPlace) {
+#ifdef __linux__
+    AESEncryptor aes(encryption_key_, AESMode::GCM);
+    std::string plaintext(1000, 'q');
+    std::vector<uint8_t> buffer(plaintext.size() + AESEncryptor::kGcmOverhead);
+    uint8_t* body = buffer.data() + AESEncryptor::kGcmNonceSize;
+    std::memcpy(body, plaintext.data(), plaintext.size());
+
+    size_t sealed_len = aes.Seal(body, plaintext.size(), buffer.data());
+    ASSERT_EQ(sealed_len, buffer.size());
+    EXPECT_NE(std::string(reinterpret_cast<char*>(body), plaintext.size()), plaintext);
+
+    size_t plaintext_len = 0;
+    ASSERT_TRUE(aes.Open(buffer.data(), sealed_len, body, &plaintext_len));
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(body), plaintext_len), plaintext);
+#else
+    GTEST_SKIP() << "AES not available on this platform";
+#endif
+}
+
+/**
+ * @test GcmTamperDetected
+ * @brief 测试GCM标签能检测密文篡改，无需额外HMAC
+ */
+TEST_F(AESEncryptorTest, GcmTamperDetected) {
+#ifdef __linux__
+    AESEncryptor aes(encryption_key_, AESMode::GCM);
+    std::vector<uint8_t> data(64, 0x5a);
+    auto sealed = aes.Encrypt(data);
+    sealed[AESEncryptor::kGcmNonceSize + 3] ^= 0x01;
+    EXPECT_THROW(aes.Decrypt(sealed), std::runtime_error);
+
+    std::vector<uint8_t> out(data.size());
+    size_t len = 0;
+    EXPECT_FALSE(aes.Open(sealed.data(), sealed.size(), out.data(), &len));
+    // CBC模式不支持Seal
+    AESEncryptor cbc(encryption_key_);
+    EXPECT_THROW(cbc.Seal(data.data(), data.size(), out.data()), std::runtime_error);
+#else
+    GTEST_SKIP() << "AES not available on this platform";
+#endif
+}
+
+/**
+ * @test CachedContextReusedAcrossMessages
+ * @brief 测试缓存上下文在多次加解密及密钥更新后仍然正确
+ */
+TEST_F(AESEncryptorTest, CachedContextReusedAcrossMessages) {
+#ifdef __linux__
+    AESEncryptor aes(encryption_key_);
+    std::vector<uint8_t> data(100, 0x11);
+    auto first = aes.Encrypt(data);
+    for (int i = 0; i < 10; ++i) {
+        // CBC使用固定IV，缓存上下文重置后结果应完全一致
+        EXPECT_EQ(aes.Encrypt(data), first);
+    }
+    // 解密失败后上下文仍可继续使用
+    std::vector<uint8_t> garbage(32, 0x7f);
+    EXPECT_THROW(aes.Decrypt(garbage), std::runtime_error);
+    EXPECT_EQ(aes.Decrypt(first), data);
+
+    aes.UpdateKey(EncryptionKey::GenerateRandom(32, 16));
+    EXPECT_NE(aes.Encrypt(data), first);
+    EXPECT_EQ(aes.Decrypt(aes.Encrypt(data)), data);
+#else
+    GTEST_SKIP() << "AES not available on this platform";
+#endif
+}
+
+/**
+ * @test AESThroughputBenchmark
+ * @brief 单核加密吞吐量（MB/s）：旧的CBC+HMAC路径与GCM原地加密对比
+ */
+TEST(AESThroughputBenchmark, MBPerSecondPerCore) {
+#ifdef __linux__
+    auto key = EncryptionKey::GenerateRandom(32, 16);
+    AESEncryptor cbc(key, AESMode::CBC);
+    AESEncryptor gcm(key, AESMode::GCM);
+    const size_t total_bytes = 64 * 1024 * 1024;
+
+    auto report = [](const std::string& name, size_t frame_size, size_t bytes,
+                     std::chrono::steady_clock::duration elapsed) {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        double mbps = seconds > 0 ? (bytes / (1024.0 * 1024.0)) / seconds : 0.0;
+        std::cout << "[BENCH] " << std::left << std::setw(24) << name
+                  << " frame=" << std::setw(8) << frame_size
+                  << std::fixed << std::setprecision(1) << mbps << " MB/s/core" << std::endl;
+    };
+
+    for (size_t frame_size : {size_t(4096), size_t(64 * 1024), size_t(1024 * 1024)}) {
+        size_t iterations = total_bytes / frame_size;
+        std::vector<uint8_t> frame(frame_size, 0xab);
+
+        // 旧路径：向量拷贝 + CBC加密 + 单独的HMAC-SHA256
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            auto ct = cbc.Encrypt(std::vector<uint8_t>(frame.begin(), frame.end()));
+            auto mac = HMACSHA256::Compute(key->GetKey(), ct);
+            ASSERT_EQ(mac.size(), 32u);
+        }
+        report("AES-256-CBC+HMAC", frame_size, iterations * frame_size,
+               std::chrono::steady_clock::now() - start);
+
+        // 新路径：GCM在调用方缓冲区上原地加密
+        std::vector<uint8_t> buffer(frame_size + AESEncryptor::kGcmOverhead);
+        uint8_t* body = buffer.data() + AESEncryptor::kGcmNonceSize;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            ASSERT_EQ(gcm.Seal(body, frame_size, buffer.data()), buffer.size());
+        }
+        report("AES-256-GCM in-place", frame_size, iterations * frame_size,
+               std::chrono::steady_clock::now() - start);
+
+        start = std::chrono::steady_clock::now();
+        size_t plaintext_len = 0;
+        for (size_t i = 0; i < iterations; ++i) {
+            size_t sealed_len = gcm.Seal(body, frame_size, buffer.data());
+            ASSERT_TRUE(gcm.Open(buffer.data(), sealed_len, body, &plaintext_len));
+        }
+        report("AES-256-GCM seal+open", frame_size, iterations * frame_size,
+               std::chrono::steady_clock::now() - start);
+    }
+#else
+    GTEST_SKIP() << "AES not available on this platform";
+#endif
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
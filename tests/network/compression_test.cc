@@ -0,0 +1,286 @@
+/**
+ * @file compression_test.cc
+ * @brief 网络帧压缩功能测试
+ *
+ * 测试LZ块编解码、消息体压缩封装、CONNECT协商与加密组合，
+ * 并给出文本型结果集上的压缩率与吞吐量基准
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "network/compression.h"
+#include "network/network.h"
+
+using namespace sqlcc::network;
+
+namespace {
+
+// 构造文本型查询结果：宽行、重复的列值模式
+std::string MakeTextResultSet(size_t rows) {
+    std::ostringstream oss;
+    static const char* kCities[] = {"Beijing", "Shanghai", "Guangzhou", "Shenzhen", "Hangzhou"};
+    for (size_t i = 0; i < rows; ++i) {
+        oss << i << "|customer_" << (i * 7919 % 100000) << "|customer" << i
+            << "@example.com|" << kCities[i % 5]
+            << "|Regular customer account created by the nightly import job|ACTIVE\n";
+    }
+    return oss.str();
+}
+
+std::string RoundTrip(const std::string& input) {
+    std::vector<char> compressed(LZCodec::MaxCompressedSize(input.size()));
+    size_t len = LZCodec::Compress(input.data(), input.size(), compressed.data(), compressed.size());
+    EXPECT_GT(len, 0u);
+    std::string output(input.size(), '\0');
+    long decoded = LZCodec::Decompress(compressed.data(), len, &output[0], output.size());
+    EXPECT_EQ(decoded, static_cast<long>(input.size()));
+    return output;
+}
+
+} // namespace
+
+TEST(LZCodecTest, RoundTripEdgeCases) {
+    EXPECT_EQ(RoundTrip(""), "");
+    EXPECT_EQ(RoundTrip("a"), "a");
+    EXPECT_EQ(RoundTrip("short text"), "short text");
+    // 长游程（重叠复制）与长字面量（长度扩展字节）
+    std::string run(100000, 'z');
+    EXPECT_EQ(RoundTrip(run), run);
+    std::string text = MakeTextResultSet(2000);
+    EXPECT_EQ(RoundTrip(text), text);
+}
+
+TEST(LZCodecTest, RandomDataRoundTrip) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(0, 255);
+    std::string random(70000, '\0');
+    for (auto& c : random) {
+        c = static_cast<char>(dis(gen));
+    }
+    EXPECT_EQ(RoundTrip(random), random);
+}
+
+TEST(LZCodecTest, CorruptInputRejected) {
+    std::string text = MakeTextResultSet(100);
+    std::vector<char> compressed(LZCodec::MaxCompressedSize(text.size()));
+    size_t len = LZCodec::Compress(text.data(), text.size(), compressed.data(), compressed.size());
+    std::string output(text.size(), '\0');
+    // 输出缓冲区不足
+    EXPECT_EQ(LZCodec::Decompress(compressed.data(), len, &output[0], text.size() / 2), -1);
+    // 截断的输入
+    EXPECT_NE(LZCodec::Decompress(compressed.data(), len / 2, &output[0], output.size()),
+              static_cast<long>(text.size()));
+}
+
+TEST(FrameCompressorTest, CompressibleAndIncompressible) {
+    std::string text = MakeTextResultSet(500);
+    std::string compressed;
+    ASSERT_TRUE(FrameCompressor::Compress(text.data(), text.size(), &compressed));
+    EXPECT_LT(compressed.size(), text.size());
+    std::string restored;
+    ASSERT_TRUE(FrameCompressor::Decompress(compressed.data(), compressed.size(), &restored));
+    EXPECT_EQ(restored, text);
+
+    // 不可压缩的数据原样发送
+    std::mt19937 gen(7);
+    std::string random(8192, '\0');
+    for (auto& c : random) {
+        c = static_cast<char>(gen());
+    }
+    EXPECT_FALSE(FrameCompressor::Compress(random.data(), random.size(), &compressed));
+
+    // 声明的原始长度超过上限时拒绝解压
+    std::string bomb(8, '\0');
+    uint32_t huge = static_cast<uint32_t>(FrameCompressor::kMaxFrameBodySize + 1);
+    std::memcpy(&bomb[0], &huge, sizeof(huge));
+    EXPECT_FALSE(FrameCompressor::Decompress(bomb.data(), bomb.size(), &restored));
+
+    // 声明的原始长度超过压缩数据能展开的上限时，不分配缓冲区直接拒绝
+    uint32_t inflated = static_cast<uint32_t>(4 * FrameCompressor::kMaxExpansion + 1);
+    std::memcpy(&bomb[0], &inflated, sizeof(inflated));
+    restored.clear();
+    EXPECT_FALSE(FrameCompressor::Decompress(bomb.data(), bomb.size(), &restored));
+    EXPECT_TRUE(restored.empty());
+}
+
+/**
+ * @test NegotiatedCompressionRoundTrip
+ * @brief 端到端：CONNECT协商压缩后，大查询与大结果以压缩帧传输
+ */
+TEST(CompressionEndToEnd, NegotiatedCompressionRoundTrip) {
+#ifdef __linux__
+    int port = 6511;
+    ServerNetworkManager server(port);
+    ASSERT_TRUE(server.Start());
+    std::atomic<bool> running{true};
+    std::thread srv([&]() {
+        while (running.load()) {
+            server.ProcessEvents();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    });
+
+    ClientNetworkManager client("127.0.0.1", port);
+    client.RequestCompression(true);
+    ASSERT_TRUE(client.Connect());
+
+    MessageHeader ch;
+    ch.magic = 0x53514C43;
+    ch.length = 0;
+    ch.type = CONNECT;
+    ch.flags = CONNECT_DISABLE_AUTH;
+    ch.sequence_id = 1;
+    std::vector<char> conn(sizeof(MessageHeader));
+    std::memcpy(conn.data(), &ch, sizeof(MessageHeader));
+    ASSERT_TRUE(client.SendRequest(conn));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto ack = client.ReceiveResponse();
+    ASSERT_GE(ack.size(), sizeof(MessageHeader));
+    EXPECT_TRUE(reinterpret_cast<MessageHeader*>(ack.data())->flags & CONNECT_COMPRESSION);
+    EXPECT_TRUE(client.IsCompressionEnabled());
+
+    // 超过单次接收缓冲区的查询，只有压缩后才能在一帧内送达
+    std::string query = "SELECT * FROM t WHERE note = '" + std::string(20000, 'n') + "'";
+    MessageHeader qh;
+    qh.magic = 0x53514C43;
+    qh.length = static_cast<uint32_t>(query.size());
+    qh.type = QUERY;
+    qh.flags = 0;
+    qh.sequence_id = 3;
+    std::vector<char> msg(sizeof(MessageHeader) + query.size());
+    std::memcpy(msg.data(), &qh, sizeof(MessageHeader));
+    std::memcpy(msg.data() + sizeof(MessageHeader), query.data(), query.size());
+    ASSERT_TRUE(client.SendRequest(msg));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto resp = client.ReceiveResponse();
+    ASSERT_GE(resp.size(), sizeof(MessageHeader));
+    auto* rh = reinterpret_cast<MessageHeader*>(resp.data());
+    EXPECT_EQ(rh->type, QUERY_RESULT);
+    EXPECT_EQ(rh->flags & FRAME_FLAG_COMPRESSED, 0);
+    EXPECT_EQ(std::string(resp.data() + sizeof(MessageHeader), rh->length), "ECHO: " + query);
+
+    client.Disconnect();
+    running.store(false);
+    srv.join();
+    server.Stop();
+#else
+    GTEST_SKIP() << "Network tests require Linux";
+#endif
+}
+
+/**
+ * @test CompressedFrameRequiresNegotiation
+ * @brief 没有协商压缩的连接发送压缩帧时，服务器返回错误而不解压
+ */
+TEST(CompressionEndToEnd, CompressedFrameRequiresNegotiation) {
+#ifdef __linux__
+    int port = 6512;
+    ServerNetworkManager server(port);
+    ASSERT_TRUE(server.Start());
+    std::atomic<bool> running{true};
+    std::thread srv([&]() {
+        while (running.load()) {
+            server.ProcessEvents();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    });
+
+    ClientNetworkManager client("127.0.0.1", port);
+    ASSERT_TRUE(client.Connect());
+
+    MessageHeader ch;
+    ch.magic = 0x53514C43;
+    ch.length = 0;
+    ch.type = CONNECT;
+    ch.flags = CONNECT_DISABLE_AUTH;
+    ch.sequence_id = 1;
+    std::vector<char> conn(sizeof(MessageHeader));
+    std::memcpy(conn.data(), &ch, sizeof(MessageHeader));
+    ASSERT_TRUE(client.SendRequest(conn));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto ack = client.ReceiveResponse();
+    ASSERT_GE(ack.size(), sizeof(MessageHeader));
+    EXPECT_FALSE(client.IsCompressionEnabled());
+
+    std::string query = "SELECT * FROM t WHERE note = '" + std::string(8000, 'n') + "'";
+    std::string compressed;
+    ASSERT_TRUE(FrameCompressor::Compress(query.data(), query.size(), &compressed));
+    MessageHeader qh;
+    qh.magic = 0x53514C43;
+    qh.length = static_cast<uint32_t>(compressed.size());
+    qh.type = QUERY;
+    qh.flags = FRAME_FLAG_COMPRESSED;
+    qh.sequence_id = 2;
+    std::vector<char> msg(sizeof(MessageHeader) + compressed.size());
+    std::memcpy(msg.data(), &qh, sizeof(MessageHeader));
+    std::memcpy(msg.data() + sizeof(MessageHeader), compressed.data(), compressed.size());
+    ASSERT_TRUE(client.SendRequest(msg));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto resp = client.ReceiveResponse();
+    ASSERT_GE(resp.size(), sizeof(MessageHeader));
+    auto* rh = reinterpret_cast<MessageHeader*>(resp.data());
+    EXPECT_EQ(rh->type, ERROR);
+    EXPECT_EQ(std::string(resp.data() + sizeof(MessageHeader), rh->length),
+              "Compression not negotiated");
+
+    client.Disconnect();
+    running.store(false);
+    srv.join();
+    server.Stop();
+#else
+    GTEST_SKIP() << "Network tests require Linux";
+#endif
+}
+
+/**
+ * @test CompressionBenchmark
+ * @brief 文本型结果集上的压缩率与单核吞吐量
+ */
+TEST(CompressionBenchmark, RatioAndThroughput) {
+    for (size_t rows : {size_t(100), size_t(10000), size_t(100000)}) {
+        std::string text = MakeTextResultSet(rows);
+        std::string compressed;
+        std::string restored;
+        const size_t target_bytes = 64 * 1024 * 1024;
+        size_t iterations = std::max<size_t>(1, target_bytes / text.size());
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            ASSERT_TRUE(FrameCompressor::Compress(text.data(), text.size(), &compressed));
+        }
+        double compress_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            ASSERT_TRUE(FrameCompressor::Decompress(compressed.data(), compressed.size(), &restored));
+        }
+        double decompress_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ASSERT_EQ(restored, text);
+
+        double mb = static_cast<double>(text.size() * iterations) / (1024.0 * 1024.0);
+        std::cout << "[BENCH] rows=" << std::left << std::setw(7) << rows
+                  << " raw=" << std::setw(9) << text.size()
+                  << " compressed=" << std::setw(9) << compressed.size()
+                  << std::fixed << std::setprecision(2)
+                  << " ratio=" << static_cast<double>(text.size()) / compressed.size()
+                  << std::setprecision(1)
+                  << " compress=" << mb / compress_s << " MB/s"
+                  << " decompress=" << mb / decompress_s << " MB/s" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,240 @@
+/**
+ * @file connection_pool_test.cc
+ * @brief 客户端连接池与异步查询接口测试
+ *
+ * 测试已认证会话的复用、借出上限与超时、空闲回收、损坏连接的丢弃、
+ * future异步查询，并对比每次查询新建连接与复用连接的延迟
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "network/connection_pool.h"
+#include "network/network.h"
+
+using namespace sqlcc::network;
+
+namespace {
+
+// 在后台线程中驱动服务器事件循环
+class PoolTestServer {
+public:
+    explicit PoolTestServer(int port) : server_(port) {}
+
+    bool Start() {
+        if (!server_.Start()) {
+            return false;
+        }
+        thread_ = std::thread([this]() {
+            while (running_.load()) {
+                server_.ProcessEvents();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        return true;
+    }
+
+    ~PoolTestServer() {
+        running_.store(false);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        server_.Stop();
+    }
+
+private:
+    ServerNetworkManager server_;
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+ConnectionPoolOptions MakeOptions(int port) {
+    ConnectionPoolOptions options;
+    options.host = "127.0.0.1";
+    options.port = port;
+    options.username = "admin";
+    options.password = "password";
+    options.max_connections = 2;
+    options.query_timeout = std::chrono::milliseconds(2000);
+    return options;
+}
+
+} // namespace
+
+#ifdef __linux__
+
+TEST(ConnectionPoolTest, ReusesAuthenticatedSession) {
+    PoolTestServer server(6521);
+    ASSERT_TRUE(server.Start());
+    ClientConnectionPool pool(MakeOptions(6521));
+
+    for (int i = 0; i < 20; ++i) {
+        std::string sql = "SELECT " + std::to_string(i);
+        QueryResponse response = pool.Execute(sql);
+        ASSERT_TRUE(response.success) << response.payload;
+        EXPECT_EQ(response.payload, "ECHO: " + sql);
+    }
+
+    // 顺序执行只需要一条连接，握手与认证只做一次
+    ConnectionPoolStats stats = pool.GetStats();
+    EXPECT_EQ(stats.created, 1u);
+    EXPECT_EQ(stats.reused, 19u);
+    EXPECT_EQ(stats.idle, 1u);
+    EXPECT_EQ(stats.in_use, 0u);
+}
+
+TEST(ConnectionPoolTest, RejectsBadCredentials) {
+    PoolTestServer server(6522);
+    ASSERT_TRUE(server.Start());
+    ConnectionPoolOptions options = MakeOptions(6522);
+    options.password = "wrong";
+    ClientConnectionPool pool(options);
+
+    PooledConnection connection = pool.Acquire();
+    EXPECT_FALSE(connection);
+    QueryResponse response = pool.Execute("SELECT 1");
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(pool.GetStats().created, 0u);
+}
+
+TEST(ConnectionPoolTest, AcquireTimesOutWhenExhausted) {
+    PoolTestServer server(6523);
+    ASSERT_TRUE(server.Start());
+    ConnectionPoolOptions options = MakeOptions(6523);
+    options.acquire_timeout = std::chrono::milliseconds(100);
+    ClientConnectionPool pool(options);
+
+    PooledConnection first = pool.Acquire();
+    PooledConnection second = pool.Acquire();
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_FALSE(pool.Acquire());
+    EXPECT_EQ(pool.GetStats().acquire_timeouts, 1u);
+
+    // 归还后可以立即借出
+    first.Release();
+    PooledConnection third = pool.Acquire();
+    EXPECT_TRUE(third);
+    EXPECT_EQ(pool.GetStats().created, 2u);
+}
+
+TEST(ConnectionPoolTest, BrokenConnectionIsDiscarded) {
+    PoolTestServer server(6524);
+    ASSERT_TRUE(server.Start());
+    ClientConnectionPool pool(MakeOptions(6524));
+
+    {
+        PooledConnection connection = pool.Acquire();
+        ASSERT_TRUE(connection);
+        connection.MarkBroken();
+    }
+    ConnectionPoolStats stats = pool.GetStats();
+    EXPECT_EQ(stats.discarded_broken, 1u);
+    EXPECT_EQ(stats.idle, 0u);
+
+    EXPECT_TRUE(pool.Execute("SELECT 1").success);
+    EXPECT_EQ(pool.GetStats().created, 2u);
+}
+
+TEST(ConnectionPoolTest, IdleConnectionsEvicted) {
+    PoolTestServer server(6525);
+    ASSERT_TRUE(server.Start());
+    ConnectionPoolOptions options = MakeOptions(6525);
+    options.idle_timeout = std::chrono::milliseconds(50);
+    ClientConnectionPool pool(options);
+
+    ASSERT_TRUE(pool.Execute("SELECT 1").success);
+    EXPECT_EQ(pool.GetStats().idle, 1u);
+
+    // 维护线程周期为idle_timeout/2
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    ConnectionPoolStats stats = pool.GetStats();
+    EXPECT_EQ(stats.idle, 0u);
+    EXPECT_EQ(stats.evicted_idle, 1u);
+}
+
+TEST(ConnectionPoolTest, AsyncQueriesShareFewSockets) {
+    PoolTestServer server(6526);
+    ASSERT_TRUE(server.Start());
+    ConnectionPoolOptions options = MakeOptions(6526);
+    options.max_connections = 4;
+    ClientConnectionPool pool(options);
+
+    // 多个应用线程同时提交查询
+    std::vector<std::future<QueryResponse>> futures;
+    std::mutex futures_mutex;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&, t]() {
+            for (int i = 0; i < 25; ++i) {
+                auto future = pool.ExecuteAsync("SELECT " + std::to_string(t * 100 + i));
+                std::lock_guard<std::mutex> lock(futures_mutex);
+                futures.push_back(std::move(future));
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    ASSERT_EQ(futures.size(), 100u);
+    for (auto& future : futures) {
+        QueryResponse response = future.get();
+        EXPECT_TRUE(response.success) << response.payload;
+        EXPECT_EQ(response.payload.rfind("ECHO: SELECT ", 0), 0u);
+    }
+    ConnectionPoolStats stats = pool.GetStats();
+    EXPECT_LE(stats.created, 4u);
+    EXPECT_EQ(stats.created + stats.reused, 100u);
+
+    // 关闭后提交的查询立即以失败完成
+    pool.Shutdown();
+    QueryResponse rejected = pool.ExecuteAsync("SELECT 1").get();
+    EXPECT_FALSE(rejected.success);
+}
+
+/**
+ * @test ConnectionPoolBenchmark
+ * @brief 每次查询新建连接（TCP+CONNECT+AUTH）与连接池复用的延迟对比
+ */
+TEST(ConnectionPoolBenchmark, PerQueryConnectVsPooled) {
+    PoolTestServer server(6527);
+    ASSERT_TRUE(server.Start());
+    const int kQueries = 200;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kQueries; ++i) {
+        ClientNetworkManager client("127.0.0.1", 6527);
+        client.SetReceiveTimeout(2000);
+        ASSERT_TRUE(client.ConnectAndAuthenticate("admin", "password"));
+        ASSERT_TRUE(client.ExecuteQuery("SELECT 1").success);
+        client.Disconnect();
+    }
+    double connect_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / kQueries;
+
+    ClientConnectionPool pool(MakeOptions(6527));
+    ASSERT_TRUE(pool.Execute("SELECT 1").success); // 预热
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kQueries; ++i) {
+        ASSERT_TRUE(pool.Execute("SELECT 1").success);
+    }
+    double pooled_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / kQueries;
+
+    std::cout << "[BENCH] per-query connect: " << connect_us << " us/query, pooled: "
+              << pooled_us << " us/query" << std::endl;
+    EXPECT_LT(pooled_us, connect_us);
+}
+
+#endif // __linux__
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
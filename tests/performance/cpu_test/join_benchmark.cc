@@ -0,0 +1,100 @@
+/**
+ * @file join_benchmark.cc
+ * @brief 连接算法微基准：比较哈希连接、嵌套循环连接与排序归并连接的耗时
+ *
+ * 用法: join_benchmark [最大行数] [重复次数]
+ * 两侧输入按连接键有序生成，行数从1000按10倍递增到最大行数；
+ * 嵌套循环连接为O(n*m)，只在行数不超过kNestedLoopMaxRows时运行。
+ * 最后对同样的有序输入运行排序归并连接（两侧都无需再次排序）。
+ */
+
+#include "execution/join_executor.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace sqlcc;
+
+namespace {
+
+constexpr size_t kNestedLoopMaxRows = 1000;
+
+// 生成按键有序的两列输入：key, payload
+ExecutionResult CreateKeyedInput(const std::string &key_name, size_t count) {
+  ExecutionResult result;
+  result.column_metadata.push_back({key_name, "INT", false, false, false, ""});
+  result.column_metadata.push_back(
+      {key_name + "_payload", "INT", false, false, false, ""});
+  result.rows.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    Row row;
+    row.values.push_back(Value(static_cast<int64_t>(i)));
+    row.values.push_back(Value(static_cast<int64_t>(count - i)));
+    result.rows.push_back(std::move(row));
+  }
+  result.success = true;
+  return result;
+}
+
+// 重复执行连接，返回单次平均耗时（毫秒）；algorithm带回实际使用的算法
+double MeasureJoin(const ExecutionResult &left, const ExecutionResult &right,
+                   JoinAlgorithm requested, size_t repeat,
+                   std::string &algorithm, size_t &result_rows) {
+  JoinExecutor executor(nullptr);
+  executor.set_algorithm(requested);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    ExecutionResult result =
+        executor.execute(left, right, JoinType::INNER_JOIN, "l = r");
+    result_rows = result.rows.size();
+  }
+  double ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  algorithm = executor.get_stats().algorithm;
+  return ms / repeat;
+}
+
+void PrintRow(size_t rows, const std::string &algorithm, double ms,
+              double baseline, size_t result_rows) {
+  std::printf("%8zu x %-8zu %-12s %12.2f ms  x%9.2f  rows=%zu\n", rows, rows,
+              algorithm.c_str(), ms, ms / baseline, result_rows);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t max_rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+  size_t repeat = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 3;
+  repeat = std::max<size_t>(repeat, 1);
+
+  std::printf("INNER JOIN l = r, 最大行数=%zu, 重复=%zu\n", max_rows, repeat);
+  std::printf("（耗时倍数以哈希连接为基准，嵌套循环仅在行数<=%zu时运行）\n",
+              kNestedLoopMaxRows);
+
+  for (size_t rows = 1000; rows <= max_rows; rows *= 10) {
+    ExecutionResult left = CreateKeyedInput("l", rows);
+    ExecutionResult right = CreateKeyedInput("r", rows);
+
+    std::string algorithm;
+    size_t result_rows = 0;
+    double hash_ms = MeasureJoin(left, right, JoinAlgorithm::HASH, repeat,
+                                 algorithm, result_rows);
+    PrintRow(rows, algorithm, hash_ms, hash_ms, result_rows);
+
+    if (rows <= kNestedLoopMaxRows) {
+      double ms = MeasureJoin(left, right, JoinAlgorithm::NESTED_LOOP, repeat,
+                              algorithm, result_rows);
+      PrintRow(rows, algorithm, ms, hash_ms, result_rows);
+    }
+
+    // 输入已按键有序，归并前两侧都不需要再排序
+    double ms = MeasureJoin(left, right, JoinAlgorithm::SORT_MERGE, repeat,
+                            algorithm, result_rows);
+    PrintRow(rows, algorithm, ms, hash_ms, result_rows);
+  }
+  return 0;
+}
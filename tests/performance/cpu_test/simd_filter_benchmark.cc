@@ -0,0 +1,192 @@
+/**
+ * @file simd_filter_benchmark.cc
+ * @brief 过滤内核微基准：比较标量、SSE4.2、AVX2的选择吞吐量
+ *
+ * 用法: simd_filter_benchmark [行数] [重复次数]
+ * 每种内核在CPU支持的各指令集级别上生成位图并转换为选择向量，
+ * 另外对比CompiledPredicate按批求值(select)与逐行求值的吞吐量。
+ */
+
+#include "execution/compiled_predicate.h"
+#include "execution/simd_filter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace sqlcc;
+
+namespace {
+
+std::vector<SimdLevel> SupportedLevels() {
+  std::vector<SimdLevel> levels = {SimdLevel::SCALAR};
+  if (detect_simd_level() >= SimdLevel::SSE42) {
+    levels.push_back(SimdLevel::SSE42);
+  }
+  if (detect_simd_level() >= SimdLevel::AVX2) {
+    levels.push_back(SimdLevel::AVX2);
+  }
+  return levels;
+}
+
+// 重复执行body，返回每秒处理的行数（百万行/秒）
+double MeasureThroughput(size_t rows, size_t repeat,
+                         const std::function<size_t()> &body,
+                         size_t &selected) {
+  selected = body(); // 预热
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    selected = body();
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return static_cast<double>(rows) * repeat / seconds / 1e6;
+}
+
+void PrintRow(const std::string &kernel, const char *level, double mrows,
+              double baseline, size_t selected) {
+  std::printf("%-28s %-8s %10.1f Mrows/s  x%5.2f  selected=%zu\n",
+              kernel.c_str(), level, mrows, mrows / baseline, selected);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1 << 22);
+  size_t repeat = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+
+  std::mt19937_64 rng(2024);
+  std::vector<int64_t> ints(rows);
+  std::vector<double> doubles(rows);
+  for (size_t i = 0; i < rows; ++i) {
+    ints[i] = static_cast<int64_t>(rng() % 1000);
+    doubles[i] = static_cast<double>(rng() % 100000) / 100.0;
+  }
+  std::vector<int64_t> in_ints = {3, 17, 99, 256, 511, 700, 901, 998};
+  std::vector<double> in_doubles = {1.5, 20.25, 333.0, 999.99};
+
+  std::printf("CPU最高指令集: %s, 行数=%zu, 重复=%zu\n",
+              simd_level_name(detect_simd_level()), rows, repeat);
+
+  std::vector<uint64_t> mask(bitmap_words(rows));
+  SelectionVector selection;
+  selection.reserve(rows);
+
+  struct Kernel {
+    std::string name;
+    std::function<void(SimdLevel)> fill;
+  };
+  std::vector<Kernel> kernels = {
+      {"int64 > 500",
+       [&](SimdLevel level) {
+         compare_mask(ints.data(), rows, CompareOp::GT, int64_t(500),
+                      mask.data(), level);
+       }},
+      {"int64 = 42",
+       [&](SimdLevel level) {
+         compare_mask(ints.data(), rows, CompareOp::EQ, int64_t(42),
+                      mask.data(), level);
+       }},
+      {"double <= 250.0",
+       [&](SimdLevel level) {
+         compare_mask(doubles.data(), rows, CompareOp::LE, 250.0, mask.data(),
+                      level);
+       }},
+      {"int64 BETWEEN 100 AND 300",
+       [&](SimdLevel level) {
+         between_mask(ints.data(), rows, 100, 300, mask.data(), level);
+       }},
+      {"double BETWEEN 10 AND 20",
+       [&](SimdLevel level) {
+         between_mask(doubles.data(), rows, 10.0, 20.0, mask.data(), level);
+       }},
+      {"int64 IN (8 values)",
+       [&](SimdLevel level) {
+         in_list_mask(ints.data(), rows, in_ints.data(), in_ints.size(),
+                      mask.data(), level);
+       }},
+      {"double IN (4 values)",
+       [&](SimdLevel level) {
+         in_list_mask(doubles.data(), rows, in_doubles.data(),
+                      in_doubles.size(), mask.data(), level);
+       }},
+  };
+
+  std::printf("\n== 位图内核 + 选择向量 ==\n");
+  for (const auto &kernel : kernels) {
+    double baseline = 0;
+    for (SimdLevel level : SupportedLevels()) {
+      size_t selected = 0;
+      double mrows = MeasureThroughput(
+          rows, repeat,
+          [&]() {
+            kernel.fill(level);
+            return mask_to_selection(mask.data(), rows, selection);
+          },
+          selected);
+      if (level == SimdLevel::SCALAR) {
+        baseline = mrows;
+      }
+      PrintRow(kernel.name, simd_level_name(level), mrows, baseline, selected);
+    }
+  }
+
+  // 按批求值：与FilterOperator相同的批大小，列为INT/DOUBLE
+  std::vector<ColumnMeta> columns = {{"a", "INT", true, false, false, ""},
+                                     {"b", "DOUBLE", true, false, false, ""}};
+  const size_t batch_size = 1024;
+  std::vector<std::vector<Row>> batches;
+  for (size_t begin = 0; begin < rows; begin += batch_size) {
+    std::vector<Row> batch;
+    for (size_t i = begin; i < std::min(rows, begin + batch_size); ++i) {
+      Row row;
+      row.values = {Value(ints[i]), Value(doubles[i])};
+      batch.push_back(std::move(row));
+    }
+    batches.push_back(std::move(batch));
+  }
+  CompiledPredicate predicate = CompiledPredicate::all_of(
+      {CompiledPredicate::compile(columns, "a", "BETWEEN", "100 AND 600"),
+       CompiledPredicate::compile(columns, "b", ">", "300")});
+
+  std::printf("\n== CompiledPredicate: %s ==\n", predicate.describe().c_str());
+  size_t selected = 0;
+  double row_mrows = MeasureThroughput(
+      rows, repeat,
+      [&]() {
+        size_t count = 0;
+        for (const auto &batch : batches) {
+          for (const auto &row : batch) {
+            count += predicate(row);
+          }
+        }
+        return count;
+      },
+      selected);
+  PrintRow("row-at-a-time", "-", row_mrows, row_mrows, selected);
+
+  SimdLevel original = active_simd_level();
+  for (SimdLevel level : SupportedLevels()) {
+    set_simd_level(level);
+    double mrows = MeasureThroughput(
+        rows, repeat,
+        [&]() {
+          size_t count = 0;
+          for (const auto &batch : batches) {
+            predicate.select(batch, selection);
+            count += selection.size();
+          }
+          return count;
+        },
+        selected);
+    PrintRow("select (batch)", simd_level_name(level), mrows, row_mrows,
+             selected);
+  }
+  set_simd_level(original);
+  return 0;
+}
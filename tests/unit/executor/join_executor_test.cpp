@@ -127,7 +127,7 @@ TEST_F(JoinExecutorTest, InnerJoinOperation) {
   auto stats = join_executor_->get_stats();
   EXPECT_EQ(stats.left_rows, 3);
   EXPECT_EQ(stats.right_rows, 3);
-  EXPECT_EQ(stats.rows_processed, 9); // 3*3=9行处理
+  EXPECT_EQ(stats.rows_processed, 6); // Hash JOIN: 构建3行 + 探测3行
   EXPECT_EQ(stats.result_rows, 3);
   EXPECT_FALSE(stats.has_error);
 }
@@ -154,7 +154,7 @@ TEST_F(JoinExecutorTest, LeftJoinOperation) {
   auto stats = join_executor_->get_stats();
   EXPECT_EQ(stats.left_rows, 3);
   EXPECT_EQ(stats.right_rows, 3);
-  EXPECT_EQ(stats.rows_processed, 9); // 3*3=9行处理
+  EXPECT_EQ(stats.rows_processed, 6); // Hash JOIN: 构建3行 + 探测3行
   EXPECT_EQ(stats.result_rows, 3);
   EXPECT_FALSE(stats.has_error);
 }
@@ -182,7 +182,7 @@ TEST_F(JoinExecutorTest, RightJoinOperation) {
   auto stats = join_executor_->get_stats();
   EXPECT_EQ(stats.left_rows, 3);
   EXPECT_EQ(stats.right_rows, 3);
-  EXPECT_EQ(stats.rows_processed, 9); // 3*3=9行处理
+  EXPECT_EQ(stats.rows_processed, 6); // Hash JOIN: 构建3行 + 探测3行
   EXPECT_EQ(stats.result_rows, 4);
   EXPECT_FALSE(stats.has_error);
 }
@@ -0,0 +1,62 @@
+/**
+ * @file explain_analyze_test.cpp
+ * @brief EXPLAIN ANALYZE单元测试
+ *
+ * 测试每个算子的实际行数、循环次数、耗时和缓冲池访问统计，
+ * 以及并行扫描时工作线程的页面访问汇总到Gather算子
+ */
+
+#include "execution/explain_analyze.h"
+#include "execution/parallel_scan.h"
+#include "memory_table_scan.h"
+#include <gtest/gtest.h>
+
+using namespace sqlcc;
+using sqlcc::test::CountingTableScan;
+
+TEST(ExplainAnalyzeTest, ExplainAnalyzeProfilesEachOperator) {
+  auto scan = std::make_unique<CountingTableScan>(1000);
+  scan->set_estimated_rows(1000);
+  auto filter = std::make_unique<FilterOperator>(
+      std::move(scan),
+      [](const Row &row) { return row.values[0].int_val % 2 == 0; },
+      "id % 2 = 0");
+  OperatorPtr root = instrument_operator_tree(
+      std::make_unique<LimitOperator>(std::move(filter), 10, 0));
+  EXPECT_EQ(execute_operator_tree(*root).rows.size(), 10u);
+
+  const auto &limit = dynamic_cast<const InstrumentedOperator &>(*root);
+  const auto &filter_profile =
+      dynamic_cast<const InstrumentedOperator &>(*limit.input().children()[0]);
+  const auto &scan_profile = dynamic_cast<const InstrumentedOperator &>(
+      *filter_profile.input().children()[0]);
+  EXPECT_EQ(limit.profile().loops, 1u);
+  EXPECT_EQ(limit.profile().rows, 10u);
+  EXPECT_GE(filter_profile.profile().rows, 10u);
+  EXPECT_GE(scan_profile.profile().rows, filter_profile.profile().rows);
+  // 时间和缓冲池访问包含下层算子
+  EXPECT_GT(scan_profile.profile().buffers.hits, 0u);
+  EXPECT_EQ(limit.profile().buffers.hits, scan_profile.profile().buffers.hits);
+  EXPECT_GE(limit.profile().wall_ms, scan_profile.profile().wall_ms);
+
+  std::string text = explain_analyze(*root);
+  EXPECT_EQ(text.find("Limit"), 0u) << text;
+  EXPECT_NE(text.find("est rows=1000, actual rows=" +
+                      std::to_string(scan_profile.profile().rows) +
+                      ", loops=1"),
+            std::string::npos)
+      << text;
+  EXPECT_NE(text.find("buffers: hits="), std::string::npos) << text;
+
+  // 并行扫描：工作线程的页面访问计入Gather，流水线不计时
+  OperatorPtr gather = instrument_operator_tree(std::make_unique<ExchangeOperator>(
+      std::make_unique<CountingTableScan>(1000),
+      [](OperatorPtr source) { return source; }, 4));
+  size_t rows = execute_operator_tree(*gather).rows.size();
+  text = explain_analyze(*gather);
+  EXPECT_NE(text.find("actual rows=" + std::to_string(rows)), std::string::npos)
+      << text;
+  // 工作线程逐页读取：1000行共100页，每页固定一次
+  EXPECT_NE(text.find("hits=100 "), std::string::npos) << text;
+  EXPECT_NE(text.find("-> MorselScan(sales)\n"), std::string::npos) << text;
+}
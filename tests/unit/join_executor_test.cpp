@@ -1,6 +1,8 @@
 #include "database_manager.h"
+#include "exception.h"
 #include "execution/join_executor.h"
 #include "sql_executor.h"
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <memory>
 
@@ -127,7 +129,7 @@ TEST_F(JoinExecutorTest, InnerJoinOperation) {
   auto stats = join_executor_->get_stats();
   EXPECT_EQ(stats.left_rows, 3);
   EXPECT_EQ(stats.right_rows, 3);
-  EXPECT_EQ(stats.rows_processed, 9); // 3*3=9行处理
+  EXPECT_EQ(stats.rows_processed, 6); // Hash JOIN: 构建3行 + 探测3行
   EXPECT_EQ(stats.result_rows, 3);
   EXPECT_FALSE(stats.has_error);
 }
@@ -154,7 +156,7 @@ TEST_F(JoinExecutorTest, LeftJoinOperation) {
   auto stats = join_executor_->get_stats();
   EXPECT_EQ(stats.left_rows, 3);
   EXPECT_EQ(stats.right_rows, 3);
-  EXPECT_EQ(stats.rows_processed, 9); // 3*3=9行处理
+  EXPECT_EQ(stats.rows_processed, 6); // Hash JOIN: 构建3行 + 探测3行
   EXPECT_EQ(stats.result_rows, 3);
   EXPECT_FALSE(stats.has_error);
 }
@@ -182,7 +184,7 @@ TEST_F(JoinExecutorTest, RightJoinOperation) {
   auto stats = join_executor_->get_stats();
   EXPECT_EQ(stats.left_rows, 3);
   EXPECT_EQ(stats.right_rows, 3);
-  EXPECT_EQ(stats.rows_processed, 9); // 3*3=9行处理
+  EXPECT_EQ(stats.rows_processed, 6); // Hash JOIN: 构建3行 + 探测3行
   EXPECT_EQ(stats.result_rows, 4);
   EXPECT_FALSE(stats.has_error);
 }
@@ -233,3 +235,284 @@ TEST(JoinExecutorSimpleTest, BasicFunctionality) {
   EXPECT_FALSE(stats.has_error);
   EXPECT_FALSE(stats.error_message.has_value());
 }
+
+// 生成 count 行 (key, payload) 数据，key = i % modulo
+static sqlcc::ExecutionResult create_keyed_table(const std::string &key_name,
+                                                 size_t count, size_t modulo) {
+  sqlcc::ExecutionResult result;
+  result.column_metadata.push_back({key_name, "INT", false, false, false, ""});
+  result.column_metadata.push_back(
+      {key_name + "_payload", "INT", false, false, false, ""});
+  result.rows.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    sqlcc::Row row;
+    row.values.push_back(sqlcc::Value(static_cast<int64_t>(i % modulo)));
+    row.values.push_back(sqlcc::Value(static_cast<int64_t>(i)));
+    result.rows.push_back(row);
+  }
+  result.success = true;
+  return result;
+}
+
+// 测试FULL JOIN在一次探测中输出两侧未匹配行
+TEST_F(JoinExecutorTest, HashFullJoinOperation) {
+  sqlcc::ExecutionResult left_table = create_test_left_table();
+  sqlcc::ExecutionResult right_table = create_test_right_table();
+
+  sqlcc::ExecutionResult result = join_executor_->execute(
+      left_table, right_table, sqlcc::JoinType::FULL_JOIN,
+      "employees.department_id = departments.department_id");
+
+  // 3行匹配 + 右表department_id=30未匹配
+  EXPECT_TRUE(result.success);
+  ASSERT_EQ(result.rows.size(), 4);
+  EXPECT_EQ(result.rows.back().values[4].str_val, "IT");
+
+  auto stats = join_executor_->get_stats();
+  EXPECT_EQ(stats.algorithm, "hash");
+  EXPECT_EQ(stats.rows_processed, 6);
+}
+
+// 测试在较小的输入上建立哈希表，并保持左右列顺序
+TEST_F(JoinExecutorTest, HashJoinBuildsOnSmallerInput) {
+  sqlcc::ExecutionResult left_table = create_keyed_table("a", 10, 10);
+  sqlcc::ExecutionResult right_table = create_keyed_table("b", 4, 4);
+
+  join_executor_->set_algorithm(sqlcc::JoinAlgorithm::HASH);
+  sqlcc::ExecutionResult result = join_executor_->execute(
+      left_table, right_table, sqlcc::JoinType::LEFT_JOIN, "a = b");
+
+  auto stats = join_executor_->get_stats();
+  EXPECT_EQ(stats.build_rows, 4);
+  ASSERT_EQ(result.rows.size(), 10);
+  for (const auto &row : result.rows) {
+    ASSERT_EQ(row.values.size(), 4);
+    // 左表列在前
+    EXPECT_EQ(row.values[0].int_val, row.values[1].int_val);
+  }
+  // 左表输入顺序保持不变
+  EXPECT_EQ(result.rows[9].values[1].int_val, 9);
+
+  // RIGHT JOIN 的保留侧是构建侧
+  result = join_executor_->execute(right_table, left_table,
+                                   sqlcc::JoinType::RIGHT_JOIN, "b = a");
+  EXPECT_EQ(join_executor_->get_stats().build_rows, 4);
+  ASSERT_EQ(result.rows.size(), 10);
+  EXPECT_EQ(result.rows.back().values[2].int_val, 9);
+}
+
+// 测试非等值连接条件被拒绝
+TEST_F(JoinExecutorTest, NonEquiJoinConditionRejected) {
+  sqlcc::ExecutionResult left_table = create_test_left_table();
+  sqlcc::ExecutionResult right_table = create_test_right_table();
+
+  EXPECT_THROW(join_executor_->execute(left_table, right_table,
+                                       sqlcc::JoinType::INNER_JOIN,
+                                       "department_id >= department_id"),
+               sqlcc::Exception);
+  EXPECT_TRUE(join_executor_->get_stats().has_error);
+}
+
+// 把结果行转换为有序字符串集合，便于比较不同算法的输出
+static std::vector<std::string>
+canonical_rows(const sqlcc::ExecutionResult &result) {
+  std::vector<std::string> rows;
+  for (const auto &row : result.rows) {
+    std::string text;
+    for (const auto &value : row.values) {
+      text += value.type == sqlcc::Value::Type::STRING
+                  ? value.str_val
+                  : std::to_string(value.int_val);
+      text += "|";
+    }
+    rows.push_back(text);
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+// 生成带字符串负载的表，key = i % modulo + offset，两表偏移不同时部分键不匹配
+static sqlcc::ExecutionResult create_wide_table(const std::string &key_name,
+                                                size_t count, size_t modulo,
+                                                int64_t offset) {
+  sqlcc::ExecutionResult result;
+  result.column_metadata.push_back({key_name, "INT", false, false, false, ""});
+  result.column_metadata.push_back(
+      {key_name + "_text", "VARCHAR(64)", false, false, false, ""});
+  for (size_t i = 0; i < count; ++i) {
+    sqlcc::Row row;
+    row.values.push_back(
+        sqlcc::Value(static_cast<int64_t>(i % modulo) + offset));
+    row.values.push_back(sqlcc::Value(key_name + "_row_payload_" +
+                                      std::to_string(i)));
+    result.rows.push_back(row);
+  }
+  return result;
+}
+
+// 测试哈希连接与嵌套循环连接结果一致，且在较小的输入上建表
+TEST_F(JoinExecutorTest, HashJoinMatchesNestedLoop) {
+  sqlcc::ExecutionResult large = create_wide_table("a", 600, 200, 0);
+  sqlcc::ExecutionResult small = create_wide_table("b", 200, 100, 150);
+
+  for (auto join_type :
+       {sqlcc::JoinType::INNER_JOIN, sqlcc::JoinType::LEFT_JOIN,
+        sqlcc::JoinType::RIGHT_JOIN, sqlcc::JoinType::FULL_JOIN}) {
+    join_executor_->set_algorithm(sqlcc::JoinAlgorithm::NESTED_LOOP);
+    sqlcc::ExecutionResult expected =
+        join_executor_->execute(large, small, join_type, "a = b");
+    EXPECT_EQ(join_executor_->get_stats().algorithm, "nested_loop");
+
+    join_executor_->set_algorithm(sqlcc::JoinAlgorithm::HASH);
+    sqlcc::ExecutionResult actual =
+        join_executor_->execute(large, small, join_type, "a = b");
+    auto stats = join_executor_->get_stats();
+    EXPECT_EQ(stats.algorithm, "hash");
+    EXPECT_EQ(stats.build_rows, small.rows.size());
+    EXPECT_EQ(stats.rows_processed, large.rows.size() + small.rows.size());
+    EXPECT_EQ(canonical_rows(actual), canonical_rows(expected));
+  }
+
+  // 较小的输入在左侧时同样作为构建侧
+  sqlcc::ExecutionResult swapped = join_executor_->execute(
+      small, large, sqlcc::JoinType::INNER_JOIN, "b = a");
+  EXPECT_EQ(join_executor_->get_stats().build_rows, small.rows.size());
+  // 两侧共有的键为150..199，每个键在左侧2行、右侧3行
+  EXPECT_EQ(swapped.rows.size(), 50u * 2 * 3);
+}
+
+// 测试超出内存限制时Grace Hash JOIN的结果与内存Hash JOIN一致
+TEST_F(JoinExecutorTest, GraceHashJoinMatchesInMemory) {
+  sqlcc::ExecutionResult left_table = create_wide_table("a", 3000, 1000, 0);
+  sqlcc::ExecutionResult right_table = create_wide_table("b", 2000, 1000, 500);
+
+  for (auto join_type :
+       {sqlcc::JoinType::INNER_JOIN, sqlcc::JoinType::LEFT_JOIN,
+        sqlcc::JoinType::RIGHT_JOIN, sqlcc::JoinType::FULL_JOIN}) {
+    sqlcc::JoinExecutor in_memory(nullptr);
+    sqlcc::ExecutionResult expected =
+        in_memory.execute(left_table, right_table, join_type, "a = b");
+    EXPECT_EQ(in_memory.get_stats().algorithm, "hash");
+
+    join_executor_->set_memory_limit(32 * 1024);
+    sqlcc::ExecutionResult actual =
+        join_executor_->execute(left_table, right_table, join_type, "a = b");
+    auto stats = join_executor_->get_stats();
+    EXPECT_EQ(stats.algorithm, "grace_hash");
+    EXPECT_GT(stats.spilled_partitions, 0);
+    EXPECT_GT(stats.spilled_bytes, 0);
+    EXPECT_EQ(canonical_rows(actual), canonical_rows(expected));
+  }
+}
+
+// 测试分区仍超限时递归重分区
+TEST_F(JoinExecutorTest, GraceHashJoinRepartitions) {
+  sqlcc::ExecutionResult left_table = create_wide_table("a", 20000, 20000, 0);
+  sqlcc::ExecutionResult right_table = create_wide_table("b", 20000, 20000, 0);
+
+  // 64个分区仍放不下，需要第二层划分
+  join_executor_->set_algorithm(sqlcc::JoinAlgorithm::HASH);
+  join_executor_->set_memory_limit(8 * 1024);
+  sqlcc::ExecutionResult result = join_executor_->execute(
+      left_table, right_table, sqlcc::JoinType::INNER_JOIN, "a = b");
+  EXPECT_EQ(result.rows.size(), 20000);
+  EXPECT_GE(join_executor_->get_stats().max_partition_depth, 1);
+}
+
+// 测试单一键严重倾斜时分块连接仍保证外连接语义
+TEST_F(JoinExecutorTest, GraceHashJoinSkewedKey) {
+  sqlcc::ExecutionResult left_table = create_wide_table("a", 400, 1, 7);
+  sqlcc::ExecutionResult right_table = create_wide_table("b", 300, 1, 7);
+  // 右表追加一行不匹配的键
+  sqlcc::Row unmatched;
+  unmatched.values.push_back(sqlcc::Value(static_cast<int64_t>(99)));
+  unmatched.values.push_back(sqlcc::Value(std::string("lonely")));
+  right_table.rows.push_back(unmatched);
+
+  join_executor_->set_algorithm(sqlcc::JoinAlgorithm::HASH);
+  join_executor_->set_memory_limit(4 * 1024);
+  sqlcc::ExecutionResult result = join_executor_->execute(
+      left_table, right_table, sqlcc::JoinType::FULL_JOIN, "a = b");
+
+  EXPECT_EQ(result.rows.size(), 400 * 300 + 1);
+  auto stats = join_executor_->get_stats();
+  EXPECT_EQ(stats.algorithm, "grace_hash");
+  EXPECT_GT(stats.spilled_partitions, 0);
+}
+
+// 测试Sort-Merge JOIN在重复键和外连接下与Hash JOIN结果一致
+TEST_F(JoinExecutorTest, SortMergeJoinMatchesHashJoin) {
+  sqlcc::ExecutionResult left_table = create_wide_table("a", 300, 70, 0);
+  sqlcc::ExecutionResult right_table = create_wide_table("b", 200, 50, 30);
+
+  for (auto join_type :
+       {sqlcc::JoinType::INNER_JOIN, sqlcc::JoinType::LEFT_JOIN,
+        sqlcc::JoinType::RIGHT_JOIN, sqlcc::JoinType::FULL_JOIN}) {
+    join_executor_->set_algorithm(sqlcc::JoinAlgorithm::HASH);
+    sqlcc::ExecutionResult expected =
+        join_executor_->execute(left_table, right_table, join_type, "a = b");
+
+    join_executor_->set_algorithm(sqlcc::JoinAlgorithm::SORT_MERGE);
+    sqlcc::ExecutionResult actual =
+        join_executor_->execute(left_table, right_table, join_type, "a = b");
+    EXPECT_EQ(join_executor_->get_stats().algorithm, "sort_merge");
+    EXPECT_EQ(canonical_rows(actual), canonical_rows(expected));
+  }
+}
+
+// 测试代价估计对已排序输入选择归并连接
+TEST_F(JoinExecutorTest, PlannerPicksMergeForSortedInputs) {
+  sqlcc::ExecutionResult left_table = create_keyed_table("a", 5000, 5000);
+  sqlcc::ExecutionResult right_table = create_keyed_table("b", 5000, 5000);
+
+  sqlcc::ExecutionResult result = join_executor_->execute(
+      left_table, right_table, sqlcc::JoinType::INNER_JOIN, "a = b");
+  EXPECT_EQ(join_executor_->get_stats().algorithm, "sort_merge");
+  ASSERT_EQ(result.rows.size(), 5000);
+  // 归并输出按连接键有序
+  EXPECT_EQ(result.rows.back().values[0].int_val, 4999);
+
+  // 打乱右表后改用哈希连接
+  std::reverse(right_table.rows.begin(), right_table.rows.end());
+  std::swap(right_table.rows[0], right_table.rows[2500]);
+  join_executor_->execute(left_table, right_table,
+                          sqlcc::JoinType::INNER_JOIN, "a = b");
+  EXPECT_EQ(join_executor_->get_stats().algorithm, "hash");
+}
+
+// 测试连接算法的代价选择
+TEST(JoinPlannerTest, ChooseJoinAlgorithm) {
+  using sqlcc::JoinAlgorithm;
+  using sqlcc::JoinType;
+  using sqlcc::choose_join_algorithm;
+
+  EXPECT_EQ(choose_join_algorithm({100, false, false}, {100, false, false},
+                                  JoinType::INNER_JOIN, false),
+            JoinAlgorithm::NESTED_LOOP);
+  // 单行外表使用嵌套循环
+  EXPECT_EQ(choose_join_algorithm({1, false, false}, {1000, false, false},
+                                  JoinType::INNER_JOIN, true),
+            JoinAlgorithm::NESTED_LOOP);
+  EXPECT_EQ(choose_join_algorithm({100000, false, false},
+                                  {100000, false, false}, JoinType::INNER_JOIN,
+                                  true),
+            JoinAlgorithm::HASH);
+  EXPECT_EQ(choose_join_algorithm({100000, true, false}, {100000, true, false},
+                                  JoinType::FULL_JOIN, true),
+            JoinAlgorithm::SORT_MERGE);
+  // 小外表连接带索引的大维表
+  EXPECT_EQ(choose_join_algorithm({100, false, false},
+                                  {10000000, false, true},
+                                  JoinType::LEFT_JOIN, true),
+            JoinAlgorithm::INDEX_NESTED_LOOP);
+  // 需要保留内表未匹配行时不能使用索引连接
+  EXPECT_EQ(choose_join_algorithm({100, false, false},
+                                  {10000000, false, true},
+                                  JoinType::RIGHT_JOIN, true),
+            JoinAlgorithm::HASH);
+  // 外表与内表相当时全表哈希更便宜
+  EXPECT_EQ(choose_join_algorithm({1000000, false, false},
+                                  {1000000, false, true},
+                                  JoinType::INNER_JOIN, true),
+            JoinAlgorithm::HASH);
+}
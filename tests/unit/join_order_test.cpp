@@ -0,0 +1,176 @@
+/**
+ * @file join_order_test.cpp
+ * @brief 多表连接顺序单元测试
+ *
+ * 测试DPccp与贪心算法选择的连接顺序、超出动态规划上限和不连通的连接图、
+ * 按连接树构建的算子对限定列名的解析，以及执行计划生成器对多表连接的排序
+ */
+
+#include "execution/join_order.h"
+#include "execution/statistics.h"
+#include "memory_table_scan.h"
+#include "unified_executor.h"
+#include <gtest/gtest.h>
+
+using namespace sqlcc;
+using sqlcc::test::MemoryTableScan;
+
+namespace {
+
+ColumnMeta MakeColumn(const std::string &name, const std::string &type) {
+  return {name, type, true, false, false, ""};
+}
+
+// 星型模型：fact(1e6行)连接三个维表，d1经过滤后只剩10行
+JoinGraph MakeStarGraph() {
+  JoinGraph graph;
+  graph.relations = {{"fact", 1e6, 1e4},
+                     {"d2", 1000, 10},
+                     {"d3", 1000, 10},
+                     {"d1", 10, 10}};
+  for (size_t dim = 1; dim < 4; ++dim) {
+    JoinPredicate predicate;
+    predicate.left = 0;
+    predicate.right = dim;
+    predicate.left_column = graph.relations[dim].name + "_id";
+    predicate.right_column = "id";
+    predicate.selectivity = 1e-3;
+    graph.predicates.push_back(predicate);
+  }
+  return graph;
+}
+
+// 包含fact的最小子树（第一次连接事实表）
+const JoinTreeNode *FirstFactJoin(const JoinTreeNode &tree) {
+  const JoinTreeNode *node = &tree;
+  while (!node->is_leaf()) {
+    const JoinTreeNode *next = (node->left->relations & 1) ? node->left.get()
+                                                           : node->right.get();
+    if (next->is_leaf()) {
+      return node;
+    }
+    node = next;
+  }
+  return node;
+}
+
+} // namespace
+
+TEST(JoinOrderTest, JoinOrderJoinsSelectiveDimensionFirst) {
+  JoinGraph graph = MakeStarGraph();
+  JoinTreePtr tree = optimize_join_order(graph);
+  EXPECT_EQ(tree->relations, 0xFu);
+  EXPECT_NEAR(tree->rows, 1e4, 1);
+  // 先连接过滤后的维表，中间结果保持在1e4行
+  const JoinTreeNode *first = FirstFactJoin(*tree);
+  EXPECT_EQ(first->relations, 0x9u) << tree->to_string(graph);
+  EXPECT_EQ(first->right->relation, 3u); // 小表为构建侧
+  EXPECT_LE(tree->cost, greedy_join_order(graph)->cost + 1e-9);
+
+  // 按查询文本顺序先连接未过滤的维表，代价更高
+  graph.relations[3].rows = 1000;
+  graph.relations[1].rows = 10;
+  EXPECT_EQ(FirstFactJoin(*optimize_join_order(graph))->relations, 0x3u);
+}
+
+TEST(JoinOrderTest, JoinOrderHandlesLargeAndDisconnectedGraphs) {
+  // 13张表的链超过动态规划上限，使用贪心算法
+  JoinGraph chain;
+  for (size_t i = 0; i < 13; ++i) {
+    chain.relations.push_back({"t" + std::to_string(i), 100.0 * (i + 1), 1});
+    if (i > 0) {
+      chain.predicates.push_back({i - 1, i, "id", "id", 1.0 / (100.0 * (i + 1))});
+    }
+  }
+  JoinTreePtr greedy = optimize_join_order(chain);
+  EXPECT_EQ(greedy->relations, (uint64_t(1) << 13) - 1);
+  EXPECT_DOUBLE_EQ(greedy->cost, greedy_join_order(chain)->cost);
+
+  // 12张表用动态规划，不劣于贪心
+  chain.relations.pop_back();
+  chain.predicates.pop_back();
+  EXPECT_LE(optimize_join_order(chain)->cost,
+            greedy_join_order(chain)->cost + 1e-9);
+
+  // 没有连接条件的表最后以笛卡尔积合并
+  JoinGraph disconnected = MakeStarGraph();
+  disconnected.relations.push_back({"other", 5, 1});
+  JoinTreePtr tree = optimize_join_order(disconnected);
+  EXPECT_EQ(tree->relations, 0x1Fu);
+  EXPECT_TRUE(tree->predicates.empty());
+  EXPECT_NE(tree->to_string(disconnected).find("CROSS JOIN other"),
+            std::string::npos);
+  EXPECT_THROW(optimize_join_order(JoinGraph()), Exception);
+}
+
+TEST(JoinOrderTest, JoinTreeExecutesWithQualifiedColumns) {
+  // a(id, x) - b(id, x) - c(id, x)，三个条件构成环：a.id = b.id、b.x = c.x、a.x = c.id
+  auto make_table = [](size_t rows, int64_t modulo) {
+    std::vector<Row> data;
+    for (size_t i = 0; i < rows; ++i) {
+      Row row;
+      row.values = {Value(static_cast<int64_t>(i)),
+                    Value(static_cast<int64_t>(i) % modulo)};
+      data.push_back(row);
+    }
+    return std::make_unique<ValuesScanOperator>(
+        std::vector<ColumnMeta>{MakeColumn("id", "INT"), MakeColumn("x", "INT")},
+        std::move(data));
+  };
+  JoinGraph graph;
+  graph.relations = {{"a", 50, 1}, {"b", 40, 1}, {"c", 30, 1}};
+  graph.predicates = {{0, 1, "id", "id", 1.0 / 50},
+                      {1, 2, "x", "x", 1.0 / 7},
+                      {0, 2, "x", "id", 1.0 / 30}};
+  JoinTreePtr tree = optimize_join_order(graph);
+  OperatorPtr root = build_join_operator(*tree, graph, [&](size_t relation) {
+    const size_t rows[] = {50, 40, 30};
+    const int64_t modulo[] = {5, 7, 7};
+    return OperatorPtr(make_table(rows[relation], modulo[relation]));
+  });
+  EXPECT_NE(root->explain().find("Filter"), std::string::npos)
+      << root->explain();
+
+  size_t expected = 0;
+  for (int64_t a = 0; a < 50; ++a) {
+    for (int64_t c = 0; c < 30; ++c) {
+      int64_t b = a; // a.id = b.id
+      expected += b < 40 && b % 7 == c % 7 && a % 5 == c;
+    }
+  }
+  ExecutionResult result = execute_operator_tree(*root);
+  EXPECT_EQ(result.rows.size(), expected);
+  const auto &columns = root->output_columns();
+  ASSERT_EQ(columns.size(), 6u);
+  EXPECT_NE(columns[resolve_column(columns, "c.x")].name.find("c."),
+            std::string::npos);
+  EXPECT_EQ(resolve_column(columns, "x"), resolve_column(columns, columns[1].name));
+}
+
+TEST(JoinOrderTest, PlanGeneratorOrdersMultiTableJoins) {
+  const std::string database = "join_order_test";
+  MemoryTableScan scan(1000);
+  TableStatistics sales = collect_table_statistics(scan);
+  StatisticsCatalog::shared().put(database, sales);
+  ExecutionContext context("tester", database);
+  ExecutionPlanGenerator generator;
+
+  // 查询文本先连接sales；WHERE条件下推到regions之后regions只剩1行
+  sql_parser::SelectStatement stmt;
+  stmt.setTableName("sales");
+  stmt.addSelectColumn("*");
+  stmt.setJoinCondition("sales.id = items.id AND sales.region = regions.region");
+  stmt.setWhereClause(sql_parser::WhereClause("regions.region", "=", "'r1'"));
+  ExecutionPlan plan = generator.generatePlan(stmt, context);
+  EXPECT_EQ(plan.type, ExecutionPlan::JOIN);
+  EXPECT_NE(plan.description.find("连接顺序"), std::string::npos)
+      << plan.description;
+  EXPECT_GT(plan.estimated_rows, 0.0);
+  EXPECT_DOUBLE_EQ(generator.estimateCost(plan, context), plan.cost_estimate);
+
+  // 非等值条件不参与连接顺序枚举
+  stmt.setJoinCondition("sales.id < items.id AND sales.region = regions.region");
+  EXPECT_EQ(generator.generatePlan(stmt, context).description.find("连接顺序"),
+            std::string::npos);
+  StatisticsCatalog::shared().remove(database, "sales");
+}
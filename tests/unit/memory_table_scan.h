@@ -0,0 +1,97 @@
+/**
+ * @file memory_table_scan.h
+ * @brief 执行器单元测试共用的内存表扫描，不经过存储引擎
+ */
+
+#ifndef SQLCC_TESTS_UNIT_MEMORY_TABLE_SCAN_H
+#define SQLCC_TESTS_UNIT_MEMORY_TABLE_SCAN_H
+
+#include "execution/explain_analyze.h"
+#include "execution/physical_operator.h"
+#include "table_storage.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sqlcc {
+namespace test {
+
+// 内存中的sales(id, region, amount)表：第i行位于页i/10、偏移i%10，
+// i % 17 == 3的记录已删除
+class MemoryTableScan : public TableScanOperator {
+public:
+  explicit MemoryTableScan(size_t rows)
+      : TableScanOperator(std::make_shared<TableStorageManager>(nullptr),
+                          "sales", MakeSalesMetadata()),
+        rows_(rows) {}
+
+protected:
+  std::vector<std::string> read_record(int32_t page_id,
+                                       size_t offset) const override {
+    size_t i = static_cast<size_t>(page_id) * 10 + offset;
+    if (i % 17 == 3) {
+      return {};
+    }
+    return {std::to_string(i), "r" + std::to_string(i % 5),
+            std::to_string(i % 40) + ".5"};
+  }
+
+  std::vector<int32_t> table_pages() const override {
+    std::vector<int32_t> pages;
+    for (size_t page = 0; page * 10 < rows_; ++page) {
+      pages.push_back(static_cast<int32_t>(page));
+    }
+    return pages;
+  }
+
+  std::vector<std::vector<std::string>>
+  read_page(int32_t page_id) const override {
+    std::vector<std::vector<std::string>> records;
+    for (size_t offset = 0; offset < 10; ++offset) {
+      if (static_cast<size_t>(page_id) * 10 + offset >= rows_) {
+        break;
+      }
+      auto record = MemoryTableScan::read_record(page_id, offset);
+      if (!record.empty()) {
+        records.push_back(std::move(record));
+      }
+    }
+    return records;
+  }
+
+private:
+  static std::shared_ptr<TableMetadata> MakeSalesMetadata() {
+    auto meta = std::make_shared<TableMetadata>();
+    meta->table_name = "sales";
+    meta->columns = {{"id", "INT", 8, false, ""},
+                     {"region", "VARCHAR", 16, true, ""},
+                     {"amount", "DOUBLE", 8, true, ""}};
+    return meta;
+  }
+
+  size_t rows_;
+};
+
+// 每次读取记录或整页计一次缓冲池命中，模拟经缓冲池固定数据页
+class CountingTableScan : public MemoryTableScan {
+public:
+  using MemoryTableScan::MemoryTableScan;
+
+protected:
+  std::vector<std::string> read_record(int32_t page_id,
+                                       size_t offset) const override {
+    thread_buffer_usage().hits++;
+    return MemoryTableScan::read_record(page_id, offset);
+  }
+
+  std::vector<std::vector<std::string>>
+  read_page(int32_t page_id) const override {
+    thread_buffer_usage().hits++;
+    return MemoryTableScan::read_page(page_id);
+  }
+};
+
+} // namespace test
+} // namespace sqlcc
+
+#endif // SQLCC_TESTS_UNIT_MEMORY_TABLE_SCAN_H
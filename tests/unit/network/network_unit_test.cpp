@@ -1,4 +1,5 @@
 #include "network/network.h"
+#include "network/buffer_chain.h"
 #include <gtest/gtest.h>
 #include <memory>
 #include <string>
@@ -184,6 +185,59 @@ TEST_F(SessionManagerTest, SessionIdGeneration) {
   EXPECT_LT(session3->GetSessionId(), session4->GetSessionId());
 }
 
+// 测试BufferChain：片段引用而非拷贝，部分发送后正确推进
+TEST(BufferChainTest, AppendAndConsume) {
+  auto head = std::make_shared<std::string>("HEAD");
+  auto body = std::make_shared<std::vector<char>>(10, 'x');
+
+  BufferChain chain;
+  chain.Append(head);
+  chain.Append(body);
+  chain.Append(std::make_shared<std::string>()); // 空片段被忽略
+  EXPECT_EQ(chain.SliceCount(), 2u);
+  EXPECT_EQ(chain.TotalBytes(), 14u);
+  // 片段直接指向原容器内存
+  EXPECT_EQ(chain.Front().data, head->data());
+
+  chain.Consume(6);
+  EXPECT_EQ(chain.SliceCount(), 1u);
+  EXPECT_EQ(chain.TotalBytes(), 8u);
+  EXPECT_EQ(chain.Front().data, body->data() + 2);
+
+  chain.Consume(100);
+  EXPECT_TRUE(chain.Empty());
+  EXPECT_EQ(chain.TotalBytes(), 0u);
+}
+
+TEST(BufferChainTest, SpliceKeepsOwnersAlive) {
+  BufferChain frame;
+  const char* raw = nullptr;
+  {
+    auto body = std::make_shared<std::string>("payload");
+    raw = body->data();
+    frame.Append(std::move(body));
+  }
+  BufferChain queue;
+  queue.Splice(frame);
+  EXPECT_TRUE(frame.Empty());
+  ASSERT_EQ(queue.SliceCount(), 1u);
+  EXPECT_EQ(queue.Front().data, raw);
+  EXPECT_EQ(std::string(queue.Front().data, queue.Front().length), "payload");
+  EXPECT_EQ(queue.CollectOwners(4).size(), 1u);
+}
+
+#ifdef __linux__
+TEST(BufferChainTest, FillIovec) {
+  BufferChain chain;
+  for (int i = 0; i < 5; ++i) {
+    chain.Append(std::make_shared<std::string>(std::to_string(i)));
+  }
+  struct iovec iov[3];
+  ASSERT_EQ(chain.FillIovec(iov, 3), 3u);
+  EXPECT_EQ(std::string(static_cast<char*>(iov[2].iov_base), iov[2].iov_len), "2");
+}
+#endif
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
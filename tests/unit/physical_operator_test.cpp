@@ -0,0 +1,1243 @@
+/**
+ * @file physical_operator_test.cpp
+ * @brief 拉取式算子树单元测试
+ *
+ * 测试各算子按固定批大小流式输出、LIMIT提前终止扫描、
+ * 连接/聚合/排序/窗口函数的结果正确性、聚合溢出与HAVING、子查询去相关与缓存、
+ * 编译后WHERE谓词的类型化比较、并行扫描、区域映射跳页，
+ * 以及执行计划生成器输出的算子树
+ */
+
+#include "execution/compiled_predicate.h"
+#include "execution/explain_analyze.h"
+#include "execution/parallel_scan.h"
+#include "execution/physical_operator.h"
+#include "execution/spill_file.h"
+#include "execution/statistics.h"
+#include "execution/subquery_executor.h"
+#include "b_plus_tree.h"
+#include "table_storage.h"
+#include "zone_map.h"
+#include "unified_executor.h"
+#include "memory_table_scan.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <map>
+
+using namespace sqlcc;
+using sqlcc::test::CountingTableScan;
+using sqlcc::test::MemoryTableScan;
+
+namespace {
+
+ColumnMeta MakeColumn(const std::string &name, const std::string &type) {
+  return {name, type, true, false, false, ""};
+}
+
+Row MakeRow(int64_t id, const std::string &name, int64_t dept) {
+  Row row;
+  row.values = {Value(id), Value(name), Value(dept)};
+  return row;
+}
+
+// 生成 employees(id, name, dept)，dept = id % 4
+std::unique_ptr<ValuesScanOperator> MakeEmployees(size_t count) {
+  std::vector<Row> rows;
+  for (size_t i = 0; i < count; ++i) {
+    rows.push_back(MakeRow(static_cast<int64_t>(i), "emp" + std::to_string(i),
+                           static_cast<int64_t>(i % 4)));
+  }
+  return std::make_unique<ValuesScanOperator>(
+      std::vector<ColumnMeta>{MakeColumn("id", "INT"),
+                              MakeColumn("name", "VARCHAR"),
+                              MakeColumn("dept", "INT")},
+      std::move(rows));
+}
+
+std::unique_ptr<ValuesScanOperator> MakeDepartments() {
+  std::vector<Row> rows;
+  for (int64_t id : {0, 1, 7}) {
+    Row row;
+    row.values = {Value(id), Value("dept" + std::to_string(id))};
+    rows.push_back(row);
+  }
+  return std::make_unique<ValuesScanOperator>(
+      std::vector<ColumnMeta>{MakeColumn("dept_id", "INT"),
+                              MakeColumn("dept_name", "VARCHAR")},
+      std::move(rows));
+}
+
+} // namespace
+
+TEST(PhysicalOperatorTest, FilterProjectStreamInFixedBatches) {
+  auto scan = MakeEmployees(100);
+  OperatorPtr filter = std::make_unique<FilterOperator>(
+      std::move(scan),
+      make_comparison_predicate({MakeColumn("id", "INT"),
+                                 MakeColumn("name", "VARCHAR"),
+                                 MakeColumn("dept", "INT")},
+                                "dept", "=", "1"),
+      "dept = 1");
+  ProjectOperator project(std::move(filter), {"name", "id"});
+
+  ASSERT_EQ(project.output_columns().size(), 2u);
+  EXPECT_EQ(project.output_columns()[0].name, "name");
+
+  project.open();
+  RowBatch batch(7);
+  size_t total = 0;
+  while (project.next(batch)) {
+    EXPECT_LE(batch.size(), 7u);
+    for (const auto &row : batch.rows()) {
+      ASSERT_EQ(row.values.size(), 2u);
+      EXPECT_EQ(row.values[1].int_val % 4, 1);
+    }
+    total += batch.size();
+  }
+  project.close();
+  EXPECT_EQ(total, 25u);
+}
+
+TEST(PhysicalOperatorTest, LimitStopsScanEarly) {
+  auto scan = MakeEmployees(100000);
+  PhysicalOperator *scan_ptr = scan.get();
+  LimitOperator limit(std::move(scan), 10, 5);
+
+  ExecutionResult result = execute_operator_tree(limit);
+  ASSERT_EQ(result.rows.size(), 10u);
+  EXPECT_EQ(result.rows.front().values[0].int_val, 5);
+  EXPECT_EQ(result.rows.back().values[0].int_val, 14);
+  // 扫描只读取了OFFSET+LIMIT行，而不是整张表
+  EXPECT_EQ(scan_ptr->rows_produced(), 15u);
+}
+
+TEST(PhysicalOperatorTest, JoinTypesAcrossSmallBatches) {
+  auto run = [](JoinType type) {
+    JoinOperator join(MakeEmployees(8), MakeDepartments(), type,
+                      "employees.dept = departments.dept_id");
+    return execute_operator_tree(join, 2);
+  };
+
+  // dept 0 和 1 各有2名员工
+  ExecutionResult inner = run(JoinType::INNER_JOIN);
+  EXPECT_EQ(inner.rows.size(), 4u);
+  EXPECT_EQ(inner.column_metadata.size(), 5u);
+  for (const auto &row : inner.rows) {
+    EXPECT_EQ(compare_values(row.values[2], row.values[3]), 0);
+  }
+
+  EXPECT_EQ(run(JoinType::LEFT_JOIN).rows.size(), 8u);
+  // 右表中dept 7没有匹配
+  ExecutionResult right = run(JoinType::RIGHT_JOIN);
+  ASSERT_EQ(right.rows.size(), 5u);
+  EXPECT_EQ(right.rows.back().values[4].str_val, "dept7");
+  EXPECT_EQ(run(JoinType::FULL_JOIN).rows.size(), 9u);
+  EXPECT_EQ(run(JoinType::CROSS_JOIN).rows.size(), 24u);
+
+  EXPECT_THROW(JoinOperator(MakeEmployees(1), MakeDepartments(),
+                            JoinType::INNER_JOIN, "id <= dept_id"),
+               Exception);
+}
+
+TEST(PhysicalOperatorTest, AggregateGroupsAndEmptyInput) {
+  AggregateOperator aggregate(
+      MakeEmployees(10), {"dept"},
+      {{AggregateSpec::COUNT, "", ""},
+       {AggregateSpec::SUM, "id", ""},
+       {AggregateSpec::AVG, "id", ""},
+       {AggregateSpec::MIN, "name", ""},
+       {AggregateSpec::MAX, "id", ""}});
+  EXPECT_EQ(aggregate.output_columns()[1].name, "COUNT(*)");
+
+  ExecutionResult result = execute_operator_tree(aggregate);
+  ASSERT_EQ(result.rows.size(), 4u);
+  // dept 0: id 0, 4, 8
+  const Row &dept0 = result.rows[0];
+  EXPECT_EQ(dept0.values[0].int_val, 0);
+  EXPECT_EQ(dept0.values[1].int_val, 3);
+  EXPECT_EQ(dept0.values[2].int_val, 12);
+  EXPECT_DOUBLE_EQ(dept0.values[3].double_val, 4.0);
+  EXPECT_EQ(dept0.values[4].str_val, "emp0");
+  EXPECT_EQ(dept0.values[5].int_val, 8);
+
+  AggregateOperator empty(MakeEmployees(0), {},
+                          {{AggregateSpec::COUNT, "", ""}});
+  ExecutionResult empty_result = execute_operator_tree(empty);
+  ASSERT_EQ(empty_result.rows.size(), 1u);
+  EXPECT_EQ(empty_result.rows[0].values[0].int_val, 0);
+}
+
+TEST(PhysicalOperatorTest, AggregateTypedAccumulatorsAndHaving) {
+  std::vector<Row> rows;
+  for (int64_t i = 0; i < 12; ++i) {
+    Row row;
+    row.values = {Value(i % 3), Value(i * 0.5), Value(i)};
+    rows.push_back(row);
+  }
+  AggregateOperator aggregate(
+      std::make_unique<ValuesScanOperator>(
+          std::vector<ColumnMeta>{MakeColumn("grp", "INT"),
+                                  MakeColumn("price", "DOUBLE"),
+                                  MakeColumn("qty", "BIGINT")},
+          std::move(rows)),
+      {"grp"},
+      {{AggregateSpec::SUM, "price", ""},
+       {AggregateSpec::SUM, "qty", ""},
+       {AggregateSpec::AVG, "qty", ""},
+       {AggregateSpec::MIN, "price", ""}});
+  aggregate.set_having("SUM(qty)", ">", "15");
+  EXPECT_NE(aggregate.describe().find("having SUM(qty) > 15"),
+            std::string::npos);
+
+  ExecutionResult result = execute_operator_tree(aggregate);
+  // grp 0: qty 0,3,6,9 = 18；grp 1: 22；grp 2: 26
+  ASSERT_EQ(result.rows.size(), 3u);
+  aggregate.set_having("SUM(qty)", ">=", "22");
+  result = execute_operator_tree(aggregate);
+  ASSERT_EQ(result.rows.size(), 2u);
+  const Row &grp1 = result.rows[0];
+  EXPECT_EQ(grp1.values[0].int_val, 1);
+  EXPECT_EQ(grp1.values[1].type, Value::Type::DOUBLE);
+  EXPECT_DOUBLE_EQ(grp1.values[1].double_val, 11.0);
+  EXPECT_EQ(grp1.values[2].type, Value::Type::INT);
+  EXPECT_EQ(grp1.values[2].int_val, 22);
+  EXPECT_DOUBLE_EQ(grp1.values[3].double_val, 5.5);
+  EXPECT_DOUBLE_EQ(grp1.values[4].double_val, 0.5);
+  EXPECT_EQ(aggregate.group_count(), 3u);
+}
+
+TEST(PhysicalOperatorTest, AggregateSpillsGroupsAndMergesRuns) {
+  // 每个id一组，dept把结果错开，确保溢出段之间存在重复键
+  auto build = [](size_t memory_limit) {
+    std::vector<Row> rows;
+    for (int64_t i = 0; i < 3000; ++i) {
+      rows.push_back(MakeRow(i % 1000, "emp" + std::to_string(i), i));
+    }
+    auto aggregate = std::make_unique<AggregateOperator>(
+        std::make_unique<ValuesScanOperator>(
+            std::vector<ColumnMeta>{MakeColumn("id", "INT"),
+                                    MakeColumn("name", "VARCHAR"),
+                                    MakeColumn("dept", "INT")},
+            std::move(rows)),
+        std::vector<std::string>{"id"},
+        std::vector<AggregateSpec>{{AggregateSpec::COUNT, "", ""},
+                                   {AggregateSpec::SUM, "dept", ""},
+                                   {AggregateSpec::MAX, "name", ""}});
+    aggregate->set_memory_limit(memory_limit);
+    aggregate->set_having("COUNT(*)", "=", "3");
+    return aggregate;
+  };
+
+  auto in_memory = build(kDefaultOperatorMemoryLimit);
+  ExecutionResult expected = execute_operator_tree(*in_memory);
+  EXPECT_EQ(in_memory->spilled_runs(), 0u);
+
+  auto spilled = build(64 * 1024);
+  ExecutionResult actual = execute_operator_tree(*spilled);
+  EXPECT_GT(spilled->spilled_runs(), 1u);
+  EXPECT_EQ(spilled->group_count(), 1000u);
+
+  ASSERT_EQ(actual.rows.size(), 1000u);
+  ASSERT_EQ(expected.rows.size(), 1000u);
+  std::map<int64_t, const Row *> by_key;
+  for (const auto &row : expected.rows) {
+    by_key[row.values[0].int_val] = &row;
+  }
+  int64_t previous = -1;
+  for (const auto &row : actual.rows) {
+    // 溢出后按分组键有序输出
+    EXPECT_GT(row.values[0].int_val, previous);
+    previous = row.values[0].int_val;
+    const Row &reference = *by_key.at(row.values[0].int_val);
+    EXPECT_EQ(row.values[1].int_val, 3);
+    EXPECT_EQ(row.values[2].int_val, reference.values[2].int_val);
+    EXPECT_EQ(row.values[3].str_val, reference.values[3].str_val);
+  }
+}
+
+TEST(PhysicalOperatorTest, SortThenLimit) {
+  OperatorPtr sort = std::make_unique<SortOperator>(
+      MakeEmployees(50), std::vector<SortKey>{{"dept", false}, {"id", true}});
+  LimitOperator limit(std::move(sort), 3);
+
+  ExecutionResult result = execute_operator_tree(limit, 2);
+  ASSERT_EQ(result.rows.size(), 3u);
+  EXPECT_EQ(result.rows[0].values[0].int_val, 3);
+  EXPECT_EQ(result.rows[1].values[0].int_val, 7);
+  EXPECT_EQ(result.rows[2].values[0].int_val, 11);
+}
+
+TEST(PhysicalOperatorTest, UnionAllStreamsBothChildren) {
+  auto left = MakeEmployees(5);
+  PhysicalOperator *left_ptr = left.get();
+  OperatorPtr union_all =
+      std::make_unique<UnionAllOperator>(std::move(left), MakeEmployees(3));
+  LimitOperator limit(std::move(union_all), 6);
+
+  ExecutionResult result = execute_operator_tree(limit, 2);
+  ASSERT_EQ(result.rows.size(), 6u);
+  EXPECT_EQ(result.rows[4].values[0].int_val, 4);
+  EXPECT_EQ(result.rows[5].values[0].int_val, 0);
+  EXPECT_EQ(left_ptr->rows_produced(), 5u);
+
+  EXPECT_THROW(UnionAllOperator(MakeEmployees(1), MakeDepartments()),
+               Exception);
+}
+
+TEST(PhysicalOperatorTest, SortKeyEncodingMatchesCompareValues) {
+  std::vector<Value> values = {Value(int64_t(-5)),
+                               Value(int64_t(0)),
+                               Value(-0.0),
+                               Value(int64_t(3)),
+                               Value(2.5),
+                               Value(3.0),
+                               Value(int64_t(9007199254740992)),
+                               Value(int64_t(9007199254740993)),
+                               Value(-1e300),
+                               Value(std::string("")),
+                               Value(std::string("a")),
+                               Value(std::string("a\0b", 3)),
+                               Value(std::string("ab")),
+                               Value(std::string("b"))};
+  for (bool ascending : {true, false}) {
+    for (const auto &left : values) {
+      for (const auto &right : values) {
+        std::string left_key;
+        std::string right_key;
+        encode_sort_key(left, ascending, left_key);
+        encode_sort_key(right, ascending, right_key);
+        int expected = compare_values(left, right);
+        int actual = left_key.compare(right_key);
+        actual = (actual > 0) - (actual < 0);
+        EXPECT_EQ(ascending ? expected : -expected, actual);
+      }
+    }
+  }
+}
+
+TEST(PhysicalOperatorTest, CompiledPredicateComparesTypedRecords) {
+  std::vector<ColumnMeta> columns = {MakeColumn("id", "INT"),
+                                     MakeColumn("name", "VARCHAR"),
+                                     MakeColumn("price", "DOUBLE")};
+
+  auto id_gt = CompiledPredicate::compile(columns, "id", ">", "9");
+  EXPECT_TRUE(id_gt({"10", "a", "1.0"}));  // 数值比较而非字典序
+  EXPECT_FALSE(id_gt({"9", "a", "1.0"}));
+  EXPECT_TRUE(CompiledPredicate::compile(columns, "t.id", "=", "5")(
+      std::vector<std::string>{"05", "a", "1.0"}));
+  // 非数值字段不抛异常，按compare_values规则（数值小于字符串）比较
+  EXPECT_TRUE(id_gt({"abc", "a", "1.0"}));
+  EXPECT_FALSE(CompiledPredicate::compile(columns, "id", "<", "9")(
+      std::vector<std::string>{"abc", "a", "1.0"}));
+  // 整数列与小数常量
+  EXPECT_TRUE(CompiledPredicate::compile(columns, "id", ">", "1.5")(
+      std::vector<std::string>{"2", "a", "1.0"}));
+
+  auto name_eq = CompiledPredicate::compile(columns, "name", "=", "'bob'");
+  EXPECT_TRUE(name_eq({"1", "bob", "1.0"}));
+  EXPECT_FALSE(name_eq({"1", "bobby", "1.0"}));
+
+  auto price_le = CompiledPredicate::compile(columns, "price", "<=", "2.5");
+  EXPECT_TRUE(price_le({"1", "a", "2.50"}));
+  EXPECT_FALSE(price_le({"1", "a", "2.6"}));
+
+  Row row;
+  row.values = {Value(int64_t(3)), Value(std::string("bob")), Value(2.0)};
+  EXPECT_TRUE(name_eq(row));
+  EXPECT_TRUE(price_le(row));
+  EXPECT_FALSE(id_gt(row));
+
+  auto combined = CompiledPredicate::all_of(
+      {name_eq, CompiledPredicate::negate(id_gt)});
+  EXPECT_TRUE(combined(row));
+  EXPECT_FALSE(CompiledPredicate::any_of({id_gt, CompiledPredicate::constant(
+                                                     false)})(row));
+  EXPECT_TRUE(CompiledPredicate().always_true());
+
+  EXPECT_THROW(CompiledPredicate::compile(columns, "missing", "=", "1"),
+               Exception);
+  EXPECT_THROW(CompiledPredicate::compile(columns, "id", "LIKE", "1"),
+               Exception);
+}
+
+TEST(PhysicalOperatorTest, CompiledPredicateMatchesCompareValues) {
+  std::vector<ColumnMeta> columns = {MakeColumn("i", "INT"),
+                                     MakeColumn("d", "DOUBLE"),
+                                     MakeColumn("s", "VARCHAR"),
+                                     MakeColumn("x", "")};
+  std::vector<std::string> fields = {"-3", "0",    "7",  "12", "2.5", "abc",
+                                     "b",  "1e3", "-0.5", "",   " 4"};
+  std::vector<std::string> literals = {"0", "7", "2.5", "'b'", "abc", "-3"};
+  std::vector<std::string> ops = {"=", "<>", "<", "<=", ">", ">="};
+
+  for (size_t c = 0; c < columns.size(); ++c) {
+    for (const auto &literal : literals) {
+      // 参照实现：与旧版make_comparison_predicate相同的转换规则
+      bool quoted = literal.front() == '\'';
+      Value constant =
+          quoted ? Value(literal.substr(1, literal.size() - 2))
+                 : parse_value(literal, columns[c].data_type);
+      if (!quoted && columns[c].data_type == "INT" &&
+          constant.type == Value::Type::STRING &&
+          parse_value(literal, "DOUBLE").type == Value::Type::DOUBLE) {
+        constant = parse_value(literal, "DOUBLE");
+      }
+      for (const auto &op : ops) {
+        auto predicate =
+            CompiledPredicate::compile(columns, columns[c].name, op, literal);
+        for (const auto &field : fields) {
+          int cmp =
+              compare_values(parse_value(field, columns[c].data_type), constant);
+          bool expected = op == "="    ? cmp == 0
+                          : op == "<>" ? cmp != 0
+                          : op == "<"  ? cmp < 0
+                          : op == "<=" ? cmp <= 0
+                          : op == ">"  ? cmp > 0
+                                       : cmp >= 0;
+          std::vector<std::string> record(columns.size(), "");
+          record[c] = field;
+          EXPECT_EQ(predicate(record), expected)
+              << columns[c].name << " " << field << " " << op << " " << literal;
+
+          Row row;
+          row.values.assign(columns.size(), Value());
+          row.values[c] = parse_value(field, columns[c].data_type);
+          EXPECT_EQ(predicate(row), expected)
+              << "row " << columns[c].name << " " << field << " " << op << " "
+              << literal;
+        }
+      }
+    }
+  }
+}
+
+TEST(PhysicalOperatorTest, ExternalSortSpillsAndMergesStably) {
+  auto build = [](size_t memory_limit) {
+    std::vector<Row> rows;
+    for (int64_t i = 0; i < 20000; ++i) {
+      rows.push_back(MakeRow(i, "emp" + std::to_string(i), (i * 7919) % 97));
+    }
+    auto sort = std::make_unique<SortOperator>(
+        std::make_unique<ValuesScanOperator>(
+            std::vector<ColumnMeta>{MakeColumn("id", "INT"),
+                                    MakeColumn("name", "VARCHAR"),
+                                    MakeColumn("dept", "INT")},
+            std::move(rows)),
+        std::vector<SortKey>{{"dept", false}});
+    sort->set_memory_limit(memory_limit);
+    return sort;
+  };
+
+  auto in_memory = build(kDefaultOperatorMemoryLimit);
+  ExecutionResult expected = execute_operator_tree(*in_memory);
+  EXPECT_EQ(in_memory->spilled_runs(), 0u);
+
+  // 64KB工作内存只允许4路归并，需要多趟归并
+  auto external = build(64 * 1024);
+  ExecutionResult actual = execute_operator_tree(*external, 100);
+  EXPECT_GT(external->spilled_runs(), 4u);
+  EXPECT_GT(external->merge_passes(), 1u);
+
+  ASSERT_EQ(actual.rows.size(), 20000u);
+  ASSERT_EQ(expected.rows.size(), 20000u);
+  for (size_t i = 0; i < actual.rows.size(); ++i) {
+    ASSERT_EQ(actual.rows[i].values.size(), 3u);
+    // 同一dept内保持输入顺序（id递增）
+    ASSERT_EQ(actual.rows[i].values[0].int_val,
+              expected.rows[i].values[0].int_val)
+        << i;
+    ASSERT_EQ(actual.rows[i].values[1].str_val,
+              expected.rows[i].values[1].str_val);
+    if (i > 0) {
+      const Row &previous = actual.rows[i - 1];
+      ASSERT_GE(previous.values[2].int_val, actual.rows[i].values[2].int_val);
+      if (previous.values[2].int_val == actual.rows[i].values[2].int_val) {
+        ASSERT_LT(previous.values[0].int_val, actual.rows[i].values[0].int_val);
+      }
+    }
+  }
+}
+
+TEST(PhysicalOperatorTest, TopNMatchesSortThenLimit) {
+  auto make_input = []() {
+    std::vector<Row> rows;
+    for (int64_t i = 0; i < 500; ++i) {
+      rows.push_back(MakeRow(i, "emp" + std::to_string(i), (i * 37) % 11));
+    }
+    return std::make_unique<ValuesScanOperator>(
+        std::vector<ColumnMeta>{MakeColumn("id", "INT"),
+                                MakeColumn("name", "VARCHAR"),
+                                MakeColumn("dept", "INT")},
+        std::move(rows));
+  };
+
+  struct Case {
+    bool ascending;
+    size_t limit;
+    size_t offset;
+  };
+  for (const Case &c : {Case{true, 10, 0}, Case{false, 20, 15},
+                        Case{true, 0, 0}, Case{false, 30, 490},
+                        Case{true, 1000, 3}}) {
+    std::vector<SortKey> keys{{"dept", c.ascending}};
+    TopNOperator topn(make_input(), keys, c.limit, c.offset);
+    LimitOperator reference(std::make_unique<SortOperator>(make_input(), keys),
+                            c.limit, c.offset);
+    ExecutionResult expected = execute_operator_tree(reference, 7);
+    ExecutionResult actual = execute_operator_tree(topn, 7);
+    ASSERT_EQ(actual.rows.size(), expected.rows.size());
+    for (size_t i = 0; i < actual.rows.size(); ++i) {
+      EXPECT_EQ(actual.rows[i].values[0].int_val,
+                expected.rows[i].values[0].int_val);
+    }
+  }
+}
+
+TEST(PhysicalOperatorTest, PlanGeneratorBuildsOperatorTree) {
+  sql_parser::SelectStatement stmt;
+  stmt.setTableName("employees");
+  stmt.addSelectColumn("dept");
+  stmt.addSelectColumn("COUNT(*)");
+  stmt.setWhereClause(sql_parser::WhereClause("id", ">=", "20"));
+  stmt.setGroupByColumn("dept");
+  stmt.setOrderByColumn("dept");
+  stmt.setOrderDirection("DESC");
+  stmt.setLimit(2);
+
+  ExecutionPlanGenerator generator;
+  OperatorPtr root = generator.generateOperatorTree(stmt, MakeEmployees(100));
+  std::string plan = root->explain();
+  EXPECT_NE(plan.find("Project(dept, COUNT(*))"), std::string::npos) << plan;
+  EXPECT_NE(plan.find("TopN(dept DESC; limit 2)"), std::string::npos) << plan;
+  EXPECT_EQ(plan.find("Sort("), std::string::npos) << plan;
+  EXPECT_NE(plan.find("Aggregate(group by dept; COUNT(*))"), std::string::npos)
+      << plan;
+  EXPECT_NE(plan.find("Filter(id >= 20)"), std::string::npos) << plan;
+
+  ExecutionResult result = execute_operator_tree(*root);
+  ASSERT_EQ(result.rows.size(), 2u);
+  EXPECT_EQ(result.rows[0].values[0].int_val, 3);
+  EXPECT_EQ(result.rows[0].values[1].int_val, 20);
+  EXPECT_EQ(result.rows[1].values[0].int_val, 2);
+}
+
+TEST(PhysicalOperatorTest, PlanGeneratorAppliesHaving) {
+  sql_parser::SelectStatement stmt;
+  stmt.setTableName("employees");
+  stmt.addSelectColumn("dept");
+  stmt.setGroupByColumn("dept");
+  stmt.setHavingClause(sql_parser::WhereClause("SUM(id)", ">", "1200"));
+  ASSERT_TRUE(stmt.hasHavingClause());
+
+  ExecutionPlanGenerator generator;
+  OperatorPtr root = generator.generateOperatorTree(stmt, MakeEmployees(100));
+  std::string plan = root->explain();
+  EXPECT_NE(plan.find("having SUM(id) > 1200"), std::string::npos) << plan;
+
+  // dept d 的 SUM(id) = 1200 + 25 * d
+  ExecutionResult result = execute_operator_tree(*root);
+  ASSERT_EQ(result.rows.size(), 3u);
+  ASSERT_EQ(result.rows[0].values.size(), 1u);
+  EXPECT_EQ(result.rows[0].values[0].int_val, 1);
+}
+
+namespace {
+
+WindowSpec ParseWindow(const std::string &expr) {
+  WindowSpec spec;
+  EXPECT_TRUE(ExecutionPlanGenerator::parseWindowFunction(expr, spec)) << expr;
+  return spec;
+}
+
+} // namespace
+
+TEST(PhysicalOperatorTest, WindowFunctionsShareSorts) {
+  // dept = id % 4：dept 0 = {0,4,8}，1 = {1,5,9}，2 = {2,6}，3 = {3,7}
+  std::vector<WindowSpec> specs = {
+      ParseWindow("ROW_NUMBER() OVER (PARTITION BY dept ORDER BY id DESC)"),
+      ParseWindow("LAG(id, 1, -1) OVER (PARTITION BY dept ORDER BY id DESC)"),
+      ParseWindow("RANK() OVER (ORDER BY dept)"),
+      ParseWindow("DENSE_RANK() OVER (ORDER BY dept)"),
+      ParseWindow("SUM(id) OVER (ORDER BY dept)"),
+      ParseWindow("LEAD(name) OVER (PARTITION BY dept ORDER BY id DESC)")};
+  WindowOperator window(MakeEmployees(10), specs);
+  ASSERT_EQ(window.output_columns().size(), 9u);
+  EXPECT_EQ(window.output_columns()[3].name, specs[0].alias);
+  EXPECT_EQ(window.output_columns()[7].data_type, "INT");
+
+  ExecutionResult result = execute_operator_tree(window, 3);
+  ASSERT_EQ(result.rows.size(), 10u);
+  // 两组窗口定义各排序一次
+  EXPECT_EQ(window.sorts_performed(), 2u);
+
+  const std::map<int64_t, std::vector<int64_t>> expected = {
+      // id: row_number, lag, rank, dense_rank, running sum
+      {8, {1, -1, 1, 1, 12}}, {4, {2, 8, 1, 1, 12}}, {0, {3, 4, 1, 1, 12}},
+      {9, {1, -1, 4, 2, 27}}, {5, {2, 9, 4, 2, 27}}, {1, {3, 5, 4, 2, 27}},
+      {6, {1, -1, 7, 3, 35}}, {2, {2, 6, 7, 3, 35}}, {7, {1, -1, 9, 4, 45}},
+      {3, {2, 7, 9, 4, 45}}};
+  for (const auto &row : result.rows) {
+    int64_t id = row.values[0].int_val;
+    const auto &want = expected.at(id);
+    for (size_t i = 0; i < want.size(); ++i) {
+      EXPECT_EQ(row.values[3 + i].int_val, want[i]) << "id " << id << " #" << i;
+    }
+  }
+  // 按第一组的顺序输出：dept升序、组内id降序
+  EXPECT_EQ(result.rows[0].values[0].int_val, 8);
+  EXPECT_EQ(result.rows[0].values[8].str_val, "emp4");
+  EXPECT_EQ(result.rows[2].values[8].int_val, 0);
+}
+
+TEST(PhysicalOperatorTest, WindowSlidingFramesMatchBruteForce) {
+  std::vector<Row> rows;
+  for (int64_t i = 0; i < 500; ++i) {
+    Row row;
+    row.values = {Value(i), Value((i * 7919) % 101 - 50), Value(i % 3)};
+    rows.push_back(row);
+  }
+  auto source = [&rows]() {
+    return std::make_unique<ValuesScanOperator>(
+        std::vector<ColumnMeta>{MakeColumn("id", "INT"),
+                                MakeColumn("v", "INT"), MakeColumn("g", "INT")},
+        rows);
+  };
+
+  const std::vector<std::string> frames = {
+      "ROWS BETWEEN 3 PRECEDING AND CURRENT ROW",
+      "ROWS BETWEEN 2 PRECEDING AND 4 FOLLOWING",
+      "ROWS BETWEEN 1 FOLLOWING AND 3 FOLLOWING",
+      "ROWS BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING",
+      "ROWS 5 PRECEDING"};
+  const std::vector<std::string> functions = {"SUM(v)", "COUNT(*)", "MIN(v)",
+                                              "MAX(v)", "AVG(v)"};
+  std::vector<WindowSpec> specs;
+  for (const auto &frame : frames) {
+    for (const auto &function : functions) {
+      specs.push_back(ParseWindow(function + " OVER (PARTITION BY g ORDER BY id " +
+                                  frame + ")"));
+    }
+  }
+  WindowOperator window(source(), specs);
+  ExecutionResult result = execute_operator_tree(window);
+  ASSERT_EQ(result.rows.size(), rows.size());
+  EXPECT_EQ(window.sorts_performed(), 1u);
+
+  // 每个分区内按id升序，第p行的值
+  std::map<int64_t, std::vector<int64_t>> partitions;
+  for (const auto &row : rows) {
+    partitions[row.values[2].int_val].push_back(row.values[1].int_val);
+  }
+  for (const auto &row : result.rows) {
+    const auto &values = partitions[row.values[2].int_val];
+    int64_t p = row.values[0].int_val / 3;
+    int64_t n = static_cast<int64_t>(values.size());
+    for (size_t s = 0; s < specs.size(); ++s) {
+      const WindowSpec &spec = specs[s];
+      int64_t begin = spec.frame_start == WindowSpec::kUnboundedPreceding
+                          ? 0
+                          : std::max<int64_t>(0, p + spec.frame_start);
+      int64_t end = spec.frame_end == WindowSpec::kUnboundedFollowing
+                        ? n
+                        : std::min<int64_t>(n, p + spec.frame_end + 1);
+      int64_t count = 0, sum = 0, min = 0, max = 0;
+      for (int64_t i = begin; i < end; ++i) {
+        min = count == 0 ? values[i] : std::min(min, values[i]);
+        max = count == 0 ? values[i] : std::max(max, values[i]);
+        sum += values[i];
+        count++;
+      }
+      const Value &actual = row.values[3 + s];
+      SCOPED_TRACE(spec.alias + " at id " + std::to_string(row.values[0].int_val));
+      switch (spec.function) {
+      case WindowSpec::SUM:
+        EXPECT_EQ(actual.int_val, sum);
+        break;
+      case WindowSpec::COUNT:
+        EXPECT_EQ(actual.int_val, count);
+        break;
+      case WindowSpec::MIN:
+        EXPECT_EQ(actual.int_val, min);
+        break;
+      case WindowSpec::MAX:
+        EXPECT_EQ(actual.int_val, max);
+        break;
+      default:
+        EXPECT_DOUBLE_EQ(actual.double_val,
+                         count == 0 ? 0.0 : static_cast<double>(sum) / count);
+        break;
+      }
+    }
+  }
+}
+
+TEST(PhysicalOperatorTest, PlanGeneratorAddsWindowOperator) {
+  sql_parser::SelectStatement stmt;
+  stmt.setTableName("employees");
+  stmt.addSelectColumn("id");
+  stmt.addSelectColumn("SUM(id) OVER (PARTITION BY dept ORDER BY id)");
+  stmt.setOrderByColumn("id");
+
+  // 窗口函数不能被当成普通聚合
+  AggregateSpec aggregate;
+  EXPECT_FALSE(ExecutionPlanGenerator::parseAggregate(
+      "SUM(id) OVER (PARTITION BY dept ORDER BY id)", aggregate));
+  WindowSpec spec;
+  EXPECT_FALSE(ExecutionPlanGenerator::parseWindowFunction("SUM(id)", spec));
+  EXPECT_THROW(ExecutionPlanGenerator::parseWindowFunction(
+                   "NTILE(4) OVER (ORDER BY id)", spec),
+               Exception);
+
+  ExecutionPlanGenerator generator;
+  OperatorPtr root = generator.generateOperatorTree(stmt, MakeEmployees(8));
+  std::string plan = root->explain();
+  EXPECT_NE(plan.find("Window("), std::string::npos) << plan;
+  EXPECT_EQ(plan.find("Aggregate"), std::string::npos) << plan;
+
+  ExecutionResult result = execute_operator_tree(*root);
+  ASSERT_EQ(result.rows.size(), 8u);
+  ASSERT_EQ(result.rows[0].values.size(), 2u);
+  // id 4 在dept 0中的累计和为 0 + 4
+  EXPECT_EQ(result.rows[4].values[1].int_val, 4);
+  EXPECT_EQ(result.rows[7].values[1].int_val, 10);
+}
+
+namespace {
+
+// 以内存中的键->位置表代替B+树索引和表存储
+class FakeIndexJoinOperator : public IndexNestedLoopJoinOperator {
+public:
+  FakeIndexJoinOperator(OperatorPtr outer, std::shared_ptr<TableMetadata> meta,
+                        JoinType type)
+      : IndexNestedLoopJoinOperator(std::move(outer), nullptr, "departments",
+                                    std::move(meta), nullptr, "dept", type) {
+    // 每页4条记录，只有dept 0和2有对应记录，dept 2有两条
+    add("0", {"0", "sales"}, 0, 0);
+    add("2", {"2", "hr"}, 5, 1);
+    add("2", {"2", "hr-annex"}, 9, 3);
+  }
+
+  mutable size_t fetches = 0;
+
+protected:
+  std::vector<IndexEntry> lookup(const std::string &key) const override {
+    auto it = index_.find(key);
+    return it == index_.end() ? std::vector<IndexEntry>{} : it->second;
+  }
+  std::vector<std::string> fetch(int32_t page_id,
+                                 size_t offset) const override {
+    fetches++;
+    return records_.at({page_id, offset});
+  }
+
+private:
+  void add(const std::string &key, std::vector<std::string> record,
+           int32_t page_id, size_t offset) {
+    index_[key].emplace_back(key, page_id, offset);
+    records_[{page_id, offset}] = std::move(record);
+  }
+
+  std::map<std::string, std::vector<IndexEntry>> index_;
+  std::map<std::pair<int32_t, size_t>, std::vector<std::string>> records_;
+};
+
+// 以有序的内存索引代替B+树，记录直接由键生成，id作为INCLUDE列保存在条目中
+class FakeIndexOrderScan : public IndexOrderScanOperator {
+public:
+  FakeIndexOrderScan(std::shared_ptr<TableMetadata> meta,
+                     std::vector<std::string> keys)
+      : IndexOrderScanOperator(std::make_shared<TableStorageManager>(nullptr),
+                               "people", std::move(meta), nullptr, "name") {
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      entries_.emplace_back(keys[i], static_cast<int32_t>(i), i,
+                            std::vector<std::string>{std::to_string(i)});
+    }
+  }
+
+  mutable size_t records_read = 0;
+
+protected:
+  std::vector<IndexEntry> scan_index(const std::string &lower_bound,
+                                     size_t max_entries) const override {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(),
+                               IndexEntry(lower_bound, 0, 0));
+    std::vector<IndexEntry> result;
+    for (; it != entries_.end() && result.size() < max_entries; ++it) {
+      result.push_back(*it);
+    }
+    return result;
+  }
+  std::vector<std::string> read_record(int32_t page_id,
+                                       size_t) const override {
+    records_read++;
+    return {std::to_string(page_id), entries_[page_id].key};
+  }
+
+private:
+  std::vector<IndexEntry> entries_;
+};
+
+std::shared_ptr<TableMetadata> MakePeopleMetadata() {
+  auto meta = std::make_shared<TableMetadata>();
+  meta->table_name = "people";
+  meta->columns = {{"id", "INT", 8, false, ""},
+                   {"name", "VARCHAR", 32, true, ""}};
+  return meta;
+}
+
+std::shared_ptr<TableMetadata> MakeDepartmentMetadata() {
+  auto meta = std::make_shared<TableMetadata>();
+  meta->table_name = "departments";
+  meta->columns = {{"dept_id", "INT", 8, false, ""},
+                   {"dept_name", "VARCHAR", 32, true, ""}};
+  return meta;
+}
+
+} // namespace
+
+TEST(PhysicalOperatorTest, SemiAndAntiJoinEmitOuterRowsOnce) {
+  auto run = [](bool anti) {
+    SemiJoinOperator join(MakeEmployees(8), MakeDepartments(), "dept",
+                          "dept_id", anti);
+    return execute_operator_tree(join, 3);
+  };
+
+  ExecutionResult semi = run(false);
+  ASSERT_EQ(semi.rows.size(), 4u);
+  EXPECT_EQ(semi.column_metadata.size(), 3u);
+  for (const auto &row : semi.rows) {
+    EXPECT_LT(row.values[2].int_val, 2);
+  }
+  ExecutionResult anti = run(true);
+  ASSERT_EQ(anti.rows.size(), 4u);
+  for (const auto &row : anti.rows) {
+    EXPECT_GE(row.values[2].int_val, 2);
+  }
+}
+
+namespace {
+
+sql_parser::SelectStatement MakeSubquery(const std::string &table,
+                                         const std::string &column,
+                                         const sql_parser::WhereClause &where) {
+  sql_parser::SelectStatement stmt;
+  stmt.setTableName(table);
+  if (column == "*") {
+    stmt.setSelectAll(true);
+  } else {
+    stmt.addSelectColumn(column);
+  }
+  stmt.setWhereClause(where);
+  return stmt;
+}
+
+std::unique_ptr<SubqueryExecutor> MakeSubqueryExecutor(size_t &scans) {
+  auto executor = std::make_unique<SubqueryExecutor>(nullptr, nullptr, nullptr,
+                                                     ExecutionContext());
+  executor->set_source_provider([&scans](const std::string &table) {
+    scans++;
+    return table == "employees" ? OperatorPtr(MakeEmployees(8))
+                                : OperatorPtr(MakeDepartments());
+  });
+  return executor;
+}
+
+} // namespace
+
+TEST(PhysicalOperatorTest, SubqueriesDecorrelateIntoJoins) {
+  size_t scans = 0;
+  auto executor = MakeSubqueryExecutor(scans);
+
+  // EXISTS (SELECT * FROM departments WHERE dept_id = e.dept)
+  auto exists = MakeSubquery("departments", "*", {"dept_id", "=", "e.dept"});
+  OperatorPtr plan = executor->plan_subquery_predicate(
+      MakeEmployees(8), "e", {SubqueryPredicate::EXISTS, "", "", &exists});
+  EXPECT_EQ(plan->describe(), "SemiJoin(e.dept = dept_id)");
+  EXPECT_EQ(execute_operator_tree(*plan).rows.size(), 4u);
+
+  // dept NOT IN (SELECT dept_id FROM departments WHERE dept_id < 5)
+  auto in = MakeSubquery("departments", "dept_id", {"dept_id", "<", "5"});
+  plan = executor->plan_subquery_predicate(
+      MakeEmployees(8), "e", {SubqueryPredicate::NOT_IN, "dept", "", &in});
+  EXPECT_EQ(plan->describe(), "AntiJoin(dept = dept_id)");
+  ExecutionResult not_in = execute_operator_tree(*plan);
+  ASSERT_EQ(not_in.rows.size(), 4u);
+  EXPECT_EQ(not_in.rows[0].values[2].int_val, 2);
+
+  // id > (SELECT AVG(id) FROM employees WHERE dept = e1.dept)
+  // 每个dept有id为d和d+4的两名员工，平均值为d+2
+  auto scalar = MakeSubquery("employees", "AVG(id)", {"dept", "=", "e1.dept"});
+  plan = executor->plan_subquery_predicate(
+      MakeEmployees(8), "e1", {SubqueryPredicate::SCALAR, "id", ">", &scalar});
+  EXPECT_NE(plan->explain().find("HashJoin(Inner"), std::string::npos);
+  ExecutionResult above_average = execute_operator_tree(*plan);
+  ASSERT_EQ(above_average.rows.size(), 4u);
+  EXPECT_EQ(above_average.column_metadata.size(), 3u);
+  for (const auto &row : above_average.rows) {
+    EXPECT_GE(row.values[0].int_val, 4);
+  }
+
+  // COUNT在没有匹配时为0：id >= (SELECT COUNT(*) FROM departments WHERE
+  // dept_id = e.dept)，只有id 0（dept 0计数为1）不满足
+  auto count =
+      MakeSubquery("departments", "COUNT(*)", {"dept_id", "=", "e.dept"});
+  plan = executor->plan_subquery_predicate(
+      MakeEmployees(8), "e", {SubqueryPredicate::SCALAR, "id", ">=", &count});
+  EXPECT_NE(plan->explain().find("HashJoin(Left"), std::string::npos);
+  EXPECT_EQ(execute_operator_tree(*plan).rows.size(), 7u);
+
+  // 每个子查询的内表只扫描一次，没有逐行执行
+  EXPECT_EQ(executor->subquery_executions(), 0u);
+}
+
+TEST(PhysicalOperatorTest, CorrelatedSubqueryResultsAreMemoized) {
+  size_t scans = 0;
+  auto executor = MakeSubqueryExecutor(scans);
+
+  // 非等值相关条件无法改写为连接：
+  // EXISTS (SELECT * FROM departments WHERE dept_id > e.dept)
+  auto exists = MakeSubquery("departments", "*", {"dept_id", ">", "e.dept"});
+  OperatorPtr plan = executor->plan_subquery_predicate(
+      MakeEmployees(8), "e", {SubqueryPredicate::EXISTS, "", "", &exists});
+  EXPECT_NE(plan->describe().find("memoized"), std::string::npos);
+  EXPECT_EQ(execute_operator_tree(*plan).rows.size(), 8u);
+  // 8个外层行只有4个不同的dept
+  EXPECT_EQ(executor->subquery_executions(), 4u);
+  EXPECT_EQ(executor->cache_hits(), 4u);
+
+  // 逐行接口同样使用缓存，绑定后的条件为 dept_id > 3
+  Row outer = MakeRow(3, "emp3", 3);
+  EXPECT_TRUE(executor->execute_exists_subquery(
+      std::make_unique<sql_parser::SelectStatement>(exists), outer));
+  EXPECT_EQ(executor->subquery_executions(), 4u);
+  auto correlation = executor->find_correlation(exists);
+  ASSERT_TRUE(correlation.has_value());
+  EXPECT_EQ(correlation->inner_column, "dept_id");
+  EXPECT_EQ(correlation->outer_column, "e.dept");
+
+  // 内层同名列不是相关引用
+  auto self = MakeSubquery("employees", "*", {"id", "=", "dept"});
+  executor->set_outer_scope("employees", MakeEmployees(1)->output_columns());
+  EXPECT_FALSE(executor->find_correlation(self).has_value());
+}
+
+TEST(PhysicalOperatorTest, IndexNestedLoopJoinProbesPerBatch) {
+  FakeIndexJoinOperator join(MakeEmployees(8), MakeDepartmentMetadata(),
+                             JoinType::INNER_JOIN);
+  ASSERT_EQ(join.output_columns().size(), 5u);
+
+  ExecutionResult result = execute_operator_tree(join, 4);
+  // dept 0: id 0, 4；dept 2: id 2, 6，各匹配两条记录
+  ASSERT_EQ(result.rows.size(), 6u);
+  EXPECT_EQ(result.rows[0].values[0].int_val, 0);
+  EXPECT_EQ(result.rows[0].values[4].str_val, "sales");
+  EXPECT_EQ(result.rows[1].values[4].str_val, "hr");
+  EXPECT_EQ(result.rows[2].values[4].str_val, "hr-annex");
+  EXPECT_EQ(result.rows[1].values[3].int_val, 2);
+
+  // 两个批次各有4个不同的键，每批每个键只查找一次索引
+  EXPECT_EQ(join.index_lookups(), 8u);
+  // 只读取匹配记录所在的页
+  EXPECT_EQ(join.pages_touched(), 6u);
+  EXPECT_EQ(join.fetches, 6u);
+}
+
+TEST(PhysicalOperatorTest, IndexNestedLoopLeftJoinAndPlanning) {
+  FakeIndexJoinOperator join(MakeEmployees(4), MakeDepartmentMetadata(),
+                             JoinType::LEFT_JOIN);
+  ExecutionResult result = execute_operator_tree(join);
+  ASSERT_EQ(result.rows.size(), 5u);
+  EXPECT_EQ(result.rows[1].values[0].int_val, 1);
+  EXPECT_EQ(result.rows[1].values[4].str_val, "");
+
+  EXPECT_THROW(FakeIndexJoinOperator(MakeEmployees(1),
+                                     MakeDepartmentMetadata(),
+                                     JoinType::FULL_JOIN),
+               Exception);
+
+  // 内表不是带索引的表扫描时退回哈希连接
+  OperatorPtr planned =
+      plan_join(MakeEmployees(8), 8, MakeDepartments(), 3, nullptr,
+                JoinType::INNER_JOIN, "dept = dept_id");
+  EXPECT_NE(planned->describe().find("HashJoin"), std::string::npos);
+}
+
+TEST(PhysicalOperatorTest, IndexOrderScanStopsAfterLimit) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < 1000; ++i) {
+    keys.push_back("name" + std::to_string(i % 300));
+  }
+  auto make_scan = [&]() {
+    return std::make_unique<FakeIndexOrderScan>(MakePeopleMetadata(), keys);
+  };
+
+  // 完整扫描按键有序且重复键跨块时不会重复或遗漏
+  auto full = make_scan();
+  ExecutionResult all = execute_operator_tree(*full, 4);
+  ASSERT_EQ(all.rows.size(), 1000u);
+  for (size_t i = 1; i < all.rows.size(); ++i) {
+    ASSERT_LE(all.rows[i - 1].values[1].str_val, all.rows[i].values[1].str_val);
+  }
+  EXPECT_EQ(full->entries_read(), 1000u);
+
+  // ORDER BY name LIMIT 5：不排序，只读取前几块索引条目
+  sql_parser::SelectStatement stmt;
+  stmt.setTableName("people");
+  stmt.setSelectAll(true);
+  stmt.setOrderByColumn("name");
+  stmt.setLimit(5);
+  auto source = make_scan();
+  FakeIndexOrderScan *scan = source.get();
+  ExecutionPlanGenerator generator;
+  OperatorPtr root = generator.generateOperatorTree(stmt, std::move(source));
+  std::string plan = root->explain();
+  EXPECT_EQ(plan.find("TopN"), std::string::npos) << plan;
+  EXPECT_NE(plan.find("IndexOrderScan(people, name ASC)"), std::string::npos)
+      << plan;
+
+  ExecutionResult result = execute_operator_tree(*root);
+  ASSERT_EQ(result.rows.size(), 5u);
+  EXPECT_EQ(result.rows[0].values[1].str_val, "name0");
+  EXPECT_EQ(result.rows[4].values[1].str_val, "name1");
+  EXPECT_LE(scan->entries_read(), 5u);
+  EXPECT_LE(scan->records_read, 5u);
+
+  // 降序不能使用索引顺序，回退到Top-N
+  stmt.setOrderDirection("DESC");
+  root = generator.generateOperatorTree(stmt, make_scan());
+  EXPECT_NE(root->explain().find("TopN(name DESC; limit 5)"),
+            std::string::npos);
+}
+
+TEST(PhysicalOperatorTest, IndexOnlyScanSkipsHeap) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < 200; ++i) {
+    keys.push_back("name" + std::to_string(i % 70));
+  }
+  FakeIndexOrderScan heap(MakePeopleMetadata(), keys);
+  ExecutionResult expected = execute_operator_tree(heap, 8);
+  ASSERT_EQ(expected.rows.size(), 200u);
+
+  // 索引(name) INCLUDE (id)覆盖全部列：结果与回表相同，不读取记录
+  FakeIndexOrderScan covering(MakePeopleMetadata(), keys);
+  covering.set_index_only("name", {"id"});
+  EXPECT_EQ(covering.describe(), "IndexOnlyOrderScan(people, name ASC)");
+  ASSERT_EQ(covering.output_columns().size(), 2u);
+  ExecutionResult result = execute_operator_tree(covering, 8);
+  EXPECT_EQ(covering.records_read, 0u);
+  ASSERT_EQ(result.rows.size(), expected.rows.size());
+  for (size_t i = 0; i < result.rows.size(); ++i) {
+    EXPECT_EQ(result.rows[i].values[0].type, Value::Type::INT);
+    EXPECT_EQ(result.rows[i].values[0].int_val,
+              expected.rows[i].values[0].int_val);
+    EXPECT_EQ(result.rows[i].values[1].str_val,
+              expected.rows[i].values[1].str_val);
+  }
+
+  // 只用键列时输出列只剩name
+  FakeIndexOrderScan key_only(MakePeopleMetadata(), keys);
+  key_only.set_index_only("name", {});
+  ASSERT_EQ(key_only.output_columns().size(), 1u);
+  EXPECT_EQ(key_only.output_columns()[0].name, "name");
+  EXPECT_EQ(execute_operator_tree(key_only, 8).rows.size(), 200u);
+  EXPECT_EQ(key_only.records_read, 0u);
+  EXPECT_THROW(key_only.set_index_only("missing", {}), Exception);
+}
+
+namespace {
+
+ExecutionResult RunWithParallelDegree(const sql_parser::SelectStatement &stmt,
+                                      size_t dop, std::string *plan = nullptr) {
+  ExecutionPlanGenerator generator;
+  generator.setParallelDegree(dop);
+  generator.setWorkMem(64 * 1024);
+  OperatorPtr root = generator.generateOperatorTree(
+      stmt, std::make_unique<MemoryTableScan>(5000));
+  if (plan) {
+    *plan = root->explain();
+  }
+  return execute_operator_tree(*root);
+}
+
+} // namespace
+
+TEST(PhysicalOperatorTest, MorselQueueSplitsByPage) {
+  MorselQueue queue(2);
+  // 5个页，每个morsel两页
+  queue.reset({7, 8, 9, 12, 13});
+  ASSERT_EQ(queue.morsel_count(), 3u);
+  size_t begin = 0, end = 0;
+  ASSERT_TRUE(queue.next(begin, end));
+  EXPECT_EQ(begin, 0u);
+  EXPECT_EQ(end, 2u);
+  ASSERT_TRUE(queue.next(begin, end));
+  EXPECT_EQ(begin, 2u);
+  EXPECT_EQ(end, 4u);
+  EXPECT_EQ(queue.page(begin), 9);
+  ASSERT_TRUE(queue.next(begin, end));
+  EXPECT_EQ(begin, 4u);
+  EXPECT_EQ(end, 5u);
+  EXPECT_EQ(queue.page(begin), 13);
+  EXPECT_FALSE(queue.next(begin, end));
+
+  queue.reset({});
+  EXPECT_EQ(queue.morsel_count(), 0u);
+  EXPECT_FALSE(queue.next(begin, end));
+}
+
+TEST(PhysicalOperatorTest, ExchangeGathersAllMorsels) {
+  std::atomic<size_t> pipelines{0};
+  ExchangeOperator exchange(
+      std::make_unique<CountingTableScan>(5000),
+      [&](OperatorPtr source) {
+        pipelines++;
+        return source;
+      },
+      4);
+  EXPECT_EQ(pipelines.load(), 4u);
+  EXPECT_EQ(exchange.describe(), "Gather(dop=4)");
+
+  BufferUsage before = thread_buffer_usage();
+  ExecutionResult result = execute_operator_tree(exchange, 7);
+  EXPECT_GT(exchange.morsel_count(), 4u);
+  EXPECT_EQ(exchange.workers_started(), 4u);
+  // 调用线程不读取数据页，500个页由工作线程各读取一次
+  EXPECT_EQ((thread_buffer_usage() - before).hits, 0u);
+  EXPECT_EQ(exchange.worker_buffer_usage().hits, 500u);
+  // 每条未删除的记录恰好输出一次
+  std::vector<int64_t> ids;
+  for (const auto &row : result.rows) {
+    ids.push_back(row.values[0].int_val);
+  }
+  std::sort(ids.begin(), ids.end());
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < 5000; ++i) {
+    if (i % 17 != 3) {
+      expected.push_back(i);
+    }
+  }
+  EXPECT_EQ(ids, expected);
+
+  // LIMIT满足后关闭，工作线程被取消而不是读完整张表
+  LimitOperator limit(std::make_unique<ExchangeOperator>(
+                          std::make_unique<MemoryTableScan>(5000),
+                          [](OperatorPtr source) { return source; }, 4),
+                      5, 0);
+  EXPECT_EQ(execute_operator_tree(limit).rows.size(), 5u);
+}
+
+TEST(PhysicalOperatorTest, ParallelAggregateMatchesSerial) {
+  sql_parser::SelectStatement stmt;
+  stmt.setTableName("sales");
+  for (const char *column : {"region", "COUNT(*)", "SUM(amount)", "MIN(id)",
+                             "MAX(id)", "AVG(amount)", "COUNT(amount)"}) {
+    stmt.addSelectColumn(column);
+  }
+  stmt.setWhereClause(sql_parser::WhereClause("id", ">=", "100"));
+  stmt.setGroupByColumn("region");
+  stmt.setHavingClause(sql_parser::WhereClause("SUM(id)", ">", "0"));
+  stmt.setOrderByColumn("region");
+
+  std::string plan;
+  ExecutionResult parallel = RunWithParallelDegree(stmt, 4, &plan);
+  EXPECT_NE(plan.find("FinalAggregate(group by region;"), std::string::npos)
+      << plan;
+  EXPECT_NE(plan.find("Gather(dop=4)"), std::string::npos) << plan;
+  EXPECT_NE(plan.find("PartialAggregate(group by region;"), std::string::npos)
+      << plan;
+  EXPECT_NE(plan.find("Filter(id >= 100)"), std::string::npos) << plan;
+  EXPECT_NE(plan.find("MorselScan(sales)"), std::string::npos) << plan;
+
+  ExecutionResult serial = RunWithParallelDegree(stmt, 1, &plan);
+  EXPECT_EQ(plan.find("Gather"), std::string::npos) << plan;
+  ASSERT_EQ(serial.rows.size(), 5u);
+  ASSERT_EQ(parallel.rows.size(), serial.rows.size());
+  ASSERT_EQ(parallel.column_metadata.size(), serial.column_metadata.size());
+  for (size_t c = 0; c < serial.column_metadata.size(); ++c) {
+    EXPECT_EQ(parallel.column_metadata[c].name,
+              serial.column_metadata[c].name);
+    EXPECT_EQ(parallel.column_metadata[c].data_type,
+              serial.column_metadata[c].data_type);
+  }
+  for (size_t r = 0; r < serial.rows.size(); ++r) {
+    for (size_t c = 0; c < serial.rows[r].values.size(); ++c) {
+      const Value &expected = serial.rows[r].values[c];
+      const Value &actual = parallel.rows[r].values[c];
+      if (expected.type == Value::Type::DOUBLE) {
+        EXPECT_NEAR(actual.double_val, expected.double_val, 1e-6);
+      } else {
+        EXPECT_EQ(compare_values(actual, expected), 0)
+            << "row " << r << " column " << c;
+      }
+    }
+  }
+
+  // 没有GROUP BY且过滤后为空：各线程的部分状态为空，仍输出一行
+  sql_parser::SelectStatement empty;
+  empty.setTableName("sales");
+  empty.addSelectColumn("COUNT(*)");
+  empty.addSelectColumn("MAX(amount)");
+  empty.setWhereClause(sql_parser::WhereClause("id", "<", "0"));
+  ExecutionResult none = RunWithParallelDegree(empty, 4);
+  ASSERT_EQ(none.rows.size(), 1u);
+  EXPECT_EQ(none.rows[0].values[0].int_val, 0);
+}
+
+// 区域映射由内存中的记录生成，不经过存储引擎
+class ZoneMappedScan : public CountingTableScan {
+public:
+  explicit ZoneMappedScan(size_t rows) : CountingTableScan(rows) {
+    for (size_t i = 0; i < rows; ++i) {
+      int32_t page_id = static_cast<int32_t>(i / 10);
+      zones_.AddRecord(page_id, MemoryTableScan::read_record(page_id, i % 10),
+                       metadata_->columns);
+    }
+  }
+
+protected:
+  bool page_may_match(int32_t page_id) const override {
+    return zones_.PageMayMatch(page_id, zone_column_,
+                               columns_[zone_column_].data_type, zone_op_,
+                               zone_value_);
+  }
+
+private:
+  ZoneMapIndex zones_;
+};
+
+TEST(PhysicalOperatorTest, ZoneMapSkipsPagesOutsideRange) {
+  auto make_filter = [](std::unique_ptr<TableScanOperator> scan,
+                        bool parallel) {
+    CompiledPredicate predicate =
+        CompiledPredicate::compile(scan->output_columns(), "id", ">=", "950");
+    OperatorPtr source = std::move(scan);
+    if (parallel) {
+      std::unique_ptr<TableScanOperator> table_scan(
+          static_cast<TableScanOperator *>(source.release()));
+      source = std::make_unique<ExchangeOperator>(
+          std::move(table_scan), [](OperatorPtr input) { return input; }, 4);
+    }
+    return std::make_unique<FilterOperator>(std::move(source),
+                                            std::move(predicate), "id >= 950");
+  };
+
+  auto full_scan = make_filter(std::make_unique<MemoryTableScan>(1000), false);
+  size_t expected = execute_operator_tree(*full_scan).rows.size();
+  EXPECT_GT(expected, 0u);
+  for (bool parallel : {false, true}) {
+    auto scan = std::make_unique<ZoneMappedScan>(1000);
+    scan->set_zone_filter("id", ">=", "950");
+    const TableScanOperator *scan_ptr = scan.get();
+    auto filter = make_filter(std::move(scan), parallel);
+    BufferUsage before = thread_buffer_usage();
+    EXPECT_EQ(execute_operator_tree(*filter).rows.size(), expected);
+    EXPECT_EQ(scan_ptr->pages_skipped(), 95u);
+    EXPECT_NE(scan_ptr->describe().find("pages skipped=95"), std::string::npos)
+        << scan_ptr->describe();
+    if (!parallel) {
+      // 只固定未被排除的5个页
+      EXPECT_EQ((thread_buffer_usage() - before).hits, 5u);
+    }
+  }
+}
@@ -0,0 +1,148 @@
+/**
+ * @file result_cache_test.cpp
+ * @brief 查询结果缓存单元测试
+ */
+
+#include "execution/result_cache.h"
+#include <gtest/gtest.h>
+
+using namespace sqlcc;
+
+namespace {
+
+ExecutionResult make_result(const std::string &message, size_t rows = 1) {
+  ExecutionResult result(true, message);
+  for (size_t i = 0; i < rows; ++i) {
+    Row row;
+    row.values = {Value(static_cast<int64_t>(i)), Value(std::string(64, 'x'))};
+    result.add_row(row);
+  }
+  return result;
+}
+
+void put(QueryResultCache &cache, const std::string &key,
+         const std::vector<std::string> &tables, ExecutionResult result) {
+  cache.insert(key, "db", tables, cache.table_versions("db", tables),
+               std::move(result));
+}
+
+} // namespace
+
+TEST(ResultCacheTest, NormalizesWhitespaceOutsideLiterals) {
+  EXPECT_EQ(QueryResultCache::normalize_sql(
+                "SELECT  a ,b\n FROM t WHERE ( a = 1 ) ;"),
+            "SELECT a,b FROM t WHERE(a=1)");
+  EXPECT_EQ(QueryResultCache::normalize_sql("SELECT 'a  b' FROM t"),
+            "SELECT 'a  b' FROM t");
+  EXPECT_EQ(QueryResultCache::make_key("db", "u", "SELECT * FROM t;"),
+            QueryResultCache::make_key("db", "u", "SELECT *   FROM t"));
+  EXPECT_NE(QueryResultCache::make_key("db", "u1", "SELECT * FROM t"),
+            QueryResultCache::make_key("db", "u2", "SELECT * FROM t"));
+}
+
+TEST(ResultCacheTest, CountsHitsAndMisses) {
+  QueryResultCache cache;
+  EXPECT_EQ(cache.lookup("k"), nullptr);
+  put(cache, "k", {"t"}, make_result("ok", 3));
+
+  auto hit = cache.lookup("k");
+  ASSERT_NE(hit, nullptr);
+  EXPECT_EQ(hit->message, "ok");
+  EXPECT_EQ(hit->row_count(), 3u);
+
+  auto stats = cache.stats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.inserts, 1u);
+  EXPECT_EQ(stats.entries, 1u);
+  EXPECT_GT(stats.bytes, 0u);
+}
+
+TEST(ResultCacheTest, TableModificationInvalidatesDependents) {
+  QueryResultCache cache;
+  put(cache, "a", {"t1"}, make_result("a"));
+  put(cache, "b", {"t1", "t2"}, make_result("b"));
+  put(cache, "c", {"t2"}, make_result("c"));
+
+  cache.invalidate_table("db", "T1");
+  EXPECT_EQ(cache.lookup("a"), nullptr);
+  EXPECT_EQ(cache.lookup("b"), nullptr);
+  EXPECT_NE(cache.lookup("c"), nullptr);
+  EXPECT_EQ(cache.stats().invalidations, 2u);
+
+  // 其他数据库中的同名表不影响
+  cache.invalidate_table("other", "t2");
+  EXPECT_NE(cache.lookup("c"), nullptr);
+}
+
+TEST(ResultCacheTest, SkipsResultsOfConcurrentlyModifiedTables) {
+  QueryResultCache cache;
+  auto versions = cache.table_versions("db", {"t"});
+  cache.invalidate_table("db", "t"); // 查询执行期间表被修改
+  cache.insert("k", "db", {"t"}, versions, make_result("stale"));
+  EXPECT_EQ(cache.lookup("k"), nullptr);
+  EXPECT_EQ(cache.stats().inserts, 0u);
+}
+
+TEST(ResultCacheTest, UncommittedWritesInvalidateOnlyAtCommit) {
+  QueryResultCache cache;
+  put(cache, "k", {"t"}, make_result("committed"));
+
+  // 写入期间已缓存的结果不命中，读到未提交行的结果不缓存
+  cache.begin_write("db", "t");
+  EXPECT_EQ(cache.lookup("k"), nullptr);
+  put(cache, "dirty", {"t"}, make_result("dirty"));
+  EXPECT_EQ(cache.stats().inserts, 1u);
+
+  // 回滚：表恢复为已提交内容，原条目仍然有效
+  cache.abort_write("db", "t");
+  EXPECT_NE(cache.lookup("k"), nullptr);
+  EXPECT_EQ(cache.lookup("dirty"), nullptr);
+  EXPECT_EQ(cache.stats().invalidations, 0u);
+
+  // 提交：版本加一并删除依赖条目
+  auto versions = cache.table_versions("db", {"t"});
+  cache.begin_write("db", "t");
+  cache.begin_write("db", "t");
+  cache.commit_write("db", "t");
+  EXPECT_EQ(cache.lookup("k"), nullptr);
+  EXPECT_NE(cache.table_versions("db", {"t"}), versions);
+  put(cache, "k", {"t"}, make_result("still writing"));
+  EXPECT_EQ(cache.lookup("k"), nullptr);
+
+  cache.commit_write("db", "t");
+  put(cache, "k", {"t"}, make_result("new"));
+  auto hit = cache.lookup("k");
+  ASSERT_NE(hit, nullptr);
+  EXPECT_EQ(hit->message, "new");
+}
+
+TEST(ResultCacheTest, EvictsLeastRecentlyUsed) {
+  QueryResultCache probe;
+  put(probe, "k1", {"t"}, make_result("r", 4));
+  size_t entry_bytes = probe.stats().bytes;
+
+  QueryResultCache cache(entry_bytes * 2 + entry_bytes / 2);
+  put(cache, "k1", {"t"}, make_result("r", 4));
+  put(cache, "k2", {"t"}, make_result("r", 4));
+  ASSERT_NE(cache.lookup("k1"), nullptr); // k2成为最久未使用
+  put(cache, "k3", {"t"}, make_result("r", 4));
+
+  EXPECT_NE(cache.lookup("k1"), nullptr);
+  EXPECT_EQ(cache.lookup("k2"), nullptr);
+  EXPECT_NE(cache.lookup("k3"), nullptr);
+  EXPECT_EQ(cache.stats().evictions, 1u);
+  EXPECT_LE(cache.stats().bytes, cache.stats().capacity);
+
+  // 超过上限的单个结果不缓存
+  put(cache, "big", {"t"}, make_result("r", 1000));
+  EXPECT_EQ(cache.lookup("big"), nullptr);
+
+  cache.set_capacity(entry_bytes);
+  EXPECT_EQ(cache.stats().entries, 1u);
+  EXPECT_NE(cache.lookup("k3"), nullptr);
+
+  cache.clear();
+  EXPECT_EQ(cache.stats().entries, 0u);
+  EXPECT_EQ(cache.stats().bytes, 0u);
+}
@@ -1,8 +1,10 @@
 #include "database_manager.h"
 #include "execution/set_operation_executor.h"
 #include "sql_executor.h"
+#include <functional>
 #include <gtest/gtest.h>
 #include <memory>
+#include <set>
 
 // 集合操作测试 - 测试UNION、INTERSECT、EXCEPT等集合操作
 
@@ -72,9 +74,114 @@ TEST_F(SetOperationTest, MemoryLimit) {
   set_executor_->set_memory_limit(1024 * 1024 * 500); // 500MB
 }
 
-// 简单的集合操作测试（不依赖完整的SQL执行）
+namespace {
+
+sqlcc::ExecutionResult MakeResult(const std::vector<int64_t> &ids) {
+  sqlcc::ExecutionResult result;
+  result.column_metadata.push_back({"id", "INT", false, false, false, ""});
+  for (int64_t id : ids) {
+    sqlcc::Row row;
+    row.values.push_back(sqlcc::Value(id));
+    row.values.push_back(sqlcc::Value("name_" + std::to_string(id % 100)));
+    result.rows.push_back(row);
+  }
+  return result;
+}
+
+std::multiset<int64_t> Ids(const sqlcc::ExecutionResult &result) {
+  std::multiset<int64_t> ids;
+  for (const auto &row : result.rows) {
+    ids.insert(row.values[0].int_val);
+  }
+  return ids;
+}
+
+} // namespace
+
+// ResultSetCombiner的ALL/DISTINCT语义
 TEST(SetOperationSimpleTest, ResultSetCombiner) {
-  // 测试ResultSetCombiner的基本功能
-  // 由于ResultSetCombiner是内部类，这里只做简单的构造测试
-  SUCCEED();
+  using sqlcc::ResultSetCombiner;
+  auto left = MakeResult({1, 1, 1, 2, 3, 3});
+  auto right = MakeResult({1, 1, 3, 4});
+
+  EXPECT_EQ(Ids(ResultSetCombiner::union_all(left, right)),
+            (std::multiset<int64_t>{1, 1, 1, 1, 1, 2, 3, 3, 3, 4}));
+  EXPECT_EQ(Ids(ResultSetCombiner::union_distinct(left, right)),
+            (std::multiset<int64_t>{1, 2, 3, 4}));
+  EXPECT_EQ(Ids(ResultSetCombiner::intersect(left, right, false)),
+            (std::multiset<int64_t>{1, 3}));
+  EXPECT_EQ(Ids(ResultSetCombiner::intersect(left, right, true)),
+            (std::multiset<int64_t>{1, 1, 3}));
+  EXPECT_EQ(Ids(ResultSetCombiner::except(left, right, false)),
+            (std::multiset<int64_t>{2}));
+  EXPECT_EQ(Ids(ResultSetCombiner::except(left, right, true)),
+            (std::multiset<int64_t>{1, 2, 3}));
+
+  // UNION DISTINCT保持首次出现的顺序
+  auto ordered = ResultSetCombiner::union_distinct(left, right);
+  ASSERT_EQ(ordered.rows.size(), 4u);
+  EXPECT_EQ(ordered.rows[0].values[0].int_val, 1);
+  EXPECT_EQ(ordered.rows[3].values[0].int_val, 4);
+
+  // 右值版本的UNION ALL直接移动行
+  auto moved = ResultSetCombiner::union_all(MakeResult({5, 6}),
+                                            MakeResult({6}));
+  EXPECT_EQ(Ids(moved), (std::multiset<int64_t>{5, 6, 6}));
+  EXPECT_EQ(moved.column_metadata.size(), 1u);
+}
+
+// 超出内存限制时按哈希分区溢出到磁盘，结果与内存中计算一致
+TEST(SetOperationSimpleTest, SpillsPartitionsUnderMemoryLimit) {
+  using sqlcc::ResultSetCombiner;
+  std::vector<int64_t> left_ids, right_ids;
+  for (int64_t i = 0; i < 6000; ++i) {
+    left_ids.push_back(i % 4000);
+    right_ids.push_back(i % 3000 + 2000);
+  }
+  auto left = MakeResult(left_ids);
+  auto right = MakeResult(right_ids);
+  const size_t limit = 32 * 1024;
+
+  struct Case {
+    const char *name;
+    std::function<sqlcc::ExecutionResult(size_t, sqlcc::ExecutionStats *)> run;
+  };
+  std::vector<Case> cases = {
+      {"union", [&](size_t mem, sqlcc::ExecutionStats *stats) {
+         return ResultSetCombiner::union_distinct(left, right, mem, stats);
+       }},
+      {"intersect", [&](size_t mem, sqlcc::ExecutionStats *stats) {
+         return ResultSetCombiner::intersect(left, right, false, mem, stats);
+       }},
+      {"intersect all", [&](size_t mem, sqlcc::ExecutionStats *stats) {
+         return ResultSetCombiner::intersect(left, right, true, mem, stats);
+       }},
+      {"except", [&](size_t mem, sqlcc::ExecutionStats *stats) {
+         return ResultSetCombiner::except(left, right, false, mem, stats);
+       }},
+      {"except all", [&](size_t mem, sqlcc::ExecutionStats *stats) {
+         return ResultSetCombiner::except(left, right, true, mem, stats);
+       }},
+  };
+
+  for (const auto &c : cases) {
+    SCOPED_TRACE(c.name);
+    sqlcc::ExecutionStats in_memory_stats;
+    auto expected = c.run(sqlcc::kDefaultOperatorMemoryLimit, &in_memory_stats);
+    EXPECT_EQ(in_memory_stats.spilled_partitions, 0u);
+
+    sqlcc::ExecutionStats stats;
+    auto actual = c.run(limit, &stats);
+    EXPECT_GT(stats.spilled_partitions, 0u);
+    EXPECT_GT(stats.spilled_bytes, 0u);
+    EXPECT_EQ(Ids(actual), Ids(expected));
+  }
+}
+
+// 连哈希分区也无法装入内存时报告错误
+TEST(SetOperationSimpleTest, ThrowsWhenPartitionsNeverFit) {
+  auto left = MakeResult(std::vector<int64_t>(200, 7));
+  auto right = MakeResult({7});
+  EXPECT_THROW(sqlcc::ResultSetCombiner::except(left, right, true, 1),
+               sqlcc::MemoryLimitExceededException);
 }
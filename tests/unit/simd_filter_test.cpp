@@ -0,0 +1,299 @@
+/**
+ * @file simd_filter_test.cpp
+ * @brief SIMD过滤内核与按批谓词求值单元测试
+ *
+ * 各指令集级别的比较/BETWEEN/IN内核与标量参照实现逐位一致，
+ * 选择向量与逐行求值一致，FilterOperator按选择向量输出
+ */
+
+#include "execution/compiled_predicate.h"
+#include "execution/physical_operator.h"
+#include "execution/simd_filter.h"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+
+using namespace sqlcc;
+
+namespace {
+
+const CompareOp kOps[] = {CompareOp::EQ, CompareOp::NE, CompareOp::LT,
+                          CompareOp::LE, CompareOp::GT, CompareOp::GE};
+const size_t kCounts[] = {0, 1, 3, 63, 64, 65, 130, 1000};
+
+std::vector<SimdLevel> SupportedLevels() {
+  std::vector<SimdLevel> levels = {SimdLevel::SCALAR};
+  if (detect_simd_level() >= SimdLevel::SSE42) {
+    levels.push_back(SimdLevel::SSE42);
+  }
+  if (detect_simd_level() >= SimdLevel::AVX2) {
+    levels.push_back(SimdLevel::AVX2);
+  }
+  return levels;
+}
+
+template <typename T> bool Reference(T value, CompareOp op, T constant) {
+  switch (op) {
+  case CompareOp::EQ:
+    return value == constant;
+  case CompareOp::NE:
+    return value != constant;
+  case CompareOp::LT:
+    return value < constant;
+  case CompareOp::LE:
+    return value <= constant;
+  case CompareOp::GT:
+    return value > constant;
+  default:
+    return value >= constant;
+  }
+}
+
+// 位图中的有效位与参照结果一致，末尾多余的位为0
+template <typename Predicate>
+void ExpectMask(const std::vector<uint64_t> &mask, size_t count,
+                Predicate expected, const std::string &label) {
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(bitmap_test(mask.data(), i), expected(i)) << label << " @" << i;
+  }
+  if (count % 64 != 0) {
+    EXPECT_EQ(mask.back() >> (count % 64), 0u) << label;
+  }
+}
+
+ColumnMeta MakeColumn(const std::string &name, const std::string &type) {
+  return {name, type, true, false, false, ""};
+}
+
+// 混合类型的行：INT列中夹杂字符串，DOUBLE列中夹杂整数
+std::vector<Row> MakeMixedRows(size_t count) {
+  std::mt19937 rng(7);
+  std::vector<Row> rows;
+  for (size_t i = 0; i < count; ++i) {
+    Row row;
+    if (i % 17 == 5) {
+      row.values.push_back(Value(std::string("n/a")));
+    } else {
+      row.values.push_back(Value(static_cast<int64_t>(rng() % 100) - 20));
+    }
+    if (i % 11 == 3) {
+      row.values.push_back(Value(static_cast<int64_t>(rng() % 10)));
+    } else {
+      row.values.push_back(Value((rng() % 1000) / 100.0));
+    }
+    row.values.push_back(Value("name" + std::to_string(rng() % 5)));
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+} // namespace
+
+TEST(SimdFilterTest, CompareKernelsMatchScalarReference) {
+  std::mt19937_64 rng(42);
+  std::vector<int64_t> ints(1000);
+  std::vector<double> doubles(1000);
+  for (size_t i = 0; i < ints.size(); ++i) {
+    ints[i] = static_cast<int64_t>(rng() % 21) - 10;
+    doubles[i] = static_cast<double>(rng() % 21) / 2 - 5;
+  }
+  ints[7] = std::numeric_limits<int64_t>::min();
+  ints[8] = std::numeric_limits<int64_t>::max();
+  doubles[9] = std::nan("");
+  doubles[10] = -std::numeric_limits<double>::infinity();
+
+  for (SimdLevel level : SupportedLevels()) {
+    for (size_t count : kCounts) {
+      // 预先置1，确认内核覆盖整个位图
+      std::vector<uint64_t> mask(bitmap_words(count), ~uint64_t(0));
+      for (CompareOp op : kOps) {
+        std::string label = std::string(simd_level_name(level)) + " n=" +
+                            std::to_string(count) + " op=" +
+                            std::to_string(static_cast<int>(op));
+        compare_mask(ints.data(), count, op, int64_t(3), mask.data(), level);
+        ExpectMask(mask, count,
+                   [&](size_t i) { return Reference(ints[i], op, int64_t(3)); },
+                   "int " + label);
+        compare_mask(doubles.data(), count, op, 1.5, mask.data(), level);
+        ExpectMask(mask, count,
+                   [&](size_t i) { return Reference(doubles[i], op, 1.5); },
+                   "double " + label);
+      }
+    }
+  }
+}
+
+TEST(SimdFilterTest, BetweenAndInListKernelsMatchScalarReference) {
+  std::mt19937_64 rng(3);
+  std::vector<int64_t> ints(1000);
+  std::vector<double> doubles(1000);
+  for (size_t i = 0; i < ints.size(); ++i) {
+    ints[i] = static_cast<int64_t>(rng() % 64);
+    doubles[i] = static_cast<double>(rng() % 64) / 4;
+  }
+  doubles[1] = std::nan("");
+
+  std::vector<int64_t> short_ints = {3, 9, 27, 63};
+  std::vector<double> short_doubles = {0.25, 2.0, 15.75};
+  std::vector<int64_t> long_ints;
+  std::vector<double> long_doubles;
+  for (int64_t v = 0; v < 64; v += 3) {
+    long_ints.push_back(v);
+    long_doubles.push_back(v / 4.0);
+  }
+  long_doubles.push_back(std::nan(""));
+
+  auto in = [](const auto &list, auto value) {
+    return std::find(list.begin(), list.end(), value) != list.end();
+  };
+
+  for (SimdLevel level : SupportedLevels()) {
+    for (size_t count : kCounts) {
+      std::vector<uint64_t> mask(bitmap_words(count));
+      std::string label = simd_level_name(level) + std::string(" n=") +
+                          std::to_string(count);
+
+      between_mask(ints.data(), count, 10, 20, mask.data(), level);
+      ExpectMask(mask, count,
+                 [&](size_t i) { return ints[i] >= 10 && ints[i] <= 20; },
+                 "int between " + label);
+      between_mask(doubles.data(), count, 2.5, 7.25, mask.data(), level);
+      ExpectMask(
+          mask, count,
+          [&](size_t i) { return doubles[i] >= 2.5 && doubles[i] <= 7.25; },
+          "double between " + label);
+
+      for (const auto *list : {&short_ints, &long_ints}) {
+        in_list_mask(ints.data(), count, list->data(), list->size(),
+                     mask.data(), level);
+        ExpectMask(mask, count, [&](size_t i) { return in(*list, ints[i]); },
+                   "int in " + label);
+      }
+      for (const auto *list : {&short_doubles, &long_doubles}) {
+        in_list_mask(doubles.data(), count, list->data(), list->size(),
+                     mask.data(), level);
+        ExpectMask(mask, count,
+                   [&](size_t i) { return in(*list, doubles[i]); },
+                   "double in " + label);
+      }
+    }
+  }
+}
+
+TEST(SimdFilterTest, BitmapHelpersAndSelectionVector) {
+  const size_t count = 70;
+  std::vector<uint64_t> mask(bitmap_words(count), 0);
+  std::vector<uint64_t> other(bitmap_words(count), 0);
+  for (size_t i : {0, 5, 63, 64, 69}) {
+    bitmap_set(mask.data(), i);
+  }
+  for (size_t i : {5, 64, 68}) {
+    bitmap_set(other.data(), i);
+  }
+
+  SelectionVector selection;
+  EXPECT_EQ(mask_to_selection(mask.data(), count, selection), 5u);
+  EXPECT_EQ(selection, (SelectionVector{0, 5, 63, 64, 69}));
+
+  std::vector<uint64_t> both = mask;
+  bitmap_and(both.data(), other.data(), count);
+  mask_to_selection(both.data(), count, selection);
+  EXPECT_EQ(selection, (SelectionVector{5, 64}));
+
+  bitmap_or(both.data(), other.data(), count);
+  bitmap_not(both.data(), count);
+  EXPECT_EQ(mask_to_selection(both.data(), count, selection), count - 3);
+  EXPECT_EQ(selection.back(), 69u);
+
+  SimdLevel original = active_simd_level();
+  EXPECT_EQ(set_simd_level(SimdLevel::SCALAR), SimdLevel::SCALAR);
+  EXPECT_EQ(set_simd_level(SimdLevel::AVX2), detect_simd_level());
+  set_simd_level(original);
+}
+
+TEST(SimdFilterTest, CompiledPredicateSelectMatchesRowEvaluation) {
+  std::vector<ColumnMeta> columns = {MakeColumn("a", "INT"),
+                                     MakeColumn("b", "DOUBLE"),
+                                     MakeColumn("c", "VARCHAR")};
+  std::vector<CompiledPredicate> predicates = {
+      CompiledPredicate::compile(columns, "a", ">=", "30"),
+      CompiledPredicate::compile(columns, "a", "<", "12.5"),
+      CompiledPredicate::compile(columns, "b", "<>", "4"),
+      CompiledPredicate::compile(columns, "c", "=", "'name3'"),
+      CompiledPredicate::compile(columns, "a", "BETWEEN", "0 AND 40"),
+      CompiledPredicate::compile(columns, "b", "not between", "1.5 and 8"),
+      CompiledPredicate::compile(columns, "a", "IN", "(1, 2, 3, 50, 77)"),
+      CompiledPredicate::compile(columns, "b", "IN", "(1, 2.5, 9.99)"),
+      CompiledPredicate::compile(columns, "c", "NOT IN", "('name1', 'x,y')"),
+      CompiledPredicate::compile(columns, "a", ">", "'abc'"),
+  };
+  predicates.push_back(
+      CompiledPredicate::all_of({predicates[0], predicates[2]}));
+  predicates.push_back(CompiledPredicate::any_of(
+      {predicates[4], CompiledPredicate::negate(predicates[7])}));
+  predicates.push_back(CompiledPredicate());
+  predicates.push_back(CompiledPredicate::constant(false));
+
+  SimdLevel original = active_simd_level();
+  for (SimdLevel level : SupportedLevels()) {
+    set_simd_level(level);
+    for (size_t count : kCounts) {
+      std::vector<Row> rows = MakeMixedRows(count);
+      for (const auto &predicate : predicates) {
+        SelectionVector expected;
+        for (size_t i = 0; i < rows.size(); ++i) {
+          if (predicate(rows[i])) {
+            expected.push_back(static_cast<uint32_t>(i));
+          }
+        }
+        SelectionVector selection;
+        predicate.select(rows, selection);
+        EXPECT_EQ(selection, expected)
+            << simd_level_name(level) << " " << predicate.describe();
+      }
+    }
+  }
+  set_simd_level(original);
+
+  // 存储层记录与Row的求值一致
+  auto between = CompiledPredicate::compile(columns, "a", "BETWEEN", "1 AND 3");
+  EXPECT_TRUE(between(std::vector<std::string>{"2", "0", "x"}));
+  EXPECT_FALSE(between(std::vector<std::string>{"n/a", "0", "x"}));
+  auto in = CompiledPredicate::compile(columns, "b", "IN", "(2.5, 3)");
+  EXPECT_TRUE(in(std::vector<std::string>{"0", "3.0", "x"}));
+  EXPECT_THROW(CompiledPredicate::compile(columns, "a", "BETWEEN", "1"),
+               Exception);
+  EXPECT_THROW(CompiledPredicate::compile(columns, "a", "IN", "()"),
+               Exception);
+}
+
+TEST(SimdFilterTest, VectorizedFilterOperatorHonorsSelection) {
+  std::vector<ColumnMeta> columns = {MakeColumn("a", "INT"),
+                                     MakeColumn("b", "DOUBLE"),
+                                     MakeColumn("c", "VARCHAR")};
+  std::vector<Row> rows = MakeMixedRows(5000);
+  auto predicate = CompiledPredicate::compile(columns, "a", "BETWEEN", "10 AND 30");
+
+  FilterOperator vectorized(
+      std::make_unique<ValuesScanOperator>(columns, rows), predicate,
+      "a BETWEEN 10 AND 30");
+  FilterOperator row_at_a_time(
+      std::make_unique<ValuesScanOperator>(columns, rows),
+      RowPredicate([&](const Row &row) { return predicate(row); }),
+      "a BETWEEN 10 AND 30");
+
+  ExecutionResult expected = execute_operator_tree(row_at_a_time, 100);
+  ExecutionResult actual = execute_operator_tree(vectorized, 100);
+  ASSERT_TRUE(actual.success);
+  ASSERT_EQ(actual.rows.size(), expected.rows.size());
+  EXPECT_GT(actual.rows.size(), 0u);
+  for (size_t i = 0; i < actual.rows.size(); ++i) {
+    EXPECT_EQ(compare_values(actual.rows[i].values[0],
+                             expected.rows[i].values[0]),
+              0);
+    EXPECT_EQ(actual.rows[i].values[2].str_val,
+              expected.rows[i].values[2].str_val);
+  }
+}
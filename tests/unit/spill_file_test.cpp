@@ -0,0 +1,61 @@
+/**
+ * @file spill_file_test.cpp
+ * @brief 算子溢出文件单元测试
+ */
+
+#include "execution/spill_file.h"
+#include <filesystem>
+#include <gtest/gtest.h>
+
+using namespace sqlcc;
+
+TEST(SpillFileTest, RoundTripAcrossPages) {
+  SpillFile file;
+  for (int64_t i = 0; i < 5000; ++i) {
+    Row row;
+    row.values = {Value(i), Value(i * 0.5),
+                  Value(std::string(static_cast<size_t>(i % 300), 'x'))};
+    file.append(row);
+  }
+  EXPECT_EQ(file.row_count(), 5000u);
+
+  // 可以多次重读
+  for (int pass = 0; pass < 2; ++pass) {
+    RowReader reader = file.reader();
+    int64_t expected = 0;
+    while (const Row *row = reader()) {
+      ASSERT_EQ(row->values.size(), 3u);
+      EXPECT_EQ(row->values[0].int_val, expected);
+      EXPECT_DOUBLE_EQ(row->values[1].double_val, expected * 0.5);
+      EXPECT_EQ(row->values[2].str_val.size(),
+                static_cast<size_t>(expected % 300));
+      expected++;
+    }
+    EXPECT_EQ(expected, 5000);
+  }
+  EXPECT_GT(file.page_count(), 1u);
+  EXPECT_EQ(file.bytes_written(), file.page_count() * 8192);
+}
+
+TEST(SpillFileTest, RowLargerThanPageAndEmptyFile) {
+  SpillFile empty;
+  EXPECT_EQ(empty.reader()(), nullptr);
+
+  SpillFile file;
+  Row row;
+  row.values = {Value(std::string(20000, 'y'))};
+  file.append(row);
+  RowReader reader = file.reader();
+  const Row *read = reader();
+  ASSERT_NE(read, nullptr);
+  EXPECT_EQ(read->values[0].str_val, row.values[0].str_val);
+  EXPECT_EQ(reader(), nullptr);
+}
+
+TEST(SpillFileTest, EstimateRowSizeCountsHeapStrings) {
+  Row small;
+  small.values = {Value(int64_t{1})};
+  Row large;
+  large.values = {Value(std::string(1000, 'z'))};
+  EXPECT_GT(estimate_row_size(large), estimate_row_size(small) + 1000);
+}
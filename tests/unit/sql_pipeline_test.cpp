@@ -0,0 +1,438 @@
+/**
+ * @file sql_pipeline_test.cpp
+ * @brief SQL端到端测试：解析器、统一执行器和表存储
+ */
+
+#include "database_manager.h"
+#include "buffer_usage.h"
+#include "execution/statistics.h"
+#include "sql_parser/parser.h"
+#include "system_database.h"
+#include "unified_executor.h"
+#include <algorithm>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+using namespace sqlcc;
+
+namespace {
+
+class SqlPipelineTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    db_path_ = (std::filesystem::temp_directory_path() /
+                ("sqlcc_sql_pipeline_" + std::to_string(::getpid())))
+                   .string();
+    std::filesystem::remove_all(db_path_);
+    Open();
+    ASSERT_TRUE(db_manager_->CreateDatabase("shop"));
+    ASSERT_TRUE(db_manager_->UseDatabase("shop"));
+  }
+
+  void TearDown() override {
+    Close();
+    StatisticsCatalog::shared().clear();
+    std::filesystem::remove_all(db_path_);
+  }
+
+  void Open() {
+    db_manager_ = std::make_shared<DatabaseManager>(db_path_);
+    system_db_ = std::make_shared<SystemDatabase>(db_manager_);
+    ASSERT_TRUE(system_db_->Initialize()) << system_db_->GetLastError();
+    executor_ =
+        std::make_unique<UnifiedExecutor>(db_manager_, nullptr, system_db_);
+    context_ = std::make_shared<ExecutionContext>();
+    context_->current_database = "shop";
+  }
+
+  void Close() {
+    executor_.reset();
+    system_db_.reset();
+    db_manager_.reset();
+  }
+
+  ExecutionResult Analyze(const std::string &table) {
+    return executor_->execute(
+        std::make_unique<sql_parser::AnalyzeStatement>(table), context_);
+  }
+
+  // notes表：每行约两百字节，几百行会分布在多个数据页上，id按插入顺序递增
+  void FillNotes(int rows) {
+    ASSERT_TRUE(Run("CREATE TABLE notes (id INT, body VARCHAR(200))").success);
+    const std::string body(180, 'x');
+    for (int i = 0; i < rows; ++i) {
+      ASSERT_TRUE(Run("INSERT INTO notes VALUES (" + std::to_string(i) + ", '" +
+                      body + "')")
+                      .success);
+    }
+  }
+
+  ExecutionResult ExplainAnalyze(const std::string &sql) {
+    sql_parser::Parser parser(sql);
+    auto statements = parser.parseStatements();
+    EXPECT_EQ(statements.size(), 1u) << sql;
+    if (statements.empty()) {
+      return {false, "no statement"};
+    }
+    return executor_->execute(std::make_unique<sql_parser::ExplainStatement>(
+                                  std::move(statements[0]), true),
+                              context_);
+  }
+
+  ExecutionResult Run(const std::string &sql) {
+    sql_parser::Parser parser(sql);
+    auto statements = parser.parseStatements();
+    EXPECT_EQ(statements.size(), 1u) << sql;
+    if (statements.empty()) {
+      return {false, "no statement"};
+    }
+    return executor_->execute(std::move(statements[0]), context_);
+  }
+
+  std::string db_path_;
+  std::shared_ptr<DatabaseManager> db_manager_;
+  std::shared_ptr<SystemDatabase> system_db_;
+  std::unique_ptr<UnifiedExecutor> executor_;
+  std::shared_ptr<ExecutionContext> context_;
+};
+
+} // namespace
+
+TEST_F(SqlPipelineTest, SelectReadsInsertedRows) {
+  ASSERT_TRUE(Run("CREATE TABLE items (id INT, name VARCHAR(20))").success);
+  ASSERT_TRUE(Run("INSERT INTO items VALUES (1, 'apple')").success);
+  ASSERT_TRUE(Run("INSERT INTO items VALUES (2, 'pear')").success);
+  ASSERT_TRUE(Run("INSERT INTO items VALUES (3, 'plum')").success);
+
+  auto all = Run("SELECT * FROM items");
+  ASSERT_TRUE(all.success) << all.message;
+  ASSERT_EQ(all.rows.size(), 3u);
+  EXPECT_EQ(all.rows[0].values[0], Value(int64_t(1)));
+  EXPECT_EQ(all.rows[0].values[1], Value(std::string("apple")));
+  EXPECT_EQ(all.rows[2].values[1], Value(std::string("plum")));
+
+  auto filtered = Run("SELECT name FROM items WHERE id = 2");
+  ASSERT_TRUE(filtered.success) << filtered.message;
+  ASSERT_EQ(filtered.rows.size(), 1u);
+  EXPECT_EQ(filtered.rows[0].values[0], Value(std::string("pear")));
+}
+
+TEST_F(SqlPipelineTest, ScanCoversEveryPageAfterUpdateAndDelete) {
+  const int rows = 300;
+  FillNotes(rows);
+  EXPECT_GT(db_manager_->GetStorageEngine()->GetTableDirectory()
+                .GetPages("notes")
+                .size(),
+            1u);
+
+  auto all = Run("SELECT id FROM notes");
+  ASSERT_TRUE(all.success) << all.message;
+  ASSERT_EQ(all.rows.size(), static_cast<size_t>(rows));
+  for (int i = 0; i < rows; ++i) {
+    EXPECT_EQ(all.rows[i].values[0], Value(int64_t(i)));
+  }
+
+  ASSERT_TRUE(Run("DELETE FROM notes WHERE id = 7").success);
+  // 新版本比旧版本长，所在页放不下时移到表末尾
+  ASSERT_TRUE(Run("UPDATE notes SET body = '" + std::string(190, 'y') +
+                  "' WHERE id = 0")
+                  .success);
+  EXPECT_EQ(Run("SELECT id FROM notes").rows.size(),
+            static_cast<size_t>(rows - 1));
+  EXPECT_TRUE(Run("SELECT id FROM notes WHERE id = 7").rows.empty());
+  auto updated = Run("SELECT body FROM notes WHERE id = 0");
+  ASSERT_EQ(updated.rows.size(), 1u);
+  EXPECT_EQ(updated.rows[0].values[0], Value(std::string(190, 'y')));
+}
+
+TEST_F(SqlPipelineTest, LimitStopsScanningAfterFirstPage) {
+  FillNotes(300);
+  size_t pages =
+      db_manager_->GetStorageEngine()->GetTableDirectory().GetPages("notes").size();
+  ASSERT_GT(pages, 4u);
+  context_->set_parallel_degree(1);
+  auto fetches = [] {
+    BufferUsage usage = thread_buffer_usage();
+    return usage.hits + usage.misses;
+  };
+
+  size_t before = fetches();
+  auto all = Run("SELECT id FROM notes");
+  ASSERT_TRUE(all.success) << all.message;
+  ASSERT_EQ(all.rows.size(), 300u);
+  // 每个数据页只固定一次，而不是每行一次
+  size_t full_scan = fetches() - before;
+  EXPECT_GE(full_scan, pages);
+  EXPECT_LT(full_scan, 2 * pages);
+
+  // 扫描逐页进行，LIMIT满足后不再读取后续页
+  before = fetches();
+  auto first = Run("SELECT id FROM notes LIMIT 1");
+  ASSERT_TRUE(first.success) << first.message;
+  ASSERT_EQ(first.rows.size(), 1u);
+  EXPECT_EQ(first.rows[0].values[0], Value(int64_t(0)));
+  EXPECT_LE(fetches() - before, full_scan - pages + 1);
+}
+
+TEST_F(SqlPipelineTest, RowsSurviveReopen) {
+  ASSERT_TRUE(Run("CREATE TABLE items (id INT, name VARCHAR(20))").success);
+  ASSERT_TRUE(Run("INSERT INTO items VALUES (1, 'apple')").success);
+  ASSERT_TRUE(Run("INSERT INTO items VALUES (2, 'pear')").success);
+
+  Close();
+  Open();
+  ASSERT_TRUE(db_manager_->UseDatabase("shop"));
+
+  auto all = Run("SELECT * FROM items");
+  ASSERT_TRUE(all.success) << all.message;
+  ASSERT_EQ(all.rows.size(), 2u);
+  EXPECT_EQ(all.rows[1].values[1], Value(std::string("pear")));
+}
+
+TEST_F(SqlPipelineTest, AnalyzeCollectsStatisticsFromTableRows) {
+  ASSERT_TRUE(Run("CREATE TABLE items (id INT, name VARCHAR(20))").success);
+  for (int i = 1; i <= 5; ++i) {
+    ASSERT_TRUE(Run("INSERT INTO items VALUES (" + std::to_string(i) +
+                    ", 'item" + std::to_string(i % 3) + "')")
+                    .success);
+  }
+
+  auto result = Analyze("items");
+  ASSERT_TRUE(result.success) << result.message;
+
+  auto statistics = StatisticsCatalog::shared().get("shop", "items");
+  ASSERT_NE(statistics, nullptr);
+  EXPECT_EQ(statistics->row_count, 5u);
+  EXPECT_EQ(statistics->page_count, 1u);
+  const ColumnStatistics *id = statistics->column("id");
+  ASSERT_NE(id, nullptr);
+  EXPECT_DOUBLE_EQ(id->distinct_count, 5.0);
+  ASSERT_FALSE(id->histogram.empty());
+  EXPECT_EQ(id->histogram.front(), Value(int64_t(1)));
+  EXPECT_EQ(id->histogram.back(), Value(int64_t(5)));
+  const ColumnStatistics *name = statistics->column("name");
+  ASSERT_NE(name, nullptr);
+  EXPECT_DOUBLE_EQ(name->distinct_count, 3.0);
+}
+
+TEST_F(SqlPipelineTest, StatisticsSurviveRestart) {
+  ASSERT_TRUE(Run("CREATE TABLE items (id INT, name VARCHAR(20))").success);
+  for (int i = 1; i <= 4; ++i) {
+    ASSERT_TRUE(
+        Run("INSERT INTO items VALUES (" + std::to_string(i) + ", 'x')")
+            .success);
+  }
+  ASSERT_TRUE(Analyze("items").success);
+  // 再次ANALYZE覆盖系统表里的旧行
+  ASSERT_TRUE(Run("INSERT INTO items VALUES (5, 'y')").success);
+  ASSERT_TRUE(Analyze("items").success);
+
+  auto metadata =
+      db_manager_->GetStorageEngine()->GetTableDirectory().GetTable("items");
+  ASSERT_NE(metadata, nullptr);
+  int64_t table_id = metadata->table_id;
+  EXPECT_GT(table_id, 0);
+
+  Close();
+  StatisticsCatalog::shared().clear();
+  Open();
+  ASSERT_TRUE(db_manager_->UseDatabase("shop"));
+
+  auto persisted = system_db_->GetTableStatistics(table_id);
+  ASSERT_EQ(persisted.size(), 1u);
+  EXPECT_EQ(persisted[0].row_count, 5);
+  EXPECT_EQ(system_db_->GetColumnStatistics(table_id).size(), 2u);
+
+  // 优化器在目录未命中时从系统表读回
+  ASSERT_EQ(StatisticsCatalog::shared().get("shop", "items"), nullptr);
+  ASSERT_TRUE(Run("SELECT name FROM items WHERE id = 2").success);
+  auto statistics = StatisticsCatalog::shared().get("shop", "items");
+  ASSERT_NE(statistics, nullptr);
+  EXPECT_EQ(statistics->row_count, 5u);
+  const ColumnStatistics *id = statistics->column("id");
+  ASSERT_NE(id, nullptr);
+  EXPECT_EQ(id->histogram.back(), Value(int64_t(5)));
+}
+
+TEST_F(SqlPipelineTest, ParallelScanMatchesSerial) {
+  FillNotes(300);
+  auto ids = [](const ExecutionResult &result) {
+    std::vector<int64_t> values;
+    for (const auto &row : result.rows) {
+      values.push_back(row.values[0].int_val);
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+  };
+
+  context_->set_parallel_degree(1);
+  auto serial = Run("SELECT id FROM notes WHERE id >= 100");
+  ASSERT_TRUE(serial.success) << serial.message;
+  EXPECT_EQ(context_->execution_plan.find("Gather"), std::string::npos)
+      << context_->execution_plan;
+  ASSERT_EQ(serial.rows.size(), 200u);
+
+  // 多个工作线程按页领取morsel，汇集后的结果与串行扫描相同
+  context_->set_parallel_degree(4);
+  auto parallel = Run("SELECT id FROM notes WHERE id >= 100");
+  ASSERT_TRUE(parallel.success) << parallel.message;
+  EXPECT_NE(context_->execution_plan.find("Gather(dop=4)"), std::string::npos)
+      << context_->execution_plan;
+  EXPECT_NE(context_->execution_plan.find("MorselScan(notes)"),
+            std::string::npos)
+      << context_->execution_plan;
+  EXPECT_EQ(ids(parallel), ids(serial));
+  EXPECT_EQ(ids(parallel).front(), 100);
+  EXPECT_EQ(ids(parallel).back(), 299);
+}
+
+TEST_F(SqlPipelineTest, ZoneMapSkipsPagesOfRealTable) {
+  FillNotes(300);
+  size_t pages =
+      db_manager_->GetStorageEngine()->GetTableDirectory().GetPages("notes").size();
+  ASSERT_GT(pages, 2u);
+
+  // 按id顺序插入，每页的id范围互不重叠，只有最后的页可能包含id >= 290
+  context_->set_parallel_degree(1);
+  auto fetches = [] {
+    BufferUsage usage = thread_buffer_usage();
+    return usage.hits + usage.misses;
+  };
+  size_t before = fetches();
+  ASSERT_EQ(Run("SELECT id FROM notes WHERE id < 300").rows.size(), 300u);
+  size_t full_scan = fetches() - before;
+  // 区域映射在固定页面之前检查，被排除的页不经过缓冲池
+  before = fetches();
+  ASSERT_EQ(Run("SELECT id FROM notes WHERE id >= 290").rows.size(), 10u);
+  EXPECT_EQ(fetches() - before, full_scan - (pages - 1));
+
+  auto explain = ExplainAnalyze("SELECT id FROM notes WHERE id >= 290");
+  ASSERT_TRUE(explain.success) << explain.message;
+  std::string plan = context_->execution_plan;
+  EXPECT_NE(plan.find("zone map: id >= 290"), std::string::npos) << plan;
+  EXPECT_NE(plan.find("pages skipped=" + std::to_string(pages - 1)),
+            std::string::npos)
+      << plan;
+  EXPECT_NE(plan.find("10 row(s)"), std::string::npos) << plan;
+
+  for (size_t dop : {1, 4}) {
+    context_->set_parallel_degree(dop);
+    auto result = Run("SELECT id FROM notes WHERE id >= 290");
+    ASSERT_TRUE(result.success) << result.message;
+    EXPECT_EQ(result.rows.size(), 10u) << "dop=" << dop;
+  }
+
+  // 删除记录后区域映射只会偏宽，不会漏掉匹配行
+  ASSERT_TRUE(Run("DELETE FROM notes WHERE id = 295").success);
+  EXPECT_EQ(Run("SELECT id FROM notes WHERE id >= 290").rows.size(), 9u);
+  EXPECT_EQ(Run("SELECT id FROM notes WHERE id < 0").rows.size(), 0u);
+}
+
+TEST_F(SqlPipelineTest, CoveringIndexBackfillsAndFollowsUpdates) {
+  ASSERT_TRUE(
+      Run("CREATE TABLE people (id INT, name VARCHAR(200), dept INT)").success);
+  // 名字较长，记录分布在多个数据页上
+  const std::string padding(150, 'n');
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(Run("INSERT INTO people VALUES (" + std::to_string(i) +
+                    ", 'p" + std::to_string(i) + padding + "', " +
+                    std::to_string(i % 4) + ")")
+                    .success);
+  }
+  auto created =
+      Run("CREATE INDEX idx_people_id ON people (id) INCLUDE (name)");
+  ASSERT_TRUE(created.success) << created.message;
+
+  // 建索引之前插入的记录由回填写入索引，只读索引即可回答
+  auto covered = Run("SELECT name FROM people WHERE id = 7");
+  ASSERT_TRUE(covered.success) << covered.message;
+  ASSERT_EQ(covered.rows.size(), 1u);
+  EXPECT_EQ(covered.rows[0].values[0], Value("p7" + padding));
+  EXPECT_TRUE(context_->used_index);
+  EXPECT_NE(context_->execution_plan.find("IndexOnlyScan"), std::string::npos)
+      << context_->execution_plan;
+
+  // 索引不覆盖dept时按条目中的位置回表读取
+  auto lookup = Run("SELECT * FROM people WHERE id = 7");
+  ASSERT_EQ(lookup.rows.size(), 1u);
+  EXPECT_EQ(lookup.rows[0].values[2], Value(int64_t(3)));
+  EXPECT_TRUE(context_->used_index);
+  EXPECT_EQ(context_->execution_plan.find("IndexOnly"), std::string::npos)
+      << context_->execution_plan;
+
+  // 只改非索引列：键和INCLUDE值不变，但新版本写到了页内新位置
+  ASSERT_TRUE(Run("UPDATE people SET dept = 9 WHERE id = 5").success);
+  lookup = Run("SELECT * FROM people WHERE id = 5");
+  ASSERT_EQ(lookup.rows.size(), 1u);
+  EXPECT_EQ(lookup.rows[0].values[2], Value(int64_t(9)));
+
+  // 新版本更长，所在页放不下时移到表末尾，索引条目跟随新位置
+  const std::string longer(190, 'y');
+  ASSERT_TRUE(
+      Run("UPDATE people SET name = '" + longer + "' WHERE id = 0").success);
+  covered = Run("SELECT name FROM people WHERE id = 0");
+  ASSERT_EQ(covered.rows.size(), 1u);
+  EXPECT_EQ(covered.rows[0].values[0], Value(longer));
+  lookup = Run("SELECT * FROM people WHERE id = 0");
+  ASSERT_EQ(lookup.rows.size(), 1u);
+  EXPECT_EQ(lookup.rows[0].values[1], Value(longer));
+  EXPECT_EQ(lookup.rows[0].values[2], Value(int64_t(0)));
+
+  // 删除后索引中不再有该行
+  ASSERT_TRUE(Run("DELETE FROM people WHERE id = 7").success);
+  EXPECT_TRUE(Run("SELECT name FROM people WHERE id = 7").rows.empty());
+  EXPECT_EQ(Run("SELECT name FROM people WHERE id = 8").rows.size(), 1u);
+}
+
+TEST_F(SqlPipelineTest, NumericIndexServesRangesAndOrder) {
+  ASSERT_TRUE(Run("CREATE TABLE readings (id INT, value DOUBLE)").success);
+  // 插入顺序打乱，且跨越负数和不同位数：按字符串比较时顺序会出错
+  for (int i = 0; i < 120; ++i) {
+    int id = (i * 37) % 120 - 20;
+    ASSERT_TRUE(Run("INSERT INTO readings VALUES (" + std::to_string(id) +
+                    ", " + std::to_string(id) + ".5)")
+                    .success);
+  }
+  ASSERT_TRUE(Run("CREATE INDEX idx_readings_id ON readings (id)").success);
+  ASSERT_TRUE(Run("CREATE INDEX idx_readings_value ON readings (value)").success);
+
+  // 只引用索引列的范围查询沿B+树叶子链读取，不读数据页
+  auto above = Run("SELECT id FROM readings WHERE id > 90");
+  ASSERT_TRUE(above.success) << above.message;
+  EXPECT_NE(context_->execution_plan.find("IndexOnlyScan(readings, id > 90)"),
+            std::string::npos)
+      << context_->execution_plan;
+  ASSERT_EQ(above.rows.size(), 9u);
+  for (size_t i = 0; i < above.rows.size(); ++i) {
+    EXPECT_EQ(above.rows[i].values[0], Value(int64_t(91 + i)));
+  }
+
+  auto below = Run("SELECT * FROM readings WHERE id < 5");
+  ASSERT_TRUE(below.success) << below.message;
+  EXPECT_NE(context_->execution_plan.find("IndexScan(readings, id < 5)"),
+            std::string::npos)
+      << context_->execution_plan;
+  ASSERT_EQ(below.rows.size(), 25u);
+  EXPECT_EQ(below.rows.front().values[0], Value(int64_t(-20)));
+  EXPECT_EQ(below.rows.front().values[1], Value(-20.5));
+  EXPECT_EQ(below.rows.back().values[0], Value(int64_t(4)));
+
+  auto doubles = Run("SELECT value FROM readings WHERE value >= 97.5");
+  ASSERT_TRUE(doubles.success) << doubles.message;
+  EXPECT_NE(context_->execution_plan.find("IndexOnlyScan"), std::string::npos)
+      << context_->execution_plan;
+  ASSERT_EQ(doubles.rows.size(), 3u);
+  EXPECT_EQ(doubles.rows[0].values[0], Value(97.5));
+
+  // 数值列也可以按索引顺序扫描，结果与排序一致
+  auto first = Run("SELECT id FROM readings ORDER BY id LIMIT 3");
+  ASSERT_TRUE(first.success) << first.message;
+  EXPECT_NE(context_->execution_plan.find("IndexOnlyOrderScan(readings, id ASC)"),
+            std::string::npos)
+      << context_->execution_plan;
+  ASSERT_EQ(first.rows.size(), 3u);
+  EXPECT_EQ(first.rows[0].values[0], Value(int64_t(-20)));
+  EXPECT_EQ(first.rows[1].values[0], Value(int64_t(-19)));
+  EXPECT_EQ(first.rows[2].values[0], Value(int64_t(-18)));
+}
@@ -0,0 +1,243 @@
+/**
+ * @file statistics_test.cpp
+ * @brief 统计信息单元测试
+ *
+ * 测试ANALYZE收集的行数、不同值个数和直方图，按直方图估计的选择率，
+ * 优化器按统计信息选择扫描方式和连接算法，HyperLogLog与蓄水池抽样的合并，
+ * 抽样统计的外推，以及统计信息目录对表修改的跟踪
+ */
+
+#include "execution/statistics.h"
+#include "memory_table_scan.h"
+#include "unified_executor.h"
+#include <gtest/gtest.h>
+
+using namespace sqlcc;
+using sqlcc::test::MemoryTableScan;
+
+TEST(StatisticsTest, StatisticsDescribeTableContents) {
+  MemoryTableScan scan(1000);
+  TableStatistics statistics = collect_table_statistics(scan);
+  EXPECT_EQ(statistics.table_name, "sales");
+  EXPECT_EQ(statistics.row_count, 941u); // 1000行中59行已删除
+  EXPECT_EQ(statistics.page_count, 100u);
+  ASSERT_EQ(statistics.columns.size(), 3u);
+
+  const ColumnStatistics *id = statistics.column("sales.id");
+  ASSERT_NE(id, nullptr);
+  EXPECT_DOUBLE_EQ(id->distinct_count, 941.0);
+  EXPECT_DOUBLE_EQ(id->null_fraction, 0.0);
+  ASSERT_EQ(id->histogram.size(), kDefaultHistogramBuckets + 1);
+  EXPECT_EQ(id->histogram.front().int_val, 0);
+  EXPECT_EQ(id->histogram.back().int_val, 999);
+  for (size_t i = 1; i < id->histogram.size(); ++i) {
+    EXPECT_LE(compare_values(id->histogram[i - 1], id->histogram[i]), 0);
+  }
+  EXPECT_DOUBLE_EQ(statistics.column("region")->distinct_count, 5.0);
+  EXPECT_DOUBLE_EQ(statistics.column("amount")->distinct_count, 40.0);
+  EXPECT_EQ(statistics.column("missing"), nullptr);
+
+  EXPECT_EQ(decode_histogram(encode_histogram(id->histogram)).size(),
+            id->histogram.size());
+  std::vector<Value> mixed = {Value(int64_t(-3)), Value(2.25),
+                              Value(std::string("a:1'b"))};
+  EXPECT_TRUE(decode_histogram(encode_histogram(mixed)) == mixed);
+}
+
+TEST(StatisticsTest, SelectivityFollowsHistogram) {
+  MemoryTableScan scan(1000);
+  TableStatistics statistics = collect_table_statistics(scan);
+
+  // 与实际比例比较：id < 500约占一半，amount在[10, 19.5]的约占1/4
+  EXPECT_NEAR(statistics.selectivity("id", "<", "500"), 0.5, 0.03);
+  EXPECT_NEAR(statistics.selectivity("id", ">=", "900"), 0.1, 0.03);
+  EXPECT_NEAR(statistics.selectivity("amount", "BETWEEN", "10 AND 19.5"), 0.25,
+              0.05);
+  EXPECT_NEAR(statistics.selectivity("region", "=", "'r1'"), 0.2, 0.01);
+  EXPECT_NEAR(statistics.selectivity("region", "NOT IN", "('r1', 'r2')"), 0.6,
+              0.01);
+  EXPECT_NEAR(statistics.selectivity("id", "=", "42"), 1.0 / 941, 1e-9);
+  EXPECT_NEAR(statistics.selectivity("id", "IN", "(1, 2, 5000)"), 2.0 / 941,
+              1e-9);
+  // 超出[最小值, 最大值]的常量
+  EXPECT_DOUBLE_EQ(statistics.selectivity("id", "=", "5000"), 0.0);
+  EXPECT_DOUBLE_EQ(statistics.selectivity("id", ">", "999"), 0.0);
+  EXPECT_DOUBLE_EQ(statistics.selectivity("id", "<", "0"), 0.0);
+  // 没有统计信息的列使用默认选择率
+  EXPECT_DOUBLE_EQ(statistics.selectivity("missing", "=", "1"),
+                   default_selectivity("="));
+}
+
+TEST(StatisticsTest, CostModelChoosesScanByStatistics) {
+  MemoryTableScan scan(1000);
+  TableStatistics sales = collect_table_statistics(scan);
+
+  // 唯一值的等值查找走索引；只有5个不同值的列和大范围条件走全表扫描
+  EXPECT_TRUE(index_scan_is_cheaper(sales, "id", "=", "42"));
+  EXPECT_FALSE(index_scan_is_cheaper(sales, "region", "=", "'r1'"));
+  EXPECT_FALSE(index_scan_is_cheaper(sales, "id", "<", "900"));
+  EXPECT_LT(index_scan_cost(sales, 0.001), index_scan_cost(sales, 0.1));
+  EXPECT_GT(index_scan_cost(sales, 1.0), seq_scan_cost(sales));
+
+  TableStatistics regions;
+  regions.table_name = "regions";
+  regions.row_count = 5;
+  regions.page_count = 1;
+  ColumnStatistics region;
+  region.column_name = "region";
+  region.data_type = "VARCHAR";
+  region.distinct_count = 5;
+  region.histogram = {Value(std::string("r0")), Value(std::string("r4"))};
+  regions.columns.push_back(region);
+  EXPECT_DOUBLE_EQ(estimate_join_rows(sales, "region", regions, "region"),
+                   941.0);
+
+  const std::string database = "cost_model_test";
+  StatisticsCatalog &catalog = StatisticsCatalog::shared();
+  catalog.put(database, sales);
+  catalog.put(database, regions);
+  ExecutionContext context("tester", database);
+  ExecutionPlanGenerator generator;
+
+  // 有统计信息时成本按代价模型计算，没有时退化为固定成本
+  sql_parser::SelectStatement stmt;
+  stmt.setTableName("sales");
+  stmt.addSelectColumn("id");
+  stmt.setWhereClause(sql_parser::WhereClause("id", "<", "500"));
+  ExecutionPlan plan = generator.generatePlan(stmt, context);
+  EXPECT_EQ(plan.type, ExecutionPlan::FULL_TABLE_SCAN);
+  EXPECT_DOUBLE_EQ(plan.cost_estimate, seq_scan_cost(sales));
+  EXPECT_NEAR(plan.estimated_rows, 470, 30);
+
+  ExecutionPlan seek = plan;
+  seek.type = ExecutionPlan::INDEX_SEEK;
+  seek.where_clause = "id = 42";
+  EXPECT_LT(generator.estimateCost(seek, context), plan.cost_estimate);
+  seek.where_clause = "region NOT IN ('r1', 'r2')";
+  EXPECT_GT(generator.estimateCost(seek, context), plan.cost_estimate);
+  seek.table_name = "unknown";
+  EXPECT_DOUBLE_EQ(generator.estimateCost(seek, context), 10.0);
+
+  // 两表连接：小表作为哈希构建侧，成本包含两侧扫描
+  sql_parser::SelectStatement join;
+  join.setTableName("regions");
+  join.addSelectColumn("id");
+  join.setJoinCondition("regions.region = sales.region");
+  join.setWhereClause(sql_parser::WhereClause("sales.id", "<", "500"));
+  ExecutionPlan join_plan = generator.generatePlan(join, context);
+  EXPECT_EQ(join_plan.type, ExecutionPlan::JOIN);
+  EXPECT_NE(join_plan.description.find("hash"), std::string::npos)
+      << join_plan.description;
+  EXPECT_GT(join_plan.cost_estimate,
+            seq_scan_cost(sales) + seq_scan_cost(regions));
+  EXPECT_NEAR(join_plan.estimated_rows, 470, 30);
+  EXPECT_DOUBLE_EQ(generator.estimateCost(join_plan, context),
+                   join_plan.cost_estimate);
+
+  CostBasedOptimizer optimizer;
+  ExecutionPlan optimized = optimizer.optimize(plan, context);
+  EXPECT_TRUE(optimized.is_optimized);
+  EXPECT_DOUBLE_EQ(optimized.cost_estimate, plan.cost_estimate);
+
+  catalog.remove(database, "sales");
+  EXPECT_EQ(catalog.get(database, "sales"), nullptr);
+  EXPECT_DOUBLE_EQ(generator.estimateCost(plan, context), 100.0);
+  catalog.remove(database, "regions");
+}
+
+TEST(StatisticsTest, HyperLogLogEstimatesAndMerges) {
+  HyperLogLog left, right;
+  for (int64_t i = 0; i < 60000; ++i) {
+    left.add(Value(i));
+  }
+  for (int64_t i = 40000; i < 100000; ++i) {
+    right.add(Value(i));
+  }
+  EXPECT_NEAR(left.estimate(), 60000, 60000 * 0.05);
+
+  // 合并后等于并集的估计，重复值不重复计数
+  left.merge(right);
+  EXPECT_NEAR(left.estimate(), 100000, 100000 * 0.05);
+  HyperLogLog small;
+  for (int i = 0; i < 100; ++i) {
+    small.add(Value("v" + std::to_string(i % 10)));
+  }
+  EXPECT_NEAR(small.estimate(), 10, 1);
+  EXPECT_THROW(small.merge(HyperLogLog(10)), Exception);
+}
+
+TEST(StatisticsTest, ReservoirSamplesMergeByWeight) {
+  ReservoirSample first(100, 1), second(100, 2);
+  for (int64_t i = 0; i < 5000; ++i) {
+    first.add(Row{{Value(i)}});
+    second.add(Row{{Value(i + 5000)}});
+  }
+  EXPECT_EQ(first.rows().size(), 100u);
+  EXPECT_FALSE(first.complete());
+  first.merge(std::move(second));
+  EXPECT_EQ(first.seen(), 10000u);
+  ASSERT_EQ(first.rows().size(), 100u);
+  size_t from_first = 0;
+  for (const Row &row : first.rows()) {
+    from_first += row.values[0].int_val < 5000;
+  }
+  EXPECT_GT(from_first, 30u);
+  EXPECT_LT(from_first, 70u);
+
+  // 两个完整的小样本直接拼接
+  ReservoirSample a(10, 1), b(10, 2);
+  a.add(Row{{Value(int64_t(1))}});
+  b.add(Row{{Value(int64_t(2))}});
+  a.merge(std::move(b));
+  EXPECT_TRUE(a.complete());
+  EXPECT_EQ(a.rows().size(), 2u);
+}
+
+TEST(StatisticsTest, SampledStatisticsExtrapolate) {
+  MemoryTableScan scan(20000);
+  StatisticsOptions options;
+  options.sample_pages = 200; // 2000页中读取200页
+  options.seed = 7;
+  TableStatistics statistics = collect_table_statistics(scan, options);
+  EXPECT_EQ(statistics.page_count, 2000u);
+  EXPECT_NEAR(statistics.row_count, 18823, 18823 * 0.02);
+  EXPECT_NEAR(statistics.column("id")->distinct_count, 18823, 18823 * 0.05);
+  EXPECT_NEAR(statistics.column("region")->distinct_count, 5, 0.5);
+  EXPECT_NEAR(statistics.column("amount")->distinct_count, 40, 2);
+  EXPECT_NEAR(statistics.selectivity("id", "<", "10000"), 0.5, 0.05);
+
+  // 并行收集与串行收集的结果相同
+  MemoryTableScan serial_scan(1000), parallel_scan(1000);
+  StatisticsOptions parallel;
+  parallel.parallel_degree = 4;
+  TableStatistics serial = collect_table_statistics(serial_scan);
+  TableStatistics merged = collect_table_statistics(parallel_scan, parallel);
+  EXPECT_EQ(merged.row_count, serial.row_count);
+  for (size_t i = 0; i < serial.columns.size(); ++i) {
+    EXPECT_DOUBLE_EQ(merged.columns[i].distinct_count,
+                     serial.columns[i].distinct_count);
+    EXPECT_TRUE(merged.columns[i].histogram == serial.columns[i].histogram);
+  }
+}
+
+TEST(StatisticsTest, CatalogTracksModifications) {
+  const std::string database = "auto_analyze_test";
+  StatisticsCatalog &catalog = StatisticsCatalog::shared();
+  catalog.record_modification(database, "sales", 10, 0, 0);
+  EXPECT_EQ(catalog.get(database, "sales"), nullptr); // 没有统计信息的表不跟踪
+
+  MemoryTableScan scan(1000);
+  catalog.put(database, collect_table_statistics(scan));
+  catalog.record_modification(database, "sales", 100, 41, 0);
+  EXPECT_EQ(catalog.get(database, "sales")->row_count, 1000u);
+  EXPECT_NEAR(catalog.get(database, "sales")->page_count, 106, 1);
+  EXPECT_EQ(catalog.modified_rows(database, "sales"), 141u);
+  EXPECT_FALSE(catalog.needs_analyze(database, "sales")); // 阈值50 + 100
+
+  catalog.record_modification(database, "sales", 0, 0, 10);
+  EXPECT_TRUE(catalog.needs_analyze(database, "sales"));
+  catalog.put(database, collect_table_statistics(scan));
+  EXPECT_EQ(catalog.modified_rows(database, "sales"), 0u);
+  EXPECT_FALSE(catalog.needs_analyze(database, "sales"));
+  catalog.remove(database, "sales");
+}
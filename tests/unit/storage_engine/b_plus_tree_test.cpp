@@ -1,6 +1,8 @@
 #include "storage/b_plus_tree.h"
 #include "utils/config_manager.h"
 #include "storage_engine.h"
+#include <cstdio>
+#include <cstring>
 #include <gtest/gtest.h>
 
 namespace sqlcc {
@@ -29,6 +31,48 @@ protected:
     std::remove("test_db.meta");
   }
 
+  // 两位数字的键，字典序与数值顺序一致
+  static std::string PaddedKey(int i) {
+    char key[16];
+    std::snprintf(key, sizeof(key), "key%02d", i);
+    return key;
+  }
+
+  // 叶子页头部的格式字节
+  char LeafFormat(int32_t page_id) {
+    Page *page = storage_engine_->FetchPage(page_id);
+    char format = page->GetData()[13];
+    storage_engine_->UnpinPage(page_id, false);
+    return format;
+  }
+
+  // 按加入INCLUDE列之前的格式写一个叶子页：条目只有键、页面ID和偏移量
+  void WriteLegacyLeaf(int32_t page_id,
+                       const std::vector<IndexEntry> &entries) {
+    Page *page = storage_engine_->FetchPage(page_id);
+    char *data = page->GetData();
+    std::memset(data, 0, PAGE_SIZE);
+    data[0] = 1;
+    *reinterpret_cast<int32_t *>(data + 1) =
+        static_cast<int32_t>(entries.size());
+    *reinterpret_cast<int32_t *>(data + 5) = -1;
+    *reinterpret_cast<int32_t *>(data + 9) = -1;
+    data[13] = 0;
+    size_t offset = 20;
+    for (const auto &entry : entries) {
+      int32_t key_len = static_cast<int32_t>(entry.key.size());
+      std::memcpy(data + offset, &key_len, sizeof(int32_t));
+      offset += sizeof(int32_t);
+      std::memcpy(data + offset, entry.key.data(), key_len);
+      offset += key_len;
+      std::memcpy(data + offset, &entry.page_id, sizeof(int32_t));
+      offset += sizeof(int32_t);
+      std::memcpy(data + offset, &entry.offset, sizeof(size_t));
+      offset += sizeof(size_t);
+    }
+    storage_engine_->UnpinPage(page_id, true);
+  }
+
   std::unique_ptr<ConfigManager> config_manager_;
   std::unique_ptr<StorageEngine> storage_engine_;
   std::unique_ptr<BPlusTreeIndex> b_plus_tree_index_;
@@ -200,9 +244,9 @@ TEST_F(BPlusTreeTest, SingleNodeOperations) {
 
 TEST_F(BPlusTreeTest, MultipleRangeQueries) {
   // 插入多个键
+  // 键按字符串比较，补齐两位数字让字典序与数值顺序一致
   for (int i = 0; i < 100; ++i) {
-    std::string key = "key" + std::to_string(i);
-    IndexEntry entry(key, i, 0);
+    IndexEntry entry(PaddedKey(i), i, 0);
     EXPECT_TRUE(b_plus_tree_index_->Insert(entry));
   }
 
@@ -213,32 +257,161 @@ TEST_F(BPlusTreeTest, MultipleRangeQueries) {
   results = b_plus_tree_index_->SearchRange("key50", "key99");
   EXPECT_EQ(results.size(), 50); // key50到key99共50个键
 
-  results = b_plus_tree_index_->SearchRange("key0", "key9");
-  EXPECT_EQ(results.size(), 10); // key0到key9共10个键
+  results = b_plus_tree_index_->SearchRange("key00", "key09");
+  EXPECT_EQ(results.size(), 10); // key00到key09共10个键
 }
 
 TEST_F(BPlusTreeTest, EdgeKeyRangeQueries) {
   // 插入键
   for (int i = 0; i < 5; ++i) {
-    std::string key = "key" + std::to_string(i);
-    IndexEntry entry(key, i, 0);
+    IndexEntry entry(PaddedKey(i), i, 0);
     EXPECT_TRUE(b_plus_tree_index_->Insert(entry));
   }
 
   // 测试范围边界等于最小键
-  std::vector<IndexEntry> results = b_plus_tree_index_->SearchRange("key0", "key2");
-  EXPECT_EQ(results.size(), 3); // key0, key1, key2
+  std::vector<IndexEntry> results = b_plus_tree_index_->SearchRange("key00", "key02");
+  EXPECT_EQ(results.size(), 3); // key00, key01, key02
 
   // 测试范围边界等于最大键
-  results = b_plus_tree_index_->SearchRange("key3", "key4");
-  EXPECT_EQ(results.size(), 2); // key3, key4
+  results = b_plus_tree_index_->SearchRange("key03", "key04");
+  EXPECT_EQ(results.size(), 2); // key03, key04
 
   // 测试超出范围的查询
   results = b_plus_tree_index_->SearchRange("key10", "key20");
   EXPECT_EQ(results.size(), 0);
 
-  results = b_plus_tree_index_->SearchRange("a", "key0");
-  EXPECT_EQ(results.size(), 1); // 只包含key0
+  results = b_plus_tree_index_->SearchRange("a", "key00");
+  EXPECT_EQ(results.size(), 1); // 只包含key00
+}
+
+TEST_F(BPlusTreeTest, IncludedColumnsStoredInLeaves) {
+  BPlusTreeIndex &index = *b_plus_tree_index_;
+
+  // INCLUDE列的值随叶子条目保存，写回页面后仍能读出
+  for (int i = 0; i < 40; ++i) {
+    IndexEntry entry("key" + std::to_string(i), i, 0,
+                     {std::to_string(i * 10), "name" + std::to_string(i)});
+    EXPECT_TRUE(index.Insert(entry));
+  }
+  for (int i : {0, 20, 39}) {
+    std::vector<IndexEntry> results = index.Search("key" + std::to_string(i));
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].page_id, i);
+    ASSERT_EQ(results[0].included_values.size(), 2u);
+    EXPECT_EQ(results[0].included_values[0], std::to_string(i * 10));
+    EXPECT_EQ(results[0].included_values[1], "name" + std::to_string(i));
+  }
+  EXPECT_EQ(LeafFormat(index.GetRootPageId()), 1);
+
+  // 超过半页的条目被拒绝
+  IndexEntry huge("huge", 1, 0, {std::string(PAGE_SIZE, 'x')});
+  EXPECT_FALSE(index.Insert(huge));
+  EXPECT_TRUE(index.Search("huge").empty());
+}
+
+TEST_F(BPlusTreeTest, LegacyLeafStillDeserializes) {
+  int32_t page_id = -1;
+  ASSERT_NE(storage_engine_->NewPage(&page_id), nullptr);
+  storage_engine_->UnpinPage(page_id, false);
+  WriteLegacyLeaf(page_id, {IndexEntry("apple", 3, 120),
+                            IndexEntry("pear", 4, 512)});
+
+  {
+    BPlusTreeLeafNode leaf(storage_engine_.get(), page_id);
+    const auto &entries = leaf.GetEntries();
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].key, "apple");
+    EXPECT_EQ(entries[0].page_id, 3);
+    EXPECT_EQ(entries[0].offset, 120u);
+    EXPECT_TRUE(entries[0].included_values.empty());
+    EXPECT_EQ(entries[1].key, "pear");
+    EXPECT_EQ(entries[1].offset, 512u);
+    EXPECT_EQ(leaf.GetNextPageId(), -1);
+
+    // 修改后按新格式写回
+    ASSERT_TRUE(leaf.Insert(IndexEntry("plum", 5, 64, {"purple"})));
+    leaf.SerializeToPage();
+  }
+  EXPECT_EQ(LeafFormat(page_id), 1);
+
+  BPlusTreeLeafNode reread(storage_engine_.get(), page_id);
+  const auto &entries = reread.GetEntries();
+  ASSERT_EQ(entries.size(), 3u);
+  EXPECT_EQ(entries[0].key, "apple");
+  EXPECT_TRUE(entries[0].included_values.empty());
+  EXPECT_EQ(entries[1].key, "pear");
+  EXPECT_EQ(entries[1].page_id, 4);
+  EXPECT_EQ(entries[2].key, "plum");
+  ASSERT_EQ(entries[2].included_values.size(), 1u);
+  EXPECT_EQ(entries[2].included_values[0], "purple");
+}
+
+TEST_F(BPlusTreeTest, PointSearchAfterSplits) {
+  BPlusTreeIndex &index = *b_plus_tree_index_;
+
+  // 较长的INCLUDE值让叶子按字节数提前分裂，条目数足以让内部节点也分裂
+  const int count = 3000;
+  for (int i = 0; i < count; ++i) {
+    IndexEntry entry(std::to_string(i), i, 0, {std::string(150, 'x')});
+    ASSERT_TRUE(index.Insert(entry));
+  }
+  EXPECT_EQ(index.SearchRange("", "~").size(), static_cast<size_t>(count));
+
+  // 每个键都能从根下降到所在的叶子，包括等于分隔键的键
+  for (int i = 0; i < count; ++i) {
+    std::vector<IndexEntry> results = index.Search(std::to_string(i));
+    ASSERT_EQ(results.size(), 1u) << "key " << i;
+    EXPECT_EQ(results[0].page_id, i);
+  }
+}
+
+TEST_F(BPlusTreeTest, NumericKeysRangeInValueOrder) {
+  BPlusTreeIndex &index = *b_plus_tree_index_;
+
+  // 数值键按保序编码：负数、跨位数的整数都按数值顺序排列
+  std::vector<int> values;
+  for (int i = -50; i <= 150; i += 5) {
+    values.push_back(i);
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    std::string key = BPlusTreeIndex::EncodeKey(std::to_string(values[i]), "INT");
+    ASSERT_TRUE(index.Insert(IndexEntry(key, static_cast<int32_t>(i), 0)));
+  }
+  ASSERT_TRUE(index.Insert(IndexEntry(BPlusTreeIndex::EncodeKey("", "INT"), 999, 0)));
+
+  std::string min_key, max_key;
+  ASSERT_TRUE(BPlusTreeIndex::NumericKeyBounds("INT", min_key, max_key));
+  std::vector<IndexEntry> above =
+      index.SearchRange(BPlusTreeIndex::EncodeKey("95", "INT"), max_key);
+  ASSERT_EQ(above.size(), 12u); // 95..150，不含无法解析的值
+  EXPECT_EQ(BPlusTreeIndex::DecodeKey(above.front().key, "INT"), "95");
+  EXPECT_EQ(BPlusTreeIndex::DecodeKey(above.back().key, "INT"), "150");
+  std::vector<IndexEntry> below =
+      index.SearchRange(min_key, BPlusTreeIndex::EncodeKey("-40", "INT"));
+  ASSERT_EQ(below.size(), 3u);
+  EXPECT_EQ(BPlusTreeIndex::DecodeKey(below.front().key, "INT"), "-50");
+
+  // 无法解析的值排在所有数值之后
+  std::vector<IndexEntry> all = index.ScanFrom("", 1000);
+  ASSERT_EQ(all.size(), values.size() + 1);
+  EXPECT_EQ(all.back().page_id, 999);
+
+  // 浮点数：负数、-0.0和0.0、小数部分都按数值顺序
+  std::vector<std::string> doubles = {"-1e10", "-2.5", "-0.0", "0",
+                                      "0.25", "3", "12.75", "1e300"};
+  for (size_t i = 1; i < doubles.size(); ++i) {
+    std::string previous = BPlusTreeIndex::EncodeKey(doubles[i - 1], "DOUBLE");
+    std::string current = BPlusTreeIndex::EncodeKey(doubles[i], "DOUBLE");
+    if (i == 3) {
+      EXPECT_EQ(previous, current); // -0.0 == 0
+    } else {
+      EXPECT_LT(previous, current) << doubles[i - 1] << " < " << doubles[i];
+    }
+  }
+  EXPECT_EQ(BPlusTreeIndex::DecodeKey(BPlusTreeIndex::EncodeKey("12.75", "DOUBLE"), "DOUBLE"),
+            "12.75");
+  // 非数值列保存原始文本
+  EXPECT_EQ(BPlusTreeIndex::EncodeKey("abc", "VARCHAR(10)"), "abc");
 }
 
 } // namespace test
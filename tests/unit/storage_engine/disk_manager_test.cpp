@@ -207,10 +207,10 @@ TEST_F(DiskManagerTest, DeallocateAllPages) {
     disk_manager_->DeallocatePage(page_id);
   }
 
-  // 重新分配页面，应该重用之前的页面ID
+  // 重新分配页面，应该重用之前的页面ID，空闲列表后释放的先重用
   for (int i = 0; i < num_pages; ++i) {
     int32_t page_id = disk_manager_->AllocatePage();
-    EXPECT_EQ(page_id, page_ids[i]);
+    EXPECT_EQ(page_id, page_ids[num_pages - 1 - i]);
   }
 }
 
@@ -0,0 +1,102 @@
+/**
+ * @file zone_map_test.cpp
+ * @brief 区域映射单元测试
+ */
+
+#include "zone_map.h"
+#include <gtest/gtest.h>
+
+using namespace sqlcc;
+
+namespace {
+
+std::vector<TableColumn> EventColumns() {
+    return {{"id", "INT", 4, false, ""},
+            {"ts", "BIGINT", 8, false, ""},
+            {"name", "VARCHAR", 32, true, ""},
+            {"score", "DOUBLE", 8, true, ""}};
+}
+
+} // namespace
+
+TEST(ZoneMapTest, TracksMinMaxAndNullsPerPage) {
+    ZoneMapIndex zones;
+    auto columns = EventColumns();
+    zones.AddRecord(1, {"5", "1000", "bob", "2.5"}, columns);
+    zones.AddRecord(1, {"3", "1010", "", "NULL"}, columns);
+    zones.AddRecord(1, {"9", "1005", "alice", "-1"}, columns);
+
+    PageZone zone;
+    ASSERT_TRUE(zones.GetPageZone(1, zone));
+    EXPECT_EQ(zone.row_count, 3u);
+    ASSERT_EQ(zone.columns.size(), 4u);
+    EXPECT_DOUBLE_EQ(zone.columns[0].min_number, 3);
+    EXPECT_DOUBLE_EQ(zone.columns[0].max_number, 9);
+    EXPECT_FALSE(zone.columns[0].has_string);
+    EXPECT_EQ(zone.columns[2].min_string, "");
+    EXPECT_EQ(zone.columns[2].max_string, "bob");
+    EXPECT_EQ(zone.columns[2].null_count, 1u);
+    EXPECT_EQ(zone.columns[3].null_count, 1u);
+    EXPECT_DOUBLE_EQ(zone.columns[3].min_number, -1);
+    EXPECT_TRUE(zone.columns[3].has_string); // 数值列中的NULL按字符串比较
+
+    EXPECT_FALSE(zones.GetPageZone(2, zone));
+    EXPECT_EQ(zones.PageCount(), 1u);
+    zones.RemovePage(1);
+    EXPECT_EQ(zones.PageCount(), 0u);
+}
+
+TEST(ZoneMapTest, SkipsPagesOutsideNumericRange) {
+    ZoneMapIndex zones;
+    auto columns = EventColumns();
+    // 按时间追加：每页的ts范围互不重叠
+    for (int32_t page = 0; page < 4; ++page) {
+        for (int i = 0; i < 10; ++i) {
+            std::string ts = std::to_string(page * 100 + i);
+            zones.AddRecord(page, {ts, ts, "e", "0"}, columns);
+        }
+    }
+    auto matching = [&](const std::string& op, const std::string& value) {
+        std::vector<int32_t> pages;
+        for (int32_t page = 0; page < 4; ++page) {
+            if (zones.PageMayMatch(page, 1, "BIGINT", op, value)) {
+                pages.push_back(page);
+            }
+        }
+        return pages;
+    };
+    EXPECT_EQ(matching(">=", "250"), (std::vector<int32_t>{3}));
+    EXPECT_EQ(matching(">", "210"), (std::vector<int32_t>{3}));
+    EXPECT_EQ(matching("<", "100"), (std::vector<int32_t>{0, 1}));
+    EXPECT_EQ(matching("=", "105"), (std::vector<int32_t>{1}));
+    EXPECT_EQ(matching("=", "150"), (std::vector<int32_t>{}));
+    // 整数列与小数常量按数值比较
+    EXPECT_EQ(matching("<=", "9.5"), (std::vector<int32_t>{0}));
+    // 带引号的常量是字符串，排在所有数值之后
+    EXPECT_EQ(matching("<", "'0'"), (std::vector<int32_t>{0, 1, 2, 3}));
+    EXPECT_EQ(matching("=", "'105'"), (std::vector<int32_t>{}));
+    // 其他操作符和没有摘要的页不排除
+    EXPECT_EQ(matching("<>", "105"), (std::vector<int32_t>{0, 1, 2, 3}));
+    EXPECT_TRUE(zones.PageMayMatch(99, 1, "BIGINT", "=", "-1"));
+}
+
+TEST(ZoneMapTest, ComparesStringsAndMixedValues) {
+    ZoneMapIndex zones;
+    auto columns = EventColumns();
+    zones.AddRecord(7, {"1", "1", "carol", "abc"}, columns);
+    zones.AddRecord(7, {"2", "2", "dave", "3.5"}, columns);
+
+    EXPECT_TRUE(zones.PageMayMatch(7, 2, "VARCHAR", "=", "'carol'"));
+    EXPECT_FALSE(zones.PageMayMatch(7, 2, "VARCHAR", "=", "'bob'"));
+    EXPECT_FALSE(zones.PageMayMatch(7, 2, "VARCHAR", "<", "'carol'"));
+    EXPECT_TRUE(zones.PageMayMatch(7, 2, "VARCHAR", "<=", "'carol'"));
+    EXPECT_FALSE(zones.PageMayMatch(7, 2, "VARCHAR", ">", "'dave'"));
+
+    // 数值列中有无法解析的值：任何字符串都大于数值
+    EXPECT_TRUE(zones.PageMayMatch(7, 3, "DOUBLE", ">", "1000"));
+    EXPECT_FALSE(zones.PageMayMatch(7, 3, "DOUBLE", "<", "3"));
+    EXPECT_TRUE(zones.PageMayMatch(7, 3, "DOUBLE", "=", "3.5"));
+
+    zones.AddRecord(8, {"1", "1", "x", "nan"}, columns);
+    EXPECT_TRUE(zones.PageMayMatch(8, 3, "DOUBLE", "=", "42"));
+}